@@ -1046,6 +1046,16 @@ if __name__ == "__main__":
     file.functions["ufbx_load_geometry_cache_len"].alloc_type = "geometryCache"
     file.functions["ufbx_create_anim"].alloc_type = "anim"
     file.functions["ufbx_bake_anim"].alloc_type = "bakedAnim"
+    file.functions["ufbx_compress_baked_anim"].alloc_type = "compressedAnim"
+    file.functions["ufbx_compile_anim"].alloc_type = "compiledAnim"
+    file.functions["ufbx_create_blend_vertex_layout"].alloc_type = "blendVertexLayout"
+    file.functions["ufbx_create_mesh_buffers"].alloc_type = "meshBuffers"
+    file.functions["ufbx_save_scene_snapshot"].alloc_type = "sceneSnapshot"
+    file.functions["ufbx_load_scene_snapshot"].alloc_type = "scene"
+    file.functions["ufbx_load_scene_snapshot_file"].alloc_type = "scene"
+    file.functions["ufbx_load_scene_snapshot_file_len"].alloc_type = "scene"
+    file.functions["ufbx_load_scene_snapshot_stream"].alloc_type = "scene"
+    file.functions["ufbx_create_load_context"].alloc_type = "loadContext"
 
     file.functions["ufbx_free_scene"].kind = "free"
     file.functions["ufbx_free_mesh"].kind = "free"
@@ -1053,6 +1063,12 @@ if __name__ == "__main__":
     file.functions["ufbx_free_geometry_cache"].kind = "free"
     file.functions["ufbx_free_anim"].kind = "free"
     file.functions["ufbx_free_baked_anim"].kind = "free"
+    file.functions["ufbx_free_compressed_anim"].kind = "free"
+    file.functions["ufbx_free_compiled_anim"].kind = "free"
+    file.functions["ufbx_free_blend_vertex_layout"].kind = "free"
+    file.functions["ufbx_free_mesh_buffers"].kind = "free"
+    file.functions["ufbx_free_scene_snapshot"].kind = "free"
+    file.functions["ufbx_free_load_context"].kind = "free"
 
     file.functions["ufbx_retain_scene"].kind = "retain"
     file.functions["ufbx_retain_mesh"].kind = "retain"
@@ -1060,6 +1076,12 @@ if __name__ == "__main__":
     file.functions["ufbx_retain_geometry_cache"].kind = "retain"
     file.functions["ufbx_retain_anim"].kind = "retain"
     file.functions["ufbx_retain_baked_anim"].kind = "retain"
+    file.functions["ufbx_retain_compressed_anim"].kind = "retain"
+    file.functions["ufbx_retain_compiled_anim"].kind = "retain"
+    file.functions["ufbx_retain_blend_vertex_layout"].kind = "retain"
+    file.functions["ufbx_retain_mesh_buffers"].kind = "retain"
+    file.functions["ufbx_retain_scene_snapshot"].kind = "retain"
+    file.functions["ufbx_retain_load_context"].kind = "retain"
 
     file.functions["ufbx_triangulate_face"].return_array_scale = 3
     file.functions["ufbx_ffi_triangulate_face"].return_array_scale = 3
@@ -0,0 +1,274 @@
+#ifndef UFBX_CHROME_TRACE_H_INCLUDED
+#define UFBX_CHROME_TRACE_H_INCLUDED
+
+// Records `ufbx_trace_cb` zones and writes them in the Chrome trace event format,
+// viewable in `chrome://tracing` or https://ui.perfetto.dev.
+//
+//   ufbx_chrome_trace *trace = ufbx_chrome_trace_create(NULL);
+//   ufbx_load_opts opts = { 0 };
+//   ufbx_chrome_trace_init_ufbx_trace_cb(&opts.trace_cb, trace);
+//   ufbx_scene *scene = ufbx_load_file("file.fbx", &opts, NULL);
+//   ufbx_chrome_trace_write(trace, "trace.json");
+//   ufbx_chrome_trace_free(trace);
+//
+// Define `UFBX_CHROME_TRACE_IMPLEMENTATION` in one file before including this header.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#if !defined(UFBX_VERSION)
+	#error "ufbx.h" must be included before "ufbx_chrome_trace.h"
+#endif
+
+#ifndef ufbx_chrome_trace_abi
+#define ufbx_chrome_trace_abi
+#endif
+
+#ifndef UFBX_CHROME_TRACE_DEFAULT_MAX_EVENTS
+#define UFBX_CHROME_TRACE_DEFAULT_MAX_EVENTS (1024*1024)
+#endif
+
+// Maximum number of distinct threads per trace, further threads share `tid` 0.
+#ifndef UFBX_CHROME_TRACE_MAX_THREADS
+#define UFBX_CHROME_TRACE_MAX_THREADS 256
+#endif
+
+typedef struct ufbx_chrome_trace_opts {
+	uint32_t _begin_zero;
+
+	// Maximum number of recorded begin/end events, further events are dropped.
+	// Default: `UFBX_CHROME_TRACE_DEFAULT_MAX_EVENTS`
+	size_t max_events;
+
+	uint32_t _end_zero;
+} ufbx_chrome_trace_opts;
+
+typedef struct ufbx_chrome_trace ufbx_chrome_trace;
+
+ufbx_chrome_trace_abi ufbx_chrome_trace *ufbx_chrome_trace_create(const ufbx_chrome_trace_opts *user_opts);
+ufbx_chrome_trace_abi void ufbx_chrome_trace_free(ufbx_chrome_trace *trace);
+
+// Setup `dst` to record zones into `trace`, the callbacks are thread-safe.
+ufbx_chrome_trace_abi void ufbx_chrome_trace_init_ufbx_trace_cb(ufbx_trace_cb *dst, ufbx_chrome_trace *trace);
+
+// Number of events dropped due to `ufbx_chrome_trace_opts.max_events`.
+ufbx_chrome_trace_abi size_t ufbx_chrome_trace_dropped_events(const ufbx_chrome_trace *trace);
+
+// Write the recorded events as JSON, must not be called while zones are being recorded.
+ufbx_chrome_trace_abi bool ufbx_chrome_trace_write(const ufbx_chrome_trace *trace, const char *path);
+
+#endif
+
+#if defined(UFBX_CHROME_TRACE_IMPLEMENTATION)
+#ifndef UFBX_CHROME_TRACE_H_IMPLEMENTED
+#define UFBX_CHROME_TRACE_H_IMPLEMENTED
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#include <intrin.h>
+
+typedef volatile long ufbxct_atomic_u32;
+static uint32_t ufbxct_atomic_u32_inc(ufbxct_atomic_u32 *ptr) { return (uint32_t)_InterlockedIncrement(ptr) - 1; }
+#define ufbxct_thread_local __declspec(thread)
+
+static uint64_t ufbxct_os_thread_id(void) { return (uint64_t)GetCurrentThreadId() + 1; }
+
+static uint64_t ufbxct_time_ns(void)
+{
+	LARGE_INTEGER freq, count;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&count);
+	return (uint64_t)((double)count.QuadPart * (1e9 / (double)freq.QuadPart));
+}
+
+#else
+
+#include <time.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+typedef volatile uint32_t ufbxct_atomic_u32;
+static uint32_t ufbxct_atomic_u32_inc(ufbxct_atomic_u32 *ptr) { return __atomic_fetch_add(ptr, 1, __ATOMIC_RELAXED); }
+#define ufbxct_thread_local __thread
+#else
+	#error "Unsupported compiler"
+#endif
+
+// `pthread_t` is opaque, the address of a thread-local variable is unique among running threads.
+static ufbxct_thread_local char ufbxct_thread_key;
+static uint64_t ufbxct_os_thread_id(void) { return (uint64_t)(uintptr_t)&ufbxct_thread_key; }
+
+static uint64_t ufbxct_time_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+#endif
+
+typedef struct {
+	const char *name;
+	uint64_t time_ns;
+	uint32_t thread_id;
+	bool begin;
+} ufbxct_event;
+
+struct ufbx_chrome_trace {
+	ufbx_chrome_trace_opts opts;
+	uint64_t start_ns;
+	uint32_t serial;
+
+	ufbxct_atomic_u32 next_event;
+	ufbxct_atomic_u32 next_thread_id;
+
+	ufbxct_event *events;
+
+	// OS thread IDs of threads that have recorded events, indexed by `tid - 1`.
+	// Each slot is written only by the thread it belongs to.
+	volatile uint64_t threads[UFBX_CHROME_TRACE_MAX_THREADS];
+};
+
+// Distinguishes traces that may have been allocated at the same address.
+static ufbxct_atomic_u32 ufbxct_next_serial;
+
+// Compact per-trace thread IDs, the last one used by each thread is cached.
+static ufbxct_thread_local uint32_t ufbxct_local_serial;
+static ufbxct_thread_local uint32_t ufbxct_local_thread_id;
+
+static uint32_t ufbxct_find_thread_id(ufbx_chrome_trace *trace)
+{
+	uint64_t os_id = ufbxct_os_thread_id();
+
+	// Only this thread can write its own ID so a plain scan finds it if it exists
+	uint32_t num_threads = (uint32_t)trace->next_thread_id;
+	if (num_threads > UFBX_CHROME_TRACE_MAX_THREADS) num_threads = UFBX_CHROME_TRACE_MAX_THREADS;
+	for (uint32_t i = 0; i < num_threads; i++) {
+		if (trace->threads[i] == os_id) return i + 1;
+	}
+
+	uint32_t index = ufbxct_atomic_u32_inc(&trace->next_thread_id);
+	if (index >= UFBX_CHROME_TRACE_MAX_THREADS) return 0;
+	trace->threads[index] = os_id;
+	return index + 1;
+}
+
+static void ufbxct_record(ufbx_chrome_trace *trace, const char *name, bool begin)
+{
+	uint64_t time_ns = ufbxct_time_ns();
+
+	if (ufbxct_local_serial != trace->serial) {
+		ufbxct_local_thread_id = ufbxct_find_thread_id(trace);
+		ufbxct_local_serial = trace->serial;
+	}
+
+	uint32_t index = ufbxct_atomic_u32_inc(&trace->next_event);
+	if (index >= trace->opts.max_events) return;
+
+	ufbxct_event *event = &trace->events[index];
+	event->name = name;
+	event->time_ns = time_ns;
+	event->thread_id = ufbxct_local_thread_id;
+	event->begin = begin;
+}
+
+static void ufbxct_begin_fn(void *user, const char *name)
+{
+	ufbxct_record((ufbx_chrome_trace*)user, name, true);
+}
+
+static void ufbxct_end_fn(void *user, const char *name)
+{
+	ufbxct_record((ufbx_chrome_trace*)user, name, false);
+}
+
+ufbx_chrome_trace_abi ufbx_chrome_trace *ufbx_chrome_trace_create(const ufbx_chrome_trace_opts *user_opts)
+{
+	ufbx_chrome_trace_opts opts;
+	if (user_opts) {
+		opts = *user_opts;
+	} else {
+		memset(&opts, 0, sizeof(opts));
+	}
+	if (opts.max_events == 0) {
+		opts.max_events = UFBX_CHROME_TRACE_DEFAULT_MAX_EVENTS;
+	}
+	if (opts.max_events > UINT32_MAX / 2) {
+		opts.max_events = UINT32_MAX / 2;
+	}
+
+	ufbx_chrome_trace *trace = (ufbx_chrome_trace*)calloc(1, sizeof(ufbx_chrome_trace));
+	if (!trace) return NULL;
+
+	trace->events = (ufbxct_event*)malloc(opts.max_events * sizeof(ufbxct_event));
+	if (!trace->events) {
+		free(trace);
+		return NULL;
+	}
+
+	trace->opts = opts;
+	trace->start_ns = ufbxct_time_ns();
+	trace->serial = ufbxct_atomic_u32_inc(&ufbxct_next_serial) + 1;
+	return trace;
+}
+
+ufbx_chrome_trace_abi void ufbx_chrome_trace_free(ufbx_chrome_trace *trace)
+{
+	if (!trace) return;
+	free(trace->events);
+	free(trace);
+}
+
+ufbx_chrome_trace_abi void ufbx_chrome_trace_init_ufbx_trace_cb(ufbx_trace_cb *dst, ufbx_chrome_trace *trace)
+{
+	dst->begin_fn = &ufbxct_begin_fn;
+	dst->end_fn = &ufbxct_end_fn;
+	dst->user = trace;
+}
+
+ufbx_chrome_trace_abi size_t ufbx_chrome_trace_dropped_events(const ufbx_chrome_trace *trace)
+{
+	size_t num_events = (size_t)trace->next_event;
+	return num_events > trace->opts.max_events ? num_events - trace->opts.max_events : 0;
+}
+
+ufbx_chrome_trace_abi bool ufbx_chrome_trace_write(const ufbx_chrome_trace *trace, const char *path)
+{
+	FILE *f = fopen(path, "w");
+	if (!f) return false;
+
+	size_t num_events = (size_t)trace->next_event;
+	if (num_events > trace->opts.max_events) {
+		num_events = trace->opts.max_events;
+	}
+
+	fprintf(f, "{\"traceEvents\":[\n");
+	for (size_t i = 0; i < num_events; i++) {
+		const ufbxct_event *event = &trace->events[i];
+		uint64_t time_ns = event->time_ns >= trace->start_ns ? event->time_ns - trace->start_ns : 0;
+
+		// Names are static identifiers from ufbx, but escape them just in case
+		fputs(i > 0 ? ",\n{\"name\":\"" : "{\"name\":\"", f);
+		for (const char *c = event->name; *c; c++) {
+			if (*c == '"' || *c == '\\') fputc('\\', f);
+			if ((unsigned char)*c >= 0x20) fputc(*c, f);
+		}
+		fprintf(f, "\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+			event->begin ? 'B' : 'E', (double)time_ns * 1e-3, event->thread_id);
+	}
+	fprintf(f, "\n]}\n");
+
+	bool ok = !ferror(f);
+	if (fclose(f) != 0) ok = false;
+	return ok;
+}
+
+#endif
+#endif
@@ -0,0 +1,372 @@
+#ifndef UFBX_LOAD_BATCH_H_INCLUDED
+#define UFBX_LOAD_BATCH_H_INCLUDED
+
+// Loads many files concurrently using a shared `ufbx_os_thread_pool`.
+// Scenes are delivered through a completion callback as soon as each one is ready.
+//
+//   static void on_complete(void *user, const ufbx_load_batch_item *item, size_t index, ufbx_scene *scene, const ufbx_error *error)
+//   {
+//       if (scene) {
+//           import_scene(scene);
+//           ufbx_free_scene(scene);
+//       }
+//   }
+//
+//   ufbx_load_batch_opts opts = { 0 };
+//   opts.pool = pool;
+//   opts.memory_budget = 1024*1024*1024;
+//   opts.complete_cb.fn = &on_complete;
+//   ufbx_load_batch(items, num_items, &opts);
+//
+// Files are started in order of decreasing size, and each load is given the
+// thread pool for its own internal parallelism only if it is large or if there
+// are not enough files left to keep all threads busy.
+//
+// Define `UFBX_LOAD_BATCH_IMPLEMENTATION` in one file before including this header.
+// Requires "ufbx_os.h" to be included before this header.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#if !defined(UFBX_OS_H_INCLUDED)
+	#error "ufbx_os.h" must be included before "ufbx_load_batch.h"
+#endif
+
+#ifndef ufbx_load_batch_abi
+#define ufbx_load_batch_abi
+#endif
+
+// Default estimate of the memory needed to load a file relative to its size.
+// Refined during a batch by the `ufbx_metadata.memory_peak` of finished loads.
+#ifndef UFBX_LOAD_BATCH_DEFAULT_MEMORY_RATIO
+#define UFBX_LOAD_BATCH_DEFAULT_MEMORY_RATIO 8.0
+#endif
+
+#ifndef UFBX_LOAD_BATCH_DEFAULT_INNER_THREADING_SIZE
+#define UFBX_LOAD_BATCH_DEFAULT_INNER_THREADING_SIZE (1024*1024)
+#endif
+
+typedef struct ufbx_load_batch_item {
+	// Path of the file to load, ignored if `data` is set.
+	const char *path;
+
+	// Load from memory instead of a file.
+	const void *data;
+	size_t data_size;
+
+	// Optional load options for this item, overriding `ufbx_load_batch_opts.load_opts`.
+	const ufbx_load_opts *load_opts;
+
+	// Free for use by the caller.
+	void *user;
+} ufbx_load_batch_item;
+
+// Called once for each item when it has finished loading.
+// On success `scene` is non-NULL and owned by the callback, call `ufbx_free_scene()`
+// when done with it. On failure `scene` is NULL and `error` describes the failure.
+// Called from thread pool threads, but never concurrently with itself.
+typedef void ufbx_load_batch_complete_fn(void *user, const ufbx_load_batch_item *item, size_t index, ufbx_scene *scene, const ufbx_error *error);
+
+typedef struct ufbx_load_batch_complete_cb {
+	ufbx_load_batch_complete_fn *fn;
+	void *user;
+} ufbx_load_batch_complete_cb;
+
+typedef struct ufbx_load_batch_opts {
+	uint32_t _begin_zero;
+
+	// Thread pool to load in, if NULL files are loaded one by one on the calling thread.
+	ufbx_os_thread_pool *pool;
+
+	// Load options used for items without `ufbx_load_batch_item.load_opts`.
+	// `thread_opts.pool` is overwritten, other thread options are respected.
+	ufbx_load_opts load_opts;
+
+	ufbx_load_batch_complete_cb complete_cb;
+
+	// Maximum number of files being loaded at the same time.
+	// Default: number of threads in `pool` plus the calling thread.
+	size_t max_concurrent_loads;
+
+	// Approximate limit for the memory used by loads in progress, zero for no limit.
+	// New loads are not started while their estimated memory use would exceed this,
+	// unless nothing else is loading. Scenes kept by `complete_cb` are not counted.
+	size_t memory_budget;
+
+	// Files at least this large always use the thread pool internally.
+	// Default: `UFBX_LOAD_BATCH_DEFAULT_INNER_THREADING_SIZE`
+	size_t inner_threading_size;
+
+	uint32_t _end_zero;
+} ufbx_load_batch_opts;
+
+typedef struct ufbx_load_batch_result {
+	size_t num_loaded;
+	size_t num_failed;
+
+	// Highest sum of the estimated memory of concurrent loads.
+	size_t peak_reserved_memory;
+} ufbx_load_batch_result;
+
+// Load `items` concurrently, returns when all items have completed.
+ufbx_load_batch_abi ufbx_load_batch_result ufbx_load_batch(const ufbx_load_batch_item *items, size_t num_items, const ufbx_load_batch_opts *opts);
+
+#endif
+
+#if defined(UFBX_LOAD_BATCH_IMPLEMENTATION)
+#ifndef UFBX_LOAD_BATCH_H_IMPLEMENTED
+#define UFBX_LOAD_BATCH_H_IMPLEMENTED
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+
+typedef SRWLOCK ufbxlb_mutex;
+typedef CONDITION_VARIABLE ufbxlb_cond;
+
+static void ufbxlb_mutex_init(ufbxlb_mutex *m) { InitializeSRWLock(m); }
+static void ufbxlb_mutex_free(ufbxlb_mutex *m) { (void)m; }
+static void ufbxlb_mutex_lock(ufbxlb_mutex *m) { AcquireSRWLockExclusive(m); }
+static void ufbxlb_mutex_unlock(ufbxlb_mutex *m) { ReleaseSRWLockExclusive(m); }
+static void ufbxlb_cond_init(ufbxlb_cond *c) { InitializeConditionVariable(c); }
+static void ufbxlb_cond_free(ufbxlb_cond *c) { (void)c; }
+static void ufbxlb_cond_wait(ufbxlb_cond *c, ufbxlb_mutex *m) { SleepConditionVariableSRW(c, m, INFINITE, 0); }
+static void ufbxlb_cond_broadcast(ufbxlb_cond *c) { WakeAllConditionVariable(c); }
+
+#else
+
+#include <pthread.h>
+
+typedef pthread_mutex_t ufbxlb_mutex;
+typedef pthread_cond_t ufbxlb_cond;
+
+static void ufbxlb_mutex_init(ufbxlb_mutex *m) { pthread_mutex_init(m, NULL); }
+static void ufbxlb_mutex_free(ufbxlb_mutex *m) { pthread_mutex_destroy(m); }
+static void ufbxlb_mutex_lock(ufbxlb_mutex *m) { pthread_mutex_lock(m); }
+static void ufbxlb_mutex_unlock(ufbxlb_mutex *m) { pthread_mutex_unlock(m); }
+static void ufbxlb_cond_init(ufbxlb_cond *c) { pthread_cond_init(c, NULL); }
+static void ufbxlb_cond_free(ufbxlb_cond *c) { pthread_cond_destroy(c); }
+static void ufbxlb_cond_wait(ufbxlb_cond *c, ufbxlb_mutex *m) { pthread_cond_wait(c, m); }
+static void ufbxlb_cond_broadcast(ufbxlb_cond *c) { pthread_cond_broadcast(c); }
+
+#endif
+
+typedef struct {
+	size_t index;
+	size_t size;
+} ufbxlb_entry;
+
+typedef struct {
+	const ufbx_load_batch_item *items;
+	const ufbx_load_batch_opts *opts;
+	ufbxlb_entry *entries;
+	size_t num_items;
+	size_t num_threads;
+
+	// Protected by `mutex`
+	ufbxlb_mutex mutex;
+	ufbxlb_cond cond;
+	size_t next_entry;
+	size_t num_in_flight;
+	size_t reserved_memory;
+	double memory_ratio;
+	ufbx_load_batch_result result;
+
+	// Serializes `complete_cb`
+	ufbxlb_mutex callback_mutex;
+} ufbxlb_batch;
+
+static size_t ufbxlb_item_size(const ufbx_load_batch_item *item)
+{
+	if (item->data) return item->data_size;
+	if (!item->path) return 0;
+
+	FILE *f = fopen(item->path, "rb");
+	if (!f) return 0;
+	long size = -1;
+	if (fseek(f, 0, SEEK_END) == 0) {
+		size = ftell(f);
+	}
+	fclose(f);
+	return size > 0 ? (size_t)size : 0;
+}
+
+static int ufbxlb_cmp_entry(const void *va, const void *vb)
+{
+	const ufbxlb_entry *a = (const ufbxlb_entry*)va, *b = (const ufbxlb_entry*)vb;
+	if (a->size != b->size) return a->size > b->size ? -1 : 1;
+	return a->index < b->index ? -1 : a->index > b->index ? 1 : 0;
+}
+
+static size_t ufbxlb_estimate_memory(ufbxlb_batch *batch, size_t size)
+{
+	double estimate = (double)size * batch->memory_ratio;
+	if (estimate < 64.0*1024.0) estimate = 64.0*1024.0;
+	if (estimate > (double)SIZE_MAX) return SIZE_MAX;
+	return (size_t)estimate;
+}
+
+static void ufbxlb_load_task(void *user, uint32_t slot)
+{
+	ufbxlb_batch *batch = (ufbxlb_batch*)user;
+	const ufbx_load_batch_opts *opts = batch->opts;
+	(void)slot;
+
+	for (;;) {
+		// Claim the next item once it fits in the memory budget
+		ufbxlb_mutex_lock(&batch->mutex);
+		size_t estimate = 0;
+		const ufbxlb_entry *entry = NULL;
+		while (batch->next_entry < batch->num_items) {
+			const ufbxlb_entry *next = &batch->entries[batch->next_entry];
+			estimate = ufbxlb_estimate_memory(batch, next->size);
+			size_t budget = opts->memory_budget;
+			if (budget == 0 || batch->num_in_flight == 0 || (batch->reserved_memory <= budget && estimate <= budget - batch->reserved_memory)) {
+				entry = next;
+				break;
+			}
+			ufbxlb_cond_wait(&batch->cond, &batch->mutex);
+		}
+		if (!entry) {
+			ufbxlb_mutex_unlock(&batch->mutex);
+			break;
+		}
+
+		batch->next_entry++;
+		batch->num_in_flight++;
+		batch->reserved_memory += estimate;
+		if (batch->reserved_memory > batch->result.peak_reserved_memory) {
+			batch->result.peak_reserved_memory = batch->reserved_memory;
+		}
+		size_t num_remaining = batch->num_items - batch->next_entry;
+		ufbxlb_mutex_unlock(&batch->mutex);
+
+		const ufbx_load_batch_item *item = &batch->items[entry->index];
+		ufbx_load_opts load_opts = item->load_opts ? *item->load_opts : opts->load_opts;
+		memset(&load_opts.thread_opts.pool, 0, sizeof(ufbx_thread_pool));
+
+		// Balance file and array parallelism: small files are loaded single-threaded
+		// as long as there are enough of them to keep all the threads busy.
+		if (opts->pool && (entry->size >= opts->inner_threading_size || num_remaining < batch->num_threads)) {
+			ufbx_os_init_ufbx_thread_pool(&load_opts.thread_opts.pool, opts->pool);
+		}
+
+		ufbx_error error;
+		ufbx_scene *scene = NULL;
+		if (item->data) {
+			scene = ufbx_load_memory(item->data, item->data_size, &load_opts, &error);
+		} else if (item->path) {
+			scene = ufbx_load_file(item->path, &load_opts, &error);
+		} else {
+			memset(&error, 0, sizeof(error));
+			error.type = UFBX_ERROR_FILE_NOT_FOUND;
+			error.description.data = "No path or data";
+			error.description.length = strlen(error.description.data);
+		}
+		bool loaded = scene != NULL;
+		size_t memory_peak = scene ? scene->metadata.memory_peak : 0;
+
+		if (opts->complete_cb.fn) {
+			ufbxlb_mutex_lock(&batch->callback_mutex);
+			opts->complete_cb.fn(opts->complete_cb.user, item, entry->index, scene, scene ? NULL : &error);
+			ufbxlb_mutex_unlock(&batch->callback_mutex);
+		} else if (scene) {
+			ufbx_free_scene(scene);
+		}
+
+		ufbxlb_mutex_lock(&batch->mutex);
+		batch->num_in_flight--;
+		batch->reserved_memory -= estimate;
+		if (loaded) {
+			batch->result.num_loaded++;
+			if (entry->size > 0 && memory_peak > 0) {
+				double ratio = (double)memory_peak / (double)entry->size;
+				if (ratio > batch->memory_ratio) batch->memory_ratio = ratio;
+			}
+		} else {
+			batch->result.num_failed++;
+		}
+		ufbxlb_cond_broadcast(&batch->cond);
+		ufbxlb_mutex_unlock(&batch->mutex);
+	}
+}
+
+ufbx_load_batch_abi ufbx_load_batch_result ufbx_load_batch(const ufbx_load_batch_item *items, size_t num_items, const ufbx_load_batch_opts *user_opts)
+{
+	ufbx_load_batch_opts opts;
+	if (user_opts) {
+		opts = *user_opts;
+	} else {
+		memset(&opts, 0, sizeof(opts));
+	}
+	if (opts.inner_threading_size == 0) {
+		opts.inner_threading_size = UFBX_LOAD_BATCH_DEFAULT_INNER_THREADING_SIZE;
+	}
+
+	ufbxlb_batch batch;
+	memset(&batch, 0, sizeof(batch));
+	batch.items = items;
+	batch.opts = &opts;
+	batch.num_items = num_items;
+	batch.memory_ratio = UFBX_LOAD_BATCH_DEFAULT_MEMORY_RATIO;
+	batch.num_threads = opts.pool ? ufbx_os_thread_pool_get_num_threads(opts.pool) + 1 : 1;
+
+	batch.entries = (ufbxlb_entry*)malloc((num_items > 0 ? num_items : 1) * sizeof(ufbxlb_entry));
+	if (!batch.entries) {
+		// Report every item as failed so that callers can rely on one callback per item
+		ufbx_error error;
+		memset(&error, 0, sizeof(error));
+		error.type = UFBX_ERROR_OUT_OF_MEMORY;
+		error.description.data = "Out of memory";
+		error.description.length = strlen(error.description.data);
+		for (size_t i = 0; i < num_items; i++) {
+			if (opts.complete_cb.fn) opts.complete_cb.fn(opts.complete_cb.user, &items[i], i, NULL, &error);
+		}
+		batch.result.num_failed = num_items;
+		return batch.result;
+	}
+
+	// Start the largest files first to avoid one big file finishing last
+	for (size_t i = 0; i < num_items; i++) {
+		batch.entries[i].index = i;
+		batch.entries[i].size = ufbxlb_item_size(&items[i]);
+	}
+	qsort(batch.entries, num_items, sizeof(ufbxlb_entry), &ufbxlb_cmp_entry);
+
+	ufbxlb_mutex_init(&batch.mutex);
+	ufbxlb_mutex_init(&batch.callback_mutex);
+	ufbxlb_cond_init(&batch.cond);
+
+	size_t num_slots = opts.max_concurrent_loads ? opts.max_concurrent_loads : batch.num_threads;
+	if (num_slots > num_items) num_slots = num_items;
+	if (num_slots > UINT32_MAX) num_slots = UINT32_MAX;
+
+	if (opts.pool && num_slots > 1) {
+		// The calling thread helps by running slots while waiting
+		uint64_t task_id = ufbx_os_thread_pool_run(opts.pool, &ufbxlb_load_task, &batch, (uint32_t)num_slots);
+		ufbx_os_thread_pool_wait(opts.pool, task_id);
+	} else if (num_slots > 0) {
+		ufbxlb_load_task(&batch, 0);
+	}
+
+	ufbxlb_cond_free(&batch.cond);
+	ufbxlb_mutex_free(&batch.callback_mutex);
+	ufbxlb_mutex_free(&batch.mutex);
+	free(batch.entries);
+
+	return batch.result;
+}
+
+#endif
+#endif
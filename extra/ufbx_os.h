@@ -21,8 +21,15 @@
 typedef struct ufbx_os_thread_pool_opts {
 	uint32_t _begin_zero;
 
+	// Number of worker threads, defaults to the number of logical cores
+	// clamped to `UFBX_OS_DEFAULT_MAX_THREADS`.
 	size_t max_threads;
 
+	// Start newly submitted work before continuing earlier work.
+	// Use this when running multiple loads from different threads in one shared
+	// pool, so that later loads do not have to wait for earlier ones to drain.
+	bool fair;
+
 	uint32_t _end_zero;
 } ufbx_os_thread_pool_opts;
 
@@ -31,6 +38,9 @@ typedef struct ufbx_os_thread_pool ufbx_os_thread_pool;
 ufbx_os_abi ufbx_os_thread_pool *ufbx_os_create_thread_pool(const ufbx_os_thread_pool_opts *user_opts);
 ufbx_os_abi void ufbx_os_free_thread_pool(ufbx_os_thread_pool *pool);
 
+// Number of worker threads in the pool, not counting threads that help while waiting.
+ufbx_os_abi size_t ufbx_os_thread_pool_get_num_threads(const ufbx_os_thread_pool *pool);
+
 ufbx_os_abi void ufbx_os_init_ufbx_thread_pool(ufbx_thread_pool *dst, ufbx_os_thread_pool *pool);
 
 typedef struct ufbx_os_thread_pool_task ufbx_os_thread_pool_task;
@@ -50,8 +60,10 @@ ufbx_os_abi void ufbx_os_thread_pool_wait(ufbx_os_thread_pool *pool, uint64_t ta
 #define UFBX_OS_H_IMPLEMENTED
 
 #include <stdlib.h>
+#include <string.h>
 
-static void ufbxos_thread_pool_entry(ufbx_os_thread_pool *pool);
+typedef struct ufbxos_worker ufbxos_worker;
+static void ufbxos_thread_pool_entry(ufbxos_worker *worker);
 
 #if defined(_WIN32)
 
@@ -65,6 +77,8 @@ static uint32_t ufbxos_atomic_u32_load_relaxed(ufbxos_atomic_u32 *ptr) { return
 static uint32_t ufbxos_atomic_u32_load(ufbxos_atomic_u32 *ptr) { return _InterlockedOr(ptr, 0); }
 static void ufbxos_atomic_u32_store(ufbxos_atomic_u32 *ptr, uint32_t value) { _InterlockedExchange(ptr, (LONG)value); }
 static uint32_t ufbxos_atomic_u32_inc(ufbxos_atomic_u32 *ptr) { return _InterlockedIncrement(ptr) - 1; }
+static uint32_t ufbxos_atomic_u32_dec(ufbxos_atomic_u32 *ptr) { return _InterlockedDecrement(ptr) + 1; }
+static uint32_t ufbxos_atomic_u32_sub(ufbxos_atomic_u32 *ptr, uint32_t value) { return (uint32_t)_InterlockedExchangeAdd(ptr, -(LONG)value); }
 static bool ufbxos_atomic_u32_cas(ufbxos_atomic_u32 *ptr, uint32_t ref, uint32_t value) { return _InterlockedCompareExchange(ptr, value, ref) == ref; }
 
 typedef volatile LONG64 ufbxos_atomic_u64;
@@ -105,13 +119,13 @@ typedef HANDLE ufbxos_os_thread;
 
 static DWORD WINAPI ufbxos_os_thread_entry(LPVOID user)
 {
-	ufbxos_thread_pool_entry((ufbx_os_thread_pool*)user);
+	ufbxos_thread_pool_entry((ufbxos_worker*)user);
 	return 0;
 }
 
-static bool ufbxos_os_thread_start(ufbxos_os_thread *os_thread, ufbx_os_thread_pool *pool)
+static bool ufbxos_os_thread_start(ufbxos_os_thread *os_thread, ufbxos_worker *worker)
 {
-	*os_thread = CreateThread(NULL, 0, &ufbxos_os_thread_entry, pool, 0, NULL);
+	*os_thread = CreateThread(NULL, 0, &ufbxos_os_thread_entry, worker, 0, NULL);
 	return *os_thread != NULL;
 }
 
@@ -142,6 +156,8 @@ static uint32_t ufbxos_atomic_u32_load_relaxed(ufbxos_atomic_u32 *ptr) { uint32_
 static uint32_t ufbxos_atomic_u32_load(ufbxos_atomic_u32 *ptr) { uint32_t r; __atomic_load(ptr, &r, __ATOMIC_SEQ_CST); return r; }
 static void ufbxos_atomic_u32_store(ufbxos_atomic_u32 *ptr, uint32_t value) { __atomic_store(ptr, &value, __ATOMIC_SEQ_CST); }
 static uint32_t ufbxos_atomic_u32_inc(ufbxos_atomic_u32 *ptr) { return __atomic_fetch_add(ptr, 1, __ATOMIC_SEQ_CST); }
+static uint32_t ufbxos_atomic_u32_dec(ufbxos_atomic_u32 *ptr) { return __atomic_fetch_sub(ptr, 1, __ATOMIC_SEQ_CST); }
+static uint32_t ufbxos_atomic_u32_sub(ufbxos_atomic_u32 *ptr, uint32_t value) { return __atomic_fetch_sub(ptr, value, __ATOMIC_SEQ_CST); }
 static bool ufbxos_atomic_u32_cas(ufbxos_atomic_u32 *ptr, uint32_t ref, uint32_t value) { return __atomic_compare_exchange(ptr, &ref, &value, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST); }
 
 #if defined(__i386__) || defined(__i386)
@@ -236,15 +252,14 @@ typedef pthread_t ufbxos_os_thread;
 
 static void *ufbxos_os_thread_entry(void *user)
 {
-	ufbxos_thread_pool_entry((ufbx_os_thread_pool*)user);
+	ufbxos_thread_pool_entry((ufbxos_worker*)user);
 	return NULL;
 }
 
-static bool ufbxos_os_thread_start(ufbxos_os_thread *os_thread, ufbx_os_thread_pool *pool)
+static bool ufbxos_os_thread_start(ufbxos_os_thread *os_thread, ufbxos_worker *worker)
 {
-	int res = pthread_create(os_thread, NULL, &ufbxos_os_thread_entry, pool);
-	if (res == 0) return false;
-	return true;
+	int res = pthread_create(os_thread, NULL, &ufbxos_os_thread_entry, worker);
+	return res == 0;
 }
 
 static void ufbxos_os_thread_join(ufbxos_os_thread *os_thread)
@@ -360,47 +375,74 @@ static uint64_t ufbxos_wait_entry_encode(ufbxos_wait_entry_state s)
 	return (uint64_t)(s.sema_index | s.hash << 8) | (uint64_t)s.sema_revision << 32;
 }
 
+#define UFBXOS_MAX_TASKS 256
+#define UFBXOS_TASK_INDEX_BITS 8
+#define UFBXOS_QUEUE_SIZE (UFBXOS_MAX_TASKS * 2)
+#define UFBXOS_DEQUE_SIZE 1024
+
 typedef struct {
-	// [0:16] refcount
-	// [16:64] cycle
-	ufbxos_atomic_u64 state;
+	// Incremented when all indices of the task have finished
+	ufbxos_atomic_u64 cycle;
 
-	ufbxos_atomic_u64 next;
+	// Number of indices that have not finished yet
+	ufbxos_atomic_u32 remaining;
 
 	ufbx_os_thread_pool_task_fn *fn;
 	void *user;
 	uint32_t count;
-	ufbxos_atomic_u32 counter;
-
 } ufbxos_task;
 
+// Range of indices `[begin, end)` of a single task, packed into 64 bits:
+// [0:8] task index, [8:36] begin, [36:64] end
 typedef struct {
-	uint32_t refcount;
-	uint64_t cycle;
-} ufbxos_task_state;
+	uint32_t task_index;
+	uint32_t begin;
+	uint32_t end;
+} ufbxos_work;
 
-static ufbxos_task_state ufbxos_task_decode(uint64_t state)
+#define UFBXOS_WORK_RANGE_BITS 28
+#define UFBXOS_WORK_MAX_RANGE (((uint32_t)1 << UFBXOS_WORK_RANGE_BITS) - 1)
+#define UFBXOS_WORK_ANY_TASK UINT32_MAX
+
+static ufbxos_work ufbxos_work_decode(uint64_t work)
 {
-	ufbxos_task_state s;
-	uint32_t state_lo = (uint32_t)state;
-	s.refcount = (state_lo >> 0) & 0xffff;
-	s.cycle = state >> 16;
-	return s;
+	ufbxos_work w;
+	w.task_index = (uint32_t)work & (UFBXOS_MAX_TASKS - 1);
+	w.begin = (uint32_t)(work >> UFBXOS_TASK_INDEX_BITS) & UFBXOS_WORK_MAX_RANGE;
+	w.end = (uint32_t)(work >> (UFBXOS_TASK_INDEX_BITS + UFBXOS_WORK_RANGE_BITS)) & UFBXOS_WORK_MAX_RANGE;
+	return w;
 }
 
-static uint64_t ufbxos_task_encode(ufbxos_task_state s)
+static uint64_t ufbxos_work_encode(ufbxos_work w)
 {
-	return (uint64_t)s.refcount | (s.cycle << 16);
+	return (uint64_t)w.task_index | (uint64_t)w.begin << UFBXOS_TASK_INDEX_BITS
+		| (uint64_t)w.end << (UFBXOS_TASK_INDEX_BITS + UFBXOS_WORK_RANGE_BITS);
 }
 
+// Chase-Lev work-stealing deque: the owning worker pushes and pops at `bottom`,
+// other threads steal from `top`.
+typedef struct {
+	ufbxos_atomic_u32 top;
+	char top_pad[60];
+	ufbxos_atomic_u32 bottom;
+	char bottom_pad[60];
+	ufbxos_atomic_u64 items[UFBXOS_DEQUE_SIZE];
+} ufbxos_deque;
+
+struct ufbxos_worker {
+	ufbx_os_thread_pool *pool;
+	ufbxos_os_thread thread;
+	uint32_t index;
+	uint32_t random_state;
+	ufbxos_deque deque;
+};
+
 #define UFBXOS_WAIT_SEMA_MAX_COUNT 64
 #define UFBXOS_WAIT_SEMA_SCAN 16
 
 #define UFBXOS_WAIT_MAP_SIZE 128
 #define UFBXOS_WAIT_MAP_SCAN 2
 
-#define UFBXOS_TASK_FREE_BIT ((uint64_t)1<<63)
-
 struct ufbx_os_thread_pool {
 	ufbxos_atomic_u32 wait_sema_lock;
 	ufbxos_atomic_u32 wait_sema_count;
@@ -408,18 +450,27 @@ struct ufbx_os_thread_pool {
 
 	ufbxos_wait_entry wait_map[UFBXOS_WAIT_MAP_SIZE];
 
-	uint32_t num_tasks;
-	uint32_t task_cycle_shift;
-	uint32_t task_index_mask;
-	ufbxos_task *tasks;
+	bool fair;
+
+	ufbxos_task tasks[UFBXOS_MAX_TASKS];
 
-	ufbxos_atomic_u64 task_alloc_head;
-	ufbxos_atomic_u64 task_work_tail;
-	ufbxos_atomic_u64 task_work_head;
-	ufbxos_atomic_u32 task_init_count;
+	// Protects `free_tasks` and `queue`
+	ufbxos_atomic_u32 lock;
+	uint32_t free_tasks[UFBXOS_MAX_TASKS];
+	uint32_t num_free_tasks;
+
+	// Newly submitted work from any thread, FIFO
+	uint64_t queue[UFBXOS_QUEUE_SIZE];
+	uint32_t queue_head;
+	ufbxos_atomic_u32 queue_count;
+
+	// Incremented when work is added, idle workers sleep on this
+	ufbxos_atomic_u32 work_epoch;
+	ufbxos_atomic_u32 num_sleeping;
+	ufbxos_atomic_u32 shutdown;
 
 	uint32_t num_threads;
-	ufbxos_os_thread *threads;
+	ufbxos_worker *workers;
 };
 
 static uint32_t ufbxos_wait_sema_create(ufbx_os_thread_pool *pool)
@@ -765,152 +816,278 @@ static void ufbxos_atomic_notify64(ufbx_os_thread_pool *pool, ufbxos_atomic_u64
 #endif
 }
 
-static uint32_t ufbxos_task_index(ufbx_os_thread_pool *pool, uint64_t task_id)
+static void ufbxos_lock(ufbx_os_thread_pool *pool)
 {
-	return (uint32_t)task_id & pool->task_index_mask;
+	while (!ufbxos_atomic_u32_cas(&pool->lock, 0, 1)) {
+		ufbxos_os_yield();
+	}
 }
 
-static uint64_t ufbxos_task_cycle(ufbx_os_thread_pool *pool, uint64_t task_id)
+static void ufbxos_unlock(ufbx_os_thread_pool *pool)
 {
-	return task_id >> pool->task_cycle_shift;
+	ufbxos_atomic_u32_store(&pool->lock, 0);
 }
 
-static uint64_t ufbxos_task_id(ufbx_os_thread_pool *pool, uint32_t index, uint64_t cycle)
+static uint32_t ufbxos_task_index(uint64_t task_id)
 {
-	ufbxos_assert(index <= pool->task_index_mask);
-	return (cycle << pool->task_cycle_shift) | index;
+	return (uint32_t)task_id & (UFBXOS_MAX_TASKS - 1);
 }
 
-static uint64_t ufbxos_push_task(ufbx_os_thread_pool *pool, ufbx_os_thread_pool_task_fn *fn, void *user, uint32_t count)
+static uint64_t ufbxos_task_cycle(uint64_t task_id)
 {
-	uint64_t task_id = ufbxos_atomic_u64_load(&pool->task_alloc_head);
-	for (;;) {
-		if (task_id == 0) {
-			if (ufbxos_atomic_u32_load_relaxed(&pool->task_init_count) < pool->num_tasks) {
-				uint32_t index = ufbxos_atomic_u32_inc(&pool->task_init_count);
-				if (index < pool->num_tasks) {
-					task_id = index;
-					break;
-				}
-			}
+	return task_id >> UFBXOS_TASK_INDEX_BITS;
+}
 
-			ufbxos_atomic_wait64(pool, &pool->task_alloc_head, 0);
-			continue;
-		}
+static uint64_t ufbxos_task_id(uint32_t index, uint64_t cycle)
+{
+	ufbxos_assert(index < UFBXOS_MAX_TASKS);
+	return (cycle << UFBXOS_TASK_INDEX_BITS) | index;
+}
 
-		ufbxos_task *task = &pool->tasks[ufbxos_task_index(pool, task_id)];
-		uint64_t next_id = ufbxos_atomic_u64_load(&task->next);
-		if (ufbxos_atomic_u64_cas(&pool->task_alloc_head, &task_id, next_id & ~UFBXOS_TASK_FREE_BIT)) {
-			ufbxos_assert(next_id & UFBXOS_TASK_FREE_BIT);
-			break;
-		}
+// -- Deque
+
+static bool ufbxos_deque_push(ufbxos_deque *deque, uint64_t work)
+{
+	uint32_t bottom = ufbxos_atomic_u32_load_relaxed(&deque->bottom);
+	uint32_t top = ufbxos_atomic_u32_load(&deque->top);
+	if (bottom - top >= UFBXOS_DEQUE_SIZE) return false;
+
+	ufbxos_atomic_u64_store(&deque->items[bottom % UFBXOS_DEQUE_SIZE], work);
+	ufbxos_atomic_u32_store(&deque->bottom, bottom + 1);
+	return true;
+}
+
+static bool ufbxos_deque_pop(ufbxos_deque *deque, uint64_t *p_work)
+{
+	uint32_t bottom = ufbxos_atomic_u32_load_relaxed(&deque->bottom) - 1;
+	ufbxos_atomic_u32_store(&deque->bottom, bottom);
+	uint32_t top = ufbxos_atomic_u32_load(&deque->top);
+
+	int32_t size = (int32_t)(bottom - top);
+	if (size < 0) {
+		ufbxos_atomic_u32_store(&deque->bottom, top);
+		return false;
 	}
 
-	uint32_t task_index = ufbxos_task_index(pool, task_id);
-	uint64_t task_cycle = ufbxos_task_cycle(pool, task_id);
-	ufbxos_task *task = &pool->tasks[task_index];
+	*p_work = ufbxos_atomic_u64_load(&deque->items[bottom % UFBXOS_DEQUE_SIZE]);
+	if (size > 0) return true;
 
-	task->fn = fn;
-	task->user = user;
-	task->count = count;
-	ufbxos_atomic_u32_store(&task->counter, 0);
-	ufbxos_atomic_u64_store(&task->next, task_id);
-	ufbxos_atomic_notify64(pool, &task->next);
-	uint64_t work_head = ufbxos_atomic_u64_load(&pool->task_work_head);
+	// Last item, race against thieves for it
+	bool ok = ufbxos_atomic_u32_cas(&deque->top, top, top + 1);
+	ufbxos_atomic_u32_store(&deque->bottom, top + 1);
+	return ok;
+}
+
+// Steal the topmost work item, fails if `task_index` is not `UFBXOS_WORK_ANY_TASK`
+// and the item belongs to a different task.
+static bool ufbxos_deque_steal(ufbxos_deque *deque, uint64_t *p_work, uint32_t task_index)
+{
 	for (;;) {
-		ufbxos_task *prev = &pool->tasks[ufbxos_task_index(pool, work_head)];
+		uint32_t top = ufbxos_atomic_u32_load(&deque->top);
+		uint32_t bottom = ufbxos_atomic_u32_load(&deque->bottom);
+		if ((int32_t)(bottom - top) <= 0) return false;
 
-		if (ufbxos_atomic_u64_cas(&pool->task_work_head, &work_head, task_id)) {
-			ufbxos_atomic_u64_store(&prev->next, task_id);
-			ufbxos_atomic_notify64(pool, &prev->next);
-			break;
+		uint64_t work = ufbxos_atomic_u64_load(&deque->items[top % UFBXOS_DEQUE_SIZE]);
+		if (task_index != UFBXOS_WORK_ANY_TASK && ufbxos_work_decode(work).task_index != task_index) return false;
+
+		if (ufbxos_atomic_u32_cas(&deque->top, top, top + 1)) {
+			*p_work = work;
+			return true;
 		}
 	}
+}
 
-	return task_id;
+// -- Queue
+
+static bool ufbxos_queue_push(ufbx_os_thread_pool *pool, uint64_t work)
+{
+	bool ok = false;
+	ufbxos_lock(pool);
+	uint32_t count = ufbxos_atomic_u32_load_relaxed(&pool->queue_count);
+	if (count < UFBXOS_QUEUE_SIZE) {
+		pool->queue[(pool->queue_head + count) % UFBXOS_QUEUE_SIZE] = work;
+		ufbxos_atomic_u32_store(&pool->queue_count, count + 1);
+		ok = true;
+	}
+	ufbxos_unlock(pool);
+	return ok;
 }
 
-static void ufbxos_thread_pool_entry(ufbx_os_thread_pool *pool)
+// Pop the oldest queued work item, optionally only of `task_index`.
+static bool ufbxos_queue_pop(ufbx_os_thread_pool *pool, uint64_t *p_work, uint32_t task_index)
 {
-	uint64_t task_id = 0;
-	for (;;) {
-		uint32_t task_index = ufbxos_task_index(pool, task_id);
-		uint64_t task_cycle = ufbxos_task_cycle(pool, task_id);
-		ufbxos_task *task = &pool->tasks[task_index];
+	if (ufbxos_atomic_u32_load_relaxed(&pool->queue_count) == 0) return false;
 
-		bool ok = false;
-		uint64_t old_state = ufbxos_atomic_u64_load(&task->state);
-		for (;;) {
-			ufbxos_task_state s = ufbxos_task_decode(old_state);
-			if (s.cycle > task_cycle) break;
-			if (s.refcount >= 0xffff) break;
+	bool ok = false;
+	ufbxos_lock(pool);
+	uint32_t count = ufbxos_atomic_u32_load_relaxed(&pool->queue_count);
+	for (uint32_t i = 0; i < count; i++) {
+		uint64_t work = pool->queue[(pool->queue_head + i) % UFBXOS_QUEUE_SIZE];
+		if (task_index != UFBXOS_WORK_ANY_TASK && ufbxos_work_decode(work).task_index != task_index) continue;
 
-			s.refcount += 1;
-			if (ufbxos_atomic_u64_cas(&task->state, &old_state, ufbxos_task_encode(s))) {
-				ok = true;
-				break;
-			}
+		// Keep the queue in order by shifting the preceding items forward
+		for (uint32_t j = i; j > 0; j--) {
+			pool->queue[(pool->queue_head + j) % UFBXOS_QUEUE_SIZE] = pool->queue[(pool->queue_head + j - 1) % UFBXOS_QUEUE_SIZE];
 		}
+		pool->queue_head = (pool->queue_head + 1) % UFBXOS_QUEUE_SIZE;
+		ufbxos_atomic_u32_store(&pool->queue_count, count - 1);
 
-		uint64_t free_task_id = 0;
-		if (ok) {
-			ufbx_os_thread_pool_task_fn *fn = task->fn;
+		*p_work = work;
+		ok = true;
+		break;
+	}
+	ufbxos_unlock(pool);
+	return ok;
+}
 
-			void *user = task->user;
-			uint32_t count = task->count;
-			for (;;) {
-				uint32_t index = ufbxos_atomic_u32_inc(&task->counter);
-				if (index >= count) break;
-				if (fn == NULL) return;
-				fn(user, index);
-			}
+// -- Scheduling
 
-			old_state = ufbxos_atomic_u64_load(&task->state);
-			for (;;) {
-				ufbxos_task_state s = ufbxos_task_decode(old_state);
-				s.refcount -= 1;
-				if (s.refcount == 0) {
-					s.cycle += 1;
-				}
-				if (ufbxos_atomic_u64_cas(&task->state, &old_state, ufbxos_task_encode(s))) {
-					if (s.refcount == 0) {
-						ufbxos_atomic_notify64(pool, &task->state);
-						// TODO: if (cycle <= max_cycle)
-						free_task_id = ufbxos_task_id(pool, task_index, s.cycle);
-					}
-					break;
-				}
-			}
+static void ufbxos_wake_workers(ufbx_os_thread_pool *pool)
+{
+	ufbxos_atomic_u32_inc(&pool->work_epoch);
+	if (ufbxos_atomic_u32_load(&pool->num_sleeping) > 0) {
+		ufbxos_atomic_notify32(pool, &pool->work_epoch);
+	}
+}
+
+static uint32_t ufbxos_alloc_task(ufbx_os_thread_pool *pool)
+{
+	for (;;) {
+		ufbxos_lock(pool);
+		if (pool->num_free_tasks > 0) {
+			uint32_t index = pool->free_tasks[--pool->num_free_tasks];
+			ufbxos_unlock(pool);
+			return index;
 		}
+		ufbxos_unlock(pool);
 
-		uint64_t prev_task_id = task_id;
-		for (;;) {
-			task_id = ufbxos_atomic_u64_load(&pool->task_work_tail);
-			if (task_id != prev_task_id) break;
+		// All task slots are in use, wait for some to finish
+		ufbxos_os_yield();
+	}
+}
 
-			task_id = ufbxos_atomic_u64_load(&task->next);
-			if (task_id == prev_task_id) {
-				ufbxos_atomic_wait64(pool, &task->next, prev_task_id);
-				continue;
-			}
+static void ufbxos_finish_task(ufbx_os_thread_pool *pool, uint32_t task_index)
+{
+	ufbxos_task *task = &pool->tasks[task_index];
 
-			uint64_t ref_task_id = prev_task_id;
-			if (ufbxos_atomic_u64_cas(&pool->task_work_tail, &ref_task_id, task_id)) {
-				break;
-			}
+	uint64_t cycle = ufbxos_atomic_u64_load(&task->cycle);
+	ufbxos_atomic_u64_store(&task->cycle, cycle + 1);
+	ufbxos_atomic_notify64(pool, &task->cycle);
+
+	ufbxos_lock(pool);
+	pool->free_tasks[pool->num_free_tasks++] = task_index;
+	ufbxos_unlock(pool);
+}
+
+static void ufbxos_run_range(ufbx_os_thread_pool *pool, uint32_t task_index, uint32_t begin, uint32_t end)
+{
+	ufbxos_task *task = &pool->tasks[task_index];
+	ufbx_os_thread_pool_task_fn *fn = task->fn;
+	void *user = task->user;
+	for (uint32_t i = begin; i < end; i++) {
+		fn(user, i);
+	}
+
+	uint32_t count = end - begin;
+	if (ufbxos_atomic_u32_sub(&task->remaining, count) == count) {
+		ufbxos_finish_task(pool, task_index);
+	}
+}
+
+static void ufbxos_worker_execute(ufbxos_worker *worker, uint64_t work)
+{
+	ufbx_os_thread_pool *pool = worker->pool;
+	ufbxos_work w = ufbxos_work_decode(work);
+
+	// Split off the back halves for other workers to steal, keeping the front
+	// of the range which contains the most expensive indices if sorted by cost
+	bool pushed = false;
+	while (w.end - w.begin > 1) {
+		ufbxos_work rest = w;
+		rest.begin = w.begin + (w.end - w.begin) / 2;
+		if (!ufbxos_deque_push(&worker->deque, ufbxos_work_encode(rest))) break;
+		w.end = rest.begin;
+		pushed = true;
+	}
+
+	// NOTE: This can miss a worker that is just about to sleep, which only
+	// delays stealing until the next time work is submitted.
+	if (pushed && ufbxos_atomic_u32_load(&pool->num_sleeping) > 0) {
+		ufbxos_wake_workers(pool);
+	}
+
+	ufbxos_run_range(pool, w.task_index, w.begin, w.end);
+}
+
+static uint32_t ufbxos_random(ufbxos_worker *worker)
+{
+	uint32_t x = worker->random_state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	worker->random_state = x;
+	return x;
+}
+
+static bool ufbxos_steal(ufbx_os_thread_pool *pool, uint64_t *p_work, uint32_t first_victim, uint32_t self, uint32_t task_index)
+{
+	for (uint32_t i = 0; i < pool->num_threads; i++) {
+		uint32_t victim = (first_victim + i) % pool->num_threads;
+		if (victim == self) continue;
+		if (ufbxos_deque_steal(&pool->workers[victim].deque, p_work, task_index)) return true;
+	}
+	return false;
+}
+
+static bool ufbxos_find_work(ufbxos_worker *worker, uint64_t *p_work)
+{
+	ufbx_os_thread_pool *pool = worker->pool;
+
+	// In fair mode newly submitted work is started before continuing existing
+	// work, so that a load does not have to wait for earlier ones to drain.
+	if (pool->fair && ufbxos_queue_pop(pool, p_work, UFBXOS_WORK_ANY_TASK)) return true;
+	if (ufbxos_deque_pop(&worker->deque, p_work)) return true;
+	if (!pool->fair && ufbxos_queue_pop(pool, p_work, UFBXOS_WORK_ANY_TASK)) return true;
+
+	uint32_t first_victim = ufbxos_random(worker) % pool->num_threads;
+	return ufbxos_steal(pool, p_work, first_victim, worker->index, UFBXOS_WORK_ANY_TASK);
+}
+
+static void ufbxos_thread_pool_entry(ufbxos_worker *worker)
+{
+	ufbx_os_thread_pool *pool = worker->pool;
+	for (;;) {
+		uint32_t epoch = ufbxos_atomic_u32_load(&pool->work_epoch);
+
+		uint64_t work;
+		if (ufbxos_find_work(worker, &work)) {
+			ufbxos_worker_execute(worker, work);
+			continue;
 		}
 
-		if (free_task_id != 0) {
-			uint64_t prev_head = ufbxos_atomic_u64_load(&pool->task_alloc_head);
-			for (;;) {
-				ufbxos_atomic_u64_store(&task->next, prev_head | UFBXOS_TASK_FREE_BIT);
-				ufbxos_atomic_notify64(pool, &task->next);
-				if (ufbxos_atomic_u64_cas(&pool->task_alloc_head, &prev_head, free_task_id)) {
-					break;
-				}
-			}
+		if (ufbxos_atomic_u32_load(&pool->shutdown)) break;
+
+		ufbxos_atomic_u32_inc(&pool->num_sleeping);
+		if (ufbxos_atomic_u32_load(&pool->work_epoch) == epoch) {
+			ufbxos_atomic_wait32(pool, &pool->work_epoch, epoch);
+		}
+		ufbxos_atomic_u32_dec(&pool->num_sleeping);
+	}
+}
+
+// Execute the first index of `work` on a waiting thread, the remaining range
+// is pushed back to the queue for workers or the next iteration.
+static void ufbxos_help_execute(ufbx_os_thread_pool *pool, uint64_t work)
+{
+	ufbxos_work w = ufbxos_work_decode(work);
+	if (w.end - w.begin > 1) {
+		ufbxos_work rest = w;
+		rest.begin = w.begin + 1;
+		if (ufbxos_queue_push(pool, ufbxos_work_encode(rest))) {
+			w.end = rest.begin;
 		}
 	}
+	ufbxos_run_range(pool, w.task_index, w.begin, w.end);
 }
 
 // -- API
@@ -925,14 +1102,18 @@ ufbx_os_abi ufbx_os_thread_pool *ufbx_os_create_thread_pool(const ufbx_os_thread
 	}
 
 	ufbx_os_thread_pool *pool = (ufbx_os_thread_pool*)calloc(1, sizeof(ufbx_os_thread_pool));
+	if (!pool) return NULL;
+
 	for (uint32_t i = 0; i < 2; i++) {
 		ufbxos_wait_sema_create(pool);
 	}
 
-	pool->num_tasks = 256;
-	pool->task_index_mask = pool->num_tasks - 1;
-	pool->task_cycle_shift = 8;
-	pool->tasks = (ufbxos_task*)calloc(pool->num_tasks, sizeof(ufbxos_task));
+	pool->fair = opts.fair;
+
+	for (uint32_t i = 0; i < UFBXOS_MAX_TASKS; i++) {
+		pool->free_tasks[i] = UFBXOS_MAX_TASKS - 1 - i;
+	}
+	pool->num_free_tasks = UFBXOS_MAX_TASKS;
 
 	size_t num_threads = opts.max_threads;
 	if (num_threads == 0) {
@@ -941,15 +1122,28 @@ ufbx_os_abi ufbx_os_thread_pool *ufbx_os_create_thread_pool(const ufbx_os_thread
 			num_threads = UFBX_OS_DEFAULT_MAX_THREADS;
 		}
 	}
+	if (num_threads == 0) {
+		num_threads = 1;
+	}
 
-	pool->num_threads = num_threads;
+	pool->num_threads = (uint32_t)num_threads;
 
-	pool->threads = (ufbxos_os_thread*)calloc(pool->num_threads, sizeof(ufbxos_os_thread));
-	for (uint32_t i = 0; i < pool->num_threads; i++) {
-		ufbxos_os_thread_start(&pool->threads[i], pool);
+	pool->workers = (ufbxos_worker*)calloc(pool->num_threads, sizeof(ufbxos_worker));
+	if (!pool->workers) {
+		free(pool);
+		return NULL;
 	}
 
-	ufbxos_atomic_u32_store(&pool->task_init_count, 1);
+	for (uint32_t i = 0; i < pool->num_threads; i++) {
+		ufbxos_worker *worker = &pool->workers[i];
+		worker->pool = pool;
+		worker->index = i;
+		worker->random_state = 0x9e3779b9u * (i + 1);
+	}
+	for (uint32_t i = 0; i < pool->num_threads; i++) {
+		ufbxos_worker *worker = &pool->workers[i];
+		ufbxos_os_thread_start(&worker->thread, worker);
+	}
 
 	return pool;
 }
@@ -958,9 +1152,11 @@ ufbx_os_abi void ufbx_os_free_thread_pool(ufbx_os_thread_pool *pool)
 {
 	if (!pool) return;
 
-	ufbxos_push_task(pool, NULL, NULL, pool->num_threads);
+	ufbxos_atomic_u32_store(&pool->shutdown, 1);
+	ufbxos_atomic_u32_inc(&pool->work_epoch);
+	ufbxos_atomic_notify32(pool, &pool->work_epoch);
 	for (size_t i = 0; i < pool->num_threads; i++) {
-		ufbxos_os_thread_join(&pool->threads[i]);
+		ufbxos_os_thread_join(&pool->workers[i].thread);
 	}
 
 	uint32_t sema_count = ufbxos_atomic_u32_load(&pool->wait_sema_count);
@@ -969,43 +1165,91 @@ ufbx_os_abi void ufbx_os_free_thread_pool(ufbx_os_thread_pool *pool)
 		ufbxos_os_semaphore_free(&pool->wait_semas[i].os_semaphore[1]);
 	}
 
-	free(pool->tasks);
-	free(pool->threads);
+	free(pool->workers);
 	free(pool);
 }
 
+ufbx_os_abi size_t ufbx_os_thread_pool_get_num_threads(const ufbx_os_thread_pool *pool)
+{
+	return pool->num_threads;
+}
+
 ufbx_os_abi uint64_t ufbx_os_thread_pool_run(ufbx_os_thread_pool *pool, ufbx_os_thread_pool_task_fn *fn, void *user, uint32_t count)
 {
 	ufbxos_assert(fn != NULL);
-	return ufbxos_push_task(pool, fn, user, count);
+
+	uint32_t task_index = ufbxos_alloc_task(pool);
+	ufbxos_task *task = &pool->tasks[task_index];
+	uint64_t task_id = ufbxos_task_id(task_index, ufbxos_atomic_u64_load(&task->cycle));
+
+	if (count == 0) {
+		ufbxos_finish_task(pool, task_index);
+		return task_id;
+	}
+
+	task->fn = fn;
+	task->user = user;
+	task->count = count;
+	ufbxos_atomic_u32_store(&task->remaining, count);
+
+	for (uint32_t begin = 0; begin < count; ) {
+		ufbxos_work w;
+		w.task_index = task_index;
+		w.begin = begin;
+		w.end = count - begin > UFBXOS_WORK_MAX_RANGE ? begin + UFBXOS_WORK_MAX_RANGE : count;
+		begin = w.end;
+
+		// Ranges past the packed limit are executed directly if the queue is full
+		if (w.end > UFBXOS_WORK_MAX_RANGE || !ufbxos_queue_push(pool, ufbxos_work_encode(w))) {
+			ufbxos_run_range(pool, task_index, w.begin, w.end);
+		}
+	}
+
+	ufbxos_wake_workers(pool);
+	return task_id;
 }
 
 ufbx_os_abi bool ufbx_os_thread_pool_try_wait(ufbx_os_thread_pool *pool, uint64_t task_id)
 {
-	uint32_t task_index = ufbxos_task_index(pool, task_id);
-	uint64_t task_cycle = ufbxos_task_cycle(pool, task_id);
-	ufbxos_task *task = &pool->tasks[task_index];
-	ufbxos_task_state s = ufbxos_task_decode(ufbxos_atomic_u64_load(&task->state));
-	return s.cycle > task_cycle;
+	ufbxos_task *task = &pool->tasks[ufbxos_task_index(task_id)];
+	return ufbxos_atomic_u64_load(&task->cycle) > ufbxos_task_cycle(task_id);
 }
 
 ufbx_os_abi void ufbx_os_thread_pool_wait(ufbx_os_thread_pool *pool, uint64_t task_id)
 {
-	uint32_t task_index = ufbxos_task_index(pool, task_id);
-	uint64_t task_cycle = ufbxos_task_cycle(pool, task_id);
+	uint32_t task_index = ufbxos_task_index(task_id);
+	uint64_t task_cycle = ufbxos_task_cycle(task_id);
 	ufbxos_task *task = &pool->tasks[task_index];
+	uint32_t first_victim = task_index % pool->num_threads;
 	for (;;) {
-		uint64_t state = ufbxos_atomic_u64_load(&task->state);
-		ufbxos_task_state s = ufbxos_task_decode(state);
-		if (s.cycle > task_cycle) return;
-		ufbxos_atomic_wait64(pool, &task->state, state);
+		uint64_t cycle = ufbxos_atomic_u64_load(&task->cycle);
+		if (cycle > task_cycle) return;
+
+		// Help with the remaining work of this task instead of idling
+		uint64_t work;
+		if (ufbxos_queue_pop(pool, &work, task_index) || ufbxos_steal(pool, &work, first_victim, UINT32_MAX, task_index)) {
+			ufbxos_help_execute(pool, work);
+			continue;
+		}
+
+		ufbxos_atomic_wait64(pool, &task->cycle, cycle);
 	}
 }
 
+typedef struct {
+	double cost;
+	uint32_t index;
+} ufbxos_task_order;
+
+// Limit for sorting tasks by cost, larger thread pools run tasks in order
+#define UFBXOS_MAX_ORDERED_TASKS (64*1024)
+
 typedef struct {
 	uint64_t task_id;
-	uint32_t start_index; 
+	uint32_t start_index;
+	bool ordered;
 	ufbx_thread_pool_context ctx;
+	ufbxos_task_order *order;
 } ufbxos_pool_group;
 
 typedef struct {
@@ -1013,23 +1257,45 @@ typedef struct {
 		ufbxos_pool_group group;
 		char padding[64];
 	} groups[UFBX_THREAD_GROUP_COUNT];
+	uint32_t max_tasks;
 	void *allocation;
 } ufbxos_pool_ctx;
 
 static void ufbxos_ufbx_task(void *user, uint32_t index)
 {
 	ufbxos_pool_group *group = (ufbxos_pool_group*)user;
-	ufbx_thread_pool_run_task(group->ctx, group->start_index + index);
+	if (group->ordered) {
+		ufbx_thread_pool_run_task(group->ctx, group->order[index].index);
+	} else {
+		ufbx_thread_pool_run_task(group->ctx, group->start_index + index);
+	}
+}
+
+static int ufbxos_cmp_task_order(const void *va, const void *vb)
+{
+	const ufbxos_task_order *a = (const ufbxos_task_order*)va, *b = (const ufbxos_task_order*)vb;
+	if (a->cost != b->cost) return a->cost > b->cost ? -1 : 1;
+	return a->index < b->index ? -1 : a->index > b->index ? 1 : 0;
 }
 
 static bool ufbxos_ufbx_thread_pool_init(void *user, ufbx_thread_pool_context ctx, const ufbx_thread_pool_info *info)
 {
-	void *allocation = calloc(1, sizeof(ufbxos_pool_ctx) + 128);
+	uint32_t max_tasks = info->max_concurrent_tasks;
+	if (max_tasks > UFBXOS_MAX_ORDERED_TASKS) max_tasks = 0;
+
+	size_t order_size = (size_t)max_tasks * sizeof(ufbxos_task_order);
+	void *allocation = calloc(1, sizeof(ufbxos_pool_ctx) + 128 + order_size * UFBX_THREAD_GROUP_COUNT);
 	if (!allocation) return false;
 
 	char *data = (char*)allocation + (((uintptr_t)-(intptr_t)allocation) & 63);
 	ufbxos_pool_ctx *up = (ufbxos_pool_ctx*)data;
 	up->allocation = allocation;
+	up->max_tasks = max_tasks;
+
+	ufbxos_task_order *order = (ufbxos_task_order*)(data + sizeof(ufbxos_pool_ctx));
+	for (uint32_t i = 0; i < UFBX_THREAD_GROUP_COUNT; i++) {
+		up->groups[i].group.order = order + (size_t)i * max_tasks;
+	}
 
 	ufbx_thread_pool_set_user_ptr(ctx, up);
 
@@ -1044,6 +1310,23 @@ static bool ufbxos_ufbx_thread_pool_run(void *user, ufbx_thread_pool_context ctx
 
 	ug->start_index = start_index;
 	ug->ctx = ctx;
+
+	// Run the most expensive tasks first to avoid a long tail where one
+	// worker is busy with a large task while the rest are idle.
+	ug->ordered = false;
+	if (count > 1 && count <= up->max_tasks) {
+		bool uniform = true;
+		for (uint32_t i = 0; i < count; i++) {
+			ug->order[i].cost = ufbx_thread_pool_get_task_cost(ctx, start_index + i);
+			ug->order[i].index = start_index + i;
+			if (ug->order[i].cost != ug->order[0].cost) uniform = false;
+		}
+		if (!uniform) {
+			qsort(ug->order, count, sizeof(ufbxos_task_order), &ufbxos_cmp_task_order);
+			ug->ordered = true;
+		}
+	}
+
 	ug->task_id = ufbx_os_thread_pool_run(pool, &ufbxos_ufbx_task, ug, count);
 
 	return true;
@@ -1062,7 +1345,7 @@ static bool ufbxos_ufbx_thread_pool_wait(void *user, ufbx_thread_pool_context ct
 
 static void ufbxos_ufbx_thread_pool_free(void *user, ufbx_thread_pool_context ctx)
 {
-	ufbx_os_thread_pool *pool = (ufbx_os_thread_pool*)user;
+	(void)user;
 	ufbxos_pool_ctx *up = (ufbxos_pool_ctx*)ufbx_thread_pool_get_user_ptr(ctx);
 
 	free(up->allocation);
@@ -0,0 +1,211 @@
+# Generates the type tables used by `ufbx_save_scene_snapshot()` in `ufbx.c`.
+# Run `python3 bindgen/ufbx_parser.py` first to produce `bindgen/build/ufbx.json`.
+# Paste the output over the generated block in the "Scene snapshot" section.
+
+import argparse
+import json
+import os
+import sys
+
+src_path = os.path.dirname(os.path.realpath(__file__))
+
+parser = argparse.ArgumentParser("gen_snapshot_types.py")
+parser.add_argument("-i", help="Input bindgen AST file", default=os.path.join(src_path, "..", "bindgen", "build", "ufbx.json"))
+argv = parser.parse_args()
+
+with open(argv.i) as f:
+    ast = json.load(f)
+
+structs = { }
+enums = { }
+
+def collect(node):
+    if isinstance(node, dict):
+        if node.get("kind") == "struct" and node.get("name") and "decls" in node:
+            structs[node["name"]] = node
+        if node.get("kind") == "enum" and node.get("name") and "decls" in node:
+            enums[node["name"]] = node
+        for v in node.values():
+            collect(v)
+    elif isinstance(node, list):
+        for v in node:
+            collect(v)
+
+collect(ast)
+
+class Field:
+    def __init__(self, name, type, mods):
+        self.name = name
+        self.type = type
+        self.mods = [m for m in mods if m["type"] not in ("nullable", "const", "unsafe")]
+
+def struct_fields(decls, out):
+    for decl in decls:
+        kind = decl["kind"]
+        if kind == "group":
+            struct_fields(decl["decls"], out)
+        elif kind == "decl" and decl.get("declKind") == "field":
+            out.append(Field(decl["name"], decl["type"]["name"], decl["type"]["mods"]))
+        elif kind == "struct" and not decl.get("name"):
+            if decl["structKind"] == "union":
+                # Only the first member of unions is followed, the rest
+                # alias it (eg. `ufbx_node.element` vs `ufbx_node.name`)
+                first = []
+                struct_fields(decl["decls"], first)
+                group = decl["decls"][0]
+                if group["kind"] == "struct":
+                    sub = []
+                    struct_fields([group], sub)
+                    out += sub
+                else:
+                    out.append(first[0])
+            else:
+                struct_fields(decl["decls"], out)
+    return out
+
+def get_fields(name):
+    return struct_fields(structs[name]["decls"], [])
+
+element_types = set(["ufbx_element"])
+for name, st in structs.items():
+    fields = get_fields(name)
+    if fields and fields[0].name == "element" and fields[0].type == "ufbx_element" and not fields[0].mods:
+        element_types.add(name)
+
+def short_name(name):
+    name = name.replace("ufbx_", "", 1)
+    if name.endswith("_t"): name = name[:-2]
+    return name.upper()
+
+types = { }
+type_order = []
+pointer_types = set()
+
+def has_pointers(name, stack=()):
+    if name in ("ufbx_string", "ufbx_blob"): return True
+    if name not in structs: return False
+    if structs[name].get("isList"): return True
+    if name in stack: return True
+    for f in get_fields(name):
+        if any(m["type"] == "pointer" for m in f.mods): return True
+        if has_pointers(f.type, stack + (name,)): return True
+    return False
+
+def add_type(name):
+    if name in types: return
+    types[name] = None
+    entries = []
+    if name == "ufbx_string":
+        entries.append((None, "STRING", None, "1"))
+    elif name == "ufbx_blob":
+        entries.append((None, "BLOB", None, "1"))
+    elif name in structs:
+        for f in get_fields(name):
+            ptrs = sum(1 for m in f.mods if m["type"] == "pointer")
+            arrays = [m["length"] for m in f.mods if m["type"] == "array"]
+            count = arrays[0] if arrays else "1"
+            if ptrs == 0:
+                if f.type == "ufbx_string":
+                    entries.append((f.name, "STRING", None, count))
+                elif f.type == "ufbx_blob":
+                    entries.append((f.name, "BLOB", None, count))
+                elif f.type in structs and structs[f.type].get("isList"):
+                    data = get_fields(f.type)[0]
+                    data_ptrs = sum(1 for m in data.mods if m["type"] == "pointer")
+                    if data_ptrs == 2:
+                        elem = add_pointer_type(data.type)
+                    else:
+                        assert data_ptrs == 1
+                        add_type(data.type)
+                        elem = data.type
+                    # Vertex attribute values have a zero element before `data`
+                    kind = "VALUES" if name.startswith("ufbx_vertex_") and f.name == "values" else "LIST"
+                    entries.append((f.name, kind, elem, count))
+                elif has_pointers(f.type):
+                    add_type(f.type)
+                    entries.append((f.name, "INLINE", f.type, count))
+            elif ptrs == 1:
+                if f.type not in structs:
+                    raise RuntimeError(f"Unsupported pointer field {name}.{f.name}: {f.type}")
+                add_type(f.type)
+                entries.append((f.name, "PTR", f.type, count))
+            else:
+                raise RuntimeError(f"Unsupported pointer field {name}.{f.name}")
+    types[name] = entries
+    type_order.append(name)
+
+def add_pointer_type(name):
+    add_type(name)
+    key = name + "*"
+    if key not in types:
+        types[key] = [(None, "PTR", name, "1")]
+        type_order.append(key)
+    return key
+
+def type_id(name):
+    if name.endswith("*"):
+        return "UFBXI_SNAPSHOT_TYPE_" + short_name(name[:-1]) + "_PTR"
+    return "UFBXI_SNAPSHOT_TYPE_" + short_name(name)
+
+def c_type(name):
+    if name.endswith("*"):
+        return name[:-1] + "*"
+    return name
+
+add_type("ufbx_scene")
+
+element_enum = enums["ufbx_element_type"]
+element_values = []
+def collect_enum(decls):
+    for decl in decls:
+        if decl["kind"] == "group":
+            collect_enum(decl["decls"])
+        elif decl["kind"] == "decl" and decl.get("declKind") == "enumValue":
+            element_values.append(decl["name"])
+collect_enum(element_enum["decls"])
+element_values = [v for v in element_values if not v.endswith("_COUNT") and not v.startswith("UFBX_ELEMENT_TYPE")]
+
+for value in element_values:
+    name = "ufbx_" + value.replace("UFBX_ELEMENT_", "").lower()
+    if name not in structs:
+        raise RuntimeError(f"No struct for element type {value}")
+    add_type(name)
+
+print("// Generated by `misc/gen_snapshot_types.py`")
+print()
+print("typedef enum {")
+for name in type_order:
+    print(f"\t{type_id(name)},")
+print("\tUFBXI_SNAPSHOT_TYPE_COUNT,")
+print("} ufbxi_snapshot_type_id;")
+print()
+
+for name in type_order:
+    entries = types[name]
+    if not entries: continue
+    sym = "ufbxi_snapshot_fields_" + short_name(name[:-1] + "_ptr" if name.endswith("*") else name).lower()
+    print(f"static const ufbxi_snapshot_field {sym}[] = {{")
+    for field, kind, target, count in entries:
+        offset = f"offsetof({name}, {field})" if field else "0"
+        target_id = type_id(target) if target else "0"
+        print(f"\t{{ (uint32_t){offset}, UFBXI_SNAPSHOT_FIELD_{kind}, {target_id}, {count} }},")
+    print("};")
+print()
+
+print("static const ufbxi_snapshot_type ufbxi_snapshot_types[] = {")
+for name in type_order:
+    entries = types[name]
+    is_element = "true" if name in element_types else "false"
+    if entries:
+        sym = "ufbxi_snapshot_fields_" + short_name(name[:-1] + "_ptr" if name.endswith("*") else name).lower()
+        print(f"\t{{ sizeof({c_type(name)}), {sym}, ufbxi_arraycount({sym}), {is_element} }},")
+    else:
+        print(f"\t{{ sizeof({c_type(name)}), NULL, 0, {is_element} }},")
+print("};")
+print()
+
+print("static const uint16_t ufbxi_snapshot_element_types[] = {")
+for value in element_values:
+    name = "ufbx_" + value.replace("UFBX_ELEMENT_", "").lower()
+    print(f"\t{type_id(name)},")
+print("};")
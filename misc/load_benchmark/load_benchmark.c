@@ -0,0 +1,633 @@
+// End-to-end load throughput benchmark.
+//
+// Loads every .fbx/.obj file in the given files/directories (default `data/`)
+// in every combination of input mode, thread count and load option variant,
+// and reports throughput, latency percentiles and peak memory.
+//
+// Build (from the repository root):
+//   cc -O2 misc/load_benchmark/load_benchmark.c ufbx.c -lm -lpthread -o load_benchmark
+//
+// Usage: load_benchmark [options] [files or directories...]
+//   -n <count>            Iterations per file and configuration (default 5)
+//   --modes <list>        Input modes: memory,file,stream (default all)
+//   --threads <list>      Thread counts, 1 disables the thread pool (default 1)
+//   --variants <list>     Load option variants: default,skinning,normals (default all)
+//   --filter <str>        Only benchmark files whose name contains <str>
+//   --csv <path>          Write per-file results as CSV
+//   --json <path>         Write per-file results as JSON
+//   --baseline <path>     Compare against a CSV written by an earlier run
+//   --threshold <ratio>   Relative p50 slowdown reported as a regression (default 0.1)
+//
+// Exits with 1 if any configuration regressed against the baseline.
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <Windows.h>
+#else
+	#include <sys/types.h>
+	#include <dirent.h>
+#endif
+
+#include "../../ufbx.h"
+#include "../../extra/ufbx_os.h"
+#include "../../test/cputime.h"
+
+#define lb_arraycount(arr) (sizeof(arr) / sizeof(*(arr)))
+
+static void lb_fail(const char *msg, const char *arg)
+{
+	fprintf(stderr, "load_benchmark: %s%s\n", msg, arg ? arg : "");
+	exit(2);
+}
+
+static void *lb_alloc(size_t size)
+{
+	void *ptr = malloc(size > 0 ? size : 1);
+	if (!ptr) lb_fail("Out of memory", NULL);
+	return ptr;
+}
+
+// -- Configuration
+
+typedef enum {
+	LB_MODE_MEMORY,
+	LB_MODE_FILE,
+	LB_MODE_STREAM,
+	LB_MODE_COUNT,
+} lb_mode;
+
+static const char *const lb_mode_names[] = { "memory", "file", "stream" };
+
+typedef enum {
+	LB_VARIANT_DEFAULT,
+	LB_VARIANT_SKINNING,
+	LB_VARIANT_NORMALS,
+	LB_VARIANT_COUNT,
+} lb_variant;
+
+static const char *const lb_variant_names[] = { "default", "skinning", "normals" };
+
+#define LB_MAX_THREAD_COUNTS 16
+
+typedef struct {
+	size_t iterations;
+	bool modes[LB_MODE_COUNT];
+	bool variants[LB_VARIANT_COUNT];
+	size_t thread_counts[LB_MAX_THREAD_COUNTS];
+	size_t num_thread_counts;
+	const char *filter;
+	const char *csv_path;
+	const char *json_path;
+	const char *baseline_path;
+	double threshold;
+} lb_opts;
+
+static void lb_parse_name_list(bool *dst, const char *const *names, size_t count, const char *list)
+{
+	memset(dst, 0, count * sizeof(bool));
+	const char *begin = list;
+	while (*begin) {
+		const char *end = strchr(begin, ',');
+		size_t len = end ? (size_t)(end - begin) : strlen(begin);
+		size_t i;
+		for (i = 0; i < count; i++) {
+			if (strlen(names[i]) == len && !memcmp(names[i], begin, len)) break;
+		}
+		if (i == count) lb_fail("Unknown list entry: ", begin);
+		dst[i] = true;
+		begin += len;
+		if (*begin == ',') begin++;
+	}
+}
+
+static void lb_parse_thread_list(lb_opts *opts, const char *list)
+{
+	opts->num_thread_counts = 0;
+	const char *begin = list;
+	while (*begin) {
+		if (opts->num_thread_counts >= LB_MAX_THREAD_COUNTS) lb_fail("Too many thread counts", NULL);
+		char *end = NULL;
+		long count = strtol(begin, &end, 10);
+		if (end == begin || count <= 0) lb_fail("Bad thread count: ", begin);
+		opts->thread_counts[opts->num_thread_counts++] = (size_t)count;
+		begin = end;
+		if (*begin == ',') begin++;
+	}
+}
+
+// -- Files
+
+typedef struct {
+	char *path;
+	char *data;
+	size_t size;
+} lb_file;
+
+typedef struct {
+	lb_file *files;
+	size_t count;
+	size_t capacity;
+} lb_file_list;
+
+static bool lb_has_extension(const char *path)
+{
+	size_t len = strlen(path);
+	if (len < 4) return false;
+	const char *ext = path + len - 4;
+	return !strcmp(ext, ".fbx") || !strcmp(ext, ".FBX") || !strcmp(ext, ".obj") || !strcmp(ext, ".OBJ");
+}
+
+static char *lb_read_file(const char *path, size_t *p_size)
+{
+	FILE *f = fopen(path, "rb");
+	if (!f) return NULL;
+	fseek(f, 0, SEEK_END);
+	long size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	if (size < 0) {
+		fclose(f);
+		return NULL;
+	}
+	char *data = (char*)lb_alloc((size_t)size);
+	size_t num_read = fread(data, 1, (size_t)size, f);
+	fclose(f);
+	if (num_read != (size_t)size) {
+		free(data);
+		return NULL;
+	}
+	*p_size = (size_t)size;
+	return data;
+}
+
+static void lb_add_file(lb_file_list *list, const lb_opts *opts, const char *path)
+{
+	if (!lb_has_extension(path)) return;
+	if (opts->filter && !strstr(path, opts->filter)) return;
+
+	lb_file file;
+	file.data = lb_read_file(path, &file.size);
+	if (!file.data) {
+		fprintf(stderr, "load_benchmark: Failed to read %s\n", path);
+		return;
+	}
+	file.path = (char*)lb_alloc(strlen(path) + 1);
+	strcpy(file.path, path);
+
+	if (list->count == list->capacity) {
+		list->capacity = list->capacity ? list->capacity * 2 : 64;
+		lb_file *files = (lb_file*)realloc(list->files, list->capacity * sizeof(lb_file));
+		if (!files) lb_fail("Out of memory", NULL);
+		list->files = files;
+	}
+	list->files[list->count++] = file;
+}
+
+static int lb_cmp_file(const void *va, const void *vb)
+{
+	const lb_file *a = (const lb_file*)va, *b = (const lb_file*)vb;
+	return strcmp(a->path, b->path);
+}
+
+static void lb_add_path(lb_file_list *list, const lb_opts *opts, const char *path)
+{
+	char full_path[2048];
+
+#if defined(_WIN32)
+	char pattern[2048];
+	snprintf(pattern, sizeof(pattern), "%s\\*", path);
+	WIN32_FIND_DATAA find_data;
+	HANDLE find_handle = FindFirstFileA(pattern, &find_data);
+	if (find_handle != INVALID_HANDLE_VALUE) {
+		do {
+			if (find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) continue;
+			snprintf(full_path, sizeof(full_path), "%s\\%s", path, find_data.cFileName);
+			lb_add_file(list, opts, full_path);
+		} while (FindNextFileA(find_handle, &find_data));
+		FindClose(find_handle);
+		return;
+	}
+#else
+	DIR *dir = opendir(path);
+	if (dir) {
+		struct dirent *entry;
+		while ((entry = readdir(dir)) != NULL) {
+			snprintf(full_path, sizeof(full_path), "%s/%s", path, entry->d_name);
+			lb_add_file(list, opts, full_path);
+		}
+		closedir(dir);
+		return;
+	}
+#endif
+
+	lb_add_file(list, opts, path);
+}
+
+// -- Loading
+
+typedef struct {
+	const char *data;
+	size_t size;
+	size_t offset;
+} lb_memory_stream;
+
+static size_t lb_stream_read(void *user, void *data, size_t size)
+{
+	lb_memory_stream *stream = (lb_memory_stream*)user;
+	size_t left = stream->size - stream->offset;
+	if (size > left) size = left;
+	memcpy(data, stream->data + stream->offset, size);
+	stream->offset += size;
+	return size;
+}
+
+static ufbx_scene *lb_load(const lb_file *file, lb_mode mode, const ufbx_load_opts *opts, ufbx_error *error)
+{
+	switch (mode) {
+	case LB_MODE_MEMORY:
+		return ufbx_load_memory(file->data, file->size, opts, error);
+	case LB_MODE_FILE:
+		return ufbx_load_file(file->path, opts, error);
+	case LB_MODE_STREAM: {
+		lb_memory_stream user = { file->data, file->size, 0 };
+		ufbx_stream stream = { 0 };
+		stream.read_fn = &lb_stream_read;
+		stream.user = &user;
+		return ufbx_load_stream(&stream, opts, error);
+	}
+	default:
+		return NULL;
+	}
+}
+
+// -- Results
+
+typedef struct {
+	const char *file;
+	lb_mode mode;
+	size_t threads;
+	lb_variant variant;
+	size_t iterations;
+	size_t file_size;
+	size_t elements;
+	double p50_ms;
+	double p99_ms;
+	double mean_ms;
+	size_t peak_memory;
+} lb_result;
+
+static double lb_mb_per_sec(const lb_result *r)
+{
+	return r->p50_ms > 0.0 ? (double)r->file_size / (r->p50_ms * 1e-3) * 1e-6 : 0.0;
+}
+
+static double lb_elements_per_sec(const lb_result *r)
+{
+	return r->p50_ms > 0.0 ? (double)r->elements / (r->p50_ms * 1e-3) : 0.0;
+}
+
+static int lb_cmp_double(const void *va, const void *vb)
+{
+	double a = *(const double*)va, b = *(const double*)vb;
+	return a < b ? -1 : a > b ? 1 : 0;
+}
+
+// Nearest-rank percentile of sorted `samples`
+static double lb_percentile(const double *samples, size_t count, double p)
+{
+	size_t rank = (size_t)(p * (double)count + 0.999999);
+	if (rank < 1) rank = 1;
+	if (rank > count) rank = count;
+	return samples[rank - 1];
+}
+
+static bool lb_run(lb_result *result, const lb_file *file, lb_mode mode, lb_variant variant, size_t threads,
+	ufbx_os_thread_pool *pool, size_t iterations, double *samples)
+{
+	ufbx_load_opts opts = { 0 };
+	opts.evaluate_skinning = variant == LB_VARIANT_SKINNING;
+	opts.generate_missing_normals = variant == LB_VARIANT_NORMALS;
+	if (pool) {
+		ufbx_os_init_ufbx_thread_pool(&opts.thread_opts.pool, pool);
+	}
+
+	memset(result, 0, sizeof(lb_result));
+	result->file = file->path;
+	result->mode = mode;
+	result->threads = threads;
+	result->variant = variant;
+	result->iterations = iterations;
+	result->file_size = file->size;
+
+	double total_ms = 0.0;
+	for (size_t i = 0; i < iterations; i++) {
+		ufbx_error error;
+		uint64_t begin = cputime_os_tick();
+		ufbx_scene *scene = lb_load(file, mode, &opts, &error);
+		uint64_t end = cputime_os_tick();
+		if (!scene) {
+			char buf[1024];
+			ufbx_format_error(buf, sizeof(buf), &error);
+			fprintf(stderr, "load_benchmark: Failed to load %s: %s\n", file->path, buf);
+			return false;
+		}
+
+		double ms = cputime_os_delta_to_sec(NULL, end - begin) * 1e3;
+		samples[i] = ms;
+		total_ms += ms;
+
+		result->elements = scene->elements.count;
+		if (scene->metadata.memory_peak > result->peak_memory) {
+			result->peak_memory = scene->metadata.memory_peak;
+		}
+		ufbx_free_scene(scene);
+	}
+
+	qsort(samples, iterations, sizeof(double), &lb_cmp_double);
+	result->p50_ms = lb_percentile(samples, iterations, 0.5);
+	result->p99_ms = lb_percentile(samples, iterations, 0.99);
+	result->mean_ms = total_ms / (double)iterations;
+	return true;
+}
+
+static void lb_write_csv(const char *path, const lb_result *results, size_t count)
+{
+	FILE *f = fopen(path, "w");
+	if (!f) lb_fail("Failed to open ", path);
+	fprintf(f, "file,mode,threads,variant,iterations,file_size,elements,p50_ms,p99_ms,mean_ms,mb_per_sec,elements_per_sec,peak_memory\n");
+	for (size_t i = 0; i < count; i++) {
+		const lb_result *r = &results[i];
+		fprintf(f, "%s,%s,%zu,%s,%zu,%zu,%zu,%.4f,%.4f,%.4f,%.3f,%.1f,%zu\n",
+			r->file, lb_mode_names[r->mode], r->threads, lb_variant_names[r->variant],
+			r->iterations, r->file_size, r->elements, r->p50_ms, r->p99_ms, r->mean_ms,
+			lb_mb_per_sec(r), lb_elements_per_sec(r), r->peak_memory);
+	}
+	fclose(f);
+}
+
+static void lb_write_json_string(FILE *f, const char *str)
+{
+	fputc('"', f);
+	for (const char *c = str; *c; c++) {
+		if (*c == '"' || *c == '\\') fputc('\\', f);
+		fputc(*c, f);
+	}
+	fputc('"', f);
+}
+
+static void lb_write_json(const char *path, const lb_result *results, size_t count)
+{
+	FILE *f = fopen(path, "w");
+	if (!f) lb_fail("Failed to open ", path);
+	fprintf(f, "[\n");
+	for (size_t i = 0; i < count; i++) {
+		const lb_result *r = &results[i];
+		fprintf(f, "  {\"file\": ");
+		lb_write_json_string(f, r->file);
+		fprintf(f, ", \"mode\": \"%s\", \"threads\": %zu, \"variant\": \"%s\", \"iterations\": %zu, "
+			"\"file_size\": %zu, \"elements\": %zu, \"p50_ms\": %.4f, \"p99_ms\": %.4f, \"mean_ms\": %.4f, "
+			"\"mb_per_sec\": %.3f, \"elements_per_sec\": %.1f, \"peak_memory\": %zu}%s\n",
+			lb_mode_names[r->mode], r->threads, lb_variant_names[r->variant], r->iterations,
+			r->file_size, r->elements, r->p50_ms, r->p99_ms, r->mean_ms,
+			lb_mb_per_sec(r), lb_elements_per_sec(r), r->peak_memory, i + 1 < count ? "," : "");
+	}
+	fprintf(f, "]\n");
+	fclose(f);
+}
+
+// -- Baseline comparison
+
+// Returns the number of regressed configurations
+static size_t lb_compare_baseline(const char *path, const lb_result *results, size_t count, double threshold)
+{
+	FILE *f = fopen(path, "r");
+	if (!f) lb_fail("Failed to open baseline ", path);
+
+	size_t num_regressions = 0, num_matched = 0;
+	double log_ratio_sum = 0.0;
+
+	char line[4096];
+	bool header = true;
+	while (fgets(line, sizeof(line), f)) {
+		if (header) {
+			header = false;
+			continue;
+		}
+
+		// Only the key columns and `p50_ms` are needed
+		char *fields[13];
+		size_t num_fields = 0;
+		char *field = line;
+		while (num_fields < lb_arraycount(fields)) {
+			fields[num_fields++] = field;
+			char *comma = strchr(field, ',');
+			if (!comma) break;
+			*comma = '\0';
+			field = comma + 1;
+		}
+		if (num_fields < 8) continue;
+
+		size_t threads = (size_t)strtoul(fields[2], NULL, 10);
+		double base_p50 = strtod(fields[7], NULL);
+
+		for (size_t i = 0; i < count; i++) {
+			const lb_result *r = &results[i];
+			if (strcmp(r->file, fields[0]) != 0) continue;
+			if (strcmp(lb_mode_names[r->mode], fields[1]) != 0) continue;
+			if (r->threads != threads) continue;
+			if (strcmp(lb_variant_names[r->variant], fields[3]) != 0) continue;
+			if (base_p50 <= 0.0) break;
+
+			double ratio = r->p50_ms / base_p50;
+			log_ratio_sum += log(ratio);
+			num_matched++;
+
+			if (ratio > 1.0 + threshold) {
+				printf("REGRESSION %s [%s, %zu threads, %s]: %.3fms -> %.3fms (%+.1f%%)\n",
+					r->file, lb_mode_names[r->mode], r->threads, lb_variant_names[r->variant],
+					base_p50, r->p50_ms, (ratio - 1.0) * 100.0);
+				num_regressions++;
+			}
+			break;
+		}
+	}
+	fclose(f);
+
+	if (num_matched > 0) {
+		double geomean = exp(log_ratio_sum / (double)num_matched);
+		printf("Baseline: %zu configurations compared, geometric mean time ratio %.3f, %zu regressions\n",
+			num_matched, geomean, num_regressions);
+	} else {
+		printf("Baseline: no matching configurations\n");
+	}
+	return num_regressions;
+}
+
+int main(int argc, char **argv)
+{
+	lb_opts opts = { 0 };
+	opts.iterations = 5;
+	opts.threshold = 0.1;
+	for (size_t i = 0; i < LB_MODE_COUNT; i++) opts.modes[i] = true;
+	for (size_t i = 0; i < LB_VARIANT_COUNT; i++) opts.variants[i] = true;
+	opts.thread_counts[0] = 1;
+	opts.num_thread_counts = 1;
+
+	const char *paths[256];
+	size_t num_paths = 0;
+
+	for (int i = 1; i < argc; i++) {
+		const char *arg = argv[i];
+		const char *next = i + 1 < argc ? argv[i + 1] : NULL;
+		if (!strcmp(arg, "-n") && next) {
+			opts.iterations = (size_t)strtoul(next, NULL, 10);
+			i++;
+		} else if (!strcmp(arg, "--modes") && next) {
+			lb_parse_name_list(opts.modes, lb_mode_names, LB_MODE_COUNT, next);
+			i++;
+		} else if (!strcmp(arg, "--variants") && next) {
+			lb_parse_name_list(opts.variants, lb_variant_names, LB_VARIANT_COUNT, next);
+			i++;
+		} else if (!strcmp(arg, "--threads") && next) {
+			lb_parse_thread_list(&opts, next);
+			i++;
+		} else if (!strcmp(arg, "--filter") && next) {
+			opts.filter = next;
+			i++;
+		} else if (!strcmp(arg, "--csv") && next) {
+			opts.csv_path = next;
+			i++;
+		} else if (!strcmp(arg, "--json") && next) {
+			opts.json_path = next;
+			i++;
+		} else if (!strcmp(arg, "--baseline") && next) {
+			opts.baseline_path = next;
+			i++;
+		} else if (!strcmp(arg, "--threshold") && next) {
+			opts.threshold = strtod(next, NULL);
+			i++;
+		} else if (arg[0] == '-') {
+			lb_fail("Unknown option: ", arg);
+		} else {
+			if (num_paths >= lb_arraycount(paths)) lb_fail("Too many paths", NULL);
+			paths[num_paths++] = arg;
+		}
+	}
+
+	if (opts.iterations == 0) opts.iterations = 1;
+	if (num_paths == 0) {
+		paths[num_paths++] = "data";
+	}
+
+	cputime_init();
+
+	lb_file_list files = { 0 };
+	for (size_t i = 0; i < num_paths; i++) {
+		lb_add_path(&files, &opts, paths[i]);
+	}
+	qsort(files.files, files.count, sizeof(lb_file), &lb_cmp_file);
+	if (files.count == 0) lb_fail("No files found", NULL);
+
+	size_t max_results = files.count * LB_MODE_COUNT * LB_VARIANT_COUNT * opts.num_thread_counts;
+	lb_result *results = (lb_result*)lb_alloc(max_results * sizeof(lb_result));
+	double *samples = (double*)lb_alloc(opts.iterations * sizeof(double));
+	size_t num_results = 0;
+
+	printf("%-48s %-6s %3s %-8s %9s %9s %9s %12s %10s\n",
+		"file", "mode", "thr", "variant", "p50 ms", "p99 ms", "MB/s", "elements/s", "peak kB");
+
+	for (size_t ti = 0; ti < opts.num_thread_counts; ti++) {
+		size_t threads = opts.thread_counts[ti];
+
+		ufbx_os_thread_pool *pool = NULL;
+		if (threads > 1) {
+			ufbx_os_thread_pool_opts pool_opts = { 0 };
+			pool_opts.max_threads = threads;
+			pool = ufbx_os_create_thread_pool(&pool_opts);
+			if (!pool) lb_fail("Failed to create thread pool", NULL);
+		}
+
+		for (size_t fi = 0; fi < files.count; fi++) {
+			const lb_file *file = &files.files[fi];
+			for (size_t mode = 0; mode < LB_MODE_COUNT; mode++) {
+				if (!opts.modes[mode]) continue;
+				for (size_t variant = 0; variant < LB_VARIANT_COUNT; variant++) {
+					if (!opts.variants[variant]) continue;
+
+					lb_result *r = &results[num_results];
+					if (!lb_run(r, file, (lb_mode)mode, (lb_variant)variant, threads, pool, opts.iterations, samples)) {
+						continue;
+					}
+					num_results++;
+
+					const char *name = strrchr(r->file, '/');
+					name = name ? name + 1 : r->file;
+					printf("%-48.48s %-6s %3zu %-8s %9.3f %9.3f %9.1f %12.0f %10.1f\n",
+						name, lb_mode_names[r->mode], r->threads, lb_variant_names[r->variant],
+						r->p50_ms, r->p99_ms, lb_mb_per_sec(r), lb_elements_per_sec(r),
+						(double)r->peak_memory * 1e-3);
+				}
+			}
+		}
+
+		if (pool) {
+			ufbx_os_free_thread_pool(pool);
+		}
+	}
+
+	// Aggregate throughput per configuration over all files
+	printf("\n");
+	for (size_t ti = 0; ti < opts.num_thread_counts; ti++) {
+		for (size_t mode = 0; mode < LB_MODE_COUNT; mode++) {
+			for (size_t variant = 0; variant < LB_VARIANT_COUNT; variant++) {
+				double total_ms = 0.0, total_bytes = 0.0;
+				size_t count = 0;
+				for (size_t i = 0; i < num_results; i++) {
+					const lb_result *r = &results[i];
+					if (r->threads != opts.thread_counts[ti] || r->mode != mode || r->variant != variant) continue;
+					total_ms += r->p50_ms;
+					total_bytes += (double)r->file_size;
+					count++;
+				}
+				if (count == 0) continue;
+				printf("Total [%s, %zu threads, %s]: %zu files, %.1f MB in %.1f ms, %.1f MB/s\n",
+					lb_mode_names[mode], opts.thread_counts[ti], lb_variant_names[variant],
+					count, total_bytes * 1e-6, total_ms, total_ms > 0.0 ? total_bytes * 1e-6 / (total_ms * 1e-3) : 0.0);
+			}
+		}
+	}
+
+	if (opts.csv_path) lb_write_csv(opts.csv_path, results, num_results);
+	if (opts.json_path) lb_write_json(opts.json_path, results, num_results);
+
+	int exit_code = 0;
+	if (opts.baseline_path) {
+		if (lb_compare_baseline(opts.baseline_path, results, num_results, opts.threshold) > 0) {
+			exit_code = 1;
+		}
+	}
+
+	for (size_t i = 0; i < files.count; i++) {
+		free(files.files[i].path);
+		free(files.files[i].data);
+	}
+	free(files.files);
+	free(results);
+	free(samples);
+
+	return exit_code;
+}
+
+#define CPUTIME_IMPLEMENTATION
+#include "../../test/cputime.h"
+
+#define UFBX_OS_IMPLEMENTATION
+#include "../../extra/ufbx_os.h"
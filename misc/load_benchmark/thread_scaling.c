@@ -0,0 +1,263 @@
+// Thread scaling benchmark and determinism check for threaded loading.
+//
+// Loads each input with every combination of thread count and `ufbx_thread_opts`
+// settings, reports speedup and parallel efficiency relative to loading without
+// a thread pool, and verifies that every configuration produces the same scene
+// hash (see `test/hash_scene.h`) as the single-threaded load.
+//
+// Build (from the repository root):
+//   cc -O2 misc/load_benchmark/thread_scaling.c ufbx.c -lm -lpthread -o thread_scaling
+//
+// Usage: thread_scaling [options] [files...]
+//   -n <count>               Iterations per configuration (default 5)
+//   --threads <list>         Thread counts (default 1,2,4,8,16,32,64)
+//   --num-tasks <list>       Values for `ufbx_thread_opts.num_tasks` (default 0)
+//   --memory-limit <list>    Values for `ufbx_thread_opts.memory_limit` in kB (default 0)
+//   --csv <path>             Write results as CSV for plotting
+//
+// Defaults to the largest binary and ASCII files in `data/`.
+// NOTE: ufbx only uses threads for large enough inputs unless compiled with
+// `UFBX_EXTENSIVE_THREADING`, small files are expected to show no speedup.
+//
+// Exits with 1 if any configuration produced a different scene hash.
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+#include "../../ufbx.h"
+#include "../../extra/ufbx_os.h"
+#include "../../test/hash_scene.h"
+#include "../../test/cputime.h"
+
+#define ts_arraycount(arr) (sizeof(arr) / sizeof(*(arr)))
+
+#define TS_MAX_LIST 32
+
+typedef struct {
+	size_t values[TS_MAX_LIST];
+	size_t count;
+} ts_list;
+
+static void ts_fail(const char *msg, const char *arg)
+{
+	fprintf(stderr, "thread_scaling: %s%s\n", msg, arg ? arg : "");
+	exit(2);
+}
+
+static void ts_parse_list(ts_list *list, const char *str, size_t scale)
+{
+	list->count = 0;
+	while (*str) {
+		if (list->count >= TS_MAX_LIST) ts_fail("Too many list entries: ", str);
+		char *end = NULL;
+		unsigned long long value = strtoull(str, &end, 10);
+		if (end == str) ts_fail("Bad list entry: ", str);
+		list->values[list->count++] = (size_t)value * scale;
+		str = end;
+		if (*str == ',') str++;
+	}
+}
+
+static int ts_cmp_double(const void *va, const void *vb)
+{
+	double a = *(const double*)va, b = *(const double*)vb;
+	return a < b ? -1 : a > b ? 1 : 0;
+}
+
+typedef struct {
+	double p50_ms;
+	uint64_t hash;
+	bool ok;
+} ts_measurement;
+
+static ts_measurement ts_measure(const char *path, ufbx_os_thread_pool *pool, size_t num_tasks, size_t memory_limit, size_t iterations, double *samples)
+{
+	ts_measurement result = { 0 };
+
+	ufbx_load_opts opts = { 0 };
+	if (pool) {
+		ufbx_os_init_ufbx_thread_pool(&opts.thread_opts.pool, pool);
+		opts.thread_opts.num_tasks = num_tasks;
+		opts.thread_opts.memory_limit = memory_limit;
+	}
+
+	for (size_t i = 0; i < iterations; i++) {
+		ufbx_error error;
+		uint64_t begin = cputime_os_tick();
+		ufbx_scene *scene = ufbx_load_file(path, &opts, &error);
+		uint64_t end = cputime_os_tick();
+
+		if (!scene) {
+			char buf[1024];
+			ufbx_format_error(buf, sizeof(buf), &error);
+			fprintf(stderr, "thread_scaling: Failed to load %s: %s\n", path, buf);
+			return result;
+		}
+
+		samples[i] = cputime_os_delta_to_sec(NULL, end - begin) * 1e3;
+
+		// Every iteration is hashed to catch non-deterministic results
+		uint64_t hash = ufbxt_hash_scene(scene, NULL);
+		ufbx_free_scene(scene);
+		if (i > 0 && hash != result.hash) {
+			fprintf(stderr, "thread_scaling: %s: Hash differs between iterations\n", path);
+			return result;
+		}
+		result.hash = hash;
+	}
+
+	qsort(samples, iterations, sizeof(double), &ts_cmp_double);
+	result.p50_ms = samples[iterations / 2];
+	result.ok = true;
+	return result;
+}
+
+static void ts_print_bar(double speedup, double max_speedup)
+{
+	const int width = 40;
+	int len = max_speedup > 0.0 ? (int)(speedup / max_speedup * width + 0.5) : 0;
+	if (len > width) len = width;
+	putchar('|');
+	for (int i = 0; i < len; i++) putchar('#');
+	for (int i = len; i < width; i++) putchar(' ');
+	putchar('|');
+}
+
+int main(int argc, char **argv)
+{
+	size_t iterations = 5;
+	const char *csv_path = NULL;
+
+	ts_list threads = { { 1, 2, 4, 8, 16, 32, 64 }, 7 };
+	ts_list num_tasks = { { 0 }, 1 };
+	ts_list memory_limits = { { 0 }, 1 };
+
+	const char *paths[64];
+	size_t num_paths = 0;
+
+	for (int i = 1; i < argc; i++) {
+		const char *arg = argv[i];
+		const char *next = i + 1 < argc ? argv[i + 1] : NULL;
+		if (!strcmp(arg, "-n") && next) {
+			iterations = (size_t)strtoul(next, NULL, 10);
+			i++;
+		} else if (!strcmp(arg, "--threads") && next) {
+			ts_parse_list(&threads, next, 1);
+			i++;
+		} else if (!strcmp(arg, "--num-tasks") && next) {
+			ts_parse_list(&num_tasks, next, 1);
+			i++;
+		} else if (!strcmp(arg, "--memory-limit") && next) {
+			ts_parse_list(&memory_limits, next, 1024);
+			i++;
+		} else if (!strcmp(arg, "--csv") && next) {
+			csv_path = next;
+			i++;
+		} else if (arg[0] == '-') {
+			ts_fail("Unknown option: ", arg);
+		} else {
+			if (num_paths >= ts_arraycount(paths)) ts_fail("Too many files", NULL);
+			paths[num_paths++] = arg;
+		}
+	}
+
+	if (iterations == 0) iterations = 1;
+	if (num_paths == 0) {
+		paths[num_paths++] = "data/maya_human_ik_6100_binary.fbx";
+		paths[num_paths++] = "data/maya_kenney_character_7700_binary.fbx";
+		paths[num_paths++] = "data/maya_slime_7500_ascii.fbx";
+		paths[num_paths++] = "data/motionbuilder_thumbnail_7700_ascii.fbx";
+	}
+
+	cputime_init();
+
+	FILE *csv = NULL;
+	if (csv_path) {
+		csv = fopen(csv_path, "w");
+		if (!csv) ts_fail("Failed to open ", csv_path);
+		fprintf(csv, "file,threads,num_tasks,memory_limit,p50_ms,speedup,efficiency,hash,hash_ok\n");
+	}
+
+	double *samples = (double*)malloc(iterations * sizeof(double));
+	if (!samples) ts_fail("Out of memory", NULL);
+
+	size_t num_mismatches = 0;
+
+	for (size_t pi = 0; pi < num_paths; pi++) {
+		const char *path = paths[pi];
+
+		// Untimed warmup so that the reference isn't measured with cold caches
+		// while the threaded configurations measured after it are warm.
+		ts_measurement warmup = ts_measure(path, NULL, 0, 0, 1, samples);
+		if (!warmup.ok) {
+			num_mismatches++;
+			continue;
+		}
+
+		// Reference: load without a thread pool
+		ts_measurement ref = ts_measure(path, NULL, 0, 0, iterations, samples);
+		if (!ref.ok) {
+			num_mismatches++;
+			continue;
+		}
+
+		printf("\n%s: %.3f ms without threads, hash %016" PRIx64 "\n", path, ref.p50_ms, ref.hash);
+		printf("%7s %9s %12s %10s %8s %10s  %-42s %s\n",
+			"threads", "num_tasks", "memory_limit", "p50 ms", "speedup", "efficiency", "speedup", "hash");
+
+		for (size_t ti = 0; ti < threads.count; ti++) {
+			size_t num_threads = threads.values[ti];
+
+			ufbx_os_thread_pool_opts pool_opts = { 0 };
+			pool_opts.max_threads = num_threads;
+			ufbx_os_thread_pool *pool = ufbx_os_create_thread_pool(&pool_opts);
+			if (!pool) ts_fail("Failed to create thread pool", NULL);
+
+			for (size_t ni = 0; ni < num_tasks.count; ni++) {
+				for (size_t mi = 0; mi < memory_limits.count; mi++) {
+					ts_measurement m = ts_measure(path, pool, num_tasks.values[ni], memory_limits.values[mi], iterations, samples);
+					bool hash_ok = m.ok && m.hash == ref.hash;
+					if (!hash_ok) num_mismatches++;
+
+					double speedup = m.ok && m.p50_ms > 0.0 ? ref.p50_ms / m.p50_ms : 0.0;
+					double efficiency = speedup / (double)num_threads;
+
+					printf("%7zu %9zu %12zu %10.3f %7.2fx %9.0f%%  ",
+						num_threads, num_tasks.values[ni], memory_limits.values[mi] / 1024,
+						m.p50_ms, speedup, efficiency * 100.0);
+					ts_print_bar(speedup, (double)threads.values[threads.count - 1]);
+					printf(" %s\n", hash_ok ? "OK" : "MISMATCH");
+
+					if (csv) {
+						fprintf(csv, "%s,%zu,%zu,%zu,%.4f,%.4f,%.4f,%016" PRIx64 ",%d\n",
+							path, num_threads, num_tasks.values[ni], memory_limits.values[mi],
+							m.p50_ms, speedup, efficiency, m.hash, hash_ok ? 1 : 0);
+					}
+				}
+			}
+
+			ufbx_os_free_thread_pool(pool);
+		}
+	}
+
+	if (csv) fclose(csv);
+	free(samples);
+
+	if (num_mismatches > 0) {
+		printf("\n%zu configurations produced a different result!\n", num_mismatches);
+		return 1;
+	}
+	printf("\nAll configurations produced identical scenes\n");
+	return 0;
+}
+
+#define CPUTIME_IMPLEMENTATION
+#include "../../test/cputime.h"
+
+#define UFBX_OS_IMPLEMENTATION
+#include "../../extra/ufbx_os.h"
@@ -0,0 +1,287 @@
+// Polygon triangulation benchmark.
+//
+// Triangulates every face of the input meshes with `ufbx_triangulate_mesh()` and
+// reports the median time, time per corner, and the relative difference between
+// the polygon area and the area of the resulting triangles.
+//
+// Build (from the repository root):
+//   cc -O2 misc/load_benchmark/triangulate_benchmark.c ufbx.c -lm -o triangulate_benchmark
+//
+// To compare against ear clipping only, build `ufbx.c` with
+//   -DUFBXI_MONOTONE_TRIANGULATE_MIN_INDICES=0xffffffffu
+//
+// Usage: triangulate_benchmark [options] [files...]
+//   -n <count>               Iterations per input (default 5)
+//   --synthetic <list>       Also triangulate random star polygons with these corner counts
+//   --csv <path>             Write results as CSV for plotting
+//
+// Defaults to `data/blender_300_ngon_*.fbx` and synthetic polygons of 1k to 256k corners.
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "../../ufbx.h"
+#include "../../test/cputime.h"
+
+#define tb_arraycount(arr) (sizeof(arr) / sizeof(*(arr)))
+
+#define TB_MAX_LIST 32
+
+static void tb_fail(const char *msg, const char *arg)
+{
+	fprintf(stderr, "triangulate_benchmark: %s%s\n", msg, arg ? arg : "");
+	exit(2);
+}
+
+static int tb_cmp_double(const void *va, const void *vb)
+{
+	double a = *(const double*)va, b = *(const double*)vb;
+	return a < b ? -1 : a > b ? 1 : 0;
+}
+
+typedef struct {
+	size_t num_faces;
+	size_t num_corners;
+	size_t num_triangles;
+	double p50_ms;
+	double area_error;
+} tb_result;
+
+// Signed area of the triangle `a, b, c` projected to the plane defined by `normal`
+static double tb_area(ufbx_vec3 normal, const ufbx_vec3 *a, const ufbx_vec3 *b, const ufbx_vec3 *c)
+{
+	double ux = b->x - a->x, uy = b->y - a->y, uz = b->z - a->z;
+	double vx = c->x - a->x, vy = c->y - a->y, vz = c->z - a->z;
+	double x = uy*vz - uz*vy, y = uz*vx - ux*vz, z = ux*vy - uy*vx;
+	return 0.5 * (x*normal.x + y*normal.y + z*normal.z);
+}
+
+static void tb_measure_mesh(tb_result *result, const ufbx_mesh *mesh, size_t iterations, double *samples)
+{
+	size_t num_indices = mesh->num_triangles * 3;
+	uint32_t *indices = (uint32_t*)malloc((num_indices + 1) * sizeof(uint32_t));
+	if (!indices) tb_fail("Out of memory", NULL);
+
+	memset(result, 0, sizeof(tb_result));
+	result->num_triangles = mesh->num_triangles;
+
+	for (size_t i = 0; i < iterations; i++) {
+		ufbx_error error;
+		uint64_t begin = cputime_os_tick();
+		bool ok = ufbx_triangulate_mesh(mesh, indices, num_indices, NULL, &error);
+		uint64_t end = cputime_os_tick();
+		if (!ok) tb_fail("Failed to triangulate: ", error.description.data);
+		samples[i] = cputime_os_delta_to_sec(NULL, end - begin) * 1e3;
+	}
+
+	// Compare the area of the triangles to the area of the polygons
+	double poly_area = 0.0, tri_area = 0.0;
+	const uint32_t *face_indices = indices;
+	for (size_t fi = 0; fi < mesh->faces.count; fi++) {
+		ufbx_face face = mesh->faces.data[fi];
+		if (face.num_indices < 3) continue;
+		uint32_t num_tris = face.num_indices - 2;
+		const uint32_t *tris = face_indices;
+		face_indices += num_tris * 3;
+		result->num_faces++;
+		result->num_corners += face.num_indices;
+
+		ufbx_vec3 normal = ufbx_get_weighted_face_normal(&mesh->vertex_position, face);
+		double len = sqrt(normal.x*normal.x + normal.y*normal.y + normal.z*normal.z);
+		if (len <= 0.0) continue;
+		normal.x /= len;
+		normal.y /= len;
+		normal.z /= len;
+
+		ufbx_vec3 first = ufbx_get_vertex_vec3(&mesh->vertex_position, face.index_begin);
+		for (uint32_t i = 1; i + 1 < face.num_indices; i++) {
+			ufbx_vec3 b = ufbx_get_vertex_vec3(&mesh->vertex_position, face.index_begin + i);
+			ufbx_vec3 c = ufbx_get_vertex_vec3(&mesh->vertex_position, face.index_begin + i + 1);
+			poly_area += tb_area(normal, &first, &b, &c);
+		}
+
+		for (uint32_t i = 0; i < num_tris; i++) {
+			ufbx_vec3 a = ufbx_get_vertex_vec3(&mesh->vertex_position, tris[i*3 + 0]);
+			ufbx_vec3 b = ufbx_get_vertex_vec3(&mesh->vertex_position, tris[i*3 + 1]);
+			ufbx_vec3 c = ufbx_get_vertex_vec3(&mesh->vertex_position, tris[i*3 + 2]);
+			tri_area += tb_area(normal, &a, &b, &c);
+		}
+	}
+
+	free(indices);
+
+	qsort(samples, iterations, sizeof(double), &tb_cmp_double);
+	result->p50_ms = samples[iterations / 2];
+	result->area_error = poly_area != 0.0 ? fabs(tri_area - poly_area) / fabs(poly_area) : 0.0;
+}
+
+// Random star-shaped polygon, every other corner is likely to be reflex
+static ufbx_mesh *tb_create_star_mesh(uint32_t num_corners)
+{
+	ufbx_mesh *mesh = (ufbx_mesh*)calloc(1, sizeof(ufbx_mesh));
+	ufbx_vec3 *positions = (ufbx_vec3*)malloc(num_corners * sizeof(ufbx_vec3));
+	uint32_t *indices = (uint32_t*)malloc(num_corners * sizeof(uint32_t));
+	ufbx_face *face = (ufbx_face*)malloc(sizeof(ufbx_face));
+	if (!mesh || !positions || !indices || !face) tb_fail("Out of memory", NULL);
+
+	uint32_t seed = num_corners;
+	for (uint32_t i = 0; i < num_corners; i++) {
+		seed = seed * 1664525u + 1013904223u;
+		double angle = (double)i / (double)num_corners * 6.283185307179586;
+		double radius = 0.2 + (double)(seed >> 8) / (double)(1u << 24);
+		positions[i].x = (ufbx_real)(radius * cos(angle));
+		positions[i].y = (ufbx_real)(radius * sin(angle));
+		positions[i].z = 0.0f;
+		indices[i] = i;
+	}
+
+	face->index_begin = 0;
+	face->num_indices = num_corners;
+
+	mesh->num_faces = 1;
+	mesh->num_indices = num_corners;
+	mesh->num_triangles = num_corners - 2;
+	mesh->max_face_triangles = num_corners - 2;
+	mesh->faces.data = face;
+	mesh->faces.count = 1;
+	mesh->vertex_position.exists = true;
+	mesh->vertex_position.values.data = positions;
+	mesh->vertex_position.values.count = num_corners;
+	mesh->vertex_position.indices.data = indices;
+	mesh->vertex_position.indices.count = num_corners;
+	return mesh;
+}
+
+static void tb_free_star_mesh(ufbx_mesh *mesh)
+{
+	free(mesh->faces.data);
+	free(mesh->vertex_position.values.data);
+	free(mesh->vertex_position.indices.data);
+	free(mesh);
+}
+
+static void tb_report(FILE *csv, const char *name, const tb_result *r)
+{
+	double ns_per_corner = r->num_corners > 0 ? r->p50_ms * 1e6 / (double)r->num_corners : 0.0;
+	printf("%-48s %7zu %9zu %9zu %10.3f %9.1f %10.2e\n",
+		name, r->num_faces, r->num_corners, r->num_triangles, r->p50_ms, ns_per_corner, r->area_error);
+	if (csv) {
+		fprintf(csv, "%s,%zu,%zu,%zu,%.4f,%.2f,%.3e\n",
+			name, r->num_faces, r->num_corners, r->num_triangles, r->p50_ms, ns_per_corner, r->area_error);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	size_t iterations = 5;
+	const char *csv_path = NULL;
+
+	size_t synthetic[TB_MAX_LIST] = { 1024, 4096, 16384, 65536, 262144 };
+	size_t num_synthetic = 5;
+
+	const char *paths[64];
+	size_t num_paths = 0;
+
+	for (int i = 1; i < argc; i++) {
+		const char *arg = argv[i];
+		const char *next = i + 1 < argc ? argv[i + 1] : NULL;
+		if (!strcmp(arg, "-n") && next) {
+			iterations = (size_t)strtoul(next, NULL, 10);
+			i++;
+		} else if (!strcmp(arg, "--synthetic") && next) {
+			num_synthetic = 0;
+			for (const char *str = next; *str; ) {
+				if (num_synthetic >= TB_MAX_LIST) tb_fail("Too many list entries: ", next);
+				char *end = NULL;
+				unsigned long value = strtoul(str, &end, 10);
+				if (end == str || value < 3 || value > 0x10000000u) tb_fail("Bad list entry: ", str);
+				synthetic[num_synthetic++] = (size_t)value;
+				str = *end == ',' ? end + 1 : end;
+			}
+			i++;
+		} else if (!strcmp(arg, "--csv") && next) {
+			csv_path = next;
+			i++;
+		} else if (arg[0] == '-') {
+			tb_fail("Unknown option: ", arg);
+		} else {
+			if (num_paths >= tb_arraycount(paths)) tb_fail("Too many files", NULL);
+			paths[num_paths++] = arg;
+		}
+	}
+
+	if (iterations == 0) iterations = 1;
+	if (num_paths == 0) {
+		paths[num_paths++] = "data/blender_300_ngon_abstract_7400_binary.fbx";
+		paths[num_paths++] = "data/blender_300_ngon_big_7400_binary.fbx";
+		paths[num_paths++] = "data/blender_300_ngon_e_7400_binary.fbx";
+		paths[num_paths++] = "data/blender_300_ngon_intersection_7400_binary.fbx";
+		paths[num_paths++] = "data/blender_300_ngon_irregular_7400_binary.fbx";
+	}
+
+	cputime_init();
+
+	FILE *csv = NULL;
+	if (csv_path) {
+		csv = fopen(csv_path, "w");
+		if (!csv) tb_fail("Failed to open ", csv_path);
+		fprintf(csv, "input,faces,corners,triangles,p50_ms,ns_per_corner,area_error\n");
+	}
+
+	double *samples = (double*)malloc(iterations * sizeof(double));
+	if (!samples) tb_fail("Out of memory", NULL);
+
+	printf("%-48s %7s %9s %9s %10s %9s %10s\n", "input", "faces", "corners", "triangles", "p50 ms", "ns/corner", "area error");
+
+	for (size_t pi = 0; pi < num_paths; pi++) {
+		const char *path = paths[pi];
+
+		ufbx_error error;
+		ufbx_scene *scene = ufbx_load_file(path, NULL, &error);
+		if (!scene) {
+			char buf[1024];
+			ufbx_format_error(buf, sizeof(buf), &error);
+			fprintf(stderr, "triangulate_benchmark: Failed to load %s: %s\n", path, buf);
+			continue;
+		}
+
+		tb_result total = { 0 };
+		for (size_t mi = 0; mi < scene->meshes.count; mi++) {
+			tb_result r;
+			tb_measure_mesh(&r, scene->meshes.data[mi], iterations, samples);
+			total.num_faces += r.num_faces;
+			total.num_corners += r.num_corners;
+			total.num_triangles += r.num_triangles;
+			total.p50_ms += r.p50_ms;
+			if (r.area_error > total.area_error) total.area_error = r.area_error;
+		}
+		tb_report(csv, path, &total);
+
+		ufbx_free_scene(scene);
+	}
+
+	for (size_t si = 0; si < num_synthetic; si++) {
+		ufbx_mesh *mesh = tb_create_star_mesh((uint32_t)synthetic[si]);
+
+		char name[64];
+		snprintf(name, sizeof(name), "star %zu", synthetic[si]);
+
+		tb_result r;
+		tb_measure_mesh(&r, mesh, iterations, samples);
+		tb_report(csv, name, &r);
+
+		tb_free_star_mesh(mesh);
+	}
+
+	if (csv) fclose(csv);
+	free(samples);
+	return 0;
+}
+
+#define CPUTIME_IMPLEMENTATION
+#include "../../test/cputime.h"
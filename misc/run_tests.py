@@ -1059,6 +1059,7 @@ async def main():
             "UFBX_NO_SKINNING_EVALUATION",
             "UFBX_NO_ANIMATION_BAKING",
             "UFBX_NO_FORMAT_OBJ",
+            "UFBX_NO_SCENE_SNAPSHOT",
             "UFBX_NO_INDEX_GENERATION",
             "UFBX_NO_TRIANGULATION",
             "UFBX_NO_ERROR_STACK",
@@ -1466,6 +1467,112 @@ async def main():
             for line in best_target.log[1].splitlines(keepends=False):
                 log_comment(line)
 
+    if "benchmark" in tests:
+        log_comment("-- Compiling and running load_benchmark --")
+
+        target_tasks = []
+
+        benchmark_config = {
+            "sources": ["ufbx.c", "misc/load_benchmark/load_benchmark.c"],
+            "output": "load_benchmark" + exe_suffix,
+            "optimize": True,
+            "threads": True,
+        }
+        target_tasks += compile_permutations("load_benchmark", benchmark_config, arch_configs, None)
+
+        targets = await gather(target_tasks)
+        all_targets += targets
+
+        def target_score(target):
+            compiler = target.compiler
+            config = target.config
+            if not target.compiled:
+                return (0, 0)
+            score = 1
+            if config["arch"] == "x64":
+                score += 10
+            if "clang" in compiler.name:
+                score += 10
+            version = re.search(r"\d+", compiler.version)
+            version = int(version.group(0)) if version else 0
+            return (score, version)
+
+        best_target = max(targets, key=target_score)
+        if best_target.compiled:
+            log_comment(f"-- Running {best_target.name} --")
+
+            csv_path = os.path.join(build_path, "load_benchmark.csv")
+            best_target.log.clear()
+            best_target.ran = False
+            await run_target(best_target, ["-n", "3", "--threads", "1,4", "--csv", csv_path, "data"])
+            for line in best_target.log[1].splitlines(keepends=False):
+                if line.startswith("Total"):
+                    log_comment(line)
+
+    if "threadscaling" in tests:
+        log_comment("-- Compiling and running thread_scaling --")
+
+        target_tasks = []
+
+        thread_scaling_config = {
+            "sources": ["ufbx.c", "misc/load_benchmark/thread_scaling.c"],
+            "output": "thread_scaling" + exe_suffix,
+            "optimize": True,
+            "threads": True,
+            "defines": {
+                "UFBX_EXTENSIVE_THREADING": 1,
+            },
+        }
+        target_tasks += compile_permutations("thread_scaling", thread_scaling_config, arch_configs, None)
+
+        targets = await gather(target_tasks)
+        all_targets += targets
+
+        # Any compiled target will do, the run fails if a thread configuration
+        # produces a different scene hash than loading without threads.
+        compiled_targets = [t for t in targets if t.compiled and t.config["arch"] == "x64"]
+        if compiled_targets:
+            target = compiled_targets[0]
+            log_comment(f"-- Running {target.name} --")
+
+            csv_path = os.path.join(build_path, "thread_scaling.csv")
+            target.log.clear()
+            target.ran = False
+            await run_target(target, ["-n", "3", "--threads", "1,2,4,8", "--num-tasks", "0,4", "--csv", csv_path])
+
+    if "triangulatebenchmark" in tests:
+        log_comment("-- Compiling and running triangulate_benchmark --")
+
+        # Build a second copy that only uses ear clipping for comparison
+        variants = {
+            "triangulate_benchmark": { },
+            "triangulate_benchmark_ear": { "UFBXI_MONOTONE_TRIANGULATE_MIN_INDICES": "0xffffffffu" },
+        }
+
+        variant_targets = { }
+        for name, defines in variants.items():
+            triangulate_config = {
+                "sources": ["ufbx.c", "misc/load_benchmark/triangulate_benchmark.c"],
+                "output": name + exe_suffix,
+                "optimize": True,
+                "defines": defines,
+            }
+            variant_targets[name] = await gather(compile_permutations(name, triangulate_config, arch_configs, None))
+            all_targets += variant_targets[name]
+
+        for name, targets in variant_targets.items():
+            compiled_targets = [t for t in targets if t.compiled and t.config["arch"] == "x64"]
+            if compiled_targets:
+                target = compiled_targets[0]
+                log_comment(f"-- Running {target.name} --")
+
+                csv_path = os.path.join(build_path, name + ".csv")
+                target.log.clear()
+                target.ran = False
+                await run_target(target, ["-n", "3", "--synthetic", "1024,4096,16384", "--csv", csv_path])
+                for line in target.log[1].splitlines(keepends=False):
+                    log_comment(line)
+
     if "hashes" in tests:
 
         hash_file = argv.hash_file
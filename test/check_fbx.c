@@ -32,6 +32,8 @@ bool g_verbose = false;
 	#include "../extra/ufbx_os.h"
 #endif
 
+#include "../extra/ufbx_chrome_trace.h"
+
 #include "check_scene.h"
 #include "check_material.h"
 #include "testing_utils.h"
@@ -152,6 +154,7 @@ int check_fbx_main(int argc, char **argv, const char *path)
 	bool dedicated_allocs = false;
 	bool bake = false;
 	double bake_fps = -1.0;
+	const char *chrome_trace_path = NULL;
 	double override_fps = -1.0;
 
 	ufbx_load_opts opts = { 0 };
@@ -202,6 +205,8 @@ int check_fbx_main(int argc, char **argv, const char *path)
 			bake = true;
 		} else if (!strcmp(argv[i], "--bake-fps")) {
 			if (++i < argc) bake_fps = strtod(argv[i], NULL);
+		} else if (!strcmp(argv[i], "--chrome-trace")) {
+			if (++i < argc) chrome_trace_path = argv[i];
 		} else if (argv[i][0] == '-') {
 			fprintf(stderr, "Unrecognized flag: %s\n", argv[i]);
 			exit(1);
@@ -281,6 +286,13 @@ int check_fbx_main(int argc, char **argv, const char *path)
 	ufbx_error error;
 	ufbx_scene *scene;
 
+	ufbx_chrome_trace *chrome_trace = NULL;
+	if (chrome_trace_path) {
+		chrome_trace = ufbx_chrome_trace_create(NULL);
+		ufbxt_assert(chrome_trace);
+		ufbx_chrome_trace_init_ufbx_trace_cb(&opts.trace_cb, chrome_trace);
+	}
+
 	uint64_t load_delta = 0;
 	{
 		uint64_t load_begin = cputime_cpu_tick();
@@ -294,6 +306,13 @@ int check_fbx_main(int argc, char **argv, const char *path)
 		load_delta = load_end - load_begin;
 	}
 
+	if (chrome_trace) {
+		if (!ufbx_chrome_trace_write(chrome_trace, chrome_trace_path)) {
+			fprintf(stderr, "Failed to write trace: %s\n", chrome_trace_path);
+		}
+		ufbx_chrome_trace_free(chrome_trace);
+	}
+
 	if (!scene) {
 		char buf[1024];
 		ufbx_format_error(buf, sizeof(buf), &error);
@@ -721,6 +740,9 @@ int main(int argc, char **argv)
 	#include "../extra/ufbx_os.h"
 #endif
 
+#define UFBX_CHROME_TRACE_IMPLEMENTATION
+#include "../extra/ufbx_chrome_trace.h"
+
 #ifndef EXTERNAL_UFBX
 	#include "../ufbx.c"
 #endif
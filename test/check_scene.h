@@ -451,6 +451,38 @@ static void ufbxt_check_mesh(ufbx_scene *scene, ufbx_mesh *mesh)
 	ufbxt_assert(mesh->num_vertices == mesh->vertex_position.values.count);
 	ufbxt_assert(mesh->num_triangles <= mesh->num_indices);
 
+	if (mesh->triangle_indices.count > 0) {
+		ufbxt_assert(mesh->triangle_indices.count == mesh->num_triangles * 3);
+		for (size_t i = 0; i < mesh->triangle_indices.count; i++) {
+			ufbxt_assert(mesh->triangle_indices.data[i] < mesh->num_indices);
+		}
+	}
+
+	if (mesh->topology.count > 0) {
+		ufbxt_assert(mesh->topology.count == mesh->num_indices);
+		for (size_t fi = 0; fi < mesh->num_faces; fi++) {
+			ufbx_face face = mesh->faces.data[fi];
+			for (uint32_t i = 0; i < face.num_indices; i++) {
+				uint32_t ix = face.index_begin + i;
+				const ufbx_topo_edge *te = &mesh->topology.data[ix];
+				ufbxt_assert(te->index == ix);
+				ufbxt_assert(te->face == fi);
+				ufbxt_assert(te->next == face.index_begin + (i + 1) % face.num_indices);
+				ufbxt_assert(mesh->topology.data[te->next].prev == ix);
+				if (te->twin != UFBX_NO_INDEX) {
+					const ufbx_topo_edge *twin = &mesh->topology.data[te->twin];
+					uint32_t a = mesh->vertex_indices.data[te->index], b = mesh->vertex_indices.data[te->next];
+					uint32_t ta = mesh->vertex_indices.data[twin->index], tb = mesh->vertex_indices.data[twin->next];
+					ufbxt_assert(twin->twin == ix);
+					ufbxt_assert((ta == b && tb == a) || (ta == a && tb == b));
+				}
+				if (te->edge != UFBX_NO_INDEX) {
+					ufbxt_assert(te->edge < mesh->num_edges);
+				}
+			}
+		}
+	}
+
 	ufbxt_assert(mesh->vertex_position.value_reals == 3);
 	ufbxt_assert(mesh->vertex_normal.value_reals == 3);
 	ufbxt_assert(mesh->vertex_tangent.value_reals == 3);
@@ -4,6 +4,7 @@
 #include "testing_basics.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <assert.h>
 
 typedef struct ufbxt_hash {
@@ -1066,6 +1067,13 @@ ufbxt_noinline static void ufbxt_hash_anim_prop_imp(ufbxt_hash *h, const ufbx_an
 	ufbxt_hash_element_ref(h, v->anim_value);
 }
 
+static int ufbxt_cmp_anim_prop_ptr(const void *va, const void *vb)
+{
+	const ufbx_anim_prop *a = *(const ufbx_anim_prop *const*)va, *b = *(const ufbx_anim_prop *const*)vb;
+	if (a->element->element_id != b->element->element_id) return a->element->element_id < b->element->element_id ? -1 : +1;
+	return strcmp(a->prop_name.data, b->prop_name.data);
+}
+
 ufbxt_noinline static void ufbxt_hash_anim_layer_imp(ufbxt_hash *h, const ufbx_anim_layer *v)
 {
 	ufbxt_hash_real(h, v->weight);
@@ -1076,7 +1084,31 @@ ufbxt_noinline static void ufbxt_hash_anim_layer_imp(ufbxt_hash *h, const ufbx_a
 	ufbxt_hash_pod(h, v->compose_scale);
 
 	ufbxt_hash_list(h, v->anim_values, ufbxt_hash_element_ref_imp);
-	ufbxt_hash_list_ptr(h, v->anim_props, ufbxt_hash_anim_prop_imp);
+
+	// Animated properties are sorted by element address, hash them in element ID
+	// order so that the hash does not depend on the memory layout of the scene.
+	{
+		size_t count = v->anim_props.count;
+		const ufbx_anim_prop **props = (const ufbx_anim_prop**)malloc(count * sizeof(const ufbx_anim_prop*) + 1);
+		assert(props);
+		for (size_t i = 0; i < count; i++) {
+			props[i] = &v->anim_props.data[i];
+		}
+		qsort((void*)props, count, sizeof(const ufbx_anim_prop*), &ufbxt_cmp_anim_prop_ptr);
+
+		ufbxt_push_tag(h, "anim_props");
+		ufbxt_hash_size_t(h, count);
+		ufbxt_push_tag(h, "data");
+		for (size_t i = 0; i < count; i++) {
+			ufbxt_push_tag_index(h, i);
+			ufbxt_hash_anim_prop_imp(h, props[i]);
+			ufbxt_pop_tag(h);
+		}
+		ufbxt_pop_tag(h);
+		ufbxt_pop_tag(h);
+
+		free((void*)props);
+	}
 
 	ufbxt_hash_anim(h, v->anim);
 
@@ -12,6 +12,8 @@ static void ufbxt_assert_fail(const char *file, uint32_t line, const char *expr)
 #if defined(UFBXT_THREADS)
 	#define UFBX_OS_IMPLEMENTATION
 	#include "../extra/ufbx_os.h"
+	#define UFBX_LOAD_BATCH_IMPLEMENTATION
+	#include "../extra/ufbx_load_batch.h"
 #endif
 
 #include <string.h>
@@ -134,6 +136,7 @@ static void ufbxt_longjmp(int env, int value, const char *file, uint32_t line, c
 
 #include "check_scene.h"
 #include "testing_utils.h"
+#include "hash_scene.h"
 
 typedef struct {
 	int failed;
@@ -2797,6 +2800,51 @@ void ufbxt_do_file_test(const char *name, void (*test_fn)(ufbx_scene *s, ufbxt_d
 				ufbxt_assert_fail(__FILE__, __LINE__, "Failed to parse streamed file");
 			}
 
+			// Round-trip through a scene snapshot
+			if (streamed_scene) {
+				ufbx_scene_snapshot *snapshot = ufbx_save_scene_snapshot(streamed_scene, NULL, &error);
+				if (!snapshot) ufbxt_log_error(&error);
+				ufbxt_assert(snapshot);
+
+				ufbx_scene *snapshot_scene = ufbx_load_scene_snapshot(snapshot->data.data, snapshot->data.size, NULL, &error);
+				if (!snapshot_scene) ufbxt_log_error(&error);
+				ufbxt_assert(snapshot_scene);
+				ufbxt_check_scene(snapshot_scene);
+				ufbxt_assert(snapshot_scene->dom_root);
+				ufbxt_assert(ufbxt_hash_scene(snapshot_scene, NULL) == ufbxt_hash_scene(streamed_scene, NULL));
+
+				ufbx_free_scene(snapshot_scene);
+				ufbx_free_scene_snapshot(snapshot);
+			}
+
+			// Compact result layout
+			if (scene) {
+				ufbx_load_opts compact_opts = load_opts;
+				compact_opts.compact_result = true;
+
+				ufbx_scene *compact_scene = ufbx_load_memory(data, size, &compact_opts, &error);
+				if (!compact_scene) ufbxt_log_error(&error);
+				ufbxt_assert(compact_scene);
+				ufbxt_check_scene(compact_scene);
+
+				// Animated properties are sorted by element address so their order may differ
+				for (size_t i = 0; i < scene->anim_layers.count; i++) {
+					ufbx_anim_layer *layer = scene->anim_layers.data[i];
+					ufbx_anim_layer *compact_layer = compact_scene->anim_layers.data[i];
+					ufbxt_assert(layer->anim_props.count == compact_layer->anim_props.count);
+					for (size_t j = 0; j < layer->anim_props.count; j++) {
+						ufbx_anim_prop *aprop = &layer->anim_props.data[j];
+						ufbx_element *compact_elem = compact_scene->elements.data[aprop->element->element_id];
+						ufbx_anim_prop *compact_aprop = ufbx_find_anim_prop_len(compact_layer, compact_elem, aprop->prop_name.data, aprop->prop_name.length);
+						ufbxt_assert(compact_aprop);
+						ufbxt_assert(compact_aprop->anim_value->element_id == aprop->anim_value->element_id);
+					}
+				}
+				ufbxt_assert(ufbxt_hash_scene(compact_scene, NULL) == ufbxt_hash_scene(scene, NULL));
+
+				ufbx_free_scene(compact_scene);
+			}
+
 			#if defined(UFBXT_THREADS)
 			{
 				ufbx_load_opts thread_opts = load_opts;
@@ -2961,6 +3009,8 @@ void ufbxt_do_file_test(const char *name, void (*test_fn)(ufbx_scene *s, ufbxt_d
 					loose_opts.connect_broken_elements = true;
 					loose_opts.generate_missing_normals = true;
 					loose_opts.ignore_missing_external_files = true;
+					loose_opts.store_triangle_indices = true;
+					loose_opts.compute_topology = true;
 
 					ufbx_error loose_error;
 					ufbx_scene *loose_scene = ufbx_load_file(buf, &loose_opts, &loose_error);
@@ -2300,3 +2300,689 @@ UFBXT_FILE_TEST(maya_anim_layer_anim)
 	ufbx_free_baked_anim(bake);
 }
 #endif
+
+#if UFBXT_IMPL
+static void ufbxt_check_compiled_anim(ufbxt_diff_error *err, const ufbx_scene *scene, const ufbx_anim *anim, const ufbx_compiled_anim *compiled)
+{
+	ufbxt_assert(compiled->num_nodes == scene->nodes.count);
+	ufbxt_assert(compiled->num_static_nodes + compiled->num_curve_nodes + compiled->num_fallback_nodes == compiled->num_nodes);
+
+	ufbx_transform *pose = (ufbx_transform*)calloc(scene->nodes.count + 1, sizeof(ufbx_transform));
+	ufbxt_assert(pose);
+
+	// Sample outside of the animation range as well to check extrapolation
+	double time_begin = anim->time_begin - 0.5;
+	double time_end = anim->time_end + 0.5;
+	const size_t num_samples = 64;
+	for (size_t i = 0; i <= num_samples; i++) {
+		double time = time_begin + (time_end - time_begin) * ((double)i / (double)num_samples);
+		ufbxt_hintf("time=%f", time);
+
+		pose[scene->nodes.count].translation.x = 123.0f;
+		size_t num_written = ufbx_evaluate_pose(compiled, time, pose, scene->nodes.count + 1);
+		ufbxt_assert(num_written == scene->nodes.count);
+		ufbxt_assert(pose[scene->nodes.count].translation.x == 123.0f);
+
+		for (size_t node_ix = 0; node_ix < scene->nodes.count; node_ix++) {
+			ufbx_node *node = scene->nodes.data[node_ix];
+			ufbxt_hintf("time=%f node=%s", time, node->name.data);
+			ufbx_transform ref = ufbx_evaluate_transform(anim, node, time);
+			ufbxt_assert_close_vec3(err, pose[node_ix].translation, ref.translation);
+			ufbxt_assert_close_quat(err, pose[node_ix].rotation, ref.rotation);
+			ufbxt_assert_close_vec3(err, pose[node_ix].scale, ref.scale);
+		}
+	}
+
+	// Partial output buffer
+	if (scene->nodes.count > 1) {
+		size_t num_written = ufbx_evaluate_pose(compiled, 0.0, pose, 1);
+		ufbxt_assert(num_written == 1);
+	}
+
+	free(pose);
+}
+#endif
+
+UFBXT_FILE_TEST_ALT(anim_compiled_pose, maya_anim_pivot_rotate)
+#if UFBXT_IMPL
+{
+	ufbx_error error;
+	ufbx_compiled_anim *compiled = ufbx_compile_anim(scene, NULL, NULL, &error);
+	if (!compiled) ufbxt_log_error(&error);
+	ufbxt_assert(compiled);
+
+	ufbxt_assert(compiled->num_curve_nodes > 0);
+	ufbxt_assert(compiled->num_fallback_nodes == 0);
+	ufbxt_assert(compiled->num_curves > 0);
+
+	ufbxt_check_compiled_anim(err, scene, scene->anim, compiled);
+	ufbx_free_compiled_anim(compiled);
+}
+#endif
+
+UFBXT_FILE_TEST_ALT(anim_compiled_pose_layers, maya_anim_layers)
+#if UFBXT_IMPL
+{
+	ufbx_error error;
+	ufbx_compiled_anim *compiled = ufbx_compile_anim(scene, NULL, NULL, &error);
+	if (!compiled) ufbxt_log_error(&error);
+	ufbxt_assert(compiled);
+
+	// Nodes affected by multiple layers fall back to `ufbx_evaluate_transform()`
+	ufbxt_assert(compiled->num_fallback_nodes > 0);
+
+	ufbxt_check_compiled_anim(err, scene, scene->anim, compiled);
+	ufbx_free_compiled_anim(compiled);
+
+	// Only the first layer: everything can be evaluated from curves
+	uint32_t layer_ids[] = { scene->anim->layers.data[0]->typed_id };
+	ufbx_anim_opts anim_opts = { 0 };
+	anim_opts.layer_ids.data = layer_ids;
+	anim_opts.layer_ids.count = 1;
+	ufbx_anim *anim = ufbx_create_anim(scene, &anim_opts, &error);
+	if (!anim) ufbxt_log_error(&error);
+	ufbxt_assert(anim);
+
+	compiled = ufbx_compile_anim(scene, anim, NULL, &error);
+	if (!compiled) ufbxt_log_error(&error);
+	ufbxt_assert(compiled);
+	ufbxt_assert(compiled->num_fallback_nodes == 0);
+	ufbxt_assert(compiled->num_curve_nodes > 0);
+
+	ufbxt_check_compiled_anim(err, scene, anim, compiled);
+
+	// The compiled animation retains the custom animation
+	ufbx_transform pose_ref[64], pose[64];
+	ufbxt_assert(scene->nodes.count <= ufbxt_arraycount(pose));
+	size_t num_nodes = ufbx_evaluate_pose(compiled, 0.5, pose_ref, ufbxt_arraycount(pose_ref));
+	ufbx_free_anim(anim);
+	ufbxt_assert(ufbx_evaluate_pose(compiled, 0.5, pose, ufbxt_arraycount(pose)) == num_nodes);
+	ufbxt_assert(!memcmp(pose, pose_ref, num_nodes * sizeof(ufbx_transform)));
+
+	ufbx_free_compiled_anim(compiled);
+}
+#endif
+
+UFBXT_FILE_TEST_OPTS_ALT(anim_compiled_pose_scale_helper, maya_anim_no_inherit_scale, ufbxt_anim_scale_helper_opts)
+#if UFBXT_IMPL
+{
+	ufbx_error error;
+	ufbx_compiled_anim *compiled = ufbx_compile_anim(scene, NULL, NULL, &error);
+	if (!compiled) ufbxt_log_error(&error);
+	ufbxt_assert(compiled);
+
+	ufbxt_assert(compiled->num_fallback_nodes > 0);
+
+	ufbxt_check_compiled_anim(err, scene, scene->anim, compiled);
+	ufbx_free_compiled_anim(compiled);
+}
+#endif
+
+#if UFBXT_IMPL
+static void ufbxt_check_compressed_track_vec3(ufbxt_diff_error *err, const ufbx_compressed_track *track, ufbx_baked_vec3_list keys)
+{
+	ufbx_real threshold = 0.00001f;
+	threshold += (ufbx_real)fmax(fmax(track->range_scale.x, track->range_scale.y), track->range_scale.z);
+
+	for (size_t i = 0; i < keys.count; i++) {
+		double times[] = { keys.data[i].time, i + 1 < keys.count ? (keys.data[i].time + keys.data[i + 1].time) * 0.5 : keys.data[i].time + 1.0 };
+		for (size_t j = 0; j < ufbxt_arraycount(times); j++) {
+			ufbx_vec3 ref = ufbx_evaluate_baked_vec3(keys, times[j]);
+			ufbx_vec3 value = ufbx_evaluate_compressed_vec3(track, times[j]);
+			ufbxt_assert_close_vec3_threshold(err, ref, value, threshold);
+		}
+	}
+}
+
+static void ufbxt_check_compressed_track_quat(ufbxt_diff_error *err, const ufbx_compressed_track *track, ufbx_baked_quat_list keys)
+{
+	for (size_t i = 0; i < keys.count; i++) {
+		double times[] = { keys.data[i].time, i + 1 < keys.count ? (keys.data[i].time + keys.data[i + 1].time) * 0.5 : keys.data[i].time + 1.0 };
+		for (size_t j = 0; j < ufbxt_arraycount(times); j++) {
+			ufbx_quat ref = ufbx_evaluate_baked_quat(keys, times[j]);
+			ufbx_quat value = ufbx_evaluate_compressed_quat(track, times[j]);
+			ufbx_real dot = ufbx_quat_dot(ref, value);
+			ufbxt_assert(fabs(dot) >= 0.99999);
+		}
+	}
+}
+
+// Returns the size of the baked keyframes relative to the compressed data
+static double ufbxt_check_compressed_anim(ufbxt_diff_error *err, const ufbx_baked_anim *bake)
+{
+	ufbx_error error;
+	ufbx_compressed_anim *anim = ufbx_compress_baked_anim(bake, NULL, &error);
+	if (!anim) ufbxt_log_error(&error);
+	ufbxt_assert(anim);
+
+	size_t baked_size = 0;
+	ufbxt_assert(anim->nodes.count == bake->nodes.count);
+	for (size_t i = 0; i < bake->nodes.count; i++) {
+		const ufbx_baked_node *ref = &bake->nodes.data[i];
+		const ufbx_compressed_node *node = &anim->nodes.data[i];
+		ufbxt_assert(node->typed_id == ref->typed_id);
+		ufbxt_assert(node->element_id == ref->element_id);
+		if (ref->constant_translation) ufbxt_assert(node->translation.num_keys == 0);
+		if (ref->constant_rotation) ufbxt_assert(node->rotation.num_keys == 0);
+		if (ref->constant_scale) ufbxt_assert(node->scale.num_keys == 0);
+
+		ufbxt_check_compressed_track_vec3(err, &node->translation, ref->translation_keys);
+		ufbxt_check_compressed_track_quat(err, &node->rotation, ref->rotation_keys);
+		ufbxt_check_compressed_track_vec3(err, &node->scale, ref->scale_keys);
+
+		ufbx_transform transform = ufbx_evaluate_compressed_node(node, 0.5);
+		ufbxt_assert_close_vec3(err, transform.translation, ufbx_evaluate_compressed_vec3(&node->translation, 0.5));
+		ufbxt_assert_close_vec3(err, transform.scale, ufbx_evaluate_compressed_vec3(&node->scale, 0.5));
+
+		baked_size += ref->translation_keys.count * sizeof(ufbx_baked_vec3);
+		baked_size += ref->rotation_keys.count * sizeof(ufbx_baked_quat);
+		baked_size += ref->scale_keys.count * sizeof(ufbx_baked_vec3);
+	}
+
+	ufbxt_assert(anim->elements.count == bake->elements.count);
+	for (size_t i = 0; i < bake->elements.count; i++) {
+		const ufbx_baked_element *ref = &bake->elements.data[i];
+		const ufbx_compressed_element *elem = &anim->elements.data[i];
+		ufbxt_assert(elem->element_id == ref->element_id);
+		ufbxt_assert(elem->props.count == ref->props.count);
+		for (size_t j = 0; j < ref->props.count; j++) {
+			ufbxt_assert(!strcmp(elem->props.data[j].name.data, ref->props.data[j].name.data));
+			ufbxt_check_compressed_track_vec3(err, &elem->props.data[j].track, ref->props.data[j].keys);
+			baked_size += ref->props.data[j].keys.count * sizeof(ufbx_baked_vec3);
+		}
+	}
+
+	ufbxt_assert(anim->key_data_size < baked_size);
+	double ratio = (double)baked_size / (double)anim->key_data_size;
+
+	ufbx_free_compressed_anim(anim);
+	return ratio;
+}
+#endif
+
+UFBXT_FILE_TEST_ALT(anim_compressed, maya_anim_pivot_rotate)
+#if UFBXT_IMPL
+{
+	ufbx_error error;
+	ufbx_baked_anim *bake = ufbx_bake_anim(scene, NULL, NULL, &error);
+	if (!bake) ufbxt_log_error(&error);
+	ufbxt_assert(bake);
+
+	// Resampled keys are evenly spaced so only the values are stored
+	ufbxt_assert(ufbxt_check_compressed_anim(err, bake) >= 4.0);
+	ufbx_free_baked_anim(bake);
+
+	ufbx_bake_opts opts = { 0 };
+	opts.key_reduction_enabled = true;
+	opts.key_reduction_rotation = true;
+	bake = ufbx_bake_anim(scene, NULL, &opts, &error);
+	if (!bake) ufbxt_log_error(&error);
+	ufbxt_assert(bake);
+	ufbxt_check_compressed_anim(err, bake);
+	ufbx_free_baked_anim(bake);
+}
+#endif
+
+UFBXT_FILE_TEST_ALT(anim_compressed_props, maya_anim_diffuse_curve)
+#if UFBXT_IMPL
+{
+	ufbx_error error;
+	ufbx_bake_opts opts = { 0 };
+	opts.resample_rate = 24.0;
+	ufbx_baked_anim *bake = ufbx_bake_anim(scene, NULL, &opts, &error);
+	if (!bake) ufbxt_log_error(&error);
+	ufbxt_assert(bake);
+	ufbxt_assert(bake->elements.count > 0);
+	ufbxt_check_compressed_anim(err, bake);
+	ufbx_free_baked_anim(bake);
+}
+#endif
+
+#if UFBXT_IMPL
+static void ufbxt_check_sampled_baked_pose(ufbxt_diff_error *err, const ufbx_baked_anim *bake)
+{
+	size_t num_nodes = bake->nodes.count;
+	ufbx_transform *pose = (ufbx_transform*)calloc(num_nodes + 1, sizeof(ufbx_transform));
+	ufbx_curve_cursor *cursors = (ufbx_curve_cursor*)calloc(num_nodes + 1, sizeof(ufbx_curve_cursor));
+	ufbxt_assert(pose && cursors);
+
+	// Sample forwards and backwards to exercise the cursors
+	for (int pass = 0; pass < 2; pass++) {
+		for (int frame = -2; frame <= 100; frame++) {
+			double time = (pass == 0 ? (double)frame : (double)(98 - frame)) / 30.0 + 0.01;
+			for (int use_cursors = 0; use_cursors <= 1; use_cursors++) {
+				ufbx_curve_cursor *cur = use_cursors ? cursors : NULL;
+				ufbxt_assert(ufbx_sample_baked_pose(bake, time, pose, num_nodes + 1, cur, num_nodes) == num_nodes);
+
+				for (size_t i = 0; i < num_nodes; i++) {
+					const ufbx_baked_node *node = &bake->nodes.data[i];
+					ufbx_vec3 translation = ufbx_evaluate_baked_vec3(node->translation_keys, time);
+					ufbx_quat rotation = ufbx_evaluate_baked_quat(node->rotation_keys, time);
+					ufbx_vec3 scale = ufbx_evaluate_baked_vec3(node->scale_keys, time);
+					ufbxt_assert(!memcmp(&pose[i].translation, &translation, sizeof(ufbx_vec3)));
+					ufbxt_assert(!memcmp(&pose[i].rotation, &rotation, sizeof(ufbx_quat)));
+					ufbxt_assert(!memcmp(&pose[i].scale, &scale, sizeof(ufbx_vec3)));
+				}
+			}
+		}
+	}
+
+	ufbxt_assert(ufbx_sample_baked_pose(bake, 0.0, pose, 0, NULL, 0) == 0);
+
+	free(pose);
+	free(cursors);
+}
+#endif
+
+UFBXT_FILE_TEST_ALT(anim_sample_baked_pose, maya_anim_pivot_rotate)
+#if UFBXT_IMPL
+{
+	ufbx_error error;
+	ufbx_baked_anim *bake = ufbx_bake_anim(scene, NULL, NULL, &error);
+	if (!bake) ufbxt_log_error(&error);
+	ufbxt_assert(bake);
+	ufbxt_check_sampled_baked_pose(err, bake);
+	ufbx_free_baked_anim(bake);
+
+	// Key reduction results in different keyframe times per track
+	ufbx_bake_opts opts = { 0 };
+	opts.key_reduction_enabled = true;
+	opts.key_reduction_rotation = true;
+	bake = ufbx_bake_anim(scene, NULL, &opts, &error);
+	if (!bake) ufbxt_log_error(&error);
+	ufbxt_assert(bake);
+	ufbxt_check_sampled_baked_pose(err, bake);
+	ufbx_free_baked_anim(bake);
+}
+#endif
+
+UFBXT_FILE_TEST_ALT(anim_sample_baked_pose_layers, maya_anim_layers)
+#if UFBXT_IMPL
+{
+	ufbx_error error;
+	ufbx_baked_anim *bake = ufbx_bake_anim(scene, NULL, NULL, &error);
+	if (!bake) ufbxt_log_error(&error);
+	ufbxt_assert(bake);
+	ufbxt_check_sampled_baked_pose(err, bake);
+	ufbx_free_baked_anim(bake);
+}
+#endif
+
+#if UFBXT_IMPL
+static void ufbxt_check_updated_scene(ufbxt_diff_error *err, ufbx_scene *scene, const ufbx_anim *anim)
+{
+	ufbx_evaluate_opts opts = { 0 };
+	opts.evaluate_skinning = true;
+
+	ufbx_error error;
+	ufbxt_assert(!ufbx_update_evaluated_scene(scene, 0.0, &error));
+	ufbxt_assert(error.type != UFBX_ERROR_NONE);
+
+	ufbx_scene *state = ufbx_evaluate_scene(scene, anim, anim->time_begin, &opts, &error);
+	if (!state) ufbxt_log_error(&error);
+	ufbxt_assert(state);
+
+	// Step forwards, backwards and outside of the animation range
+	const size_t num_samples = 16;
+	for (size_t i = 0; i <= num_samples * 2; i++) {
+		double t = (double)(i <= num_samples ? i : num_samples * 2 - i) / (double)num_samples;
+		double time = anim->time_begin - 0.25 + (anim->time_end - anim->time_begin + 0.5) * t;
+		ufbxt_hintf("time=%f", time);
+
+		bool ok = ufbx_update_evaluated_scene(state, time, &error);
+		if (!ok) ufbxt_log_error(&error);
+		ufbxt_assert(ok);
+
+		ufbx_scene *ref = ufbx_evaluate_scene(scene, anim, time, &opts, &error);
+		if (!ref) ufbxt_log_error(&error);
+		ufbxt_assert(ref);
+
+		ufbxt_assert(ref->elements.count == state->elements.count);
+		for (size_t elem_ix = 0; elem_ix < ref->elements.count; elem_ix++) {
+			const ufbx_props *ref_props = &ref->elements.data[elem_ix]->props;
+			const ufbx_props *props = &state->elements.data[elem_ix]->props;
+			ufbxt_assert(ref_props->props.count == props->props.count);
+			ufbxt_assert(ref_props->num_animated == props->num_animated);
+			for (size_t prop_ix = 0; prop_ix < ref_props->props.count; prop_ix++) {
+				ufbxt_assert(ref_props->props.data[prop_ix].name.data == props->props.data[prop_ix].name.data);
+				ufbxt_assert_close_vec4(err, ref_props->props.data[prop_ix].value_vec4, props->props.data[prop_ix].value_vec4);
+			}
+		}
+
+		for (size_t node_ix = 0; node_ix < ref->nodes.count; node_ix++) {
+			ufbx_node *ref_node = ref->nodes.data[node_ix];
+			ufbx_node *node = state->nodes.data[node_ix];
+			ufbxt_hintf("time=%f node=%s", time, node->name.data);
+			ufbxt_assert_close_matrix(err, ref_node->node_to_world, node->node_to_world);
+			ufbxt_assert_close_matrix(err, ref_node->geometry_to_world, node->geometry_to_world);
+			ufbxt_assert(ref_node->visible == node->visible);
+		}
+
+		for (size_t chan_ix = 0; chan_ix < ref->blend_channels.count; chan_ix++) {
+			ufbxt_assert_close_real(err, ref->blend_channels.data[chan_ix]->weight, state->blend_channels.data[chan_ix]->weight);
+		}
+
+		for (size_t mesh_ix = 0; mesh_ix < ref->meshes.count; mesh_ix++) {
+			ufbx_mesh *ref_mesh = ref->meshes.data[mesh_ix];
+			ufbx_mesh *mesh = state->meshes.data[mesh_ix];
+			ufbxt_hintf("time=%f mesh=%s", time, mesh->name.data);
+			ufbxt_assert(ref_mesh->skinned_is_local == mesh->skinned_is_local);
+			ufbxt_assert(ref_mesh->skinned_position.values.count == mesh->skinned_position.values.count);
+			for (size_t vert_ix = 0; vert_ix < ref_mesh->skinned_position.values.count; vert_ix++) {
+				ufbxt_assert_close_vec3(err, ref_mesh->skinned_position.values.data[vert_ix], mesh->skinned_position.values.data[vert_ix]);
+			}
+			ufbxt_assert(ref_mesh->skinned_normal.values.count == mesh->skinned_normal.values.count);
+			for (size_t normal_ix = 0; normal_ix < ref_mesh->skinned_normal.values.count; normal_ix++) {
+				ufbxt_assert_close_vec3(err, ref_mesh->skinned_normal.values.data[normal_ix], mesh->skinned_normal.values.data[normal_ix]);
+			}
+		}
+
+		ufbx_free_scene(ref);
+	}
+
+	ufbx_free_scene(state);
+}
+#endif
+
+UFBXT_FILE_TEST_ALT(anim_update_scene_skin, blender_279_sausage)
+#if UFBXT_IMPL
+{
+	ufbxt_check_updated_scene(err, scene, scene->anim);
+}
+#endif
+
+UFBXT_FILE_TEST_ALT(anim_update_scene_blend, maya_blend_inbetween)
+#if UFBXT_IMPL
+{
+	ufbxt_check_updated_scene(err, scene, scene->anim);
+}
+#endif
+
+UFBXT_FILE_TEST_ALT(anim_update_scene_layers, maya_anim_layers)
+#if UFBXT_IMPL
+{
+	ufbxt_check_updated_scene(err, scene, scene->anim);
+}
+#endif
+
+UFBXT_FILE_TEST_OPTS_ALT(anim_update_scene_scale_helper, maya_anim_no_inherit_scale, ufbxt_anim_scale_helper_opts)
+#if UFBXT_IMPL
+{
+	ufbxt_check_updated_scene(err, scene, scene->anim);
+}
+#endif
+
+UFBXT_FILE_TEST_ALT(anim_update_scene_free_anim, maya_anim_light)
+#if UFBXT_IMPL
+{
+	ufbx_node *node = ufbx_find_node(scene, "pointLight1");
+	ufbxt_assert(node && node->light);
+	uint32_t element_id = node->light->element.element_id;
+
+	ufbx_prop_override_desc overrides[] = {
+		{ element_id, { "Intensity", SIZE_MAX }, { (ufbx_real)10.0 } },
+		{ element_id, { "|NewProp", SIZE_MAX }, { 10, 20, 30 }, { "Test", SIZE_MAX } },
+	};
+	ufbx_transform_override transform_overrides[] = {
+		{ node->typed_id, { { 1.0f, 2.0f, 3.0f }, { 0.0f, 0.0f, 0.0f, 1.0f }, { 4.0f, 5.0f, 6.0f } } },
+	};
+
+	ufbx_anim_opts opts = { 0 };
+	opts.prop_overrides.data = overrides;
+	opts.prop_overrides.count = ufbxt_arraycount(overrides);
+	opts.transform_overrides.data = transform_overrides;
+	opts.transform_overrides.count = ufbxt_arraycount(transform_overrides);
+
+	ufbx_error error;
+	ufbx_anim *anim = ufbx_create_anim(scene, &opts, &error);
+	if (!anim) ufbxt_log_error(&error);
+	ufbxt_assert(anim);
+
+	ufbx_scene *state = ufbx_evaluate_scene(scene, anim, 0.0, NULL, &error);
+	if (!state) ufbxt_log_error(&error);
+	ufbxt_assert(state);
+
+	// Overwrite the freed memory to catch references to it without ASan
+	memset(anim->prop_overrides.data, 0xcc, anim->prop_overrides.count * sizeof(ufbx_prop_override));
+	memset(anim->transform_overrides.data, 0xcc, anim->transform_overrides.count * sizeof(ufbx_transform_override));
+	ufbx_free_anim(anim);
+
+	ufbx_node *light_node = ufbx_find_node(state, "pointLight1");
+	ufbxt_assert(light_node && light_node->light);
+	ufbx_light *light = light_node->light;
+
+	ufbx_vec3 ref_new = { 10, 20, 30 };
+	for (int frame = 0; frame <= 60; frame += 12) {
+		double time = frame * (1.0/24.0);
+		ufbxt_hintf("time=%f", time);
+
+		bool ok = ufbx_update_evaluated_scene(state, time, &error);
+		if (!ok) ufbxt_log_error(&error);
+		ufbxt_assert(ok);
+
+		ufbxt_assert_close_real(err, light->intensity, 0.1f);
+		ufbxt_assert_close_vec3(err, light_node->local_transform.translation, transform_overrides[0].transform.translation);
+		ufbxt_assert_close_vec3(err, light_node->local_transform.scale, transform_overrides[0].transform.scale);
+
+		ufbx_prop *new_prop = ufbx_find_prop(&light->props, "|NewProp");
+		ufbxt_assert(new_prop);
+		ufbxt_assert(!strcmp(new_prop->value_str.data, "Test"));
+		ufbxt_assert_close_vec3(err, new_prop->value_vec3, ref_new);
+	}
+
+	ufbx_free_scene(state);
+}
+#endif
+
+UFBXT_FILE_TEST_OPTS_ALT(anim_evaluate_threaded_nodes, maya_anim_no_inherit_scale, ufbxt_anim_scale_helper_opts)
+#if UFBXT_IMPL
+{
+#if defined(UFBXT_THREADS)
+	// Parallel transform propagation must match the serial result exactly
+	ufbx_evaluate_opts serial_opts = { 0 };
+	ufbx_evaluate_opts thread_opts = { 0 };
+	ufbx_os_init_ufbx_thread_pool(&thread_opts.thread_opts.pool, g_thread_pool);
+
+	for (int frame = 0; frame <= 30; frame += 5) {
+		double time = (double)frame / 30.0;
+		ufbxt_hintf("time=%f", time);
+
+		ufbx_scene *serial = ufbx_evaluate_scene(scene, scene->anim, time, &serial_opts, NULL);
+		ufbx_scene *threaded = ufbx_evaluate_scene(scene, scene->anim, time, &thread_opts, NULL);
+		ufbxt_assert(serial && threaded);
+
+		ufbxt_assert(serial->nodes.count == threaded->nodes.count);
+		for (size_t i = 0; i < serial->nodes.count; i++) {
+			ufbx_node *a = serial->nodes.data[i], *b = threaded->nodes.data[i];
+			ufbxt_assert(!memcmp(&a->local_transform, &b->local_transform, sizeof(ufbx_transform)));
+			ufbxt_assert(!memcmp(&a->node_to_world, &b->node_to_world, sizeof(ufbx_matrix)));
+			ufbxt_assert(!memcmp(&a->unscaled_node_to_world, &b->unscaled_node_to_world, sizeof(ufbx_matrix)));
+			ufbxt_assert(!memcmp(&a->geometry_to_world, &b->geometry_to_world, sizeof(ufbx_matrix)));
+		}
+
+		ufbx_free_scene(serial);
+		ufbx_free_scene(threaded);
+	}
+#endif
+}
+#endif
+
+UFBXT_TEST(curve_cursor)
+#if UFBXT_IMPL
+{
+	const size_t num_keys = 10000;
+	ufbx_keyframe *keys = (ufbx_keyframe*)calloc(num_keys, sizeof(ufbx_keyframe));
+	ufbx_baked_vec3 *vec_keys = (ufbx_baked_vec3*)calloc(num_keys, sizeof(ufbx_baked_vec3));
+	ufbx_baked_quat *quat_keys = (ufbx_baked_quat*)calloc(num_keys, sizeof(ufbx_baked_quat));
+	ufbxt_assert(keys && vec_keys && quat_keys);
+
+	uint32_t state = 1;
+	double time = 0.0;
+	for (size_t i = 0; i < num_keys; i++) {
+		ufbx_keyframe *key = &keys[i];
+		key->time = time;
+		key->value = ufbxt_xorshift32_real(&state) * 10.0f;
+		key->interpolation = (ufbx_interpolation)(i % 4);
+		key->left.dx = key->right.dx = 0.01f;
+		key->left.dy = key->right.dy = ufbxt_xorshift32_real(&state);
+
+		vec_keys[i].time = time;
+		vec_keys[i].value.x = key->value;
+		quat_keys[i].time = time;
+		quat_keys[i].value = ufbx_euler_to_quat(vec_keys[i].value, UFBX_ROTATION_ORDER_XYZ);
+
+		// Include some duplicate times for discontinuities
+		if (i % 7 != 0) time += 1.0 / 30.0;
+	}
+
+	ufbx_anim_curve curve = { 0 };
+	curve.keyframes.data = keys;
+	curve.keyframes.count = num_keys;
+
+	ufbx_baked_vec3_list vec_list = { vec_keys, num_keys };
+	ufbx_baked_quat_list quat_list = { quat_keys, num_keys };
+
+	ufbx_curve_cursor cursor = { 0 };
+	ufbx_curve_cursor vec_cursor = { 0 };
+	ufbx_curve_cursor quat_cursor = { 0 };
+
+	// Forward playback at various rates, random jumps and reverse playback
+	double t = -1.0;
+	for (size_t i = 0; i < 100000; i++) {
+		uint32_t mode = (uint32_t)(i / 10000) % 4;
+		if (mode == 0) {
+			t += 1.0 / 60.0;
+		} else if (mode == 1) {
+			t += 0.5;
+		} else if (mode == 2) {
+			t = ((double)ufbxt_xorshift32_real(&state) * 1.2 - 0.1) * time;
+		} else {
+			t -= 1.0 / 24.0;
+		}
+		if (i % 997 == 0) t = keys[(i * 31) % num_keys].time;
+		ufbxt_hintf("i=%zu t=%f", i, t);
+
+		ufbx_real ref = ufbx_evaluate_curve(&curve, t, 0.0f);
+		ufbx_real value = ufbx_evaluate_curve_cursor(&curve, &cursor, t, 0.0f);
+		ufbxt_assert(ref == value);
+
+		ufbx_vec3 vec_ref = ufbx_evaluate_baked_vec3(vec_list, t);
+		ufbx_vec3 vec_value = ufbx_evaluate_baked_vec3_cursor(vec_list, &vec_cursor, t);
+		ufbxt_assert(!memcmp(&vec_ref, &vec_value, sizeof(ufbx_vec3)));
+
+		ufbx_quat quat_ref = ufbx_evaluate_baked_quat(quat_list, t);
+		ufbx_quat quat_value = ufbx_evaluate_baked_quat_cursor(quat_list, &quat_cursor, t);
+		ufbxt_assert(!memcmp(&quat_ref, &quat_value, sizeof(ufbx_quat)));
+	}
+
+	// Batch evaluation, `NULL` curves keep their default value
+	const ufbx_anim_curve *curves[] = { &curve, NULL, &curve };
+	ufbx_curve_cursor cursors[3] = { 0 };
+	for (size_t i = 0; i < 100; i++) {
+		double bt = (double)i * 0.75;
+		ufbx_real values[3] = { 1.0f, 2.0f, 3.0f };
+		ufbx_real cursor_values[3] = { 1.0f, 2.0f, 3.0f };
+		ufbx_evaluate_curves(curves, NULL, 3, bt, values);
+		ufbx_evaluate_curves(curves, cursors, 3, bt, cursor_values);
+
+		ufbx_real ref = ufbx_evaluate_curve(&curve, bt, 0.0f);
+		ufbxt_assert(values[0] == ref && values[1] == 2.0f && values[2] == ref);
+		ufbxt_assert(!memcmp(values, cursor_values, sizeof(values)));
+	}
+
+	// Empty and single keyframe curves
+	ufbx_curve_cursor small_cursor = { 0 };
+	curve.keyframes.count = 0;
+	ufbxt_assert(ufbx_evaluate_curve_cursor(&curve, &small_cursor, 1.0, 5.0f) == 5.0f);
+	curve.keyframes.count = 1;
+	ufbxt_assert(ufbx_evaluate_curve_cursor(&curve, &small_cursor, 1.0, 5.0f) == keys[0].value);
+	ufbxt_assert(ufbx_evaluate_curve_cursor(NULL, &small_cursor, 1.0, 5.0f) == 5.0f);
+
+	free(keys);
+	free(vec_keys);
+	free(quat_keys);
+}
+#endif
+
+UFBXT_TEST(curve_batch_cubic)
+#if UFBXT_IMPL
+{
+	ufbxt_diff_error err = { 0 };
+
+	const size_t num_curves = 7;
+	const size_t num_keys = 64;
+	ufbx_keyframe *keys = (ufbx_keyframe*)calloc(num_curves * num_keys, sizeof(ufbx_keyframe));
+	ufbxt_assert(keys);
+
+	ufbx_anim_curve curves[7];
+	const ufbx_anim_curve *curve_ptrs[8];
+	memset(curves, 0, sizeof(curves));
+
+	uint32_t state = 2;
+	for (size_t ci = 0; ci < num_curves; ci++) {
+		ufbx_keyframe *ck = keys + ci * num_keys;
+		double time = 0.0;
+		for (size_t i = 0; i < num_keys; i++) {
+			ufbx_keyframe *key = &ck[i];
+			double delta = 0.05 + (double)ufbxt_xorshift32_real(&state) * 0.5;
+			key->time = time;
+			key->value = ufbxt_xorshift32_real(&state) * 4.0f - 2.0f;
+			key->interpolation = (ci == 3 && i % 5 == 0) ? UFBX_INTERPOLATION_LINEAR : UFBX_INTERPOLATION_CUBIC;
+
+			// Extreme tangents need more Newton iterations than the unrolled ones
+			float extent = (i % 3 == 0) ? 0.49f : 0.2f;
+			key->left.dx = (float)(delta * extent * ufbxt_xorshift32_real(&state));
+			key->right.dx = (float)(delta * extent * ufbxt_xorshift32_real(&state));
+			key->left.dy = ufbxt_xorshift32_real(&state) * 2.0f - 1.0f;
+			key->right.dy = ufbxt_xorshift32_real(&state) * 2.0f - 1.0f;
+			time += delta;
+		}
+		curves[ci].keyframes.data = ck;
+		curves[ci].keyframes.count = num_keys;
+		curve_ptrs[ci] = &curves[ci];
+	}
+	curve_ptrs[7] = NULL;
+
+	double end_time = curves[0].keyframes.data[num_keys - 1].time;
+	const size_t num_samples = 1001;
+	double *times = (double*)calloc(num_samples, sizeof(double));
+	ufbx_real *values = (ufbx_real*)calloc(num_samples, sizeof(ufbx_real));
+	ufbxt_assert(times && values);
+
+	for (size_t i = 0; i < num_samples; i++) {
+		times[i] = -1.0 + (end_time + 2.0) * ((double)i / (double)(num_samples - 1));
+	}
+	times[num_samples / 2] = curves[0].keyframes.data[10].time;
+
+	for (size_t ci = 0; ci < num_curves; ci++) {
+		ufbx_evaluate_curve_samples(&curves[ci], times, values, num_samples, 0.0f);
+		for (size_t i = 0; i < num_samples; i++) {
+			ufbxt_hintf("ci=%zu i=%zu", ci, i);
+			ufbxt_assert_close_real(&err, values[i], ufbx_evaluate_curve(&curves[ci], times[i], 0.0f));
+		}
+	}
+
+	ufbx_curve_cursor cursors[8] = { 0 };
+	for (size_t i = 0; i < num_samples; i++) {
+		ufbx_real batch_values[8];
+		for (size_t ci = 0; ci < 8; ci++) batch_values[ci] = -100.0f;
+		ufbx_evaluate_curves(curve_ptrs, (i % 2) ? cursors : NULL, 8, times[i], batch_values);
+
+		for (size_t ci = 0; ci < num_curves; ci++) {
+			ufbxt_hintf("ci=%zu i=%zu", ci, i);
+			ufbxt_assert_close_real(&err, batch_values[ci], ufbx_evaluate_curve(&curves[ci], times[i], 0.0f));
+		}
+		ufbxt_assert(batch_values[7] == -100.0f);
+	}
+
+	// Empty curves fill the default value
+	ufbx_evaluate_curve_samples(NULL, times, values, 4, 3.0f);
+	ufbxt_assert(values[0] == 3.0f && values[3] == 3.0f);
+
+	ufbxt_logf(".. Absolute diff: avg %.3g, max %.3g (%zu tests)", err.sum / (ufbx_real)err.num, err.max, err.num);
+
+	free(times);
+	free(values);
+	free(keys);
+}
+#endif
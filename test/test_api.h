@@ -148,5 +148,703 @@ UFBXT_TEST(retain_free_null)
 	ufbx_free_anim(NULL);
 	ufbx_retain_baked_anim(NULL);
 	ufbx_free_baked_anim(NULL);
+	ufbx_retain_scene_snapshot(NULL);
+	ufbx_free_scene_snapshot(NULL);
+}
+#endif
+
+#if UFBXT_IMPL
+typedef struct {
+	const char *data;
+	size_t size;
+	size_t pos;
+} ufbxt_snapshot_stream;
+
+static size_t ufbxt_snapshot_read_byte(void *user, void *data, size_t size)
+{
+	ufbxt_snapshot_stream *stream = (ufbxt_snapshot_stream*)user;
+	if (stream->pos >= stream->size || size == 0) return 0;
+	*(char*)data = stream->data[stream->pos++];
+	return 1;
+}
+#endif
+
+UFBXT_FILE_TEST_ALT(snapshot_stream, maya_cube_7500_binary)
+#if UFBXT_IMPL
+{
+	ufbx_error error;
+	ufbx_scene_snapshot *snapshot = ufbx_save_scene_snapshot(scene, NULL, &error);
+	if (!snapshot) ufbxt_log_error(&error);
+	ufbxt_assert(snapshot);
+	ufbx_retain_scene_snapshot(snapshot);
+	ufbx_free_scene_snapshot(snapshot);
+
+	ufbxt_snapshot_stream user = { (const char*)snapshot->data.data, snapshot->data.size };
+	ufbx_stream stream = { 0 };
+	stream.read_fn = &ufbxt_snapshot_read_byte;
+	stream.user = &user;
+
+	ufbx_scene *snapshot_scene = ufbx_load_scene_snapshot_stream(&stream, NULL, &error);
+	if (!snapshot_scene) ufbxt_log_error(&error);
+	ufbxt_assert(snapshot_scene);
+	ufbxt_check_scene(snapshot_scene);
+	ufbxt_assert(user.pos == user.size);
+	ufbxt_assert(ufbxt_hash_scene(snapshot_scene, NULL) == ufbxt_hash_scene(scene, NULL));
+
+	// Evaluated scenes retain the snapshot scene
+	ufbx_scene *state = ufbx_evaluate_scene(snapshot_scene, NULL, 0.5, NULL, NULL);
+	ufbxt_assert(state);
+	ufbx_free_scene(snapshot_scene);
+	ufbxt_check_scene(state);
+
+	ufbx_node *node = ufbx_find_node(state, "pCube1");
+	ufbxt_assert(node && node->mesh);
+	ufbxt_assert(node->mesh->num_faces == 6);
+	ufbx_free_scene(state);
+
+	ufbx_free_scene_snapshot(snapshot);
+}
+#endif
+
+#if UFBXT_IMPL
+static const ufbx_dom_value *ufbxt_find_dom_raw_strings(const ufbx_dom_node *node)
+{
+	for (size_t i = 0; i < node->values.count; i++) {
+		const ufbx_dom_value *value = &node->values.data[i];
+		if (value->type == UFBX_DOM_VALUE_ARRAY_RAW_STRING && value->value_int > 0) return value;
+	}
+	for (size_t i = 0; i < node->children.count; i++) {
+		const ufbx_dom_value *value = ufbxt_find_dom_raw_strings(node->children.data[i]);
+		if (value) return value;
+	}
+	return NULL;
+}
+#endif
+
+UFBXT_TEST(snapshot_dom_raw_strings)
+#if UFBXT_IMPL
+{
+	size_t num_found = 0;
+	char path[512];
+	ufbxt_file_iterator iter = { "max2009_blob" };
+	while (ufbxt_next_file(&iter, path, sizeof(path))) {
+		ufbx_load_opts opts = { 0 };
+		opts.retain_dom = true;
+
+		ufbx_error error;
+		ufbx_scene *scene = ufbx_load_file(path, &opts, &error);
+		if (!scene) ufbxt_log_error(&error);
+		ufbxt_assert(scene);
+		const ufbx_dom_value *value = scene->dom_root ? ufbxt_find_dom_raw_strings(scene->dom_root) : NULL;
+		if (!value) {
+			ufbx_free_scene(scene);
+			continue;
+		}
+		num_found++;
+		const ufbx_string *strs = (const ufbx_string*)value->value_blob.data;
+		char first[256];
+		size_t first_len = strs[0].length < sizeof(first) ? strs[0].length : sizeof(first);
+		memcpy(first, strs[0].data, first_len);
+
+		ufbx_scene_snapshot *snapshot = ufbx_save_scene_snapshot(scene, NULL, &error);
+		if (!snapshot) ufbxt_log_error(&error);
+		ufbxt_assert(snapshot);
+		uint64_t hash = ufbxt_hash_scene(scene, NULL);
+
+		// The snapshot must not refer to the source scene
+		ufbx_free_scene(scene);
+
+		ufbx_scene *snapshot_scene = ufbx_load_scene_snapshot(snapshot->data.data, snapshot->data.size, NULL, &error);
+		if (!snapshot_scene) ufbxt_log_error(&error);
+		ufbxt_assert(snapshot_scene);
+		ufbx_free_scene_snapshot(snapshot);
+
+		value = ufbxt_find_dom_raw_strings(snapshot_scene->dom_root);
+		ufbxt_assert(value);
+		strs = (const ufbx_string*)value->value_blob.data;
+		ufbxt_assert(strs[0].length >= first_len);
+		ufbxt_assert(!memcmp(strs[0].data, first, first_len));
+		ufbxt_assert(ufbxt_hash_scene(snapshot_scene, NULL) == hash);
+
+		ufbx_free_scene(snapshot_scene);
+	}
+	ufbxt_assert(num_found > 0);
+}
+#endif
+
+UFBXT_FILE_TEST_ALT(snapshot_corrupt, maya_cube_7500_binary)
+#if UFBXT_IMPL
+{
+	ufbx_error error;
+	ufbx_scene_snapshot *snapshot = ufbx_save_scene_snapshot(scene, NULL, &error);
+	if (!snapshot) ufbxt_log_error(&error);
+	ufbxt_assert(snapshot);
+
+	size_t size = snapshot->data.size;
+	char *data = (char*)malloc(size);
+	ufbxt_assert(data);
+
+	// Truncated
+	for (size_t i = 0; i < size; i += 1 + i / 4) {
+		ufbx_scene *bad_scene = ufbx_load_scene_snapshot(snapshot->data.data, i, NULL, &error);
+		ufbxt_assert(!bad_scene);
+		ufbxt_assert(error.type == UFBX_ERROR_TRUNCATED_FILE);
+	}
+
+	// Flip single bytes in the header, data, and relocations
+	size_t positions[] = { 0, 12, 40, 64, size / 2, size - 1 };
+	for (size_t i = 0; i < ufbxt_arraycount(positions); i++) {
+		memcpy(data, snapshot->data.data, size);
+		data[positions[i]] ^= 0x10;
+
+		ufbx_scene *bad_scene = ufbx_load_scene_snapshot(data, size, NULL, &error);
+		ufbxt_assert(!bad_scene);
+		ufbxt_assert(error.type == UFBX_ERROR_BAD_SNAPSHOT);
+	}
+
+	// Checksum is not verified for data, but relocations are always validated
+	{
+		memcpy(data, snapshot->data.data, size);
+		uint64_t reloc;
+		memcpy(&reloc, data + size - sizeof(uint64_t), sizeof(uint64_t));
+		reloc += 1;
+		memcpy(data + size - sizeof(uint64_t), &reloc, sizeof(uint64_t));
+
+		ufbx_load_snapshot_opts opts = { 0 };
+		opts.skip_checksum = true;
+		ufbx_scene *bad_scene = ufbx_load_scene_snapshot(data, size, &opts, &error);
+		ufbxt_assert(!bad_scene);
+		ufbxt_assert(error.type == UFBX_ERROR_BAD_SNAPSHOT);
+	}
+
+	free(data);
+	ufbx_free_scene_snapshot(snapshot);
+
+	ufbx_scene *missing_scene = ufbx_load_scene_snapshot_file("<nonexistent>", NULL, &error);
+	ufbxt_assert(!missing_scene);
+	ufbxt_assert(error.type == UFBX_ERROR_FILE_NOT_FOUND);
+}
+#endif
+
+UFBXT_TEST(compact_result)
+#if UFBXT_IMPL
+{
+	char path[512];
+	ufbxt_file_iterator iter = { "maya_game_sausage" };
+	while (ufbxt_next_file(&iter, path, sizeof(path))) {
+		ufbxt_counting_alloc_stats stats = { 0 };
+
+		ufbx_load_opts opts = { 0 };
+		opts.compact_result = true;
+		opts.result_allocator.allocator.alloc_fn = &ufbxt_counting_alloc;
+		opts.result_allocator.allocator.free_fn = &ufbxt_counting_free;
+		opts.result_allocator.allocator.user = &stats;
+
+		ufbx_error error;
+		ufbx_scene *scene = ufbx_load_file(path, &opts, &error);
+		if (!scene) ufbxt_log_error(&error);
+		ufbxt_assert(scene);
+		ufbxt_check_scene(scene);
+
+		// The whole scene is in a single allocation
+		ufbxt_assert(stats.num_allocs > 1);
+		ufbxt_assert(stats.num_live == 1);
+
+		// Elements in typed lists are contiguous, except for elements that
+		// have been referenced before the list, eg. `ufbx_scene.root_node`.
+		size_t num_contiguous = 0;
+		for (size_t i = 1; i < scene->nodes.count; i++) {
+			const char *prev = (const char*)scene->nodes.data[i - 1];
+			const char *node = (const char*)scene->nodes.data[i];
+			if (node == prev + sizeof(ufbx_node)) num_contiguous++;
+		}
+		ufbxt_assert(num_contiguous + 2 >= scene->nodes.count);
+
+		ufbx_free_scene(scene);
+		ufbxt_assert(stats.num_live == 0);
+	}
+}
+#endif
+
+#if UFBXT_IMPL
+static size_t ufbxt_check_dom_array_alignment(const ufbx_dom_node *node)
+{
+	size_t num_arrays = 0;
+	for (size_t i = 0; i < node->values.count; i++) {
+		const ufbx_dom_value *value = &node->values.data[i];
+		size_t align = 0;
+		switch (value->type) {
+		case UFBX_DOM_VALUE_ARRAY_I32: align = sizeof(int32_t); break;
+		case UFBX_DOM_VALUE_ARRAY_I64: align = sizeof(int64_t); break;
+		case UFBX_DOM_VALUE_ARRAY_F32: align = sizeof(float); break;
+		case UFBX_DOM_VALUE_ARRAY_F64: align = sizeof(double); break;
+		case UFBX_DOM_VALUE_ARRAY_RAW_STRING: align = sizeof(void*); break;
+		default: break;
+		}
+		if (align > 0 && value->value_blob.size > 0) {
+			ufbxt_assert((uintptr_t)value->value_blob.data % align == 0);
+			num_arrays++;
+		}
+	}
+	for (size_t i = 0; i < node->children.count; i++) {
+		num_arrays += ufbxt_check_dom_array_alignment(node->children.data[i]);
+	}
+	return num_arrays;
+}
+#endif
+
+UFBXT_TEST(dom_array_alignment)
+#if UFBXT_IMPL
+{
+	char path[512];
+	ufbxt_file_iterator iter = { "maya_cube" };
+	while (ufbxt_next_file(&iter, path, sizeof(path))) {
+		ufbx_load_opts opts = { 0 };
+		opts.retain_dom = true;
+
+		ufbx_error error;
+		ufbx_scene *scene = ufbx_load_file(path, &opts, &error);
+		if (!scene) ufbxt_log_error(&error);
+		ufbxt_assert(scene);
+		if (!scene->dom_root) {
+			ufbx_free_scene(scene);
+			continue;
+		}
+		size_t num_arrays = ufbxt_check_dom_array_alignment(scene->dom_root);
+		ufbxt_assert(num_arrays > 0);
+
+		ufbx_scene_snapshot *snapshot = ufbx_save_scene_snapshot(scene, NULL, &error);
+		if (!snapshot) ufbxt_log_error(&error);
+		ufbxt_assert(snapshot);
+		ufbx_free_scene(scene);
+
+		ufbx_scene *snapshot_scene = ufbx_load_scene_snapshot(snapshot->data.data, snapshot->data.size, NULL, &error);
+		if (!snapshot_scene) ufbxt_log_error(&error);
+		ufbxt_assert(snapshot_scene);
+		ufbxt_assert(ufbxt_check_dom_array_alignment(snapshot_scene->dom_root) == num_arrays);
+		ufbx_free_scene(snapshot_scene);
+		ufbx_free_scene_snapshot(snapshot);
+
+		opts.compact_result = true;
+		ufbx_scene *compact_scene = ufbx_load_file(path, &opts, &error);
+		if (!compact_scene) ufbxt_log_error(&error);
+		ufbxt_assert(compact_scene);
+		ufbxt_assert(ufbxt_check_dom_array_alignment(compact_scene->dom_root) == num_arrays);
+		ufbx_free_scene(compact_scene);
+	}
+}
+#endif
+
+UFBXT_FILE_TEST_ALT(memory_peak, maya_slime_7500_ascii)
+#if UFBXT_IMPL
+{
+	const ufbx_metadata *metadata = &scene->metadata;
+	ufbxt_assert(metadata->temp_memory_peak >= metadata->temp_memory_used);
+	ufbxt_assert(metadata->memory_peak >= metadata->result_memory_used + metadata->temp_memory_used);
+
+	// Temporary parse data should be released before the scene is fully built
+	ufbxt_assert(metadata->memory_peak < metadata->temp_memory_peak + metadata->result_memory_used);
+}
+#endif
+
+UFBXT_TEST(load_stats)
+#if UFBXT_IMPL
+{
+	char path[512];
+	ufbxt_file_iterator iter = { "maya_slime" };
+	while (ufbxt_next_file(&iter, path, sizeof(path))) {
+		ufbx_load_opts opts = { 0 };
+		opts.collect_stats = true;
+
+		ufbx_scene *scene = ufbx_load_file(path, &opts, NULL);
+		ufbxt_assert(scene);
+
+		const ufbx_metadata *metadata = &scene->metadata;
+		const ufbx_load_stats *stats = &metadata->load_stats;
+		ufbxt_assert(stats->enabled);
+		ufbxt_assert(stats->wall_time >= 0.0);
+
+		double wall_time = 0.0;
+		size_t temp_allocs = 0, result_allocs = 0;
+		size_t temp_peak = 0;
+		for (size_t i = 0; i < UFBX_LOAD_PHASE_COUNT; i++) {
+			const ufbx_load_phase_stats *phase = &stats->phases[i];
+			ufbxt_assert(phase->wall_time >= 0.0);
+			wall_time += phase->wall_time;
+			temp_allocs += phase->temp_allocs;
+			result_allocs += phase->result_allocs;
+			if (phase->temp_memory_peak > temp_peak) temp_peak = phase->temp_memory_peak;
+		}
+
+		ufbxt_assert(fabs(wall_time - stats->wall_time) <= 1e-6 + stats->wall_time * 1e-6);
+		ufbxt_assert(temp_allocs > 0 && temp_allocs <= metadata->temp_allocs);
+		ufbxt_assert(result_allocs > 0 && result_allocs <= metadata->result_allocs);
+		ufbxt_assert(temp_peak <= metadata->temp_memory_peak);
+
+		ufbxt_assert(stats->phases[UFBX_LOAD_PHASE_IO].bytes_read > 0);
+		ufbxt_assert(stats->phases[UFBX_LOAD_PHASE_READ_OBJECTS].result_allocs > 0);
+		ufbxt_assert(stats->phases[UFBX_LOAD_PHASE_FINALIZE].result_allocs > 0);
+
+		ufbx_free_scene(scene);
+
+		// Statistics should be empty if not requested
+		opts.collect_stats = false;
+		scene = ufbx_load_file(path, &opts, NULL);
+		ufbxt_assert(scene);
+		ufbxt_assert(!scene->metadata.load_stats.enabled);
+		ufbxt_assert(scene->metadata.load_stats.phases[UFBX_LOAD_PHASE_IO].bytes_read == 0);
+		ufbx_free_scene(scene);
+	}
+}
+#endif
+
+#if UFBXT_IMPL
+typedef struct {
+	const char *stack[32];
+	size_t depth;
+	size_t num_zones;
+	bool found_phase;
+	bool found_parse;
+} ufbxt_trace_recorder;
+
+static void ufbxt_trace_begin(void *user, const char *name)
+{
+	ufbxt_trace_recorder *rec = (ufbxt_trace_recorder*)user;
+	ufbxt_assert(name && rec->depth < ufbxt_arraycount(rec->stack));
+	if (!strcmp(name, "read_objects") || !strcmp(name, "evaluate_props") || !strcmp(name, "bake_elements") || !strcmp(name, "subdivide_level")) {
+		rec->found_phase = true;
+	}
+	if (!strcmp(name, "parse")) {
+		rec->found_parse = true;
+	}
+	rec->stack[rec->depth++] = name;
+	rec->num_zones++;
+}
+
+static void ufbxt_trace_end(void *user, const char *name)
+{
+	ufbxt_trace_recorder *rec = (ufbxt_trace_recorder*)user;
+	ufbxt_assert(rec->depth > 0);
+	ufbxt_assert(!strcmp(rec->stack[--rec->depth], name));
+}
+
+static void ufbxt_init_trace_recorder(ufbx_trace_cb *cb, ufbxt_trace_recorder *rec)
+{
+	memset(rec, 0, sizeof(ufbxt_trace_recorder));
+	cb->begin_fn = &ufbxt_trace_begin;
+	cb->end_fn = &ufbxt_trace_end;
+	cb->user = rec;
+}
+#endif
+
+UFBXT_TEST(trace_zones)
+#if UFBXT_IMPL
+{
+	char path[512];
+	ufbxt_file_iterator iter = { "maya_cube" };
+	while (ufbxt_next_file(&iter, path, sizeof(path))) {
+		ufbxt_trace_recorder rec;
+
+		ufbx_load_opts load_opts = { 0 };
+		ufbxt_init_trace_recorder(&load_opts.trace_cb, &rec);
+		ufbx_scene *scene = ufbx_load_file(path, &load_opts, NULL);
+		ufbxt_assert(scene);
+		ufbxt_assert(rec.depth == 0 && rec.num_zones > 0 && rec.found_phase && rec.found_parse);
+
+		ufbx_evaluate_opts eval_opts = { 0 };
+		ufbxt_init_trace_recorder(&eval_opts.trace_cb, &rec);
+		ufbx_scene *state = ufbx_evaluate_scene(scene, NULL, 0.5, &eval_opts, NULL);
+		ufbxt_assert(state);
+		ufbxt_assert(rec.depth == 0 && rec.num_zones > 0 && rec.found_phase);
+		ufbx_free_scene(state);
+
+		ufbx_bake_opts bake_opts = { 0 };
+		ufbxt_init_trace_recorder(&bake_opts.trace_cb, &rec);
+		ufbx_baked_anim *bake = ufbx_bake_anim(scene, NULL, &bake_opts, NULL);
+		ufbxt_assert(bake);
+		ufbxt_assert(rec.depth == 0 && rec.num_zones > 0 && rec.found_phase);
+		ufbx_free_baked_anim(bake);
+
+		ufbx_node *node = ufbx_find_node(scene, "pCube1");
+		ufbxt_assert(node && node->mesh);
+
+		ufbx_subdivide_opts subdivide_opts = { 0 };
+		ufbxt_init_trace_recorder(&subdivide_opts.trace_cb, &rec);
+		ufbx_mesh *mesh = ufbx_subdivide_mesh(node->mesh, 2, &subdivide_opts, NULL);
+		ufbxt_assert(mesh);
+		ufbxt_assert(rec.depth == 0 && rec.num_zones > 0 && rec.found_phase);
+		ufbx_free_mesh(mesh);
+
+		ufbx_free_scene(scene);
+	}
+
+	// Zones must be closed even if loading fails
+	{
+		ufbxt_trace_recorder rec;
+		ufbx_load_opts opts = { 0 };
+		ufbxt_init_trace_recorder(&opts.trace_cb, &rec);
+		char data[] = "Kaydara FBX Binary  \x00\x1a\x00\xff\xff\xff\xff";
+		ufbx_scene *scene = ufbx_load_memory(data, sizeof(data), &opts, NULL);
+		ufbxt_assert(!scene);
+		ufbxt_assert(rec.depth == 0 && rec.num_zones > 0);
+	}
+}
+#endif
+
+UFBXT_TEST(load_context)
+#if UFBXT_IMPL
+{
+	char path[512];
+	ufbxt_file_iterator iter = { "maya_cube" };
+	while (ufbxt_next_file(&iter, path, sizeof(path))) {
+		ufbxt_counting_alloc_stats stats = { 0 };
+
+		ufbx_load_context_opts context_opts = { 0 };
+		context_opts.allocator.allocator.alloc_fn = &ufbxt_counting_alloc;
+		context_opts.allocator.allocator.free_fn = &ufbxt_counting_free;
+		context_opts.allocator.allocator.user = &stats;
+
+		ufbx_error error;
+		ufbx_load_context *context = ufbx_create_load_context(&context_opts, &error);
+		ufbxt_assert(context);
+
+		ufbx_load_opts opts = { 0 };
+		opts.load_context = context;
+
+		size_t first_allocs = 0;
+		for (size_t i = 0; i < 3; i++) {
+			size_t prev_allocs = stats.num_allocs;
+
+			ufbx_scene *scene = ufbx_load_file(path, &opts, &error);
+			if (!scene) ufbxt_log_error(&error);
+			ufbxt_assert(scene);
+			ufbxt_check_scene(scene);
+			ufbx_free_scene(scene);
+
+			// Later loads should mostly reuse the memory cached by the first one
+			size_t num_allocs = stats.num_allocs - prev_allocs;
+			if (i == 0) {
+				first_allocs = num_allocs;
+			} else {
+				ufbxt_assert(num_allocs * 2 < first_allocs);
+			}
+			ufbxt_assert(context->num_loads == i + 1);
+			ufbxt_assert(context->cached_memory > 0);
+		}
+
+		ufbx_trim_load_context(context, 0);
+		ufbxt_assert(context->cached_memory == 0);
+
+		ufbx_free_load_context(context);
+		ufbxt_assert(stats.num_live == 0);
+	}
+}
+#endif
+
+UFBXT_TEST(load_context_allocation_limit)
+#if UFBXT_IMPL
+{
+	char path[512];
+	ufbxt_file_iterator iter = { "maya_cube" };
+	while (ufbxt_next_file(&iter, path, sizeof(path))) {
+		// Cache almost nothing so that every load allocates from the context,
+		// a single load needs well below `allocation_limit` allocations.
+		ufbx_load_context_opts context_opts = { 0 };
+		context_opts.max_cached_memory = 1;
+		context_opts.allocator.allocation_limit = 1000;
+
+		ufbx_error error;
+		ufbx_load_context *context = ufbx_create_load_context(&context_opts, &error);
+		ufbxt_assert(context);
+
+		ufbx_load_opts opts = { 0 };
+		opts.load_context = context;
+
+		for (size_t i = 0; i < 64; i++) {
+			ufbx_scene *scene = ufbx_load_file(path, &opts, &error);
+			if (!scene) ufbxt_log_error(&error);
+			ufbxt_assert(scene);
+			ufbx_free_scene(scene);
+		}
+		ufbxt_assert(context->num_loads == 64);
+
+		ufbx_free_load_context(context);
+	}
+}
+#endif
+
+#if UFBXT_IMPL && defined(UFBXT_THREADS)
+typedef struct {
+	uint32_t *hits;
+	uint32_t heavy_index;
+	volatile uint32_t sink;
+} ufbxt_pool_task_data;
+
+static void ufbxt_pool_task_fn(void *user, uint32_t index)
+{
+	ufbxt_pool_task_data *data = (ufbxt_pool_task_data*)user;
+	if (index == data->heavy_index) {
+		for (uint32_t i = 0; i < 1000000; i++) {
+			data->sink += i;
+		}
+	}
+	data->hits[index] += 1;
+}
+
+typedef struct {
+	ufbx_os_thread_pool *pool;
+	char path[512];
+	size_t num_nodes[8];
+	bool ok[8];
+} ufbxt_shared_pool_loads;
+
+static void ufbxt_shared_pool_load_fn(void *user, uint32_t index)
+{
+	ufbxt_shared_pool_loads *loads = (ufbxt_shared_pool_loads*)user;
+	ufbx_load_opts opts = { 0 };
+	ufbx_os_init_ufbx_thread_pool(&opts.thread_opts.pool, loads->pool);
+	ufbx_scene *scene = ufbx_load_file(loads->path, &opts, NULL);
+	if (scene) {
+		loads->num_nodes[index] = scene->nodes.count;
+		loads->ok[index] = true;
+		ufbx_free_scene(scene);
+	}
+}
+#endif
+
+UFBXT_TEST(thread_pool_scheduling)
+#if UFBXT_IMPL
+{
+#if defined(UFBXT_THREADS)
+	for (int fair = 0; fair <= 1; fair++) {
+		ufbx_os_thread_pool_opts pool_opts = { 0 };
+		pool_opts.max_threads = 4;
+		pool_opts.fair = fair != 0;
+		ufbx_os_thread_pool *pool = ufbx_os_create_thread_pool(&pool_opts);
+		ufbxt_assert(pool);
+
+		// Mixed workload: one expensive index among many cheap ones, every
+		// index must run exactly once no matter which thread picks it up
+		static const uint32_t counts[] = { 1, 3, 1000, 0, 257 };
+		ufbxt_pool_task_data datas[ufbxt_arraycount(counts)];
+		uint64_t task_ids[ufbxt_arraycount(counts)];
+		for (size_t i = 0; i < ufbxt_arraycount(counts); i++) {
+			datas[i].hits = (uint32_t*)calloc(counts[i] + 1, sizeof(uint32_t));
+			ufbxt_assert(datas[i].hits);
+			datas[i].heavy_index = counts[i] / 2;
+			datas[i].sink = 0;
+			task_ids[i] = ufbx_os_thread_pool_run(pool, &ufbxt_pool_task_fn, &datas[i], counts[i]);
+		}
+		for (size_t i = ufbxt_arraycount(counts); i > 0; i--) {
+			ufbx_os_thread_pool_wait(pool, task_ids[i - 1]);
+			ufbxt_assert(ufbx_os_thread_pool_try_wait(pool, task_ids[i - 1]));
+		}
+		for (size_t i = 0; i < ufbxt_arraycount(counts); i++) {
+			for (uint32_t j = 0; j < counts[i]; j++) {
+				ufbxt_assert(datas[i].hits[j] == 1);
+			}
+			free(datas[i].hits);
+		}
+
+		// Several loads sharing the pool, submitted from the workers of another pool
+		ufbxt_shared_pool_loads loads = { pool };
+		ufbxt_file_iterator iter = { "maya_slime" };
+		ufbxt_assert(ufbxt_next_file(&iter, loads.path, sizeof(loads.path)));
+
+		ufbx_os_thread_pool_opts outer_opts = { 0 };
+		outer_opts.max_threads = 4;
+		ufbx_os_thread_pool *outer = ufbx_os_create_thread_pool(&outer_opts);
+		ufbxt_assert(outer);
+		uint64_t load_id = ufbx_os_thread_pool_run(outer, &ufbxt_shared_pool_load_fn, &loads, ufbxt_arraycount(loads.ok));
+		ufbx_os_thread_pool_wait(outer, load_id);
+		ufbx_os_free_thread_pool(outer);
+
+		for (size_t i = 0; i < ufbxt_arraycount(loads.ok); i++) {
+			ufbxt_assert(loads.ok[i]);
+			ufbxt_assert(loads.num_nodes[i] == loads.num_nodes[0]);
+		}
+
+		ufbx_os_free_thread_pool(pool);
+	}
+#endif
+}
+#endif
+
+#if UFBXT_IMPL && defined(UFBXT_THREADS)
+typedef struct {
+	uint32_t num_calls[8];
+	size_t num_nodes[8];
+	bool failed[8];
+} ufbxt_batch_results;
+
+static void ufbxt_batch_complete_fn(void *user, const ufbx_load_batch_item *item, size_t index, ufbx_scene *scene, const ufbx_error *error)
+{
+	ufbxt_batch_results *results = (ufbxt_batch_results*)user;
+	ufbxt_assert(item->user == (void*)(uintptr_t)index);
+	results->num_calls[index]++;
+	if (scene) {
+		ufbxt_assert(!error);
+		results->num_nodes[index] = scene->nodes.count;
+		ufbx_free_scene(scene);
+	} else {
+		ufbxt_assert(error && error->type != UFBX_ERROR_NONE);
+		results->failed[index] = true;
+	}
+}
+#endif
+
+UFBXT_TEST(load_batch)
+#if UFBXT_IMPL
+{
+#if defined(UFBXT_THREADS)
+	char paths[4][512];
+	const char *names[] = { "maya_cube", "maya_slime", "maya_human_ik" };
+	for (size_t i = 0; i < ufbxt_arraycount(names); i++) {
+		ufbxt_file_iterator iter = { names[i] };
+		ufbxt_assert(ufbxt_next_file(&iter, paths[i], sizeof(paths[i])));
+	}
+	snprintf(paths[3], sizeof(paths[3]), "%s%s", data_root, "batch_not_found.fbx");
+
+	size_t blob_size = 0;
+	void *blob = ufbxt_read_file(paths[0], &blob_size);
+	ufbxt_assert(blob);
+
+	ufbx_load_batch_item items[6] = { 0 };
+	for (size_t i = 0; i < 4; i++) {
+		items[i].path = paths[i];
+	}
+	items[4].data = blob;
+	items[4].data_size = blob_size;
+	items[5].path = paths[1];
+	for (size_t i = 0; i < ufbxt_arraycount(items); i++) {
+		items[i].user = (void*)(uintptr_t)i;
+	}
+
+	// Unlimited budget, a budget allowing only one load at a time, and no thread pool
+	size_t budgets[] = { 0, 1, 0 };
+	for (size_t run = 0; run < ufbxt_arraycount(budgets); run++) {
+		ufbxt_batch_results results = { 0 };
+
+		ufbx_load_batch_opts opts = { 0 };
+		opts.pool = run < 2 ? g_thread_pool : NULL;
+		opts.memory_budget = budgets[run];
+		opts.complete_cb.fn = &ufbxt_batch_complete_fn;
+		opts.complete_cb.user = &results;
+
+		ufbx_load_batch_result result = ufbx_load_batch(items, ufbxt_arraycount(items), &opts);
+		ufbxt_assert(result.num_loaded == 5);
+		ufbxt_assert(result.num_failed == 1);
+		ufbxt_assert(result.peak_reserved_memory > 0);
+
+		for (size_t i = 0; i < ufbxt_arraycount(items); i++) {
+			ufbxt_assert(results.num_calls[i] == 1);
+			ufbxt_assert(results.failed[i] == (i == 3));
+		}
+		ufbxt_assert(results.num_nodes[4] == results.num_nodes[0]);
+		ufbxt_assert(results.num_nodes[5] == results.num_nodes[1]);
+	}
+
+	free(blob);
+#endif
 }
 #endif
@@ -73,6 +73,191 @@ UFBXT_FILE_TEST(blender_279_sausage)
 }
 #endif
 
+UFBXT_FILE_TEST_ALT(skin_update_vertices, blender_279_sausage)
+#if UFBXT_IMPL
+{
+	ufbx_anim_stack *stack = (ufbx_anim_stack*)ufbx_find_element(scene, UFBX_ELEMENT_ANIM_STACK, scene->metadata.ascii ? "Wiggle" : "Skeleton|Wiggle");
+	ufbxt_assert(stack);
+
+	ufbx_evaluate_opts opts = { 0 };
+	opts.evaluate_skinning = true;
+
+	ufbx_error error;
+	ufbx_scene *prev = ufbx_evaluate_scene(scene, stack->anim, 5.0/24.0, &opts, &error);
+	ufbx_scene *next = ufbx_evaluate_scene(scene, stack->anim, 12.0/24.0, &opts, &error);
+	ufbxt_assert(prev && next);
+
+	ufbx_mesh *prev_mesh = prev->meshes.data[0];
+	ufbx_mesh *mesh = next->meshes.data[0];
+	ufbxt_assert(mesh->skin_deformers.count == 1);
+	ufbx_skin_deformer *skin = mesh->skin_deformers.data[0];
+	size_t num_vertices = mesh->num_vertices;
+
+	uint32_t changed[16];
+	size_t num_changed = 0;
+	ufbxt_assert(skin->clusters.count <= ufbxt_arraycount(changed));
+	for (size_t i = 0; i < skin->clusters.count; i++) {
+		ufbx_skin_cluster *prev_cluster = prev_mesh->skin_deformers.data[0]->clusters.data[i];
+		if (memcmp(&prev_cluster->geometry_to_world, &skin->clusters.data[i]->geometry_to_world, sizeof(ufbx_matrix)) != 0) {
+			changed[num_changed++] = (uint32_t)i;
+		}
+	}
+	ufbxt_assert(num_changed > 0);
+
+	ufbx_vec3 *positions = (ufbx_vec3*)malloc(num_vertices * sizeof(ufbx_vec3));
+	ufbxt_assert(positions);
+
+	for (int reverse = 0; reverse <= 1; reverse++) {
+		memcpy(positions, prev_mesh->skinned_position.values.data, num_vertices * sizeof(ufbx_vec3));
+		if (reverse) {
+			for (size_t i = 0; i < num_changed / 2; i++) {
+				uint32_t tmp = changed[i];
+				changed[i] = changed[num_changed - 1 - i];
+				changed[num_changed - 1 - i] = tmp;
+			}
+		}
+
+		ufbx_matrix *fallback = &mesh->instances.data[0]->geometry_to_world;
+		size_t num_skinned = ufbx_update_skin_vertices(skin, changed, num_changed, mesh->vertices.data, positions, num_vertices, fallback);
+		ufbxt_assert(num_skinned > 0);
+		if (!reverse) {
+			// Sorted clusters skin each vertex at most once
+			ufbxt_assert(num_skinned <= num_vertices);
+		}
+
+		for (size_t i = 0; i < num_vertices; i++) {
+			ufbxt_assert_close_vec3(err, positions[i], mesh->skinned_position.values.data[i]);
+		}
+	}
+
+	free(positions);
+	ufbx_free_scene(prev);
+	ufbx_free_scene(next);
+}
+#endif
+
+UFBXT_FILE_TEST_ALT(skin_pack_weights, blender_279_sausage)
+#if UFBXT_IMPL
+{
+	ufbx_mesh *mesh = scene->meshes.data[0];
+	ufbxt_assert(mesh->skin_deformers.count == 1);
+	ufbx_skin_deformer *skin = mesh->skin_deformers.data[0];
+	size_t num_vertices = mesh->num_vertices;
+
+	uint8_t indices8[4096], weights8[4096];
+	uint16_t indices16[4096], weights16[4096];
+	ufbxt_assert(num_vertices * 8 <= ufbxt_arraycount(indices8));
+
+	ufbx_error error;
+	bool ok = ufbx_pack_skin_weights(skin, NULL, num_vertices, indices8, weights8, NULL, &error);
+	if (!ok) ufbxt_log_error(&error);
+	ufbxt_assert(ok);
+
+	ufbx_pack_skin_weights_opts opts = { 0 };
+	opts.max_influences = 8;
+	opts.wide_indices = true;
+	opts.wide_weights = true;
+	ok = ufbx_pack_skin_weights(skin, NULL, num_vertices, indices16, weights16, &opts, &error);
+	if (!ok) ufbxt_log_error(&error);
+	ufbxt_assert(ok);
+
+	for (size_t i = 0; i < num_vertices; i++) {
+		ufbx_skin_vertex vertex = skin->vertices.data[i];
+		ufbx_real total = 0.0f;
+		for (size_t j = 0; j < vertex.num_weights && j < 4; j++) {
+			total += skin->weights.data[vertex.weight_begin + j].weight;
+		}
+
+		uint32_t sum8 = 0, sum16 = 0;
+		for (size_t j = 0; j < 4; j++) {
+			if (j < vertex.num_weights) {
+				ufbx_skin_weight weight = skin->weights.data[vertex.weight_begin + j];
+				ufbxt_assert(indices8[i * 4 + j] == weight.cluster_index);
+				ufbxt_assert_close_real_threshold(err, (ufbx_real)weights8[i * 4 + j] / 255.0f, weight.weight / total, 1.5f / 255.0f);
+			} else {
+				ufbxt_assert(indices8[i * 4 + j] == 0 && weights8[i * 4 + j] == 0);
+			}
+			sum8 += weights8[i * 4 + j];
+		}
+		for (size_t j = 0; j < 8; j++) {
+			if (j < vertex.num_weights) {
+				ufbxt_assert(indices16[i * 8 + j] == skin->weights.data[vertex.weight_begin + j].cluster_index);
+			} else {
+				ufbxt_assert(indices16[i * 8 + j] == 0 && weights16[i * 8 + j] == 0);
+			}
+			sum16 += weights16[i * 8 + j];
+		}
+		ufbxt_assert(sum8 == (vertex.num_weights > 0 ? 255u : 0u));
+		ufbxt_assert(sum16 == (vertex.num_weights > 0 ? 65535u : 0u));
+	}
+
+	// Expanded to the index space of the mesh
+	{
+		size_t num_indices = mesh->num_indices;
+		uint8_t *index_bones = (uint8_t*)malloc(num_indices * 4);
+		uint8_t *index_weights = (uint8_t*)malloc(num_indices * 4);
+		ufbxt_assert(index_bones && index_weights);
+
+		ok = ufbx_pack_skin_weights(skin, mesh->vertex_indices.data, num_indices, index_bones, index_weights, NULL, &error);
+		ufbxt_assert(ok);
+		for (size_t i = 0; i < num_indices; i++) {
+			uint32_t vertex = mesh->vertex_indices.data[i];
+			ufbxt_assert(!memcmp(index_bones + i * 4, indices8 + vertex * 4, 4));
+			ufbxt_assert(!memcmp(index_weights + i * 4, weights8 + vertex * 4, 4));
+		}
+
+		free(index_bones);
+		free(index_weights);
+	}
+
+	// Errors
+	{
+		uint32_t bad_vertex = (uint32_t)num_vertices;
+		ufbxt_assert(!ufbx_pack_skin_weights(skin, &bad_vertex, 1, indices8, weights8, NULL, &error));
+		ufbxt_assert(error.type != UFBX_ERROR_NONE);
+
+		opts.max_influences = 9;
+		ufbxt_assert(!ufbx_pack_skin_weights(skin, NULL, num_vertices, indices16, weights16, &opts, &error));
+		ufbxt_assert(error.type != UFBX_ERROR_NONE);
+	}
+
+#if defined(UFBXT_THREADS)
+	// Enough vertices to split into multiple tasks, must match the serial result
+	{
+		const size_t num_packed = 100000;
+		uint32_t *vertices = (uint32_t*)malloc(num_packed * sizeof(uint32_t));
+		uint8_t *serial = (uint8_t*)malloc(num_packed * 8);
+		uint8_t *threaded = (uint8_t*)malloc(num_packed * 8);
+		ufbxt_assert(vertices && serial && threaded);
+		for (size_t i = 0; i < num_packed; i++) {
+			vertices[i] = (uint32_t)((i * 7) % num_vertices);
+		}
+
+		ufbx_pack_skin_weights_opts thread_opts = { 0 };
+		ufbxt_assert(ufbx_pack_skin_weights(skin, vertices, num_packed, serial, serial + num_packed * 4, &thread_opts, NULL));
+
+		ufbx_os_thread_pool_opts pool_opts = { 0 };
+		pool_opts.max_threads = 4;
+		ufbx_os_thread_pool *pool = ufbx_os_create_thread_pool(&pool_opts);
+		ufbxt_assert(pool);
+		ufbx_os_init_ufbx_thread_pool(&thread_opts.thread_opts.pool, pool);
+		ufbxt_assert(ufbx_pack_skin_weights(skin, vertices, num_packed, threaded, threaded + num_packed * 4, &thread_opts, NULL));
+		ufbxt_assert(!memcmp(serial, threaded, num_packed * 8));
+
+		// Out of bounds vertex in a threaded task
+		vertices[num_packed - 1] = (uint32_t)num_vertices;
+		ufbxt_assert(!ufbx_pack_skin_weights(skin, vertices, num_packed, threaded, threaded + num_packed * 4, &thread_opts, &error));
+		ufbxt_assert(error.type != UFBX_ERROR_NONE);
+
+		ufbx_os_free_thread_pool(pool);
+		free(vertices);
+		free(serial);
+		free(threaded);
+	}
+#endif
+}
+#endif
+
 UFBXT_FILE_TEST(maya_game_sausage)
 #if UFBXT_IMPL
 {
@@ -522,6 +707,91 @@ UFBXT_FILE_TEST(maya_blend_inbetween)
 }
 #endif
 
+UFBXT_FILE_TEST_ALT(blend_shape_weights_batch, maya_blend_inbetween)
+#if UFBXT_IMPL
+{
+	ufbxt_assert(scene->meshes.count >= 1);
+	ufbx_mesh *mesh = scene->meshes.data[0];
+	ufbxt_assert(mesh->blend_deformers.count == 1);
+	ufbx_blend_deformer *blend = mesh->blend_deformers.data[0];
+	size_t num_vertices = mesh->num_vertices;
+
+	size_t num_shapes = ufbx_get_blend_shape_weights(blend, NULL, 0, NULL, 0);
+	ufbxt_assert(num_shapes > blend->channels.count);
+
+	ufbx_blend_vertex_layout *layout = ufbx_create_blend_vertex_layout(blend, NULL, NULL);
+	ufbxt_assert(layout);
+	ufbxt_assert(layout->num_shapes == num_shapes);
+	ufbxt_assert(layout->offset_begin.count == layout->vertices.count + 1);
+	ufbxt_assert(layout->offset_begin.data[layout->vertices.count] == layout->num_offsets);
+	for (size_t i = 1; i < layout->vertices.count; i++) {
+		ufbxt_assert(layout->vertices.data[i - 1] < layout->vertices.data[i]);
+	}
+
+	ufbx_real *channel_weights = (ufbx_real*)calloc(blend->channels.count, sizeof(ufbx_real));
+	ufbx_real *shape_weights = (ufbx_real*)calloc(num_shapes, sizeof(ufbx_real));
+	ufbx_real *override_weights = (ufbx_real*)calloc(num_shapes, sizeof(ufbx_real));
+	ufbx_vec3 *ref_pos = (ufbx_vec3*)calloc(num_vertices, sizeof(ufbx_vec3));
+	ufbx_vec3 *batch_pos = (ufbx_vec3*)calloc(num_vertices, sizeof(ufbx_vec3));
+	ufbx_vec3 *layout_pos = (ufbx_vec3*)calloc(num_vertices, sizeof(ufbx_vec3));
+	ufbxt_assert(channel_weights && shape_weights && override_weights && ref_pos && batch_pos && layout_pos);
+
+	for (int frame = 0; frame <= 120; frame += 5) {
+		double time = (double)frame / 24.0;
+		ufbxt_hintf("frame = %d", frame);
+
+		ufbx_scene *state = ufbx_evaluate_scene(scene, scene->anim, time, NULL, NULL);
+		ufbxt_assert(state);
+		ufbx_blend_deformer *eval_blend = state->blend_deformers.data[blend->typed_id];
+
+		// Evaluated weights should match the keyframe effective weights
+		ufbxt_assert(ufbx_get_blend_shape_weights(eval_blend, NULL, 0, shape_weights, num_shapes) == num_shapes);
+		size_t shape_ix = 0;
+		for (size_t chan_ix = 0; chan_ix < eval_blend->channels.count; chan_ix++) {
+			ufbx_blend_channel *chan = eval_blend->channels.data[chan_ix];
+			channel_weights[chan_ix] = chan->weight;
+			for (size_t key_ix = 0; key_ix < chan->keyframes.count; key_ix++) {
+				ufbxt_assert(shape_weights[shape_ix++] == chan->keyframes.data[key_ix].effective_weight);
+			}
+		}
+
+		// Overriding the weights of the unevaluated scene should produce the same result
+		ufbxt_assert(ufbx_get_blend_shape_weights(blend, channel_weights, blend->channels.count, override_weights, num_shapes) == num_shapes);
+		for (size_t i = 0; i < num_shapes; i++) {
+			ufbxt_assert(override_weights[i] == shape_weights[i]);
+		}
+
+		for (size_t i = 0; i < num_vertices; i++) {
+			ref_pos[i] = batch_pos[i] = layout_pos[i] = mesh->vertices.data[i];
+		}
+
+		ufbx_add_blend_vertex_offsets(eval_blend, ref_pos, num_vertices, 1.0f);
+		ufbx_add_weighted_blend_vertex_offsets(blend, shape_weights, num_shapes, batch_pos, num_vertices);
+		ufbx_add_blend_vertex_layout_offsets(layout, shape_weights, num_shapes, layout_pos, num_vertices);
+
+		for (size_t i = 0; i < num_vertices; i++) {
+			ufbxt_assert_close_vec3(err, ref_pos[i], batch_pos[i]);
+			ufbxt_assert(!memcmp(&batch_pos[i], &layout_pos[i], sizeof(ufbx_vec3)));
+		}
+
+		ufbx_free_scene(state);
+	}
+
+	// Truncated outputs
+	ufbxt_assert(ufbx_get_blend_shape_weights(blend, NULL, 0, shape_weights, 1) == num_shapes);
+	ufbx_add_blend_vertex_layout_offsets(layout, shape_weights, num_shapes, layout_pos, 1);
+
+	free(channel_weights);
+	free(shape_weights);
+	free(override_weights);
+	free(ref_pos);
+	free(batch_pos);
+	free(layout_pos);
+
+	ufbx_free_blend_vertex_layout(layout);
+}
+#endif
+
 UFBXT_FILE_TEST(synthetic_blend_shape_order)
 #if UFBXT_IMPL
 {
@@ -69,6 +69,245 @@ UFBXT_FILE_TEST(maya_planar_ngon)
 }
 #endif
 
+#if UFBXT_IMPL
+typedef struct {
+	uint32_t lo, hi, index;
+} ufbxt_topo_key;
+
+static int ufbxt_cmp_topo_key(const void *va, const void *vb)
+{
+	const ufbxt_topo_key *a = (const ufbxt_topo_key*)va, *b = (const ufbxt_topo_key*)vb;
+	if (a->lo != b->lo) return a->lo < b->lo ? -1 : +1;
+	if (a->hi != b->hi) return a->hi < b->hi ? -1 : +1;
+	return 0;
+}
+
+// Check `topo` against pairing the edges by sorting their vertices
+static void ufbxt_check_topology_reference(const ufbx_mesh *mesh, const ufbx_topo_edge *topo)
+{
+	ufbxt_topo_key *keys = (ufbxt_topo_key*)calloc(mesh->num_indices + 1, sizeof(ufbxt_topo_key));
+	ufbxt_assert(keys);
+
+	for (size_t fi = 0; fi < mesh->num_faces; fi++) {
+		ufbx_face face = mesh->faces.data[fi];
+		for (uint32_t i = 0; i < face.num_indices; i++) {
+			uint32_t ix = face.index_begin + i;
+			uint32_t a = mesh->vertex_indices.data[ix];
+			uint32_t b = mesh->vertex_indices.data[face.index_begin + (i + 1) % face.num_indices];
+			keys[ix].lo = a < b ? a : b;
+			keys[ix].hi = a < b ? b : a;
+			keys[ix].index = ix;
+
+			ufbxt_assert(topo[ix].index == ix);
+			ufbxt_assert(topo[ix].face == fi);
+			ufbxt_assert(topo[ix].next == face.index_begin + (i + 1) % face.num_indices);
+			ufbxt_assert(topo[ix].prev == face.index_begin + (i + face.num_indices - 1) % face.num_indices);
+		}
+	}
+
+	for (size_t i = 0; i < mesh->num_indices; i++) {
+		uint32_t edge = topo[i].edge;
+		if (edge == UFBX_NO_INDEX) continue;
+		ufbxt_assert(edge < mesh->num_edges);
+		uint32_t a = mesh->vertex_indices.data[mesh->edges.data[edge].a];
+		uint32_t b = mesh->vertex_indices.data[mesh->edges.data[edge].b];
+		ufbxt_assert(keys[i].lo == (a < b ? a : b));
+		ufbxt_assert(keys[i].hi == (a < b ? b : a));
+	}
+
+	qsort(keys, mesh->num_indices, sizeof(ufbxt_topo_key), &ufbxt_cmp_topo_key);
+
+	for (size_t i0 = 0; i0 < mesh->num_indices; ) {
+		size_t i1 = i0 + 1;
+		while (i1 < mesh->num_indices && ufbxt_cmp_topo_key(&keys[i0], &keys[i1]) == 0) i1++;
+
+		for (size_t i = i0; i < i1; i++) {
+			const ufbx_topo_edge *te = &topo[keys[i].index];
+			if (i1 - i0 == 2) {
+				ufbxt_assert(te->twin == keys[i0 + i1 - 1 - i].index);
+				ufbxt_assert(te->flags == 0);
+			} else if (i1 - i0 > 2) {
+				ufbxt_assert(te->twin == UFBX_NO_INDEX);
+				ufbxt_assert((te->flags & UFBX_TOPO_NON_MANIFOLD) != 0);
+			} else {
+				ufbxt_assert(te->twin == UFBX_NO_INDEX);
+				ufbxt_assert(te->flags == 0);
+			}
+		}
+
+		i0 = i1;
+	}
+
+	free(keys);
+}
+
+static void ufbxt_check_stored_topology(const ufbx_mesh *mesh)
+{
+	ufbxt_assert(mesh->topology.count == mesh->num_indices);
+	ufbxt_check_topology_reference(mesh, mesh->topology.data);
+
+	// Without the stored topology `ufbx_compute_topology()` uses the original sort
+	// based implementation, which should give the same result
+	ufbx_mesh copy = *mesh;
+	copy.topology.data = NULL;
+	copy.topology.count = 0;
+
+	ufbx_topo_edge *topo = (ufbx_topo_edge*)calloc(mesh->num_indices + 1, sizeof(ufbx_topo_edge));
+	ufbxt_assert(topo);
+	ufbx_compute_topology(&copy, topo, mesh->num_indices);
+	for (size_t i = 0; i < mesh->num_indices; i++) {
+		const ufbx_topo_edge *a = &topo[i], *b = &mesh->topology.data[i];
+		ufbxt_assert(a->index == b->index && a->next == b->next && a->prev == b->prev);
+		ufbxt_assert(a->twin == b->twin && a->face == b->face && a->edge == b->edge && a->flags == b->flags);
+	}
+	free(topo);
+}
+
+static ufbx_load_opts ufbxt_compute_topology_opts()
+{
+	ufbx_load_opts opts = { 0 };
+	opts.compute_topology = true;
+#if defined(UFBXT_THREADS)
+	ufbx_os_init_ufbx_thread_pool(&opts.thread_opts.pool, g_thread_pool);
+#endif
+	return opts;
+}
+
+static ufbx_load_opts ufbxt_compute_topology_reverse_winding_opts()
+{
+	ufbx_load_opts opts = ufbxt_compute_topology_opts();
+	opts.reverse_winding = true;
+	return opts;
+}
+
+static ufbx_load_opts ufbxt_compute_topology_normals_opts()
+{
+	ufbx_load_opts opts = ufbxt_compute_topology_opts();
+	opts.generate_missing_normals = true;
+	return opts;
+}
+#endif
+
+UFBXT_FILE_TEST_OPTS_ALT(topology_stored, maya_slime, ufbxt_compute_topology_opts)
+#if UFBXT_IMPL
+{
+	for (size_t i = 0; i < scene->meshes.count; i++) {
+		ufbxt_check_stored_topology(scene->meshes.data[i]);
+	}
+}
+#endif
+
+UFBXT_FILE_TEST_OPTS_ALT(topology_stored_nonmanifold, blender_293x_nonmanifold_subsurf, ufbxt_compute_topology_opts)
+#if UFBXT_IMPL
+{
+	size_t num_nonmanifold = 0;
+	for (size_t i = 0; i < scene->meshes.count; i++) {
+		ufbx_mesh *mesh = scene->meshes.data[i];
+		ufbxt_check_stored_topology(mesh);
+		for (size_t j = 0; j < mesh->topology.count; j++) {
+			if (mesh->topology.data[j].flags & UFBX_TOPO_NON_MANIFOLD) num_nonmanifold++;
+		}
+	}
+	ufbxt_assert(num_nonmanifold > 0);
+}
+#endif
+
+UFBXT_FILE_TEST_OPTS_ALT(topology_stored_reverse_winding, maya_slime, ufbxt_compute_topology_reverse_winding_opts)
+#if UFBXT_IMPL
+{
+	for (size_t i = 0; i < scene->meshes.count; i++) {
+		ufbx_mesh *mesh = scene->meshes.data[i];
+		ufbxt_assert(mesh->reversed_winding);
+		ufbxt_check_stored_topology(mesh);
+	}
+}
+#endif
+
+UFBXT_FILE_TEST_OPTS_ALT(topology_stored_normals, synthetic_missing_normals, ufbxt_compute_topology_normals_opts)
+#if UFBXT_IMPL
+{
+	ufbx_node *node = ufbx_find_node(scene, "pCube1");
+	ufbxt_assert(node && node->mesh);
+	ufbx_mesh *mesh = node->mesh;
+	ufbxt_assert(mesh->generated_normals);
+	ufbxt_check_stored_topology(mesh);
+
+	for (size_t face_ix = 0; face_ix < mesh->faces.count; face_ix++) {
+		ufbx_face face = mesh->faces.data[face_ix];
+		ufbx_vec3 normal = ufbxt_normalize(ufbx_get_weighted_face_normal(&mesh->vertex_position, face));
+		for (size_t i = 0; i < face.num_indices; i++) {
+			ufbx_vec3 mesh_normal = ufbx_get_vertex_vec3(&mesh->vertex_normal, face.index_begin + i);
+			ufbxt_assert_close_vec3(err, normal, mesh_normal);
+		}
+	}
+}
+#endif
+
+UFBXT_FILE_TEST_OPTS_ALT(topology_stored_subdivide, maya_subsurf_cube, ufbxt_compute_topology_opts)
+#if UFBXT_IMPL
+{
+	ufbx_node *node = ufbx_find_node(scene, "pCube1");
+	ufbxt_assert(node && node->mesh);
+	ufbx_mesh *mesh = node->mesh;
+	ufbxt_check_stored_topology(mesh);
+
+	ufbx_mesh copy = *mesh;
+	copy.topology.data = NULL;
+	copy.topology.count = 0;
+
+	ufbx_mesh *sub_mesh = ufbx_subdivide_mesh(mesh, 2, NULL, NULL);
+	ufbx_mesh *ref_mesh = ufbx_subdivide_mesh(&copy, 2, NULL, NULL);
+	ufbxt_assert(sub_mesh && ref_mesh);
+
+	// Stored topology is kept in the subdivided mesh
+	ufbxt_check_stored_topology(sub_mesh);
+	ufbxt_assert(ref_mesh->topology.count == 0);
+
+	ufbxt_assert(sub_mesh->num_indices == ref_mesh->num_indices);
+	for (size_t i = 0; i < sub_mesh->num_indices; i++) {
+		ufbxt_assert_close_vec3(err, ufbx_get_vertex_vec3(&sub_mesh->vertex_position, i), ufbx_get_vertex_vec3(&ref_mesh->vertex_position, i));
+		ufbxt_assert_close_vec3(err, ufbx_get_vertex_vec3(&sub_mesh->vertex_normal, i), ufbx_get_vertex_vec3(&ref_mesh->vertex_normal, i));
+	}
+
+	ufbx_free_mesh(sub_mesh);
+	ufbx_free_mesh(ref_mesh);
+}
+#endif
+
+UFBXT_FILE_TEST_ALT(topology_overlapping_faces, maya_subsurf_cube)
+#if UFBXT_IMPL
+{
+	ufbx_node *node = ufbx_find_node(scene, "pCube1");
+	ufbxt_assert(node && node->mesh);
+	ufbx_mesh *mesh = node->mesh;
+	ufbxt_assert(mesh->faces.count >= 2);
+	ufbxt_assert(mesh->faces.data[0].num_indices == mesh->faces.data[1].num_indices);
+
+	// Faces cover `num_indices` in total but leave the indices of the second face
+	// uncovered, the radix sorted topology must not use them as keys.
+	ufbx_face *faces = (ufbx_face*)calloc(mesh->faces.count, sizeof(ufbx_face));
+	ufbxt_assert(faces);
+	memcpy(faces, mesh->faces.data, mesh->faces.count * sizeof(ufbx_face));
+	faces[1] = faces[0];
+
+	ufbx_mesh copy = *mesh;
+	copy.faces.data = faces;
+	copy.topology.data = NULL;
+	copy.topology.count = 0;
+
+	// Subdivision may reject the mesh but must not read or write out of bounds
+	ufbx_error error;
+	ufbx_mesh *sub_mesh = ufbx_subdivide_mesh(&copy, 1, NULL, &error);
+	if (sub_mesh) {
+		ufbx_free_mesh(sub_mesh);
+	} else {
+		ufbxt_assert(error.type != UFBX_ERROR_NONE);
+	}
+
+	free(faces);
+}
+#endif
+
 UFBXT_FILE_TEST(maya_subsurf_cube)
 #if UFBXT_IMPL
 {
@@ -336,6 +575,534 @@ UFBXT_FILE_TEST_ALT(generate_indices_multi_stream, blender_293_half_smooth_cube_
 }
 #endif
 
+#if UFBXT_IMPL
+typedef struct {
+	uint32_t v[3];
+} ufbxt_index_triangle;
+
+static int ufbxt_cmp_index_triangle(const void *va, const void *vb)
+{
+	return memcmp(va, vb, sizeof(ufbxt_index_triangle));
+}
+
+// Triangles rotated to start from the smallest index and sorted, winding is preserved
+static ufbxt_index_triangle *ufbxt_sorted_triangles(const uint32_t *indices, size_t num_indices, const uint32_t *remap)
+{
+	size_t num_triangles = num_indices / 3;
+	ufbxt_index_triangle *tris = (ufbxt_index_triangle*)malloc((num_triangles + 1) * sizeof(ufbxt_index_triangle));
+	ufbxt_assert(tris);
+	for (size_t i = 0; i < num_triangles; i++) {
+		uint32_t v[3];
+		for (size_t j = 0; j < 3; j++) {
+			v[j] = remap ? remap[indices[i * 3 + j]] : indices[i * 3 + j];
+		}
+		size_t first = v[0] < v[1] ? (v[0] < v[2] ? 0 : 2) : (v[1] < v[2] ? 1 : 2);
+		for (size_t j = 0; j < 3; j++) {
+			tris[i].v[j] = v[(first + j) % 3];
+		}
+	}
+	qsort(tris, num_triangles, sizeof(ufbxt_index_triangle), &ufbxt_cmp_index_triangle);
+	return tris;
+}
+
+static size_t ufbxt_count_cache_misses(const uint32_t *indices, size_t num_indices, size_t num_vertices, size_t cache_size)
+{
+	uint32_t *cache_time = (uint32_t*)calloc(num_vertices, sizeof(uint32_t));
+	ufbxt_assert(cache_time);
+	uint32_t time = (uint32_t)cache_size + 1;
+	size_t misses = 0;
+	for (size_t i = 0; i < num_indices; i++) {
+		uint32_t v = indices[i];
+		if (time - cache_time[v] > cache_size) {
+			cache_time[v] = time++;
+			misses++;
+		}
+	}
+	free(cache_time);
+	return misses;
+}
+
+// Returns the relative number of cache misses after optimization
+static double ufbxt_check_optimize_indices(ufbx_mesh *mesh, bool optimize_overdraw)
+{
+	size_t num_indices = mesh->num_triangles * 3;
+	ufbx_vec3 *positions = (ufbx_vec3*)malloc(num_indices * sizeof(ufbx_vec3));
+	ufbx_vec3 *normals = (ufbx_vec3*)malloc(num_indices * sizeof(ufbx_vec3));
+	uint32_t *indices = (uint32_t*)malloc(num_indices * sizeof(uint32_t));
+	uint32_t *ref_indices = (uint32_t*)malloc(num_indices * sizeof(uint32_t));
+	uint32_t *ids = (uint32_t*)malloc(num_indices * sizeof(uint32_t));
+	uint32_t *part_offsets = (uint32_t*)malloc(mesh->material_parts.count * sizeof(uint32_t));
+	uint32_t *tri = (uint32_t*)malloc(mesh->max_face_triangles * 3 * sizeof(uint32_t));
+	ufbxt_assert(positions && normals && indices && ref_indices && ids && part_offsets && tri);
+
+	// Triangulate each material part in order
+	size_t num_part_offsets = 0, num_written = 0;
+	for (size_t part_ix = 0; part_ix < mesh->material_parts.count; part_ix++) {
+		ufbx_mesh_part *part = &mesh->material_parts.data[part_ix];
+		if (part_ix > 0) {
+			part_offsets[num_part_offsets++] = (uint32_t)num_written;
+		}
+		for (size_t face_ix = 0; face_ix < part->face_indices.count; face_ix++) {
+			ufbx_face face = mesh->faces.data[part->face_indices.data[face_ix]];
+			size_t num_tris = ufbx_triangulate_face(tri, mesh->max_face_triangles * 3, mesh, face);
+			for (size_t i = 0; i < num_tris * 3; i++) {
+				positions[num_written] = ufbx_get_vertex_vec3(&mesh->vertex_position, tri[i]);
+				normals[num_written] = mesh->vertex_normal.exists ? ufbx_get_vertex_vec3(&mesh->vertex_normal, tri[i]) : ufbx_zero_vec3;
+				num_written++;
+			}
+		}
+	}
+	ufbxt_assert(num_written == num_indices);
+
+	ufbx_vertex_stream streams[] = {
+		{ positions, num_indices, sizeof(ufbx_vec3) },
+		{ normals, num_indices, sizeof(ufbx_vec3) },
+		{ ids, num_indices, sizeof(uint32_t) },
+	};
+	size_t num_vertices = ufbx_generate_indices(streams, 2, indices, num_indices, NULL, NULL);
+	ufbxt_assert(num_vertices > 0);
+	for (size_t i = 0; i < num_vertices; i++) {
+		ids[i] = (uint32_t)i;
+	}
+	memcpy(ref_indices, indices, num_indices * sizeof(uint32_t));
+	ufbx_vec3 *ref_positions = (ufbx_vec3*)malloc(num_vertices * sizeof(ufbx_vec3));
+	ufbxt_assert(ref_positions);
+	memcpy(ref_positions, positions, num_vertices * sizeof(ufbx_vec3));
+
+	ufbx_optimize_indices_opts opts = { 0 };
+	opts.part_offsets.data = part_offsets;
+	opts.part_offsets.count = num_part_offsets;
+	opts.optimize_overdraw = optimize_overdraw;
+	opts.position_stream = 0;
+	opts.reorder_vertices = true;
+#if defined(UFBXT_THREADS)
+	ufbx_os_init_ufbx_thread_pool(&opts.thread_opts.pool, g_thread_pool);
+#endif
+
+	ufbx_error error;
+	bool ok = ufbx_optimize_indices(streams, 3, indices, num_indices, num_vertices, &opts, &error);
+	if (!ok) ufbxt_log_error(&error);
+	ufbxt_assert(ok);
+
+	// Vertices are renumbered in order of first use
+	uint32_t max_index = 0;
+	for (size_t i = 0; i < num_indices; i++) {
+		ufbxt_assert(indices[i] <= max_index);
+		if (indices[i] == max_index) max_index++;
+	}
+
+	// Vertex data has moved along with the indices
+	for (size_t i = 0; i < num_vertices; i++) {
+		ufbxt_assert(ids[i] < num_vertices);
+		ufbxt_assert(!memcmp(&positions[i], &ref_positions[ids[i]], sizeof(ufbx_vec3)));
+	}
+
+	// Each part contains the same triangles with the same winding
+	for (size_t part_ix = 0; part_ix <= num_part_offsets; part_ix++) {
+		size_t begin = part_ix > 0 ? part_offsets[part_ix - 1] : 0;
+		size_t end = part_ix < num_part_offsets ? part_offsets[part_ix] : num_indices;
+		ufbxt_index_triangle *ref_tris = ufbxt_sorted_triangles(ref_indices + begin, end - begin, NULL);
+		ufbxt_index_triangle *tris = ufbxt_sorted_triangles(indices + begin, end - begin, ids);
+		ufbxt_assert(!memcmp(ref_tris, tris, (end - begin) / 3 * sizeof(ufbxt_index_triangle)));
+		free(ref_tris);
+		free(tris);
+	}
+
+	size_t ref_misses = ufbxt_count_cache_misses(ref_indices, num_indices, num_vertices, 16);
+	size_t misses = ufbxt_count_cache_misses(indices, num_indices, num_vertices, 16);
+	ufbxt_logf(".. ACMR %.3f -> %.3f", (double)ref_misses / (double)(num_indices / 3), (double)misses / (double)(num_indices / 3));
+	ufbxt_assert(misses <= ref_misses);
+
+	free(positions);
+	free(normals);
+	free(indices);
+	free(ref_indices);
+	free(ids);
+	free(part_offsets);
+	free(tri);
+	free(ref_positions);
+
+	return (double)misses / (double)ref_misses;
+}
+#endif
+
+UFBXT_FILE_TEST_ALT(optimize_indices, maya_slime)
+#if UFBXT_IMPL
+{
+	for (size_t i = 0; i < scene->meshes.count; i++) {
+		ufbx_mesh *mesh = scene->meshes.data[i];
+		if (mesh->num_triangles < 1000) continue;
+		ufbxt_assert(ufbxt_check_optimize_indices(mesh, false) < 0.8);
+		// Overdraw optimization trades some cache efficiency
+		ufbxt_assert(ufbxt_check_optimize_indices(mesh, true) < 0.9);
+	}
+}
+#endif
+
+UFBXT_FILE_TEST_ALT(optimize_indices_parts, max2009_blob)
+#if UFBXT_IMPL
+{
+	for (size_t i = 0; i < scene->meshes.count; i++) {
+		ufbx_mesh *mesh = scene->meshes.data[i];
+		if (mesh->num_triangles < 100) continue;
+		ufbxt_assert(mesh->material_parts.count > 1);
+		ufbxt_check_optimize_indices(mesh, false);
+		ufbxt_check_optimize_indices(mesh, true);
+	}
+}
+#endif
+
+UFBXT_TEST(optimize_indices_errors)
+#if UFBXT_IMPL
+{
+	uint32_t indices[] = { 0, 1, 2, 2, 1, 3 };
+	ufbx_vec3 positions[4] = { { 0.0f } };
+	ufbx_vertex_stream stream = { positions, 4, sizeof(ufbx_vec3) };
+	ufbx_error error;
+
+	ufbxt_assert(!ufbx_optimize_indices(&stream, 1, indices, 5, 4, NULL, &error));
+	ufbxt_assert(error.type != UFBX_ERROR_NONE);
+
+	ufbxt_assert(!ufbx_optimize_indices(&stream, 1, indices, 6, 3, NULL, &error));
+	ufbxt_assert(error.type != UFBX_ERROR_NONE);
+
+	ufbxt_assert(!ufbx_optimize_indices(&stream, 1, indices, 6, 5, NULL, &error));
+	ufbxt_assert(error.type == UFBX_ERROR_TRUNCATED_VERTEX_STREAM);
+
+	uint32_t bad_offset = 4;
+	ufbx_optimize_indices_opts opts = { 0 };
+	opts.part_offsets.data = &bad_offset;
+	opts.part_offsets.count = 1;
+	ufbxt_assert(!ufbx_optimize_indices(&stream, 1, indices, 6, 4, &opts, &error));
+	ufbxt_assert(error.type != UFBX_ERROR_NONE);
+
+	opts.part_offsets.count = 0;
+	opts.optimize_overdraw = true;
+	opts.position_stream = 1;
+	ufbxt_assert(!ufbx_optimize_indices(&stream, 1, indices, 6, 4, &opts, &error));
+	ufbxt_assert(error.type != UFBX_ERROR_NONE);
+
+	opts.position_stream = 0;
+	ufbxt_assert(ufbx_optimize_indices(&stream, 1, indices, 6, 4, &opts, &error));
+	ufbxt_assert(error.type == UFBX_ERROR_NONE);
+	ufbxt_assert(ufbx_optimize_indices(NULL, 0, indices, 0, 0, NULL, &error));
+}
+#endif
+
+#if UFBXT_IMPL
+static float ufbxt_f16_to_f32(uint16_t half)
+{
+	uint32_t exponent = (half >> 10) & 0x1f, mantissa = half & 0x3ff;
+	float value;
+	if (exponent == 0) {
+		value = (float)mantissa * (1.0f / 16777216.0f);
+	} else {
+		value = ldexpf((float)(mantissa | 0x400), (int)exponent - 25);
+	}
+	return (half & 0x8000) ? -value : value;
+}
+
+static ufbx_vec3 ufbxt_decode_oct_snorm16(const int16_t *src)
+{
+	ufbx_vec3 v = { (ufbx_real)src[0] / 32767.0f, (ufbx_real)src[1] / 32767.0f, 0.0f };
+	v.z = 1.0f - fabs(v.x) - fabs(v.y);
+	if (v.z < 0.0f) {
+		ufbx_real x = v.x, y = v.y;
+		v.x = (1.0f - fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+		v.y = (1.0f - fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+	}
+	return ufbxt_normalize(v);
+}
+
+static void ufbxt_check_mesh_buffers(ufbx_mesh *mesh, bool force_32bit_indices)
+{
+	// float3 position, oct normal, half2 uv, unorm8x4 color
+	ufbx_vertex_attrib_desc attribs[] = {
+		{ UFBX_VERTEX_ATTRIB_POSITION, UFBX_VERTEX_FORMAT_FLOAT32, 0, 0, 0 },
+		{ UFBX_VERTEX_ATTRIB_NORMAL, UFBX_VERTEX_FORMAT_OCT_SNORM16, 0, 0, 12 },
+		{ UFBX_VERTEX_ATTRIB_UV, UFBX_VERTEX_FORMAT_FLOAT16, 0, 0, 16 },
+		{ UFBX_VERTEX_ATTRIB_COLOR, UFBX_VERTEX_FORMAT_UNORM8, 0, 0, 20 },
+	};
+
+	ufbx_mesh_buffers_opts opts = { 0 };
+	opts.attribs.data = attribs;
+	opts.attribs.count = ufbxt_arraycount(attribs);
+	opts.force_32bit_indices = force_32bit_indices;
+#if defined(UFBXT_THREADS)
+	ufbx_os_init_ufbx_thread_pool(&opts.thread_opts.pool, g_thread_pool);
+#endif
+
+	ufbx_error error;
+	ufbx_mesh_buffers *buffers = ufbx_create_mesh_buffers(mesh, &opts, &error);
+	if (!buffers) ufbxt_log_error(&error);
+	ufbxt_assert(buffers);
+	ufbxt_assert(buffers->vertex_stride == 24);
+	ufbxt_assert(buffers->parts.count == mesh->material_parts.count);
+
+	// Large polygons may be split differently from `ufbx_triangulate_face()`, compare against
+	// `ufbx_triangulate_mesh()` instead and find the first triangle of each face
+	uint32_t *tri_indices = (uint32_t*)malloc((mesh->num_triangles * 3 + 1) * sizeof(uint32_t));
+	size_t *face_tri_offset = (size_t*)malloc((mesh->num_faces + 1) * sizeof(size_t));
+	ufbxt_assert(tri_indices && face_tri_offset);
+	ufbxt_assert(ufbx_triangulate_mesh(mesh, tri_indices, mesh->num_triangles * 3, NULL, &error));
+
+	size_t tri_offset = 0;
+	for (size_t i = 0; i < mesh->num_faces; i++) {
+		face_tri_offset[i] = tri_offset;
+		uint32_t num_face_indices = mesh->faces.data[i].num_indices;
+		if (num_face_indices >= 3) tri_offset += (num_face_indices - 2) * 3;
+	}
+
+	size_t total_indices = 0;
+	for (size_t part_ix = 0; part_ix < buffers->parts.count; part_ix++) {
+		ufbx_mesh_buffer_part *part = &buffers->parts.data[part_ix];
+		ufbx_mesh_part *src = &mesh->material_parts.data[part_ix];
+		ufbxt_assert(part->part_index == part_ix);
+		ufbxt_assert(part->num_indices == src->num_triangles * 3);
+		ufbxt_assert(part->num_vertices <= part->num_indices);
+		ufbxt_assert(part->vertex_data.size == part->num_vertices * buffers->vertex_stride);
+		ufbxt_assert(part->index_size == (force_32bit_indices || part->num_vertices > UINT16_MAX ? 4u : 2u));
+		ufbxt_assert(part->index_data.size == part->num_indices * part->index_size);
+		total_indices += part->num_indices;
+
+		const char *vertex_data = (const char*)part->vertex_data.data;
+		size_t corner_ix = 0;
+		for (size_t face_ix = 0; face_ix < src->face_indices.count; face_ix++) {
+			uint32_t src_face_ix = src->face_indices.data[face_ix];
+			ufbx_face face = mesh->faces.data[src_face_ix];
+			const uint32_t *tri = tri_indices + face_tri_offset[src_face_ix];
+			size_t num_tris = face.num_indices >= 3 ? face.num_indices - 2 : 0;
+			for (size_t i = 0; i < num_tris * 3; i++) {
+				uint32_t index = tri[i];
+				size_t vertex_ix;
+				if (part->index_size == 2) {
+					vertex_ix = ((const uint16_t*)part->index_data.data)[corner_ix];
+				} else {
+					vertex_ix = ((const uint32_t*)part->index_data.data)[corner_ix];
+				}
+				corner_ix++;
+				ufbxt_assert(vertex_ix < part->num_vertices);
+				const char *vertex = vertex_data + vertex_ix * buffers->vertex_stride;
+
+				float pos[3];
+				memcpy(pos, vertex, sizeof(pos));
+				ufbx_vec3 ref_pos = ufbx_get_vertex_vec3(&mesh->vertex_position, index);
+				ufbxt_assert(pos[0] == (float)ref_pos.x && pos[1] == (float)ref_pos.y && pos[2] == (float)ref_pos.z);
+
+				if (mesh->vertex_normal.exists) {
+					int16_t oct[2];
+					memcpy(oct, vertex + 12, sizeof(oct));
+					ufbx_vec3 normal = ufbxt_decode_oct_snorm16(oct);
+					ufbx_vec3 ref_normal = ufbxt_normalize(ufbx_get_vertex_vec3(&mesh->vertex_normal, index));
+					ufbxt_assert(fabs(normal.x - ref_normal.x) <= 1e-3 && fabs(normal.y - ref_normal.y) <= 1e-3 && fabs(normal.z - ref_normal.z) <= 1e-3);
+				}
+
+				uint16_t uv[2];
+				memcpy(uv, vertex + 16, sizeof(uv));
+				if (mesh->vertex_uv.exists) {
+					ufbx_vec2 ref_uv = ufbx_get_vertex_vec2(&mesh->vertex_uv, index);
+					ufbxt_assert(fabs(ufbxt_f16_to_f32(uv[0]) - ref_uv.x) <= fmax(fabs(ref_uv.x), 1.0) * 1e-3);
+					ufbxt_assert(fabs(ufbxt_f16_to_f32(uv[1]) - ref_uv.y) <= fmax(fabs(ref_uv.y), 1.0) * 1e-3);
+				} else {
+					ufbxt_assert(uv[0] == 0 && uv[1] == 0);
+				}
+
+				uint8_t color[4];
+				memcpy(color, vertex + 20, sizeof(color));
+				if (mesh->vertex_color.exists) {
+					ufbx_vec4 ref_color = ufbx_get_vertex_vec4(&mesh->vertex_color, index);
+					ufbx_real ref[4] = { ref_color.x, ref_color.y, ref_color.z, ref_color.w };
+					for (size_t c = 0; c < 4; c++) {
+						ufbx_real r = ref[c] < 0.0f ? 0.0f : ref[c] > 1.0f ? 1.0f : ref[c];
+						ufbxt_assert(fabs((double)color[c] / 255.0 - r) <= 0.5 / 255.0 + 1e-6);
+					}
+				} else {
+					ufbxt_assert(!color[0] && !color[1] && !color[2] && !color[3]);
+				}
+			}
+		}
+		ufbxt_assert(corner_ix == part->num_indices);
+
+		// All vertices are unique and used, check uniqueness with an open addressing hash set
+		size_t stride = buffers->vertex_stride;
+		size_t set_size = 16;
+		while (set_size < part->num_vertices * 2) set_size *= 2;
+		uint32_t *set = (uint32_t*)malloc(set_size * sizeof(uint32_t));
+		bool *used = (bool*)calloc(part->num_vertices + 1, sizeof(bool));
+		ufbxt_assert(set && used);
+		memset(set, 0xff, set_size * sizeof(uint32_t));
+
+		for (size_t i = 0; i < part->num_vertices; i++) {
+			const char *vertex = vertex_data + i * stride;
+			uint32_t hash = 2166136261u;
+			for (size_t j = 0; j < stride; j++) {
+				hash = (hash ^ (uint8_t)vertex[j]) * 16777619u;
+			}
+			size_t slot = hash & (set_size - 1);
+			while (set[slot] != UINT32_MAX) {
+				ufbxt_assert(memcmp(vertex_data + set[slot] * stride, vertex, stride) != 0);
+				slot = (slot + 1) & (set_size - 1);
+			}
+			set[slot] = (uint32_t)i;
+		}
+
+		ufbxt_assert((uintptr_t)part->index_data.data % part->index_size == 0);
+		for (size_t i = 0; i < part->num_indices; i++) {
+			size_t vertex_ix = part->index_size == 2
+				? ((const uint16_t*)part->index_data.data)[i]
+				: ((const uint32_t*)part->index_data.data)[i];
+			used[vertex_ix] = true;
+		}
+		for (size_t i = 0; i < part->num_vertices; i++) {
+			ufbxt_assert(used[i]);
+		}
+
+		free(set);
+		free(used);
+	}
+	ufbxt_assert(total_indices == mesh->num_triangles * 3);
+
+	ufbx_retain_mesh_buffers(buffers);
+	ufbx_free_mesh_buffers(buffers);
+	ufbx_free_mesh_buffers(buffers);
+	free(tri_indices);
+	free(face_tri_offset);
+}
+#endif
+
+UFBXT_FILE_TEST_ALT(mesh_buffers, maya_slime)
+#if UFBXT_IMPL
+{
+	for (size_t i = 0; i < scene->meshes.count; i++) {
+		ufbx_mesh *mesh = scene->meshes.data[i];
+		ufbxt_check_mesh_buffers(mesh, false);
+		ufbxt_check_mesh_buffers(mesh, true);
+	}
+}
+#endif
+
+UFBXT_FILE_TEST_ALT(mesh_buffers_parts, max2009_blob)
+#if UFBXT_IMPL
+{
+	for (size_t i = 0; i < scene->meshes.count; i++) {
+		ufbx_mesh *mesh = scene->meshes.data[i];
+		ufbxt_check_mesh_buffers(mesh, false);
+	}
+}
+#endif
+
+UFBXT_TEST(mesh_buffers_large_ngon)
+#if UFBXT_IMPL
+{
+	// Star polygon with enough corners to be split into monotone pieces in all builds
+	char obj[4096];
+	size_t obj_len = 0;
+	uint32_t num_corners = 64;
+	for (uint32_t i = 0; i < num_corners; i++) {
+		double angle = (double)i / (double)num_corners * 3.141592653589793 * 2.0;
+		double radius = i % 2 == 0 ? 1.0 : 0.4 + 0.1 * (double)(i % 5);
+		obj_len += (size_t)snprintf(obj + obj_len, sizeof(obj) - obj_len, "v %.6f %.6f 0\n", radius * cos(angle), radius * sin(angle));
+	}
+	obj_len += (size_t)snprintf(obj + obj_len, sizeof(obj) - obj_len, "f");
+	for (uint32_t i = 0; i < num_corners; i++) {
+		obj_len += (size_t)snprintf(obj + obj_len, sizeof(obj) - obj_len, " %u", i + 1);
+	}
+	obj_len += (size_t)snprintf(obj + obj_len, sizeof(obj) - obj_len, "\n");
+	ufbxt_assert(obj_len < sizeof(obj));
+
+	ufbx_load_opts load_opts = ufbxt_store_triangle_indices_opts();
+	ufbx_error error;
+	ufbx_scene *scene = ufbx_load_memory(obj, obj_len, &load_opts, &error);
+	if (!scene) ufbxt_log_error(&error);
+	ufbxt_assert(scene);
+	ufbxt_assert(scene->meshes.count == 1);
+	ufbx_mesh *mesh = scene->meshes.data[0];
+	ufbxt_assert(mesh->num_faces == 1 && mesh->faces.data[0].num_indices == num_corners);
+	ufbxt_assert(mesh->triangle_indices.count == (num_corners - 2) * 3);
+
+	ufbxt_check_face_triangles(mesh->faces.data[0], mesh->triangle_indices.data, num_corners - 2);
+	ufbxt_check_triangulate_mesh(mesh, mesh->triangle_indices.data);
+	ufbxt_check_mesh_buffers(mesh, false);
+
+	// Scratch memory for the monotone split must come from `temp_allocator`
+	ufbxt_counting_alloc_stats stats = { 0 };
+	ufbx_vertex_attrib_desc position = { UFBX_VERTEX_ATTRIB_POSITION, UFBX_VERTEX_FORMAT_FLOAT32 };
+	ufbx_mesh_buffers_opts opts = { 0 };
+	opts.attribs.data = &position;
+	opts.attribs.count = 1;
+	opts.temp_allocator.allocator.alloc_fn = &ufbxt_counting_alloc;
+	opts.temp_allocator.allocator.free_fn = &ufbxt_counting_free;
+	opts.temp_allocator.allocator.user = &stats;
+
+	ufbx_mesh_buffers *buffers = ufbx_create_mesh_buffers(mesh, &opts, &error);
+	if (!buffers) ufbxt_log_error(&error);
+	ufbxt_assert(buffers);
+	ufbxt_assert(stats.num_allocs > 0);
+	ufbxt_assert(stats.num_live == 0);
+	ufbxt_assert(buffers->parts.count == 1);
+	ufbxt_assert(buffers->parts.data[0].num_indices == (num_corners - 2) * 3);
+	ufbx_free_mesh_buffers(buffers);
+
+	ufbx_free_scene(scene);
+}
+#endif
+
+UFBXT_FILE_TEST_ALT(mesh_buffers_dedup, blender_279_default)
+#if UFBXT_IMPL
+{
+	ufbx_node *node = ufbx_find_node(scene, "Cube");
+	ufbxt_assert(node && node->mesh);
+	ufbx_mesh *mesh = node->mesh;
+
+	// Only positions: the cube shares its 8 corners between faces
+	ufbx_vertex_attrib_desc position = { UFBX_VERTEX_ATTRIB_POSITION, UFBX_VERTEX_FORMAT_FLOAT32 };
+	ufbx_mesh_buffers_opts opts = { 0 };
+	opts.attribs.data = &position;
+	opts.attribs.count = 1;
+
+	ufbx_error error;
+	ufbx_mesh_buffers *buffers = ufbx_create_mesh_buffers(mesh, &opts, &error);
+	if (!buffers) ufbxt_log_error(&error);
+	ufbxt_assert(buffers);
+	ufbxt_assert(buffers->vertex_stride == 12);
+	ufbxt_assert(buffers->parts.count == 1);
+	ufbxt_assert(buffers->parts.data[0].num_vertices == 8);
+	ufbxt_assert(buffers->parts.data[0].num_indices == 36);
+	ufbxt_assert(buffers->parts.data[0].index_size == 2);
+	ufbx_free_mesh_buffers(buffers);
+
+	// Adding normals splits the corners per face
+	ufbx_vertex_attrib_desc attribs[] = {
+		{ UFBX_VERTEX_ATTRIB_POSITION, UFBX_VERTEX_FORMAT_FLOAT32, 0, 0, 0 },
+		{ UFBX_VERTEX_ATTRIB_NORMAL, UFBX_VERTEX_FORMAT_SNORM16, 4, 0, 12 },
+	};
+	opts.attribs.data = attribs;
+	opts.attribs.count = ufbxt_arraycount(attribs);
+	buffers = ufbx_create_mesh_buffers(mesh, &opts, &error);
+	ufbxt_assert(buffers);
+	ufbxt_assert(buffers->vertex_stride == 20);
+	ufbxt_assert(buffers->parts.data[0].num_vertices == 24);
+
+	// Missing fourth component defaults to one
+	const int16_t *normal = (const int16_t*)((const char*)buffers->parts.data[0].vertex_data.data + 12);
+	ufbxt_assert(normal[3] == 32767);
+	ufbx_free_mesh_buffers(buffers);
+
+	// Errors
+	ufbxt_assert(!ufbx_create_mesh_buffers(mesh, NULL, &error));
+	ufbxt_assert(error.type != UFBX_ERROR_NONE);
+
+	opts.vertex_stride = 16;
+	ufbxt_assert(!ufbx_create_mesh_buffers(mesh, &opts, &error));
+	ufbxt_assert(error.type != UFBX_ERROR_NONE);
+
+	opts.vertex_stride = 0;
+	attribs[1].num_components = 5;
+	ufbxt_assert(!ufbx_create_mesh_buffers(mesh, &opts, &error));
+	ufbxt_assert(error.type != UFBX_ERROR_NONE);
+}
+#endif
+
 UFBXT_FILE_TEST(maya_vertex_crease_single)
 #if UFBXT_IMPL
 {
@@ -262,6 +262,152 @@ UFBXT_FILE_TEST(blender_300_ngon_irregular)
 }
 #endif
 
+#if UFBXT_IMPL
+static void ufbxt_set_corner(ufbx_vec3 *dst, ufbx_real x, ufbx_real y)
+{
+	dst->x = x;
+	dst->y = y;
+	dst->z = 0.0f;
+}
+
+typedef struct {
+	size_t num_live;
+	size_t num_allocs;
+} ufbxt_counting_alloc_stats;
+
+static void *ufbxt_counting_alloc(void *user, size_t size)
+{
+	ufbxt_counting_alloc_stats *stats = (ufbxt_counting_alloc_stats*)user;
+	stats->num_live++;
+	stats->num_allocs++;
+	return malloc(size);
+}
+
+static void ufbxt_counting_free(void *user, void *ptr, size_t size)
+{
+	ufbxt_counting_alloc_stats *stats = (ufbxt_counting_alloc_stats*)user;
+	stats->num_live--;
+	free(ptr);
+}
+
+// Check that `tris` contains `face.num_indices - 2` triangles using every corner of `face`
+static void ufbxt_check_face_triangles(ufbx_face face, const uint32_t *tris, size_t num_tris)
+{
+	ufbxt_assert(num_tris == face.num_indices - 2);
+	uint32_t *corner_used = (uint32_t*)calloc(face.num_indices, sizeof(uint32_t));
+	ufbxt_assert(corner_used);
+	for (size_t i = 0; i < num_tris * 3; i++) {
+		ufbxt_assert(tris[i] >= face.index_begin && tris[i] - face.index_begin < face.num_indices);
+		corner_used[tris[i] - face.index_begin]++;
+	}
+	for (uint32_t i = 0; i < face.num_indices; i++) {
+		ufbxt_assert(corner_used[i] > 0);
+	}
+	free(corner_used);
+}
+
+// Triangulate a single polygon on the XY plane and check that the triangles cover it exactly,
+// both with `ufbx_triangulate_face()` and `ufbx_triangulate_mesh()` which splits large polygons into monotone pieces
+static void ufbxt_check_large_ngon(ufbxt_diff_error *err, ufbx_vec3 *positions, uint32_t num_corners)
+{
+	uint32_t *vertex_indices = (uint32_t*)malloc(num_corners * sizeof(uint32_t));
+	uint32_t *indices = (uint32_t*)malloc((num_corners - 2) * 3 * sizeof(uint32_t));
+	ufbxt_assert(vertex_indices && indices);
+
+	for (uint32_t i = 0; i < num_corners; i++) {
+		vertex_indices[i] = i;
+	}
+
+	ufbx_face face = { 0, num_corners };
+
+	ufbx_mesh mesh = { 0 };
+	mesh.num_indices = num_corners;
+	mesh.num_faces = 1;
+	mesh.faces.data = &face;
+	mesh.faces.count = 1;
+	mesh.vertex_position.exists = true;
+	mesh.vertex_position.values.data = positions;
+	mesh.vertex_position.values.count = num_corners;
+	mesh.vertex_position.indices.data = vertex_indices;
+	mesh.vertex_position.indices.count = num_corners;
+	mesh.vertices = mesh.vertex_position.values;
+	mesh.vertex_indices = mesh.vertex_position.indices;
+
+	mesh.num_triangles = num_corners - 2;
+	mesh.max_face_triangles = num_corners - 2;
+
+	const ufbx_vec3 basis[2] = {
+		{ { 1.0f, 0.0f, 0.0f } },
+		{ { 0.0f, 1.0f, 0.0f } },
+	};
+
+	size_t num_tris = ufbx_triangulate_face(indices, (num_corners - 2) * 3, &mesh, face);
+	ufbxt_check_face_triangles(face, indices, num_tris);
+	ufbxt_check_ngon_triangulation(err, &mesh, face, indices, num_tris, basis);
+
+	// Scratch memory for the monotone split must come from `temp_allocator`
+	ufbxt_counting_alloc_stats stats = { 0 };
+	ufbx_triangulate_mesh_opts opts = { 0 };
+	opts.temp_allocator.allocator.alloc_fn = &ufbxt_counting_alloc;
+	opts.temp_allocator.allocator.free_fn = &ufbxt_counting_free;
+	opts.temp_allocator.allocator.user = &stats;
+
+	ufbx_error error;
+	bool ok = ufbx_triangulate_mesh(&mesh, indices, (num_corners - 2) * 3, &opts, &error);
+	if (!ok) ufbxt_log_error(&error);
+	ufbxt_assert(ok);
+	ufbxt_assert(stats.num_allocs > 0);
+	ufbxt_assert(stats.num_live == 0);
+	ufbxt_check_face_triangles(face, indices, num_corners - 2);
+	ufbxt_check_ngon_triangulation(err, &mesh, face, indices, num_corners - 2, basis);
+
+	free(vertex_indices);
+	free(indices);
+}
+#endif
+
+UFBXT_TEST(triangulate_large_ngon)
+#if UFBXT_IMPL
+{
+	ufbxt_diff_error err = { 0 };
+	uint32_t max_corners = 8192;
+	ufbx_vec3 *positions = (ufbx_vec3*)malloc(max_corners * sizeof(ufbx_vec3));
+	ufbxt_assert(positions);
+
+	// Star with random radii, roughly every other corner is reflex
+	for (uint32_t num_corners = 5; num_corners <= max_corners; num_corners *= 2) {
+		uint32_t seed = num_corners;
+		for (uint32_t i = 0; i < num_corners; i++) {
+			seed = seed * 1664525u + 1013904223u;
+			double angle = (double)i / (double)num_corners * 3.141592653589793 * 2.0;
+			double radius = 0.2 + (double)(seed >> 8) / (double)(1u << 24);
+			positions[i].x = (ufbx_real)(radius * cos(angle));
+			positions[i].y = (ufbx_real)(radius * sin(angle));
+			positions[i].z = 0.0f;
+		}
+		ufbxt_check_large_ngon(&err, positions, num_corners);
+	}
+
+	// Comb with teeth of varying height, lots of corners share coordinates
+	for (uint32_t num_teeth = 1; num_teeth <= 1024; num_teeth *= 4) {
+		uint32_t num_corners = 0;
+		ufbxt_set_corner(&positions[num_corners++], 0.0f, 0.0f);
+		ufbxt_set_corner(&positions[num_corners++], (ufbx_real)(num_teeth * 2), 0.0f);
+		for (uint32_t i = num_teeth; i > 0; i--) {
+			ufbx_real height = (ufbx_real)(2 + i % 3);
+			ufbxt_set_corner(&positions[num_corners++], (ufbx_real)(i * 2), height);
+			ufbxt_set_corner(&positions[num_corners++], (ufbx_real)(i * 2 - 1), height);
+			ufbxt_set_corner(&positions[num_corners++], (ufbx_real)(i * 2 - 1), 1.0f);
+		}
+		ufbxt_set_corner(&positions[num_corners++], 0.0f, 1.0f);
+		ufbxt_check_large_ngon(&err, positions, num_corners);
+	}
+
+	free(positions);
+	ufbxt_logf(".. Absolute diff: avg %.3g, max %.3g (%zu tests)", err.sum / (ufbx_real)err.num, err.max, err.num);
+}
+#endif
+
 UFBXT_FILE_TEST_ALT(triangulate_empty, maya_cube_7500_binary)
 #if UFBXT_IMPL
 {
@@ -276,3 +422,106 @@ UFBXT_FILE_TEST_ALT(triangulate_empty, maya_cube_7500_binary)
 }
 #endif
 
+
+#if UFBXT_IMPL
+// Check that `ufbx_triangulate_mesh()` matches triangulating each face separately,
+// except for large non-convex polygons that may be split into monotone pieces instead
+static void ufbxt_check_triangulate_mesh(ufbx_mesh *mesh, const uint32_t *stored_indices)
+{
+	size_t num_indices = mesh->num_triangles * 3;
+	uint32_t *indices = (uint32_t*)malloc((num_indices + 1) * sizeof(uint32_t));
+	uint32_t *tri = (uint32_t*)malloc((mesh->max_face_triangles * 3 + 1) * sizeof(uint32_t));
+	ufbxt_assert(indices && tri);
+
+	ufbx_triangulate_mesh_opts opts = { 0 };
+#if defined(UFBXT_THREADS)
+	ufbx_os_init_ufbx_thread_pool(&opts.thread_opts.pool, g_thread_pool);
+#endif
+
+	ufbx_error error;
+	bool ok = ufbx_triangulate_mesh(mesh, indices, num_indices, &opts, &error);
+	if (!ok) ufbxt_log_error(&error);
+	ufbxt_assert(ok);
+
+	size_t num_read = 0;
+	for (size_t i = 0; i < mesh->num_faces; i++) {
+		ufbx_face face = mesh->faces.data[i];
+		size_t num_tris = ufbx_triangulate_face(tri, mesh->max_face_triangles * 3, mesh, face);
+		ufbxt_assert(num_read + num_tris * 3 <= num_indices);
+		if (memcmp(indices + num_read, tri, num_tris * 3 * sizeof(uint32_t)) != 0) {
+			ufbxt_assert(face.num_indices >= 5);
+			ufbxt_check_face_triangles(face, indices + num_read, num_tris);
+		}
+		num_read += num_tris * 3;
+	}
+	ufbxt_assert(num_read == num_indices);
+
+	if (stored_indices) {
+		ufbxt_assert(!memcmp(stored_indices, indices, num_indices * sizeof(uint32_t)));
+	}
+
+	if (num_indices > 0) {
+		ufbxt_assert(!ufbx_triangulate_mesh(mesh, indices, num_indices - 1, NULL, &error));
+		ufbxt_assert(error.type != UFBX_ERROR_NONE);
+	}
+
+	free(indices);
+	free(tri);
+}
+
+static ufbx_load_opts ufbxt_store_triangle_indices_opts()
+{
+	ufbx_load_opts opts = { 0 };
+	opts.store_triangle_indices = true;
+#if defined(UFBXT_THREADS)
+	ufbx_os_init_ufbx_thread_pool(&opts.thread_opts.pool, g_thread_pool);
+#endif
+	return opts;
+}
+#endif
+
+UFBXT_FILE_TEST_ALT(triangulate_mesh, maya_tri_cone)
+#if UFBXT_IMPL
+{
+	ufbx_node *node = ufbx_find_node(scene, "pCone1");
+	ufbxt_assert(node && node->mesh);
+	ufbx_mesh *mesh = node->mesh;
+	ufbxt_assert(mesh->triangle_indices.count == 0);
+	ufbxt_check_triangulate_mesh(mesh, NULL);
+
+	// The cone cap is convex and triangulated as a fan from the first corner
+	for (size_t i = 0; i < mesh->num_faces; i++) {
+		ufbx_face face = mesh->faces.data[i];
+		if (face.num_indices <= 4) continue;
+
+		uint32_t tris[32*3];
+		size_t num_tris = ufbx_triangulate_face(tris, ufbxt_arraycount(tris), mesh, face);
+		ufbxt_assert(num_tris == face.num_indices - 2);
+		for (size_t ti = 0; ti < num_tris; ti++) {
+			ufbxt_assert(tris[ti*3 + 0] == face.index_begin);
+			ufbxt_assert(tris[ti*3 + 1] == face.index_begin + ti + 1);
+			ufbxt_assert(tris[ti*3 + 2] == face.index_begin + ti + 2);
+		}
+	}
+}
+#endif
+
+UFBXT_FILE_TEST_ALT(triangulate_mesh_irregular, blender_300_ngon_irregular)
+#if UFBXT_IMPL
+{
+	for (size_t i = 0; i < scene->meshes.count; i++) {
+		ufbxt_check_triangulate_mesh(scene->meshes.data[i], NULL);
+	}
+}
+#endif
+
+UFBXT_FILE_TEST_OPTS_ALT(triangulate_mesh_stored, maya_slime, ufbxt_store_triangle_indices_opts)
+#if UFBXT_IMPL
+{
+	for (size_t i = 0; i < scene->meshes.count; i++) {
+		ufbx_mesh *mesh = scene->meshes.data[i];
+		ufbxt_assert(mesh->triangle_indices.count == mesh->num_triangles * 3);
+		ufbxt_check_triangulate_mesh(mesh, mesh->triangle_indices.data);
+	}
+}
+#endif
@@ -16,6 +16,7 @@
 //   UFBX_USE_UNALIGNED_LOADS  Forcibly use unaligned loads on unknown platforms
 //   UFBX_USE_SSE              Explicitly enable SSE2 support (for x86)
 //   UFBX_HAS_FTELLO           Allow ufbx to use `ftello()` to measure file size
+//   UFBX_HAS_CLOCK_GETTIME    Allow ufbx to use `clock_gettime()` for `ufbx_load_stats`
 //   UFBX_WASM_32BIT           Optimize WASM for 32-bit architectures
 //   UFBX_TRACE                Log calls of `ufbxi_check()` for tracing execution
 //   UFBX_LITTLE_ENDIAN=0/1    Explicitly define little/big endian architecture
@@ -43,6 +44,14 @@
 #define UFBXI_FACE_GROUP_HASH_BITS 8
 #define UFBXI_MIN_THREADED_DEFLATE_BYTES 256
 #define UFBXI_MIN_THREADED_ASCII_VALUES 64
+#define UFBXI_UPDATE_NODES_TASK_SIZE 2048
+#define UFBXI_TRIANGULATE_TASK_FACES 8192
+#define UFBXI_TOPOLOGY_TASK_FACES 8192
+
+// Polygons with at least this many corners are triangulated using a monotone partition
+#ifndef UFBXI_MONOTONE_TRIANGULATE_MIN_INDICES
+#define UFBXI_MONOTONE_TRIANGULATE_MIN_INDICES 32
+#endif
 
 #ifndef UFBXI_MAX_NURBS_ORDER
 #define UFBXI_MAX_NURBS_ORDER 128
@@ -84,6 +93,9 @@
 	#if !defined(UFBX_NO_FORMAT_OBJ)
 		#define UFBXI_FEATURE_FORMAT_OBJ 1
 	#endif
+	#if !defined(UFBX_NO_SCENE_SNAPSHOT)
+		#define UFBXI_FEATURE_SCENE_SNAPSHOT 1
+	#endif
 #endif
 
 #if defined(UFBX_DEV)
@@ -119,6 +131,9 @@
 #if !defined(UFBXI_FEATURE_FORMAT_OBJ) && defined(UFBX_ENABLE_FORMAT_OBJ)
 	#define UFBXI_FEATURE_FORMAT_OBJ 1
 #endif
+#if !defined(UFBXI_FEATURE_SCENE_SNAPSHOT) && defined(UFBX_ENABLE_SCENE_SNAPSHOT)
+	#define UFBXI_FEATURE_SCENE_SNAPSHOT 1
+#endif
 #if !defined(UFBXI_FEATURE_ERROR_STACK) && defined(UFBX_ENABLE_ERROR_STACK)
 	#define UFBXI_FEATURE_ERROR_STACK 1
 #endif
@@ -150,6 +165,9 @@
 #if !defined(UFBXI_FEATURE_FORMAT_OBJ)
 	#define UFBXI_FEATURE_FORMAT_OBJ 0
 #endif
+#if !defined(UFBXI_FEATURE_SCENE_SNAPSHOT)
+	#define UFBXI_FEATURE_SCENE_SNAPSHOT 0
+#endif
 #if !defined(UFBXI_FEATURE_ERROR_STACK)
 	#define UFBXI_FEATURE_ERROR_STACK 0
 #endif
@@ -168,7 +186,7 @@
 	#define UFBXI_FEATURE_KD 0
 #endif
 
-#if !UFBXI_FEATURE_SUBDIVISION || !UFBXI_FEATURE_TESSELLATION || !UFBXI_FEATURE_GEOMETRY_CACHE || !UFBXI_FEATURE_SCENE_EVALUATION || !UFBXI_FEATURE_SKINNING_EVALUATION || !UFBXI_FEATURE_ANIMATION_BAKING || !UFBXI_FEATURE_TRIANGULATION || !UFBXI_FEATURE_INDEX_GENERATION || !UFBXI_FEATURE_XML || !UFBXI_FEATURE_KD || !UFBXI_FEATURE_FORMAT_OBJ
+#if !UFBXI_FEATURE_SUBDIVISION || !UFBXI_FEATURE_TESSELLATION || !UFBXI_FEATURE_GEOMETRY_CACHE || !UFBXI_FEATURE_SCENE_EVALUATION || !UFBXI_FEATURE_SKINNING_EVALUATION || !UFBXI_FEATURE_ANIMATION_BAKING || !UFBXI_FEATURE_TRIANGULATION || !UFBXI_FEATURE_INDEX_GENERATION || !UFBXI_FEATURE_XML || !UFBXI_FEATURE_KD || !UFBXI_FEATURE_FORMAT_OBJ || !UFBXI_FEATURE_SCENE_SNAPSHOT
 	#define UFBXI_PARTIAL_FEATURES 1
 #endif
 
@@ -180,6 +198,7 @@
 #include <stdarg.h>
 #include <locale.h>
 #include <float.h>
+#include <time.h>
 
 #if !defined(UFBX_NO_MATH_H)
 	#include <math.h>
@@ -437,6 +456,11 @@
 			#define UFBX_HAS_FTELLO
 		#endif
 	#endif
+	#if _POSIX_C_SOURCE >= 199309l
+		#ifndef UFBX_HAS_CLOCK_GETTIME
+			#define UFBX_HAS_CLOCK_GETTIME
+		#endif
+	#endif
 #endif
 
 // Unaligned little-endian load functions
@@ -751,6 +775,9 @@ ufbx_static_assert(source_header_version, UFBX_SOURCE_VERSION/1000u == UFBX_HEAD
 
 	#undef UFBXI_FACE_GROUP_HASH_BITS
 	#define UFBXI_FACE_GROUP_HASH_BITS 2
+
+	#undef UFBXI_MONOTONE_TRIANGULATE_MIN_INDICES
+	#define UFBXI_MONOTONE_TRIANGULATE_MIN_INDICES 5
 #endif
 
 #if defined(UFBX_REGRESSION) || defined(UFBX_EXTENSIVE_THREADING)
@@ -759,6 +786,15 @@ ufbx_static_assert(source_header_version, UFBX_SOURCE_VERSION/1000u == UFBX_HEAD
 
 	#undef UFBXI_MIN_THREADED_ASCII_VALUES
 	#define UFBXI_MIN_THREADED_ASCII_VALUES 2
+
+	#undef UFBXI_UPDATE_NODES_TASK_SIZE
+	#define UFBXI_UPDATE_NODES_TASK_SIZE 1
+
+	#undef UFBXI_TRIANGULATE_TASK_FACES
+	#define UFBXI_TRIANGULATE_TASK_FACES 4
+
+	#undef UFBXI_TOPOLOGY_TASK_FACES
+	#define UFBXI_TOPOLOGY_TASK_FACES 4
 #endif
 
 #if defined(UFBX_REGRESSION)
@@ -3041,6 +3077,8 @@ static ufbxi_noinline void ufbxi_fix_error_type(ufbx_error *error, const char *d
 		error->type = UFBX_ERROR_UNSAFE_OPTIONS;
 	} else if (!strcmp(desc, "Duplicate override")) {
 		error->type = UFBX_ERROR_DUPLICATE_OVERRIDE;
+	} else if (!strcmp(desc, "Bad snapshot")) {
+		error->type = UFBX_ERROR_BAD_SNAPSHOT;
 	}
 	error->description.data = desc;
 	error->description.length = strlen(desc);
@@ -3068,9 +3106,18 @@ static ufbxi_forceinline size_t ufbxi_size_align_mask(size_t size)
 	return ((size ^ (size - 1)) >> 1) & 0x7;
 }
 
+typedef struct ufbxi_alloc_cache ufbxi_alloc_cache;
+
+// Memory usage shared between multiple allocators, eg. temporary and result.
+typedef struct {
+	size_t current_size;
+	size_t peak_size;
+} ufbxi_memory_usage;
+
 typedef struct {
 	ufbx_error *error;
 	size_t current_size;
+	size_t peak_size;
 	size_t max_size;
 	size_t num_allocs;
 	size_t max_allocs;
@@ -3078,8 +3125,13 @@ typedef struct {
 	size_t chunk_max;
 	ufbx_allocator_opts ator;
 	const char *name;
+	ufbxi_memory_usage *usage; // < Optional
+	ufbxi_alloc_cache *cache;  // < Optional, see `ufbx_load_context`
 } ufbxi_allocator;
 
+static void *ufbxi_cache_alloc(ufbxi_alloc_cache *cache, size_t size);
+static void ufbxi_cache_free(ufbxi_alloc_cache *cache, void *ptr, size_t size);
+
 static ufbxi_forceinline bool ufbxi_does_overflow(size_t total, size_t a, size_t b)
 {
 	// If `a` and `b` have at most 4 bits per `size_t` byte, the product can't overflow.
@@ -3089,6 +3141,23 @@ static ufbxi_forceinline bool ufbxi_does_overflow(size_t total, size_t a, size_t
 	return false;
 }
 
+static ufbxi_forceinline void ufbxi_ator_add_size(ufbxi_allocator *ator, size_t size)
+{
+	ator->current_size += size;
+	if (ator->current_size > ator->peak_size) ator->peak_size = ator->current_size;
+	ufbxi_memory_usage *usage = ator->usage;
+	if (usage) {
+		usage->current_size += size;
+		if (usage->current_size > usage->peak_size) usage->peak_size = usage->current_size;
+	}
+}
+
+static ufbxi_forceinline void ufbxi_ator_sub_size(ufbxi_allocator *ator, size_t size)
+{
+	ator->current_size -= size;
+	if (ator->usage) ator->usage->current_size -= size;
+}
+
 static ufbxi_noinline void *ufbxi_alloc_size(ufbxi_allocator *ator, size_t size, size_t n)
 {
 	// Always succeed with an empty non-NULL buffer for empty allocations
@@ -3110,10 +3179,12 @@ static ufbxi_noinline void *ufbxi_alloc_size(ufbxi_allocator *ator, size_t size,
 	}
 	ator->num_allocs++;
 
-	ator->current_size += total;
+	ufbxi_ator_add_size(ator, total);
 
 	void *ptr;
-	if (ator->ator.allocator.alloc_fn) {
+	if (ator->cache) {
+		ptr = ufbxi_cache_alloc(ator->cache, total);
+	} else if (ator->ator.allocator.alloc_fn) {
 		ptr = ator->ator.allocator.alloc_fn(ator->ator.allocator.user, total);
 	} else if (ator->ator.allocator.realloc_fn) {
 		ptr = ator->ator.allocator.realloc_fn(ator->ator.allocator.user, NULL, 0, total);
@@ -3122,6 +3193,7 @@ static ufbxi_noinline void *ufbxi_alloc_size(ufbxi_allocator *ator, size_t size,
 	}
 
 	if (!ptr) {
+		ufbxi_ator_sub_size(ator, total);
 		ufbxi_report_err_msg(ator->error, "ptr", "Out of memory");
 		ufbxi_fmt_err_info(ator->error, "%s", ator->name);
 		return NULL;
@@ -3152,11 +3224,17 @@ static ufbxi_noinline void *ufbxi_realloc_size(ufbxi_allocator *ator, size_t siz
 	ufbxi_check_return_err_msg(ator->error, ator->num_allocs < ator->max_allocs, NULL, "Allocation limit exceeded");
 	ator->num_allocs++;
 
-	ator->current_size += total;
-	ator->current_size -= old_total;
+	ufbxi_ator_sub_size(ator, old_total);
+	ufbxi_ator_add_size(ator, total);
 
 	void *ptr;
-	if (ator->ator.allocator.realloc_fn) {
+	if (ator->cache) {
+		ptr = ufbxi_cache_alloc(ator->cache, total);
+		if (ptr) {
+			memcpy(ptr, old_ptr, ufbxi_min_sz(old_total, total));
+			ufbxi_cache_free(ator->cache, old_ptr, old_total);
+		}
+	} else if (ator->ator.allocator.realloc_fn) {
 		ptr = ator->ator.allocator.realloc_fn(ator->ator.allocator.user, old_ptr, old_total, total);
 	} else if (ator->ator.allocator.alloc_fn) {
 		// Use user-provided alloc_fn() and free_fn()
@@ -3169,6 +3247,11 @@ static ufbxi_noinline void *ufbxi_realloc_size(ufbxi_allocator *ator, size_t siz
 		ptr = realloc(old_ptr, total);
 	}
 
+	// `old_ptr` is still owned by the caller if the reallocation failed
+	if (!ptr) {
+		ufbxi_ator_sub_size(ator, total);
+		ufbxi_ator_add_size(ator, old_total);
+	}
 	ufbxi_check_return_err_msg(ator->error, ptr, NULL, "Out of memory");
 	ufbx_assert(((uintptr_t)ptr & ufbxi_size_align_mask(total)) == 0);
 
@@ -3187,9 +3270,11 @@ static ufbxi_noinline void ufbxi_free_size(ufbxi_allocator *ator, size_t size, v
 	ufbx_assert(!ufbxi_does_overflow(total, size, n));
 	ufbx_assert(total <= ator->current_size);
 
-	ator->current_size -= total;
+	ufbxi_ator_sub_size(ator, total);
 
-	if (ator->ator.allocator.alloc_fn || ator->ator.allocator.realloc_fn) {
+	if (ator->cache) {
+		ufbxi_cache_free(ator->cache, ptr, total);
+	} else if (ator->ator.allocator.alloc_fn || ator->ator.allocator.realloc_fn) {
 		// Don't call default free() if there is an user-provided `alloc_fn()`
 		if (ator->ator.allocator.free_fn) {
 			ator->ator.allocator.free_fn(ator->ator.allocator.user, ptr, total);
@@ -3241,6 +3326,120 @@ static ufbxi_noinline void ufbxi_free_ator(ufbxi_allocator *ator)
 
 #define ufbxi_grow_array(ator, p_ptr, p_cap, n) ufbxi_grow_array_size((ator), sizeof(**(p_ptr)), (p_ptr), (p_cap), (n))
 
+// -- Allocation cache
+//
+// Retains freed allocations between loads, see `ufbx_load_context`.
+// Buffer chunks and map tables use a small set of allocation sizes so blocks
+// are only reused for allocations of the exact same size.
+
+typedef struct ufbxi_cached_block ufbxi_cached_block;
+
+struct ufbxi_cached_block {
+	ufbxi_cached_block *next;
+};
+
+typedef struct {
+	size_t size;
+	ufbxi_cached_block *blocks;
+} ufbxi_cache_bucket;
+
+struct ufbxi_alloc_cache {
+	ufbxi_allocator *ator;
+
+	// Sorted by `size`
+	ufbxi_cache_bucket *buckets;
+	size_t num_buckets;
+	size_t buckets_cap;
+
+	size_t cached_size;
+	size_t max_cached_size;
+};
+
+static ufbxi_forceinline size_t ufbxi_cache_find_bucket(const ufbxi_alloc_cache *cache, size_t size)
+{
+	size_t begin = 0, end = cache->num_buckets;
+	while (begin < end) {
+		size_t mid = begin + (end - begin) / 2;
+		if (cache->buckets[mid].size < size) {
+			begin = mid + 1;
+		} else {
+			end = mid;
+		}
+	}
+	return begin;
+}
+
+static ufbxi_noinline void *ufbxi_cache_alloc(ufbxi_alloc_cache *cache, size_t size)
+{
+	size_t index = ufbxi_cache_find_bucket(cache, size);
+	if (index < cache->num_buckets) {
+		ufbxi_cache_bucket *bucket = &cache->buckets[index];
+		ufbxi_cached_block *block = bucket->blocks;
+		if (bucket->size == size && block) {
+			bucket->blocks = block->next;
+			cache->cached_size -= size;
+			return block;
+		}
+	}
+	return ufbxi_alloc_size(cache->ator, 1, size);
+}
+
+static ufbxi_noinline void ufbxi_cache_free(ufbxi_alloc_cache *cache, void *ptr, size_t size)
+{
+	if (size >= sizeof(ufbxi_cached_block) && size <= cache->max_cached_size - cache->cached_size) {
+		size_t index = ufbxi_cache_find_bucket(cache, size);
+		if (index == cache->num_buckets || cache->buckets[index].size != size) {
+			if (ufbxi_grow_array(cache->ator, &cache->buckets, &cache->buckets_cap, cache->num_buckets + 1)) {
+				ufbxi_cache_bucket *bucket = &cache->buckets[index];
+				memmove(bucket + 1, bucket, (cache->num_buckets - index) * sizeof(ufbxi_cache_bucket));
+				bucket->size = size;
+				bucket->blocks = NULL;
+				cache->num_buckets++;
+			} else {
+				index = SIZE_MAX;
+			}
+		}
+
+		if (index != SIZE_MAX) {
+			ufbxi_cache_bucket *bucket = &cache->buckets[index];
+			ufbxi_cached_block *block = (ufbxi_cached_block*)ptr;
+			block->next = bucket->blocks;
+			bucket->blocks = block;
+			cache->cached_size += size;
+			return;
+		}
+	}
+	ufbxi_free_size(cache->ator, 1, ptr, size);
+}
+
+// Free cached blocks, largest first, until at most `max_size` bytes are retained.
+static ufbxi_noinline void ufbxi_cache_trim(ufbxi_alloc_cache *cache, size_t max_size)
+{
+	size_t num_buckets = 0;
+	for (size_t i = cache->num_buckets; i > 0; i--) {
+		ufbxi_cache_bucket *bucket = &cache->buckets[i - 1];
+		while (bucket->blocks && cache->cached_size > max_size) {
+			ufbxi_cached_block *block = bucket->blocks;
+			bucket->blocks = block->next;
+			cache->cached_size -= bucket->size;
+			ufbxi_free_size(cache->ator, 1, block, bucket->size);
+		}
+	}
+
+	for (size_t i = 0; i < cache->num_buckets; i++) {
+		if (cache->buckets[i].blocks) {
+			cache->buckets[num_buckets++] = cache->buckets[i];
+		}
+	}
+	cache->num_buckets = num_buckets;
+
+	if (num_buckets == 0) {
+		ufbxi_free(cache->ator, ufbxi_cache_bucket, cache->buckets, cache->buckets_cap);
+		cache->buckets = NULL;
+		cache->buckets_cap = 0;
+	}
+}
+
 #define UFBXI_SCENE_IMP_MAGIC 0x58424655
 #define UFBXI_MESH_IMP_MAGIC 0x48534d55
 #define UFBXI_LINE_CURVE_IMP_MAGIC 0x55434c55
@@ -3249,6 +3448,12 @@ static ufbxi_noinline void ufbxi_free_ator(ufbxi_allocator *ator)
 #define UFBXI_BAKED_ANIM_IMP_MAGIC 0x4b414255
 #define UFBXI_REFCOUNT_IMP_MAGIC 0x46455255
 #define UFBXI_BUF_CHUNK_IMP_MAGIC 0x46554255
+#define UFBXI_SCENE_SNAPSHOT_IMP_MAGIC 0x504e5355
+#define UFBXI_LOAD_CONTEXT_IMP_MAGIC 0x58434c55
+#define UFBXI_COMPILED_ANIM_IMP_MAGIC 0x4e414355
+#define UFBXI_BLEND_VERTEX_LAYOUT_IMP_MAGIC 0x4c564255
+#define UFBXI_COMPRESSED_ANIM_IMP_MAGIC 0x4e415a55
+#define UFBXI_MESH_BUFFERS_IMP_MAGIC 0x46424d55
 
 // -- Memory buffer
 //
@@ -3853,11 +4058,13 @@ static ufbxi_noinline void ufbxi_map_free(ufbxi_map *map)
 	map->items = NULL;
 	map->aa_root = NULL;
 	map->mask = map->capacity = map->size = 0;
+	map->data_size = 0;
 
 #if defined(UFBX_REGRESSION)
 	if (regression_ator) {
 		ufbxi_free_ator(regression_ator);
 		free(regression_ator);
+		map->aa_buf.ator = NULL;
 	}
 #endif
 }
@@ -5340,6 +5547,65 @@ static ufbxi_noinline ufbx_vec3 ufbxi_slow_normalized_cross3(const ufbx_vec3 *a,
 	return ufbxi_normalize3(ufbxi_cross3(*a, *b));
 }
 
+// -- Tracing
+
+#define UFBXI_MAX_TRACE_DEPTH 16
+
+// Keeps track of open zones so they can be closed on failure, see `ufbxi_trace_unwind()`.
+typedef struct {
+	ufbx_trace_cb cb;
+	bool enabled;
+	uint32_t depth;
+	const char *stack[UFBXI_MAX_TRACE_DEPTH];
+} ufbxi_tracer;
+
+static ufbxi_noinline void ufbxi_trace_init(ufbxi_tracer *tr, const ufbx_trace_cb *cb)
+{
+	tr->cb = *cb;
+	tr->enabled = cb->begin_fn || cb->end_fn;
+	tr->depth = 0;
+}
+
+static ufbxi_noinline void ufbxi_trace_begin_imp(ufbxi_tracer *tr, const char *name)
+{
+	if (tr->depth < UFBXI_MAX_TRACE_DEPTH) {
+		tr->stack[tr->depth] = name;
+	}
+	tr->depth++;
+	if (tr->cb.begin_fn) {
+		tr->cb.begin_fn(tr->cb.user, name);
+	}
+}
+
+static ufbxi_noinline void ufbxi_trace_end_imp(ufbxi_tracer *tr)
+{
+	ufbx_assert(tr->depth > 0);
+	if (tr->depth == 0) return;
+	tr->depth--;
+	const char *name = tr->depth < UFBXI_MAX_TRACE_DEPTH ? tr->stack[tr->depth] : "";
+	if (tr->cb.end_fn) {
+		tr->cb.end_fn(tr->cb.user, name);
+	}
+}
+
+static ufbxi_forceinline void ufbxi_trace_begin(ufbxi_tracer *tr, const char *name)
+{
+	if (tr->enabled) ufbxi_trace_begin_imp(tr, name);
+}
+
+static ufbxi_forceinline void ufbxi_trace_end(ufbxi_tracer *tr)
+{
+	if (tr->enabled) ufbxi_trace_end_imp(tr);
+}
+
+// Close all zones left open by an early return on failure.
+static ufbxi_noinline void ufbxi_trace_unwind(ufbxi_tracer *tr)
+{
+	while (tr->enabled && tr->depth > 0) {
+		ufbxi_trace_end_imp(tr);
+	}
+}
+
 // -- Threading
 
 typedef struct ufbxi_task ufbxi_task;
@@ -5356,6 +5622,8 @@ struct ufbxi_task {
 typedef struct {
 	ufbxi_task task;
 	ufbxi_task_fn *fn;
+	const char *name;
+	double cost;
 } ufbxi_task_imp;
 
 typedef struct {
@@ -5368,6 +5636,7 @@ struct ufbxi_thread_pool {
 	ufbxi_allocator *ator;
 	ufbx_error *error;
 	void *user_ptr;
+	ufbx_trace_cb trace_cb;
 
 	bool enabled;
 	bool failed;
@@ -5389,11 +5658,18 @@ struct ufbxi_thread_pool {
 static void ufbxi_thread_pool_execute(ufbxi_thread_pool *pool, uint32_t index)
 {
 	ufbxi_task_imp *imp = &pool->tasks[index % pool->num_tasks];
+
+	// Tasks may run on any thread so they are traced without `ufbxi_tracer`
+	const ufbx_trace_cb *trace = &pool->trace_cb;
+	if (trace->begin_fn) trace->begin_fn(trace->user, imp->name);
+
 	if (imp->fn(&imp->task)) {
 		imp->task.error = NULL;
 	} else if (!imp->task.error) {
 		imp->task.error = "";
 	}
+
+	if (trace->end_fn) trace->end_fn(trace->user, imp->name);
 }
 
 ufbxi_noinline static void ufbxi_thread_pool_update_finished(ufbxi_thread_pool *pool, uint32_t max_index)
@@ -5444,7 +5720,7 @@ ufbxi_nodiscard ufbxi_noinline static int ufbxi_thread_pool_wait_all(ufbxi_threa
 	return 1;
 }
 
-ufbxi_nodiscard ufbxi_noinline static int ufbxi_thread_pool_init(ufbxi_thread_pool *pool, ufbx_error *error, ufbxi_allocator *ator, const ufbx_thread_opts *opts)
+ufbxi_nodiscard ufbxi_noinline static int ufbxi_thread_pool_init(ufbxi_thread_pool *pool, ufbx_error *error, ufbxi_allocator *ator, const ufbx_thread_opts *opts, const ufbx_trace_cb *trace_cb)
 {
 	if (!(opts->pool.run_fn && opts->pool.wait_fn)) return 1;
 	if (!ufbx_is_thread_safe()) return 1;
@@ -5463,6 +5739,7 @@ ufbxi_nodiscard ufbxi_noinline static int ufbxi_thread_pool_init(ufbxi_thread_po
 	}
 	pool->ator = ator;
 	pool->error = error;
+	pool->trace_cb = *trace_cb;
 
 	pool->num_tasks = num_tasks;
 	pool->tasks = ufbxi_alloc(ator, ufbxi_task_imp, num_tasks);
@@ -5524,7 +5801,7 @@ static void ufbxi_thread_pool_flush_group(ufbxi_thread_pool *pool)
 	pool->group = (group + 1) % UFBX_THREAD_GROUP_COUNT;
 }
 
-ufbxi_nodiscard ufbxi_noinline static ufbxi_task *ufbxi_thread_pool_create_task(ufbxi_thread_pool *pool, ufbxi_task_fn *fn)
+ufbxi_nodiscard ufbxi_noinline static ufbxi_task *ufbxi_thread_pool_create_task(ufbxi_thread_pool *pool, ufbxi_task_fn *fn, const char *name)
 {
 	uint32_t index = pool->start_index;
 	if (index - pool->wait_index >= pool->num_tasks) {
@@ -5543,6 +5820,7 @@ ufbxi_nodiscard ufbxi_noinline static ufbxi_task *ufbxi_thread_pool_create_task(
 	}
 
 	imp->fn = fn;
+	imp->name = name;
 
 	return &imp->task;
 }
@@ -5552,6 +5830,7 @@ static void ufbxi_thread_pool_run_task(ufbxi_thread_pool *pool, ufbxi_task *task
 	(void)task;
 	uint32_t index = pool->start_index;
 	ufbx_assert(task == &pool->tasks[index % pool->num_tasks].task);
+	pool->tasks[index % pool->num_tasks].cost = cost;
 	pool->start_index = index + 1;
 	pool->accumulated_cost += cost;
 
@@ -5619,14 +5898,29 @@ static ufbxi_noinline void ufbxi_retain_ref(ufbxi_refcount *refcount);
 
 #define ufbxi_get_imp(type, ptr) ((type*)((char*)ptr - sizeof(ufbxi_refcount)))
 
+typedef struct ufbxi_eval_partition ufbxi_eval_partition;
+
 typedef struct {
 	ufbxi_refcount refcount;
 	ufbx_scene scene;
 	uint32_t magic;
 
 	ufbxi_buf string_buf;
+
+	// Set for scenes returned by `ufbx_evaluate_scene()`, see `ufbx_update_evaluated_scene()`.
+	ufbxi_eval_partition *eval_partition;
 } ufbxi_scene_imp;
 
+typedef struct {
+	ufbxi_refcount refcount;
+	ufbx_load_context context;
+	uint32_t magic;
+
+	ufbx_error error;
+	ufbxi_alloc_cache cache;
+	bool in_use;
+} ufbxi_load_context_imp;
+
 ufbx_static_assert(scene_imp_offset, offsetof(ufbxi_scene_imp, scene) == sizeof(ufbxi_refcount));
 
 typedef struct {
@@ -5885,6 +6179,7 @@ typedef struct {
 	// Allocators
 	ufbxi_allocator ator_result;
 	ufbxi_allocator ator_tmp;
+	ufbxi_memory_usage memory_usage;
 
 	// Temporary maps
 	ufbxi_map prop_type_map;    // < `ufbxi_prop_type_name` Property type to enum
@@ -5982,6 +6277,8 @@ typedef struct {
 	ufbx_scene scene;
 	ufbxi_scene_imp *scene_imp;
 
+	ufbxi_load_context_imp *load_context;
+
 	ufbx_inflate_retain *inflate_retain;
 
 	// Per-mesh consecutive indices used by `ufbxi_flip_winding()`.
@@ -6007,6 +6304,15 @@ typedef struct {
 	bool parse_threaded;
 	ufbxi_thread_pool thread_pool;
 
+	ufbxi_tracer tracer;
+
+	// Load statistics, see `ufbxi_phase_begin()`
+	ufbx_load_phase stats_phase;
+	double stats_start_wall_time, stats_start_cpu_time;
+	double stats_wall_time, stats_cpu_time;
+	size_t stats_temp_allocs, stats_result_allocs;
+	size_t stats_temp_peak, stats_result_peak;
+
 } ufbxi_context;
 
 static ufbxi_noinline int ufbxi_fail_imp(ufbxi_context *uc, const char *cond, const char *func, uint32_t line)
@@ -6026,6 +6332,138 @@ static ufbxi_noinline int ufbxi_fail_imp(ufbxi_context *uc, const char *cond, co
 #define ufbxi_warnf(type, ...) ufbxi_warnf_imp(&uc->warnings, type, ~0u, __VA_ARGS__)
 #define ufbxi_warnf_tag(type, element_id, ...) ufbxi_warnf_imp(&uc->warnings, type, (element_id), __VA_ARGS__)
 
+// -- Load statistics
+
+static ufbxi_noinline double ufbxi_stats_cpu_time(void)
+{
+	return (double)clock() / (double)CLOCKS_PER_SEC;
+}
+
+static ufbxi_noinline double ufbxi_stats_wall_time(void)
+{
+#if !defined(UFBX_STANDARD_C) && defined(UFBX_HAS_CLOCK_GETTIME)
+	struct timespec ts;
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0) {
+		return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+	}
+#elif !defined(UFBX_STANDARD_C) && UFBXI_MSC_VER >= 1900
+	struct timespec ts;
+	if (timespec_get(&ts, TIME_UTC) == TIME_UTC) {
+		return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+	}
+#endif
+	// Fall back to processor time if there is no portable wall clock
+	return ufbxi_stats_cpu_time();
+}
+
+// Accumulate the statistics of the current phase and switch to `phase`.
+// Allocator peaks are reset for each phase and the overall peak is tracked
+// separately in `stats_temp_peak` and `stats_result_peak`.
+static ufbxi_noinline void ufbxi_stats_switch(ufbxi_context *uc, ufbx_load_phase phase)
+{
+	double wall_time = ufbxi_stats_wall_time();
+	double cpu_time = ufbxi_stats_cpu_time();
+
+	ufbx_load_phase_stats *stats = &uc->scene.metadata.load_stats.phases[uc->stats_phase];
+	stats->wall_time += wall_time - uc->stats_wall_time;
+	stats->cpu_time += cpu_time - uc->stats_cpu_time;
+	stats->temp_allocs += uc->ator_tmp.num_allocs - uc->stats_temp_allocs;
+	stats->result_allocs += uc->ator_result.num_allocs - uc->stats_result_allocs;
+	stats->temp_memory_peak = ufbxi_max_sz(stats->temp_memory_peak, uc->ator_tmp.peak_size);
+	stats->result_memory_peak = ufbxi_max_sz(stats->result_memory_peak, uc->ator_result.peak_size);
+
+	uc->stats_temp_peak = ufbxi_max_sz(uc->stats_temp_peak, uc->ator_tmp.peak_size);
+	uc->stats_result_peak = ufbxi_max_sz(uc->stats_result_peak, uc->ator_result.peak_size);
+	uc->ator_tmp.peak_size = uc->ator_tmp.current_size;
+	uc->ator_result.peak_size = uc->ator_result.current_size;
+
+	uc->stats_phase = phase;
+	uc->stats_wall_time = wall_time;
+	uc->stats_cpu_time = cpu_time;
+	uc->stats_temp_allocs = uc->ator_tmp.num_allocs;
+	uc->stats_result_allocs = uc->ator_result.num_allocs;
+}
+
+static ufbxi_noinline void ufbxi_stats_start(ufbxi_context *uc)
+{
+	uc->stats_phase = UFBX_LOAD_PHASE_PARSE;
+	if (!uc->opts.collect_stats) return;
+
+	uc->stats_wall_time = uc->stats_start_wall_time = ufbxi_stats_wall_time();
+	uc->stats_cpu_time = uc->stats_start_cpu_time = ufbxi_stats_cpu_time();
+	uc->stats_temp_allocs = uc->ator_tmp.num_allocs;
+	uc->stats_result_allocs = uc->ator_result.num_allocs;
+}
+
+static ufbxi_noinline void ufbxi_stats_finish(ufbxi_context *uc)
+{
+	ufbx_load_stats *stats = &uc->scene.metadata.load_stats;
+	if (!uc->opts.collect_stats) {
+		memset(stats, 0, sizeof(ufbx_load_stats));
+		return;
+	}
+
+	ufbxi_stats_switch(uc, uc->stats_phase);
+	stats->enabled = true;
+	stats->wall_time = uc->stats_wall_time - uc->stats_start_wall_time;
+	stats->cpu_time = uc->stats_cpu_time - uc->stats_start_cpu_time;
+
+	// Restore the overall peaks for `ufbx_metadata.temp_memory_peak`
+	uc->ator_tmp.peak_size = ufbxi_max_sz(uc->ator_tmp.peak_size, uc->stats_temp_peak);
+	uc->ator_result.peak_size = ufbxi_max_sz(uc->ator_result.peak_size, uc->stats_result_peak);
+}
+
+static const char *const ufbxi_load_phase_names[] = {
+	"io",
+	"parse",
+	"inflate",
+	"read_objects",
+	"connections",
+	"finalize",
+	"skinning",
+	"caches",
+};
+
+ufbx_static_assert(load_phase_names, ufbxi_arraycount(ufbxi_load_phase_names) == UFBX_LOAD_PHASE_COUNT);
+
+// Enter `phase`, returns the previous phase to pass to `ufbxi_phase_end()`.
+// Phases are also reported as trace zones, see `ufbx_load_opts.trace_cb`.
+// `UFBX_LOAD_PHASE_PARSE` is the phase other phases are entered from, so its
+// zone is closed for the duration of other phases and reopened afterwards.
+static ufbxi_forceinline ufbx_load_phase ufbxi_phase_begin(ufbxi_context *uc, ufbx_load_phase phase)
+{
+	ufbx_load_phase prev = uc->stats_phase;
+	if (prev == UFBX_LOAD_PHASE_PARSE) {
+		ufbxi_trace_end(&uc->tracer);
+	}
+	ufbxi_trace_begin(&uc->tracer, ufbxi_load_phase_names[phase]);
+	if (uc->opts.collect_stats) {
+		ufbxi_stats_switch(uc, phase);
+	} else {
+		uc->stats_phase = phase;
+	}
+	return prev;
+}
+
+static ufbxi_forceinline void ufbxi_phase_end(ufbxi_context *uc, ufbx_load_phase prev)
+{
+	ufbxi_trace_end(&uc->tracer);
+	if (prev == UFBX_LOAD_PHASE_PARSE) {
+		ufbxi_trace_begin(&uc->tracer, ufbxi_load_phase_names[UFBX_LOAD_PHASE_PARSE]);
+	}
+	if (uc->opts.collect_stats) {
+		ufbxi_stats_switch(uc, prev);
+	} else {
+		uc->stats_phase = prev;
+	}
+}
+
+// Byte counts are always accumulated, `ufbxi_stats_finish()` clears them if not requested.
+static ufbxi_forceinline void ufbxi_stats_add_read(ufbxi_context *uc, size_t size)
+{
+	uc->scene.metadata.load_stats.phases[UFBX_LOAD_PHASE_IO].bytes_read += size;
+}
+
 // -- Progress
 
 static ufbxi_forceinline uint64_t ufbxi_get_read_offset(ufbxi_context *uc)
@@ -6108,9 +6546,12 @@ static ufbxi_noinline const char *ufbxi_refill(ufbxi_context *uc, size_t size, b
 	size_t data_capacity = uc->read_buffer_size;
 	while (data_size < data_capacity) {
 		size_t to_read = data_capacity - data_size;
+		ufbx_load_phase prev_phase = ufbxi_phase_begin(uc, UFBX_LOAD_PHASE_IO);
 		size_t read_result = uc->read_fn(uc->read_user, uc->read_buffer + data_size, to_read);
+		ufbxi_phase_end(uc, prev_phase);
 		ufbxi_check_return_msg(read_result != SIZE_MAX, NULL, "IO error");
 		ufbxi_check_return(read_result <= to_read, NULL);
+		ufbxi_stats_add_read(uc, read_result);
 		data_size += read_result;
 		if (read_result == 0) {
 			uc->eof = true;
@@ -6267,9 +6708,12 @@ ufbxi_nodiscard static ufbxi_noinline int ufbxi_read_to(ufbxi_context *uc, void
 		ufbxi_check(uc->read_fn);
 
 		while (size > 0) {
+			ufbx_load_phase prev_phase = ufbxi_phase_begin(uc, UFBX_LOAD_PHASE_IO);
 			size_t read_result = uc->read_fn(uc->read_user, ptr, size);
+			ufbxi_phase_end(uc, prev_phase);
 			ufbxi_check_msg(read_result != SIZE_MAX, "IO error");
 			ufbxi_check(read_result != 0);
+			ufbxi_stats_add_read(uc, read_result);
 
 			ptr += read_result;
 			size -= read_result;
@@ -8316,7 +8760,7 @@ ufbxi_nodiscard ufbxi_noinline static int ufbxi_binary_parse_node(ufbxi_context
 
 			// Threading
 			if (uc->parse_threaded && encoding == 1 && encoded_size >= UFBXI_MIN_THREADED_DEFLATE_BYTES && !uc->file_big_endian && !uc->local_big_endian) {
-				ufbxi_task *task = ufbxi_thread_pool_create_task(&uc->thread_pool, &ufbxi_deflate_task_fn);
+				ufbxi_task *task = ufbxi_thread_pool_create_task(&uc->thread_pool, &ufbxi_deflate_task_fn, "inflate_task");
 				if (task) {
 					ufbxi_deflate_task *t = ufbxi_push_zero(tmp_buf, ufbxi_deflate_task, 1);
 					ufbxi_check(t);
@@ -8438,9 +8882,12 @@ ufbxi_nodiscard ufbxi_noinline static int ufbxi_binary_parse_node(ufbxi_context
 					ufbxi_check(ufbxi_resume_progress(uc));
 				}
 
+				ufbx_load_phase prev_phase = ufbxi_phase_begin(uc, UFBX_LOAD_PHASE_INFLATE);
 				ptrdiff_t res = ufbx_inflate(decoded_data, decoded_data_size, &input, uc->inflate_retain);
+				ufbxi_phase_end(uc, prev_phase);
 				ufbxi_check_msg(res != -28, "Cancelled");
 				ufbxi_check_msg(res == (ptrdiff_t)decoded_data_size, "Bad DEFLATE data");
+				uc->scene.metadata.load_stats.phases[UFBX_LOAD_PHASE_INFLATE].bytes_inflated += decoded_data_size;
 
 			} else {
 				ufbxi_fail("Bad array encoding");
@@ -8658,9 +9105,12 @@ static ufbxi_noinline char ufbxi_ascii_refill(ufbxi_context *uc)
 
 		// Read user data, return '\0' on EOF
 		// TODO: Very unoptimal for non-full-size reads in some cases
+		ufbx_load_phase prev_phase = ufbxi_phase_begin(uc, UFBX_LOAD_PHASE_IO);
 		size_t num_read = uc->read_fn(uc->read_user, dst_buffer, dst_size);
+		ufbxi_phase_end(uc, prev_phase);
 		ufbxi_check_return_msg(num_read != SIZE_MAX, '\0', "IO error");
 		ufbxi_check_return(num_read <= uc->read_buffer_size, '\0');
+		ufbxi_stats_add_read(uc, num_read);
 		if (num_read == 0) return '\0';
 
 		uc->data = uc->data_begin = ua->src = dst_buffer;
@@ -9798,7 +10248,7 @@ ufbxi_nodiscard ufbxi_noinline static int ufbxi_ascii_parse_node(ufbxi_context *
 				t.offset = 0;
 
 				// TODO: Split these further
-				ufbxi_task *task = ufbxi_thread_pool_create_task(&uc->thread_pool, &ufbxi_ascii_array_task_fn);
+				ufbxi_task *task = ufbxi_thread_pool_create_task(&uc->thread_pool, &ufbxi_ascii_array_task_fn, "ascii_array_task");
 				if (task) {
 					task->data = ufbxi_push_copy(tmp_buf, ufbxi_ascii_array_task, 1, &t);
 					ufbxi_check(task->data);
@@ -14843,15 +15293,19 @@ ufbxi_nodiscard ufbxi_noinline static int ufbxi_read_root(ufbxi_context *uc)
 		// even the objects are not found.
 		ufbxi_check_msg(uc->top_node, "Not an FBX file");
 	}
+	ufbx_load_phase prev_phase = ufbxi_phase_begin(uc, UFBX_LOAD_PHASE_READ_OBJECTS);
 	if (uc->thread_pool.enabled) {
 		ufbxi_check(ufbxi_read_objects_threaded(uc));
 	} else {
 		ufbxi_check(ufbxi_read_objects(uc));
 	}
+	ufbxi_phase_end(uc, prev_phase);
 
 	// Connections: Relationships between nodes
 	ufbxi_check(ufbxi_parse_toplevel(uc, ufbxi_Connections));
+	prev_phase = ufbxi_phase_begin(uc, UFBX_LOAD_PHASE_CONNECTIONS);
 	ufbxi_check(ufbxi_read_connections(uc));
+	ufbxi_phase_end(uc, prev_phase);
 
 	// Takes: Pre-7000 animation data
 	ufbxi_check(ufbxi_parse_toplevel(uc, ufbxi_Takes));
@@ -17441,7 +17895,7 @@ static uint64_t ufbxi_find_attribute_fbx_id(ufbxi_context *uc, uint64_t node_fbx
 ufbxi_nodiscard ufbxi_noinline static int ufbxi_resolve_connections(ufbxi_context *uc)
 {
 	size_t num_connections = uc->tmp_connections.num_items;
-	ufbxi_tmp_connection *tmp_connections = ufbxi_push_pop(&uc->tmp, &uc->tmp_connections, ufbxi_tmp_connection, num_connections);
+	ufbxi_tmp_connection *tmp_connections = ufbxi_push_pop(&uc->tmp_parse, &uc->tmp_connections, ufbxi_tmp_connection, num_connections);
 	ufbxi_buf_free(&uc->tmp_connections);
 	ufbxi_check(tmp_connections);
 
@@ -17545,6 +17999,9 @@ ufbxi_nodiscard ufbxi_noinline static int ufbxi_resolve_connections(ufbxi_contex
 
 	// We don't need the temporary connections at this point anymore
 	ufbxi_buf_free(&uc->tmp_connections);
+	ufbxi_buf_free(&uc->tmp_parse);
+	ufbxi_map_free(&uc->fbx_attr_map);
+	ufbxi_map_free(&uc->node_prop_set);
 
 	return 1;
 }
@@ -19059,86 +19516,351 @@ ufbxi_nodiscard ufbxi_noinline static int ufbxi_finalize_lod_group(ufbxi_context
 	return 1;
 }
 
-ufbxi_nodiscard ufbxi_noinline static int ufbxi_generate_normals(ufbxi_context *uc, ufbx_mesh *mesh)
-{
-	size_t num_indices = mesh->num_indices;
-
-	mesh->generated_normals = true;
+#if UFBXI_FEATURE_TRIANGULATION
 
-	ufbx_topo_edge *topo = ufbxi_push(&uc->tmp_stack, ufbx_topo_edge, num_indices);
-	ufbxi_check(topo);
+// Caller allocated temporary memory for triangulating polygons with many corners,
+// see `ufbxi_init_monotone_scratch()`.
+typedef struct {
+	char *data;
+	size_t size;
+	size_t pos;
+} ufbxi_monotone_scratch;
 
-	uint32_t *normal_indices = ufbxi_push(&uc->result, uint32_t, num_indices);
-	ufbxi_check(normal_indices);
+static ufbxi_noinline uint32_t ufbxi_triangulate_face_imp(uint32_t *indices, size_t num_indices, const ufbx_mesh *mesh, ufbx_face face, ufbxi_monotone_scratch *scratch);
+ufbxi_nodiscard static int ufbxi_init_monotone_scratch(ufbxi_monotone_scratch *scratch, ufbxi_buf *buf, uint32_t max_indices);
 
-	ufbx_compute_topology(mesh, topo, num_indices);
-	size_t num_normals = ufbx_generate_normal_mapping(mesh, topo, num_indices, normal_indices, num_indices, false);
+typedef struct {
+	const ufbx_mesh *mesh;
+	uint32_t *indices;
+	size_t face_begin, face_end;
 
-	if (num_normals == mesh->num_vertices) {
-		mesh->vertex_normal.unique_per_vertex = true;
-	}
+	// Number of triangle indices in the range, converted to an offset in `indices[]`
+	size_t index_offset;
 
-	ufbx_vec3 *normal_data = ufbxi_push(&uc->result, ufbx_vec3, num_normals + 1);
-	ufbxi_check(normal_data);
+	// Largest face in the range, used to allocate `scratch`
+	uint32_t max_face_indices;
+	ufbxi_monotone_scratch scratch;
+} ufbxi_triangulate_range;
 
-	normal_data[0] = ufbx_zero_vec3;
-	normal_data++;
+static ufbxi_noinline void ufbxi_count_triangulate_range(ufbxi_triangulate_range *range)
+{
+	const ufbx_face *faces = range->mesh->faces.data;
+	size_t num_indices = 0;
+	uint32_t max_face_indices = 0;
+	for (size_t i = range->face_begin; i < range->face_end; i++) {
+		uint32_t num_face_indices = faces[i].num_indices;
+		if (num_face_indices >= 3) {
+			num_indices += ((size_t)num_face_indices - 2) * 3;
+		}
+		max_face_indices = ufbxi_max32(max_face_indices, num_face_indices);
+	}
+	range->index_offset = num_indices;
+	range->max_face_indices = max_face_indices;
+}
 
-	ufbx_compute_normals(mesh, &mesh->vertex_position, normal_indices, num_indices, normal_data, num_normals);
+static ufbxi_noinline void ufbxi_triangulate_range_faces(ufbxi_triangulate_range *range)
+{
+	const ufbx_mesh *mesh = range->mesh;
+	uint32_t *dst = range->indices + range->index_offset;
+	for (size_t face_ix = range->face_begin; face_ix < range->face_end; face_ix++) {
+		ufbx_face face = mesh->faces.data[face_ix];
+		if (face.num_indices < 3) continue;
 
-	mesh->vertex_normal.exists = true;
-	mesh->vertex_normal.values.data = normal_data;
-	mesh->vertex_normal.values.count = num_normals;
-	mesh->vertex_normal.indices.data = normal_indices;
-	mesh->vertex_normal.indices.count = num_indices;
-	mesh->vertex_normal.value_reals = 3;
+		// Faces with missing positions (see `ufbx_load_opts.allow_missing_vertex_position` and
+		// `UFBX_INDEX_ERROR_HANDLING_NO_INDEX`) have nothing to base the triangulation on
+		bool valid = mesh->vertex_position.exists;
+		if (valid) {
+			const uint32_t *pos_indices = mesh->vertex_position.indices.data + face.index_begin;
+			size_t num_positions = mesh->vertex_position.values.count;
+			for (uint32_t i = 0; i < face.num_indices; i++) {
+				if (pos_indices[i] >= num_positions) valid = false;
+			}
+		}
 
-	mesh->skinned_normal = mesh->vertex_normal;
+		// Polygons are always split into exactly `num_indices - 2` triangles
+		size_t num_face_indices = ((size_t)face.num_indices - 2) * 3;
+		if (valid) {
+			uint32_t num_tris = ufbxi_triangulate_face_imp(dst, num_face_indices, mesh, face, &range->scratch);
+			ufbx_assert(num_tris * 3 == num_face_indices);
+			ufbxi_ignore(num_tris);
+		} else {
+			for (uint32_t i = 1; i + 1 < face.num_indices; i++) {
+				dst[i*3 - 3] = face.index_begin;
+				dst[i*3 - 2] = face.index_begin + i;
+				dst[i*3 - 1] = face.index_begin + i + 1;
+			}
+		}
+		dst += num_face_indices;
+	}
+}
 
-	ufbxi_pop(&uc->tmp_stack, ufbx_topo_edge, num_indices, NULL);
+static bool ufbxi_count_triangulate_range_task_fn(ufbxi_task *task)
+{
+	ufbxi_count_triangulate_range((ufbxi_triangulate_range*)task->data);
+	return true;
+}
 
-	return 1;
+static bool ufbxi_triangulate_range_task_fn(ufbxi_task *task)
+{
+	ufbxi_triangulate_range_faces((ufbxi_triangulate_range*)task->data);
+	return true;
 }
 
-ufbxi_nodiscard ufbxi_noinline static int ufbxi_push_prop_prefix(ufbxi_context *uc, ufbx_string *dst, ufbx_string prefix)
+// Triangulate `mesh` into `indices[max_indices]`: Count the triangles of each face range,
+// prefix sum the counts to find where each range begins and triangulate the ranges.
+// Both passes run in parallel if `pool` is enabled.
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_triangulate_mesh_imp(const ufbx_mesh *mesh, uint32_t *indices, size_t max_indices,
+	ufbxi_buf *tmp, ufbxi_thread_pool *pool, ufbx_error *error)
 {
-	size_t stack_size = 0;
-	if (prefix.length > 0 && prefix.data[prefix.length - 1] != '|') {
-		stack_size = prefix.length + 1;
-		char *copy = ufbxi_push(&uc->tmp_stack, char, stack_size);
-		ufbxi_check(copy);
-		memcpy(copy, prefix.data, prefix.length);
-		copy[prefix.length] = '|';
+	size_t num_faces = mesh->num_faces;
+	size_t num_ranges = (num_faces + UFBXI_TRIANGULATE_TASK_FACES - 1) / UFBXI_TRIANGULATE_TASK_FACES;
+	if (num_ranges == 0) return 1;
+
+	ufbxi_triangulate_range *ranges = ufbxi_push(tmp, ufbxi_triangulate_range, num_ranges);
+	ufbxi_check_err(error, ranges);
+
+	for (size_t i = 0; i < num_ranges; i++) {
+		ufbxi_triangulate_range *range = &ranges[i];
+		range->mesh = mesh;
+		range->indices = indices;
+		range->face_begin = i * UFBXI_TRIANGULATE_TASK_FACES;
+		range->face_end = ufbxi_min_sz(range->face_begin + UFBXI_TRIANGULATE_TASK_FACES, num_faces);
+		range->index_offset = 0;
+		range->max_face_indices = 0;
+	}
+
+	bool threaded = pool->enabled && num_ranges > 1;
+	for (size_t i = 0; i < num_ranges; i++) {
+		ufbxi_task *task = threaded ? ufbxi_thread_pool_create_task(pool, &ufbxi_count_triangulate_range_task_fn, "count_triangles") : NULL;
+		if (task) {
+			task->data = &ranges[i];
+			ufbxi_thread_pool_run_task(pool, task, (double)(ranges[i].face_end - ranges[i].face_begin));
+		} else {
+			ufbxi_count_triangulate_range(&ranges[i]);
+		}
+	}
+	if (threaded) {
+		ufbxi_thread_pool_flush_group(pool);
+		ufbxi_check_err(error, ufbxi_thread_pool_wait_all(pool));
+	}
 
-		prefix.data = copy;
-		prefix.length += 1;
+	size_t num_indices = 0;
+	for (size_t i = 0; i < num_ranges; i++) {
+		size_t count = ranges[i].index_offset;
+		ranges[i].index_offset = num_indices;
+		num_indices += count;
 	}
+	ufbxi_check_err_msg(error, num_indices <= max_indices, "Triangle index buffer too small");
 
-	ufbxi_check(ufbxi_push_string_place_str(&uc->string_pool, &prefix, false));
-	*dst = prefix;
+	// Allocate memory for triangulating large polygons here as the tasks can't allocate
+	for (size_t i = 0; i < num_ranges; i++) {
+		ufbxi_check_err(error, ufbxi_init_monotone_scratch(&ranges[i].scratch, tmp, ranges[i].max_face_indices));
+	}
 
-	if (stack_size > 0) {
-		ufbxi_pop(&uc->tmp_stack, char, stack_size, NULL);
+	for (size_t i = 0; i < num_ranges; i++) {
+		ufbxi_task *task = threaded ? ufbxi_thread_pool_create_task(pool, &ufbxi_triangulate_range_task_fn, "triangulate") : NULL;
+		if (task) {
+			task->data = &ranges[i];
+			ufbxi_thread_pool_run_task(pool, task, (double)(ranges[i].face_end - ranges[i].face_begin) * 4.0);
+		} else {
+			ufbxi_triangulate_range_faces(&ranges[i]);
+		}
+	}
+	if (threaded) {
+		ufbxi_thread_pool_flush_group(pool);
+		ufbxi_check_err(error, ufbxi_thread_pool_wait_all(pool));
 	}
 
+	for (size_t i = num_ranges; i > 0; i--) {
+		ufbxi_pop(tmp, uint64_t, ranges[i - 1].scratch.size / 8, NULL);
+	}
+	ufbxi_pop(tmp, ufbxi_triangulate_range, num_ranges, NULL);
 	return 1;
 }
 
-ufbxi_nodiscard ufbxi_noinline static int ufbxi_shader_texture_find_prefix(ufbxi_context *uc, ufbx_texture *texture, ufbx_shader_texture *shader)
+ufbxi_nodiscard ufbxi_noinline static int ufbxi_store_triangle_indices(ufbxi_context *uc)
 {
-	ufbx_string suffixes[3];
-	size_t num_suffixes = 0;
+	ufbxi_for_ptr_list(ufbx_mesh, p_mesh, uc->scene.meshes) {
+		ufbx_mesh *mesh = *p_mesh;
+		size_t num_indices = mesh->num_triangles * 3;
 
-	suffixes[num_suffixes++] = ufbxi_str_c(" Parameters/Connections");
-	if (shader->shader_name.length > 0) {
-		suffixes[num_suffixes++] = shader->shader_name;
+		uint32_t *indices = ufbxi_push(&uc->result, uint32_t, num_indices);
+		ufbxi_check(indices);
+		ufbxi_check(ufbxi_triangulate_mesh_imp(mesh, indices, num_indices, &uc->tmp_stack, &uc->thread_pool, &uc->error));
+
+		mesh->triangle_indices.data = indices;
+		mesh->triangle_indices.count = num_indices;
 	}
-	suffixes[num_suffixes++] = ufbxi_str_c("3dsMax|parameters");
+	return 1;
+}
 
-	ufbx_assert(num_suffixes <= ufbxi_arraycount(suffixes));
+static ufbxi_noinline bool ufbxi_triangulate_mesh(const ufbx_mesh *mesh, uint32_t *indices, size_t num_indices, const ufbx_triangulate_mesh_opts *user_opts, ufbx_error *error)
+{
+	ufbx_triangulate_mesh_opts opts;
+	if (user_opts) {
+		opts = *user_opts;
+	} else {
+		memset(&opts, 0, sizeof(opts));
+	}
 
-	ufbxi_for(ufbx_string, p_suffix, suffixes, num_suffixes) {
-		ufbx_string suffix = *p_suffix;
+	// `ufbx_triangulate_mesh_opts` must be cleared to zero first!
+	ufbx_assert(opts._begin_zero == 0 && opts._end_zero == 0);
+	if (opts._begin_zero != 0 || opts._end_zero != 0) {
+		ufbxi_report_err_msg(error, "opts._begin_zero == 0 && opts._end_zero == 0", "Uninitialized options");
+		ufbxi_fix_error_type(error, "Failed to triangulate mesh");
+		return false;
+	}
+
+	ufbxi_allocator ator = { 0 };
+	ufbxi_init_ator(error, &ator, &opts.temp_allocator, "temp");
+
+	ufbxi_thread_pool pool;
+	ufbxi_buf tmp;
+	memset(&pool, 0, sizeof(pool));
+	memset(&tmp, 0, sizeof(tmp));
+	tmp.ator = &ator;
+
+	int ok = 1;
+	ufbx_trace_cb trace_cb = { 0 };
+	if (mesh->num_faces >= UFBXI_TRIANGULATE_TASK_FACES * 2) {
+		ok = ufbxi_thread_pool_init(&pool, error, &ator, &opts.thread_opts, &trace_cb);
+	}
+	if (ok) {
+		ok = ufbxi_triangulate_mesh_imp(mesh, indices, num_indices, &tmp, &pool, error);
+	}
+
+	// Wait for all tasks before releasing them
+	ufbxi_thread_pool_free(&pool);
+	ufbxi_buf_free(&tmp);
+	ufbxi_free_ator(&ator);
+
+	if (ok) {
+		ufbxi_clear_error(error);
+	} else {
+		ufbxi_fix_error_type(error, "Failed to triangulate mesh");
+	}
+	return ok != 0;
+}
+
+#else
+
+ufbxi_nodiscard ufbxi_noinline static int ufbxi_store_triangle_indices(ufbxi_context *uc)
+{
+	ufbxi_fmt_err_info(&uc->error, "UFBX_ENABLE_TRIANGULATION");
+	ufbxi_fail_msg("UFBXI_FEATURE_TRIANGULATION", "Feature disabled");
+}
+
+static ufbxi_noinline bool ufbxi_triangulate_mesh(const ufbx_mesh *mesh, uint32_t *indices, size_t num_indices, const ufbx_triangulate_mesh_opts *user_opts, ufbx_error *error)
+{
+	ufbxi_fmt_err_info(error, "UFBX_ENABLE_TRIANGULATION");
+	ufbxi_report_err_msg(error, "UFBXI_FEATURE_TRIANGULATION", "Feature disabled");
+	return false;
+}
+
+#endif
+
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_compute_topology_imp(const ufbx_mesh *mesh, ufbx_topo_edge *topo,
+	ufbxi_buf *tmp, ufbxi_thread_pool *pool, ufbx_error *error);
+
+ufbxi_nodiscard ufbxi_noinline static int ufbxi_store_topology(ufbxi_context *uc, ufbx_mesh *mesh)
+{
+	ufbx_topo_edge *topo = ufbxi_push(&uc->result, ufbx_topo_edge, mesh->num_indices);
+	ufbxi_check(topo);
+	ufbxi_check(ufbxi_compute_topology_imp(mesh, topo, &uc->tmp_stack, &uc->thread_pool, &uc->error));
+
+	mesh->topology.data = topo;
+	mesh->topology.count = mesh->num_indices;
+	return 1;
+}
+
+ufbxi_nodiscard ufbxi_noinline static int ufbxi_generate_normals(ufbxi_context *uc, ufbx_mesh *mesh)
+{
+	size_t num_indices = mesh->num_indices;
+
+	mesh->generated_normals = true;
+
+	// Use the stored topology from `ufbx_load_opts.compute_topology` if possible
+	ufbx_topo_edge *topo = mesh->topology.data;
+	ufbx_topo_edge *tmp_topo = NULL;
+	if (mesh->topology.count != num_indices) {
+		tmp_topo = ufbxi_push(&uc->tmp_stack, ufbx_topo_edge, num_indices);
+		ufbxi_check(tmp_topo);
+		ufbxi_check(ufbxi_compute_topology_imp(mesh, tmp_topo, &uc->tmp_stack, &uc->thread_pool, &uc->error));
+		topo = tmp_topo;
+	}
+
+	uint32_t *normal_indices = ufbxi_push(&uc->result, uint32_t, num_indices);
+	ufbxi_check(normal_indices);
+
+	size_t num_normals = ufbx_generate_normal_mapping(mesh, topo, num_indices, normal_indices, num_indices, false);
+
+	if (num_normals == mesh->num_vertices) {
+		mesh->vertex_normal.unique_per_vertex = true;
+	}
+
+	ufbx_vec3 *normal_data = ufbxi_push(&uc->result, ufbx_vec3, num_normals + 1);
+	ufbxi_check(normal_data);
+
+	normal_data[0] = ufbx_zero_vec3;
+	normal_data++;
+
+	ufbx_compute_normals(mesh, &mesh->vertex_position, normal_indices, num_indices, normal_data, num_normals);
+
+	mesh->vertex_normal.exists = true;
+	mesh->vertex_normal.values.data = normal_data;
+	mesh->vertex_normal.values.count = num_normals;
+	mesh->vertex_normal.indices.data = normal_indices;
+	mesh->vertex_normal.indices.count = num_indices;
+	mesh->vertex_normal.value_reals = 3;
+
+	mesh->skinned_normal = mesh->vertex_normal;
+
+	if (tmp_topo) {
+		ufbxi_pop(&uc->tmp_stack, ufbx_topo_edge, num_indices, NULL);
+	}
+
+	return 1;
+}
+
+ufbxi_nodiscard ufbxi_noinline static int ufbxi_push_prop_prefix(ufbxi_context *uc, ufbx_string *dst, ufbx_string prefix)
+{
+	size_t stack_size = 0;
+	if (prefix.length > 0 && prefix.data[prefix.length - 1] != '|') {
+		stack_size = prefix.length + 1;
+		char *copy = ufbxi_push(&uc->tmp_stack, char, stack_size);
+		ufbxi_check(copy);
+		memcpy(copy, prefix.data, prefix.length);
+		copy[prefix.length] = '|';
+
+		prefix.data = copy;
+		prefix.length += 1;
+	}
+
+	ufbxi_check(ufbxi_push_string_place_str(&uc->string_pool, &prefix, false));
+	*dst = prefix;
+
+	if (stack_size > 0) {
+		ufbxi_pop(&uc->tmp_stack, char, stack_size, NULL);
+	}
+
+	return 1;
+}
+
+ufbxi_nodiscard ufbxi_noinline static int ufbxi_shader_texture_find_prefix(ufbxi_context *uc, ufbx_texture *texture, ufbx_shader_texture *shader)
+{
+	ufbx_string suffixes[3];
+	size_t num_suffixes = 0;
+
+	suffixes[num_suffixes++] = ufbxi_str_c(" Parameters/Connections");
+	if (shader->shader_name.length > 0) {
+		suffixes[num_suffixes++] = shader->shader_name;
+	}
+	suffixes[num_suffixes++] = ufbxi_str_c("3dsMax|parameters");
+
+	ufbx_assert(num_suffixes <= ufbxi_arraycount(suffixes));
+
+	ufbxi_for(ufbx_string, p_suffix, suffixes, num_suffixes) {
+		ufbx_string suffix = *p_suffix;
 
 		ufbxi_for_list(ufbx_prop, prop, texture->props.props) {
 			if (prop->type != UFBX_PROP_COMPOUND) continue;
@@ -19856,6 +20578,11 @@ ufbxi_nodiscard ufbxi_noinline static int ufbxi_flip_winding(ufbxi_context *uc,
 		}
 	}
 
+	// Recompute the stored topology in place as the index order has changed
+	if (mesh->topology.count > 0) {
+		ufbxi_check(ufbxi_compute_topology_imp(mesh, mesh->topology.data, &uc->tmp_stack, &uc->thread_pool, &uc->error));
+	}
+
 	return 1;
 }
 
@@ -20242,7 +20969,7 @@ ufbxi_nodiscard ufbxi_noinline static int ufbxi_finalize_scene(ufbxi_context *uc
 	char *element_data = (char*)ufbxi_push_pop(&uc->result, &uc->tmp_elements, uint64_t, uc->tmp_element_byte_offset/8);
 	ufbxi_check(element_data);
 
-	size_t *element_offsets = ufbxi_push_pop(&uc->tmp, &uc->tmp_element_offsets, size_t, uc->tmp_element_offsets.num_items);
+	size_t *element_offsets = ufbxi_push_pop(&uc->tmp_parse, &uc->tmp_element_offsets, size_t, uc->tmp_element_offsets.num_items);
 	ufbxi_buf_free(&uc->tmp_element_offsets);
 	ufbxi_check(element_offsets);
 	for (size_t i = 0; i < num_elements; i++) {
@@ -20263,6 +20990,7 @@ ufbxi_nodiscard ufbxi_noinline static int ufbxi_finalize_scene(ufbxi_context *uc
 	uc->scene.elements.count = num_elements;
 	ufbxi_buf_free(&uc->tmp_element_offsets);
 	ufbxi_buf_free(&uc->tmp_elements);
+	ufbxi_buf_free(&uc->tmp_parse);
 
 	uc->tmp_element_flag = ufbxi_push_zero(&uc->tmp, uint8_t, num_elements);
 	ufbxi_check(uc->tmp_element_flag);
@@ -20271,13 +20999,15 @@ ufbxi_nodiscard ufbxi_noinline static int ufbxi_finalize_scene(ufbxi_context *uc
 	uc->scene.metadata.raw_original_file_path = ufbx_find_blob(&uc->scene.metadata.scene_props, "DocumentUrl", ufbx_empty_blob);
 
 	// Resolve and add the connections to elements
+	ufbx_load_phase prev_phase = ufbxi_phase_begin(uc, UFBX_LOAD_PHASE_CONNECTIONS);
 	ufbxi_check(ufbxi_resolve_connections(uc));
 	ufbxi_check(ufbxi_add_connections_to_elements(uc));
+	ufbxi_phase_end(uc, prev_phase);
 	ufbxi_check(ufbxi_linearize_nodes(uc));
 
 	for (size_t type = 0; type < UFBX_ELEMENT_TYPE_COUNT; type++) {
 		size_t num_typed = uc->tmp_typed_element_offsets[type].num_items;
-		size_t *typed_offsets = ufbxi_push_pop(&uc->tmp, &uc->tmp_typed_element_offsets[type], size_t, num_typed);
+		size_t *typed_offsets = ufbxi_push_pop(&uc->tmp_parse, &uc->tmp_typed_element_offsets[type], size_t, num_typed);
 		ufbxi_buf_free(&uc->tmp_typed_element_offsets[type]);
 		ufbxi_check(typed_offsets);
 
@@ -20291,6 +21021,7 @@ ufbxi_nodiscard ufbxi_noinline static int ufbxi_finalize_scene(ufbxi_context *uc
 		}
 
 		ufbxi_buf_free(&uc->tmp_typed_element_offsets[type]);
+		ufbxi_buf_clear(&uc->tmp_parse);
 	}
 
 	// Create named elements
@@ -20627,6 +21358,10 @@ ufbxi_nodiscard ufbxi_noinline static int ufbxi_finalize_scene(ufbxi_context *uc
 				ufbxi_patch_index_pointer(uc, &set->vertex_color.indices.data);
 			}
 
+			if (uc->opts.compute_topology) {
+				ufbxi_check(ufbxi_store_topology(uc, mesh));
+			}
+
 			// Generate normals if necessary
 			if (!mesh->vertex_normal.exists && uc->opts.generate_missing_normals) {
 				ufbxi_check(ufbxi_generate_normals(uc, mesh));
@@ -21274,11 +22009,8 @@ static ufbxi_forceinline void ufbxi_add_weighted_mat(ufbx_matrix *r, const ufbx_
 	ufbxi_add_weighted_vec3(&r->cols[3], b->cols[3], w);
 }
 
-static void ufbxi_mul_rotate(ufbx_transform *t, ufbx_vec3 v, ufbx_rotation_order order)
+static void ufbxi_apply_rotate_quat(ufbx_transform *t, ufbx_quat q)
 {
-	if (ufbxi_is_vec3_zero(v)) return;
-
-	ufbx_quat q = ufbx_euler_to_quat(v, order);
 	if (t->rotation.w != 1.0) {
 		t->rotation = ufbxi_mul_quat(q, t->rotation);
 	} else {
@@ -21290,19 +22022,19 @@ static void ufbxi_mul_rotate(ufbx_transform *t, ufbx_vec3 v, ufbx_rotation_order
 	}
 }
 
+static void ufbxi_mul_rotate(ufbx_transform *t, ufbx_vec3 v, ufbx_rotation_order order)
+{
+	if (ufbxi_is_vec3_zero(v)) return;
+
+	ufbx_quat q = ufbx_euler_to_quat(v, order);
+	ufbxi_apply_rotate_quat(t, q);
+}
+
 static void ufbxi_mul_rotate_quat(ufbx_transform *t, ufbx_quat q)
 {
 	if (ufbxi_is_quat_identity(q)) return;
 
-	if (t->rotation.w != 1.0) {
-		t->rotation = ufbxi_mul_quat(q, t->rotation);
-	} else {
-		t->rotation = q;
-	}
-
-	if (!ufbxi_is_vec3_zero(t->translation)) {
-		t->translation = ufbx_quat_rotate_vec3(q, t->translation);
-	}
+	ufbxi_apply_rotate_quat(t, q);
 }
 
 static void ufbxi_mul_inv_rotate(ufbx_transform *t, ufbx_vec3 v, ufbx_rotation_order order)
@@ -21311,15 +22043,7 @@ static void ufbxi_mul_inv_rotate(ufbx_transform *t, ufbx_vec3 v, ufbx_rotation_o
 
 	ufbx_quat q = ufbx_euler_to_quat(v, order);
 	q.x = -q.x; q.y = -q.y; q.z = -q.z;
-	if (t->rotation.w != 1.0) {
-		t->rotation = ufbxi_mul_quat(q, t->rotation);
-	} else {
-		t->rotation = q;
-	}
-
-	if (!ufbxi_is_vec3_zero(t->translation)) {
-		t->translation = ufbx_quat_rotate_vec3(q, t->translation);
-	}
+	ufbxi_apply_rotate_quat(t, q);
 }
 
 // -- Updating state from properties
@@ -21365,20 +22089,45 @@ ufbxi_noinline static ufbx_transform ufbxi_get_geometry_transform(const ufbx_pro
 	return t;
 }
 
-ufbxi_noinline static ufbx_transform ufbxi_get_transform(const ufbx_props *props, ufbx_rotation_order order, const ufbx_node *node, const ufbx_vec3 *translation_scale)
-{
-	ufbx_vec3 scale_pivot = ufbxi_find_vec3(props, ufbxi_ScalingPivot, 0.0f, 0.0f, 0.0f);
-	ufbx_vec3 rot_pivot = ufbxi_find_vec3(props, ufbxi_RotationPivot, 0.0f, 0.0f, 0.0f);
-	ufbx_vec3 scale_offset = ufbxi_find_vec3(props, ufbxi_ScalingOffset, 0.0f, 0.0f, 0.0f);
-	ufbx_vec3 rot_offset = ufbxi_find_vec3(props, ufbxi_RotationOffset, 0.0f, 0.0f, 0.0f);
-
-	ufbx_vec3 translation = ufbxi_find_vec3(props, ufbxi_Lcl_Translation, 0.0f, 0.0f, 0.0f);
-	ufbx_vec3 rotation = ufbxi_find_vec3(props, ufbxi_Lcl_Rotation, 0.0f, 0.0f, 0.0f);
-	ufbx_vec3 scaling = ufbxi_find_vec3(props, ufbxi_Lcl_Scaling, 1.0f, 1.0f, 1.0f);
+// Non-animated part of the node transform, separated so that `ufbx_compile_anim()`
+// can resolve it once and compose the same transform as `ufbxi_get_transform()`.
+typedef struct {
+	ufbx_vec3 scale_pivot;
+	ufbx_vec3 rot_pivot;
+	ufbx_vec3 scale_offset;
+	ufbx_vec3 rot_offset;
+	ufbx_quat pre_rotation;
+	ufbx_quat inv_post_rotation;
+	bool has_pre_rotation;
+	bool has_post_rotation;
+} ufbxi_transform_pivots;
+
+ufbxi_noinline static void ufbxi_get_transform_pivots(ufbxi_transform_pivots *pivots, const ufbx_props *props)
+{
+	pivots->scale_pivot = ufbxi_find_vec3(props, ufbxi_ScalingPivot, 0.0f, 0.0f, 0.0f);
+	pivots->rot_pivot = ufbxi_find_vec3(props, ufbxi_RotationPivot, 0.0f, 0.0f, 0.0f);
+	pivots->scale_offset = ufbxi_find_vec3(props, ufbxi_ScalingOffset, 0.0f, 0.0f, 0.0f);
+	pivots->rot_offset = ufbxi_find_vec3(props, ufbxi_RotationOffset, 0.0f, 0.0f, 0.0f);
 
 	ufbx_vec3 pre_rotation = ufbxi_find_vec3(props, ufbxi_PreRotation, 0.0f, 0.0f, 0.0f);
 	ufbx_vec3 post_rotation = ufbxi_find_vec3(props, ufbxi_PostRotation, 0.0f, 0.0f, 0.0f);
 
+	pivots->has_pre_rotation = !ufbxi_is_vec3_zero(pre_rotation);
+	pivots->has_post_rotation = !ufbxi_is_vec3_zero(post_rotation);
+	pivots->pre_rotation = ufbx_identity_quat;
+	pivots->inv_post_rotation = ufbx_identity_quat;
+	if (pivots->has_pre_rotation) {
+		pivots->pre_rotation = ufbx_euler_to_quat(pre_rotation, UFBX_ROTATION_ORDER_XYZ);
+	}
+	if (pivots->has_post_rotation) {
+		ufbx_quat q = ufbx_euler_to_quat(post_rotation, UFBX_ROTATION_ORDER_XYZ);
+		q.x = -q.x; q.y = -q.y; q.z = -q.z;
+		pivots->inv_post_rotation = q;
+	}
+}
+
+ufbxi_noinline static ufbx_transform ufbxi_compose_transform(const ufbxi_transform_pivots *pivots, ufbx_vec3 translation, ufbx_vec3 rotation, ufbx_vec3 scaling, ufbx_rotation_order order, const ufbx_node *node, const ufbx_vec3 *translation_scale)
+{
 	ufbx_transform t = { { 0,0,0 }, { 0,0,0,1 }, { 1,1,1 }};
 
 	// WorldTransform = ParentWorldTransform * T * Roff * Rp * Rpre * R * Rpost * Rp-1 * Soff * Sp * S * Sp-1
@@ -21395,19 +22144,23 @@ ufbxi_noinline static ufbx_transform ufbxi_get_transform(const ufbx_props *props
 		ufbxi_mul_scale_real(&t, node->adjust_post_scale);
 	}
 
-	ufbxi_sub_translate(&t, scale_pivot);
+	ufbxi_sub_translate(&t, pivots->scale_pivot);
 	ufbxi_mul_scale(&t, scaling);
-	ufbxi_add_translate(&t, scale_pivot);
+	ufbxi_add_translate(&t, pivots->scale_pivot);
 
-	ufbxi_add_translate(&t, scale_offset);
+	ufbxi_add_translate(&t, pivots->scale_offset);
 
-	ufbxi_sub_translate(&t, rot_pivot);
-	ufbxi_mul_inv_rotate(&t, post_rotation, UFBX_ROTATION_ORDER_XYZ);
+	ufbxi_sub_translate(&t, pivots->rot_pivot);
+	if (pivots->has_post_rotation) {
+		ufbxi_apply_rotate_quat(&t, pivots->inv_post_rotation);
+	}
 	ufbxi_mul_rotate(&t, rotation, order);
-	ufbxi_mul_rotate(&t, pre_rotation, UFBX_ROTATION_ORDER_XYZ);
-	ufbxi_add_translate(&t, rot_pivot);
+	if (pivots->has_pre_rotation) {
+		ufbxi_apply_rotate_quat(&t, pivots->pre_rotation);
+	}
+	ufbxi_add_translate(&t, pivots->rot_pivot);
 
-	ufbxi_add_translate(&t, rot_offset);
+	ufbxi_add_translate(&t, pivots->rot_offset);
 
 	ufbxi_add_translate(&t, translation);
 
@@ -21427,6 +22180,18 @@ ufbxi_noinline static ufbx_transform ufbxi_get_transform(const ufbx_props *props
 	return t;
 }
 
+ufbxi_noinline static ufbx_transform ufbxi_get_transform(const ufbx_props *props, ufbx_rotation_order order, const ufbx_node *node, const ufbx_vec3 *translation_scale)
+{
+	ufbxi_transform_pivots pivots;
+	ufbxi_get_transform_pivots(&pivots, props);
+
+	ufbx_vec3 translation = ufbxi_find_vec3(props, ufbxi_Lcl_Translation, 0.0f, 0.0f, 0.0f);
+	ufbx_vec3 rotation = ufbxi_find_vec3(props, ufbxi_Lcl_Rotation, 0.0f, 0.0f, 0.0f);
+	ufbx_vec3 scaling = ufbxi_find_vec3(props, ufbxi_Lcl_Scaling, 1.0f, 1.0f, 1.0f);
+
+	return ufbxi_compose_transform(&pivots, translation, rotation, scaling, order, node, translation_scale);
+}
+
 ufbxi_noinline static ufbx_quat ufbxi_get_rotation(const ufbx_props *props, ufbx_rotation_order order, const ufbx_node *node)
 {
 	ufbx_vec3 rotation = ufbxi_find_vec3(props, ufbxi_Lcl_Rotation, 0.0f, 0.0f, 0.0f);
@@ -21517,7 +22282,9 @@ ufbxi_noinline static ufbx_transform ufbxi_get_constraint_transform(const ufbx_p
 	return t;
 }
 
-ufbxi_noinline static void ufbxi_update_node(ufbx_node *node, const ufbx_transform_override *overrides, size_t num_overrides)
+// Update the local transform of `node`, depends on the local transform of `node->parent->scale_helper`
+// and `node->parent->inherit_scale_node->scale_helper` if `node` is a scale helper.
+ufbxi_noinline static void ufbxi_update_node_local(ufbx_node *node, const ufbx_transform_override *overrides, size_t num_overrides)
 {
 	node->rotation_order = (ufbx_rotation_order)ufbxi_find_enum(&node->props, ufbxi_RotationOrder, UFBX_ROTATION_ORDER_XYZ, UFBX_ROTATION_ORDER_SPHERIC);
 	node->euler_rotation = ufbxi_find_vec3(&node->props, ufbxi_Lcl_Rotation, 0.0f, 0.0f, 0.0f);
@@ -21553,6 +22320,12 @@ ufbxi_noinline static void ufbxi_update_node(ufbx_node *node, const ufbx_transfo
 		node->geometry_transform = ufbx_identity_transform;
 	}
 
+	node->visible = ufbxi_find_int(&node->props, ufbxi_Visibility, 1) != 0;
+}
+
+// Update the world transform of `node`, depends only on the world transforms of its ancestors.
+ufbxi_noinline static void ufbxi_update_node_world(ufbx_node *node)
+{
 	ufbx_matrix unscaled_node_to_parent = ufbxi_unscaled_transform_to_matrix(&node->local_transform);
 
 	node->inherit_scale = node->local_transform.scale;
@@ -21598,8 +22371,102 @@ ufbxi_noinline static void ufbxi_update_node(ufbx_node *node, const ufbx_transfo
 		node->geometry_to_world = node->node_to_world;
 		node->has_geometry_transform = false;
 	}
+}
 
-	node->visible = ufbxi_find_int(&node->props, ufbxi_Visibility, 1) != 0;
+ufbxi_noinline static void ufbxi_update_node(ufbx_node *node, const ufbx_transform_override *overrides, size_t num_overrides)
+{
+	ufbxi_update_node_local(node, overrides, num_overrides);
+	ufbxi_update_node_world(node);
+}
+
+// Nodes are sorted by depth in `ufbxi_linearize_nodes()` so each level of the hierarchy
+// is a contiguous range of `scene->nodes` that only depends on the levels before it.
+// Levels wider than `2 * UFBXI_UPDATE_NODES_TASK_SIZE` are split into tasks.
+#define UFBXI_UPDATE_NODES_MAX_TASKS 64
+
+typedef struct {
+	ufbx_node **nodes;
+	size_t num_nodes;
+	const ufbx_transform_override *overrides;
+	size_t num_overrides;
+} ufbxi_update_nodes_task;
+
+ufbxi_noinline static void ufbxi_update_node_range(ufbx_node **nodes, size_t num_nodes, const ufbx_transform_override *overrides, size_t num_overrides)
+{
+	for (size_t i = 0; i < num_nodes; i++) {
+		ufbx_node *node = nodes[i];
+		// Scale helpers are updated before the rest of the level, see `ufbxi_update_nodes()`
+		if (!node->is_scale_helper) {
+			ufbxi_update_node_local(node, overrides, num_overrides);
+		}
+		ufbxi_update_node_world(node);
+	}
+}
+
+static bool ufbxi_update_nodes_task_fn(ufbxi_task *task)
+{
+	ufbxi_update_nodes_task *t = (ufbxi_update_nodes_task*)task->data;
+	ufbxi_update_node_range(t->nodes, t->num_nodes, t->overrides, t->num_overrides);
+	return true;
+}
+
+ufbxi_nodiscard ufbxi_noinline static int ufbxi_update_nodes(ufbx_scene *scene, ufbx_error *error, ufbxi_thread_pool *pool, const ufbx_transform_override *overrides, size_t num_overrides)
+{
+	ufbx_node **nodes = scene->nodes.data;
+	size_t num_nodes = scene->nodes.count;
+	bool threaded = pool && pool->enabled && num_nodes >= 2 * UFBXI_UPDATE_NODES_TASK_SIZE;
+
+	ufbxi_update_nodes_task tasks[UFBXI_UPDATE_NODES_MAX_TASKS];
+
+	size_t level_begin = 0;
+	while (level_begin < num_nodes) {
+		uint32_t depth = nodes[level_begin]->node_depth;
+		size_t level_end = level_begin + 1;
+		while (level_end < num_nodes && nodes[level_end]->node_depth == depth) {
+			level_end++;
+		}
+
+		// The local transforms of the rest of the level depend on the scale helpers
+		for (size_t i = level_begin; i < level_end; i++) {
+			if (nodes[i]->is_scale_helper) {
+				ufbxi_update_node_local(nodes[i], overrides, num_overrides);
+			}
+		}
+
+		size_t num_level_nodes = level_end - level_begin;
+		if (!threaded || num_level_nodes < 2 * UFBXI_UPDATE_NODES_TASK_SIZE) {
+			ufbxi_update_node_range(nodes + level_begin, num_level_nodes, overrides, num_overrides);
+			level_begin = level_end;
+			continue;
+		}
+
+		size_t num_tasks = ufbxi_min_sz(num_level_nodes / UFBXI_UPDATE_NODES_TASK_SIZE, UFBXI_UPDATE_NODES_MAX_TASKS);
+		for (size_t task_ix = 0; task_ix < num_tasks; task_ix++) {
+			size_t begin = level_begin + num_level_nodes * task_ix / num_tasks;
+			size_t end = level_begin + num_level_nodes * (task_ix + 1) / num_tasks;
+
+			ufbxi_task *task = ufbxi_thread_pool_create_task(pool, &ufbxi_update_nodes_task_fn, "update_nodes");
+			if (task) {
+				ufbxi_update_nodes_task *t = &tasks[task_ix];
+				t->nodes = nodes + begin;
+				t->num_nodes = end - begin;
+				t->overrides = overrides;
+				t->num_overrides = num_overrides;
+				task->data = t;
+				ufbxi_thread_pool_run_task(pool, task, (double)(end - begin));
+			} else {
+				ufbxi_update_node_range(nodes + begin, end - begin, overrides, num_overrides);
+			}
+		}
+
+		// The next level depends on the world transforms of this one
+		ufbxi_thread_pool_flush_group(pool);
+		ufbxi_check_err(error, ufbxi_thread_pool_wait_all(pool));
+
+		level_begin = level_end;
+	}
+
+	return 1;
 }
 
 ufbxi_noinline static void ufbxi_update_light(ufbx_light *light)
@@ -21842,6 +22709,46 @@ ufbxi_noinline static void ufbxi_update_skin_cluster(ufbx_skin_cluster *cluster)
 	cluster->geometry_to_world_transform = ufbx_matrix_to_transform(&cluster->geometry_to_world);
 }
 
+// Find the keyframes surrounding `weight` and the interpolation factor `t` between them,
+// index -1 refers to the implicit zero keyframe. Returns false if no keyframe is active.
+ufbxi_noinline static bool ufbxi_find_blend_keyframes(const ufbx_blend_keyframe *keys, ptrdiff_t num_keys, ufbx_real weight, ptrdiff_t *p_prev, ptrdiff_t *p_next, ufbx_real *p_t)
+{
+	// Find the split around zero
+	ptrdiff_t last_negative = -1;
+	for (ptrdiff_t i = 0; i < num_keys; i++) {
+		if (keys[i].target_weight < 0.0) last_negative = i;
+	}
+
+	// Find either the next or last keyframe away from zero
+	ptrdiff_t prev = -1, next = -1;
+	if (weight > 0.0) {
+		if (last_negative >= 0) prev = last_negative;
+		for (ptrdiff_t i = last_negative + 1; i < num_keys; i++) {
+			prev = next;
+			next = i;
+			if (keys[next].target_weight > weight) break;
+		}
+	} else {
+		if (last_negative + 1 < num_keys) prev = last_negative + 1;
+		for (ptrdiff_t i = last_negative; i >= 0; i--) {
+			prev = next;
+			next = i;
+			if (keys[next].target_weight < weight) break;
+		}
+	}
+
+	// Linearly interpolate between the endpoints with the weight
+	ufbx_real prev_weight = prev >= 0 ? keys[prev].target_weight : 0.0f;
+	ufbx_real next_weight = next >= 0 ? keys[next].target_weight : 0.0f;
+	ufbx_real delta = next_weight - prev_weight;
+	if (delta == 0.0) return false;
+
+	*p_prev = prev;
+	*p_next = next;
+	*p_t = (weight - prev_weight) / delta;
+	return true;
+}
+
 ufbxi_noinline static void ufbxi_update_blend_channel(ufbx_blend_channel *channel)
 {
 	ufbx_real weight = ufbxi_find_real(&channel->props, ufbxi_DeformPercent, 0.0f) * (ufbx_real)0.01;
@@ -21850,39 +22757,15 @@ ufbxi_noinline static void ufbxi_update_blend_channel(ufbx_blend_channel *channe
 	ptrdiff_t num_keys = (ptrdiff_t)channel->keyframes.count;
 	if (num_keys > 0) {
 		ufbx_blend_keyframe *keys = channel->keyframes.data;
-
-		// Reset the effective weights to zero and find the split around zero
-		ptrdiff_t last_negative = -1;
 		for (ptrdiff_t i = 0; i < num_keys; i++) {
 			keys[i].effective_weight = (ufbx_real)0.0;
-			if (keys[i].target_weight < 0.0) last_negative = i;
-		}
-
-		// Find either the next or last keyframe away from zero
-		ufbx_blend_keyframe zero_key = { NULL };
-		ufbx_blend_keyframe *prev = &zero_key, *next = &zero_key;
-		if (weight > 0.0) {
-			if (last_negative >= 0) prev = &keys[last_negative];
-			for (ptrdiff_t i = last_negative + 1; i < num_keys; i++) {
-				prev = next;
-				next = &keys[i];
-				if (next->target_weight > weight) break;
-			}
-		} else {
-			if (last_negative + 1 < num_keys) prev = &keys[last_negative + 1];
-			for (ptrdiff_t i = last_negative; i >= 0; i--) {
-				prev = next;
-				next = &keys[i];
-				if (next->target_weight < weight) break;
-			}
 		}
 
-		// Linearly interpolate between the endpoints with the weight
-		ufbx_real delta = next->target_weight - prev->target_weight;
-		if (delta != 0.0) {
-			ufbx_real t = (weight - prev->target_weight) / delta;
-			prev->effective_weight = 1.0f - t;
-			next->effective_weight = t;
+		ptrdiff_t prev, next;
+		ufbx_real t;
+		if (ufbxi_find_blend_keyframes(keys, num_keys, weight, &prev, &next, &t)) {
+			if (prev >= 0) keys[prev].effective_weight = 1.0f - t;
+			if (next >= 0) keys[next].effective_weight = t;
 		}
 	}
 }
@@ -22341,11 +23224,9 @@ ufbxi_noinline static void ufbxi_update_adjust_transforms(ufbxi_context *uc, ufb
 	}
 }
 
-ufbxi_noinline static void ufbxi_update_scene(ufbx_scene *scene, bool initial, const ufbx_transform_override *transform_overrides, size_t num_transform_overrides)
+ufbxi_nodiscard ufbxi_noinline static int ufbxi_update_scene(ufbx_scene *scene, bool initial, const ufbx_transform_override *transform_overrides, size_t num_transform_overrides, ufbx_error *error, ufbxi_thread_pool *pool)
 {
-	ufbxi_for_ptr_list(ufbx_node, p_node, scene->nodes) {
-		ufbxi_update_node(*p_node, transform_overrides, num_transform_overrides);
-	}
+	ufbxi_check_err(error, ufbxi_update_nodes(scene, error, pool, transform_overrides, num_transform_overrides));
 
 	ufbxi_for_ptr_list(ufbx_light, p_light, scene->lights) {
 		ufbxi_update_light(*p_light);
@@ -22398,6 +23279,7 @@ ufbxi_noinline static void ufbxi_update_scene(ufbx_scene *scene, bool initial, c
 	}
 
 	ufbxi_update_anim(scene);
+	return 1;
 }
 
 static ufbxi_noinline void ufbxi_update_scene_metadata(ufbx_metadata *metadata)
@@ -23576,22 +24458,350 @@ static ufbxi_forceinline double ufbxi_find_cubic_bezier_t(double p1, double p2,
 	return t;
 }
 
-ufbxi_nodiscard static ufbxi_noinline int ufbxi_evaluate_skinning(ufbx_scene *scene, ufbx_error *error, ufbxi_buf *buf_result, ufbxi_buf *buf_tmp,
-	double time, bool load_caches, ufbx_geometry_cache_data_opts *cache_opts)
+// Evaluate the value of the cubic segment starting from `prev` at the solved Bezier parameter `t`.
+static ufbxi_forceinline ufbx_real ufbxi_evaluate_cubic_bezier(const ufbx_keyframe *prev, double t)
 {
-#if UFBXI_FEATURE_SKINNING_EVALUATION
-	size_t max_skinned_indices = 0;
+	const ufbx_keyframe *next = prev + 1;
 
-	ufbxi_for_ptr_list(ufbx_mesh, p_mesh, scene->meshes) {
-		ufbx_mesh *mesh = *p_mesh;
-		if (mesh->blend_deformers.count == 0 && mesh->skin_deformers.count == 0 && (mesh->cache_deformers.count == 0 || !load_caches)) continue;
-		max_skinned_indices = ufbxi_max_sz(max_skinned_indices, mesh->num_indices);
-	}
+	double t2 = t*t, t3 = t2*t;
+	double u = 1.0 - t, u2 = u*u, u3 = u2*u;
 
-	ufbx_topo_edge *topo = ufbxi_push(buf_tmp, ufbx_topo_edge, max_skinned_indices);
-	ufbxi_check_err(error, topo);
+	double y0 = prev->value;
+	double y3 = next->value;
+	double y1 = y0 + prev->right.dy;
+	double y2 = y3 - next->left.dy;
 
-	ufbxi_for_ptr_list(ufbx_mesh, p_mesh, scene->meshes) {
+	return (ufbx_real)(u3*y0 + 3.0 * (u2*t*y1 + u*t2*y2) + t3*y3);
+}
+
+// Evaluate `keys[]` at `time` where `index` is the first keyframe with `keys[index].time > time`.
+static ufbxi_noinline ufbx_real ufbxi_evaluate_keyframes(const ufbx_keyframe *keys, size_t count, size_t index, double time)
+{
+	// First keyframe
+	if (index == 0) return keys[0].value;
+
+	// Last keyframe
+	if (index >= count) return keys[count - 1].value;
+
+	const ufbx_keyframe *next = &keys[index];
+	const ufbx_keyframe *prev = next - 1;
+
+	// Exact keyframe
+	if (prev->time == time) return prev->value;
+
+	double rcp_delta = 1.0 / (next->time - prev->time);
+	double t = (time - prev->time) * rcp_delta;
+
+	switch (prev->interpolation) {
+
+	case UFBX_INTERPOLATION_CONSTANT_PREV:
+		return prev->value;
+
+	case UFBX_INTERPOLATION_CONSTANT_NEXT:
+		return next->value;
+
+	case UFBX_INTERPOLATION_LINEAR:
+		return (ufbx_real)(prev->value*(1.0 - t) + next->value*t);
+
+	case UFBX_INTERPOLATION_CUBIC:
+	{
+		double x1 = prev->right.dx * rcp_delta;
+		double x2 = 1.0 - next->left.dx * rcp_delta;
+		t = ufbxi_find_cubic_bezier_t(x1, x2, t);
+		return ufbxi_evaluate_cubic_bezier(prev, t);
+	}
+
+	default:
+		ufbx_assert(0 && "Bad interpolation mode");
+		return 0.0f;
+
+	}
+}
+
+#define ufbxi_key_time(keys, stride, index) (*(const double*)((const char*)(keys) + (index) * (stride)))
+
+// Find the first key with `time > time` starting from the result of a previous search `hint`.
+// Keyframe types must start with a `double time` field. Moving forward from `hint` is
+// found in constant time if the keys are close, otherwise using an exponential search.
+static ufbxi_noinline size_t ufbxi_find_key_index_hint(const void *keys, size_t stride, size_t count, size_t hint, double time)
+{
+	size_t begin = 0, end = count;
+	if (hint > count) hint = count;
+
+	if (hint > 0 && !(ufbxi_key_time(keys, stride, hint - 1) <= time)) {
+		end = hint - 1;
+	} else {
+		begin = hint;
+		size_t step = 1;
+		for (;;) {
+			if (begin >= count) return count;
+			if (!(ufbxi_key_time(keys, stride, begin) <= time)) return begin;
+
+			size_t probe = begin + step;
+			if (probe >= count) {
+				begin = begin + 1;
+				break;
+			} else if (ufbxi_key_time(keys, stride, probe) <= time) {
+				begin = probe + 1;
+				step *= 2;
+			} else {
+				begin = begin + 1;
+				end = probe;
+				break;
+			}
+		}
+	}
+
+	while (begin < end) {
+		size_t mid = begin + ((end - begin) >> 1);
+		if (ufbxi_key_time(keys, stride, mid) <= time) {
+			begin = mid + 1;
+		} else {
+			end = mid;
+		}
+	}
+	return begin;
+}
+
+// Solve `ufbxi_find_cubic_bezier_t()` for four segments at once.
+// Lanes that have converged keep their value so the results match the scalar version.
+#if UFBXI_HAS_SSE
+
+static ufbxi_noinline void ufbxi_find_cubic_bezier_t4(const double *p1, const double *p2, const double *x0, double *result)
+{
+	const __m128d one = _mm_set1_pd(1.0), two = _mm_set1_pd(2.0), three = _mm_set1_pd(3.0);
+	const __m128d eps = _mm_set1_pd(8.881784197001252e-16);
+	const __m128d abs_mask = _mm_castsi128_pd(_mm_set_epi32(0x7fffffff, -1, 0x7fffffff, -1));
+
+	__m128d a[2], b[2], c[2], a_3[2], b_2[2], px[2], t[2], x1[2], done[2];
+	for (size_t i = 0; i < 2; i++) {
+		__m128d p1_3 = _mm_mul_pd(_mm_loadu_pd(p1 + i * 2), three);
+		__m128d p2_3 = _mm_mul_pd(_mm_loadu_pd(p2 + i * 2), three);
+		a[i] = _mm_add_pd(_mm_sub_pd(p1_3, p2_3), one);
+		b[i] = _mm_sub_pd(_mm_sub_pd(p2_3, p1_3), p1_3);
+		c[i] = p1_3;
+		a_3[i] = _mm_mul_pd(three, a[i]);
+		b_2[i] = _mm_mul_pd(two, b[i]);
+		px[i] = _mm_loadu_pd(x0 + i * 2);
+		t[i] = px[i];
+	}
+
+	#define ufbxi_bezier_t4_step(m_t, m_x1, m_i) do { \
+			__m128d m_t2 = _mm_mul_pd(m_t, m_t), m_t3 = _mm_mul_pd(m_t2, m_t); \
+			m_x1 = _mm_sub_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(a[m_i], m_t3), _mm_mul_pd(b[m_i], m_t2)), _mm_mul_pd(c[m_i], m_t)), px[m_i]); \
+			__m128d m_dx = _mm_add_pd(_mm_add_pd(_mm_mul_pd(a_3[m_i], m_t2), _mm_mul_pd(b_2[m_i], m_t)), c[m_i]); \
+			m_t = _mm_sub_pd(m_t, _mm_div_pd(m_x1, m_dx)); \
+		} while (0)
+
+	for (size_t i = 0; i < 2; i++) {
+		ufbxi_bezier_t4_step(t[i], x1[i], i);
+		ufbxi_bezier_t4_step(t[i], x1[i], i);
+		ufbxi_bezier_t4_step(t[i], x1[i], i);
+		done[i] = _mm_cmple_pd(_mm_and_pd(x1[i], abs_mask), eps);
+	}
+
+	for (size_t iter = 0; iter < 4; iter++) {
+		if (_mm_movemask_pd(_mm_and_pd(done[0], done[1])) == 3) break;
+		for (size_t i = 0; i < 2; i++) {
+			__m128d nt = t[i], nx1;
+			ufbxi_bezier_t4_step(nt, nx1, i);
+			ufbxi_bezier_t4_step(nt, nx1, i);
+			t[i] = _mm_or_pd(_mm_and_pd(done[i], t[i]), _mm_andnot_pd(done[i], nt));
+			done[i] = _mm_or_pd(done[i], _mm_cmple_pd(_mm_and_pd(nx1, abs_mask), eps));
+		}
+	}
+
+	#undef ufbxi_bezier_t4_step
+
+	_mm_storeu_pd(result + 0, t[0]);
+	_mm_storeu_pd(result + 2, t[1]);
+}
+
+#else
+
+static ufbxi_noinline void ufbxi_find_cubic_bezier_t4(const double *p1, const double *p2, const double *x0, double *result)
+{
+	for (size_t i = 0; i < 4; i++) {
+		result[i] = ufbxi_find_cubic_bezier_t(p1[i], p2[i], x0[i]);
+	}
+}
+
+#endif
+
+// Collects cubic segments from multiple curve evaluations into structure-of-arrays
+// lanes of four, so that the Bezier time can be solved with `ufbxi_find_cubic_bezier_t4()`.
+typedef struct {
+	double p1[4], p2[4], x0[4];
+	const ufbx_keyframe *prev[4];
+	ufbx_real *dst[4];
+	size_t num_lanes;
+} ufbxi_cubic_batch;
+
+static ufbxi_noinline void ufbxi_cubic_batch_flush(ufbxi_cubic_batch *batch)
+{
+	size_t num_lanes = batch->num_lanes;
+	if (num_lanes == 0) return;
+
+	for (size_t i = num_lanes; i < 4; i++) {
+		batch->p1[i] = batch->p1[0];
+		batch->p2[i] = batch->p2[0];
+		batch->x0[i] = batch->x0[0];
+	}
+
+	double t[4];
+	ufbxi_find_cubic_bezier_t4(batch->p1, batch->p2, batch->x0, t);
+	for (size_t i = 0; i < num_lanes; i++) {
+		*batch->dst[i] = ufbxi_evaluate_cubic_bezier(batch->prev[i], t[i]);
+	}
+	batch->num_lanes = 0;
+}
+
+// Equivalent to `*dst = ufbxi_evaluate_keyframes(keys, count, index, time)` but cubic
+// segments are deferred until `ufbxi_cubic_batch_flush()`.
+static ufbxi_forceinline void ufbxi_cubic_batch_evaluate(ufbxi_cubic_batch *batch, const ufbx_keyframe *keys, size_t count, size_t index, double time, ufbx_real *dst)
+{
+	const ufbx_keyframe *prev = index > 0 && index < count ? &keys[index - 1] : NULL;
+	if (!prev || prev->interpolation != UFBX_INTERPOLATION_CUBIC || prev->time == time) {
+		*dst = ufbxi_evaluate_keyframes(keys, count, index, time);
+		return;
+	}
+
+	const ufbx_keyframe *next = prev + 1;
+	double rcp_delta = 1.0 / (next->time - prev->time);
+
+	size_t lane = batch->num_lanes;
+	batch->p1[lane] = prev->right.dx * rcp_delta;
+	batch->p2[lane] = 1.0 - next->left.dx * rcp_delta;
+	batch->x0[lane] = (time - prev->time) * rcp_delta;
+	batch->prev[lane] = prev;
+	batch->dst[lane] = dst;
+	if (++batch->num_lanes == 4) {
+		ufbxi_cubic_batch_flush(batch);
+	}
+}
+
+// Evaluate `keys[]` at multiple `times[]`, fastest if the times are increasing.
+static ufbxi_noinline void ufbxi_evaluate_keyframes_batch(const ufbx_keyframe *keys, size_t count, const double *times, ufbx_real *values, size_t num_samples)
+{
+	ufbxi_cubic_batch batch;
+	batch.num_lanes = 0;
+
+	size_t index = 0;
+	for (size_t i = 0; i < num_samples; i++) {
+		double time = times[i];
+		index = ufbxi_find_key_index_hint(keys, sizeof(ufbx_keyframe), count, index, time);
+		ufbxi_cubic_batch_evaluate(&batch, keys, count, index, time, &values[i]);
+	}
+	ufbxi_cubic_batch_flush(&batch);
+}
+
+#if UFBXI_FEATURE_SKINNING_EVALUATION
+
+static ufbxi_noinline void ufbxi_skin_vertices(ufbx_mesh *mesh, ufbx_vec3 *result_pos)
+{
+	size_t num_vertices = mesh->num_vertices;
+	memcpy(result_pos, mesh->vertices.data, num_vertices * sizeof(ufbx_vec3));
+
+	ufbxi_for_ptr_list(ufbx_blend_deformer, p_blend, mesh->blend_deformers) {
+		ufbx_add_blend_vertex_offsets(*p_blend, result_pos, num_vertices, 1.0f);
+	}
+
+	// TODO: What should we do about multiple skins??
+	if (mesh->skin_deformers.count > 0) {
+		ufbx_matrix *fallback = mesh->instances.count > 0 ? &mesh->instances.data[0]->geometry_to_world : NULL;
+		ufbx_skin_deformer *skin = mesh->skin_deformers.data[0];
+		for (size_t i = 0; i < num_vertices; i++) {
+			ufbx_matrix mat = ufbx_get_skin_vertex_matrix(skin, i, fallback);
+			result_pos[i] = ufbx_transform_position(&mat, result_pos[i]);
+		}
+
+		mesh->skinned_is_local = false;
+	}
+}
+
+// Re-evaluate skinning of `mesh` in place, reusing the buffers allocated by `ufbxi_evaluate_skinning()`.
+// `cached_normals` should be set if the normals were read from a geometry cache.
+static ufbxi_noinline void ufbxi_update_skinning(ufbx_mesh *mesh, bool skinned_is_local, bool cached_normals,
+	double time, bool load_caches, ufbx_geometry_cache_data_opts *cache_opts)
+{
+	size_t num_vertices = mesh->num_vertices;
+	ufbx_vec3 *result_pos = (ufbx_vec3*)mesh->skinned_position.values.data;
+	mesh->skinned_is_local = skinned_is_local;
+
+	bool cached_position = false;
+	if (load_caches && mesh->cache_deformers.count > 0) {
+		bool sampled_normals = false;
+		ufbxi_for_ptr_list(ufbx_cache_deformer, p_cache, mesh->cache_deformers) {
+			ufbx_cache_channel *channel = (*p_cache)->external_channel;
+			if (!channel) continue;
+
+			if ((channel->interpretation == UFBX_CACHE_INTERPRETATION_VERTEX_POSITION || channel->interpretation == UFBX_CACHE_INTERPRETATION_POINTS) && !cached_position) {
+				size_t num_read = ufbx_sample_geometry_cache_vec3(channel, time, result_pos, num_vertices, cache_opts);
+				if (num_read == num_vertices) {
+					mesh->skinned_is_local = true;
+					cached_position = true;
+				}
+			} else if (channel->interpretation == UFBX_CACHE_INTERPRETATION_VERTEX_NORMAL && cached_normals && !sampled_normals) {
+				ufbx_vec3 *normal_data = (ufbx_vec3*)mesh->skinned_normal.values.data;
+				ufbx_sample_geometry_cache_vec3(channel, time, normal_data, mesh->skinned_normal.values.count, cache_opts);
+				sampled_normals = true;
+			}
+		}
+	}
+
+	if (!cached_position) {
+		ufbxi_skin_vertices(mesh, result_pos);
+	}
+
+	if (!cached_normals) {
+		ufbx_vec3 *normal_data = (ufbx_vec3*)mesh->skinned_normal.values.data;
+		ufbx_compute_normals(mesh, &mesh->skinned_position, mesh->skinned_normal.indices.data, mesh->skinned_normal.indices.count,
+			normal_data, mesh->skinned_normal.values.count);
+	}
+}
+
+// Re-skin only the vertices affected by clusters flagged in `cluster_changed[]`,
+// normals are still recomputed for the whole mesh if anything moved.
+static ufbxi_noinline void ufbxi_update_skinning_incremental(ufbx_mesh *mesh, bool cached_normals, uint32_t *changed_clusters, const bool *cluster_changed)
+{
+	ufbx_skin_deformer *skin = mesh->skin_deformers.data[0];
+	size_t num_changed = 0;
+	for (size_t i = 0; i < skin->clusters.count; i++) {
+		if (cluster_changed[skin->clusters.data[i]->typed_id]) {
+			changed_clusters[num_changed++] = (uint32_t)i;
+		}
+	}
+	if (num_changed == 0) return;
+
+	ufbx_vec3 *result_pos = (ufbx_vec3*)mesh->skinned_position.values.data;
+	ufbx_matrix *fallback = mesh->instances.count > 0 ? &mesh->instances.data[0]->geometry_to_world : NULL;
+	ufbx_update_skin_vertices(skin, changed_clusters, num_changed, mesh->vertices.data, result_pos, mesh->num_vertices, fallback);
+
+	if (!cached_normals) {
+		ufbx_vec3 *normal_data = (ufbx_vec3*)mesh->skinned_normal.values.data;
+		ufbx_compute_normals(mesh, &mesh->skinned_position, mesh->skinned_normal.indices.data, mesh->skinned_normal.indices.count,
+			normal_data, mesh->skinned_normal.values.count);
+	}
+}
+
+#endif
+
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_evaluate_skinning(ufbx_scene *scene, ufbx_error *error, ufbxi_buf *buf_result, ufbxi_buf *buf_tmp,
+	double time, bool load_caches, ufbx_geometry_cache_data_opts *cache_opts)
+{
+#if UFBXI_FEATURE_SKINNING_EVALUATION
+	size_t max_skinned_indices = 0;
+
+	ufbxi_for_ptr_list(ufbx_mesh, p_mesh, scene->meshes) {
+		ufbx_mesh *mesh = *p_mesh;
+		if (mesh->blend_deformers.count == 0 && mesh->skin_deformers.count == 0 && (mesh->cache_deformers.count == 0 || !load_caches)) continue;
+		max_skinned_indices = ufbxi_max_sz(max_skinned_indices, mesh->num_indices);
+	}
+
+	ufbx_topo_edge *topo = ufbxi_push(buf_tmp, ufbx_topo_edge, max_skinned_indices);
+	ufbxi_check_err(error, topo);
+
+	ufbxi_for_ptr_list(ufbx_mesh, p_mesh, scene->meshes) {
 		ufbx_mesh *mesh = *p_mesh;
 		if (mesh->blend_deformers.count == 0 && mesh->skin_deformers.count == 0 && (mesh->cache_deformers.count == 0 || !load_caches)) continue;
 		if (mesh->num_vertices == 0) continue;
@@ -23635,23 +24845,7 @@ ufbxi_nodiscard static ufbxi_noinline int ufbxi_evaluate_skinning(ufbx_scene *sc
 		}
 
 		if (!cached_position) {
-			memcpy(result_pos, mesh->vertices.data, num_vertices * sizeof(ufbx_vec3));
-
-			ufbxi_for_ptr_list(ufbx_blend_deformer, p_blend, mesh->blend_deformers) {
-				ufbx_add_blend_vertex_offsets(*p_blend, result_pos, num_vertices, 1.0f);
-			}
-
-			// TODO: What should we do about multiple skins??
-			if (mesh->skin_deformers.count > 0) {
-				ufbx_matrix *fallback = mesh->instances.count > 0 ? &mesh->instances.data[0]->geometry_to_world : NULL;
-				ufbx_skin_deformer *skin = mesh->skin_deformers.data[0];
-				for (size_t i = 0; i < num_vertices; i++) {
-					ufbx_matrix mat = ufbx_get_skin_vertex_matrix(skin, i, fallback);
-					result_pos[i] = ufbx_transform_position(&mat, result_pos[i]);
-				}
-
-				mesh->skinned_is_local = false;
-			}
+			ufbxi_skin_vertices(mesh, result_pos);
 		}
 
 		mesh->skinned_position.values.data = result_pos;
@@ -23661,8 +24855,12 @@ ufbxi_nodiscard static ufbxi_noinline int ufbxi_evaluate_skinning(ufbx_scene *sc
 			uint32_t *normal_indices = ufbxi_push(buf_result, uint32_t, num_indices);
 			ufbxi_check_err(error, normal_indices);
 
-			ufbx_compute_topology(mesh, topo, num_indices);
-			size_t num_normals = ufbx_generate_normal_mapping(mesh, topo, num_indices, normal_indices, num_indices, false);
+			const ufbx_topo_edge *mesh_topo = mesh->topology.data;
+			if (mesh->topology.count != num_indices) {
+				ufbxi_check_err(error, ufbxi_compute_topology_imp(mesh, topo, buf_tmp, NULL, error));
+				mesh_topo = topo;
+			}
+			size_t num_normals = ufbx_generate_normal_mapping(mesh, mesh_topo, num_indices, normal_indices, num_indices, false);
 
 			if (num_normals == mesh->num_vertices) {
 				mesh->skinned_normal.unique_per_vertex = true;
@@ -23727,19 +24925,62 @@ ufbxi_nodiscard static ufbxi_noinline int ufbxi_resolve_warning_elements(ufbxi_c
 	return 1;
 }
 
+// Temporary data is released as soon as the phase using it has finished to
+// keep the peak memory usage down, `ufbxi_free_temp()` frees the rest.
+static ufbxi_noinline void ufbxi_free_parse_temp(ufbxi_context *uc)
+{
+	ufbxi_map_free(&uc->prop_type_map);
+	ufbxi_map_free(&uc->anim_stack_map);
+	ufbxi_map_free(&uc->dom_node_map);
+
+	for (size_t i = 0; i < UFBX_THREAD_GROUP_COUNT; i++) {
+		ufbxi_buf_free(&uc->tmp_thread_parse[i]);
+	}
+	ufbxi_buf_free(&uc->tmp_dom_nodes);
+	ufbxi_buf_free(&uc->tmp_ascii_spans);
+
+	ufbxi_free(&uc->ator_tmp, ufbxi_node, uc->top_nodes, uc->top_nodes_cap);
+	uc->top_nodes = NULL;
+	uc->top_nodes_cap = 0;
+
+	ufbxi_free(&uc->ator_tmp, char, uc->ascii.token.str_data, uc->ascii.token.str_cap);
+	ufbxi_free(&uc->ator_tmp, char, uc->ascii.prev_token.str_data, uc->ascii.prev_token.str_cap);
+	uc->ascii.token.str_data = uc->ascii.prev_token.str_data = NULL;
+	uc->ascii.token.str_cap = uc->ascii.prev_token.str_cap = 0;
+}
+
+static ufbxi_noinline void ufbxi_free_finalize_temp(ufbxi_context *uc)
+{
+	ufbxi_map_free(&uc->fbx_id_map);
+	ufbxi_map_free(&uc->texture_file_map);
+
+	ufbxi_buf_free(&uc->tmp_parse);
+	ufbxi_buf_free(&uc->tmp_mesh_textures);
+	ufbxi_buf_free(&uc->tmp_full_weights);
+
+	ufbxi_free(&uc->ator_tmp, void*, uc->element_extra_arr, uc->element_extra_cap);
+	uc->element_extra_arr = NULL;
+	uc->element_extra_cap = 0;
+}
+
+#if UFBXI_FEATURE_SCENE_SNAPSHOT
+static ufbxi_noinline ufbxi_scene_imp *ufbxi_compact_scene(ufbxi_context *uc);
+#endif
+
 ufbxi_nodiscard static ufbxi_noinline int ufbxi_load_imp(ufbxi_context *uc)
 {
 	// `ufbx_load_opts` must be cleared to zero first!
 	ufbx_assert(uc->opts._begin_zero == 0 && uc->opts._end_zero == 0);
 	ufbxi_check_msg(uc->opts._begin_zero == 0 && uc->opts._end_zero == 0, "Uninitialized options");
 	ufbxi_check(uc->opts.path_separator >= 0x20 && uc->opts.path_separator <= 0x7e);
+	ufbxi_check_msg(!uc->opts.load_context || uc->load_context, "Load context in use");
 
 	ufbxi_check(ufbxi_fixup_opts_string(uc, &uc->opts.filename, false));
 	ufbxi_check(ufbxi_fixup_opts_string(uc, &uc->opts.obj_mtl_path, true));
 	ufbxi_check(ufbxi_fixup_opts_string(uc, &uc->opts.geometry_transform_helper_name, true));
 	ufbxi_check(ufbxi_fixup_opts_string(uc, &uc->opts.scale_helper_name, true));
 
-	ufbxi_check(ufbxi_thread_pool_init(&uc->thread_pool, &uc->error, &uc->ator_tmp, &uc->opts.thread_opts));
+	ufbxi_check(ufbxi_thread_pool_init(&uc->thread_pool, &uc->error, &uc->ator_tmp, &uc->opts.thread_opts, &uc->opts.trace_cb));
 
 	if (!uc->opts.allow_unsafe) {
 		ufbxi_check_msg(uc->opts.index_error_handling != UFBX_INDEX_ERROR_HANDLING_UNSAFE_IGNORE, "Unsafe options");
@@ -23760,6 +25001,9 @@ ufbxi_nodiscard static ufbxi_noinline int ufbxi_load_imp(ufbxi_context *uc)
 
 	uc->unit_scale = 1.0f;
 
+	ufbxi_stats_start(uc);
+	ufbxi_trace_begin(&uc->tracer, ufbxi_load_phase_names[UFBX_LOAD_PHASE_PARSE]);
+
 	ufbxi_check(ufbxi_load_strings(uc));
 	ufbxi_check(ufbxi_load_maps(uc));
 	ufbxi_check(ufbxi_determine_format(uc));
@@ -23791,12 +25035,16 @@ ufbxi_nodiscard static ufbxi_noinline int ufbxi_load_imp(ufbxi_context *uc)
 		uc->scene.dom_root = dom_root;
 	}
 
+	ufbxi_free_parse_temp(uc);
+
+	ufbx_load_phase finalize_prev_phase = ufbxi_phase_begin(uc, UFBX_LOAD_PHASE_FINALIZE);
 	ufbxi_check(ufbxi_pre_finalize_scene(uc));
 
 	// We can free `tmp_parse` already here as all parsing is done by now.
 	ufbxi_buf_free(&uc->tmp_parse);
 
 	ufbxi_check(ufbxi_finalize_scene(uc));
+	ufbxi_free_finalize_temp(uc);
 
 	ufbxi_update_scene_settings(&uc->scene.settings);
 
@@ -23816,7 +25064,11 @@ ufbxi_nodiscard static ufbxi_noinline int ufbxi_load_imp(ufbxi_context *uc)
 	ufbxi_check(ufbxi_modify_geometry(uc));
 	ufbxi_postprocess_scene(uc);
 
-	ufbxi_update_scene(&uc->scene, true, NULL, 0);
+	ufbxi_check(ufbxi_update_scene(&uc->scene, true, NULL, 0, &uc->error, &uc->thread_pool));
+
+	if (uc->opts.store_triangle_indices) {
+		ufbxi_check(ufbxi_store_triangle_indices(uc));
+	}
 
 	// Force a non-NULL anim pointer
 	if (!uc->scene.anim) {
@@ -23824,15 +25076,19 @@ ufbxi_nodiscard static ufbxi_noinline int ufbxi_load_imp(ufbxi_context *uc)
 	}
 
 	if (uc->opts.load_external_files) {
+		ufbx_load_phase prev_phase = ufbxi_phase_begin(uc, UFBX_LOAD_PHASE_CACHES);
 		ufbxi_check(ufbxi_load_external_files(uc));
+		ufbxi_phase_end(uc, prev_phase);
 	}
 
 	// Evaluate skinning if requested
 	if (uc->opts.evaluate_skinning) {
+		ufbx_load_phase prev_phase = ufbxi_phase_begin(uc, UFBX_LOAD_PHASE_SKINNING);
 		ufbx_geometry_cache_data_opts cache_opts = { 0 };
 		cache_opts.open_file_cb = uc->opts.open_file_cb;
 		ufbxi_check(ufbxi_evaluate_skinning(&uc->scene, &uc->error, &uc->result, &uc->tmp,
 			0.0, uc->opts.load_external_files && uc->opts.evaluate_caches, &cache_opts));
+		ufbxi_phase_end(uc, prev_phase);
 	}
 
 	// Pop warnings to metadata
@@ -23847,17 +25103,31 @@ ufbxi_nodiscard static ufbxi_noinline int ufbxi_load_imp(ufbxi_context *uc)
 	uc->scene.metadata.animation_ignored = uc->opts.ignore_animation;
 	uc->scene.metadata.embedded_ignored = uc->opts.ignore_embedded;
 
+	ufbxi_phase_end(uc, finalize_prev_phase);
+	ufbxi_trace_end(&uc->tracer);
+	ufbxi_stats_finish(uc);
+
 	// Retain the scene, this must be the final allocation as we copy
 	// `ator_result` to `ufbx_scene_imp`.
-	ufbxi_scene_imp *imp = ufbxi_push(&uc->result, ufbxi_scene_imp, 1);
-	ufbxi_check(imp);
+	ufbxi_scene_imp *imp = NULL;
+#if UFBXI_FEATURE_SCENE_SNAPSHOT
+	if (uc->opts.compact_result) {
+		imp = ufbxi_compact_scene(uc);
+		ufbxi_check(imp);
+	}
+#endif
+	if (!imp) {
+		imp = ufbxi_push(&uc->result, ufbxi_scene_imp, 1);
+		ufbxi_check(imp);
+		imp->scene = uc->scene;
+	}
 
 	ufbxi_init_ref(&imp->refcount, UFBXI_SCENE_IMP_MAGIC, NULL);
 
 	imp->magic = UFBXI_SCENE_IMP_MAGIC;
-	imp->scene = uc->scene;
 	imp->refcount.ator = uc->ator_result;
 	imp->refcount.ator.error = NULL;
+	imp->refcount.ator.usage = NULL;
 
 	// Copy retained buffers and translate the allocator struct to the one
 	// contained within `ufbxi_scene_imp`
@@ -23865,11 +25135,14 @@ ufbxi_nodiscard static ufbxi_noinline int ufbxi_load_imp(ufbxi_context *uc)
 	imp->refcount.buf.ator = &imp->refcount.ator;
 	imp->string_buf = uc->string_pool.buf;
 	imp->string_buf.ator = &imp->refcount.ator;
+	imp->eval_partition = NULL;
 
 	imp->scene.metadata.result_memory_used = imp->refcount.ator.current_size;
 	imp->scene.metadata.temp_memory_used = uc->ator_tmp.current_size;
 	imp->scene.metadata.result_allocs = imp->refcount.ator.num_allocs;
 	imp->scene.metadata.temp_allocs = uc->ator_tmp.num_allocs;
+	imp->scene.metadata.temp_memory_peak = uc->ator_tmp.peak_size;
+	imp->scene.metadata.memory_peak = uc->memory_usage.peak_size;
 
 	ufbxi_for_ptr_list(ufbx_element, p_elem, imp->scene.elements) {
 		(*p_elem)->scene = &imp->scene;
@@ -23971,6 +25244,23 @@ static ufbxi_noinline ufbx_scene *ufbxi_load(ufbxi_context *uc, const ufbx_load_
 
 	ufbxi_init_ator(&uc->error, &uc->ator_tmp, &uc->opts.temp_allocator, "temp");
 	ufbxi_init_ator(&uc->error, &uc->ator_result, &uc->opts.result_allocator, "result");
+	uc->ator_tmp.usage = &uc->memory_usage;
+	uc->ator_result.usage = &uc->memory_usage;
+
+	// Serve temporary allocations from the load context, this must be done
+	// before anything is allocated as the memory is returned to the context.
+	if (uc->opts.load_context) {
+		ufbxi_load_context_imp *context_imp = ufbxi_get_imp(ufbxi_load_context_imp, uc->opts.load_context);
+		ufbx_assert(context_imp->magic == UFBXI_LOAD_CONTEXT_IMP_MAGIC);
+		if (context_imp->magic == UFBXI_LOAD_CONTEXT_IMP_MAGIC && !context_imp->in_use) {
+			context_imp->in_use = true;
+			uc->load_context = context_imp;
+			uc->ator_tmp.cache = &context_imp->cache;
+
+			// `ufbx_load_context_opts.allocator.allocation_limit` applies to each load
+			context_imp->refcount.ator.num_allocs = 0;
+		}
+	}
 
 	if (uc->opts.read_buffer_size == 0) {
 		uc->opts.read_buffer_size = 0x4000;
@@ -24060,10 +25350,22 @@ static ufbxi_noinline ufbx_scene *ufbxi_load(ufbxi_context *uc, const ufbx_load_
 	// cppcheck-suppress autoVariables
 	uc->inflate_retain = &inflate_retain;
 
+	ufbxi_trace_init(&uc->tracer, &uc->opts.trace_cb);
+	ufbxi_trace_begin(&uc->tracer, "ufbx_load");
+
 	int ok = ufbxi_load_imp(uc);
 
 	ufbxi_free_temp(uc);
 
+	ufbxi_trace_unwind(&uc->tracer);
+
+	if (uc->load_context) {
+		ufbxi_load_context_imp *context_imp = uc->load_context;
+		context_imp->in_use = false;
+		context_imp->context.num_loads++;
+		context_imp->context.cached_memory = context_imp->cache.cached_size;
+	}
+
 	if (uc->close_fn) {
 		uc->close_fn(uc->read_user);
 	}
@@ -24453,9 +25755,62 @@ typedef struct {
 
 	ufbx_scene scene;
 
+	ufbxi_tracer tracer;
+	ufbxi_thread_pool thread_pool;
+
 	ufbxi_scene_imp *scene_imp;
+	ufbxi_eval_partition *eval_partition;
 } ufbxi_eval_context;
 
+typedef struct {
+	uint32_t element_id;
+	uint32_t max_props;
+	uint32_t override_begin;
+	uint32_t num_overrides;
+} ufbxi_eval_props;
+
+typedef struct {
+	ufbx_mesh *mesh;
+	bool skinned_is_local;
+	bool cached_normals;
+
+	// Scratch space for `ufbx_update_skin_vertices()` if the mesh can be re-skinned
+	// incrementally, `NULL` if it needs to be fully re-evaluated.
+	uint32_t *changed_clusters;
+} ufbxi_eval_mesh;
+
+// Elements of an evaluated scene that depend on the animation, everything
+// else is left untouched by `ufbx_update_evaluated_scene()`.
+struct ufbxi_eval_partition {
+	ufbx_anim *anim;
+	ufbx_evaluate_opts opts;
+
+	// Elements with animated properties
+	ufbxi_eval_props *props;
+	size_t num_props;
+
+	// Nodes affected by animation in update order
+	ufbx_node **nodes;
+	size_t num_nodes;
+
+	// Animated non-node elements, materials are updated last
+	ufbx_element **elements;
+	size_t num_elements;
+	ufbx_material **materials;
+	size_t num_materials;
+	bool propagate_textures;
+
+	ufbx_skin_cluster **clusters;
+	size_t num_clusters;
+
+	// Indexed by `ufbx_skin_cluster.typed_id`, set during update if the
+	// cluster matrix changed from the previous evaluation.
+	bool *cluster_changed;
+
+	ufbxi_eval_mesh *meshes;
+	size_t num_meshes;
+};
+
 static ufbxi_forceinline ufbx_element *ufbxi_translate_element(ufbxi_eval_context *ec, void *elem)
 {
 	return elem ? (ufbx_element*)(ec->dst_element + ((char*)elem - ec->src_element)) : NULL;
@@ -24484,52 +25839,281 @@ ufbxi_nodiscard static ufbxi_noinline int ufbxi_translate_anim(ufbxi_eval_contex
 	return 1;
 }
 
-ufbxi_nodiscard static ufbxi_noinline int ufbxi_evaluate_imp(ufbxi_eval_context *ec)
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_copy_eval_string(ufbxi_eval_context *ec, ufbx_string *str)
 {
-	// `ufbx_evaluate_opts` must be cleared to zero first!
-	ufbx_assert(ec->opts._begin_zero == 0 && ec->opts._end_zero == 0);
-	ufbxi_check_err_msg(&ec->error, ec->opts._begin_zero == 0 && ec->opts._end_zero == 0, "Uninitialized options");
-
-	ec->scene = ec->src_scene;
-	size_t num_elements = ec->scene.elements.count;
+	if (str->length == 0) return 1;
 
-	char *element_data = (char*)ufbxi_push(&ec->result, uint64_t, ec->scene.metadata.element_buffer_size/8);
-	ufbxi_check_err(&ec->error, element_data);
+	// Known property names refer to `ufbxi_strings[]`, keep them as properties are
+	// looked up by pointer.
+	size_t ix = SIZE_MAX;
+	ufbxi_macro_lower_bound_eq(ufbx_string, 16, &ix, ufbxi_strings, 0, ufbxi_arraycount(ufbxi_strings),
+		( ufbxi_str_less(*a, *str) ), ( a->data == str->data ));
+	if (ix != SIZE_MAX) return 1;
 
-	ec->scene.elements.data = ufbxi_push(&ec->result, ufbx_element*, num_elements);
-	ufbxi_check_err(&ec->error, ec->scene.elements.data);
+	char *copy = ufbxi_push_copy(&ec->result, char, str->length + 1, str->data);
+	ufbxi_check_err(&ec->error, copy);
+	str->data = copy;
+	return 1;
+}
 
-	ec->src_element = (char*)ec->src_scene.elements.data[0];
-	ec->dst_element = element_data;
+// Copy the overrides of a custom `ufbx_anim` so the evaluated scene can be
+// updated with `ufbx_update_evaluated_scene()` after the animation is freed.
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_copy_anim_overrides(ufbxi_eval_context *ec, ufbx_anim *anim)
+{
+	anim->override_layer_weights.data = ufbxi_push_copy(&ec->result, ufbx_real, anim->override_layer_weights.count, anim->override_layer_weights.data);
+	anim->prop_overrides.data = ufbxi_push_copy(&ec->result, ufbx_prop_override, anim->prop_overrides.count, anim->prop_overrides.data);
+	anim->transform_overrides.data = ufbxi_push_copy(&ec->result, ufbx_transform_override, anim->transform_overrides.count, anim->transform_overrides.data);
+	ufbxi_check_err(&ec->error, anim->override_layer_weights.data && anim->prop_overrides.data && anim->transform_overrides.data);
 
-	for (size_t i = 0; i < UFBX_ELEMENT_TYPE_COUNT; i++) {
-		ec->scene.elements_by_type[i].data = ufbxi_push(&ec->result, ufbx_element*, ec->scene.elements_by_type[i].count);
-		ufbxi_check_err(&ec->error, ec->scene.elements_by_type[i].data);
+	// Property names are shared between consecutive overrides
+	ufbx_string prev_src = { NULL, 0 }, prev_dst = { NULL, 0 };
+	ufbxi_for_list(ufbx_prop_override, over, anim->prop_overrides) {
+		if (over->prop_name.data == prev_src.data) {
+			over->prop_name = prev_dst;
+		} else {
+			prev_src = over->prop_name;
+			ufbxi_check_err(&ec->error, ufbxi_copy_eval_string(ec, &over->prop_name));
+			prev_dst = over->prop_name;
+		}
+		ufbxi_check_err(&ec->error, ufbxi_copy_eval_string(ec, &over->value_str));
 	}
 
-	size_t num_connections = ec->scene.connections_dst.count;
-	ec->scene.connections_src.data = ufbxi_push(&ec->result, ufbx_connection, num_connections);
-	ec->scene.connections_dst.data = ufbxi_push(&ec->result, ufbx_connection, num_connections);
-	ufbxi_check_err(&ec->error, ec->scene.connections_src.data);
-	ufbxi_check_err(&ec->error, ec->scene.connections_dst.data);
-	for (size_t i = 0; i < num_connections; i++) {
-		ufbx_connection *src = &ec->scene.connections_src.data[i];
-		ufbx_connection *dst = &ec->scene.connections_dst.data[i];
-		*src = ec->src_scene.connections_src.data[i];
-		*dst = ec->src_scene.connections_dst.data[i];
-		src->src = ufbxi_translate_element(ec, src->src);
-		src->dst = ufbxi_translate_element(ec, src->dst);
-		dst->src = ufbxi_translate_element(ec, dst->src);
-		dst->dst = ufbxi_translate_element(ec, dst->dst);
-	}
+	return 1;
+}
 
-	ec->scene.elements_by_name.data = ufbxi_push(&ec->result, ufbx_name_element, num_elements);
-	ufbxi_check_err(&ec->error, ec->scene.elements_by_name.data);
+static ufbxi_forceinline bool ufbxi_is_dynamic_element(const bool *dynamic, const void *elem)
+{
+	return elem && dynamic[((const ufbx_element*)elem)->element_id];
+}
 
-	ec->scene.root_node = (ufbx_node*)ufbxi_translate_element(ec, ec->scene.root_node);
-	ufbxi_check_err(&ec->error, ufbxi_translate_anim(ec, &ec->scene.anim));
+static ufbxi_noinline bool ufbxi_is_dynamic_mesh(const bool *dynamic, const ufbx_mesh *mesh, bool load_caches)
+{
+	if (load_caches && mesh->cache_deformers.count > 0) return true;
 
-	for (size_t i = 0; i < num_elements; i++) {
+	ufbxi_for_ptr_list(ufbx_skin_deformer, p_skin, mesh->skin_deformers) {
+		ufbxi_for_ptr_list(ufbx_skin_cluster, p_cluster, (*p_skin)->clusters) {
+			if (ufbxi_is_dynamic_element(dynamic, *p_cluster)) return true;
+		}
+	}
+	if (mesh->skin_deformers.count > 0 && mesh->instances.count > 0) {
+		if (ufbxi_is_dynamic_element(dynamic, mesh->instances.data[0])) return true;
+	}
+
+	ufbxi_for_ptr_list(ufbx_blend_deformer, p_blend, mesh->blend_deformers) {
+		ufbxi_for_ptr_list(ufbx_blend_channel, p_channel, (*p_blend)->channels) {
+			if (ufbxi_is_dynamic_element(dynamic, *p_channel)) return true;
+		}
+	}
+
+	return false;
+}
+
+// Collect the elements that `ufbxi_evaluate_imp()` computed from the animation.
+// Must be called after evaluation as the skinning buffers are referenced.
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_build_eval_partition(ufbxi_eval_context *ec)
+{
+	ufbx_scene *scene = &ec->scene;
+	size_t num_elements = scene->elements.count;
+
+	ufbxi_eval_partition *part = ufbxi_push_zero(&ec->result, ufbxi_eval_partition, 1);
+	ufbxi_check_err(&ec->error, part);
+	part->anim = ec->anim;
+	part->opts = ec->opts;
+
+	bool *dynamic = ufbxi_push_zero(&ec->tmp, bool, num_elements);
+	ufbxi_eval_props *props = ufbxi_push(&ec->tmp, ufbxi_eval_props, num_elements);
+	ufbx_element **elements = ufbxi_push(&ec->tmp, ufbx_element*, num_elements);
+	ufbxi_check_err(&ec->error, dynamic && props && elements);
+
+	// Match the property buffers allocated in `ufbxi_evaluate_imp()`
+	const ufbx_prop_override *over = ec->anim->prop_overrides.data;
+	const ufbx_prop_override *over_begin = over, *over_end = ufbxi_add_ptr(over, ec->anim->prop_overrides.count);
+	size_t num_props = 0;
+	for (size_t i = 0; i < num_elements; i++) {
+		const ufbx_element *src = ec->src_scene.elements.data[i];
+		size_t num_override = 0;
+		while (over != over_end && over->element_id == src->element_id) {
+			num_override++;
+			over++;
+		}
+
+		size_t num_animated = src->props.num_animated + num_override;
+		if (num_animated == 0) continue;
+
+		ufbxi_eval_props *dst = &props[num_props++];
+		dst->element_id = src->element_id;
+		dst->max_props = (uint32_t)num_animated;
+		dst->override_begin = (uint32_t)(over - over_begin - (ptrdiff_t)num_override);
+		dst->num_overrides = (uint32_t)num_override;
+		dynamic[i] = true;
+	}
+
+	part->num_props = num_props;
+	part->props = ufbxi_push_copy(&ec->result, ufbxi_eval_props, num_props, props);
+	ufbxi_check_err(&ec->error, part->props);
+
+	// Propagate to descendants and other nodes that use the transform,
+	// iterate until fixed point as helper nodes may be ordered arbitrarily.
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		ufbxi_for_ptr_list(ufbx_node, p_node, scene->nodes) {
+			ufbx_node *node = *p_node;
+			if (dynamic[node->element_id]) continue;
+
+			bool dirty = ufbxi_is_dynamic_element(dynamic, node->inherit_scale_node);
+			ufbx_node *parent = node->parent;
+			if (parent) {
+				dirty = dirty || ufbxi_is_dynamic_element(dynamic, parent);
+				dirty = dirty || ufbxi_is_dynamic_element(dynamic, parent->scale_helper);
+				if (parent->inherit_scale_node) {
+					dirty = dirty || ufbxi_is_dynamic_element(dynamic, parent->inherit_scale_node->scale_helper);
+				}
+			}
+			if (dirty) {
+				dynamic[node->element_id] = true;
+				changed = true;
+			}
+		}
+	}
+
+	size_t num_nodes = 0;
+	ufbxi_for_ptr_list(ufbx_node, p_node, scene->nodes) {
+		if (dynamic[(*p_node)->element_id]) elements[num_nodes++] = &(*p_node)->element;
+	}
+	part->num_nodes = num_nodes;
+	part->nodes = (ufbx_node**)ufbxi_push_copy(&ec->result, ufbx_element*, num_nodes, elements);
+	ufbxi_check_err(&ec->error, part->nodes);
+
+	// Elements updated from their own properties in the order of `ufbxi_update_scene()`
+	static const ufbx_element_type update_types[] = {
+		UFBX_ELEMENT_LIGHT, UFBX_ELEMENT_CAMERA, UFBX_ELEMENT_BONE, UFBX_ELEMENT_LINE_CURVE,
+		UFBX_ELEMENT_BLEND_CHANNEL, UFBX_ELEMENT_TEXTURE, UFBX_ELEMENT_ANIM_STACK,
+		UFBX_ELEMENT_DISPLAY_LAYER, UFBX_ELEMENT_CONSTRAINT,
+	};
+
+	size_t num_updated = 0;
+	for (size_t type_ix = 0; type_ix < ufbxi_arraycount(update_types); type_ix++) {
+		ufbx_element_type type = update_types[type_ix];
+		ufbxi_for_ptr_list(ufbx_element, p_elem, scene->elements_by_type[type]) {
+			if (!dynamic[(*p_elem)->element_id]) continue;
+			elements[num_updated++] = *p_elem;
+			if (type == UFBX_ELEMENT_TEXTURE) part->propagate_textures = true;
+		}
+	}
+	part->num_elements = num_updated;
+	part->elements = ufbxi_push_copy(&ec->result, ufbx_element*, num_updated, elements);
+	ufbxi_check_err(&ec->error, part->elements);
+
+	size_t num_materials = 0;
+	ufbxi_for_ptr_list(ufbx_material, p_material, scene->materials) {
+		if (dynamic[(*p_material)->element.element_id]) elements[num_materials++] = &(*p_material)->element;
+	}
+	part->num_materials = num_materials;
+	part->materials = (ufbx_material**)ufbxi_push_copy(&ec->result, ufbx_element*, num_materials, elements);
+	ufbxi_check_err(&ec->error, part->materials);
+
+	size_t num_clusters = 0;
+	ufbxi_for_ptr_list(ufbx_skin_cluster, p_cluster, scene->skin_clusters) {
+		ufbx_skin_cluster *cluster = *p_cluster;
+		if (!ufbxi_is_dynamic_element(dynamic, cluster->bone_node)) continue;
+		dynamic[cluster->element.element_id] = true;
+		elements[num_clusters++] = &cluster->element;
+	}
+	part->num_clusters = num_clusters;
+	part->clusters = (ufbx_skin_cluster**)ufbxi_push_copy(&ec->result, ufbx_element*, num_clusters, elements);
+	ufbxi_check_err(&ec->error, part->clusters);
+	part->cluster_changed = ufbxi_push_zero(&ec->result, bool, scene->skin_clusters.count);
+	ufbxi_check_err(&ec->error, part->cluster_changed);
+
+	if (ec->opts.evaluate_skinning) {
+		bool load_caches = ec->opts.load_external_files && ec->opts.evaluate_caches;
+		ufbxi_eval_mesh *meshes = ufbxi_push(&ec->tmp, ufbxi_eval_mesh, scene->meshes.count);
+		ufbxi_check_err(&ec->error, meshes);
+
+		size_t num_meshes = 0;
+		ufbxi_for_ptr_list(ufbx_mesh, p_mesh, scene->meshes) {
+			ufbx_mesh *mesh = *p_mesh;
+			if (mesh->blend_deformers.count == 0 && mesh->skin_deformers.count == 0 && (mesh->cache_deformers.count == 0 || !load_caches)) continue;
+			if (mesh->num_vertices == 0) continue;
+			if (!ufbxi_is_dynamic_mesh(dynamic, mesh, load_caches)) continue;
+
+			// Generated normals always use new index buffers, cached ones keep the original indices.
+			const ufbx_mesh *src_mesh = ec->src_scene.meshes.data[mesh->typed_id];
+			ufbxi_eval_mesh *dst = &meshes[num_meshes++];
+			dst->mesh = mesh;
+			dst->skinned_is_local = src_mesh->skinned_is_local;
+			dst->cached_normals = mesh->skinned_normal.indices.data == src_mesh->skinned_normal.indices.data;
+			dst->changed_clusters = NULL;
+
+			// Meshes deformed only by a skin can be re-skinned one cluster at a time
+			bool incremental = mesh->skin_deformers.count > 0 && mesh->blend_deformers.count == 0;
+			if (load_caches && mesh->cache_deformers.count > 0) incremental = false;
+			if (mesh->instances.count > 0 && ufbxi_is_dynamic_element(dynamic, mesh->instances.data[0])) incremental = false;
+			if (incremental) {
+				dst->changed_clusters = ufbxi_push(&ec->result, uint32_t, mesh->skin_deformers.data[0]->clusters.count);
+				ufbxi_check_err(&ec->error, dst->changed_clusters);
+			}
+		}
+
+		part->num_meshes = num_meshes;
+		part->meshes = ufbxi_push_copy(&ec->result, ufbxi_eval_mesh, num_meshes, meshes);
+		ufbxi_check_err(&ec->error, part->meshes);
+	}
+
+	ec->eval_partition = part;
+
+	return 1;
+}
+
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_evaluate_imp(ufbxi_eval_context *ec)
+{
+	// `ufbx_evaluate_opts` must be cleared to zero first!
+	ufbx_assert(ec->opts._begin_zero == 0 && ec->opts._end_zero == 0);
+	ufbxi_check_err_msg(&ec->error, ec->opts._begin_zero == 0 && ec->opts._end_zero == 0, "Uninitialized options");
+
+	ufbxi_trace_begin(&ec->tracer, "copy_scene");
+
+	ec->scene = ec->src_scene;
+	size_t num_elements = ec->scene.elements.count;
+
+	char *element_data = (char*)ufbxi_push(&ec->result, uint64_t, ec->scene.metadata.element_buffer_size/8);
+	ufbxi_check_err(&ec->error, element_data);
+
+	ec->scene.elements.data = ufbxi_push(&ec->result, ufbx_element*, num_elements);
+	ufbxi_check_err(&ec->error, ec->scene.elements.data);
+
+	ec->src_element = (char*)ec->src_scene.elements.data[0];
+	ec->dst_element = element_data;
+
+	for (size_t i = 0; i < UFBX_ELEMENT_TYPE_COUNT; i++) {
+		ec->scene.elements_by_type[i].data = ufbxi_push(&ec->result, ufbx_element*, ec->scene.elements_by_type[i].count);
+		ufbxi_check_err(&ec->error, ec->scene.elements_by_type[i].data);
+	}
+
+	size_t num_connections = ec->scene.connections_dst.count;
+	ec->scene.connections_src.data = ufbxi_push(&ec->result, ufbx_connection, num_connections);
+	ec->scene.connections_dst.data = ufbxi_push(&ec->result, ufbx_connection, num_connections);
+	ufbxi_check_err(&ec->error, ec->scene.connections_src.data);
+	ufbxi_check_err(&ec->error, ec->scene.connections_dst.data);
+	for (size_t i = 0; i < num_connections; i++) {
+		ufbx_connection *src = &ec->scene.connections_src.data[i];
+		ufbx_connection *dst = &ec->scene.connections_dst.data[i];
+		*src = ec->src_scene.connections_src.data[i];
+		*dst = ec->src_scene.connections_dst.data[i];
+		src->src = ufbxi_translate_element(ec, src->src);
+		src->dst = ufbxi_translate_element(ec, src->dst);
+		dst->src = ufbxi_translate_element(ec, dst->src);
+		dst->dst = ufbxi_translate_element(ec, dst->dst);
+	}
+
+	ec->scene.elements_by_name.data = ufbxi_push(&ec->result, ufbx_name_element, num_elements);
+	ufbxi_check_err(&ec->error, ec->scene.elements_by_name.data);
+
+	ec->scene.root_node = (ufbx_node*)ufbxi_translate_element(ec, ec->scene.root_node);
+	ufbxi_check_err(&ec->error, ufbxi_translate_anim(ec, &ec->scene.anim));
+
+	for (size_t i = 0; i < num_elements; i++) {
 		ufbx_element *src = ec->src_scene.elements.data[i];
 		ufbx_element *dst = ufbxi_translate_element(ec, src);
 		size_t size = ufbx_element_type_size[src->type];
@@ -24746,6 +26330,7 @@ ufbxi_nodiscard static ufbxi_noinline int ufbxi_evaluate_imp(ufbxi_eval_context
 	}
 
 	ufbxi_check_err(&ec->error, ufbxi_translate_anim(ec, &ec->anim));
+	ufbxi_check_err(&ec->error, ufbxi_copy_anim_overrides(ec, ec->anim));
 
 	ufbxi_for_ptr_list(ufbx_anim_value, p_value, ec->scene.anim_values) {
 		ufbx_anim_value *value = *p_value;
@@ -24754,10 +26339,13 @@ ufbxi_nodiscard static ufbxi_noinline int ufbxi_evaluate_imp(ufbxi_eval_context
 		value->curves[2] = (ufbx_anim_curve*)ufbxi_translate_element(ec, value->curves[2]);
 	}
 
+	ufbxi_trace_end(&ec->tracer);
+
 	ufbx_anim anim = *ec->anim;
 	ufbx_prop_override *over = anim.prop_overrides.data, *over_end = ufbxi_add_ptr(over, anim.prop_overrides.count);
 
 	// Evaluate the properties
+	ufbxi_trace_begin(&ec->tracer, "evaluate_props");
 	ufbxi_for_ptr_list(ufbx_element, p_elem, ec->scene.elements) {
 		ufbx_element *elem = *p_elem;
 		size_t num_animated = elem->props.num_animated;
@@ -24781,18 +26369,30 @@ ufbxi_nodiscard static ufbxi_noinline int ufbxi_evaluate_imp(ufbxi_eval_context
 		elem->props = ufbx_evaluate_props(&anim, elem, ec->time, props, num_animated);
 		elem->props.defaults = &ec->src_scene.elements.data[elem->element_id]->props;
 	}
+	ufbxi_trace_end(&ec->tracer);
 
 	// Update all derived values
-	ufbxi_update_scene(&ec->scene, false, anim.transform_overrides.data, anim.transform_overrides.count);
+	ufbxi_trace_begin(&ec->tracer, "update_scene");
+	if (ec->scene.nodes.count >= 2 * UFBXI_UPDATE_NODES_TASK_SIZE) {
+		ufbxi_check_err(&ec->error, ufbxi_thread_pool_init(&ec->thread_pool, &ec->error, &ec->ator_tmp, &ec->opts.thread_opts, &ec->opts.trace_cb));
+	}
+	ufbxi_check_err(&ec->error, ufbxi_update_scene(&ec->scene, false, anim.transform_overrides.data, anim.transform_overrides.count, &ec->error, &ec->thread_pool));
+	ufbxi_trace_end(&ec->tracer);
 
 	// Evaluate skinning if requested
 	if (ec->opts.evaluate_skinning) {
+		ufbxi_trace_begin(&ec->tracer, "skinning");
 		ufbx_geometry_cache_data_opts cache_opts = { 0 };
 		cache_opts.open_file_cb = ec->opts.open_file_cb;
 		ufbxi_check_err(&ec->error, ufbxi_evaluate_skinning(&ec->scene, &ec->error, &ec->result, &ec->tmp,
 			ec->time, ec->opts.load_external_files && ec->opts.evaluate_caches, &cache_opts));
+		ufbxi_trace_end(&ec->tracer);
 	}
 
+	ufbxi_trace_begin(&ec->tracer, "partition");
+	ufbxi_check_err(&ec->error, ufbxi_build_eval_partition(ec));
+	ufbxi_trace_end(&ec->tracer);
+
 	// Retain the scene, this must be the final allocation as we copy
 	// `ator_result` to `ufbx_scene_imp`.
 	ufbxi_scene_imp *imp = ufbxi_push_zero(&ec->result, ufbxi_scene_imp, 1);
@@ -24803,6 +26403,7 @@ ufbxi_nodiscard static ufbxi_noinline int ufbxi_evaluate_imp(ufbxi_eval_context
 
 	imp->magic = UFBXI_SCENE_IMP_MAGIC;
 	imp->scene = ec->scene;
+	imp->eval_partition = ec->eval_partition;
 	imp->refcount.ator = ec->ator_result;
 	imp->refcount.ator.error = NULL;
 
@@ -24848,7 +26449,15 @@ ufbxi_nodiscard static ufbxi_noinline ufbx_scene *ufbxi_evaluate_scene(ufbxi_eva
 	ec->result.unordered = true;
 	ec->tmp.unordered = true;
 
-	if (ufbxi_evaluate_imp(ec)) {
+	ufbxi_trace_init(&ec->tracer, &ec->opts.trace_cb);
+	ufbxi_trace_begin(&ec->tracer, "ufbx_evaluate_scene");
+	int ok = ufbxi_evaluate_imp(ec);
+	ufbxi_trace_unwind(&ec->tracer);
+
+	// Wait for all tasks before releasing them
+	ufbxi_thread_pool_free(&ec->thread_pool);
+
+	if (ok) {
 		ufbxi_buf_free(&ec->tmp);
 		ufbxi_free_ator(&ec->ator_tmp);
 		if (p_error) {
@@ -24866,6 +26475,77 @@ ufbxi_nodiscard static ufbxi_noinline ufbx_scene *ufbxi_evaluate_scene(ufbxi_eva
 	}
 }
 
+static ufbxi_noinline void ufbxi_update_evaluated_scene(ufbx_scene *scene, ufbxi_eval_partition *part, double time)
+{
+	ufbx_anim anim = *part->anim;
+	ufbx_prop_override *overrides = anim.prop_overrides.data;
+
+	for (size_t i = 0; i < part->num_props; i++) {
+		const ufbxi_eval_props *ep = &part->props[i];
+		ufbx_element *elem = scene->elements.data[ep->element_id];
+		ufbx_props *defaults = elem->props.defaults;
+		ufbx_prop *buffer = elem->props.props.data;
+
+		anim.prop_overrides.data = overrides + ep->override_begin;
+		anim.prop_overrides.count = ep->num_overrides;
+
+		// Evaluate on top of the original properties as in `ufbxi_evaluate_imp()`
+		elem->props = *defaults;
+		elem->props = ufbx_evaluate_props(&anim, elem, time, buffer, ep->max_props);
+		elem->props.defaults = defaults;
+	}
+
+	for (size_t i = 0; i < part->num_nodes; i++) {
+		ufbxi_update_node(part->nodes[i], anim.transform_overrides.data, anim.transform_overrides.count);
+	}
+
+	for (size_t i = 0; i < part->num_elements; i++) {
+		ufbx_element *elem = part->elements[i];
+		switch (elem->type) {
+		case UFBX_ELEMENT_LIGHT: ufbxi_update_light((ufbx_light*)elem); break;
+		case UFBX_ELEMENT_CAMERA: ufbxi_update_camera(scene, (ufbx_camera*)elem); break;
+		case UFBX_ELEMENT_BONE: ufbxi_update_bone(scene, (ufbx_bone*)elem); break;
+		case UFBX_ELEMENT_LINE_CURVE: ufbxi_update_line_curve((ufbx_line_curve*)elem); break;
+		case UFBX_ELEMENT_BLEND_CHANNEL: ufbxi_update_blend_channel((ufbx_blend_channel*)elem); break;
+		case UFBX_ELEMENT_TEXTURE: ufbxi_update_texture((ufbx_texture*)elem); break;
+		case UFBX_ELEMENT_ANIM_STACK: ufbxi_update_anim_stack(scene, (ufbx_anim_stack*)elem); break;
+		case UFBX_ELEMENT_DISPLAY_LAYER: ufbxi_update_display_layer((ufbx_display_layer*)elem); break;
+		case UFBX_ELEMENT_CONSTRAINT: ufbxi_update_constraint((ufbx_constraint*)elem); break;
+		default: ufbx_assert(0 && "Unexpected element type"); break;
+		}
+	}
+
+	if (part->propagate_textures) {
+		ufbxi_propagate_main_textures(scene);
+	}
+	for (size_t i = 0; i < part->num_materials; i++) {
+		ufbxi_update_material(scene, part->materials[i]);
+	}
+
+	for (size_t i = 0; i < part->num_clusters; i++) {
+		ufbx_skin_cluster *cluster = part->clusters[i];
+		ufbx_matrix prev = cluster->geometry_to_world;
+		ufbxi_update_skin_cluster(cluster);
+		part->cluster_changed[cluster->typed_id] = memcmp(&prev, &cluster->geometry_to_world, sizeof(ufbx_matrix)) != 0;
+	}
+
+#if UFBXI_FEATURE_SKINNING_EVALUATION
+	if (part->num_meshes > 0) {
+		bool load_caches = part->opts.load_external_files && part->opts.evaluate_caches;
+		ufbx_geometry_cache_data_opts cache_opts = { 0 };
+		cache_opts.open_file_cb = part->opts.open_file_cb;
+		for (size_t i = 0; i < part->num_meshes; i++) {
+			const ufbxi_eval_mesh *em = &part->meshes[i];
+			if (em->changed_clusters) {
+				ufbxi_update_skinning_incremental(em->mesh, em->cached_normals, em->changed_clusters, part->cluster_changed);
+			} else {
+				ufbxi_update_skinning(em->mesh, em->skinned_is_local, em->cached_normals, time, load_caches, &cache_opts);
+			}
+		}
+	}
+#endif
+}
+
 #endif
 
 typedef struct {
@@ -25095,6 +26775,8 @@ typedef struct {
 
 	ufbx_baked_anim bake;
 	ufbxi_baked_anim_imp *imp;
+
+	ufbxi_tracer tracer;
 } ufbxi_bake_context;
 
 typedef struct {
@@ -25642,11 +27324,38 @@ ufbxi_nodiscard static ufbxi_noinline int ufbxi_bake_anim_prop(ufbxi_bake_contex
 	name.data = prop_name;
 	name.length = strlen(prop_name);
 
-	for (size_t i = 0; i < times.count; i++) {
-		double time = times.data[i];
-		ufbx_prop prop = ufbx_evaluate_prop_len(bc->anim, element, name.data, name.length, time);
-		keys.data[i].time = time;
-		keys.data[i].value = prop.value_vec3;
+	// If a single layer animates the property directly the result is the animation value as-is,
+	// so all the times can be evaluated at once per curve instead of via `ufbx_evaluate_prop_len()`.
+	const ufbx_anim *anim = bc->anim;
+	const ufbx_prop *src_prop = ufbx_find_prop_len(&element->props, name.data, name.length);
+	bool direct = count == 1 && anim->layers.count == 1 && anim->prop_overrides.count == 0 && src_prop
+		&& (src_prop->flags & (UFBX_PROP_FLAG_ANIMATED|UFBX_PROP_FLAG_CONNECTED)) == UFBX_PROP_FLAG_ANIMATED
+		&& src_prop->name.data == props[0].prop_name && props[0].anim_value;
+
+	if (direct) {
+		const ufbx_anim_value *anim_value = props[0].anim_value;
+		ufbx_real *values = ufbxi_push(&bc->tmp_prop, ufbx_real, times.count);
+		ufbxi_check_err(&bc->error, values);
+
+		for (size_t i = 0; i < times.count; i++) {
+			keys.data[i].time = times.data[i];
+			keys.data[i].value = anim_value->default_value;
+		}
+		for (size_t axis = 0; axis < 3; axis++) {
+			const ufbx_anim_curve *curve = anim_value->curves[axis];
+			if (!curve) continue;
+			ufbx_evaluate_curve_samples(curve, times.data, values, times.count, anim_value->default_value.v[axis]);
+			for (size_t i = 0; i < times.count; i++) {
+				keys.data[i].value.v[axis] = values[i];
+			}
+		}
+	} else {
+		for (size_t i = 0; i < times.count; i++) {
+			double time = times.data[i];
+			ufbx_prop prop = ufbx_evaluate_prop_len(bc->anim, element, name.data, name.length, time);
+			keys.data[i].time = time;
+			keys.data[i].value = prop.value_vec3;
+		}
 	}
 
 	ufbx_baked_prop *baked_prop = ufbxi_push_zero(&bc->tmp_props, ufbx_baked_prop, 1);
@@ -25752,6 +27461,7 @@ ufbxi_nodiscard static ufbxi_noinline int ufbxi_bake_anim(ufbxi_bake_context *bc
 
 	// Pre-bake layer weight times
 	if (!bc->opts.ignore_layer_weight_animation) {
+		ufbxi_trace_begin(&bc->tracer, "bake_layer_weights");
 		bool has_weight_times = false;
 		ufbxi_for(ufbxi_bake_prop, prop, props, num_props) {
 			if (prop->prop_name != ufbxi_Weight) continue;
@@ -25772,8 +27482,10 @@ ufbxi_nodiscard static ufbxi_noinline int ufbxi_bake_anim(ufbxi_bake_context *bc
 
 			ufbxi_buf_clear(&bc->tmp_prop);
 		}
+		ufbxi_trace_end(&bc->tracer);
 	}
 
+	ufbxi_trace_begin(&bc->tracer, "bake_elements");
 	size_t begin = 0;
 	while (begin < num_props) {
 		uint32_t element_id = props[begin].element_id;
@@ -25784,6 +27496,7 @@ ufbxi_nodiscard static ufbxi_noinline int ufbxi_bake_anim(ufbxi_bake_context *bc
 		ufbxi_check_err(&bc->error, ufbxi_bake_element(bc, element_id, props + begin, end - begin));
 		begin = end;
 	}
+	ufbxi_trace_end(&bc->tracer);
 
 	size_t num_nodes = bc->tmp_nodes.num_items;
 	size_t num_elements = bc->tmp_elements.num_items;
@@ -25848,2542 +27561,7198 @@ ufbxi_nodiscard static ufbxi_noinline int ufbxi_bake_anim_imp(ufbxi_bake_context
 
 #endif
 
-// -- NURBS
-
-static ufbxi_forceinline ufbx_real ufbxi_nurbs_weight(const ufbx_real_list *knots, size_t knot, size_t degree, ufbx_real u)
-{
-	if (knot >= knots->count) return 0.0f;
-	if (knots->count - knot < degree) return 0.0f;
-	ufbx_real prev_u = knots->data[knot], next_u = knots->data[knot + degree];
-	if (prev_u >= next_u) return 0.0f;
-	if (u <= prev_u) return 0.0f;
-	if (u >= next_u) return 1.0f;
-	return (u - prev_u) / (next_u - prev_u);
-}
-
-static ufbxi_forceinline ufbx_real ufbxi_nurbs_deriv(const ufbx_real_list *knots, size_t knot, size_t degree)
-{
-	if (knot >= knots->count) return 0.0f;
-	if (knots->count - knot < degree) return 0.0f;
-	ufbx_real prev_u = knots->data[knot], next_u = knots->data[knot + degree];
-	if (prev_u >= next_u) return 0.0f;
-	return (ufbx_real)degree / (next_u - prev_u);
-}
+// -- Compressed animation
 
 typedef struct {
 	ufbxi_refcount refcount;
-	ufbx_line_curve curve;
+	ufbx_compressed_anim anim;
 	uint32_t magic;
-} ufbxi_line_curve_imp;
-
-ufbx_static_assert(line_curve_imp_offset, offsetof(ufbxi_line_curve_imp, curve) == sizeof(ufbxi_refcount));
-
-#if UFBXI_FEATURE_TESSELLATION
+} ufbxi_compressed_anim_imp;
 
 typedef struct {
 	ufbx_error error;
-
-	ufbx_tessellate_curve_opts opts;
-
-	const ufbx_nurbs_curve *curve;
-
-	ufbxi_allocator ator_tmp;
 	ufbxi_allocator ator_result;
-
 	ufbxi_buf result;
 
-	ufbx_line_curve line;
+	ufbx_compress_anim_opts opts;
+	const ufbx_baked_anim *bake;
 
-	ufbxi_line_curve_imp *imp;
+	ufbx_compressed_anim anim;
+	ufbxi_compressed_anim_imp *imp;
+} ufbxi_compress_anim_context;
 
-} ufbxi_tessellate_curve_context;
+// Smallest three components of an unit quaternion are within +-1/sqrt(2)
+#define UFBXI_QUAT_SMALLEST_MAX 0.70710678118654752440
+#define UFBXI_QUAT_SMALLEST_STEPS 32767.0
 
-typedef struct {
-	ufbx_error error;
+static ufbxi_forceinline uint16_t ufbxi_quantize_unorm(double value, double steps)
+{
+	return (uint16_t)(ufbx_fmin(ufbx_fmax(value, 0.0), 1.0) * steps + 0.5);
+}
 
-	ufbx_tessellate_surface_opts opts;
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_compress_key_times(ufbxi_compress_anim_context *cc, ufbx_compressed_track *track, const void *keys, size_t stride, size_t num_keys)
+{
+	ufbxi_check_err_msg(&cc->error, num_keys <= UINT32_MAX, "Too many keyframes");
+	track->num_keys = (uint32_t)num_keys;
 
-	const ufbx_nurbs_surface *surface;
+	double time_begin = ufbxi_key_time(keys, stride, 0);
+	double time_end = ufbxi_key_time(keys, stride, num_keys - 1);
+	double time_step = (time_end - time_begin) / (double)(num_keys - 1);
+	track->time_begin = time_begin;
 
-	ufbxi_allocator ator_tmp;
-	ufbxi_allocator ator_result;
+	double threshold = cc->opts.uniform_time_threshold;
+	bool uniform = threshold >= 0.0 && time_step > 0.0;
+	for (size_t i = 1; i < num_keys && uniform; i++) {
+		double time = ufbxi_key_time(keys, stride, i);
+		if (ufbx_fabs(time - (time_begin + (double)i * time_step)) > threshold) uniform = false;
+	}
 
-	ufbxi_buf tmp;
-	ufbxi_buf result;
+	if (uniform) {
+		track->time_step = time_step;
+		return 1;
+	}
 
-	ufbxi_map position_map;
+	// Single precision times are used only if the keys are far enough apart that the
+	// rounding does not affect the ordering or the interpolation too much.
+	bool precise = false;
+	for (size_t i = 1; i < num_keys; i++) {
+		double prev = ufbxi_key_time(keys, stride, i - 1) - time_begin;
+		double time = ufbxi_key_time(keys, stride, i) - time_begin;
+		if (!((time - prev) * 1048576.0 > time)) {
+			precise = true;
+			break;
+		}
+	}
 
-	ufbx_mesh mesh;
+	if (precise) {
+		double *times = ufbxi_push(&cc->result, double, num_keys);
+		ufbxi_check_err(&cc->error, times);
+		for (size_t i = 0; i < num_keys; i++) {
+			times[i] = ufbxi_key_time(keys, stride, i) - time_begin;
+		}
 
-	ufbxi_mesh_imp *imp;
+		track->precise_times.data = times;
+		track->precise_times.count = num_keys;
+		cc->anim.key_data_size += num_keys * sizeof(double);
+	} else {
+		float *times = ufbxi_push(&cc->result, float, num_keys);
+		ufbxi_check_err(&cc->error, times);
+		for (size_t i = 0; i < num_keys; i++) {
+			times[i] = (float)(ufbxi_key_time(keys, stride, i) - time_begin);
+		}
 
-} ufbxi_tessellate_surface_context;
+		track->times.data = times;
+		track->times.count = num_keys;
+		cc->anim.key_data_size += num_keys * sizeof(float);
+	}
 
-ufbxi_nodiscard static ufbxi_noinline int ufbxi_tessellate_nurbs_curve_imp(ufbxi_tessellate_curve_context *tc)
+	return 1;
+}
+
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_compress_vec3_track(ufbxi_compress_anim_context *cc, ufbx_compressed_track *track, ufbx_baked_vec3_list keys, ufbx_vec3 default_value)
 {
-	// `ufbx_tessellate_opts` must be cleared to zero first!
-	ufbx_assert(tc->opts._begin_zero == 0 && tc->opts._end_zero == 0);
-	ufbxi_check_err_msg(&tc->error, tc->opts._begin_zero == 0 && tc->opts._end_zero == 0, "Uninitialized options");
+	memset(track, 0, sizeof(ufbx_compressed_track));
 
-	if (tc->opts.span_subdivision <= 0) {
-		tc->opts.span_subdivision = 4;
+	ufbx_vec3 first = keys.count > 0 ? keys.data[0].value : default_value;
+	ufbx_vec3 min_value = first, max_value = first;
+	for (size_t i = 1; i < keys.count; i++) {
+		ufbx_vec3 v = keys.data[i].value;
+		for (size_t c = 0; c < 3; c++) {
+			min_value.v[c] = ufbxi_min_real(min_value.v[c], v.v[c]);
+			max_value.v[c] = ufbxi_max_real(max_value.v[c], v.v[c]);
+		}
 	}
-	size_t num_sub = tc->opts.span_subdivision;
-
-	const ufbx_nurbs_curve *curve = tc->curve;
-	ufbx_line_curve *line = &tc->line;
-	ufbxi_check_err_msg(&tc->error, curve->basis.valid && curve->control_points.count > 0, "Bad NURBS geometry");
 
-	ufbxi_init_ator(&tc->error, &tc->ator_tmp, &tc->opts.temp_allocator, "temp");
-	ufbxi_init_ator(&tc->error, &tc->ator_result, &tc->opts.result_allocator, "result");
+	ufbx_vec3 extent = ufbxi_sub3(max_value, min_value);
+	double threshold = cc->opts.constant_threshold;
+	bool constant = keys.count <= 1 || (ufbx_fmax(ufbx_fmax(first.x - min_value.x, max_value.x - first.x),
+		ufbx_fmax(ufbx_fmax(first.y - min_value.y, max_value.y - first.y), ufbx_fmax(first.z - min_value.z, max_value.z - first.z))) <= threshold);
+	if (constant) {
+		track->constant_value.x = first.x;
+		track->constant_value.y = first.y;
+		track->constant_value.z = first.z;
+		return 1;
+	}
 
-	tc->result.unordered = true;
-	tc->result.ator = &tc->ator_result;
+	ufbxi_check_err(&cc->error, ufbxi_compress_key_times(cc, track, keys.data, sizeof(ufbx_baked_vec3), keys.count));
 
-	size_t num_spans = curve->basis.spans.count;
+	uint16_t *values = ufbxi_push(&cc->result, uint16_t, keys.count * 3);
+	ufbxi_check_err(&cc->error, values);
 
-	// Check conservatively that we don't overflow anything
-	{
-		size_t over_spans = num_spans * 2 * sizeof(ufbx_real);
-		size_t over = over_spans * num_sub;
-		ufbxi_check_err(&tc->error, !ufbxi_does_overflow(over, over_spans, num_sub));
+	for (size_t i = 0; i < keys.count; i++) {
+		ufbx_vec3 v = keys.data[i].value;
+		for (size_t c = 0; c < 3; c++) {
+			double t = extent.v[c] > 0.0f ? (double)(v.v[c] - min_value.v[c]) / (double)extent.v[c] : 0.0;
+			values[i * 3 + c] = ufbxi_quantize_unorm(t, 65535.0);
+		}
 	}
 
-	bool is_open = curve->basis.topology == UFBX_NURBS_TOPOLOGY_OPEN;
+	track->values.data = values;
+	track->values.count = keys.count * 3;
+	track->range_min = min_value;
+	track->range_scale.x = extent.x / (ufbx_real)65535.0;
+	track->range_scale.y = extent.y / (ufbx_real)65535.0;
+	track->range_scale.z = extent.z / (ufbx_real)65535.0;
+	cc->anim.key_data_size += keys.count * 3 * sizeof(uint16_t);
+	return 1;
+}
 
-	size_t num_indices = num_spans + (num_spans - 1) * (num_sub - 1);
-	size_t num_vertices = num_indices - (is_open ? 0u : 1u);
-	ufbxi_check_err(&tc->error, num_indices <= INT32_MAX);
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_compress_quat_track(ufbxi_compress_anim_context *cc, ufbx_compressed_track *track, ufbx_baked_quat_list keys)
+{
+	memset(track, 0, sizeof(ufbx_compressed_track));
 
-	uint32_t *indices = ufbxi_push(&tc->result, uint32_t, num_indices);
-	ufbx_vec3 *vertices = ufbxi_push(&tc->result, ufbx_vec3, num_vertices);
-	ufbx_line_segment *segments = ufbxi_push(&tc->result, ufbx_line_segment, 1);
-	ufbxi_check_err(&tc->error, indices && vertices && segments);
+	ufbx_quat first = keys.count > 0 ? keys.data[0].value : ufbx_identity_quat;
+	double threshold = cc->opts.constant_threshold;
+	bool constant = true;
+	for (size_t i = 1; i < keys.count && constant; i++) {
+		ufbx_quat q = ufbx_quat_fix_antipodal(keys.data[i].value, first);
+		for (size_t c = 0; c < 4; c++) {
+			if (!(ufbx_fabs(q.v[c] - first.v[c]) <= threshold)) constant = false;
+		}
+	}
 
-	for (size_t span_ix = 0; span_ix < num_spans; span_ix++) {
-		size_t num_splits = span_ix + 1 == num_spans ? 1 : num_sub;
+	if (constant) {
+		track->constant_value.x = first.x;
+		track->constant_value.y = first.y;
+		track->constant_value.z = first.z;
+		track->constant_value.w = first.w;
+		return 1;
+	}
 
-		for (size_t sub_ix = 0; sub_ix < num_splits; sub_ix++) {
-			size_t ix = span_ix * num_sub + sub_ix;
+	ufbxi_check_err(&cc->error, ufbxi_compress_key_times(cc, track, keys.data, sizeof(ufbx_baked_quat), keys.count));
 
-			if (ix < num_vertices) {
-				ufbx_real u = curve->basis.spans.data[span_ix];
-				if (sub_ix > 0) {
-					ufbx_real t = (ufbx_real)sub_ix / (ufbx_real)num_sub;
-					u = u * (1.0f - t) + t * curve->basis.spans.data[span_ix + 1];
-				}
+	uint16_t *values = ufbxi_push(&cc->result, uint16_t, keys.count * 3);
+	ufbxi_check_err(&cc->error, values);
 
-				ufbx_curve_point point = ufbx_evaluate_nurbs_curve(curve, u);
-				vertices[ix] = point.position;
-				indices[ix] = (uint32_t)ix;
-			} else {
-				indices[ix] = 0;
-			}
+	for (size_t i = 0; i < keys.count; i++) {
+		ufbx_quat q = keys.data[i].value;
+		double len = ufbx_sqrt(q.x*q.x + q.y*q.y + q.z*q.z + q.w*q.w);
+		double rcp_len = len > 0.0 ? 1.0 / len : 0.0;
+
+		uint32_t largest = 0;
+		for (uint32_t c = 1; c < 4; c++) {
+			if (ufbx_fabs(q.v[c]) > ufbx_fabs(q.v[largest])) largest = c;
+		}
+
+		// Flip the quaternion so that the largest component is positive
+		if (q.v[largest] < 0.0f) rcp_len = -rcp_len;
+
+		uint16_t *dst = values + i * 3;
+		for (uint32_t c = 0, n = 0; c < 4; c++) {
+			if (c == largest) continue;
+			double v = (double)q.v[c] * rcp_len;
+			dst[n++] = ufbxi_quantize_unorm((v + UFBXI_QUAT_SMALLEST_MAX) * (0.5 / UFBXI_QUAT_SMALLEST_MAX), UFBXI_QUAT_SMALLEST_STEPS);
 		}
+		dst[0] = (uint16_t)(dst[0] | (largest & 1u) << 15u);
+		dst[1] = (uint16_t)(dst[1] | (largest >> 1u) << 15u);
 	}
 
-	segments[0].index_begin = 0;
-	segments[0].num_indices = (uint32_t)num_indices;
+	track->values.data = values;
+	track->values.count = keys.count * 3;
+	cc->anim.key_data_size += keys.count * 3 * sizeof(uint16_t);
+	return 1;
+}
 
-	line->element.name.data = ufbxi_empty_char;
-	line->element.type = UFBX_ELEMENT_LINE_CURVE;
-	line->element.typed_id = UINT32_MAX;
-	line->element.element_id = UINT32_MAX;
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_compress_baked_anim_imp(ufbxi_compress_anim_context *cc)
+{
+	// `ufbx_compress_anim_opts` must be cleared to zero first!
+	ufbx_assert(cc->opts._begin_zero == 0 && cc->opts._end_zero == 0);
+	ufbxi_check_err_msg(&cc->error, cc->opts._begin_zero == 0 && cc->opts._end_zero == 0, "Uninitialized options");
 
-	line->color.x = 1.0f;
-	line->color.y = 1.0f;
-	line->color.z = 1.0f;
+	if (cc->opts.constant_threshold == 0.0) cc->opts.constant_threshold = 0.000001;
+	if (cc->opts.uniform_time_threshold == 0.0) cc->opts.uniform_time_threshold = 0.000001;
 
-	line->control_points.data = vertices;
-	line->control_points.count = num_vertices;
-	line->point_indices.data = indices;
-	line->point_indices.count = num_indices;
-	line->segments.data = segments;
-	line->segments.count = 1;
+	ufbxi_init_ator(&cc->error, &cc->ator_result, &cc->opts.result_allocator, "result");
 
-	line->from_tessellated_nurbs = true;
+	cc->result.unordered = true;
+	cc->result.ator = &cc->ator_result;
 
-	tc->imp = ufbxi_push(&tc->result, ufbxi_line_curve_imp, 1);
-	ufbxi_check_err(&tc->error, tc->imp);
+	const ufbx_baked_anim *bake = cc->bake;
 
-	ufbxi_init_ref(&tc->imp->refcount, UFBXI_LINE_CURVE_IMP_MAGIC, &(ufbxi_get_imp(ufbxi_scene_imp, curve->element.scene))->refcount);
+	ufbx_compressed_node *nodes = ufbxi_push_zero(&cc->result, ufbx_compressed_node, bake->nodes.count);
+	ufbxi_check_err(&cc->error, nodes);
 
-	tc->imp->magic = UFBXI_LINE_CURVE_IMP_MAGIC;
-	tc->imp->curve = tc->line;
-	tc->imp->refcount.ator = tc->ator_result;
-	tc->imp->refcount.buf = tc->result;
+	for (size_t i = 0; i < bake->nodes.count; i++) {
+		const ufbx_baked_node *src = &bake->nodes.data[i];
+		ufbx_compressed_node *dst = &nodes[i];
+		dst->typed_id = src->typed_id;
+		dst->element_id = src->element_id;
+		ufbxi_check_err(&cc->error, ufbxi_compress_vec3_track(cc, &dst->translation, src->translation_keys, ufbx_zero_vec3));
+		ufbxi_check_err(&cc->error, ufbxi_compress_quat_track(cc, &dst->rotation, src->rotation_keys));
+		ufbxi_check_err(&cc->error, ufbxi_compress_vec3_track(cc, &dst->scale, src->scale_keys, ufbxi_one_vec3));
+	}
+
+	ufbx_compressed_element *elements = ufbxi_push_zero(&cc->result, ufbx_compressed_element, bake->elements.count);
+	ufbxi_check_err(&cc->error, elements);
+
+	for (size_t i = 0; i < bake->elements.count; i++) {
+		const ufbx_baked_element *src = &bake->elements.data[i];
+		ufbx_compressed_element *dst = &elements[i];
+		dst->element_id = src->element_id;
+
+		ufbx_compressed_prop *props = ufbxi_push_zero(&cc->result, ufbx_compressed_prop, src->props.count);
+		ufbxi_check_err(&cc->error, props);
+		dst->props.data = props;
+		dst->props.count = src->props.count;
+
+		for (size_t j = 0; j < src->props.count; j++) {
+			const ufbx_baked_prop *src_prop = &src->props.data[j];
+			char *name = ufbxi_push_copy(&cc->result, char, src_prop->name.length + 1, src_prop->name.data);
+			ufbxi_check_err(&cc->error, name);
+			props[j].name.data = name;
+			props[j].name.length = src_prop->name.length;
+			ufbxi_check_err(&cc->error, ufbxi_compress_vec3_track(cc, &props[j].track, src_prop->keys, ufbx_zero_vec3));
+		}
+	}
+
+	cc->anim.nodes.data = nodes;
+	cc->anim.nodes.count = bake->nodes.count;
+	cc->anim.elements.data = elements;
+	cc->anim.elements.count = bake->elements.count;
+
+	cc->imp = ufbxi_push(&cc->result, ufbxi_compressed_anim_imp, 1);
+	ufbxi_check_err(&cc->error, cc->imp);
 
+	ufbxi_init_ref(&cc->imp->refcount, UFBXI_COMPRESSED_ANIM_IMP_MAGIC, NULL);
+
+	cc->imp->magic = UFBXI_COMPRESSED_ANIM_IMP_MAGIC;
+	cc->imp->anim = cc->anim;
+	cc->imp->refcount.ator = cc->ator_result;
+	cc->imp->refcount.buf = cc->result;
 	return 1;
 }
 
-ufbxi_nodiscard static ufbxi_noinline int ufbxi_tessellate_nurbs_surface_imp(ufbxi_tessellate_surface_context *tc)
+static ufbxi_forceinline ufbx_vec3 ufbxi_decode_compressed_vec3(const ufbx_compressed_track *track, size_t index)
 {
-	// `ufbx_tessellate_opts` must be cleared to zero first!
-	ufbx_assert(tc->opts._begin_zero == 0 && tc->opts._end_zero == 0);
-	ufbxi_check_err_msg(&tc->error, tc->opts._begin_zero == 0 && tc->opts._end_zero == 0, "Uninitialized options");
+	const uint16_t *src = track->values.data + index * 3;
+	ufbx_vec3 v;
+	v.x = track->range_min.x + (ufbx_real)src[0] * track->range_scale.x;
+	v.y = track->range_min.y + (ufbx_real)src[1] * track->range_scale.y;
+	v.z = track->range_min.z + (ufbx_real)src[2] * track->range_scale.z;
+	return v;
+}
 
-	if (tc->opts.span_subdivision_u <= 0) {
-		tc->opts.span_subdivision_u = 4;
-	}
-	if (tc->opts.span_subdivision_v <= 0) {
-		tc->opts.span_subdivision_v = 4;
+static ufbxi_noinline ufbx_quat ufbxi_decode_compressed_quat(const ufbx_compressed_track *track, size_t index)
+{
+	const uint16_t *src = track->values.data + index * 3;
+	uint32_t largest = (uint32_t)(src[0] >> 15u) | (uint32_t)(src[1] >> 15u) << 1u;
+
+	double v[4];
+	double sum = 0.0;
+	for (uint32_t c = 0, n = 0; c < 4; c++) {
+		if (c == largest) continue;
+		double x = (double)(src[n++] & 0x7fffu) * (2.0 * UFBXI_QUAT_SMALLEST_MAX / UFBXI_QUAT_SMALLEST_STEPS) - UFBXI_QUAT_SMALLEST_MAX;
+		v[c] = x;
+		sum += x * x;
 	}
+	v[largest] = ufbx_sqrt(ufbx_fmax(1.0 - sum, 0.0));
 
-	size_t sub_u = tc->opts.span_subdivision_u;
-	size_t sub_v = tc->opts.span_subdivision_v;
+	double rcp_len = 1.0 / ufbx_sqrt(sum + v[largest] * v[largest]);
+	ufbx_quat q;
+	q.x = (ufbx_real)(v[0] * rcp_len);
+	q.y = (ufbx_real)(v[1] * rcp_len);
+	q.z = (ufbx_real)(v[2] * rcp_len);
+	q.w = (ufbx_real)(v[3] * rcp_len);
+	return q;
+}
 
-	const ufbx_nurbs_surface *surface = tc->surface;
-	ufbx_mesh *mesh = &tc->mesh;
-	ufbxi_check_err_msg(&tc->error, surface->basis_u.valid && surface->basis_v.valid
-		&& surface->num_control_points_u > 0 && surface->num_control_points_v > 0, "Bad NURBS geometry");
+// Find the keyframe at or before `time` and the interpolation factor to the next one.
+// Clamps to the first/last keyframe, `*p_t` is zero if there is no next keyframe.
+static ufbxi_noinline size_t ufbxi_find_compressed_key(const ufbx_compressed_track *track, double time, double *p_t)
+{
+	size_t num_keys = track->num_keys;
+	double offset = time - track->time_begin;
+	*p_t = 0.0;
+	if (!(offset > 0.0)) return 0;
 
-	ufbxi_init_ator(&tc->error, &tc->ator_tmp, &tc->opts.temp_allocator, "temp");
-	ufbxi_init_ator(&tc->error, &tc->ator_result, &tc->opts.result_allocator, "result");
+	const float *times = track->times.data;
+	const double *precise_times = track->precise_times.data;
+	if (!times && !precise_times) {
+		double pos = offset / track->time_step;
+		if (!(pos < (double)(num_keys - 1))) return num_keys - 1;
+		size_t index = (size_t)pos;
+		*p_t = pos - (double)index;
+		return index;
+	}
 
-	tc->result.unordered = true;
-	tc->tmp.unordered = true;
+	size_t begin = 0, end = num_keys;
+	while (begin < end) {
+		size_t mid = (begin + end) >> 1;
+		double mid_time = times ? (double)times[mid] : precise_times[mid];
+		if (mid_time <= offset) {
+			begin = mid + 1;
+		} else {
+			end = mid;
+		}
+	}
 
-	tc->result.ator = &tc->ator_result;
-	tc->tmp.ator = &tc->ator_tmp;
+	if (begin >= num_keys) return num_keys - 1;
+	size_t index = begin - 1;
+	double prev = times ? (double)times[index] : precise_times[index];
+	double next = times ? (double)times[begin] : precise_times[begin];
+	*p_t = (offset - prev) / (next - prev);
+	return index;
+}
 
-	bool open_u = surface->basis_u.topology == UFBX_NURBS_TOPOLOGY_OPEN;
-	bool open_v = surface->basis_v.topology == UFBX_NURBS_TOPOLOGY_OPEN;
+// -- Compiled animation
 
-	size_t spans_u = surface->basis_u.spans.count;
-	size_t spans_v = surface->basis_v.spans.count;
+static const char *const ufbxi_transform_props_all[] = {
+	ufbxi_Lcl_Rotation,
+	ufbxi_Lcl_Scaling,
+	ufbxi_Lcl_Translation,
+	ufbxi_PostRotation,
+	ufbxi_PreRotation,
+	ufbxi_RotationOffset,
+	ufbxi_RotationOrder,
+	ufbxi_RotationPivot,
+	ufbxi_ScalingOffset,
+	ufbxi_ScalingPivot,
+};
 
-	// Check conservatively that we don't overflow anything
-	{
-		size_t over_spans_u = spans_u * 2 * sizeof(ufbx_real);
-		size_t over_spans_v = spans_v * 2 * sizeof(ufbx_real);
-		size_t over_u = over_spans_u * sub_u;
-		size_t over_v = over_spans_v * sub_v;
-		size_t over_uv = over_u * over_v;
-		ufbxi_check_err(&tc->error, !ufbxi_does_overflow(over_u, over_spans_u, sub_u));
-		ufbxi_check_err(&tc->error, !ufbxi_does_overflow(over_v, over_spans_v, sub_v));
-		ufbxi_check_err(&tc->error, !ufbxi_does_overflow(over_uv, over_u, over_v));
-	}
+typedef enum {
+	UFBXI_COMPILED_NODE_STATIC,   // < `transform` is constant
+	UFBXI_COMPILED_NODE_CURVES,   // < Evaluate `curves[curve_begin:curve_end]` and compose with `pivots`
+	UFBXI_COMPILED_NODE_FALLBACK, // < Use `ufbx_evaluate_transform()`
+} ufbxi_compiled_node_kind;
 
-	size_t faces_u = (spans_u - 1) * sub_u;
-	size_t faces_v = (spans_v - 1) * sub_v;
+typedef struct {
+	const ufbx_anim_curve *curve;
+	uint32_t channel; // < 0: Lcl Translation, 1: Lcl Rotation, 2: Lcl Scaling
+	uint32_t axis;
+} ufbxi_compiled_curve;
 
-	size_t indices_u = spans_u + (spans_u - 1) * (sub_u - 1);
-	size_t indices_v = spans_v + (spans_v - 1) * (sub_v - 1);
+typedef struct {
+	const ufbx_node *node;
+	ufbxi_compiled_node_kind kind;
+	ufbx_rotation_order rotation_order;
+	uint32_t curve_begin, curve_end;
 
-	size_t num_faces = faces_u * faces_v;
-	size_t num_indices = indices_u * indices_v;
-	ufbxi_check_err(&tc->error, num_indices <= INT32_MAX);
+	// Lcl Translation/Rotation/Scaling before evaluating the curves
+	ufbx_vec3 values[3];
+	ufbxi_transform_pivots pivots;
 
-	uint32_t *position_ix = ufbxi_push(&tc->tmp, uint32_t, num_indices);
-	ufbx_vec3 *positions = ufbxi_push(&tc->result, ufbx_vec3, num_indices + 1);
-	ufbx_vec3 *normals = ufbxi_push(&tc->result, ufbx_vec3, num_indices + 1);
-	ufbx_vec2 *uvs = ufbxi_push(&tc->result, ufbx_vec2, num_indices + 1);
-	ufbx_vec3 *tangents = ufbxi_push(&tc->result, ufbx_vec3, num_indices + 1);
-	ufbx_vec3 *bitangents = ufbxi_push(&tc->result, ufbx_vec3, num_indices + 1);
-	ufbxi_check_err(&tc->error, position_ix && uvs && tangents && bitangents);
+	ufbx_transform transform;
+} ufbxi_compiled_node;
 
-	*positions++ = ufbx_zero_vec3;
-	*normals++ = ufbx_zero_vec3;
-	*uvs++ = ufbx_zero_vec2;
-	*tangents++ = ufbx_zero_vec3;
-	*bitangents++ = ufbx_zero_vec3;
+typedef struct {
+	ufbxi_refcount refcount;
+	ufbx_compiled_anim compiled;
+	uint32_t magic;
 
-	uint32_t num_positions = 0;
+	const ufbx_anim *anim;
+	const ufbxi_compiled_node *nodes;
+	const ufbxi_compiled_curve *curves;
+} ufbxi_compiled_anim_imp;
 
-	for (size_t span_v = 0; span_v < spans_v; span_v++) {
-		size_t splits_v = span_v + 1 == spans_v ? 1 : sub_v;
+#if UFBXI_FEATURE_SCENE_EVALUATION
 
-		for (size_t split_v = 0; split_v < splits_v; split_v++) {
-			size_t ix_v = span_v * sub_v + split_v;
-			ufbx_assert(ix_v < indices_v);
+typedef struct {
+	ufbx_error error;
+	ufbxi_allocator ator_tmp;
+	ufbxi_allocator ator_result;
 
-			ufbx_real v = surface->basis_v.spans.data[span_v];
-			if (split_v > 0) {
-				ufbx_real t = (ufbx_real)split_v / (ufbx_real)splits_v;
-				v = v * (1.0f - t) + t * surface->basis_v.spans.data[span_v + 1];
-			}
-			ufbx_real original_v = v;
-			if (span_v + 1 == spans_v && !open_v) {
-				v = surface->basis_v.spans.data[0];
-			}
+	ufbxi_buf result;
+	ufbxi_buf tmp_curves;
 
-			for (size_t span_u = 0; span_u < spans_u; span_u++) {
-				size_t splits_u = span_u + 1 == spans_u ? 1 : sub_u;
-				for (size_t split_u = 0; split_u < splits_u; split_u++) {
-					size_t ix_u = span_u * sub_u + split_u;
-					ufbx_assert(ix_u < indices_u);
+	ufbx_compile_anim_opts opts;
+	const ufbx_scene *scene;
+	const ufbx_anim *anim;
 
-					ufbx_real u = surface->basis_u.spans.data[span_u];
-					if (split_u > 0) {
-						ufbx_real t = (ufbx_real)split_u / (ufbx_real)splits_u;
-						u = u * (1.0f - t) + t * surface->basis_u.spans.data[span_u + 1];
-					}
-					ufbx_real original_u = u;
-					if (span_u + 1 == spans_u && !open_u) {
-						u = surface->basis_u.spans.data[0];
-					}
+	ufbx_compiled_anim compiled;
+	ufbxi_compiled_anim_imp *imp;
+} ufbxi_compile_anim_context;
 
-					ufbx_surface_point point = ufbx_evaluate_nurbs_surface(surface, u, v);
-					ufbx_vec3 pos = point.position;
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_compile_anim_node(ufbxi_compile_anim_context *cc, ufbxi_compiled_node *cn, const ufbx_node *node)
+{
+	const ufbx_anim *anim = cc->anim;
 
-					ufbx_vec3 tangent_u = ufbxi_slow_normalize3(&point.derivative_u);
-					ufbx_vec3 tangent_v = ufbxi_slow_normalize3(&point.derivative_v);
+	cn->node = node;
+	cn->kind = UFBXI_COMPILED_NODE_FALLBACK;
+	cn->rotation_order = UFBX_ROTATION_ORDER_XYZ;
+	cn->curve_begin = cn->curve_end = 0;
 
-					// Check if there's any wrapped positions that we could match
-					size_t neighbors[5];
-					size_t num_neighbors = 0;
+	if (node->is_root) {
+		cn->kind = UFBXI_COMPILED_NODE_STATIC;
+		cn->transform = node->local_transform;
+		return 1;
+	}
 
-					if ((span_v == 0 && (span_u > 0 || split_u > 0)) || (span_u == 0 && (span_v > 0 || split_v > 0))) {
-						// Top/left
-						neighbors[num_neighbors++] = 0;
-					}
-					if (span_v + 1 == spans_v) {
-						// Bottom
-						neighbors[num_neighbors++] = ix_u;
-						if (span_u > 0 || split_u > 0) {
-							neighbors[num_neighbors++] = ix_v * indices_u;
-						}
-					}
-					if (span_u + 1 == spans_u) {
-						// Right
-						neighbors[num_neighbors++] = ix_v * indices_u;
-						if (span_v > 0 || split_v > 0) {
-							neighbors[num_neighbors++] = indices_u - 1;
-						}
-					}
+	// Scale helpers depend on the animation of other nodes
+	if (node->parent && (node->parent->inherit_scale_node || node->parent->scale_helper)) return 1;
 
-					size_t ix = ix_v * indices_u + ix_u;
+	// Overridden properties need to be merged by `ufbxi_prop_iter`
+	if (anim->prop_overrides.count > 0) {
+		ufbx_prop_override_list over = ufbxi_find_element_prop_overrides(&anim->prop_overrides, node->element_id);
+		if (over.count > 0) return 1;
+	}
+
+	// Find the animation values that `ufbxi_evaluate_props()` would apply to the transform,
+	// the values are resolved only from layer 0 which replaces the property value as-is.
+	const ufbx_anim_value *anim_values[3] = { NULL, NULL, NULL };
+	ufbxi_for_list(const ufbx_prop, prop, node->props.props) {
+		const char *name = prop->name.data;
+		bool is_transform_prop = false;
+		for (size_t i = 0; i < ufbxi_arraycount(ufbxi_transform_props_all); i++) {
+			if (name == ufbxi_transform_props_all[i]) {
+				is_transform_prop = true;
+				break;
+			}
+		}
+		if (!is_transform_prop) continue;
 
-					uint32_t pos_ix = num_positions;
-					for (size_t i = 0; i < num_neighbors; i++) {
-						size_t nb_ix = neighbors[i];
-						ufbx_assert(nb_ix < ix);
-						uint32_t nb_pos_ix = position_ix[nb_ix];
-						ufbx_vec3 nb_pos = positions[nb_pos_ix];
-						ufbx_real dx = nb_pos.x - pos.x;
-						ufbx_real dy = nb_pos.y - pos.y;
-						ufbx_real dz = nb_pos.z - pos.z;
-						ufbx_real delta = dx*dx + dy*dy + dz*dz;
-						if (delta < 0.0000001f) { // TODO: Configurable / something more rigorous
-							pos_ix = nb_pos_ix;
-							break;
-						}
-					}
+		if ((prop->flags & UFBX_PROP_FLAG_CONNECTED) != 0 && !anim->ignore_connections) return 1;
+		if ((prop->flags & UFBX_PROP_FLAG_ANIMATED) == 0) continue;
 
-					position_ix[ix] = pos_ix;
-					if (pos_ix == num_positions) {
-						positions[pos_ix] = pos;
-						num_positions = pos_ix + 1;
-					}
-					uvs[ix].x = original_u;
-					uvs[ix].y = original_v;
-					tangents[ix] = tangent_u;
-					bitangents[ix] = tangent_v;
-				}
+		int channel = -1;
+		if (name == ufbxi_Lcl_Translation) channel = 0;
+		else if (name == ufbxi_Lcl_Rotation) channel = 1;
+		else if (name == ufbxi_Lcl_Scaling) channel = 2;
+
+		for (size_t layer_ix = 0; layer_ix < anim->layers.count; layer_ix++) {
+			ufbx_anim_layer *layer = anim->layers.data[layer_ix];
+			ufbx_anim_prop *aprop = ufbxi_find_anim_prop_start(layer, &node->element);
+			if (!aprop) continue;
+
+			for (; aprop->element == &node->element; aprop++) {
+				if (aprop->prop_name.data != name) continue;
+				if (layer_ix > 0 || channel < 0 || (prop->flags & UFBX_PROP_FLAG_NO_VALUE) != 0) return 1;
+				anim_values[channel] = aprop->anim_value;
+				break;
 			}
 		}
 	}
 
-	ufbx_face *faces = ufbxi_push(&tc->result, ufbx_face, num_faces);
-	uint32_t *vertex_ix = ufbxi_push(&tc->result, uint32_t, num_faces * 4);
-	uint32_t *attrib_ix = ufbxi_push(&tc->result, uint32_t, num_faces * 4);
-	ufbxi_check_err(&tc->error, faces && vertex_ix && attrib_ix);
+	if (!anim_values[0] && !anim_values[1] && !anim_values[2]) {
+		cn->kind = UFBXI_COMPILED_NODE_STATIC;
+		cn->transform = ufbx_evaluate_transform(anim, node, 0.0);
+		return 1;
+	}
 
-	size_t face_ix = 0;
-	size_t dst_index = 0;
+	cn->kind = UFBXI_COMPILED_NODE_CURVES;
+	cn->rotation_order = (ufbx_rotation_order)ufbxi_find_enum(&node->props, ufbxi_RotationOrder, UFBX_ROTATION_ORDER_XYZ, UFBX_ROTATION_ORDER_SPHERIC);
+	ufbxi_get_transform_pivots(&cn->pivots, &node->props);
+	cn->values[0] = ufbxi_find_vec3(&node->props, ufbxi_Lcl_Translation, 0.0f, 0.0f, 0.0f);
+	cn->values[1] = ufbxi_find_vec3(&node->props, ufbxi_Lcl_Rotation, 0.0f, 0.0f, 0.0f);
+	cn->values[2] = ufbxi_find_vec3(&node->props, ufbxi_Lcl_Scaling, 1.0f, 1.0f, 1.0f);
 
-	size_t num_triangles = 0;
+	cn->curve_begin = (uint32_t)cc->compiled.num_curves;
+	for (uint32_t channel = 0; channel < 3; channel++) {
+		const ufbx_anim_value *value = anim_values[channel];
+		if (!value) continue;
+		cn->values[channel] = value->default_value;
+		for (uint32_t axis = 0; axis < 3; axis++) {
+			if (!value->curves[axis]) continue;
+			ufbxi_compiled_curve *curve = ufbxi_push(&cc->tmp_curves, ufbxi_compiled_curve, 1);
+			ufbxi_check_err(&cc->error, curve);
+			curve->curve = value->curves[axis];
+			curve->channel = channel;
+			curve->axis = axis;
+			cc->compiled.num_curves++;
+		}
+	}
+	ufbxi_check_err(&cc->error, cc->compiled.num_curves <= UINT32_MAX);
+	cn->curve_end = (uint32_t)cc->compiled.num_curves;
 
-	for (size_t face_v = 0; face_v < faces_v; face_v++) {
-		for (size_t face_u = 0; face_u < faces_u; face_u++) {
+	return 1;
+}
 
-			attrib_ix[dst_index + 0] = (uint32_t)((face_v + 0) * indices_u + (face_u + 0));
-			attrib_ix[dst_index + 1] = (uint32_t)((face_v + 0) * indices_u + (face_u + 1));
-			attrib_ix[dst_index + 2] = (uint32_t)((face_v + 1) * indices_u + (face_u + 1));
-			attrib_ix[dst_index + 3] = (uint32_t)((face_v + 1) * indices_u + (face_u + 0));
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_compile_anim_imp(ufbxi_compile_anim_context *cc)
+{
+	// `ufbx_compile_anim_opts` must be cleared to zero first!
+	ufbx_assert(cc->opts._begin_zero == 0 && cc->opts._end_zero == 0);
+	ufbxi_check_err_msg(&cc->error, cc->opts._begin_zero == 0 && cc->opts._end_zero == 0, "Uninitialized options");
 
-			vertex_ix[dst_index + 0] = position_ix[attrib_ix[dst_index + 0]];
-			vertex_ix[dst_index + 1] = position_ix[attrib_ix[dst_index + 1]];
-			vertex_ix[dst_index + 2] = position_ix[attrib_ix[dst_index + 2]];
-			vertex_ix[dst_index + 3] = position_ix[attrib_ix[dst_index + 3]];
+	ufbxi_init_ator(&cc->error, &cc->ator_tmp, &cc->opts.temp_allocator, "temp");
+	ufbxi_init_ator(&cc->error, &cc->ator_result, &cc->opts.result_allocator, "result");
 
-			bool is_triangle = false;
-			for (size_t prev_ix = 0; prev_ix < 4; prev_ix++) {
-				size_t next_ix = (prev_ix + 1) % 4;
-				if (vertex_ix[dst_index + prev_ix] == vertex_ix[dst_index + next_ix]) {
-					for (size_t i = next_ix; i < 3; i++) {
-						attrib_ix[dst_index + i] = attrib_ix[dst_index + i + 1];
-						vertex_ix[dst_index + i] = vertex_ix[dst_index + i + 1];
-					}
-					is_triangle = true;
-					break;
-				}
-			}
+	cc->result.unordered = true;
+	cc->result.ator = &cc->ator_result;
+	cc->tmp_curves.ator = &cc->ator_tmp;
 
-			faces[face_ix].index_begin = (uint32_t)dst_index;
-			faces[face_ix].num_indices = is_triangle ? 3 : 4;
-			dst_index += is_triangle ? 3 : 4;
-			num_triangles += is_triangle ? 1 : 2;
-			face_ix++;
-		}
-	}
+	const ufbx_scene *scene = cc->scene;
+	size_t num_nodes = scene->nodes.count;
 
-	ufbxi_check_err(&tc->error, positions && normals);
+	ufbxi_compiled_node *nodes = ufbxi_push_zero(&cc->result, ufbxi_compiled_node, num_nodes);
+	ufbxi_check_err(&cc->error, nodes);
 
-	mesh->element.name.data = ufbxi_empty_char;
-	mesh->element.type = UFBX_ELEMENT_MESH;
-	mesh->element.typed_id = UINT32_MAX;
-	mesh->element.element_id = UINT32_MAX;
+	for (size_t i = 0; i < num_nodes; i++) {
+		ufbxi_compiled_node *cn = &nodes[i];
+		ufbxi_check_err(&cc->error, ufbxi_compile_anim_node(cc, cn, scene->nodes.data[i]));
+		if (cn->kind == UFBXI_COMPILED_NODE_STATIC) {
+			cc->compiled.num_static_nodes++;
+		} else if (cn->kind == UFBXI_COMPILED_NODE_CURVES) {
+			cc->compiled.num_curve_nodes++;
+		} else {
+			cc->compiled.num_fallback_nodes++;
+		}
+	}
+	cc->compiled.num_nodes = num_nodes;
 
-	mesh->vertices.data = positions;
-	mesh->vertices.count = num_positions;
-	mesh->num_vertices = num_positions;
-	mesh->vertex_indices.data = vertex_ix;
-	mesh->vertex_indices.count = dst_index;
+	ufbxi_compiled_curve *curves = ufbxi_push_pop(&cc->result, &cc->tmp_curves, ufbxi_compiled_curve, cc->compiled.num_curves);
+	ufbxi_check_err(&cc->error, curves);
 
-	mesh->faces.data = faces;
-	mesh->faces.count = num_faces;
+	cc->imp = ufbxi_push(&cc->result, ufbxi_compiled_anim_imp, 1);
+	ufbxi_check_err(&cc->error, cc->imp);
 
-	mesh->vertex_position.exists = true;
-	mesh->vertex_position.values.data = positions;
-	mesh->vertex_position.values.count = num_positions;
-	mesh->vertex_position.indices.data = vertex_ix;
-	mesh->vertex_position.indices.count = dst_index;
-	mesh->vertex_position.unique_per_vertex = true;
+	// Custom animations refer to the scene so retaining them keeps both alive
+	ufbxi_refcount *parent = cc->anim->custom
+		? &(ufbxi_get_imp(ufbxi_anim_imp, cc->anim))->refcount
+		: &(ufbxi_get_imp(ufbxi_scene_imp, scene))->refcount;
+	ufbxi_init_ref(&cc->imp->refcount, UFBXI_COMPILED_ANIM_IMP_MAGIC, parent);
+
+	cc->imp->magic = UFBXI_COMPILED_ANIM_IMP_MAGIC;
+	cc->imp->compiled = cc->compiled;
+	cc->imp->anim = cc->anim;
+	cc->imp->nodes = nodes;
+	cc->imp->curves = curves;
+	cc->imp->refcount.ator = cc->ator_result;
+	cc->imp->refcount.buf = cc->result;
+	return 1;
+}
 
-	mesh->vertex_uv.exists = true;
-	mesh->vertex_uv.values.data = uvs;
-	mesh->vertex_uv.values.count = dst_index;
-	mesh->vertex_uv.indices.data = attrib_ix;
-	mesh->vertex_uv.indices.count = dst_index;
+#endif
 
-	mesh->vertex_normal.exists = true;
-	mesh->vertex_normal.values.data = normals;
-	mesh->vertex_normal.values.count = num_positions;
-	mesh->vertex_normal.indices.data = vertex_ix;
-	mesh->vertex_normal.indices.count = dst_index;
+// -- NURBS
 
-	mesh->vertex_tangent.exists = true;
-	mesh->vertex_tangent.values.data = tangents;
-	mesh->vertex_tangent.values.count = dst_index;
-	mesh->vertex_tangent.indices.data = attrib_ix;
-	mesh->vertex_tangent.indices.count = dst_index;
+static ufbxi_forceinline ufbx_real ufbxi_nurbs_weight(const ufbx_real_list *knots, size_t knot, size_t degree, ufbx_real u)
+{
+	if (knot >= knots->count) return 0.0f;
+	if (knots->count - knot < degree) return 0.0f;
+	ufbx_real prev_u = knots->data[knot], next_u = knots->data[knot + degree];
+	if (prev_u >= next_u) return 0.0f;
+	if (u <= prev_u) return 0.0f;
+	if (u >= next_u) return 1.0f;
+	return (u - prev_u) / (next_u - prev_u);
+}
 
-	mesh->vertex_bitangent.exists = true;
-	mesh->vertex_bitangent.values.data = bitangents;
-	mesh->vertex_bitangent.values.count = dst_index;
-	mesh->vertex_bitangent.indices.data = attrib_ix;
-	mesh->vertex_bitangent.indices.count = dst_index;
+static ufbxi_forceinline ufbx_real ufbxi_nurbs_deriv(const ufbx_real_list *knots, size_t knot, size_t degree)
+{
+	if (knot >= knots->count) return 0.0f;
+	if (knots->count - knot < degree) return 0.0f;
+	ufbx_real prev_u = knots->data[knot], next_u = knots->data[knot + degree];
+	if (prev_u >= next_u) return 0.0f;
+	return (ufbx_real)degree / (next_u - prev_u);
+}
 
-	mesh->num_faces = num_faces;
-	mesh->num_triangles = num_triangles;
-	mesh->num_indices = dst_index;
-	mesh->max_face_triangles = 2;
+typedef struct {
+	ufbxi_refcount refcount;
+	ufbx_line_curve curve;
+	uint32_t magic;
+} ufbxi_line_curve_imp;
 
-	if (surface->material) {
-		mesh->face_material.data = ufbxi_push_zero(&tc->result, uint32_t, num_faces);
-		ufbxi_check_err(&tc->error, mesh->face_material.data);
+ufbx_static_assert(line_curve_imp_offset, offsetof(ufbxi_line_curve_imp, curve) == sizeof(ufbxi_refcount));
 
-		ufbx_material **mat = ufbxi_push_zero(&tc->result, ufbx_material*, 1);
-		ufbxi_check_err(&tc->error, mat);
+#if UFBXI_FEATURE_TESSELLATION
 
-		*mat = surface->material;
-		mesh->materials.data = mat;
-		mesh->materials.count = 1;
-	}
+typedef struct {
+	ufbx_error error;
 
-	if (!tc->opts.skip_mesh_parts) {
-		mesh->material_parts.count = 1;
-		mesh->material_parts.data = ufbxi_push_zero(&tc->result, ufbx_mesh_part, 1);
-		ufbxi_check_err(&tc->error, mesh->material_parts.data);
-	}
+	ufbx_tessellate_curve_opts opts;
 
-	ufbxi_check_err(&tc->error, ufbxi_finalize_mesh_material(&tc->result, &tc->error, mesh));
-	ufbxi_check_err(&tc->error, ufbxi_finalize_mesh(&tc->result, &tc->error, mesh));
+	const ufbx_nurbs_curve *curve;
 
-	mesh->generated_normals = true;
-	ufbx_compute_normals(mesh, &mesh->vertex_position,
-		mesh->vertex_normal.indices.data, mesh->vertex_normal.indices.count,
-		mesh->vertex_normal.values.data, mesh->vertex_normal.values.count);
+	ufbxi_allocator ator_tmp;
+	ufbxi_allocator ator_result;
 
-	if (surface->flip_normals) {
-		ufbxi_nounroll ufbxi_for_list(ufbx_vec3, normal, mesh->vertex_normal.values) {
-			normal->x *= -1.0f;
-			normal->y *= -1.0f;
-			normal->z *= -1.0f;
-		}
-	}
+	ufbxi_buf result;
 
-	tc->imp = ufbxi_push(&tc->result, ufbxi_mesh_imp, 1);
-	ufbxi_check_err(&tc->error, tc->imp);
+	ufbx_line_curve line;
 
-	ufbxi_init_ref(&tc->imp->refcount, UFBXI_MESH_IMP_MAGIC, &(ufbxi_get_imp(ufbxi_scene_imp, surface->element.scene))->refcount);
+	ufbxi_line_curve_imp *imp;
 
-	tc->imp->magic = UFBXI_MESH_IMP_MAGIC;
-	tc->imp->mesh = tc->mesh;
-	tc->imp->refcount.ator = tc->ator_result;
-	tc->imp->refcount.buf = tc->result;
-	tc->imp->mesh.subdivision_evaluated = true;
+} ufbxi_tessellate_curve_context;
 
-	return 1;
-}
+typedef struct {
+	ufbx_error error;
 
-#endif
+	ufbx_tessellate_surface_opts opts;
 
-// -- Topology
+	const ufbx_nurbs_surface *surface;
 
-#if UFBXI_FEATURE_KD
+	ufbxi_allocator ator_tmp;
+	ufbxi_allocator ator_result;
 
-typedef struct {
-	ufbx_real split;
-	uint32_t index;
-	uint32_t slow_left;
-	uint32_t slow_right;
-	uint32_t slow_end;
-} ufbxi_kd_node;
+	ufbxi_buf tmp;
+	ufbxi_buf result;
 
-typedef struct {
-	ufbx_face face;
-	ufbx_vertex_vec3 positions;
-	ufbx_vec3 axes[3];
-	ufbxi_kd_node kd_nodes[1 << (UFBXI_KD_FAST_DEPTH + 1)];
-	uint32_t *kd_indices;
+	ufbxi_map position_map;
 
-	// Temporary
-	ufbx_vec3 cur_axis_dir;
-	ufbx_face cur_face;
-} ufbxi_ngon_context;
+	ufbx_mesh mesh;
 
-typedef struct {
-	ufbx_real min_t[2];
-	ufbx_real max_t[2];
-	ufbx_vec2 points[3];
-	uint32_t indices[3];
-} ufbxi_kd_triangle;
+	ufbxi_mesh_imp *imp;
 
-ufbxi_forceinline static ufbx_vec2 ufbxi_ngon_project(ufbxi_ngon_context *nc, ufbx_vec3 point)
-{
-	ufbx_vec2 p;
-	p.x = ufbxi_dot3(nc->axes[0], point);
-	p.y = ufbxi_dot3(nc->axes[1], point);
-	return p;
-}
+} ufbxi_tessellate_surface_context;
 
-ufbxi_forceinline static ufbx_real ufbxi_orient2d(ufbx_vec2 a, ufbx_vec2 b, ufbx_vec2 c)
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_tessellate_nurbs_curve_imp(ufbxi_tessellate_curve_context *tc)
 {
-	return (b.x - a.x)*(c.y - a.y) - (b.y - a.y)*(c.x - a.x);
-}
+	// `ufbx_tessellate_opts` must be cleared to zero first!
+	ufbx_assert(tc->opts._begin_zero == 0 && tc->opts._end_zero == 0);
+	ufbxi_check_err_msg(&tc->error, tc->opts._begin_zero == 0 && tc->opts._end_zero == 0, "Uninitialized options");
 
-ufbxi_forceinline static bool ufbxi_kd_check_point(ufbxi_ngon_context *nc, const ufbxi_kd_triangle *tri, uint32_t index, ufbx_vec3 point)
-{
-	if (index == tri->indices[0] || index == tri->indices[1] || index == tri->indices[2]) return false;
-	ufbx_vec2 p = ufbxi_ngon_project(nc, point);
+	if (tc->opts.span_subdivision <= 0) {
+		tc->opts.span_subdivision = 4;
+	}
+	size_t num_sub = tc->opts.span_subdivision;
 
-	ufbx_real u = ufbxi_orient2d(p, tri->points[0], tri->points[1]);
-	ufbx_real v = ufbxi_orient2d(p, tri->points[1], tri->points[2]);
-	ufbx_real w = ufbxi_orient2d(p, tri->points[2], tri->points[0]);
+	const ufbx_nurbs_curve *curve = tc->curve;
+	ufbx_line_curve *line = &tc->line;
+	ufbxi_check_err_msg(&tc->error, curve->basis.valid && curve->control_points.count > 0, "Bad NURBS geometry");
 
-	if (u <= 0.0f && v <= 0.0f && w <= 0.0f) return true;
-	if (u >= 0.0f && v >= 0.0f && w >= 0.0f) return true;
-	return false;
-}
+	ufbxi_init_ator(&tc->error, &tc->ator_tmp, &tc->opts.temp_allocator, "temp");
+	ufbxi_init_ator(&tc->error, &tc->ator_result, &tc->opts.result_allocator, "result");
 
-// Recursion limited by 32-bit indices in input, minus halvings from `ufbxi_kd_check_fast()`
-ufbxi_noinline static bool ufbxi_kd_check_slow(ufbxi_ngon_context *nc, const ufbxi_kd_triangle *tri, uint32_t begin, uint32_t count, uint32_t axis)
-	ufbxi_recursive_function(bool, ufbxi_kd_check_slow, (nc, tri, begin, count, axis), 32 - UFBXI_KD_FAST_DEPTH,
-		(ufbxi_ngon_context *nc, const ufbxi_kd_triangle *tri, uint32_t begin, uint32_t count, uint32_t axis))
-{
-	ufbx_vertex_vec3 pos = nc->positions;
-	uint32_t *kd_indices = nc->kd_indices;
+	tc->result.unordered = true;
+	tc->result.ator = &tc->ator_result;
 
-	while (count > 0) {
-		uint32_t num_left = count / 2;
-		uint32_t begin_right = begin + num_left + 1;
-		uint32_t num_right = count - (num_left + 1);
+	size_t num_spans = curve->basis.spans.count;
 
-		uint32_t index = kd_indices[begin + num_left];
-		ufbx_vec3 point = pos.values.data[pos.indices.data[nc->face.index_begin + index]];
-		ufbx_real split = ufbxi_dot3(point, nc->axes[axis]);
-		bool hit_left = tri->min_t[axis] <= split;
-		bool hit_right = tri->max_t[axis] >= split;
-
-		if (hit_left && hit_right) {
-			if (ufbxi_kd_check_point(nc, tri, index, point)) {
-				return true;
-			}
-
-			if (ufbxi_kd_check_slow(nc, tri, begin_right, num_right, axis ^ 1)) {
-				return true;
-			}
-		}
-
-		axis ^= 1;
-		if (hit_left) {
-			count = num_left;
-		} else {
-			begin = begin_right;
-			count = num_right;
-		}
+	// Check conservatively that we don't overflow anything
+	{
+		size_t over_spans = num_spans * 2 * sizeof(ufbx_real);
+		size_t over = over_spans * num_sub;
+		ufbxi_check_err(&tc->error, !ufbxi_does_overflow(over, over_spans, num_sub));
 	}
 
-	return false;
-}
-
-// Recursion limited by `UFBXI_KD_FAST_DEPTH`
-ufbxi_noinline static bool ufbxi_kd_check_fast(ufbxi_ngon_context *nc, const ufbxi_kd_triangle *tri, uint32_t kd_index, uint32_t axis, uint32_t depth)
-	ufbxi_recursive_function(bool, ufbxi_kd_check_fast, (nc, tri, kd_index, axis, depth), UFBXI_KD_FAST_DEPTH,
-		(ufbxi_ngon_context *nc, const ufbxi_kd_triangle *tri, uint32_t kd_index, uint32_t axis, uint32_t depth))
-{
-	ufbx_vertex_vec3 pos = nc->positions;
+	bool is_open = curve->basis.topology == UFBX_NURBS_TOPOLOGY_OPEN;
 
-	for (;;) {
-		ufbxi_kd_node node = nc->kd_nodes[kd_index];
-		if (node.slow_end == 0) return false;
+	size_t num_indices = num_spans + (num_spans - 1) * (num_sub - 1);
+	size_t num_vertices = num_indices - (is_open ? 0u : 1u);
+	ufbxi_check_err(&tc->error, num_indices <= INT32_MAX);
 
-		bool hit_left = tri->min_t[axis] <= node.split;
-		bool hit_right = tri->max_t[axis] >= node.split;
+	uint32_t *indices = ufbxi_push(&tc->result, uint32_t, num_indices);
+	ufbx_vec3 *vertices = ufbxi_push(&tc->result, ufbx_vec3, num_vertices);
+	ufbx_line_segment *segments = ufbxi_push(&tc->result, ufbx_line_segment, 1);
+	ufbxi_check_err(&tc->error, indices && vertices && segments);
 
-		uint32_t side = hit_left ? 0 : 1;
-		uint32_t child_kd_index = kd_index * 2 + 1 + side;
-		if (hit_left && hit_right) {
+	for (size_t span_ix = 0; span_ix < num_spans; span_ix++) {
+		size_t num_splits = span_ix + 1 == num_spans ? 1 : num_sub;
 
-			// Check for the point on the split plane
-			ufbx_vec3 point = pos.values.data[pos.indices.data[nc->face.index_begin + node.index]];
-			if (ufbxi_kd_check_point(nc, tri, node.index, point)) {
-				return true;
-			}
+		for (size_t sub_ix = 0; sub_ix < num_splits; sub_ix++) {
+			size_t ix = span_ix * num_sub + sub_ix;
 
-			// Recurse always to the right if we hit both sides
-			if (depth + 1 == UFBXI_KD_FAST_DEPTH) {
-				if (ufbxi_kd_check_slow(nc, tri, node.slow_right, node.slow_end - node.slow_right, axis ^ 1)) {
-					return true;
-				}
-			} else {
-				if (ufbxi_kd_check_fast(nc, tri, child_kd_index + 1, axis ^ 1, depth + 1)) {
-					return true;
+			if (ix < num_vertices) {
+				ufbx_real u = curve->basis.spans.data[span_ix];
+				if (sub_ix > 0) {
+					ufbx_real t = (ufbx_real)sub_ix / (ufbx_real)num_sub;
+					u = u * (1.0f - t) + t * curve->basis.spans.data[span_ix + 1];
 				}
-			}
-		}
-
-		depth++;
-		axis ^= 1;
-		kd_index = child_kd_index;
 
-		if (depth == UFBXI_KD_FAST_DEPTH) {
-			if (hit_left) {
-				return ufbxi_kd_check_slow(nc, tri, node.slow_left, node.slow_right - node.slow_left, axis);
+				ufbx_curve_point point = ufbx_evaluate_nurbs_curve(curve, u);
+				vertices[ix] = point.position;
+				indices[ix] = (uint32_t)ix;
 			} else {
-				return ufbxi_kd_check_slow(nc, tri, node.slow_right, node.slow_end - node.slow_right, axis);
+				indices[ix] = 0;
 			}
 		}
 	}
-}
 
-ufbxi_noinline static bool ufbxi_kd_index_less(void *user, const void *va, const void *vb)
-{
-	ufbxi_ngon_context *nc = (ufbxi_ngon_context*)user;
-	ufbx_vertex_vec3 *pos = &nc->positions;
-	const uint32_t a = *(const uint32_t*)va, b = *(const uint32_t*)vb;
-	ufbx_real da = ufbxi_dot3(nc->cur_axis_dir, pos->values.data[pos->indices.data[nc->cur_face.index_begin + a]]);
-	ufbx_real db = ufbxi_dot3(nc->cur_axis_dir, pos->values.data[pos->indices.data[nc->cur_face.index_begin + b]]);
-	return da < db;
-}
+	segments[0].index_begin = 0;
+	segments[0].num_indices = (uint32_t)num_indices;
 
-// Recursion limited by 32-bit indices in input
-ufbxi_noinline static void ufbxi_kd_build(ufbxi_ngon_context *nc, uint32_t *indices, uint32_t *tmp, uint32_t num, uint32_t axis, uint32_t fast_index, uint32_t depth)
-	ufbxi_recursive_function_void(ufbxi_kd_build, (nc, indices, tmp, num, axis, fast_index, depth), 32,
-		(ufbxi_ngon_context *nc, uint32_t *indices, uint32_t *tmp, uint32_t num, uint32_t axis, uint32_t fast_index, uint32_t depth))
-{
-	if (num == 0) return;
+	line->element.name.data = ufbxi_empty_char;
+	line->element.type = UFBX_ELEMENT_LINE_CURVE;
+	line->element.typed_id = UINT32_MAX;
+	line->element.element_id = UINT32_MAX;
 
-	ufbx_vertex_vec3 pos = nc->positions;
-	ufbx_vec3 axis_dir = nc->axes[axis];
-	ufbx_face face = nc->face;
+	line->color.x = 1.0f;
+	line->color.y = 1.0f;
+	line->color.z = 1.0f;
 
-	nc->cur_axis_dir = axis_dir;
-	nc->cur_face = face;
+	line->control_points.data = vertices;
+	line->control_points.count = num_vertices;
+	line->point_indices.data = indices;
+	line->point_indices.count = num_indices;
+	line->segments.data = segments;
+	line->segments.count = 1;
 
-	// Sort the remaining indices based on the axis
-	ufbxi_stable_sort(sizeof(uint32_t), 16, indices, tmp, num, &ufbxi_kd_index_less, nc);
+	line->from_tessellated_nurbs = true;
 
-	uint32_t num_left = num / 2;
-	uint32_t begin_right = num_left + 1;
-	uint32_t num_right = num - begin_right;
-	uint32_t dst_right = num_left + 1;
-	if (depth < UFBXI_KD_FAST_DEPTH) {
-		uint32_t skip_left = 1u << (UFBXI_KD_FAST_DEPTH - depth - 1);
-		dst_right = dst_right > skip_left ? dst_right - skip_left : 0;
+	tc->imp = ufbxi_push(&tc->result, ufbxi_line_curve_imp, 1);
+	ufbxi_check_err(&tc->error, tc->imp);
 
-		uint32_t index = indices[num_left];
-		ufbxi_kd_node *kd = &nc->kd_nodes[fast_index];
+	ufbxi_init_ref(&tc->imp->refcount, UFBXI_LINE_CURVE_IMP_MAGIC, &(ufbxi_get_imp(ufbxi_scene_imp, curve->element.scene))->refcount);
 
-		kd->split = ufbxi_dot3(axis_dir, pos.values.data[pos.indices.data[face.index_begin + index]]);
-		kd->index = index;
+	tc->imp->magic = UFBXI_LINE_CURVE_IMP_MAGIC;
+	tc->imp->curve = tc->line;
+	tc->imp->refcount.ator = tc->ator_result;
+	tc->imp->refcount.buf = tc->result;
 
-		if (depth + 1 == UFBXI_KD_FAST_DEPTH) {
-			kd->slow_left = (uint32_t)(indices - nc->kd_indices);
-			kd->slow_right = kd->slow_left + num_left;
-			kd->slow_end = kd->slow_right + num_right;
-		} else {
-			kd->slow_left = UINT32_MAX;
-			kd->slow_right = UINT32_MAX;
-			kd->slow_end = UINT32_MAX;
-		}
-	}
+	return 1;
+}
 
-	uint32_t child_fast = fast_index * 2 + 1;
-	ufbxi_kd_build(nc, indices, tmp, num_left, axis ^ 1, child_fast + 0, depth + 1);
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_tessellate_nurbs_surface_imp(ufbxi_tessellate_surface_context *tc)
+{
+	// `ufbx_tessellate_opts` must be cleared to zero first!
+	ufbx_assert(tc->opts._begin_zero == 0 && tc->opts._end_zero == 0);
+	ufbxi_check_err_msg(&tc->error, tc->opts._begin_zero == 0 && tc->opts._end_zero == 0, "Uninitialized options");
 
-	if (dst_right != begin_right) {
-		memmove(indices + dst_right, indices + begin_right, num_right * sizeof(uint32_t));
+	if (tc->opts.span_subdivision_u <= 0) {
+		tc->opts.span_subdivision_u = 4;
+	}
+	if (tc->opts.span_subdivision_v <= 0) {
+		tc->opts.span_subdivision_v = 4;
 	}
 
-	ufbxi_kd_build(nc, indices + dst_right, tmp, num_right, axis ^ 1, child_fast + 1, depth + 1);
-}
-
-#endif
+	size_t sub_u = tc->opts.span_subdivision_u;
+	size_t sub_v = tc->opts.span_subdivision_v;
 
-#if UFBXI_FEATURE_TRIANGULATION
+	const ufbx_nurbs_surface *surface = tc->surface;
+	ufbx_mesh *mesh = &tc->mesh;
+	ufbxi_check_err_msg(&tc->error, surface->basis_u.valid && surface->basis_v.valid
+		&& surface->num_control_points_u > 0 && surface->num_control_points_v > 0, "Bad NURBS geometry");
 
-ufbxi_noinline static uint32_t ufbxi_triangulate_ngon(ufbxi_ngon_context *nc, uint32_t *indices, uint32_t num_indices)
-{
-	ufbx_face face = nc->face;
+	ufbxi_init_ator(&tc->error, &tc->ator_tmp, &tc->opts.temp_allocator, "temp");
+	ufbxi_init_ator(&tc->error, &tc->ator_result, &tc->opts.result_allocator, "result");
 
-	// Form an orthonormal basis to project the polygon into a 2D plane
-	ufbx_vec3 normal = ufbx_get_weighted_face_normal(&nc->positions, face);
-	ufbx_real len = ufbxi_length3(normal);
-	if (len > UFBX_EPSILON) {
-		normal = ufbxi_mul3(normal, 1.0f / len);
-	} else {
-		normal.x = 1.0f;
-		normal.y = 0.0f;
-		normal.z = 0.0f;
-	}
+	tc->result.unordered = true;
+	tc->tmp.unordered = true;
 
-	ufbx_vec3 axis;
-	if (normal.x*normal.x < 0.5f) {
-		axis.x = 1.0f;
-		axis.y = 0.0f;
-		axis.z = 0.0f;
-	} else {
-		axis.x = 0.0f;
-		axis.y = 1.0f;
-		axis.z = 0.0f;
-	}
-	nc->axes[0] = ufbxi_slow_normalized_cross3(&axis, &normal);
-	nc->axes[1] = ufbxi_slow_normalized_cross3(&normal, &nc->axes[0]);
-	nc->axes[2] = normal;
+	tc->result.ator = &tc->ator_result;
+	tc->tmp.ator = &tc->ator_tmp;
 
-	uint32_t *kd_indices = indices;
-	nc->kd_indices = kd_indices;
+	bool open_u = surface->basis_u.topology == UFBX_NURBS_TOPOLOGY_OPEN;
+	bool open_v = surface->basis_v.topology == UFBX_NURBS_TOPOLOGY_OPEN;
 
-	uint32_t *kd_tmp = indices + face.num_indices;
-	ufbx_vertex_vec3 pos = nc->positions;
+	size_t spans_u = surface->basis_u.spans.count;
+	size_t spans_v = surface->basis_v.spans.count;
 
-	// Collect all the reflex corners for intersection testing.
-	uint32_t num_kd_indices = 0;
+	// Check conservatively that we don't overflow anything
 	{
-		ufbx_vec2 a = ufbxi_ngon_project(nc, pos.values.data[pos.indices.data[face.index_begin + face.num_indices - 1]]);
-		ufbx_vec2 b = ufbxi_ngon_project(nc, pos.values.data[pos.indices.data[face.index_begin + 0]]);
-		for (uint32_t i = 0; i < face.num_indices; i++) {
-			uint32_t next = i + 1 < face.num_indices ? i + 1 : 0;
-			ufbx_vec2 c = ufbxi_ngon_project(nc, pos.values.data[pos.indices.data[face.index_begin + next]]);
-
-			if (ufbxi_orient2d(a, b, c) < 0.0f) {
-				kd_indices[num_kd_indices++] = i;
-			}
-
-			a = b;
-			b = c;
-		}
+		size_t over_spans_u = spans_u * 2 * sizeof(ufbx_real);
+		size_t over_spans_v = spans_v * 2 * sizeof(ufbx_real);
+		size_t over_u = over_spans_u * sub_u;
+		size_t over_v = over_spans_v * sub_v;
+		size_t over_uv = over_u * over_v;
+		ufbxi_check_err(&tc->error, !ufbxi_does_overflow(over_u, over_spans_u, sub_u));
+		ufbxi_check_err(&tc->error, !ufbxi_does_overflow(over_v, over_spans_v, sub_v));
+		ufbxi_check_err(&tc->error, !ufbxi_does_overflow(over_uv, over_u, over_v));
 	}
 
-	// Build a KD-tree out of the collected reflex vertices.
-	uint32_t num_skip_indices = (1u << (UFBXI_KD_FAST_DEPTH + 1)) - 1;
-	uint32_t kd_slow_indices = num_kd_indices > num_skip_indices ? num_kd_indices - num_skip_indices : 0;
-	ufbxi_ignore(kd_slow_indices);
-	ufbx_assert(kd_slow_indices + face.num_indices * 2 <= num_indices);
-	ufbxi_kd_build(nc, kd_indices, kd_tmp, num_kd_indices, 0, 0, 0);
+	size_t faces_u = (spans_u - 1) * sub_u;
+	size_t faces_v = (spans_v - 1) * sub_v;
 
-	uint32_t *edges = indices + num_indices - face.num_indices * 2;
+	size_t indices_u = spans_u + (spans_u - 1) * (sub_u - 1);
+	size_t indices_v = spans_v + (spans_v - 1) * (sub_v - 1);
 
-	// Initialize `edges` to be a connectivity structure where:
-	//  `edges[2*i + 0]` is the previous vertex of `i`
-	//  `edges[2*i + 1]` is the next vertex of `i`
-	// When clipped we mark indices with the high bit (0x80000000)
-	for (uint32_t i = 0; i < face.num_indices; i++) {
-		edges[i*2 + 0] = i > 0 ? i - 1 : face.num_indices - 1;
-		edges[i*2 + 1] = i + 1 < face.num_indices ? i + 1 : 0;
-	}
+	size_t num_faces = faces_u * faces_v;
+	size_t num_indices = indices_u * indices_v;
+	ufbxi_check_err(&tc->error, num_indices <= INT32_MAX);
 
-	// Core of the ear clipping algorithm.
-	// Iterate through the polygon corners looking for potential ears satisfying:
-	//   - Angle must be less than 180deg
-	//   - The triangle formed by the two edges must be contained within the polygon
-	// As these properties change only locally between modifications we only need
-	// to iterate the polygon once if we move backwards one step every time we clip an ear.
-	uint32_t indices_left = face.num_indices;
-	{
-		ufbxi_kd_triangle tri;
+	uint32_t *position_ix = ufbxi_push(&tc->tmp, uint32_t, num_indices);
+	ufbx_vec3 *positions = ufbxi_push(&tc->result, ufbx_vec3, num_indices + 1);
+	ufbx_vec3 *normals = ufbxi_push(&tc->result, ufbx_vec3, num_indices + 1);
+	ufbx_vec2 *uvs = ufbxi_push(&tc->result, ufbx_vec2, num_indices + 1);
+	ufbx_vec3 *tangents = ufbxi_push(&tc->result, ufbx_vec3, num_indices + 1);
+	ufbx_vec3 *bitangents = ufbxi_push(&tc->result, ufbx_vec3, num_indices + 1);
+	ufbxi_check_err(&tc->error, position_ix && uvs && tangents && bitangents);
 
-		uint32_t ix = 1;
-		ufbx_vec2 a = ufbxi_ngon_project(nc, pos.values.data[pos.indices.data[face.index_begin + 0]]);
-		ufbx_vec2 b = ufbxi_ngon_project(nc, pos.values.data[pos.indices.data[face.index_begin + 1]]);
-		ufbx_vec2 c = ufbxi_ngon_project(nc, pos.values.data[pos.indices.data[face.index_begin + 2]]);
-		bool prev_was_reflex = false;
+	*positions++ = ufbx_zero_vec3;
+	*normals++ = ufbx_zero_vec3;
+	*uvs++ = ufbx_zero_vec2;
+	*tangents++ = ufbx_zero_vec3;
+	*bitangents++ = ufbx_zero_vec3;
 
-		uint32_t num_steps = 0;
+	uint32_t num_positions = 0;
 
-		while (indices_left > 3) {
-			uint32_t prev = edges[ix*2 + 0];
-			uint32_t next = edges[ix*2 + 1];
-			if (ufbxi_orient2d(a, b, c) > 0.0f) {
+	for (size_t span_v = 0; span_v < spans_v; span_v++) {
+		size_t splits_v = span_v + 1 == spans_v ? 1 : sub_v;
 
-				tri.points[0] = a;
-				tri.points[1] = b;
-				tri.points[2] = c;
-				tri.indices[0] = prev;
-				tri.indices[1] = ix;
-				tri.indices[2] = next;
-				tri.min_t[0] = ufbxi_min_real(ufbxi_min_real(a.x, b.x), c.x);
-				tri.min_t[1] = ufbxi_min_real(ufbxi_min_real(a.y, b.y), c.y);
-				tri.max_t[0] = ufbxi_max_real(ufbxi_max_real(a.x, b.x), c.x);
-				tri.max_t[1] = ufbxi_max_real(ufbxi_max_real(a.y, b.y), c.y);
+		for (size_t split_v = 0; split_v < splits_v; split_v++) {
+			size_t ix_v = span_v * sub_v + split_v;
+			ufbx_assert(ix_v < indices_v);
 
-				// If there is no reflex angle contained within the triangle formed
-				// by `{ a, b, c }` connect the vertices `a - c` (prev, next) directly.
-				if (!ufbxi_kd_check_fast(nc, &tri, 0, 0, 0)) {
+			ufbx_real v = surface->basis_v.spans.data[span_v];
+			if (split_v > 0) {
+				ufbx_real t = (ufbx_real)split_v / (ufbx_real)splits_v;
+				v = v * (1.0f - t) + t * surface->basis_v.spans.data[span_v + 1];
+			}
+			ufbx_real original_v = v;
+			if (span_v + 1 == spans_v && !open_v) {
+				v = surface->basis_v.spans.data[0];
+			}
 
-					// Mark as clipped
-					edges[ix*2 + 0] |= 0x80000000;
-					edges[ix*2 + 1] |= 0x80000000;
+			for (size_t span_u = 0; span_u < spans_u; span_u++) {
+				size_t splits_u = span_u + 1 == spans_u ? 1 : sub_u;
+				for (size_t split_u = 0; split_u < splits_u; split_u++) {
+					size_t ix_u = span_u * sub_u + split_u;
+					ufbx_assert(ix_u < indices_u);
 
-					edges[next*2 + 0] = prev;
-					edges[prev*2 + 1] = next;
+					ufbx_real u = surface->basis_u.spans.data[span_u];
+					if (split_u > 0) {
+						ufbx_real t = (ufbx_real)split_u / (ufbx_real)splits_u;
+						u = u * (1.0f - t) + t * surface->basis_u.spans.data[span_u + 1];
+					}
+					ufbx_real original_u = u;
+					if (span_u + 1 == spans_u && !open_u) {
+						u = surface->basis_u.spans.data[0];
+					}
 
-					indices_left -= 1;
+					ufbx_surface_point point = ufbx_evaluate_nurbs_surface(surface, u, v);
+					ufbx_vec3 pos = point.position;
 
-					// Move backwards only if the previous was reflex as now it would
-					// cover a superset of the previous area, failing the intersection test.
-					if (prev_was_reflex) {
-						prev_was_reflex = false;
-						ix = prev;
-						b = a;
-						uint32_t prev_prev = edges[prev*2 + 0];
-						a = ufbxi_ngon_project(nc, pos.values.data[pos.indices.data[face.index_begin + prev_prev]]);
-					} else {
-						ix = next;
-						b = c;
-						uint32_t next_next = edges[next*2 + 1];
-						c = ufbxi_ngon_project(nc, pos.values.data[pos.indices.data[face.index_begin + next_next]]);
+					ufbx_vec3 tangent_u = ufbxi_slow_normalize3(&point.derivative_u);
+					ufbx_vec3 tangent_v = ufbxi_slow_normalize3(&point.derivative_v);
+
+					// Check if there's any wrapped positions that we could match
+					size_t neighbors[5];
+					size_t num_neighbors = 0;
+
+					if ((span_v == 0 && (span_u > 0 || split_u > 0)) || (span_u == 0 && (span_v > 0 || split_v > 0))) {
+						// Top/left
+						neighbors[num_neighbors++] = 0;
+					}
+					if (span_v + 1 == spans_v) {
+						// Bottom
+						neighbors[num_neighbors++] = ix_u;
+						if (span_u > 0 || split_u > 0) {
+							neighbors[num_neighbors++] = ix_v * indices_u;
+						}
+					}
+					if (span_u + 1 == spans_u) {
+						// Right
+						neighbors[num_neighbors++] = ix_v * indices_u;
+						if (span_v > 0 || split_v > 0) {
+							neighbors[num_neighbors++] = indices_u - 1;
+						}
 					}
-					continue;
-				}
 
-				prev_was_reflex = false;
-			} else {
-				prev_was_reflex = true;
-			}
+					size_t ix = ix_v * indices_u + ix_u;
 
-			// Continue forward
-			ix = next;
-			a = b;
-			b = c;
-			next = edges[next*2 + 1];
-			c = ufbxi_ngon_project(nc, pos.values.data[pos.indices.data[face.index_begin + next]]);
-			num_steps++;
+					uint32_t pos_ix = num_positions;
+					for (size_t i = 0; i < num_neighbors; i++) {
+						size_t nb_ix = neighbors[i];
+						ufbx_assert(nb_ix < ix);
+						uint32_t nb_pos_ix = position_ix[nb_ix];
+						ufbx_vec3 nb_pos = positions[nb_pos_ix];
+						ufbx_real dx = nb_pos.x - pos.x;
+						ufbx_real dy = nb_pos.y - pos.y;
+						ufbx_real dz = nb_pos.z - pos.z;
+						ufbx_real delta = dx*dx + dy*dy + dz*dz;
+						if (delta < 0.0000001f) { // TODO: Configurable / something more rigorous
+							pos_ix = nb_pos_ix;
+							break;
+						}
+					}
 
-			// If we have walked around the entire polygon it is irregular and
-			// ear cutting won't find any more triangles.
-			// TODO: This could be stricter?
-			if (num_steps >= face.num_indices*2) break;
+					position_ix[ix] = pos_ix;
+					if (pos_ix == num_positions) {
+						positions[pos_ix] = pos;
+						num_positions = pos_ix + 1;
+					}
+					uvs[ix].x = original_u;
+					uvs[ix].y = original_v;
+					tangents[ix] = tangent_u;
+					bitangents[ix] = tangent_v;
+				}
+			}
 		}
+	}
 
-		// Fallback: Cut non-ears until the polygon is completed.
-		// TODO: Could do something better here..
-		while (indices_left > 3) {
-			uint32_t prev = edges[ix*2 + 0];
-			uint32_t next = edges[ix*2 + 1];
+	ufbx_face *faces = ufbxi_push(&tc->result, ufbx_face, num_faces);
+	uint32_t *vertex_ix = ufbxi_push(&tc->result, uint32_t, num_faces * 4);
+	uint32_t *attrib_ix = ufbxi_push(&tc->result, uint32_t, num_faces * 4);
+	ufbxi_check_err(&tc->error, faces && vertex_ix && attrib_ix);
 
-			// Mark as clipped
-			edges[ix*2 + 0] |= 0x80000000;
-			edges[ix*2 + 1] |= 0x80000000;
+	size_t face_ix = 0;
+	size_t dst_index = 0;
 
-			edges[prev*2 + 1] = next;
-			edges[next*2 + 0] = prev;
+	size_t num_triangles = 0;
 
-			indices_left -= 1;
-			ix = next;
-		}
+	for (size_t face_v = 0; face_v < faces_v; face_v++) {
+		for (size_t face_u = 0; face_u < faces_u; face_u++) {
 
-		// Now we have a single triangle left at `ix`.
-		edges[ix*2 + 0] |= 0x80000000;
-		edges[ix*2 + 1] |= 0x80000000;
-	}
+			attrib_ix[dst_index + 0] = (uint32_t)((face_v + 0) * indices_u + (face_u + 0));
+			attrib_ix[dst_index + 1] = (uint32_t)((face_v + 0) * indices_u + (face_u + 1));
+			attrib_ix[dst_index + 2] = (uint32_t)((face_v + 1) * indices_u + (face_u + 1));
+			attrib_ix[dst_index + 3] = (uint32_t)((face_v + 1) * indices_u + (face_u + 0));
 
-	// Expand the adjacency information `edges` into proper triangles.
-	// Care needs to be taken here as both refer to the same memory area:
-	// The last 4 triangles may overlap in source and destination so we write
-	// them to a stack buffer and copy them over in the end.
-	uint32_t max_triangles = face.num_indices - 2;
-	uint32_t num_triangles = 0, num_last_triangles = 0;
-	uint32_t last_triangles[4*3];
+			vertex_ix[dst_index + 0] = position_ix[attrib_ix[dst_index + 0]];
+			vertex_ix[dst_index + 1] = position_ix[attrib_ix[dst_index + 1]];
+			vertex_ix[dst_index + 2] = position_ix[attrib_ix[dst_index + 2]];
+			vertex_ix[dst_index + 3] = position_ix[attrib_ix[dst_index + 3]];
 
-	uint32_t index_begin = face.index_begin;
-	for (uint32_t ix = 0; ix < face.num_indices; ix++) {
-		uint32_t prev = edges[ix*2 + 0];
-		uint32_t next = edges[ix*2 + 1];
-		if (!(prev & 0x80000000)) continue;
+			bool is_triangle = false;
+			for (size_t prev_ix = 0; prev_ix < 4; prev_ix++) {
+				size_t next_ix = (prev_ix + 1) % 4;
+				if (vertex_ix[dst_index + prev_ix] == vertex_ix[dst_index + next_ix]) {
+					for (size_t i = next_ix; i < 3; i++) {
+						attrib_ix[dst_index + i] = attrib_ix[dst_index + i + 1];
+						vertex_ix[dst_index + i] = vertex_ix[dst_index + i + 1];
+					}
+					is_triangle = true;
+					break;
+				}
+			}
 
-		uint32_t *dst = indices + num_triangles * 3;
-		if (num_triangles + 4 >= max_triangles) {
-			dst = last_triangles + num_last_triangles * 3;
-			num_last_triangles++;
+			faces[face_ix].index_begin = (uint32_t)dst_index;
+			faces[face_ix].num_indices = is_triangle ? 3 : 4;
+			dst_index += is_triangle ? 3 : 4;
+			num_triangles += is_triangle ? 1 : 2;
+			face_ix++;
 		}
-
-		dst[0] = index_begin + (prev & 0x7fffffff);
-		dst[1] = index_begin + ix;
-		dst[2] = index_begin + (next & 0x7fffffff);
-		num_triangles++;
 	}
 
-	// Copy over the last triangles
-	ufbx_assert(num_triangles == max_triangles);
-	memcpy(indices + (max_triangles - num_last_triangles) * 3, last_triangles, num_last_triangles * 3 * sizeof(uint32_t));
+	ufbxi_check_err(&tc->error, positions && normals);
 
-	return num_triangles;
-}
+	mesh->element.name.data = ufbxi_empty_char;
+	mesh->element.type = UFBX_ELEMENT_MESH;
+	mesh->element.typed_id = UINT32_MAX;
+	mesh->element.element_id = UINT32_MAX;
 
-#endif
-
-static int ufbxi_cmp_topo_index_prev_next(const void *va, const void *vb)
-{
-	const ufbx_topo_edge *a = (const ufbx_topo_edge*)va, *b = (const ufbx_topo_edge*)vb;
-	if ((int32_t)a->prev != (int32_t)b->prev) return (int32_t)a->prev < (int32_t)b->prev ? -1 : +1;
-	if ((int32_t)a->next != (int32_t)b->next) return (int32_t)a->next < (int32_t)b->next ? -1 : +1;
-	return 0;
-}
-
-static int ufbxi_cmp_topo_index_index(const void *va, const void *vb)
-{
-	const ufbx_topo_edge *a = (const ufbx_topo_edge*)va, *b = (const ufbx_topo_edge*)vb;
-	if ((int32_t)a->index != (int32_t)b->index) return (int32_t)a->index < (int32_t)b->index ? -1 : +1;
-	return 0;
-}
+	mesh->vertices.data = positions;
+	mesh->vertices.count = num_positions;
+	mesh->num_vertices = num_positions;
+	mesh->vertex_indices.data = vertex_ix;
+	mesh->vertex_indices.count = dst_index;
 
-ufbxi_noinline static void ufbxi_compute_topology(const ufbx_mesh *mesh, ufbx_topo_edge *topo)
-{
-	size_t num_indices = mesh->num_indices;
+	mesh->faces.data = faces;
+	mesh->faces.count = num_faces;
 
-	// Temporarily use `prev` and `next` for vertices
-	for (uint32_t fi = 0; fi < mesh->num_faces; fi++) {
-		ufbx_face face = mesh->faces.data[fi];
-		for (uint32_t pi = 0; pi < face.num_indices; pi++) {
-			ufbx_topo_edge *te = &topo[face.index_begin + pi];
-			uint32_t ni = (pi + 1) % face.num_indices;
-			uint32_t va = mesh->vertex_indices.data[face.index_begin + pi];
-			uint32_t vb = mesh->vertex_indices.data[face.index_begin + ni];
+	mesh->vertex_position.exists = true;
+	mesh->vertex_position.values.data = positions;
+	mesh->vertex_position.values.count = num_positions;
+	mesh->vertex_position.indices.data = vertex_ix;
+	mesh->vertex_position.indices.count = dst_index;
+	mesh->vertex_position.unique_per_vertex = true;
 
-			if (vb < va) {
-				uint32_t vt = va; va = vb; vb = vt;
-			}
-			te->index = face.index_begin + pi;
-			te->twin = UFBX_NO_INDEX;
-			te->edge = UFBX_NO_INDEX;
-			te->prev = va;
-			te->next = vb;
-			te->face = fi;
-			te->flags = (ufbx_topo_flags)0;
-		}
-	}
+	mesh->vertex_uv.exists = true;
+	mesh->vertex_uv.values.data = uvs;
+	mesh->vertex_uv.values.count = dst_index;
+	mesh->vertex_uv.indices.data = attrib_ix;
+	mesh->vertex_uv.indices.count = dst_index;
 
-	// TODO: Macro unstable/non allocating sort
-	qsort(topo, num_indices, sizeof(ufbx_topo_edge), &ufbxi_cmp_topo_index_prev_next);
+	mesh->vertex_normal.exists = true;
+	mesh->vertex_normal.values.data = normals;
+	mesh->vertex_normal.values.count = num_positions;
+	mesh->vertex_normal.indices.data = vertex_ix;
+	mesh->vertex_normal.indices.count = dst_index;
 
-	if (mesh->edges.data) {
-		for (uint32_t ei = 0; ei < mesh->num_edges; ei++) {
-			ufbx_edge edge = mesh->edges.data[ei];
-			uint32_t va = mesh->vertex_indices.data[edge.a];
-			uint32_t vb = mesh->vertex_indices.data[edge.b];
-			if (vb < va) {
-				uint32_t vt = va; va = vb; vb = vt;
-			}
+	mesh->vertex_tangent.exists = true;
+	mesh->vertex_tangent.values.data = tangents;
+	mesh->vertex_tangent.values.count = dst_index;
+	mesh->vertex_tangent.indices.data = attrib_ix;
+	mesh->vertex_tangent.indices.count = dst_index;
 
-			size_t ix = num_indices;
-			ufbxi_macro_lower_bound_eq(ufbx_topo_edge, 32, &ix, topo, 0, num_indices,
-				(a->prev == va ? a->next < vb : a->prev < va), (a->prev == va && a->next == vb));
+	mesh->vertex_bitangent.exists = true;
+	mesh->vertex_bitangent.values.data = bitangents;
+	mesh->vertex_bitangent.values.count = dst_index;
+	mesh->vertex_bitangent.indices.data = attrib_ix;
+	mesh->vertex_bitangent.indices.count = dst_index;
 
-			for (; ix < num_indices && topo[ix].prev == va && topo[ix].next == vb; ix++) {
-				topo[ix].edge = ei;
-			}
-		}
-	}
+	mesh->num_faces = num_faces;
+	mesh->num_triangles = num_triangles;
+	mesh->num_indices = dst_index;
+	mesh->max_face_triangles = 2;
 
-	// Connect paired edges
-	for (size_t i0 = 0; i0 < num_indices; ) {
-		size_t i1 = i0;
+	if (surface->material) {
+		mesh->face_material.data = ufbxi_push_zero(&tc->result, uint32_t, num_faces);
+		ufbxi_check_err(&tc->error, mesh->face_material.data);
 
-		uint32_t a = topo[i0].prev, b = topo[i0].next;
-		while (i1 + 1 < num_indices && topo[i1 + 1].prev == a && topo[i1 + 1].next == b) i1++;
+		ufbx_material **mat = ufbxi_push_zero(&tc->result, ufbx_material*, 1);
+		ufbxi_check_err(&tc->error, mat);
 
-		if (i1 == i0 + 1) {
-			topo[i0].twin = topo[i1].index;
-			topo[i1].twin = topo[i0].index;
-		} else if (i1 > i0 + 1) {
-			for (size_t i = i0; i <= i1; i++) {
-				topo[i].flags = (ufbx_topo_flags)(topo[i].flags | UFBX_TOPO_NON_MANIFOLD);
-			}
-		}
+		*mat = surface->material;
+		mesh->materials.data = mat;
+		mesh->materials.count = 1;
+	}
 
-		i0 = i1 + 1;
+	if (!tc->opts.skip_mesh_parts) {
+		mesh->material_parts.count = 1;
+		mesh->material_parts.data = ufbxi_push_zero(&tc->result, ufbx_mesh_part, 1);
+		ufbxi_check_err(&tc->error, mesh->material_parts.data);
 	}
 
-	// TODO: Macro unstable/non allocating sort
-	qsort(topo, num_indices, sizeof(ufbx_topo_edge), &ufbxi_cmp_topo_index_index);
+	ufbxi_check_err(&tc->error, ufbxi_finalize_mesh_material(&tc->result, &tc->error, mesh));
+	ufbxi_check_err(&tc->error, ufbxi_finalize_mesh(&tc->result, &tc->error, mesh));
 
-	// Fix `prev` and `next` to the actual index values
-	for (uint32_t fi = 0; fi < mesh->num_faces; fi++) {
-		ufbx_face face = mesh->faces.data[fi];
-		for (uint32_t i = 0; i < face.num_indices; i++) {
-			ufbx_topo_edge *to = &topo[face.index_begin + i];
-			to->prev = (uint32_t)(face.index_begin + (i + face.num_indices - 1) % face.num_indices);
-			to->next = (uint32_t)(face.index_begin + (i + 1) % face.num_indices);
+	mesh->generated_normals = true;
+	ufbx_compute_normals(mesh, &mesh->vertex_position,
+		mesh->vertex_normal.indices.data, mesh->vertex_normal.indices.count,
+		mesh->vertex_normal.values.data, mesh->vertex_normal.values.count);
+
+	if (surface->flip_normals) {
+		ufbxi_nounroll ufbxi_for_list(ufbx_vec3, normal, mesh->vertex_normal.values) {
+			normal->x *= -1.0f;
+			normal->y *= -1.0f;
+			normal->z *= -1.0f;
 		}
 	}
-}
 
-static bool ufbxi_is_edge_smooth(const ufbx_mesh *mesh, const ufbx_topo_edge *topo, size_t num_topo, uint32_t index, bool assume_smooth)
-{
-	ufbxi_ignore(num_topo);
-	ufbx_assert((size_t)index < num_topo);
-	if (mesh->edge_smoothing.data) {
-		uint32_t edge = topo[index].edge;
-		if (edge != UFBX_NO_INDEX && mesh->edge_smoothing.data[edge]) return true;
-	}
+	tc->imp = ufbxi_push(&tc->result, ufbxi_mesh_imp, 1);
+	ufbxi_check_err(&tc->error, tc->imp);
 
-	if (mesh->face_smoothing.data) {
-		if (mesh->face_smoothing.data[topo[index].face]) return true;
-		uint32_t twin = topo[index].twin;
-		if (twin != UFBX_NO_INDEX) {
-			if (mesh->face_smoothing.data[topo[twin].face]) return true;
-		}
-	}
+	ufbxi_init_ref(&tc->imp->refcount, UFBXI_MESH_IMP_MAGIC, &(ufbxi_get_imp(ufbxi_scene_imp, surface->element.scene))->refcount);
 
-	if (!mesh->edge_smoothing.data && !mesh->face_smoothing.data && mesh->vertex_normal.exists) {
-		uint32_t twin = topo[index].twin;
-		if (twin != UFBX_NO_INDEX && mesh->vertex_normal.exists) {
-			ufbx_assert((size_t)twin < num_topo);
-			ufbx_vec3 a0 = ufbx_get_vertex_vec3(&mesh->vertex_normal, index);
-			ufbx_vec3 a1 = ufbx_get_vertex_vec3(&mesh->vertex_normal, topo[index].next);
-			ufbx_vec3 b0 = ufbx_get_vertex_vec3(&mesh->vertex_normal, topo[twin].next);
-			ufbx_vec3 b1 = ufbx_get_vertex_vec3(&mesh->vertex_normal, twin);
-			if (a0.x == b0.x && a0.y == b0.y && a0.z == b0.z) return true;
-			if (a1.x == b1.x && a1.y == b1.y && a1.z == b1.z) return true;
-		}
-	} else if (assume_smooth) {
-		return true;
-	}
+	tc->imp->magic = UFBXI_MESH_IMP_MAGIC;
+	tc->imp->mesh = tc->mesh;
+	tc->imp->refcount.ator = tc->ator_result;
+	tc->imp->refcount.buf = tc->result;
+	tc->imp->mesh.subdivision_evaluated = true;
 
-	return false;
+	return 1;
 }
 
-// -- Subdivision
+#endif
 
-#if UFBXI_FEATURE_SUBDIVISION
+// -- Topology
 
-typedef struct {
-	const void *data;
-	ufbx_real weight;
-} ufbxi_subdivide_input;
+#if UFBXI_FEATURE_KD
 
-typedef int ufbxi_subdivide_sum_fn(void *user, void *output, const ufbxi_subdivide_input *inputs, size_t num_inputs);
+typedef struct {
+	ufbx_real split;
+	uint32_t index;
+	uint32_t slow_left;
+	uint32_t slow_right;
+	uint32_t slow_end;
+} ufbxi_kd_node;
 
 typedef struct {
-	ufbxi_subdivide_sum_fn *sum_fn;
-	void *sum_user;
+	ufbx_face face;
+	ufbx_vertex_vec3 positions;
+	ufbx_vec3 axes[3];
+	ufbxi_kd_node kd_nodes[1 << (UFBXI_KD_FAST_DEPTH + 1)];
+	uint32_t *kd_indices;
 
-	const void *values;
-	size_t stride;
+	// Temporary
+	ufbx_vec3 cur_axis_dir;
+	ufbx_face cur_face;
+} ufbxi_ngon_context;
 
-	const uint32_t *indices;
+typedef struct {
+	ufbx_real min_t[2];
+	ufbx_real max_t[2];
+	ufbx_vec2 points[3];
+	uint32_t indices[3];
+} ufbxi_kd_triangle;
 
-	bool check_split_data;
-	bool ignore_indices;
+ufbxi_forceinline static ufbx_vec2 ufbxi_ngon_project(ufbxi_ngon_context *nc, ufbx_vec3 point)
+{
+	ufbx_vec2 p;
+	p.x = ufbxi_dot3(nc->axes[0], point);
+	p.y = ufbxi_dot3(nc->axes[1], point);
+	return p;
+}
 
-	ufbx_subdivision_boundary boundary;
+ufbxi_forceinline static ufbx_real ufbxi_orient2d(ufbx_vec2 a, ufbx_vec2 b, ufbx_vec2 c)
+{
+	return (b.x - a.x)*(c.y - a.y) - (b.y - a.y)*(c.x - a.x);
+}
 
-} ufbxi_subdivide_layer_input;
+ufbxi_forceinline static bool ufbxi_kd_check_point(ufbxi_ngon_context *nc, const ufbxi_kd_triangle *tri, uint32_t index, ufbx_vec3 point)
+{
+	if (index == tri->indices[0] || index == tri->indices[1] || index == tri->indices[2]) return false;
+	ufbx_vec2 p = ufbxi_ngon_project(nc, point);
 
-typedef struct {
-	void *values;
-	size_t num_values;
-	uint32_t *indices;
-	size_t num_indices;
-	bool unique_per_vertex;
-} ufbxi_subdivide_layer_output;
+	ufbx_real u = ufbxi_orient2d(p, tri->points[0], tri->points[1]);
+	ufbx_real v = ufbxi_orient2d(p, tri->points[1], tri->points[2]);
+	ufbx_real w = ufbxi_orient2d(p, tri->points[2], tri->points[0]);
 
-typedef struct {
-	ufbx_subdivision_weight *weights;
-	size_t num_weights;
-} ufbxi_subdivision_vertex_weights;
+	if (u <= 0.0f && v <= 0.0f && w <= 0.0f) return true;
+	if (u >= 0.0f && v >= 0.0f && w >= 0.0f) return true;
+	return false;
+}
 
-typedef struct {
-	ufbxi_mesh_imp *imp;
-
-	ufbx_error error;
-
-	ufbx_mesh *src_mesh_ptr;
-	ufbx_mesh src_mesh;
-	ufbx_mesh dst_mesh;
-	ufbx_topo_edge *topo;
-	size_t num_topo;
-
-	ufbx_subdivide_opts opts;
-
-	ufbxi_allocator ator_result;
-	ufbxi_allocator ator_tmp;
+// Recursion limited by 32-bit indices in input, minus halvings from `ufbxi_kd_check_fast()`
+ufbxi_noinline static bool ufbxi_kd_check_slow(ufbxi_ngon_context *nc, const ufbxi_kd_triangle *tri, uint32_t begin, uint32_t count, uint32_t axis)
+	ufbxi_recursive_function(bool, ufbxi_kd_check_slow, (nc, tri, begin, count, axis), 32 - UFBXI_KD_FAST_DEPTH,
+		(ufbxi_ngon_context *nc, const ufbxi_kd_triangle *tri, uint32_t begin, uint32_t count, uint32_t axis))
+{
+	ufbx_vertex_vec3 pos = nc->positions;
+	uint32_t *kd_indices = nc->kd_indices;
 
-	ufbxi_buf result;
-	ufbxi_buf tmp;
-	ufbxi_buf source;
+	while (count > 0) {
+		uint32_t num_left = count / 2;
+		uint32_t begin_right = begin + num_left + 1;
+		uint32_t num_right = count - (num_left + 1);
 
-	ufbxi_subdivide_input *inputs;
-	size_t inputs_cap;
+		uint32_t index = kd_indices[begin + num_left];
+		ufbx_vec3 point = pos.values.data[pos.indices.data[nc->face.index_begin + index]];
+		ufbx_real split = ufbxi_dot3(point, nc->axes[axis]);
+		bool hit_left = tri->min_t[axis] <= split;
+		bool hit_right = tri->max_t[axis] >= split;
 
-	ufbx_real *tmp_vertex_weights;
-	ufbx_subdivision_weight *tmp_weights;
-	size_t total_weights;
-	size_t max_vertex_weights;
+		if (hit_left && hit_right) {
+			if (ufbxi_kd_check_point(nc, tri, index, point)) {
+				return true;
+			}
 
-} ufbxi_subdivide_context;
+			if (ufbxi_kd_check_slow(nc, tri, begin_right, num_right, axis ^ 1)) {
+				return true;
+			}
+		}
 
-static int ufbxi_subdivide_sum_real(void *user, void *output, const ufbxi_subdivide_input *inputs, size_t num_inputs)
-{
-	(void)user;
-	ufbx_real dst = 0.0f;
-	ufbxi_nounroll for (size_t i = 0; i != num_inputs; i++) {
-		ufbx_real src = *(const ufbx_real*)inputs[i].data;
-		ufbx_real weight = inputs[i].weight;
-		dst += src * weight;
+		axis ^= 1;
+		if (hit_left) {
+			count = num_left;
+		} else {
+			begin = begin_right;
+			count = num_right;
+		}
 	}
-	*(ufbx_real*)output = dst;
 
-	return 1;
+	return false;
 }
 
-static int ufbxi_subdivide_sum_vec2(void *user, void *output, const ufbxi_subdivide_input *inputs, size_t num_inputs)
+// Recursion limited by `UFBXI_KD_FAST_DEPTH`
+ufbxi_noinline static bool ufbxi_kd_check_fast(ufbxi_ngon_context *nc, const ufbxi_kd_triangle *tri, uint32_t kd_index, uint32_t axis, uint32_t depth)
+	ufbxi_recursive_function(bool, ufbxi_kd_check_fast, (nc, tri, kd_index, axis, depth), UFBXI_KD_FAST_DEPTH,
+		(ufbxi_ngon_context *nc, const ufbxi_kd_triangle *tri, uint32_t kd_index, uint32_t axis, uint32_t depth))
 {
-	(void)user;
-	ufbx_vec2 dst = { 0 };
-	ufbxi_nounroll for (size_t i = 0; i != num_inputs; i++) {
-		const ufbx_vec2 *src = (const ufbx_vec2*)inputs[i].data;
-		ufbx_real weight = inputs[i].weight;
-		dst.x += src->x * weight;
-		dst.y += src->y * weight;
-	}
-	*(ufbx_vec2*)output = dst;
+	ufbx_vertex_vec3 pos = nc->positions;
 
-	return 1;
-}
+	for (;;) {
+		ufbxi_kd_node node = nc->kd_nodes[kd_index];
+		if (node.slow_end == 0) return false;
 
-static int ufbxi_subdivide_sum_vec3(void *user, void *output, const ufbxi_subdivide_input *inputs, size_t num_inputs)
-{
-	(void)user;
-	ufbx_vec3 dst = { 0 };
-	ufbxi_nounroll for (size_t i = 0; i != num_inputs; i++) {
-		const ufbx_vec3 *src = (const ufbx_vec3*)inputs[i].data;
-		ufbx_real weight = inputs[i].weight;
-		dst.x += src->x * weight;
-		dst.y += src->y * weight;
-		dst.z += src->z * weight;
-	}
-	*(ufbx_vec3*)output = dst;
+		bool hit_left = tri->min_t[axis] <= node.split;
+		bool hit_right = tri->max_t[axis] >= node.split;
 
-	return 1;
-}
+		uint32_t side = hit_left ? 0 : 1;
+		uint32_t child_kd_index = kd_index * 2 + 1 + side;
+		if (hit_left && hit_right) {
 
-static int ufbxi_subdivide_sum_vec4(void *user, void *output, const ufbxi_subdivide_input *inputs, size_t num_inputs)
-{
-	(void)user;
-	ufbx_vec4 dst = { 0 };
-	ufbxi_nounroll for (size_t i = 0; i != num_inputs; i++) {
-		const ufbx_vec4 *src = (const ufbx_vec4*)inputs[i].data;
-		ufbx_real weight = inputs[i].weight;
-		dst.x += src->x * weight;
-		dst.y += src->y * weight;
-		dst.z += src->z * weight;
-		dst.w += src->w * weight;
-	}
-	*(ufbx_vec4*)output = dst;
+			// Check for the point on the split plane
+			ufbx_vec3 point = pos.values.data[pos.indices.data[nc->face.index_begin + node.index]];
+			if (ufbxi_kd_check_point(nc, tri, node.index, point)) {
+				return true;
+			}
 
-	return 1;
+			// Recurse always to the right if we hit both sides
+			if (depth + 1 == UFBXI_KD_FAST_DEPTH) {
+				if (ufbxi_kd_check_slow(nc, tri, node.slow_right, node.slow_end - node.slow_right, axis ^ 1)) {
+					return true;
+				}
+			} else {
+				if (ufbxi_kd_check_fast(nc, tri, child_kd_index + 1, axis ^ 1, depth + 1)) {
+					return true;
+				}
+			}
+		}
+
+		depth++;
+		axis ^= 1;
+		kd_index = child_kd_index;
+
+		if (depth == UFBXI_KD_FAST_DEPTH) {
+			if (hit_left) {
+				return ufbxi_kd_check_slow(nc, tri, node.slow_left, node.slow_right - node.slow_left, axis);
+			} else {
+				return ufbxi_kd_check_slow(nc, tri, node.slow_right, node.slow_end - node.slow_right, axis);
+			}
+		}
+	}
 }
 
-static ufbxi_noinline int ufbxi_cmp_subdivision_weight(const void *va, const void *vb)
+ufbxi_noinline static bool ufbxi_kd_index_less(void *user, const void *va, const void *vb)
 {
-	ufbx_subdivision_weight a = *(const ufbx_subdivision_weight*)va, b = *(const ufbx_subdivision_weight*)vb;
-	ufbxi_dev_assert(a.index != b.index);
-	if (a.weight != b.weight) return a.weight > b.weight ? -1 : +1;
-	return a.index < b.index ? -1 : +1;
+	ufbxi_ngon_context *nc = (ufbxi_ngon_context*)user;
+	ufbx_vertex_vec3 *pos = &nc->positions;
+	const uint32_t a = *(const uint32_t*)va, b = *(const uint32_t*)vb;
+	ufbx_real da = ufbxi_dot3(nc->cur_axis_dir, pos->values.data[pos->indices.data[nc->cur_face.index_begin + a]]);
+	ufbx_real db = ufbxi_dot3(nc->cur_axis_dir, pos->values.data[pos->indices.data[nc->cur_face.index_begin + b]]);
+	return da < db;
 }
 
-static int ufbxi_subdivide_sum_vertex_weights(void *user, void *output, const ufbxi_subdivide_input *inputs, size_t num_inputs)
+// Recursion limited by 32-bit indices in input
+ufbxi_noinline static void ufbxi_kd_build(ufbxi_ngon_context *nc, uint32_t *indices, uint32_t *tmp, uint32_t num, uint32_t axis, uint32_t fast_index, uint32_t depth)
+	ufbxi_recursive_function_void(ufbxi_kd_build, (nc, indices, tmp, num, axis, fast_index, depth), 32,
+		(ufbxi_ngon_context *nc, uint32_t *indices, uint32_t *tmp, uint32_t num, uint32_t axis, uint32_t fast_index, uint32_t depth))
 {
-	ufbxi_subdivide_context *sc = (ufbxi_subdivide_context*)user;
-
-	ufbx_real *vertex_weights = sc->tmp_vertex_weights;
-	ufbx_subdivision_weight *tmp_weights = sc->tmp_weights;
-	size_t num_weights = 0;
-
-	ufbxi_nounroll for (size_t input_ix = 0; input_ix != num_inputs; input_ix++) {
-		ufbxi_subdivision_vertex_weights src = *(const ufbxi_subdivision_vertex_weights*)inputs[input_ix].data;
-		ufbx_real input_weight = inputs[input_ix].weight;
+	if (num == 0) return;
 
-		for (size_t weight_ix = 0; weight_ix < src.num_weights; weight_ix++) {
-			ufbx_real weight = input_weight * src.weights[weight_ix].weight;
-			if (weight < 1.175494351e-38f) continue;
+	ufbx_vertex_vec3 pos = nc->positions;
+	ufbx_vec3 axis_dir = nc->axes[axis];
+	ufbx_face face = nc->face;
 
-			uint32_t vx = src.weights[weight_ix].index;
-			ufbxi_dev_assert(vx < sc->src_mesh.num_vertices);
+	nc->cur_axis_dir = axis_dir;
+	nc->cur_face = face;
 
-			ufbx_real prev = vertex_weights[vx];
-			vertex_weights[vx] = prev + weight;
-			if (prev == 0.0f) {
-				tmp_weights[num_weights++].index = vx;
-			}
-		}
-	}
+	// Sort the remaining indices based on the axis
+	ufbxi_stable_sort(sizeof(uint32_t), 16, indices, tmp, num, &ufbxi_kd_index_less, nc);
 
-	ufbxi_nounroll for (size_t i = 0; i != num_weights; i++) {
-		uint32_t vx = tmp_weights[i].index;
-		tmp_weights[i].weight = vertex_weights[vx];
-		vertex_weights[vx] = 0.0f;
-	}
+	uint32_t num_left = num / 2;
+	uint32_t begin_right = num_left + 1;
+	uint32_t num_right = num - begin_right;
+	uint32_t dst_right = num_left + 1;
+	if (depth < UFBXI_KD_FAST_DEPTH) {
+		uint32_t skip_left = 1u << (UFBXI_KD_FAST_DEPTH - depth - 1);
+		dst_right = dst_right > skip_left ? dst_right - skip_left : 0;
 
-	qsort(tmp_weights, num_weights, sizeof(ufbx_subdivision_weight), ufbxi_cmp_subdivision_weight);
+		uint32_t index = indices[num_left];
+		ufbxi_kd_node *kd = &nc->kd_nodes[fast_index];
 
-	if (num_weights > sc->max_vertex_weights) {
-		num_weights = sc->max_vertex_weights;
+		kd->split = ufbxi_dot3(axis_dir, pos.values.data[pos.indices.data[face.index_begin + index]]);
+		kd->index = index;
 
-		// Normalize weights
-		ufbx_real prefix_weight = 0.0f;
-		ufbxi_nounroll for (size_t i = 0; i != num_weights; i++) {
-			prefix_weight += tmp_weights[i].weight;
-		}
-		ufbxi_nounroll for (size_t i = 0; i != num_weights; i++) {
-			tmp_weights[i].weight /= prefix_weight;
+		if (depth + 1 == UFBXI_KD_FAST_DEPTH) {
+			kd->slow_left = (uint32_t)(indices - nc->kd_indices);
+			kd->slow_right = kd->slow_left + num_left;
+			kd->slow_end = kd->slow_right + num_right;
+		} else {
+			kd->slow_left = UINT32_MAX;
+			kd->slow_right = UINT32_MAX;
+			kd->slow_end = UINT32_MAX;
 		}
 	}
 
-	sc->total_weights += num_weights;
-	ufbx_subdivision_weight *weights = ufbxi_push_copy(&sc->tmp, ufbx_subdivision_weight, num_weights, tmp_weights);
-	ufbxi_check_err(&sc->error, weights);
+	uint32_t child_fast = fast_index * 2 + 1;
+	ufbxi_kd_build(nc, indices, tmp, num_left, axis ^ 1, child_fast + 0, depth + 1);
 
-	ufbxi_subdivision_vertex_weights *dst = (ufbxi_subdivision_vertex_weights*)output;
-	dst->weights = weights;
-	dst->num_weights = num_weights;
+	if (dst_right != begin_right) {
+		memmove(indices + dst_right, indices + begin_right, num_right * sizeof(uint32_t));
+	}
 
-	return 1;
+	ufbxi_kd_build(nc, indices + dst_right, tmp, num_right, axis ^ 1, child_fast + 1, depth + 1);
 }
 
-static ufbxi_subdivide_sum_fn *ufbxi_real_sum_fns[] = {
-	&ufbxi_subdivide_sum_real,
-	&ufbxi_subdivide_sum_vec2,
-	&ufbxi_subdivide_sum_vec3,
-	&ufbxi_subdivide_sum_vec4,
-};
+#endif
 
-ufbxi_noinline static bool ufbxi_is_edge_split(const ufbxi_subdivide_layer_input *input, const ufbx_topo_edge *topo, uint32_t index)
+#if UFBXI_FEATURE_TRIANGULATION
+
+ufbxi_noinline static void ufbxi_ngon_setup_axes(ufbxi_ngon_context *nc)
 {
-	uint32_t twin = topo[index].twin;
-	if (twin != UFBX_NO_INDEX) {
-		uint32_t a0 = input->indices[index];
-		uint32_t a1 = input->indices[topo[index].next];
-		uint32_t b0 = input->indices[topo[twin].next];
-		uint32_t b1 = input->indices[twin];
-		if (a0 == b0 && a1 == b1) return false;
-		if (!input->check_split_data) return true;
-		size_t stride = input->stride;
-		char *da0 = (char*)input->values + a0 * stride;
-		char *da1 = (char*)input->values + a1 * stride;
-		char *db0 = (char*)input->values + b0 * stride;
-		char *db1 = (char*)input->values + b1 * stride;
-		if (!memcmp(da0, db0, stride) && !memcmp(da1, db1, stride)) return false;
-		return true;
+	// Form an orthonormal basis to project the polygon into a 2D plane
+	ufbx_vec3 normal = ufbx_get_weighted_face_normal(&nc->positions, nc->face);
+	ufbx_real len = ufbxi_length3(normal);
+	if (len > UFBX_EPSILON) {
+		normal = ufbxi_mul3(normal, 1.0f / len);
+	} else {
+		normal.x = 1.0f;
+		normal.y = 0.0f;
+		normal.z = 0.0f;
 	}
 
-	return false;
+	ufbx_vec3 axis;
+	if (normal.x*normal.x < 0.5f) {
+		axis.x = 1.0f;
+		axis.y = 0.0f;
+		axis.z = 0.0f;
+	} else {
+		axis.x = 0.0f;
+		axis.y = 1.0f;
+		axis.z = 0.0f;
+	}
+	nc->axes[0] = ufbxi_slow_normalized_cross3(&axis, &normal);
+	nc->axes[1] = ufbxi_slow_normalized_cross3(&normal, &nc->axes[0]);
+	nc->axes[2] = normal;
 }
 
-static ufbx_real ufbxi_edge_crease(const ufbx_mesh *mesh, bool split, const ufbx_topo_edge *topo, uint32_t index)
+// Fast path for convex polygons: Returns the triangle fan `(0, i, i + 1)` if there are no
+// reflex corners and every fan triangle is front-facing, as the ear clipper in
+// `ufbxi_triangulate_ngon()` produces exactly the same triangles for these polygons.
+ufbxi_noinline static uint32_t ufbxi_triangulate_convex(ufbxi_ngon_context *nc, uint32_t *indices)
 {
-	if (topo[index].twin == UFBX_NO_INDEX) return 1.0f;
-	if (split) return 1.0f;
-	if (mesh->edge_crease.data && topo[index].edge != UFBX_NO_INDEX) return mesh->edge_crease.data[topo[index].edge] * (ufbx_real)10.0;
-	return 0.0f;
+	ufbx_face face = nc->face;
+	ufbx_vertex_vec3 pos = nc->positions;
+	const uint32_t *pos_indices = pos.indices.data + face.index_begin;
+
+	ufbx_vec2 first = ufbxi_ngon_project(nc, pos.values.data[pos_indices[0]]);
+	ufbx_vec2 a = ufbxi_ngon_project(nc, pos.values.data[pos_indices[face.num_indices - 1]]);
+	ufbx_vec2 b = first;
+	for (uint32_t i = 0; i < face.num_indices; i++) {
+		uint32_t next = i + 1 < face.num_indices ? i + 1 : 0;
+		ufbx_vec2 c = ufbxi_ngon_project(nc, pos.values.data[pos_indices[next]]);
+		if (ufbxi_orient2d(a, b, c) < 0.0f) return 0;
+		if (i >= 1 && i + 1 < face.num_indices && !(ufbxi_orient2d(first, b, c) > 0.0f)) return 0;
+		a = b;
+		b = c;
+	}
+
+	uint32_t index_begin = face.index_begin;
+	for (uint32_t i = 1; i + 1 < face.num_indices; i++) {
+		indices[0] = index_begin;
+		indices[1] = index_begin + i;
+		indices[2] = index_begin + i + 1;
+		indices += 3;
+	}
+	return face.num_indices - 2;
 }
 
-static ufbxi_noinline int ufbxi_subdivide_layer(ufbxi_subdivide_context *sc, ufbxi_subdivide_layer_output *output, const ufbxi_subdivide_layer_input *input)
+ufbxi_noinline static uint32_t ufbxi_triangulate_ngon(ufbxi_ngon_context *nc, uint32_t *indices, uint32_t num_indices)
 {
-	ufbx_subdivision_boundary boundary = input->boundary;
+	ufbx_face face = nc->face;
 
-	const ufbx_mesh *mesh = &sc->src_mesh;
-	const ufbx_topo_edge *topo = sc->topo;
-	size_t num_topo = sc->num_topo;
+	uint32_t *kd_indices = indices;
+	nc->kd_indices = kd_indices;
 
-	uint32_t *edge_indices = ufbxi_push(&sc->result, uint32_t, mesh->num_indices);
-	ufbxi_check_err(&sc->error, edge_indices);
+	uint32_t *kd_tmp = indices + face.num_indices;
+	ufbx_vertex_vec3 pos = nc->positions;
 
-	size_t num_edge_values = 0;
-	for (uint32_t ix = 0; ix < (uint32_t)mesh->num_indices; ix++) {
-		uint32_t twin = topo[ix].twin;
-		if (twin < ix && !ufbxi_is_edge_split(input, topo, ix)) {
-			edge_indices[ix] = edge_indices[twin];
-		} else {
-			edge_indices[ix] = (uint32_t)num_edge_values++;
+	// Collect all the reflex corners for intersection testing.
+	uint32_t num_kd_indices = 0;
+	{
+		ufbx_vec2 a = ufbxi_ngon_project(nc, pos.values.data[pos.indices.data[face.index_begin + face.num_indices - 1]]);
+		ufbx_vec2 b = ufbxi_ngon_project(nc, pos.values.data[pos.indices.data[face.index_begin + 0]]);
+		for (uint32_t i = 0; i < face.num_indices; i++) {
+			uint32_t next = i + 1 < face.num_indices ? i + 1 : 0;
+			ufbx_vec2 c = ufbxi_ngon_project(nc, pos.values.data[pos.indices.data[face.index_begin + next]]);
+
+			if (ufbxi_orient2d(a, b, c) < 0.0f) {
+				kd_indices[num_kd_indices++] = i;
+			}
+
+			a = b;
+			b = c;
 		}
 	}
 
-	size_t stride = input->stride;
-	size_t num_initial_values = (num_edge_values + mesh->num_faces + mesh->num_indices);
-	char *values = (char*)ufbxi_push_size(&sc->tmp, stride, num_initial_values);
-	ufbxi_check_err(&sc->error, values);
+	// Build a KD-tree out of the collected reflex vertices.
+	uint32_t num_skip_indices = (1u << (UFBXI_KD_FAST_DEPTH + 1)) - 1;
+	uint32_t kd_slow_indices = num_kd_indices > num_skip_indices ? num_kd_indices - num_skip_indices : 0;
+	ufbxi_ignore(kd_slow_indices);
+	ufbx_assert(kd_slow_indices + face.num_indices * 2 <= num_indices);
+	ufbxi_kd_build(nc, kd_indices, kd_tmp, num_kd_indices, 0, 0, 0);
 
-	char *face_values = values;
-	char *edge_values = face_values + mesh->num_faces * stride;
-	char *vertex_values = edge_values + num_edge_values * stride;
+	uint32_t *edges = indices + num_indices - face.num_indices * 2;
 
-	size_t num_vertex_values = 0;
+	// Initialize `edges` to be a connectivity structure where:
+	//  `edges[2*i + 0]` is the previous vertex of `i`
+	//  `edges[2*i + 1]` is the next vertex of `i`
+	// When clipped we mark indices with the high bit (0x80000000)
+	for (uint32_t i = 0; i < face.num_indices; i++) {
+		edges[i*2 + 0] = i > 0 ? i - 1 : face.num_indices - 1;
+		edges[i*2 + 1] = i + 1 < face.num_indices ? i + 1 : 0;
+	}
 
-	uint32_t *vertex_indices = ufbxi_push(&sc->result, uint32_t, mesh->num_indices);
-	ufbxi_check_err(&sc->error, vertex_indices);
+	// Core of the ear clipping algorithm.
+	// Iterate through the polygon corners looking for potential ears satisfying:
+	//   - Angle must be less than 180deg
+	//   - The triangle formed by the two edges must be contained within the polygon
+	// As these properties change only locally between modifications we only need
+	// to iterate the polygon once if we move backwards one step every time we clip an ear.
+	uint32_t indices_left = face.num_indices;
+	{
+		ufbxi_kd_triangle tri;
 
-	size_t min_inputs = ufbxi_max_sz(32, mesh->max_face_triangles + 2);
-	ufbxi_check_err(&sc->error, ufbxi_grow_array(&sc->ator_tmp, &sc->inputs, &sc->inputs_cap, min_inputs));
-	ufbxi_subdivide_input *inputs = sc->inputs;
+		uint32_t ix = 1;
+		ufbx_vec2 a = ufbxi_ngon_project(nc, pos.values.data[pos.indices.data[face.index_begin + 0]]);
+		ufbx_vec2 b = ufbxi_ngon_project(nc, pos.values.data[pos.indices.data[face.index_begin + 1]]);
+		ufbx_vec2 c = ufbxi_ngon_project(nc, pos.values.data[pos.indices.data[face.index_begin + 2]]);
+		bool prev_was_reflex = false;
 
-	// Assume initially unique per vertex, remove if not the case
-	output->unique_per_vertex = true;
+		uint32_t num_steps = 0;
 
-	bool sharp_corners = false;
-	bool sharp_splits = false;
-	bool sharp_all = false;
+		while (indices_left > 3) {
+			uint32_t prev = edges[ix*2 + 0];
+			uint32_t next = edges[ix*2 + 1];
+			if (ufbxi_orient2d(a, b, c) > 0.0f) {
 
-	switch (boundary) {
-	case UFBX_SUBDIVISION_BOUNDARY_DEFAULT:
-	case UFBX_SUBDIVISION_BOUNDARY_SHARP_NONE:
-	case UFBX_SUBDIVISION_BOUNDARY_LEGACY:
-		// All smooth
-		break;
-	case UFBX_SUBDIVISION_BOUNDARY_SHARP_CORNERS:
-		sharp_corners = true;
-		break;
-	case UFBX_SUBDIVISION_BOUNDARY_SHARP_BOUNDARY:
-		sharp_corners = true;
-		sharp_splits = true;
-		break;
-	case UFBX_SUBDIVISION_BOUNDARY_SHARP_INTERIOR:
-		sharp_all = true;
-		break;
-	default:
-		ufbx_assert(0 && "Bad boundary mode");
-		break;
-	}
+				tri.points[0] = a;
+				tri.points[1] = b;
+				tri.points[2] = c;
+				tri.indices[0] = prev;
+				tri.indices[1] = ix;
+				tri.indices[2] = next;
+				tri.min_t[0] = ufbxi_min_real(ufbxi_min_real(a.x, b.x), c.x);
+				tri.min_t[1] = ufbxi_min_real(ufbxi_min_real(a.y, b.y), c.y);
+				tri.max_t[0] = ufbxi_max_real(ufbxi_max_real(a.x, b.x), c.x);
+				tri.max_t[1] = ufbxi_max_real(ufbxi_max_real(a.y, b.y), c.y);
 
-	ufbxi_subdivide_sum_fn *sum_fn = input->sum_fn;
-	void *sum_user = input->sum_user;
+				// If there is no reflex angle contained within the triangle formed
+				// by `{ a, b, c }` connect the vertices `a - c` (prev, next) directly.
+				if (!ufbxi_kd_check_fast(nc, &tri, 0, 0, 0)) {
 
-	// Mark unused indices as `UFBX_NO_INDEX` so we can patch non-manifold
-	ufbxi_nounroll for (size_t i = 0; i < mesh->num_indices; i++) {
-		vertex_indices[i] = UFBX_NO_INDEX;
-	}
+					// Mark as clipped
+					edges[ix*2 + 0] |= 0x80000000;
+					edges[ix*2 + 1] |= 0x80000000;
 
-	// Face points
-	for (size_t fi = 0; fi < mesh->num_faces; fi++) {
-		ufbx_face face = mesh->faces.data[fi];
-		char *dst = face_values + fi * stride;
+					edges[next*2 + 0] = prev;
+					edges[prev*2 + 1] = next;
 
-		ufbx_real weight = 1.0f / (ufbx_real)face.num_indices;
-		for (uint32_t ci = 0; ci < face.num_indices; ci++) {
-			uint32_t ix = face.index_begin + ci;
-			inputs[ci].data = (const char*)input->values + input->indices[ix] * stride;
-			inputs[ci].weight = weight;
-		}
+					indices_left -= 1;
 
-		ufbxi_check_err(&sc->error, sum_fn(sum_user, dst, inputs, face.num_indices));
-	}
+					// Move backwards only if the previous was reflex as now it would
+					// cover a superset of the previous area, failing the intersection test.
+					if (prev_was_reflex) {
+						prev_was_reflex = false;
+						ix = prev;
+						b = a;
+						uint32_t prev_prev = edges[prev*2 + 0];
+						a = ufbxi_ngon_project(nc, pos.values.data[pos.indices.data[face.index_begin + prev_prev]]);
+					} else {
+						ix = next;
+						b = c;
+						uint32_t next_next = edges[next*2 + 1];
+						c = ufbxi_ngon_project(nc, pos.values.data[pos.indices.data[face.index_begin + next_next]]);
+					}
+					continue;
+				}
 
-	// Edge points
-	for (uint32_t ix = 0; ix < mesh->num_indices; ix++) {
-		char *dst = edge_values + edge_indices[ix] * stride;
+				prev_was_reflex = false;
+			} else {
+				prev_was_reflex = true;
+			}
 
-		uint32_t twin = topo[ix].twin;
-		bool split = ufbxi_is_edge_split(input, topo, ix);
+			// Continue forward
+			ix = next;
+			a = b;
+			b = c;
+			next = edges[next*2 + 1];
+			c = ufbxi_ngon_project(nc, pos.values.data[pos.indices.data[face.index_begin + next]]);
+			num_steps++;
 
-		if (split || (topo[ix].flags & UFBX_TOPO_NON_MANIFOLD) != 0) {
-			output->unique_per_vertex = false;
+			// If we have walked around the entire polygon it is irregular and
+			// ear cutting won't find any more triangles.
+			// TODO: This could be stricter?
+			if (num_steps >= face.num_indices*2) break;
 		}
 
-		ufbx_real crease = 0.0f;
-		if (split || twin == UFBX_NO_INDEX) {
-			crease = 1.0f;
-		} else if (topo[ix].edge != UFBX_NO_INDEX && mesh->edge_crease.data) {
-			crease = mesh->edge_crease.data[topo[ix].edge] * (ufbx_real)10.0;
+		// Fallback: Cut non-ears until the polygon is completed.
+		// TODO: Could do something better here..
+		while (indices_left > 3) {
+			uint32_t prev = edges[ix*2 + 0];
+			uint32_t next = edges[ix*2 + 1];
+
+			// Mark as clipped
+			edges[ix*2 + 0] |= 0x80000000;
+			edges[ix*2 + 1] |= 0x80000000;
+
+			edges[prev*2 + 1] = next;
+			edges[next*2 + 0] = prev;
+
+			indices_left -= 1;
+			ix = next;
 		}
-		if (sharp_all) crease = 1.0f;
 
-		const char *v0 = (const char*)input->values + input->indices[ix] * stride;
-		const char *v1 = (const char*)input->values + input->indices[topo[ix].next] * stride;
+		// Now we have a single triangle left at `ix`.
+		edges[ix*2 + 0] |= 0x80000000;
+		edges[ix*2 + 1] |= 0x80000000;
+	}
 
-		// TODO: Unify
-		if (twin < ix && !split) {
-			// Already calculated
-		} else if (crease <= 0.0f) {
-			const char *f0 = face_values + topo[ix].face * stride;
-			const char *f1 = face_values + topo[twin].face * stride;
-			inputs[0].data = v0;
-			inputs[0].weight = 0.25f;
-			inputs[1].data = v1;
-			inputs[1].weight = 0.25f;
-			inputs[2].data = f0;
-			inputs[2].weight = 0.25f;
-			inputs[3].data = f1;
-			inputs[3].weight = 0.25f;
-			ufbxi_check_err(&sc->error, sum_fn(sum_user, dst, inputs, 4));
-		} else if (crease >= 1.0f) {
-			inputs[0].data = v0;
-			inputs[0].weight = 0.5f;
-			inputs[1].data = v1;
-			inputs[1].weight = 0.5f;
-			ufbxi_check_err(&sc->error, sum_fn(sum_user, dst, inputs, 2));
-		} else if (crease < 1.0f) {
-			const char *f0 = face_values + topo[ix].face * stride;
-			const char *f1 = face_values + topo[twin].face * stride;
-			ufbx_real w0 = 0.25f + 0.25f * crease;
-			ufbx_real w1 = 0.25f - 0.25f * crease;
+	// Expand the adjacency information `edges` into proper triangles.
+	// Care needs to be taken here as both refer to the same memory area:
+	// The last 4 triangles may overlap in source and destination so we write
+	// them to a stack buffer and copy them over in the end.
+	uint32_t max_triangles = face.num_indices - 2;
+	uint32_t num_triangles = 0, num_last_triangles = 0;
+	uint32_t last_triangles[4*3];
 
-			inputs[0].data = v0;
-			inputs[0].weight = w0;
-			inputs[1].data = v1;
-			inputs[1].weight = w0;
-			inputs[2].data = f0;
-			inputs[2].weight = w1;
-			inputs[3].data = f1;
-			inputs[3].weight = w1;
-			ufbxi_check_err(&sc->error, sum_fn(sum_user, dst, inputs, 4));
+	uint32_t index_begin = face.index_begin;
+	for (uint32_t ix = 0; ix < face.num_indices; ix++) {
+		uint32_t prev = edges[ix*2 + 0];
+		uint32_t next = edges[ix*2 + 1];
+		if (!(prev & 0x80000000)) continue;
+
+		uint32_t *dst = indices + num_triangles * 3;
+		if (num_triangles + 4 >= max_triangles) {
+			dst = last_triangles + num_last_triangles * 3;
+			num_last_triangles++;
 		}
+
+		dst[0] = index_begin + (prev & 0x7fffffff);
+		dst[1] = index_begin + ix;
+		dst[2] = index_begin + (next & 0x7fffffff);
+		num_triangles++;
 	}
 
-	// Vertex points
-	for (size_t vi = 0; vi < mesh->num_vertices; vi++) {
-		uint32_t original_start = mesh->vertex_first_index.data[vi];
-		if (original_start == UFBX_NO_INDEX) continue;
+	// Copy over the last triangles
+	ufbx_assert(num_triangles == max_triangles);
+	memcpy(indices + (max_triangles - num_last_triangles) * 3, last_triangles, num_last_triangles * 3 * sizeof(uint32_t));
 
-		// Find a topological boundary, or if not found a split edge
-		uint32_t start = original_start;
-		for (uint32_t cur = start;;) {
-			uint32_t prev = ufbx_topo_prev_vertex_edge(topo, num_topo, cur);
-			if (prev == UFBX_NO_INDEX) { start = cur; break; } // Topological boundary: Stop and use as start
-			if (ufbxi_is_edge_split(input, topo, prev)) start = cur; // Split edge: Consider as start
-			if (prev == original_start) break; // Loop: Stop, use original start or split if found
-			cur = prev;
-		}
+	return num_triangles;
+}
 
-		original_start = start;
-		while (start != UFBX_NO_INDEX) {
-			if (start != original_start) {
-				output->unique_per_vertex = false;
-			}
+// -- Monotone triangulation
+//
+// Ear clipping degrades to quadratic time for polygons with many reflex corners, so
+// large polygons are first split into y-monotone pieces with a plane sweep and each
+// piece is triangulated in linear time, see "Computational Geometry: Algorithms and
+// Applications" (de Berg et al.), chapter 3.
 
-			uint32_t value_index = (uint32_t)num_vertex_values++;
-			char *dst = vertex_values + value_index * stride;
+typedef enum {
+	UFBXI_MONOTONE_REGULAR_LEFT,  // < Regular vertex with the interior to the right
+	UFBXI_MONOTONE_REGULAR_RIGHT, // < Regular vertex with the interior to the left
+	UFBXI_MONOTONE_START,
+	UFBXI_MONOTONE_END,
+	UFBXI_MONOTONE_SPLIT,
+	UFBXI_MONOTONE_MERGE,
+} ufbxi_monotone_vertex_type;
+
+// Diagonal end-point sorted by `angle` around `vertex`, `id` is the index in `diagonals[]`.
+typedef struct {
+	ufbx_real angle;
+	uint32_t vertex;
+	uint32_t neighbor;
+	uint32_t id;
+} ufbxi_monotone_slot;
 
-			// We need to compute the average crease value and keep track of
-			// two creased edges, if there's more we use the corner rule that
-			// does not need the information.
-			ufbx_real total_crease = 0.0f;
-			size_t num_crease = 0;
-			size_t num_split = 0;
-			bool on_boundary = false;
-			bool non_manifold = false;
-			size_t crease_input_indices[2];
+typedef struct {
+	uint32_t child[2];
+	uint32_t parent;
+} ufbxi_monotone_node;
 
-			// At start we always have two edges and a single face
-			uint32_t start_prev = topo[start].prev;
-			uint32_t end_edge = topo[start_prev].twin;
-			size_t valence = 2;
+typedef struct {
+	uint32_t num_vertices;
+	ufbx_vec2 *points;
+	uint32_t *rank;
+	uint8_t *type;
+
+	// Edges `i -> i + 1` with the interior to the right that intersect the sweep line
+	// stored in a treap ordered from left to right, nodes are indexed by the edge.
+	ufbxi_monotone_node *nodes;
+	uint32_t root;
+	uint32_t num_status;
+	uint32_t *helper;
+
+	uint32_t *diagonals;
+	uint32_t num_diagonals;
+
+	// Diagonal end-points of vertex `i` are `slots[slot_begin[i] .. slot_begin[i + 1]]`,
+	// `slot_pos[]` maps from `diagonals[]` indices to `slots[]`.
+	uint32_t *slot_begin;
+	ufbxi_monotone_slot *slots;
+	uint32_t *slot_pos;
+
+	// Scratch arrays, all allocated up front by `ufbxi_monotone_init_buffers()`
+	uint32_t *order;
+	ufbxi_monotone_slot *slot_tmp;
+	uint32_t *piece_id;
+	uint32_t *piece;
+	uint32_t *seq;
+	uint8_t *side;
+	uint32_t *stack;
+	ufbx_vec3 *clip_points;
+	uint32_t *clip_indices;
+	uint32_t *clip_scratch;
+} ufbxi_monotone_context;
+
+static void *ufbxi_monotone_push_size(ufbxi_monotone_scratch *scratch, size_t size, size_t n)
+{
+	size_t begin = ufbxi_align_to_mask(scratch->pos, 7);
+	scratch->pos = begin + size * n;
+	return scratch->data && scratch->pos <= scratch->size ? scratch->data + begin : NULL;
+}
+
+#define ufbxi_monotone_push(scratch, type, n) ((type*)ufbxi_monotone_push_size((scratch), sizeof(type), (n)))
+
+// Carve the buffers for a polygon with `num_vertices` corners from `scratch`, only
+// measures the required size if `scratch->data == NULL`.
+static bool ufbxi_monotone_init_buffers(ufbxi_monotone_context *mc, ufbxi_monotone_scratch *scratch, uint32_t num_vertices)
+{
+	uint32_t max_slots = num_vertices * 2;
+	uint32_t max_edges = num_vertices + max_slots;
+	uint32_t max_clip_scratch = max_edges * 3 + 12;
+
+	scratch->pos = 0;
+	mc->points = ufbxi_monotone_push(scratch, ufbx_vec2, num_vertices);
+	mc->rank = ufbxi_monotone_push(scratch, uint32_t, num_vertices);
+	mc->type = ufbxi_monotone_push(scratch, uint8_t, num_vertices);
+	mc->nodes = ufbxi_monotone_push(scratch, ufbxi_monotone_node, num_vertices);
+	mc->helper = ufbxi_monotone_push(scratch, uint32_t, num_vertices);
+	mc->diagonals = ufbxi_monotone_push(scratch, uint32_t, max_slots);
+	mc->order = ufbxi_monotone_push(scratch, uint32_t, num_vertices * 2);
+	mc->slot_begin = ufbxi_monotone_push(scratch, uint32_t, num_vertices + 1);
+	mc->slots = ufbxi_monotone_push(scratch, ufbxi_monotone_slot, max_slots);
+	mc->slot_pos = ufbxi_monotone_push(scratch, uint32_t, max_slots);
+	mc->slot_tmp = ufbxi_monotone_push(scratch, ufbxi_monotone_slot, max_slots);
+	mc->piece_id = ufbxi_monotone_push(scratch, uint32_t, max_edges);
+	mc->piece = ufbxi_monotone_push(scratch, uint32_t, max_edges);
+	mc->seq = ufbxi_monotone_push(scratch, uint32_t, max_edges);
+	mc->side = ufbxi_monotone_push(scratch, uint8_t, max_edges);
+	mc->stack = ufbxi_monotone_push(scratch, uint32_t, max_edges);
+	mc->clip_points = ufbxi_monotone_push(scratch, ufbx_vec3, max_edges);
+	mc->clip_indices = ufbxi_monotone_push(scratch, uint32_t, max_edges);
+	mc->clip_scratch = ufbxi_monotone_push(scratch, uint32_t, max_clip_scratch);
+	return mc->clip_scratch != NULL && scratch->pos <= scratch->size;
+}
+
+// Size of the scratch memory required for polygons with up to `num_vertices` corners,
+// zero if the polygon is too large to be triangulated with `ufbxi_triangulate_monotone()`.
+static size_t ufbxi_monotone_scratch_size(uint32_t num_vertices)
+{
+	// Each corner requires less than 512 bytes of scratch memory
+	if (num_vertices > UINT32_MAX / 8 || (num_vertices > 0 && SIZE_MAX / num_vertices < 512)) return 0;
+	ufbxi_monotone_context mc;
+	ufbxi_monotone_scratch scratch = { NULL, 0, 0 };
+	ufbxi_monotone_init_buffers(&mc, &scratch, num_vertices);
+	return ufbxi_align_to_mask(scratch.pos, 7);
+}
+
+ufbxi_forceinline static uint32_t ufbxi_monotone_next(const ufbxi_monotone_context *mc, uint32_t ix)
+{
+	return ix + 1 < mc->num_vertices ? ix + 1 : 0;
+}
+
+ufbxi_forceinline static uint32_t ufbxi_monotone_prev(const ufbxi_monotone_context *mc, uint32_t ix)
+{
+	return ix > 0 ? ix - 1 : mc->num_vertices - 1;
+}
+
+// X coordinate of `edge` at the height of `p`
+static ufbx_real ufbxi_monotone_edge_x(const ufbxi_monotone_context *mc, uint32_t edge, ufbx_vec2 p)
+{
+	ufbx_vec2 a = mc->points[edge];
+	ufbx_vec2 b = mc->points[ufbxi_monotone_next(mc, edge)];
+	if (a.y == b.y) {
+		return ufbxi_min_real(ufbxi_max_real(p.x, ufbxi_min_real(a.x, b.x)), ufbxi_max_real(a.x, b.x));
+	}
+	ufbx_real t = (p.y - a.y) / (b.y - a.y);
+	t = ufbxi_min_real(ufbxi_max_real(t, 0.0f), 1.0f);
+	return a.x + (b.x - a.x) * t;
+}
+
+// Rightmost status edge at or to the left of `p`, `UFBX_NO_INDEX` if there is none
+static uint32_t ufbxi_monotone_left_edge(const ufbxi_monotone_context *mc, ufbx_vec2 p)
+{
+	uint32_t node = mc->root, result = UFBX_NO_INDEX;
+	while (node != UFBX_NO_INDEX) {
+		if (ufbxi_monotone_edge_x(mc, node, p) <= p.x) {
+			result = node;
+			node = mc->nodes[node].child[1];
+		} else {
+			node = mc->nodes[node].child[0];
+		}
+	}
+	return result;
+}
 
-			non_manifold |= (topo[start].flags & UFBX_TOPO_NON_MANIFOLD) != 0;
-			non_manifold |= (topo[start_prev].flags & UFBX_TOPO_NON_MANIFOLD) != 0;
+// Rotate `node` above its parent
+static void ufbxi_monotone_rotate_up(ufbxi_monotone_context *mc, uint32_t node)
+{
+	ufbxi_monotone_node *nodes = mc->nodes;
+	uint32_t parent = nodes[node].parent;
+	uint32_t grandparent = nodes[parent].parent;
+	uint32_t side = nodes[parent].child[1] == node ? 1 : 0;
 
-			const char *v0 = (const char*)input->values + input->indices[start] * stride;
+	uint32_t inner = nodes[node].child[side ^ 1];
+	nodes[parent].child[side] = inner;
+	if (inner != UFBX_NO_INDEX) nodes[inner].parent = parent;
 
-			size_t num_inputs = 4;
+	nodes[node].child[side ^ 1] = parent;
+	nodes[parent].parent = node;
+	nodes[node].parent = grandparent;
+	if (grandparent == UFBX_NO_INDEX) {
+		mc->root = node;
+	} else {
+		nodes[grandparent].child[nodes[grandparent].child[1] == parent ? 1 : 0] = node;
+	}
+}
 
-			{
-				const char *e0 = (const char*)input->values + input->indices[topo[start].next] * stride;
-				const char *e1 = (const char*)input->values + input->indices[start_prev] * stride;
-				const char *f0 = face_values + topo[start].face * stride;
-				inputs[0].data = v0;
-				inputs[1].data = e0;
-				inputs[2].data = e1;
-				inputs[3].data = f0;
-			}
+static void ufbxi_monotone_insert_edge(ufbxi_monotone_context *mc, uint32_t vertex)
+{
+	ufbxi_monotone_node *nodes = mc->nodes;
+	ufbx_vec2 p = mc->points[vertex];
 
-			bool start_split = ufbxi_is_edge_split(input, topo, start);
-			bool prev_split = end_edge != UFBX_NO_INDEX && ufbxi_is_edge_split(input, topo, end_edge);
+	nodes[vertex].child[0] = UFBX_NO_INDEX;
+	nodes[vertex].child[1] = UFBX_NO_INDEX;
+	nodes[vertex].parent = UFBX_NO_INDEX;
 
-			// Either of the first two edges may be creased
-			ufbx_real start_crease = ufbxi_edge_crease(mesh, start_split, topo, start);
-			if (start_crease > 0.0f) {
-				total_crease += start_crease;
-				crease_input_indices[num_crease++] = 1;
-			}
-			ufbx_real prev_crease = ufbxi_edge_crease(mesh, prev_split, topo, start_prev);
-			if (prev_crease > 0.0f) {
-				total_crease += prev_crease;
-				crease_input_indices[num_crease++] = 2;
-			}
+	uint32_t parent = UFBX_NO_INDEX, side = 0;
+	uint32_t node = mc->root;
+	while (node != UFBX_NO_INDEX) {
+		parent = node;
+		side = ufbxi_monotone_edge_x(mc, node, p) <= p.x ? 1 : 0;
+		node = nodes[node].child[side];
+	}
 
-			if (end_edge != UFBX_NO_INDEX) {
-				if (prev_split) {
-					num_split++;
-				}
-			} else {
-				on_boundary = true;
-			}
+	nodes[vertex].parent = parent;
+	if (parent == UFBX_NO_INDEX) {
+		mc->root = vertex;
+	} else {
+		nodes[parent].child[side] = vertex;
+	}
 
-			ufbxi_check_err(&sc->error, vertex_indices[start] == UFBX_NO_INDEX);
-			vertex_indices[start] = value_index;
+	// Restore the heap property using hashed edge indices as priorities
+	uint32_t priority = ufbxi_hash32(vertex);
+	while (nodes[vertex].parent != UFBX_NO_INDEX && ufbxi_hash32(nodes[vertex].parent) < priority) {
+		ufbxi_monotone_rotate_up(mc, vertex);
+	}
 
-			if (start_split) {
-				// We need to special case if the first edge is split as we have
-				// handled it already in the code above..
-				start = ufbx_topo_next_vertex_edge(topo, num_topo, start);
-				num_split++;
-			} else {
-				// Follow vertex edges until we either hit a topological/split boundary
-				// or loop back to the left edge we accounted for in `start_prev`
-				uint32_t cur = start;
-				for (;;) {
-					cur = ufbx_topo_next_vertex_edge(topo, num_topo, cur);
+	mc->num_status++;
+	mc->helper[vertex] = vertex;
+}
 
-					// Topological boundary: Finished
-					if (cur == UFBX_NO_INDEX) {
-						on_boundary = true;
-						start = UFBX_NO_INDEX;
-						break;
-					}
+// Remove the edge ending at `vertex`, returns its helper or `UFBX_NO_INDEX` on failure.
+static uint32_t ufbxi_monotone_remove_edge(ufbxi_monotone_context *mc, uint32_t vertex)
+{
+	ufbxi_monotone_node *nodes = mc->nodes;
+	uint32_t edge = ufbxi_monotone_prev(mc, vertex);
+	if (nodes[edge].parent == UFBX_NO_INDEX && mc->root != edge) return UFBX_NO_INDEX;
 
-					non_manifold |= (topo[cur].flags & UFBX_TOPO_NON_MANIFOLD) != 0;
-					ufbxi_check_err(&sc->error, vertex_indices[cur] == UFBX_NO_INDEX);
-					vertex_indices[cur] = value_index;
+	// Rotate the edge down to a leaf and detach it
+	for (;;) {
+		uint32_t left = nodes[edge].child[0], right = nodes[edge].child[1];
+		if (left == UFBX_NO_INDEX && right == UFBX_NO_INDEX) break;
+		if (left == UFBX_NO_INDEX || (right != UFBX_NO_INDEX && ufbxi_hash32(right) > ufbxi_hash32(left))) {
+			ufbxi_monotone_rotate_up(mc, right);
+		} else {
+			ufbxi_monotone_rotate_up(mc, left);
+		}
+	}
 
-					bool split = ufbxi_is_edge_split(input, topo, cur);
+	uint32_t parent = nodes[edge].parent;
+	if (parent == UFBX_NO_INDEX) {
+		mc->root = UFBX_NO_INDEX;
+	} else {
+		nodes[parent].child[nodes[parent].child[1] == edge ? 1 : 0] = UFBX_NO_INDEX;
+	}
+	nodes[edge].parent = UFBX_NO_INDEX;
 
-					// Looped: Add the face from the other side still if not split
-					if (cur == end_edge && !split) {
-						ufbxi_check_err(&sc->error, ufbxi_grow_array(&sc->ator_tmp, &sc->inputs, &sc->inputs_cap, num_inputs + 1));
-						const char *f0 = face_values + topo[cur].face * stride;
-						inputs[num_inputs].data = f0;
-						start = UFBX_NO_INDEX;
-						num_inputs += 1;
-						break;
-					}
+	mc->num_status--;
+	return mc->helper[edge];
+}
 
-					// Add the edge crease, this also handles boundaries as they
-					// have an implicit crease of 1.0 using `ufbxi_edge_crease()`
-					ufbx_real cur_crease = ufbxi_edge_crease(mesh, split, topo, cur);
-					if (cur_crease > 0.0f) {
-						total_crease += cur_crease;
-						if (num_crease < 2) crease_input_indices[num_crease] = num_inputs;
-						num_crease++;
-					}
+static bool ufbxi_monotone_add_diagonal(ufbxi_monotone_context *mc, uint32_t a, uint32_t b)
+{
+	uint32_t num_vertices = mc->num_vertices;
+	if (a == b || ufbxi_monotone_next(mc, a) == b || ufbxi_monotone_prev(mc, a) == b) return false;
+	if (mc->num_diagonals + 1 >= num_vertices) return false;
+	mc->diagonals[mc->num_diagonals*2 + 0] = a;
+	mc->diagonals[mc->num_diagonals*2 + 1] = b;
+	mc->num_diagonals++;
+	return true;
+}
 
-					// Add the new edge and face to the sum
-					{
-						ufbxi_check_err(&sc->error, ufbxi_grow_array(&sc->ator_tmp, &sc->inputs, &sc->inputs_cap, num_inputs + 2));
-						inputs = sc->inputs;
+// Connect `vertex` to `helper` if it is a merge vertex
+ufbxi_forceinline static bool ufbxi_monotone_fix_merge(ufbxi_monotone_context *mc, uint32_t vertex, uint32_t helper)
+{
+	if (helper == UFBX_NO_INDEX) return false;
+	if (mc->type[helper] != UFBXI_MONOTONE_MERGE) return true;
+	return ufbxi_monotone_add_diagonal(mc, vertex, helper);
+}
 
-						const char *e0 = (char*)input->values + input->indices[topo[cur].next] * stride;
-						const char *f0 = face_values + topo[cur].face * stride;
-						inputs[num_inputs + 0].data = e0;
-						inputs[num_inputs + 1].data = f0;
-						num_inputs += 2;
-					}
-					valence++;
+// Sweep from top to bottom collecting diagonals that split the polygon into y-monotone pieces.
+static bool ufbxi_monotone_partition(ufbxi_monotone_context *mc, const uint32_t *order)
+{
+	uint32_t num_vertices = mc->num_vertices;
+	ufbx_vec2 *points = mc->points;
+	uint32_t *rank = mc->rank;
 
-					// If we landed at a split edge advance to the next one
-					// and continue from there in the outer loop
-					if (split) {
-						start = ufbx_topo_next_vertex_edge(topo, num_topo, cur);
-						num_split++;
-						break;
-					}
-				}
-			}
+	for (uint32_t i = 0; i < num_vertices; i++) {
+		uint32_t prev = ufbxi_monotone_prev(mc, i), next = ufbxi_monotone_next(mc, i);
+		bool prev_below = rank[prev] > rank[i], next_below = rank[next] > rank[i];
+		bool convex = ufbxi_orient2d(points[prev], points[i], points[next]) > 0.0f;
+		if (prev_below && next_below) {
+			mc->type[i] = (uint8_t)(convex ? UFBXI_MONOTONE_START : UFBXI_MONOTONE_SPLIT);
+		} else if (!prev_below && !next_below) {
+			mc->type[i] = (uint8_t)(convex ? UFBXI_MONOTONE_END : UFBXI_MONOTONE_MERGE);
+		} else {
+			mc->type[i] = (uint8_t)(prev_below ? UFBXI_MONOTONE_REGULAR_RIGHT : UFBXI_MONOTONE_REGULAR_LEFT);
+		}
+	}
 
-			if (start == original_start) start = UFBX_NO_INDEX;
+	for (uint32_t order_ix = 0; order_ix < num_vertices; order_ix++) {
+		uint32_t ix = order[order_ix];
+		uint32_t left = UFBX_NO_INDEX;
 
-			// Weights for various subdivision masks
-			ufbx_real fe_weight = 1.0f / (ufbx_real)(valence*valence);
-			ufbx_real v_weight = (ufbx_real)(valence - 2) / (ufbx_real)valence;
+		switch (mc->type[ix]) {
+		case UFBXI_MONOTONE_START:
+			ufbxi_monotone_insert_edge(mc, ix);
+			break;
+		case UFBXI_MONOTONE_END:
+			if (!ufbxi_monotone_fix_merge(mc, ix, ufbxi_monotone_remove_edge(mc, ix))) return false;
+			break;
+		case UFBXI_MONOTONE_SPLIT:
+			left = ufbxi_monotone_left_edge(mc, mc->points[ix]);
+			if (left == UFBX_NO_INDEX) return false;
+			if (!ufbxi_monotone_add_diagonal(mc, ix, mc->helper[left])) return false;
+			mc->helper[left] = ix;
+			ufbxi_monotone_insert_edge(mc, ix);
+			break;
+		case UFBXI_MONOTONE_MERGE:
+			if (!ufbxi_monotone_fix_merge(mc, ix, ufbxi_monotone_remove_edge(mc, ix))) return false;
+			left = ufbxi_monotone_left_edge(mc, mc->points[ix]);
+			if (left == UFBX_NO_INDEX) return false;
+			if (!ufbxi_monotone_fix_merge(mc, ix, mc->helper[left])) return false;
+			mc->helper[left] = ix;
+			break;
+		case UFBXI_MONOTONE_REGULAR_LEFT:
+			if (!ufbxi_monotone_fix_merge(mc, ix, ufbxi_monotone_remove_edge(mc, ix))) return false;
+			ufbxi_monotone_insert_edge(mc, ix);
+			break;
+		case UFBXI_MONOTONE_REGULAR_RIGHT:
+			left = ufbxi_monotone_left_edge(mc, mc->points[ix]);
+			if (left == UFBX_NO_INDEX) return false;
+			if (!ufbxi_monotone_fix_merge(mc, ix, mc->helper[left])) return false;
+			mc->helper[left] = ix;
+			break;
+		default:
+			return false;
+		}
+	}
 
-			// Select the right subdivision mask depending on valence and crease
-			if (num_crease > 2
-				|| (sharp_corners && valence == 2 && (num_split > 0 || on_boundary))
-				|| (sharp_splits && (num_split > 0 || on_boundary))
-				|| sharp_all
-				|| non_manifold) {
-				// Corner: Copy as-is
-				inputs[0].data = v0;
-				inputs[0].weight = 1.0f;
-				num_inputs = 1;
-			} else if (num_crease == 2) {
-				// Boundary: Interpolate edge
-				total_crease *= 0.5f;
-				if (total_crease < 0.0f) total_crease = 0.0f;
-				if (total_crease > 1.0f) total_crease = 1.0f;
+	return mc->num_status == 0;
+}
 
-				inputs[0].weight = v_weight * (1.0f - total_crease) + 0.75f * total_crease;
-				ufbx_real few = fe_weight * (1.0f - total_crease);
-				for (size_t i = 1; i < num_inputs; i++) {
-					inputs[i].weight = few;
-				}
+// Pseudo-angle of `dir` measured counter-clockwise from `base` in the range [0, 4)
+static ufbx_real ufbxi_monotone_angle(ufbx_vec2 base, ufbx_vec2 dir)
+{
+	ufbx_real x = base.x*dir.x + base.y*dir.y;
+	ufbx_real y = base.x*dir.y - base.y*dir.x;
+	ufbx_real len = (ufbx_real)ufbx_fabs(x) + (ufbx_real)ufbx_fabs(y);
+	if (!(len > 0.0f)) return 0.0f;
+	return y >= 0.0f ? 1.0f - x / len : 3.0f + x / len;
+}
 
-				// Add weight to the creased edges
-				inputs[crease_input_indices[0]].weight += 0.125f * total_crease;
-				inputs[crease_input_indices[1]].weight += 0.125f * total_crease;
-			} else {
-				// Regular: Weighted sum with the accumulated edge/face points
-				inputs[0].weight = v_weight;
-				for (size_t i = 1; i < num_inputs; i++) {
-					inputs[i].weight = fe_weight;
-				}
+// Sort diagonal end-points counter-clockwise around each vertex starting from the
+// outgoing edge `i -> i + 1`, which lets us walk the pieces using the rule that the
+// edge following `a -> b` is the one preceding `b -> a` around `b`.
+static void ufbxi_monotone_setup_slots(ufbxi_monotone_context *mc, ufbxi_monotone_slot *slot_tmp)
+{
+	uint32_t num_vertices = mc->num_vertices;
+	uint32_t num_slots = mc->num_diagonals * 2;
+	const ufbx_vec2 *points = mc->points;
+	ufbxi_monotone_slot *slots = mc->slots;
 
-			}
+	memset(mc->slot_begin, 0, (num_vertices + 1) * sizeof(uint32_t));
+	for (uint32_t i = 0; i < num_slots; i++) {
+		mc->slot_begin[mc->diagonals[i] + 1]++;
+	}
+	for (uint32_t i = 0; i < num_vertices; i++) {
+		mc->slot_begin[i + 1] += mc->slot_begin[i];
+	}
 
-			if (mesh->vertex_crease.exists) {
-				ufbx_real v = ufbx_get_vertex_real(&mesh->vertex_crease, original_start);
-				v *= (ufbx_real)10.0;
-				if (v > 0.0f) {
-					if (v > 1.0) v = 1.0f;
+	for (uint32_t i = 0; i < num_slots; i++) {
+		uint32_t a = mc->diagonals[i], b = mc->diagonals[i ^ 1];
+		ufbx_vec2 p = points[a], n = points[ufbxi_monotone_next(mc, a)], q = points[b];
+		ufbx_vec2 base, dir;
+		base.x = n.x - p.x;
+		base.y = n.y - p.y;
+		dir.x = q.x - p.x;
+		dir.y = q.y - p.y;
+		slots[i].angle = ufbxi_monotone_angle(base, dir);
+		slots[i].vertex = a;
+		slots[i].neighbor = b;
+		slots[i].id = i;
+	}
+	ufbxi_macro_stable_sort(ufbxi_monotone_slot, 16, slots, slot_tmp, num_slots,
+		( a->vertex != b->vertex ? a->vertex < b->vertex : a->angle < b->angle ));
+	for (uint32_t i = 0; i < num_slots; i++) {
+		mc->slot_pos[slots[i].id] = i;
+	}
+}
 
-					ufbx_real iv = 1.0f - v;
-					inputs[0].weight = 1.0f * v + (inputs[0].weight) * iv;
-					for (size_t i = 1; i < num_inputs; i++) {
-						inputs[i].weight *= iv;
-					}
+// Half-edges `[0, num_vertices)` refer to polygon edges `i -> i + 1` and
+// `num_vertices + slot` to diagonals `vertex -> neighbor`.
+static ufbxi_forceinline uint32_t ufbxi_monotone_next_edge(const ufbxi_monotone_context *mc, uint32_t edge)
+{
+	uint32_t num_vertices = mc->num_vertices;
+	if (edge < num_vertices) {
+		uint32_t next = ufbxi_monotone_next(mc, edge);
+		uint32_t end = mc->slot_begin[next + 1];
+		return end > mc->slot_begin[next] ? num_vertices + end - 1 : next;
+	} else {
+		const ufbxi_monotone_slot *slot = &mc->slots[edge - num_vertices];
+		uint32_t twin = mc->slot_pos[slot->id ^ 1];
+		return twin > mc->slot_begin[slot->neighbor] ? num_vertices + twin - 1 : slot->neighbor;
+	}
+}
+
+// Triangulate a y-monotone polygon `face[0..num_face]`, returns the number of triangles
+// or `UINT32_MAX` if the polygon turns out not to be monotone.
+static uint32_t ufbxi_monotone_triangulate_piece(const ufbxi_monotone_context *mc, const uint32_t *face, uint32_t num_face,
+	uint32_t *seq, uint8_t *side, uint32_t *stack, uint32_t *indices, uint32_t max_triangles, uint32_t index_begin)
+{
+	const uint32_t *rank = mc->rank;
+	const ufbx_vec2 *points = mc->points;
+
+	uint32_t top = 0, bottom = 0;
+	for (uint32_t i = 1; i < num_face; i++) {
+		if (rank[face[i]] < rank[face[top]]) top = i;
+		if (rank[face[i]] > rank[face[bottom]]) bottom = i;
+	}
+
+	// Merge the left (forward from `top`) and right (backward from `top`) chains by height
+	uint32_t left = top + 1 < num_face ? top + 1 : 0;
+	uint32_t right = top > 0 ? top - 1 : num_face - 1;
+	uint32_t left_rank = rank[face[top]], right_rank = left_rank;
+	seq[0] = face[top];
+	side[0] = 0;
+	for (uint32_t i = 1; i + 1 < num_face; i++) {
+		bool take_left = right == bottom || (left != bottom && rank[face[left]] < rank[face[right]]);
+		if (take_left) {
+			if (left == bottom || rank[face[left]] <= left_rank) return UINT32_MAX;
+			left_rank = rank[face[left]];
+			seq[i] = face[left];
+			side[i] = 0;
+			left = left + 1 < num_face ? left + 1 : 0;
+		} else {
+			if (right == bottom || rank[face[right]] <= right_rank) return UINT32_MAX;
+			right_rank = rank[face[right]];
+			seq[i] = face[right];
+			side[i] = 1;
+			right = right > 0 ? right - 1 : num_face - 1;
+		}
+	}
+	if (left != bottom || right != bottom) return UINT32_MAX;
+	seq[num_face - 1] = face[bottom];
+
+	if (num_face - 2 > max_triangles) return UINT32_MAX;
+	uint32_t num_triangles = 0;
+
+	#define ufbxi_monotone_emit(m_a, m_b, m_c) do { \
+		if (num_triangles >= max_triangles) return UINT32_MAX; \
+		uint32_t *mi_dst = indices + num_triangles * 3; \
+		mi_dst[0] = index_begin + (m_a); \
+		mi_dst[1] = index_begin + (m_b); \
+		mi_dst[2] = index_begin + (m_c); \
+		num_triangles++; \
+	} while (0)
+
+	// Triangles are emitted so that the polygon edges keep their direction, which
+	// makes them counter-clockwise in valid configurations.
+	uint32_t num_stack = 2;
+	stack[0] = 0;
+	stack[1] = 1;
+	for (uint32_t j = 2; j + 1 < num_face; j++) {
+		uint32_t u = seq[j];
+		if (side[j] != side[stack[num_stack - 1]]) {
+			for (uint32_t k = 0; k + 1 < num_stack; k++) {
+				uint32_t a = seq[stack[k]], b = seq[stack[k + 1]];
+				if (side[j] == 0) {
+					ufbxi_monotone_emit(b, a, u);
+				} else {
+					ufbxi_monotone_emit(a, b, u);
 				}
 			}
-
-#if defined(UFBX_REGRESSION)
-			{
-				ufbx_real total_weight = 0.0f;
-				for (size_t i = 0; i < num_inputs; i++) {
-					total_weight += inputs[i].weight;
+			stack[0] = j - 1;
+			stack[1] = j;
+			num_stack = 2;
+		} else {
+			uint32_t last = stack[--num_stack];
+			while (num_stack > 0) {
+				uint32_t t = seq[stack[num_stack - 1]], l = seq[last];
+				if (side[j] == 0) {
+					if (!(ufbxi_orient2d(points[t], points[l], points[u]) > 0.0f)) break;
+					ufbxi_monotone_emit(t, l, u);
+				} else {
+					if (!(ufbxi_orient2d(points[u], points[l], points[t]) > 0.0f)) break;
+					ufbxi_monotone_emit(u, l, t);
 				}
-				ufbx_assert(ufbx_fabs(total_weight - 1.0f) < 0.001f);
+				last = stack[--num_stack];
 			}
-#endif
-
-			ufbxi_check_err(&sc->error, sum_fn(sum_user, dst, inputs, num_inputs));
+			stack[num_stack++] = last;
+			stack[num_stack++] = j;
 		}
 	}
 
-	// Copy non-manifold vertex values as-is
-	for (size_t old_ix = 0; old_ix < mesh->num_indices; old_ix++) {
-		uint32_t ix = vertex_indices[old_ix];
-		if (ix == UFBX_NO_INDEX) {
-			ix = (uint32_t)num_vertex_values++;
-			vertex_indices[old_ix] = ix;
-			const char *src = (const char*)input->values + input->indices[old_ix] * stride;
-			char *dst = vertex_values + ix * stride;
-
-			inputs[0].data = src;
-			inputs[0].weight = 1.0f;
-			ufbxi_check_err(&sc->error, sum_fn(sum_user, dst, inputs, 1));
+	// Connect the bottom vertex to the remaining chain
+	uint32_t u = seq[num_face - 1];
+	for (uint32_t k = 0; k + 1 < num_stack; k++) {
+		uint32_t a = seq[stack[k]], b = seq[stack[k + 1]];
+		if (side[stack[num_stack - 1]] == 0) {
+			ufbxi_monotone_emit(a, b, u);
+		} else {
+			ufbxi_monotone_emit(b, a, u);
 		}
 	}
 
-	ufbx_assert(num_vertex_values <= mesh->num_indices);
-	size_t num_values = num_edge_values + mesh->num_faces + num_vertex_values;
-	char *new_values = (char*)ufbxi_push_size(&sc->result, stride, (num_values+1));
-	ufbxi_check_err(&sc->error, new_values);
-
-	memset(new_values, 0, stride);
-	new_values += stride;
-
-	memcpy(new_values, values, num_values * stride);
-
-	output->values = new_values;
-	output->num_values = num_values;
-
-	if (!input->ignore_indices) {
-		uint32_t *new_indices = ufbxi_push(&sc->result, uint32_t, mesh->num_indices * 4);
-		ufbxi_check_err(&sc->error, new_indices);
-
-		uint32_t face_start = 0;
-		uint32_t edge_start = (uint32_t)(face_start + mesh->num_faces);
-		uint32_t vert_start = (uint32_t)(edge_start + num_edge_values);
-		uint32_t *p_ix = new_indices;
-		for (size_t ix = 0; ix < mesh->num_indices; ix++) {
-			p_ix[0] = vert_start + vertex_indices[ix];
-			p_ix[1] = edge_start + edge_indices[ix];
-			p_ix[2] = face_start + topo[ix].face;
-			p_ix[3] = edge_start + edge_indices[topo[ix].prev];
-			p_ix += 4;
-		}
-		output->indices = new_indices;
-		output->num_indices = mesh->num_indices * 4;
-	} else {
-		output->indices = NULL;
-		output->num_indices = 0;
-	}
+	#undef ufbxi_monotone_emit
 
-	return 1;
+	return num_triangles;
 }
 
-static ufbxi_noinline int ufbxi_subdivide_attrib(ufbxi_subdivide_context *sc, ufbx_vertex_attrib *attrib, ufbx_subdivision_boundary boundary, bool check_split_data)
+// Self-intersecting polygons may result in pieces that are not monotone, triangulate
+// them using `ufbxi_triangulate_ngon()` which is fine as long as they are local.
+static uint32_t ufbxi_monotone_clip_ears(const ufbxi_monotone_context *mc, const uint32_t *face, uint32_t num_face,
+	uint32_t *indices, uint32_t max_triangles, uint32_t index_begin)
 {
-	if (!attrib->exists) return 1;
-
-	ufbx_assert(attrib->value_reals >= 1 && attrib->value_reals <= 4);
+	if (num_face - 2 > max_triangles) return UINT32_MAX;
 
-	ufbxi_subdivide_layer_input input;
-	input.sum_fn = ufbxi_real_sum_fns[attrib->value_reals - 1];
-	input.sum_user = NULL;
-	input.values = attrib->values.data;
-	input.indices = attrib->indices.data;
-	input.stride = attrib->value_reals * sizeof(ufbx_real);
-	input.boundary = boundary;
-	input.check_split_data = check_split_data;
-	input.ignore_indices = false;
+	// Pieces have at most `max_edges` corners, see `ufbxi_monotone_init_buffers()`
+	uint32_t num_scratch = num_face * 3 + 12;
+	ufbx_vec3 *points = mc->clip_points;
+	uint32_t *point_indices = mc->clip_indices;
+	uint32_t *scratch = mc->clip_scratch;
 
-	ufbxi_subdivide_layer_output output;
-	ufbxi_check_err(&sc->error, ufbxi_subdivide_layer(sc, &output, &input));
+	for (uint32_t i = 0; i < num_face; i++) {
+		points[i].x = mc->points[face[i]].x;
+		points[i].y = mc->points[face[i]].y;
+		points[i].z = 0.0f;
+		point_indices[i] = i;
+	}
 
-	attrib->values.data = output.values;
-	attrib->indices.data = output.indices;
-	attrib->values.count = output.num_values;
-	attrib->indices.count = output.num_indices;
+	// The points are already projected to 2D
+	ufbxi_ngon_context nc = { 0 };
+	nc.positions.values.data = points;
+	nc.positions.values.count = num_face;
+	nc.positions.indices.data = point_indices;
+	nc.positions.indices.count = num_face;
+	nc.face.num_indices = num_face;
+	nc.axes[0].x = 1.0f;
+	nc.axes[1].y = 1.0f;
+	nc.axes[2].z = 1.0f;
 
-	return 1;
+	uint32_t num_triangles = ufbxi_triangulate_ngon(&nc, scratch, num_scratch);
+	for (uint32_t i = 0; i < num_triangles * 3; i++) {
+		indices[i] = index_begin + face[scratch[i]];
+	}
+	return num_triangles;
 }
 
-static ufbxi_noinline ufbxi_subdivision_vertex_weights *ufbxi_subdivision_copy_weights(ufbxi_subdivide_context *sc, ufbx_subdivision_weight_range_list ranges, ufbx_subdivision_weight_list weights)
+// Triangulate `nc->face` in O(n log n) time for simple polygons, returns zero if the polygon
+// is too degenerate in which case the caller should fall back to `ufbxi_triangulate_ngon()`.
+// Uses only `scratch` for temporary memory, see `ufbxi_monotone_scratch_size()`.
+ufbxi_noinline static uint32_t ufbxi_triangulate_monotone(ufbxi_ngon_context *nc, ufbxi_monotone_scratch *scratch, uint32_t *indices)
 {
-	ufbxi_subdivision_vertex_weights *dst = ufbxi_push(&sc->tmp, ufbxi_subdivision_vertex_weights, ranges.count);
-	ufbxi_check_return_err(&sc->error, dst, NULL);
+	ufbx_face face = nc->face;
+	ufbx_vertex_vec3 pos = nc->positions;
+	uint32_t num_vertices = face.num_indices;
+	if (num_vertices > UINT32_MAX / 8) return 0;
+
+	ufbxi_monotone_context mc;
+	memset(&mc, 0, sizeof(mc));
+	mc.num_vertices = num_vertices;
+	if (!ufbxi_monotone_init_buffers(&mc, scratch, num_vertices)) return 0;
+	uint32_t *order = mc.order;
+
+	ufbx_real area = 0.0f;
+	const uint32_t *pos_indices = pos.indices.data + face.index_begin;
+	for (uint32_t i = 0; i < num_vertices; i++) {
+		mc.points[i] = ufbxi_ngon_project(nc, pos.values.data[pos_indices[i]]);
+		mc.nodes[i].parent = UFBX_NO_INDEX;
+		order[i] = i;
+	}
+	mc.root = UFBX_NO_INDEX;
+	for (uint32_t i = 0; i < num_vertices; i++) {
+		ufbx_vec2 a = mc.points[i], b = mc.points[ufbxi_monotone_next(&mc, i)];
+		area += a.x*b.y - a.y*b.x;
+	}
+	if (!(area > 0.0f)) return 0;
+
+	// Sweep from top to bottom, breaking ties from left to right
+	const ufbx_vec2 *points = mc.points;
+	ufbxi_macro_stable_sort(uint32_t, 32, order, order + num_vertices, num_vertices,
+		( points[*a].y != points[*b].y ? points[*a].y > points[*b].y : points[*a].x < points[*b].x ));
+	for (uint32_t i = 0; i < num_vertices; i++) {
+		mc.rank[order[i]] = i;
+	}
+
+	if (!ufbxi_monotone_partition(&mc, order)) return 0;
+
+	ufbxi_monotone_slot *slot_tmp = mc.slot_tmp;
+	uint32_t *piece_id = mc.piece_id;
+	uint32_t *piece = mc.piece;
+	uint32_t *seq = mc.seq;
+	uint8_t *side = mc.side;
+	uint32_t *stack = mc.stack;
+
+	// Label the pieces, self-intersections may result in diagonals that have the same
+	// piece on both sides, remove them and try again as they would break the triangle count.
+	uint32_t num_edges = 0;
+	for (uint32_t round = 0; ; round++) {
+		ufbxi_monotone_setup_slots(&mc, slot_tmp);
+		num_edges = num_vertices + mc.num_diagonals * 2;
+		memset(piece_id, 0xff, num_edges * sizeof(uint32_t));
+
+		uint32_t num_pieces = 0;
+		for (uint32_t first = 0; first < num_edges; first++) {
+			if (piece_id[first] != UFBX_NO_INDEX) continue;
+			uint32_t edge = first;
+			do {
+				if (piece_id[edge] != UFBX_NO_INDEX) return 0;
+				piece_id[edge] = num_pieces;
+				edge = ufbxi_monotone_next_edge(&mc, edge);
+			} while (edge != first);
+			num_pieces++;
+		}
+
+		uint32_t num_kept = 0;
+		for (uint32_t i = 0; i < mc.num_diagonals; i++) {
+			uint32_t a = mc.slot_pos[i*2 + 0], b = mc.slot_pos[i*2 + 1];
+			if (piece_id[num_vertices + a] == piece_id[num_vertices + b]) continue;
+			mc.diagonals[num_kept*2 + 0] = mc.diagonals[i*2 + 0];
+			mc.diagonals[num_kept*2 + 1] = mc.diagonals[i*2 + 1];
+			num_kept++;
+		}
+		if (num_kept == mc.num_diagonals) break;
+		if (round >= 4) return 0;
+		mc.num_diagonals = num_kept;
+	}
+
+	uint32_t max_triangles = num_vertices - 2;
+	uint32_t num_triangles = 0;
+	for (uint32_t first = 0; first < num_edges; first++) {
+		if (piece_id[first] == UFBX_NO_INDEX) continue;
+
+		uint32_t num_piece = 0;
+		uint32_t edge = first;
+		do {
+			piece_id[edge] = UFBX_NO_INDEX;
+			piece[num_piece++] = edge < num_vertices ? edge : mc.slots[edge - num_vertices].vertex;
+			edge = ufbxi_monotone_next_edge(&mc, edge);
+		} while (edge != first);
 
-	ufbxi_nounroll for (size_t i = 0; i != ranges.count; i++) {
-		ufbx_subdivision_weight_range range = ranges.data[i];
-		dst[i].weights = weights.data + range.weight_begin;
-		dst[i].num_weights = range.num_weights;
+		if (num_piece < 3) return 0;
+		uint32_t num_tris = ufbxi_monotone_triangulate_piece(&mc, piece, num_piece, seq, side, stack,
+			indices + num_triangles * 3, max_triangles - num_triangles, face.index_begin);
+		if (num_tris == UINT32_MAX) {
+			num_tris = ufbxi_monotone_clip_ears(&mc, piece, num_piece,
+				indices + num_triangles * 3, max_triangles - num_triangles, face.index_begin);
+			if (num_tris == UINT32_MAX) return 0;
+		}
+		num_triangles += num_tris;
 	}
 
-	return dst;
+	return num_triangles == max_triangles ? num_triangles : 0;
 }
 
-static ufbxi_noinline ufbxi_subdivision_vertex_weights *ufbxi_init_source_vertex_weights(ufbxi_subdivide_context *sc, size_t num_vertices)
+// Triangulate a validated `face`, polygons with many corners are split into monotone pieces
+// if `scratch` has space for them, otherwise they are ear clipped without allocating memory.
+static ufbxi_noinline uint32_t ufbxi_triangulate_face_imp(uint32_t *indices, size_t num_indices, const ufbx_mesh *mesh, ufbx_face face, ufbxi_monotone_scratch *scratch)
 {
-	ufbxi_subdivision_vertex_weights *dst = ufbxi_push(&sc->tmp, ufbxi_subdivision_vertex_weights, num_vertices);
-	ufbx_subdivision_weight *weights = ufbxi_push(&sc->tmp, ufbx_subdivision_weight, num_vertices);
-	ufbxi_check_return_err(&sc->error, dst && weights, NULL);
-
-	ufbxi_nounroll for (size_t i = 0; i != num_vertices; i++) {
-		dst[i].weights = weights + i;
-		dst[i].num_weights = 1;
-		weights[i].index = (uint32_t)i;
-		weights[i].weight = 1.0f;
-	}
+	if (face.num_indices == 3) {
+		// Fast case: Already a triangle
+		indices[0] = face.index_begin + 0;
+		indices[1] = face.index_begin + 1;
+		indices[2] = face.index_begin + 2;
+		return 1;
+	} else if (face.num_indices == 4) {
+		// Quad: Split along the shortest axis unless a vertex crosses the axis
+		uint32_t i0 = face.index_begin + 0;
+		uint32_t i1 = face.index_begin + 1;
+		uint32_t i2 = face.index_begin + 2;
+		uint32_t i3 = face.index_begin + 3;
+		ufbx_vec3 v0 = mesh->vertex_position.values.data[mesh->vertex_position.indices.data[i0]];
+		ufbx_vec3 v1 = mesh->vertex_position.values.data[mesh->vertex_position.indices.data[i1]];
+		ufbx_vec3 v2 = mesh->vertex_position.values.data[mesh->vertex_position.indices.data[i2]];
+		ufbx_vec3 v3 = mesh->vertex_position.values.data[mesh->vertex_position.indices.data[i3]];
 
-	return dst;
-}
+		ufbx_vec3 a = ufbxi_sub3(v2, v0);
+		ufbx_vec3 b = ufbxi_sub3(v3, v1);
 
-static ufbxi_noinline ufbxi_subdivision_vertex_weights *ufbxi_init_skin_weights(ufbxi_subdivide_context *sc, size_t num_vertices, const ufbx_skin_deformer *skin)
-{
-	ufbxi_subdivision_vertex_weights *dst = ufbxi_push(&sc->tmp, ufbxi_subdivision_vertex_weights, num_vertices);
-	ufbxi_check_return_err(&sc->error, dst, NULL);
+		ufbx_vec3 na1 = ufbxi_normalize3(ufbxi_cross3(a, ufbxi_sub3(v1, v0)));
+		ufbx_vec3 na3 = ufbxi_normalize3(ufbxi_cross3(a, ufbxi_sub3(v0, v3)));
+		ufbx_vec3 nb0 = ufbxi_normalize3(ufbxi_cross3(b, ufbxi_sub3(v1, v0)));
+		ufbx_vec3 nb2 = ufbxi_normalize3(ufbxi_cross3(b, ufbxi_sub3(v2, v1)));
 
-	for (size_t i = 0; i < num_vertices; i++) {
-		ufbxi_dev_assert(i < skin->vertices.count);
-		ufbx_skin_vertex vertex = skin->vertices.data[i];
-		size_t num_weights = ufbxi_min_sz(sc->max_vertex_weights, vertex.num_weights);
+		ufbx_real dot_aa = ufbxi_dot3(a, a);
+		ufbx_real dot_bb = ufbxi_dot3(b, b);
+		ufbx_real dot_na = ufbxi_dot3(na1, na3);
+		ufbx_real dot_nb = ufbxi_dot3(nb0, nb2);
 
-		ufbx_subdivision_weight *weights = ufbxi_push(&sc->tmp, ufbx_subdivision_weight, num_weights);
-		ufbxi_check_err(&sc->error, weights);
+		bool split_a = dot_aa <= dot_bb;
 
-		const ufbx_skin_weight *skin_weights = skin->weights.data + vertex.weight_begin;
+		if (dot_na < 0.0f || dot_nb < 0.0f) {
+			split_a = dot_na >= dot_nb;
+		}
 
-		dst[i].weights = weights;
-		dst[i].num_weights = num_weights;
-		ufbxi_nounroll for (size_t wi = 0; wi != num_weights; wi++) {
-			ufbxi_check_err(&sc->error, skin_weights[wi].cluster_index <= INT32_MAX);
-			weights[wi].index = skin_weights[wi].cluster_index;
-			weights[wi].weight = skin_weights[wi].weight;
+		if (split_a) {
+			indices[0] = i0;
+			indices[1] = i1;
+			indices[2] = i2;
+			indices[3] = i2;
+			indices[4] = i3;
+			indices[5] = i0;
+		} else {
+			indices[0] = i1;
+			indices[1] = i2;
+			indices[2] = i3;
+			indices[3] = i3;
+			indices[4] = i0;
+			indices[5] = i1;
 		}
-	}
 
-	return dst;
-}
+		return 2;
+	} else {
+		ufbxi_ngon_context nc = { 0 };
+		nc.positions = mesh->vertex_position;
+		nc.face = face;
+		ufbxi_ngon_setup_axes(&nc);
 
-static ufbxi_noinline int ufbxi_subdivide_weights(ufbxi_subdivide_context *sc, ufbx_subdivision_weight_range_list *ranges,
-	ufbx_subdivision_weight_list *weights, const ufbxi_subdivision_vertex_weights *src)
-{
-	ufbxi_check_err(&sc->error, src);
+		uint32_t num_convex_tris = ufbxi_triangulate_convex(&nc, indices);
+		if (num_convex_tris > 0) return num_convex_tris;
 
-	ufbxi_subdivide_layer_input input;
-	input.sum_fn = ufbxi_subdivide_sum_vertex_weights;
-	input.sum_user = sc;
-	input.values = src;
-	input.indices = sc->src_mesh.vertex_indices.data;
-	input.stride = sizeof(ufbxi_subdivision_vertex_weights);
-	input.boundary = sc->opts.boundary;
-	input.check_split_data = false;
-	input.ignore_indices = true;
+		if (scratch && face.num_indices >= UFBXI_MONOTONE_TRIANGULATE_MIN_INDICES) {
+			uint32_t num_monotone_tris = ufbxi_triangulate_monotone(&nc, scratch, indices);
+			if (num_monotone_tris > 0) return num_monotone_tris;
+		}
 
-	sc->total_weights = 0;
+		uint32_t num_indices_u32 = num_indices < UINT32_MAX ? (uint32_t)num_indices : UINT32_MAX;
 
-	ufbxi_subdivide_layer_output output;
-	ufbxi_check_err(&sc->error, ufbxi_subdivide_layer(sc, &output, &input));
+		uint32_t local_indices[12];
+		if (num_indices_u32 < 12) {
+			uint32_t num_tris = ufbxi_triangulate_ngon(&nc, local_indices, 12);
+			memcpy(indices, local_indices, num_tris * 3 * sizeof(uint32_t));
+			return num_tris;
+		} else {
+			return ufbxi_triangulate_ngon(&nc, indices, num_indices_u32);
+		}
+	}
+}
 
-	size_t num_vertices = output.num_values;
-	ufbx_assert(num_vertices == sc->dst_mesh.vertex_position.values.count);
+// Allocate `scratch` for triangulating polygons with up to `max_indices` corners, leaves it
+// empty if no polygon is large enough to use `ufbxi_triangulate_monotone()`.
+ufbxi_nodiscard static int ufbxi_init_monotone_scratch(ufbxi_monotone_scratch *scratch, ufbxi_buf *buf, uint32_t max_indices)
+{
+	memset(scratch, 0, sizeof(ufbxi_monotone_scratch));
+	if (max_indices < UFBXI_MONOTONE_TRIANGULATE_MIN_INDICES) return 1;
+	size_t size = ufbxi_monotone_scratch_size(max_indices);
+	if (size == 0) return 1;
 
-	ufbx_subdivision_weight_range *dst_ranges = ufbxi_push(&sc->result, ufbx_subdivision_weight_range, num_vertices);
-	ufbx_subdivision_weight *dst_weights = ufbxi_push(&sc->result, ufbx_subdivision_weight, sc->total_weights);
-	ufbxi_check_err(&sc->error, ranges && weights);
+	scratch->data = (char*)ufbxi_push(buf, uint64_t, size / 8);
+	if (!scratch->data) return 0;
+	scratch->size = size;
+	return 1;
+}
 
-	ufbxi_subdivision_vertex_weights *src_weights = (ufbxi_subdivision_vertex_weights*)output.values;
+#endif
 
-	size_t weight_offset = 0;
-	for (size_t vi = 0; vi < num_vertices; vi++) {
-		ufbxi_subdivision_vertex_weights ws = src_weights[vi];
-		ufbxi_check_err(&sc->error, (size_t)UINT32_MAX - weight_offset >= ws.num_weights);
-
-		dst_ranges[vi].weight_begin = (uint32_t)weight_offset;
-		dst_ranges[vi].num_weights = (uint32_t)ws.num_weights;
-		memcpy(dst_weights + weight_offset, ws.weights, ws.num_weights * sizeof(ufbx_subdivision_weight));
-		weight_offset += ws.num_weights;
-	}
-
-	ranges->data = dst_ranges;
-	ranges->count = num_vertices;
-	weights->data = dst_weights;
-	weights->count = sc->total_weights;
-
-	return 1;
+static int ufbxi_cmp_topo_index_prev_next(const void *va, const void *vb)
+{
+	const ufbx_topo_edge *a = (const ufbx_topo_edge*)va, *b = (const ufbx_topo_edge*)vb;
+	if ((int32_t)a->prev != (int32_t)b->prev) return (int32_t)a->prev < (int32_t)b->prev ? -1 : +1;
+	if ((int32_t)a->next != (int32_t)b->next) return (int32_t)a->next < (int32_t)b->next ? -1 : +1;
+	return 0;
 }
 
-ufbxi_nodiscard static ufbxi_noinline int ufbxi_subdivide_vertex_crease(ufbxi_subdivide_context *sc, ufbx_vertex_real *ufbxi_restrict dst, const ufbx_vertex_real *ufbxi_restrict src)
+static int ufbxi_cmp_topo_index_index(const void *va, const void *vb)
 {
-	size_t src_indices = src->indices.count;
-	size_t src_values = src->values.count;
+	const ufbx_topo_edge *a = (const ufbx_topo_edge*)va, *b = (const ufbx_topo_edge*)vb;
+	if ((int32_t)a->index != (int32_t)b->index) return (int32_t)a->index < (int32_t)b->index ? -1 : +1;
+	return 0;
+}
 
-	dst->values.count = src_values + 1;
-	dst->values.data = ufbxi_push(&sc->result, ufbx_real, dst->values.count);
-	ufbxi_check_err(&sc->error, dst->values.data);
-	dst->values.data[src_values] = 0.0f;
+ufbxi_noinline static void ufbxi_compute_topology(const ufbx_mesh *mesh, ufbx_topo_edge *topo)
+{
+	size_t num_indices = mesh->num_indices;
 
-	dst->indices.count = src_indices * 4;
-	dst->indices.data = ufbxi_push(&sc->result, uint32_t, dst->indices.count);
-	ufbxi_check_err(&sc->error, dst->indices.data);
+	// Temporarily use `prev` and `next` for vertices
+	for (uint32_t fi = 0; fi < mesh->num_faces; fi++) {
+		ufbx_face face = mesh->faces.data[fi];
+		for (uint32_t pi = 0; pi < face.num_indices; pi++) {
+			ufbx_topo_edge *te = &topo[face.index_begin + pi];
+			uint32_t ni = (pi + 1) % face.num_indices;
+			uint32_t va = mesh->vertex_indices.data[face.index_begin + pi];
+			uint32_t vb = mesh->vertex_indices.data[face.index_begin + ni];
 
-	// Reduce the amount of vertex crease on each iteration
-	ufbxi_nounroll for (size_t i = 0; i < src_values; i++) {
-		ufbx_real crease = src->values.data[i];
-		if (crease < 0.999f) crease -= 0.1f;
-		if (crease < 0.0f) crease = 0.0f;
-		dst->values.data[i] = crease;
+			if (vb < va) {
+				uint32_t vt = va; va = vb; vb = vt;
+			}
+			te->index = face.index_begin + pi;
+			te->twin = UFBX_NO_INDEX;
+			te->edge = UFBX_NO_INDEX;
+			te->prev = va;
+			te->next = vb;
+			te->face = fi;
+			te->flags = (ufbx_topo_flags)0;
+		}
 	}
 
-	// Write the crease at the vertex corner and zero (at `src_values`) on other ones
-	uint32_t zero_index = (uint32_t)src_values;
-	ufbxi_nounroll for (size_t i = 0; i < src_indices; i++) {
-		uint32_t *quad = dst->indices.data + i * 4;
-		quad[0] = src->indices.data[i];
-		quad[1] = zero_index;
-		quad[2] = zero_index;
-		quad[3] = zero_index;
-	}
+	// TODO: Macro unstable/non allocating sort
+	qsort(topo, num_indices, sizeof(ufbx_topo_edge), &ufbxi_cmp_topo_index_prev_next);
 
-	return 1;
-}
+	if (mesh->edges.data) {
+		for (uint32_t ei = 0; ei < mesh->num_edges; ei++) {
+			ufbx_edge edge = mesh->edges.data[ei];
+			uint32_t va = mesh->vertex_indices.data[edge.a];
+			uint32_t vb = mesh->vertex_indices.data[edge.b];
+			if (vb < va) {
+				uint32_t vt = va; va = vb; vb = vt;
+			}
 
-ufbxi_nodiscard static ufbxi_noinline int ufbxi_subdivide_mesh_level(ufbxi_subdivide_context *sc)
-{
-	const ufbx_mesh *mesh = &sc->src_mesh;
-	ufbx_mesh *result = &sc->dst_mesh;
+			size_t ix = num_indices;
+			ufbxi_macro_lower_bound_eq(ufbx_topo_edge, 32, &ix, topo, 0, num_indices,
+				(a->prev == va ? a->next < vb : a->prev < va), (a->prev == va && a->next == vb));
 
-	*result = *mesh;
+			for (; ix < num_indices && topo[ix].prev == va && topo[ix].next == vb; ix++) {
+				topo[ix].edge = ei;
+			}
+		}
+	}
 
-	ufbx_topo_edge *topo = ufbxi_push(&sc->tmp, ufbx_topo_edge, mesh->num_indices);
-	ufbxi_check_err(&sc->error, topo);
-	ufbx_compute_topology(mesh, topo, mesh->num_indices);
-	sc->topo = topo;
-	sc->num_topo = mesh->num_indices;
+	// Connect paired edges
+	for (size_t i0 = 0; i0 < num_indices; ) {
+		size_t i1 = i0;
 
-	ufbxi_check_err(&sc->error, ufbxi_subdivide_attrib(sc, (ufbx_vertex_attrib*)&result->vertex_position, sc->opts.boundary, false));
+		uint32_t a = topo[i0].prev, b = topo[i0].next;
+		while (i1 + 1 < num_indices && topo[i1 + 1].prev == a && topo[i1 + 1].next == b) i1++;
 
-	memset(&result->vertex_uv, 0, sizeof(result->vertex_uv));
-	memset(&result->vertex_tangent, 0, sizeof(result->vertex_tangent));
-	memset(&result->vertex_bitangent, 0, sizeof(result->vertex_bitangent));
-	memset(&result->vertex_color, 0, sizeof(result->vertex_color));
+		if (i1 == i0 + 1) {
+			topo[i0].twin = topo[i1].index;
+			topo[i1].twin = topo[i0].index;
+		} else if (i1 > i0 + 1) {
+			for (size_t i = i0; i <= i1; i++) {
+				topo[i].flags = (ufbx_topo_flags)(topo[i].flags | UFBX_TOPO_NON_MANIFOLD);
+			}
+		}
 
-	result->uv_sets.data = ufbxi_push_copy(&sc->result, ufbx_uv_set, result->uv_sets.count, result->uv_sets.data);
-	ufbxi_check_err(&sc->error, result->uv_sets.data);
+		i0 = i1 + 1;
+	}
 
-	result->color_sets.data = ufbxi_push_copy(&sc->result, ufbx_color_set, result->color_sets.count, result->color_sets.data);
-	ufbxi_check_err(&sc->error, result->color_sets.data);
+	// TODO: Macro unstable/non allocating sort
+	qsort(topo, num_indices, sizeof(ufbx_topo_edge), &ufbxi_cmp_topo_index_index);
 
-	ufbxi_for_list(ufbx_uv_set, set, result->uv_sets) {
-		ufbxi_check_err(&sc->error, ufbxi_subdivide_attrib(sc, (ufbx_vertex_attrib*)&set->vertex_uv, sc->opts.uv_boundary, true));
-		if (sc->opts.interpolate_tangents) {
-			ufbxi_check_err(&sc->error, ufbxi_subdivide_attrib(sc, (ufbx_vertex_attrib*)&set->vertex_tangent, sc->opts.uv_boundary, true));
-			ufbxi_check_err(&sc->error, ufbxi_subdivide_attrib(sc, (ufbx_vertex_attrib*)&set->vertex_bitangent, sc->opts.uv_boundary, true));
-		} else {
-			memset(&set->vertex_tangent, 0, sizeof(set->vertex_tangent));
-			memset(&set->vertex_bitangent, 0, sizeof(set->vertex_bitangent));
+	// Fix `prev` and `next` to the actual index values
+	for (uint32_t fi = 0; fi < mesh->num_faces; fi++) {
+		ufbx_face face = mesh->faces.data[fi];
+		for (uint32_t i = 0; i < face.num_indices; i++) {
+			ufbx_topo_edge *to = &topo[face.index_begin + i];
+			to->prev = (uint32_t)(face.index_begin + (i + face.num_indices - 1) % face.num_indices);
+			to->next = (uint32_t)(face.index_begin + (i + 1) % face.num_indices);
 		}
 	}
+}
 
-	ufbxi_for_list(ufbx_color_set, set, result->color_sets) {
-		ufbxi_check_err(&sc->error, ufbxi_subdivide_attrib(sc, (ufbx_vertex_attrib*)&set->vertex_color, sc->opts.uv_boundary, true));
-	}
+typedef struct {
+	const ufbx_mesh *mesh;
+	ufbx_topo_edge *topo;
 
-	if (result->uv_sets.count > 0) {
-		result->vertex_uv = result->uv_sets.data[0].vertex_uv;
-		result->vertex_bitangent = result->uv_sets.data[0].vertex_bitangent;
-		result->vertex_tangent = result->uv_sets.data[0].vertex_tangent;
-	}
-	if (result->color_sets.count > 0) {
-		result->vertex_color = result->color_sets.data[0].vertex_color;
-	}
+	// Vertices of each edge ordered so that `key_lo[i] <= key_hi[i]`
+	uint32_t *key_lo;
+	uint32_t *key_hi;
 
-	if (sc->opts.interpolate_normals && !sc->opts.ignore_normals) {
-		ufbxi_check_err(&sc->error, ufbxi_subdivide_attrib(sc, (ufbx_vertex_attrib*)&result->vertex_normal, sc->opts.boundary, true));
-		ufbxi_for_list(ufbx_vec3, normal, result->vertex_normal.values) {
-			*normal = ufbxi_slow_normalize3(normal);
+	// Edge indices sorted by `(key_lo, key_hi)`
+	const uint32_t *order;
+
+	size_t face_begin, face_end;
+	size_t order_begin, order_end;
+
+	// Set if all faces and vertex indices in the face range are in bounds
+	bool valid;
+} ufbxi_topo_range;
+
+static ufbxi_noinline void ufbxi_topo_range_init_edges(ufbxi_topo_range *range)
+{
+	const ufbx_mesh *mesh = range->mesh;
+	ufbx_topo_edge *topo = range->topo;
+	const uint32_t *vertex_indices = mesh->vertex_indices.data;
+	uint32_t num_vertices = (uint32_t)mesh->num_vertices;
+
+	bool valid = true;
+	for (size_t fi = range->face_begin; fi < range->face_end; fi++) {
+		ufbx_face face = mesh->faces.data[fi];
+		if (face.num_indices == 0) continue;
+		if (face.index_begin > mesh->num_indices || mesh->num_indices - face.index_begin < face.num_indices) {
+			valid = false;
+			continue;
 		}
-		if (mesh->skinned_normal.values.data == mesh->vertex_normal.values.data) {
-			result->skinned_normal = result->vertex_normal;
-		} else {
-			ufbxi_check_err(&sc->error, ufbxi_subdivide_attrib(sc, (ufbx_vertex_attrib*)&result->skinned_normal, sc->opts.boundary, true));
-			ufbxi_for_list(ufbx_vec3, normal, result->skinned_normal.values) {
-				*normal = ufbxi_slow_normalize3(normal);
-			}
+		uint32_t begin = face.index_begin, last = face.index_begin + face.num_indices - 1;
+		for (uint32_t ix = begin; ix <= last; ix++) {
+			uint32_t prev = ix > begin ? ix - 1 : last;
+			uint32_t next = ix < last ? ix + 1 : begin;
+			uint32_t va = vertex_indices[ix], vb = vertex_indices[next];
+			if (va >= num_vertices) valid = false;
+
+			ufbx_topo_edge *te = &topo[ix];
+			te->index = ix;
+			te->next = next;
+			te->prev = prev;
+			te->twin = UFBX_NO_INDEX;
+			te->face = (uint32_t)fi;
+			te->edge = UFBX_NO_INDEX;
+			te->flags = (ufbx_topo_flags)0;
+			range->key_lo[ix] = ufbxi_min32(va, vb);
+			range->key_hi[ix] = ufbxi_max32(va, vb);
 		}
 	}
+	range->valid = valid;
+}
 
-	if (result->vertex_crease.exists) {
-		ufbxi_check_err(&sc->error, ufbxi_subdivide_vertex_crease(sc, &result->vertex_crease, &mesh->vertex_crease));
-	}
-
-	if (mesh->skinned_position.values.data == mesh->vertex_position.values.data) {
-		result->skinned_position = result->vertex_position;
-	} else {
-		ufbxi_check_err(&sc->error, ufbxi_subdivide_attrib(sc, (ufbx_vertex_attrib*)&result->skinned_position, sc->opts.boundary, false));
-	}
+static ufbxi_noinline void ufbxi_topo_range_connect_edges(ufbxi_topo_range *range)
+{
+	ufbx_topo_edge *topo = range->topo;
+	const uint32_t *order = range->order;
+	const uint32_t *key_lo = range->key_lo, *key_hi = range->key_hi;
+	size_t begin = range->order_begin, end = range->order_end;
+	size_t num_indices = range->mesh->num_indices;
 
-	ufbx_subdivision_result *result_sub = ufbxi_push_zero(&sc->result, ufbx_subdivision_result, 1);
-	ufbxi_check_err(&sc->error, result_sub);
-	result->subdivision_result = result_sub;
+	// Skip the run continuing from the previous range, the last run is finished past `end`
+	size_t i0 = begin;
+	while (i0 > 0 && i0 < end && key_lo[order[i0]] == key_lo[order[i0 - 1]] && key_hi[order[i0]] == key_hi[order[i0 - 1]]) i0++;
 
-	if (sc->opts.evaluate_source_vertices || sc->opts.evaluate_skin_weights) {
-		ufbx_subdivision_result *mesh_sub = mesh->subdivision_result;
+	while (i0 < end) {
+		uint32_t lo = key_lo[order[i0]], hi = key_hi[order[i0]];
+		size_t i1 = i0 + 1;
+		while (i1 < num_indices && key_lo[order[i1]] == lo && key_hi[order[i1]] == hi) i1++;
 
-		ufbx_skin_deformer *skin = NULL;
-		if (sc->opts.evaluate_skin_weights) {
-			if (mesh->skin_deformers.count > 0) {
-				ufbxi_check_err(&sc->error, sc->opts.skin_deformer_index < mesh->skin_deformers.count);
-				skin = mesh->skin_deformers.data[sc->opts.skin_deformer_index];
+		if (i1 - i0 == 2) {
+			topo[order[i0]].twin = order[i0 + 1];
+			topo[order[i0 + 1]].twin = order[i0];
+		} else if (i1 - i0 > 2) {
+			for (size_t i = i0; i < i1; i++) {
+				ufbx_topo_edge *te = &topo[order[i]];
+				te->flags = (ufbx_topo_flags)(te->flags | UFBX_TOPO_NON_MANIFOLD);
 			}
 		}
 
-		size_t max_weights = 0;
-		if (sc->opts.evaluate_source_vertices) {
-			max_weights = ufbxi_max_sz(max_weights, mesh->num_vertices);
-		}
-		if (skin) {
-			max_weights = ufbxi_max_sz(max_weights, skin->clusters.count);
+		i0 = i1;
+	}
+}
+
+static bool ufbxi_topo_init_edges_task_fn(ufbxi_task *task)
+{
+	ufbxi_topo_range_init_edges((ufbxi_topo_range*)task->data);
+	return true;
+}
+
+static bool ufbxi_topo_connect_edges_task_fn(ufbxi_task *task)
+{
+	ufbxi_topo_range_connect_edges((ufbxi_topo_range*)task->data);
+	return true;
+}
+
+// Same result as `ufbxi_compute_topology()` but pairs the edges using a radix sort on the
+// edge vertices instead of comparison sorts. Per-edge setup and pairing are split into
+// face/edge ranges that run in parallel if `pool` is enabled.
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_compute_topology_imp(const ufbx_mesh *mesh, ufbx_topo_edge *topo,
+	ufbxi_buf *tmp, ufbxi_thread_pool *pool, ufbx_error *error)
+{
+	size_t num_faces = mesh->num_faces;
+	size_t num_indices = mesh->num_indices;
+	size_t num_vertices = mesh->num_vertices;
+	size_t num_ranges = (num_faces + UFBXI_TOPOLOGY_TASK_FACES - 1) / UFBXI_TOPOLOGY_TASK_FACES;
+	if (num_ranges == 0 || num_indices == 0) return 1;
+	ufbxi_check_err(error, num_vertices < UINT32_MAX);
+
+	ufbxi_topo_range *ranges = ufbxi_push(tmp, ufbxi_topo_range, num_ranges);
+	uint32_t *key_lo = ufbxi_push(tmp, uint32_t, num_indices);
+	uint32_t *key_hi = ufbxi_push(tmp, uint32_t, num_indices);
+	uint32_t *order = ufbxi_push(tmp, uint32_t, num_indices);
+	uint32_t *order_tmp = ufbxi_push(tmp, uint32_t, num_indices);
+	uint32_t *offsets = ufbxi_push(tmp, uint32_t, num_vertices + 1);
+	ufbxi_check_err(error, ranges && key_lo && key_hi && order && order_tmp && offsets);
+
+	for (size_t i = 0; i < num_ranges; i++) {
+		ufbxi_topo_range *range = &ranges[i];
+		range->mesh = mesh;
+		range->topo = topo;
+		range->key_lo = key_lo;
+		range->key_hi = key_hi;
+		range->order = order;
+		range->face_begin = i * UFBXI_TOPOLOGY_TASK_FACES;
+		range->face_end = ufbxi_min_sz(range->face_begin + UFBXI_TOPOLOGY_TASK_FACES, num_faces);
+		range->order_begin = i * num_indices / num_ranges;
+		range->order_end = (i + 1) * num_indices / num_ranges;
+		range->valid = false;
+	}
+
+	// Indices not covered by any face keep `UINT32_MAX` as `key_lo`
+	memset(key_lo, 0xff, num_indices * sizeof(uint32_t));
+
+	bool threaded = pool && pool->enabled && num_ranges > 1;
+	for (size_t i = 0; i < num_ranges; i++) {
+		ufbxi_task *task = threaded ? ufbxi_thread_pool_create_task(pool, &ufbxi_topo_init_edges_task_fn, "topology_edges") : NULL;
+		if (task) {
+			task->data = &ranges[i];
+			ufbxi_thread_pool_run_task(pool, task, (double)(ranges[i].face_end - ranges[i].face_begin));
+		} else {
+			ufbxi_topo_range_init_edges(&ranges[i]);
 		}
+	}
+	if (threaded) {
+		ufbxi_thread_pool_flush_group(pool);
+		ufbxi_check_err(error, ufbxi_thread_pool_wait_all(pool));
+	}
 
-		sc->tmp_vertex_weights = ufbxi_push_zero(&sc->tmp, ufbx_real, mesh->num_vertices);
-		sc->tmp_weights = ufbxi_push(&sc->tmp, ufbx_subdivision_weight, max_weights);
-		ufbxi_check_err(&sc->error, sc->tmp_vertex_weights && sc->tmp_weights);
+	// Every index must be covered by a face to have valid keys, faces may overlap
+	// in meshes created by the user so the sum of `face.num_indices` is not enough.
+	bool valid = true;
+	for (size_t i = 0; i < num_ranges; i++) {
+		if (!ranges[i].valid) valid = false;
+	}
+	for (size_t i = 0; i < num_indices && valid; i++) {
+		if (key_lo[i] == UINT32_MAX) valid = false;
+	}
 
-		if (sc->opts.evaluate_source_vertices) {
-			sc->max_vertex_weights = sc->opts.max_source_vertices ? sc->opts.max_source_vertices : SIZE_MAX;
+	if (valid) {
+		// Two pass LSD radix sort using vertex indices as digits, the offsets of
+		// the second pass are retained to find the edges starting from a vertex.
+		for (size_t pass = 0; pass < 2; pass++) {
+			const uint32_t *keys = pass == 0 ? key_hi : key_lo;
+			uint32_t *dst = pass == 0 ? order_tmp : order;
 
-			ufbxi_subdivision_vertex_weights *weights;
-			if (mesh_sub && mesh_sub->source_vertex_ranges.count > 0) {
-				weights = ufbxi_subdivision_copy_weights(sc, mesh_sub->source_vertex_ranges, mesh_sub->source_vertex_weights);
-			} else {
-				weights = ufbxi_init_source_vertex_weights(sc, mesh->num_vertices);
+			memset(offsets, 0, (num_vertices + 1) * sizeof(uint32_t));
+			for (size_t i = 0; i < num_indices; i++) {
+				offsets[keys[i] + 1]++;
+			}
+			for (size_t i = 0; i < num_vertices; i++) {
+				offsets[i + 1] += offsets[i];
+			}
+			for (size_t i = 0; i < num_indices; i++) {
+				uint32_t ix = pass == 0 ? (uint32_t)i : order_tmp[i];
+				dst[offsets[keys[ix]]++] = ix;
 			}
-
-			ufbxi_check_err(&sc->error, ufbxi_subdivide_weights(sc, &result_sub->source_vertex_ranges, &result_sub->source_vertex_weights, weights));
 		}
 
-		if (skin) {
-			sc->max_vertex_weights = sc->opts.max_skin_weights ? sc->opts.max_skin_weights : SIZE_MAX;
-
-			ufbxi_subdivision_vertex_weights *weights;
-			if (mesh_sub && mesh_sub->source_vertex_ranges.count > 0) {
-				weights = ufbxi_subdivision_copy_weights(sc, mesh_sub->skin_cluster_ranges, mesh_sub->skin_cluster_weights);
+		// `offsets[v]` now points to the end of the edges with `key_lo == v`
+		for (size_t i = 0; i < num_ranges; i++) {
+			ufbxi_task *task = threaded ? ufbxi_thread_pool_create_task(pool, &ufbxi_topo_connect_edges_task_fn, "topology_connect") : NULL;
+			if (task) {
+				task->data = &ranges[i];
+				ufbxi_thread_pool_run_task(pool, task, (double)(ranges[i].order_end - ranges[i].order_begin));
 			} else {
-				weights = ufbxi_init_skin_weights(sc, mesh->num_vertices, skin);
+				ufbxi_topo_range_connect_edges(&ranges[i]);
 			}
-
-			ufbxi_check_err(&sc->error, ufbxi_subdivide_weights(sc, &result_sub->skin_cluster_ranges, &result_sub->skin_cluster_weights, weights));
+		}
+		if (threaded) {
+			ufbxi_thread_pool_flush_group(pool);
+			ufbxi_check_err(error, ufbxi_thread_pool_wait_all(pool));
 		}
 
-	}
+		if (mesh->edges.data) {
+			for (uint32_t ei = 0; ei < mesh->num_edges; ei++) {
+				ufbx_edge edge = mesh->edges.data[ei];
+				if (edge.a >= num_indices || edge.b >= num_indices) continue;
+				uint32_t va = mesh->vertex_indices.data[edge.a];
+				uint32_t vb = mesh->vertex_indices.data[edge.b];
+				uint32_t lo = ufbxi_min32(va, vb), hi = ufbxi_max32(va, vb);
 
-	result->num_vertices = result->vertex_position.values.count;
-	result->num_indices = mesh->num_indices * 4;
-	result->num_faces = mesh->num_indices;
-	result->num_triangles = mesh->num_indices * 2;
+				size_t begin = lo > 0 ? offsets[lo - 1] : 0, end = offsets[lo];
+				size_t ix = end;
+				ufbxi_macro_lower_bound_eq(uint32_t, 16, &ix, order, begin, end,
+					(key_hi[*a] < hi), (key_hi[*a] == hi));
 
-	result->vertex_indices.data = result->vertex_position.indices.data;
-	result->vertex_indices.count = result->num_indices;
-	result->vertices.data = result->vertex_position.values.data;
-	result->vertices.count = result->num_vertices;
-
-	result->faces.count = result->num_faces;
-	result->faces.data = ufbxi_push(&sc->result, ufbx_face, result->num_faces);
-	ufbxi_check_err(&sc->error, result->faces.data);
+				for (; ix < end && key_hi[order[ix]] == hi; ix++) {
+					topo[order[ix]].edge = ei;
+				}
+			}
+		}
+	} else {
+		// Out of bounds vertex indices can't be used as radix sort digits, clear
+		// the edges first so uncovered indices are not sorted as uninitialized data.
+		memset(topo, 0, num_indices * sizeof(ufbx_topo_edge));
+		ufbxi_compute_topology(mesh, topo);
+	}
 
-	for (size_t i = 0; i < result->num_faces; i++) {
-		result->faces.data[i].index_begin = (uint32_t)(i * 4);
-		result->faces.data[i].num_indices = 4;
+	// Release the temporary arrays if `tmp` is used as a stack
+	if (!tmp->unordered) {
+		ufbxi_pop(tmp, uint32_t, num_vertices + 1, NULL);
+		ufbxi_pop(tmp, uint32_t, num_indices, NULL);
+		ufbxi_pop(tmp, uint32_t, num_indices, NULL);
+		ufbxi_pop(tmp, uint32_t, num_indices, NULL);
+		ufbxi_pop(tmp, uint32_t, num_indices, NULL);
+		ufbxi_pop(tmp, ufbxi_topo_range, num_ranges, NULL);
 	}
+	return 1;
+}
 
-	if (mesh->edges.data) {
-		result->num_edges = mesh->num_edges*2 + result->num_faces;
-		result->edges.count = result->num_edges;
-		result->edges.data = ufbxi_push(&sc->result, ufbx_edge, result->num_edges);
-		ufbxi_check_err(&sc->error, result->edges.data);
+static bool ufbxi_is_edge_smooth(const ufbx_mesh *mesh, const ufbx_topo_edge *topo, size_t num_topo, uint32_t index, bool assume_smooth)
+{
+	ufbxi_ignore(num_topo);
+	ufbx_assert((size_t)index < num_topo);
+	if (mesh->edge_smoothing.data) {
+		uint32_t edge = topo[index].edge;
+		if (edge != UFBX_NO_INDEX && mesh->edge_smoothing.data[edge]) return true;
+	}
 
-		if (mesh->edge_crease.data) {
-			result->edge_crease.count = result->num_edges;
-			result->edge_crease.data = ufbxi_push(&sc->result, ufbx_real, result->num_edges);
-			ufbxi_check_err(&sc->error, result->edge_crease.data);
-		}
-		if (mesh->edge_smoothing.data) {
-			result->edge_smoothing.count = result->num_edges;
-			result->edge_smoothing.data = ufbxi_push(&sc->result, bool, result->num_edges);
-			ufbxi_check_err(&sc->error, result->edge_smoothing.data);
-		}
-		if (mesh->edge_visibility.data) {
-			result->edge_visibility.count = result->num_edges;
-			result->edge_visibility.data = ufbxi_push(&sc->result, bool, result->num_edges);
-			ufbxi_check_err(&sc->error, result->edge_visibility.data);
+	if (mesh->face_smoothing.data) {
+		if (mesh->face_smoothing.data[topo[index].face]) return true;
+		uint32_t twin = topo[index].twin;
+		if (twin != UFBX_NO_INDEX) {
+			if (mesh->face_smoothing.data[topo[twin].face]) return true;
 		}
+	}
 
-		size_t di = 0;
-		for (size_t i = 0; i < mesh->num_edges; i++) {
-			ufbx_edge edge = mesh->edges.data[i];
-			uint32_t face_ix = topo[edge.a].face;
-			ufbx_face face = mesh->faces.data[face_ix];
-			uint32_t offset = edge.a - face.index_begin;
-			uint32_t next = (offset + 1) % (uint32_t)face.num_indices;
-
-			uint32_t a = (face.index_begin + offset) * 4;
-			uint32_t b = (face.index_begin + next) * 4;
+	if (!mesh->edge_smoothing.data && !mesh->face_smoothing.data && mesh->vertex_normal.exists) {
+		uint32_t twin = topo[index].twin;
+		if (twin != UFBX_NO_INDEX && mesh->vertex_normal.exists) {
+			ufbx_assert((size_t)twin < num_topo);
+			ufbx_vec3 a0 = ufbx_get_vertex_vec3(&mesh->vertex_normal, index);
+			ufbx_vec3 a1 = ufbx_get_vertex_vec3(&mesh->vertex_normal, topo[index].next);
+			ufbx_vec3 b0 = ufbx_get_vertex_vec3(&mesh->vertex_normal, topo[twin].next);
+			ufbx_vec3 b1 = ufbx_get_vertex_vec3(&mesh->vertex_normal, twin);
+			if (a0.x == b0.x && a0.y == b0.y && a0.z == b0.z) return true;
+			if (a1.x == b1.x && a1.y == b1.y && a1.z == b1.z) return true;
+		}
+	} else if (assume_smooth) {
+		return true;
+	}
 
-			result->edges.data[di + 0].a = a;
-			result->edges.data[di + 0].b = a + 1;
-			result->edges.data[di + 1].a = b + 3;
-			result->edges.data[di + 1].b = b;
+	return false;
+}
 
-			if (mesh->edge_crease.data) {
-				ufbx_real crease = mesh->edge_crease.data[i];
-				if (crease < 0.999f) crease -= (ufbx_real)0.1;
-				if (crease < 0.0f) crease = 0.0f;
-				result->edge_crease.data[di + 0] = crease;
-				result->edge_crease.data[di + 1] = crease;
-			}
+// -- Subdivision
 
-			if (mesh->edge_smoothing.data) {
-				result->edge_smoothing.data[di + 0] = mesh->edge_smoothing.data[i];
-				result->edge_smoothing.data[di + 1] = mesh->edge_smoothing.data[i];
-			}
+#if UFBXI_FEATURE_SUBDIVISION
 
-			if (mesh->edge_visibility.data) {
-				result->edge_visibility.data[di + 0] = mesh->edge_visibility.data[i];
-				result->edge_visibility.data[di + 1] = mesh->edge_visibility.data[i];
-			}
+typedef struct {
+	const void *data;
+	ufbx_real weight;
+} ufbxi_subdivide_input;
 
-			di += 2;
-		}
+typedef int ufbxi_subdivide_sum_fn(void *user, void *output, const ufbxi_subdivide_input *inputs, size_t num_inputs);
 
-		for (size_t fi = 0; fi < result->num_faces; fi++) {
-			result->edges.data[di].a = (uint32_t)(fi * 4 + 1);
-			result->edges.data[di].b = (uint32_t)(fi * 4 + 2);
+typedef struct {
+	ufbxi_subdivide_sum_fn *sum_fn;
+	void *sum_user;
 
-			if (result->edge_crease.data) {
-				result->edge_crease.data[di] = 0.0f;
-			}
+	const void *values;
+	size_t stride;
 
-			if (result->edge_smoothing.data) {
-				result->edge_smoothing.data[di + 0] = true;
-			}
+	const uint32_t *indices;
 
-			if (result->edge_visibility.data) {
-				result->edge_visibility.data[di + 0] = false;
-			}
+	bool check_split_data;
+	bool ignore_indices;
 
-			di++;
-		}
-	}
+	ufbx_subdivision_boundary boundary;
 
-	if (mesh->face_material.data) {
-		result->face_material.count = result->num_faces;
-		result->face_material.data = ufbxi_push(&sc->result, uint32_t, result->num_faces);
-		ufbxi_check_err(&sc->error, result->face_material.data);
-	}
-	if (mesh->face_smoothing.data) {
-		result->face_smoothing.count = result->num_faces;
-		result->face_smoothing.data = ufbxi_push(&sc->result, bool, result->num_faces);
-		ufbxi_check_err(&sc->error, result->face_smoothing.data);
-	}
-	if (mesh->face_group.data) {
-		result->face_group.count = result->num_faces;
-		result->face_group.data = ufbxi_push(&sc->result, uint32_t, result->num_faces);
-		ufbxi_check_err(&sc->error, result->face_group.data);
-	}
-	if (mesh->face_hole.data) {
-		result->face_hole.count = result->num_faces;
-		result->face_hole.data = ufbxi_push(&sc->result, bool, result->num_faces);
-		ufbxi_check_err(&sc->error, result->face_hole.data);
-	}
+} ufbxi_subdivide_layer_input;
 
-	if (result->material_parts.count > 0) {
-		result->material_parts.data = ufbxi_push_zero(&sc->result, ufbx_mesh_part, result->material_parts.count);
-		ufbxi_check_err(&sc->error, result->materials.data);
-	}
+typedef struct {
+	void *values;
+	size_t num_values;
+	uint32_t *indices;
+	size_t num_indices;
+	bool unique_per_vertex;
+} ufbxi_subdivide_layer_output;
 
-	size_t index_offset = 0;
-	for (size_t i = 0; i < mesh->num_faces; i++) {
-		ufbx_face face = mesh->faces.data[i];
+typedef struct {
+	ufbx_subdivision_weight *weights;
+	size_t num_weights;
+} ufbxi_subdivision_vertex_weights;
 
-		uint32_t mat = 0;
-		if (mesh->face_material.data) {
-			mat = mesh->face_material.data[i];
-			for (size_t ci = 0; ci < face.num_indices; ci++) {
-				result->face_material.data[index_offset + ci] = mat;
-			}
-		}
-		if (mesh->face_smoothing.data) {
-			bool flag = mesh->face_smoothing.data[i];
-			for (size_t ci = 0; ci < face.num_indices; ci++) {
-				result->face_smoothing.data[index_offset + ci] = flag;
-			}
-		}
-		if (mesh->face_group.data) {
-			uint32_t group = mesh->face_group.data[i];
-			for (size_t ci = 0; ci < face.num_indices; ci++) {
-				result->face_group.data[index_offset + ci] = group;
-			}
-		}
-		if (mesh->face_hole.data) {
-			bool flag = mesh->face_hole.data[i];
-			for (size_t ci = 0; ci < face.num_indices; ci++) {
-				result->face_hole.data[index_offset + ci] = flag;
-			}
-		}
-		index_offset += face.num_indices;
-	}
+typedef struct {
+	ufbxi_mesh_imp *imp;
 
-	// Will be filled in by `ufbxi_finalize_mesh()`.
-	result->vertex_first_index.count = 0;
+	ufbx_error error;
 
-	ufbxi_check_err(&sc->error, ufbxi_finalize_mesh_material(&sc->result, &sc->error, result));
-	ufbxi_check_err(&sc->error, ufbxi_finalize_mesh(&sc->result, &sc->error, result));
-	ufbxi_check_err(&sc->error, ufbxi_update_face_groups(&sc->result, &sc->error, result, true));
+	ufbx_mesh *src_mesh_ptr;
+	ufbx_mesh src_mesh;
+	ufbx_mesh dst_mesh;
+	ufbx_topo_edge *topo;
+	size_t num_topo;
 
-	return 1;
-}
+	ufbx_subdivide_opts opts;
 
-ufbxi_nodiscard static ufbxi_noinline int ufbxi_subdivide_mesh_imp(ufbxi_subdivide_context *sc, size_t level)
-{
-	// `ufbx_subdivide_opts` must be cleared to zero first!
-	ufbx_assert(sc->opts._begin_zero == 0 && sc->opts._end_zero == 0);
-	ufbxi_check_err_msg(&sc->error, sc->opts._begin_zero == 0 && sc->opts._end_zero == 0, "Uninitialized options");
+	ufbxi_allocator ator_result;
+	ufbxi_allocator ator_tmp;
 
-	if (sc->opts.boundary == UFBX_SUBDIVISION_BOUNDARY_DEFAULT) {
-		sc->opts.boundary = sc->src_mesh.subdivision_boundary;
-	}
+	ufbxi_buf result;
+	ufbxi_buf tmp;
+	ufbxi_buf source;
 
-	if (sc->opts.uv_boundary == UFBX_SUBDIVISION_BOUNDARY_DEFAULT) {
-		sc->opts.uv_boundary = sc->src_mesh.subdivision_uv_boundary;
-	}
+	ufbxi_subdivide_input *inputs;
+	size_t inputs_cap;
 
-	ufbxi_init_ator(&sc->error, &sc->ator_tmp, &sc->opts.temp_allocator, "temp");
-	ufbxi_init_ator(&sc->error, &sc->ator_result, &sc->opts.result_allocator, "result");
+	ufbx_real *tmp_vertex_weights;
+	ufbx_subdivision_weight *tmp_weights;
+	size_t total_weights;
+	size_t max_vertex_weights;
 
-	sc->result.unordered = true;
-	sc->source.unordered = true;
-	sc->tmp.unordered = true;
+	ufbxi_tracer tracer;
 
-	sc->source.ator = &sc->ator_tmp;
-	sc->tmp.ator = &sc->ator_tmp;
+} ufbxi_subdivide_context;
 
-	for (size_t i = 1; i < level; i++) {
-		sc->result.ator = &sc->ator_tmp;
+static int ufbxi_subdivide_sum_real(void *user, void *output, const ufbxi_subdivide_input *inputs, size_t num_inputs)
+{
+	(void)user;
+	ufbx_real dst = 0.0f;
+	ufbxi_nounroll for (size_t i = 0; i != num_inputs; i++) {
+		ufbx_real src = *(const ufbx_real*)inputs[i].data;
+		ufbx_real weight = inputs[i].weight;
+		dst += src * weight;
+	}
+	*(ufbx_real*)output = dst;
 
-		ufbxi_check_err(&sc->error, ufbxi_subdivide_mesh_level(sc));
+	return 1;
+}
 
-		sc->src_mesh = sc->dst_mesh;
+static int ufbxi_subdivide_sum_vec2(void *user, void *output, const ufbxi_subdivide_input *inputs, size_t num_inputs)
+{
+	(void)user;
+	ufbx_vec2 dst = { 0 };
+	ufbxi_nounroll for (size_t i = 0; i != num_inputs; i++) {
+		const ufbx_vec2 *src = (const ufbx_vec2*)inputs[i].data;
+		ufbx_real weight = inputs[i].weight;
+		dst.x += src->x * weight;
+		dst.y += src->y * weight;
+	}
+	*(ufbx_vec2*)output = dst;
+
+	return 1;
+}
+
+static int ufbxi_subdivide_sum_vec3(void *user, void *output, const ufbxi_subdivide_input *inputs, size_t num_inputs)
+{
+	(void)user;
+	ufbx_vec3 dst = { 0 };
+	ufbxi_nounroll for (size_t i = 0; i != num_inputs; i++) {
+		const ufbx_vec3 *src = (const ufbx_vec3*)inputs[i].data;
+		ufbx_real weight = inputs[i].weight;
+		dst.x += src->x * weight;
+		dst.y += src->y * weight;
+		dst.z += src->z * weight;
+	}
+	*(ufbx_vec3*)output = dst;
+
+	return 1;
+}
+
+static int ufbxi_subdivide_sum_vec4(void *user, void *output, const ufbxi_subdivide_input *inputs, size_t num_inputs)
+{
+	(void)user;
+	ufbx_vec4 dst = { 0 };
+	ufbxi_nounroll for (size_t i = 0; i != num_inputs; i++) {
+		const ufbx_vec4 *src = (const ufbx_vec4*)inputs[i].data;
+		ufbx_real weight = inputs[i].weight;
+		dst.x += src->x * weight;
+		dst.y += src->y * weight;
+		dst.z += src->z * weight;
+		dst.w += src->w * weight;
+	}
+	*(ufbx_vec4*)output = dst;
+
+	return 1;
+}
+
+static ufbxi_noinline int ufbxi_cmp_subdivision_weight(const void *va, const void *vb)
+{
+	ufbx_subdivision_weight a = *(const ufbx_subdivision_weight*)va, b = *(const ufbx_subdivision_weight*)vb;
+	ufbxi_dev_assert(a.index != b.index);
+	if (a.weight != b.weight) return a.weight > b.weight ? -1 : +1;
+	return a.index < b.index ? -1 : +1;
+}
+
+static int ufbxi_subdivide_sum_vertex_weights(void *user, void *output, const ufbxi_subdivide_input *inputs, size_t num_inputs)
+{
+	ufbxi_subdivide_context *sc = (ufbxi_subdivide_context*)user;
+
+	ufbx_real *vertex_weights = sc->tmp_vertex_weights;
+	ufbx_subdivision_weight *tmp_weights = sc->tmp_weights;
+	size_t num_weights = 0;
+
+	ufbxi_nounroll for (size_t input_ix = 0; input_ix != num_inputs; input_ix++) {
+		ufbxi_subdivision_vertex_weights src = *(const ufbxi_subdivision_vertex_weights*)inputs[input_ix].data;
+		ufbx_real input_weight = inputs[input_ix].weight;
+
+		for (size_t weight_ix = 0; weight_ix < src.num_weights; weight_ix++) {
+			ufbx_real weight = input_weight * src.weights[weight_ix].weight;
+			if (weight < 1.175494351e-38f) continue;
+
+			uint32_t vx = src.weights[weight_ix].index;
+			ufbxi_dev_assert(vx < sc->src_mesh.num_vertices);
+
+			ufbx_real prev = vertex_weights[vx];
+			vertex_weights[vx] = prev + weight;
+			if (prev == 0.0f) {
+				tmp_weights[num_weights++].index = vx;
+			}
+		}
+	}
+
+	ufbxi_nounroll for (size_t i = 0; i != num_weights; i++) {
+		uint32_t vx = tmp_weights[i].index;
+		tmp_weights[i].weight = vertex_weights[vx];
+		vertex_weights[vx] = 0.0f;
+	}
+
+	qsort(tmp_weights, num_weights, sizeof(ufbx_subdivision_weight), ufbxi_cmp_subdivision_weight);
+
+	if (num_weights > sc->max_vertex_weights) {
+		num_weights = sc->max_vertex_weights;
+
+		// Normalize weights
+		ufbx_real prefix_weight = 0.0f;
+		ufbxi_nounroll for (size_t i = 0; i != num_weights; i++) {
+			prefix_weight += tmp_weights[i].weight;
+		}
+		ufbxi_nounroll for (size_t i = 0; i != num_weights; i++) {
+			tmp_weights[i].weight /= prefix_weight;
+		}
+	}
+
+	sc->total_weights += num_weights;
+	ufbx_subdivision_weight *weights = ufbxi_push_copy(&sc->tmp, ufbx_subdivision_weight, num_weights, tmp_weights);
+	ufbxi_check_err(&sc->error, weights);
+
+	ufbxi_subdivision_vertex_weights *dst = (ufbxi_subdivision_vertex_weights*)output;
+	dst->weights = weights;
+	dst->num_weights = num_weights;
+
+	return 1;
+}
+
+static ufbxi_subdivide_sum_fn *ufbxi_real_sum_fns[] = {
+	&ufbxi_subdivide_sum_real,
+	&ufbxi_subdivide_sum_vec2,
+	&ufbxi_subdivide_sum_vec3,
+	&ufbxi_subdivide_sum_vec4,
+};
+
+ufbxi_noinline static bool ufbxi_is_edge_split(const ufbxi_subdivide_layer_input *input, const ufbx_topo_edge *topo, uint32_t index)
+{
+	uint32_t twin = topo[index].twin;
+	if (twin != UFBX_NO_INDEX) {
+		uint32_t a0 = input->indices[index];
+		uint32_t a1 = input->indices[topo[index].next];
+		uint32_t b0 = input->indices[topo[twin].next];
+		uint32_t b1 = input->indices[twin];
+		if (a0 == b0 && a1 == b1) return false;
+		if (!input->check_split_data) return true;
+		size_t stride = input->stride;
+		char *da0 = (char*)input->values + a0 * stride;
+		char *da1 = (char*)input->values + a1 * stride;
+		char *db0 = (char*)input->values + b0 * stride;
+		char *db1 = (char*)input->values + b1 * stride;
+		if (!memcmp(da0, db0, stride) && !memcmp(da1, db1, stride)) return false;
+		return true;
+	}
+
+	return false;
+}
+
+static ufbx_real ufbxi_edge_crease(const ufbx_mesh *mesh, bool split, const ufbx_topo_edge *topo, uint32_t index)
+{
+	if (topo[index].twin == UFBX_NO_INDEX) return 1.0f;
+	if (split) return 1.0f;
+	if (mesh->edge_crease.data && topo[index].edge != UFBX_NO_INDEX) return mesh->edge_crease.data[topo[index].edge] * (ufbx_real)10.0;
+	return 0.0f;
+}
+
+static ufbxi_noinline int ufbxi_subdivide_layer(ufbxi_subdivide_context *sc, ufbxi_subdivide_layer_output *output, const ufbxi_subdivide_layer_input *input)
+{
+	ufbx_subdivision_boundary boundary = input->boundary;
+
+	const ufbx_mesh *mesh = &sc->src_mesh;
+	const ufbx_topo_edge *topo = sc->topo;
+	size_t num_topo = sc->num_topo;
+
+	uint32_t *edge_indices = ufbxi_push(&sc->result, uint32_t, mesh->num_indices);
+	ufbxi_check_err(&sc->error, edge_indices);
+
+	size_t num_edge_values = 0;
+	for (uint32_t ix = 0; ix < (uint32_t)mesh->num_indices; ix++) {
+		uint32_t twin = topo[ix].twin;
+		if (twin < ix && !ufbxi_is_edge_split(input, topo, ix)) {
+			edge_indices[ix] = edge_indices[twin];
+		} else {
+			edge_indices[ix] = (uint32_t)num_edge_values++;
+		}
+	}
+
+	size_t stride = input->stride;
+	size_t num_initial_values = (num_edge_values + mesh->num_faces + mesh->num_indices);
+	char *values = (char*)ufbxi_push_size(&sc->tmp, stride, num_initial_values);
+	ufbxi_check_err(&sc->error, values);
+
+	char *face_values = values;
+	char *edge_values = face_values + mesh->num_faces * stride;
+	char *vertex_values = edge_values + num_edge_values * stride;
+
+	size_t num_vertex_values = 0;
+
+	uint32_t *vertex_indices = ufbxi_push(&sc->result, uint32_t, mesh->num_indices);
+	ufbxi_check_err(&sc->error, vertex_indices);
+
+	size_t min_inputs = ufbxi_max_sz(32, mesh->max_face_triangles + 2);
+	ufbxi_check_err(&sc->error, ufbxi_grow_array(&sc->ator_tmp, &sc->inputs, &sc->inputs_cap, min_inputs));
+	ufbxi_subdivide_input *inputs = sc->inputs;
+
+	// Assume initially unique per vertex, remove if not the case
+	output->unique_per_vertex = true;
+
+	bool sharp_corners = false;
+	bool sharp_splits = false;
+	bool sharp_all = false;
+
+	switch (boundary) {
+	case UFBX_SUBDIVISION_BOUNDARY_DEFAULT:
+	case UFBX_SUBDIVISION_BOUNDARY_SHARP_NONE:
+	case UFBX_SUBDIVISION_BOUNDARY_LEGACY:
+		// All smooth
+		break;
+	case UFBX_SUBDIVISION_BOUNDARY_SHARP_CORNERS:
+		sharp_corners = true;
+		break;
+	case UFBX_SUBDIVISION_BOUNDARY_SHARP_BOUNDARY:
+		sharp_corners = true;
+		sharp_splits = true;
+		break;
+	case UFBX_SUBDIVISION_BOUNDARY_SHARP_INTERIOR:
+		sharp_all = true;
+		break;
+	default:
+		ufbx_assert(0 && "Bad boundary mode");
+		break;
+	}
+
+	ufbxi_subdivide_sum_fn *sum_fn = input->sum_fn;
+	void *sum_user = input->sum_user;
+
+	// Mark unused indices as `UFBX_NO_INDEX` so we can patch non-manifold
+	ufbxi_nounroll for (size_t i = 0; i < mesh->num_indices; i++) {
+		vertex_indices[i] = UFBX_NO_INDEX;
+	}
+
+	// Face points
+	for (size_t fi = 0; fi < mesh->num_faces; fi++) {
+		ufbx_face face = mesh->faces.data[fi];
+		char *dst = face_values + fi * stride;
+
+		ufbx_real weight = 1.0f / (ufbx_real)face.num_indices;
+		for (uint32_t ci = 0; ci < face.num_indices; ci++) {
+			uint32_t ix = face.index_begin + ci;
+			inputs[ci].data = (const char*)input->values + input->indices[ix] * stride;
+			inputs[ci].weight = weight;
+		}
+
+		ufbxi_check_err(&sc->error, sum_fn(sum_user, dst, inputs, face.num_indices));
+	}
+
+	// Edge points
+	for (uint32_t ix = 0; ix < mesh->num_indices; ix++) {
+		char *dst = edge_values + edge_indices[ix] * stride;
+
+		uint32_t twin = topo[ix].twin;
+		bool split = ufbxi_is_edge_split(input, topo, ix);
+
+		if (split || (topo[ix].flags & UFBX_TOPO_NON_MANIFOLD) != 0) {
+			output->unique_per_vertex = false;
+		}
+
+		ufbx_real crease = 0.0f;
+		if (split || twin == UFBX_NO_INDEX) {
+			crease = 1.0f;
+		} else if (topo[ix].edge != UFBX_NO_INDEX && mesh->edge_crease.data) {
+			crease = mesh->edge_crease.data[topo[ix].edge] * (ufbx_real)10.0;
+		}
+		if (sharp_all) crease = 1.0f;
+
+		const char *v0 = (const char*)input->values + input->indices[ix] * stride;
+		const char *v1 = (const char*)input->values + input->indices[topo[ix].next] * stride;
+
+		// TODO: Unify
+		if (twin < ix && !split) {
+			// Already calculated
+		} else if (crease <= 0.0f) {
+			const char *f0 = face_values + topo[ix].face * stride;
+			const char *f1 = face_values + topo[twin].face * stride;
+			inputs[0].data = v0;
+			inputs[0].weight = 0.25f;
+			inputs[1].data = v1;
+			inputs[1].weight = 0.25f;
+			inputs[2].data = f0;
+			inputs[2].weight = 0.25f;
+			inputs[3].data = f1;
+			inputs[3].weight = 0.25f;
+			ufbxi_check_err(&sc->error, sum_fn(sum_user, dst, inputs, 4));
+		} else if (crease >= 1.0f) {
+			inputs[0].data = v0;
+			inputs[0].weight = 0.5f;
+			inputs[1].data = v1;
+			inputs[1].weight = 0.5f;
+			ufbxi_check_err(&sc->error, sum_fn(sum_user, dst, inputs, 2));
+		} else if (crease < 1.0f) {
+			const char *f0 = face_values + topo[ix].face * stride;
+			const char *f1 = face_values + topo[twin].face * stride;
+			ufbx_real w0 = 0.25f + 0.25f * crease;
+			ufbx_real w1 = 0.25f - 0.25f * crease;
+
+			inputs[0].data = v0;
+			inputs[0].weight = w0;
+			inputs[1].data = v1;
+			inputs[1].weight = w0;
+			inputs[2].data = f0;
+			inputs[2].weight = w1;
+			inputs[3].data = f1;
+			inputs[3].weight = w1;
+			ufbxi_check_err(&sc->error, sum_fn(sum_user, dst, inputs, 4));
+		}
+	}
+
+	// Vertex points
+	for (size_t vi = 0; vi < mesh->num_vertices; vi++) {
+		uint32_t original_start = mesh->vertex_first_index.data[vi];
+		if (original_start == UFBX_NO_INDEX) continue;
+
+		// Find a topological boundary, or if not found a split edge
+		uint32_t start = original_start;
+		for (uint32_t cur = start;;) {
+			uint32_t prev = ufbx_topo_prev_vertex_edge(topo, num_topo, cur);
+			if (prev == UFBX_NO_INDEX) { start = cur; break; } // Topological boundary: Stop and use as start
+			if (ufbxi_is_edge_split(input, topo, prev)) start = cur; // Split edge: Consider as start
+			if (prev == original_start) break; // Loop: Stop, use original start or split if found
+			cur = prev;
+		}
+
+		original_start = start;
+		while (start != UFBX_NO_INDEX) {
+			if (start != original_start) {
+				output->unique_per_vertex = false;
+			}
+
+			uint32_t value_index = (uint32_t)num_vertex_values++;
+			char *dst = vertex_values + value_index * stride;
+
+			// We need to compute the average crease value and keep track of
+			// two creased edges, if there's more we use the corner rule that
+			// does not need the information.
+			ufbx_real total_crease = 0.0f;
+			size_t num_crease = 0;
+			size_t num_split = 0;
+			bool on_boundary = false;
+			bool non_manifold = false;
+			size_t crease_input_indices[2];
+
+			// At start we always have two edges and a single face
+			uint32_t start_prev = topo[start].prev;
+			uint32_t end_edge = topo[start_prev].twin;
+			size_t valence = 2;
+
+			non_manifold |= (topo[start].flags & UFBX_TOPO_NON_MANIFOLD) != 0;
+			non_manifold |= (topo[start_prev].flags & UFBX_TOPO_NON_MANIFOLD) != 0;
+
+			const char *v0 = (const char*)input->values + input->indices[start] * stride;
+
+			size_t num_inputs = 4;
+
+			{
+				const char *e0 = (const char*)input->values + input->indices[topo[start].next] * stride;
+				const char *e1 = (const char*)input->values + input->indices[start_prev] * stride;
+				const char *f0 = face_values + topo[start].face * stride;
+				inputs[0].data = v0;
+				inputs[1].data = e0;
+				inputs[2].data = e1;
+				inputs[3].data = f0;
+			}
+
+			bool start_split = ufbxi_is_edge_split(input, topo, start);
+			bool prev_split = end_edge != UFBX_NO_INDEX && ufbxi_is_edge_split(input, topo, end_edge);
+
+			// Either of the first two edges may be creased
+			ufbx_real start_crease = ufbxi_edge_crease(mesh, start_split, topo, start);
+			if (start_crease > 0.0f) {
+				total_crease += start_crease;
+				crease_input_indices[num_crease++] = 1;
+			}
+			ufbx_real prev_crease = ufbxi_edge_crease(mesh, prev_split, topo, start_prev);
+			if (prev_crease > 0.0f) {
+				total_crease += prev_crease;
+				crease_input_indices[num_crease++] = 2;
+			}
+
+			if (end_edge != UFBX_NO_INDEX) {
+				if (prev_split) {
+					num_split++;
+				}
+			} else {
+				on_boundary = true;
+			}
+
+			ufbxi_check_err(&sc->error, vertex_indices[start] == UFBX_NO_INDEX);
+			vertex_indices[start] = value_index;
+
+			if (start_split) {
+				// We need to special case if the first edge is split as we have
+				// handled it already in the code above..
+				start = ufbx_topo_next_vertex_edge(topo, num_topo, start);
+				num_split++;
+			} else {
+				// Follow vertex edges until we either hit a topological/split boundary
+				// or loop back to the left edge we accounted for in `start_prev`
+				uint32_t cur = start;
+				for (;;) {
+					cur = ufbx_topo_next_vertex_edge(topo, num_topo, cur);
+
+					// Topological boundary: Finished
+					if (cur == UFBX_NO_INDEX) {
+						on_boundary = true;
+						start = UFBX_NO_INDEX;
+						break;
+					}
+
+					non_manifold |= (topo[cur].flags & UFBX_TOPO_NON_MANIFOLD) != 0;
+					ufbxi_check_err(&sc->error, vertex_indices[cur] == UFBX_NO_INDEX);
+					vertex_indices[cur] = value_index;
+
+					bool split = ufbxi_is_edge_split(input, topo, cur);
+
+					// Looped: Add the face from the other side still if not split
+					if (cur == end_edge && !split) {
+						ufbxi_check_err(&sc->error, ufbxi_grow_array(&sc->ator_tmp, &sc->inputs, &sc->inputs_cap, num_inputs + 1));
+						const char *f0 = face_values + topo[cur].face * stride;
+						inputs[num_inputs].data = f0;
+						start = UFBX_NO_INDEX;
+						num_inputs += 1;
+						break;
+					}
+
+					// Add the edge crease, this also handles boundaries as they
+					// have an implicit crease of 1.0 using `ufbxi_edge_crease()`
+					ufbx_real cur_crease = ufbxi_edge_crease(mesh, split, topo, cur);
+					if (cur_crease > 0.0f) {
+						total_crease += cur_crease;
+						if (num_crease < 2) crease_input_indices[num_crease] = num_inputs;
+						num_crease++;
+					}
+
+					// Add the new edge and face to the sum
+					{
+						ufbxi_check_err(&sc->error, ufbxi_grow_array(&sc->ator_tmp, &sc->inputs, &sc->inputs_cap, num_inputs + 2));
+						inputs = sc->inputs;
+
+						const char *e0 = (char*)input->values + input->indices[topo[cur].next] * stride;
+						const char *f0 = face_values + topo[cur].face * stride;
+						inputs[num_inputs + 0].data = e0;
+						inputs[num_inputs + 1].data = f0;
+						num_inputs += 2;
+					}
+					valence++;
+
+					// If we landed at a split edge advance to the next one
+					// and continue from there in the outer loop
+					if (split) {
+						start = ufbx_topo_next_vertex_edge(topo, num_topo, cur);
+						num_split++;
+						break;
+					}
+				}
+			}
+
+			if (start == original_start) start = UFBX_NO_INDEX;
+
+			// Weights for various subdivision masks
+			ufbx_real fe_weight = 1.0f / (ufbx_real)(valence*valence);
+			ufbx_real v_weight = (ufbx_real)(valence - 2) / (ufbx_real)valence;
+
+			// Select the right subdivision mask depending on valence and crease
+			if (num_crease > 2
+				|| (sharp_corners && valence == 2 && (num_split > 0 || on_boundary))
+				|| (sharp_splits && (num_split > 0 || on_boundary))
+				|| sharp_all
+				|| non_manifold) {
+				// Corner: Copy as-is
+				inputs[0].data = v0;
+				inputs[0].weight = 1.0f;
+				num_inputs = 1;
+			} else if (num_crease == 2) {
+				// Boundary: Interpolate edge
+				total_crease *= 0.5f;
+				if (total_crease < 0.0f) total_crease = 0.0f;
+				if (total_crease > 1.0f) total_crease = 1.0f;
+
+				inputs[0].weight = v_weight * (1.0f - total_crease) + 0.75f * total_crease;
+				ufbx_real few = fe_weight * (1.0f - total_crease);
+				for (size_t i = 1; i < num_inputs; i++) {
+					inputs[i].weight = few;
+				}
+
+				// Add weight to the creased edges
+				inputs[crease_input_indices[0]].weight += 0.125f * total_crease;
+				inputs[crease_input_indices[1]].weight += 0.125f * total_crease;
+			} else {
+				// Regular: Weighted sum with the accumulated edge/face points
+				inputs[0].weight = v_weight;
+				for (size_t i = 1; i < num_inputs; i++) {
+					inputs[i].weight = fe_weight;
+				}
+
+			}
+
+			if (mesh->vertex_crease.exists) {
+				ufbx_real v = ufbx_get_vertex_real(&mesh->vertex_crease, original_start);
+				v *= (ufbx_real)10.0;
+				if (v > 0.0f) {
+					if (v > 1.0) v = 1.0f;
+
+					ufbx_real iv = 1.0f - v;
+					inputs[0].weight = 1.0f * v + (inputs[0].weight) * iv;
+					for (size_t i = 1; i < num_inputs; i++) {
+						inputs[i].weight *= iv;
+					}
+				}
+			}
+
+#if defined(UFBX_REGRESSION)
+			{
+				ufbx_real total_weight = 0.0f;
+				for (size_t i = 0; i < num_inputs; i++) {
+					total_weight += inputs[i].weight;
+				}
+				ufbx_assert(ufbx_fabs(total_weight - 1.0f) < 0.001f);
+			}
+#endif
+
+			ufbxi_check_err(&sc->error, sum_fn(sum_user, dst, inputs, num_inputs));
+		}
+	}
+
+	// Copy non-manifold vertex values as-is
+	for (size_t old_ix = 0; old_ix < mesh->num_indices; old_ix++) {
+		uint32_t ix = vertex_indices[old_ix];
+		if (ix == UFBX_NO_INDEX) {
+			ix = (uint32_t)num_vertex_values++;
+			vertex_indices[old_ix] = ix;
+			const char *src = (const char*)input->values + input->indices[old_ix] * stride;
+			char *dst = vertex_values + ix * stride;
+
+			inputs[0].data = src;
+			inputs[0].weight = 1.0f;
+			ufbxi_check_err(&sc->error, sum_fn(sum_user, dst, inputs, 1));
+		}
+	}
+
+	ufbx_assert(num_vertex_values <= mesh->num_indices);
+	size_t num_values = num_edge_values + mesh->num_faces + num_vertex_values;
+	char *new_values = (char*)ufbxi_push_size(&sc->result, stride, (num_values+1));
+	ufbxi_check_err(&sc->error, new_values);
+
+	memset(new_values, 0, stride);
+	new_values += stride;
+
+	memcpy(new_values, values, num_values * stride);
+
+	output->values = new_values;
+	output->num_values = num_values;
+
+	if (!input->ignore_indices) {
+		uint32_t *new_indices = ufbxi_push(&sc->result, uint32_t, mesh->num_indices * 4);
+		ufbxi_check_err(&sc->error, new_indices);
+
+		uint32_t face_start = 0;
+		uint32_t edge_start = (uint32_t)(face_start + mesh->num_faces);
+		uint32_t vert_start = (uint32_t)(edge_start + num_edge_values);
+		uint32_t *p_ix = new_indices;
+		for (size_t ix = 0; ix < mesh->num_indices; ix++) {
+			p_ix[0] = vert_start + vertex_indices[ix];
+			p_ix[1] = edge_start + edge_indices[ix];
+			p_ix[2] = face_start + topo[ix].face;
+			p_ix[3] = edge_start + edge_indices[topo[ix].prev];
+			p_ix += 4;
+		}
+		output->indices = new_indices;
+		output->num_indices = mesh->num_indices * 4;
+	} else {
+		output->indices = NULL;
+		output->num_indices = 0;
+	}
+
+	return 1;
+}
+
+static ufbxi_noinline int ufbxi_subdivide_attrib(ufbxi_subdivide_context *sc, ufbx_vertex_attrib *attrib, ufbx_subdivision_boundary boundary, bool check_split_data)
+{
+	if (!attrib->exists) return 1;
+
+	ufbx_assert(attrib->value_reals >= 1 && attrib->value_reals <= 4);
+
+	ufbxi_subdivide_layer_input input;
+	input.sum_fn = ufbxi_real_sum_fns[attrib->value_reals - 1];
+	input.sum_user = NULL;
+	input.values = attrib->values.data;
+	input.indices = attrib->indices.data;
+	input.stride = attrib->value_reals * sizeof(ufbx_real);
+	input.boundary = boundary;
+	input.check_split_data = check_split_data;
+	input.ignore_indices = false;
+
+	ufbxi_subdivide_layer_output output;
+	ufbxi_check_err(&sc->error, ufbxi_subdivide_layer(sc, &output, &input));
+
+	attrib->values.data = output.values;
+	attrib->indices.data = output.indices;
+	attrib->values.count = output.num_values;
+	attrib->indices.count = output.num_indices;
+
+	return 1;
+}
+
+static ufbxi_noinline ufbxi_subdivision_vertex_weights *ufbxi_subdivision_copy_weights(ufbxi_subdivide_context *sc, ufbx_subdivision_weight_range_list ranges, ufbx_subdivision_weight_list weights)
+{
+	ufbxi_subdivision_vertex_weights *dst = ufbxi_push(&sc->tmp, ufbxi_subdivision_vertex_weights, ranges.count);
+	ufbxi_check_return_err(&sc->error, dst, NULL);
+
+	ufbxi_nounroll for (size_t i = 0; i != ranges.count; i++) {
+		ufbx_subdivision_weight_range range = ranges.data[i];
+		dst[i].weights = weights.data + range.weight_begin;
+		dst[i].num_weights = range.num_weights;
+	}
+
+	return dst;
+}
+
+static ufbxi_noinline ufbxi_subdivision_vertex_weights *ufbxi_init_source_vertex_weights(ufbxi_subdivide_context *sc, size_t num_vertices)
+{
+	ufbxi_subdivision_vertex_weights *dst = ufbxi_push(&sc->tmp, ufbxi_subdivision_vertex_weights, num_vertices);
+	ufbx_subdivision_weight *weights = ufbxi_push(&sc->tmp, ufbx_subdivision_weight, num_vertices);
+	ufbxi_check_return_err(&sc->error, dst && weights, NULL);
+
+	ufbxi_nounroll for (size_t i = 0; i != num_vertices; i++) {
+		dst[i].weights = weights + i;
+		dst[i].num_weights = 1;
+		weights[i].index = (uint32_t)i;
+		weights[i].weight = 1.0f;
+	}
+
+	return dst;
+}
+
+static ufbxi_noinline ufbxi_subdivision_vertex_weights *ufbxi_init_skin_weights(ufbxi_subdivide_context *sc, size_t num_vertices, const ufbx_skin_deformer *skin)
+{
+	ufbxi_subdivision_vertex_weights *dst = ufbxi_push(&sc->tmp, ufbxi_subdivision_vertex_weights, num_vertices);
+	ufbxi_check_return_err(&sc->error, dst, NULL);
+
+	for (size_t i = 0; i < num_vertices; i++) {
+		ufbxi_dev_assert(i < skin->vertices.count);
+		ufbx_skin_vertex vertex = skin->vertices.data[i];
+		size_t num_weights = ufbxi_min_sz(sc->max_vertex_weights, vertex.num_weights);
+
+		ufbx_subdivision_weight *weights = ufbxi_push(&sc->tmp, ufbx_subdivision_weight, num_weights);
+		ufbxi_check_err(&sc->error, weights);
+
+		const ufbx_skin_weight *skin_weights = skin->weights.data + vertex.weight_begin;
+
+		dst[i].weights = weights;
+		dst[i].num_weights = num_weights;
+		ufbxi_nounroll for (size_t wi = 0; wi != num_weights; wi++) {
+			ufbxi_check_err(&sc->error, skin_weights[wi].cluster_index <= INT32_MAX);
+			weights[wi].index = skin_weights[wi].cluster_index;
+			weights[wi].weight = skin_weights[wi].weight;
+		}
+	}
+
+	return dst;
+}
+
+static ufbxi_noinline int ufbxi_subdivide_weights(ufbxi_subdivide_context *sc, ufbx_subdivision_weight_range_list *ranges,
+	ufbx_subdivision_weight_list *weights, const ufbxi_subdivision_vertex_weights *src)
+{
+	ufbxi_check_err(&sc->error, src);
+
+	ufbxi_subdivide_layer_input input;
+	input.sum_fn = ufbxi_subdivide_sum_vertex_weights;
+	input.sum_user = sc;
+	input.values = src;
+	input.indices = sc->src_mesh.vertex_indices.data;
+	input.stride = sizeof(ufbxi_subdivision_vertex_weights);
+	input.boundary = sc->opts.boundary;
+	input.check_split_data = false;
+	input.ignore_indices = true;
+
+	sc->total_weights = 0;
+
+	ufbxi_subdivide_layer_output output;
+	ufbxi_check_err(&sc->error, ufbxi_subdivide_layer(sc, &output, &input));
+
+	size_t num_vertices = output.num_values;
+	ufbx_assert(num_vertices == sc->dst_mesh.vertex_position.values.count);
+
+	ufbx_subdivision_weight_range *dst_ranges = ufbxi_push(&sc->result, ufbx_subdivision_weight_range, num_vertices);
+	ufbx_subdivision_weight *dst_weights = ufbxi_push(&sc->result, ufbx_subdivision_weight, sc->total_weights);
+	ufbxi_check_err(&sc->error, ranges && weights);
+
+	ufbxi_subdivision_vertex_weights *src_weights = (ufbxi_subdivision_vertex_weights*)output.values;
+
+	size_t weight_offset = 0;
+	for (size_t vi = 0; vi < num_vertices; vi++) {
+		ufbxi_subdivision_vertex_weights ws = src_weights[vi];
+		ufbxi_check_err(&sc->error, (size_t)UINT32_MAX - weight_offset >= ws.num_weights);
+
+		dst_ranges[vi].weight_begin = (uint32_t)weight_offset;
+		dst_ranges[vi].num_weights = (uint32_t)ws.num_weights;
+		memcpy(dst_weights + weight_offset, ws.weights, ws.num_weights * sizeof(ufbx_subdivision_weight));
+		weight_offset += ws.num_weights;
+	}
+
+	ranges->data = dst_ranges;
+	ranges->count = num_vertices;
+	weights->data = dst_weights;
+	weights->count = sc->total_weights;
+
+	return 1;
+}
+
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_subdivide_vertex_crease(ufbxi_subdivide_context *sc, ufbx_vertex_real *ufbxi_restrict dst, const ufbx_vertex_real *ufbxi_restrict src)
+{
+	size_t src_indices = src->indices.count;
+	size_t src_values = src->values.count;
+
+	dst->values.count = src_values + 1;
+	dst->values.data = ufbxi_push(&sc->result, ufbx_real, dst->values.count);
+	ufbxi_check_err(&sc->error, dst->values.data);
+	dst->values.data[src_values] = 0.0f;
+
+	dst->indices.count = src_indices * 4;
+	dst->indices.data = ufbxi_push(&sc->result, uint32_t, dst->indices.count);
+	ufbxi_check_err(&sc->error, dst->indices.data);
+
+	// Reduce the amount of vertex crease on each iteration
+	ufbxi_nounroll for (size_t i = 0; i < src_values; i++) {
+		ufbx_real crease = src->values.data[i];
+		if (crease < 0.999f) crease -= 0.1f;
+		if (crease < 0.0f) crease = 0.0f;
+		dst->values.data[i] = crease;
+	}
+
+	// Write the crease at the vertex corner and zero (at `src_values`) on other ones
+	uint32_t zero_index = (uint32_t)src_values;
+	ufbxi_nounroll for (size_t i = 0; i < src_indices; i++) {
+		uint32_t *quad = dst->indices.data + i * 4;
+		quad[0] = src->indices.data[i];
+		quad[1] = zero_index;
+		quad[2] = zero_index;
+		quad[3] = zero_index;
+	}
+
+	return 1;
+}
+
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_subdivide_mesh_level(ufbxi_subdivide_context *sc)
+{
+	const ufbx_mesh *mesh = &sc->src_mesh;
+	ufbx_mesh *result = &sc->dst_mesh;
+
+	*result = *mesh;
+
+	// Reuse the topology of the source mesh if it has been computed already
+	ufbx_topo_edge *topo = mesh->topology.data;
+	if (mesh->topology.count != mesh->num_indices) {
+		topo = ufbxi_push(&sc->tmp, ufbx_topo_edge, mesh->num_indices);
+		ufbxi_check_err(&sc->error, topo);
+		ufbxi_check_err(&sc->error, ufbxi_compute_topology_imp(mesh, topo, &sc->tmp, NULL, &sc->error));
+	}
+	sc->topo = topo;
+	sc->num_topo = mesh->num_indices;
+
+	ufbxi_check_err(&sc->error, ufbxi_subdivide_attrib(sc, (ufbx_vertex_attrib*)&result->vertex_position, sc->opts.boundary, false));
+
+	memset(&result->vertex_uv, 0, sizeof(result->vertex_uv));
+	memset(&result->vertex_tangent, 0, sizeof(result->vertex_tangent));
+	memset(&result->vertex_bitangent, 0, sizeof(result->vertex_bitangent));
+	memset(&result->vertex_color, 0, sizeof(result->vertex_color));
+
+	result->uv_sets.data = ufbxi_push_copy(&sc->result, ufbx_uv_set, result->uv_sets.count, result->uv_sets.data);
+	ufbxi_check_err(&sc->error, result->uv_sets.data);
+
+	result->color_sets.data = ufbxi_push_copy(&sc->result, ufbx_color_set, result->color_sets.count, result->color_sets.data);
+	ufbxi_check_err(&sc->error, result->color_sets.data);
+
+	ufbxi_for_list(ufbx_uv_set, set, result->uv_sets) {
+		ufbxi_check_err(&sc->error, ufbxi_subdivide_attrib(sc, (ufbx_vertex_attrib*)&set->vertex_uv, sc->opts.uv_boundary, true));
+		if (sc->opts.interpolate_tangents) {
+			ufbxi_check_err(&sc->error, ufbxi_subdivide_attrib(sc, (ufbx_vertex_attrib*)&set->vertex_tangent, sc->opts.uv_boundary, true));
+			ufbxi_check_err(&sc->error, ufbxi_subdivide_attrib(sc, (ufbx_vertex_attrib*)&set->vertex_bitangent, sc->opts.uv_boundary, true));
+		} else {
+			memset(&set->vertex_tangent, 0, sizeof(set->vertex_tangent));
+			memset(&set->vertex_bitangent, 0, sizeof(set->vertex_bitangent));
+		}
+	}
+
+	ufbxi_for_list(ufbx_color_set, set, result->color_sets) {
+		ufbxi_check_err(&sc->error, ufbxi_subdivide_attrib(sc, (ufbx_vertex_attrib*)&set->vertex_color, sc->opts.uv_boundary, true));
+	}
+
+	if (result->uv_sets.count > 0) {
+		result->vertex_uv = result->uv_sets.data[0].vertex_uv;
+		result->vertex_bitangent = result->uv_sets.data[0].vertex_bitangent;
+		result->vertex_tangent = result->uv_sets.data[0].vertex_tangent;
+	}
+	if (result->color_sets.count > 0) {
+		result->vertex_color = result->color_sets.data[0].vertex_color;
+	}
+
+	if (sc->opts.interpolate_normals && !sc->opts.ignore_normals) {
+		ufbxi_check_err(&sc->error, ufbxi_subdivide_attrib(sc, (ufbx_vertex_attrib*)&result->vertex_normal, sc->opts.boundary, true));
+		ufbxi_for_list(ufbx_vec3, normal, result->vertex_normal.values) {
+			*normal = ufbxi_slow_normalize3(normal);
+		}
+		if (mesh->skinned_normal.values.data == mesh->vertex_normal.values.data) {
+			result->skinned_normal = result->vertex_normal;
+		} else {
+			ufbxi_check_err(&sc->error, ufbxi_subdivide_attrib(sc, (ufbx_vertex_attrib*)&result->skinned_normal, sc->opts.boundary, true));
+			ufbxi_for_list(ufbx_vec3, normal, result->skinned_normal.values) {
+				*normal = ufbxi_slow_normalize3(normal);
+			}
+		}
+	}
+
+	if (result->vertex_crease.exists) {
+		ufbxi_check_err(&sc->error, ufbxi_subdivide_vertex_crease(sc, &result->vertex_crease, &mesh->vertex_crease));
+	}
+
+	if (mesh->skinned_position.values.data == mesh->vertex_position.values.data) {
+		result->skinned_position = result->vertex_position;
+	} else {
+		ufbxi_check_err(&sc->error, ufbxi_subdivide_attrib(sc, (ufbx_vertex_attrib*)&result->skinned_position, sc->opts.boundary, false));
+	}
+
+	ufbx_subdivision_result *result_sub = ufbxi_push_zero(&sc->result, ufbx_subdivision_result, 1);
+	ufbxi_check_err(&sc->error, result_sub);
+	result->subdivision_result = result_sub;
+
+	if (sc->opts.evaluate_source_vertices || sc->opts.evaluate_skin_weights) {
+		ufbx_subdivision_result *mesh_sub = mesh->subdivision_result;
+
+		ufbx_skin_deformer *skin = NULL;
+		if (sc->opts.evaluate_skin_weights) {
+			if (mesh->skin_deformers.count > 0) {
+				ufbxi_check_err(&sc->error, sc->opts.skin_deformer_index < mesh->skin_deformers.count);
+				skin = mesh->skin_deformers.data[sc->opts.skin_deformer_index];
+			}
+		}
+
+		size_t max_weights = 0;
+		if (sc->opts.evaluate_source_vertices) {
+			max_weights = ufbxi_max_sz(max_weights, mesh->num_vertices);
+		}
+		if (skin) {
+			max_weights = ufbxi_max_sz(max_weights, skin->clusters.count);
+		}
+
+		sc->tmp_vertex_weights = ufbxi_push_zero(&sc->tmp, ufbx_real, mesh->num_vertices);
+		sc->tmp_weights = ufbxi_push(&sc->tmp, ufbx_subdivision_weight, max_weights);
+		ufbxi_check_err(&sc->error, sc->tmp_vertex_weights && sc->tmp_weights);
+
+		if (sc->opts.evaluate_source_vertices) {
+			sc->max_vertex_weights = sc->opts.max_source_vertices ? sc->opts.max_source_vertices : SIZE_MAX;
+
+			ufbxi_subdivision_vertex_weights *weights;
+			if (mesh_sub && mesh_sub->source_vertex_ranges.count > 0) {
+				weights = ufbxi_subdivision_copy_weights(sc, mesh_sub->source_vertex_ranges, mesh_sub->source_vertex_weights);
+			} else {
+				weights = ufbxi_init_source_vertex_weights(sc, mesh->num_vertices);
+			}
+
+			ufbxi_check_err(&sc->error, ufbxi_subdivide_weights(sc, &result_sub->source_vertex_ranges, &result_sub->source_vertex_weights, weights));
+		}
+
+		if (skin) {
+			sc->max_vertex_weights = sc->opts.max_skin_weights ? sc->opts.max_skin_weights : SIZE_MAX;
+
+			ufbxi_subdivision_vertex_weights *weights;
+			if (mesh_sub && mesh_sub->source_vertex_ranges.count > 0) {
+				weights = ufbxi_subdivision_copy_weights(sc, mesh_sub->skin_cluster_ranges, mesh_sub->skin_cluster_weights);
+			} else {
+				weights = ufbxi_init_skin_weights(sc, mesh->num_vertices, skin);
+			}
+
+			ufbxi_check_err(&sc->error, ufbxi_subdivide_weights(sc, &result_sub->skin_cluster_ranges, &result_sub->skin_cluster_weights, weights));
+		}
+
+	}
+
+	result->num_vertices = result->vertex_position.values.count;
+	result->num_indices = mesh->num_indices * 4;
+	result->num_faces = mesh->num_indices;
+	result->num_triangles = mesh->num_indices * 2;
+
+	result->vertex_indices.data = result->vertex_position.indices.data;
+	result->vertex_indices.count = result->num_indices;
+	result->vertices.data = result->vertex_position.values.data;
+	result->vertices.count = result->num_vertices;
+
+	result->faces.count = result->num_faces;
+	result->faces.data = ufbxi_push(&sc->result, ufbx_face, result->num_faces);
+	ufbxi_check_err(&sc->error, result->faces.data);
+
+	for (size_t i = 0; i < result->num_faces; i++) {
+		result->faces.data[i].index_begin = (uint32_t)(i * 4);
+		result->faces.data[i].num_indices = 4;
+	}
+
+	if (mesh->edges.data) {
+		result->num_edges = mesh->num_edges*2 + result->num_faces;
+		result->edges.count = result->num_edges;
+		result->edges.data = ufbxi_push(&sc->result, ufbx_edge, result->num_edges);
+		ufbxi_check_err(&sc->error, result->edges.data);
+
+		if (mesh->edge_crease.data) {
+			result->edge_crease.count = result->num_edges;
+			result->edge_crease.data = ufbxi_push(&sc->result, ufbx_real, result->num_edges);
+			ufbxi_check_err(&sc->error, result->edge_crease.data);
+		}
+		if (mesh->edge_smoothing.data) {
+			result->edge_smoothing.count = result->num_edges;
+			result->edge_smoothing.data = ufbxi_push(&sc->result, bool, result->num_edges);
+			ufbxi_check_err(&sc->error, result->edge_smoothing.data);
+		}
+		if (mesh->edge_visibility.data) {
+			result->edge_visibility.count = result->num_edges;
+			result->edge_visibility.data = ufbxi_push(&sc->result, bool, result->num_edges);
+			ufbxi_check_err(&sc->error, result->edge_visibility.data);
+		}
+
+		size_t di = 0;
+		for (size_t i = 0; i < mesh->num_edges; i++) {
+			ufbx_edge edge = mesh->edges.data[i];
+			uint32_t face_ix = topo[edge.a].face;
+			ufbx_face face = mesh->faces.data[face_ix];
+			uint32_t offset = edge.a - face.index_begin;
+			uint32_t next = (offset + 1) % (uint32_t)face.num_indices;
+
+			uint32_t a = (face.index_begin + offset) * 4;
+			uint32_t b = (face.index_begin + next) * 4;
+
+			result->edges.data[di + 0].a = a;
+			result->edges.data[di + 0].b = a + 1;
+			result->edges.data[di + 1].a = b + 3;
+			result->edges.data[di + 1].b = b;
+
+			if (mesh->edge_crease.data) {
+				ufbx_real crease = mesh->edge_crease.data[i];
+				if (crease < 0.999f) crease -= (ufbx_real)0.1;
+				if (crease < 0.0f) crease = 0.0f;
+				result->edge_crease.data[di + 0] = crease;
+				result->edge_crease.data[di + 1] = crease;
+			}
+
+			if (mesh->edge_smoothing.data) {
+				result->edge_smoothing.data[di + 0] = mesh->edge_smoothing.data[i];
+				result->edge_smoothing.data[di + 1] = mesh->edge_smoothing.data[i];
+			}
+
+			if (mesh->edge_visibility.data) {
+				result->edge_visibility.data[di + 0] = mesh->edge_visibility.data[i];
+				result->edge_visibility.data[di + 1] = mesh->edge_visibility.data[i];
+			}
+
+			di += 2;
+		}
+
+		for (size_t fi = 0; fi < result->num_faces; fi++) {
+			result->edges.data[di].a = (uint32_t)(fi * 4 + 1);
+			result->edges.data[di].b = (uint32_t)(fi * 4 + 2);
+
+			if (result->edge_crease.data) {
+				result->edge_crease.data[di] = 0.0f;
+			}
+
+			if (result->edge_smoothing.data) {
+				result->edge_smoothing.data[di + 0] = true;
+			}
+
+			if (result->edge_visibility.data) {
+				result->edge_visibility.data[di + 0] = false;
+			}
+
+			di++;
+		}
+	}
+
+	if (mesh->face_material.data) {
+		result->face_material.count = result->num_faces;
+		result->face_material.data = ufbxi_push(&sc->result, uint32_t, result->num_faces);
+		ufbxi_check_err(&sc->error, result->face_material.data);
+	}
+	if (mesh->face_smoothing.data) {
+		result->face_smoothing.count = result->num_faces;
+		result->face_smoothing.data = ufbxi_push(&sc->result, bool, result->num_faces);
+		ufbxi_check_err(&sc->error, result->face_smoothing.data);
+	}
+	if (mesh->face_group.data) {
+		result->face_group.count = result->num_faces;
+		result->face_group.data = ufbxi_push(&sc->result, uint32_t, result->num_faces);
+		ufbxi_check_err(&sc->error, result->face_group.data);
+	}
+	if (mesh->face_hole.data) {
+		result->face_hole.count = result->num_faces;
+		result->face_hole.data = ufbxi_push(&sc->result, bool, result->num_faces);
+		ufbxi_check_err(&sc->error, result->face_hole.data);
+	}
+
+	if (result->material_parts.count > 0) {
+		result->material_parts.data = ufbxi_push_zero(&sc->result, ufbx_mesh_part, result->material_parts.count);
+		ufbxi_check_err(&sc->error, result->materials.data);
+	}
+
+	size_t index_offset = 0;
+	for (size_t i = 0; i < mesh->num_faces; i++) {
+		ufbx_face face = mesh->faces.data[i];
+
+		uint32_t mat = 0;
+		if (mesh->face_material.data) {
+			mat = mesh->face_material.data[i];
+			for (size_t ci = 0; ci < face.num_indices; ci++) {
+				result->face_material.data[index_offset + ci] = mat;
+			}
+		}
+		if (mesh->face_smoothing.data) {
+			bool flag = mesh->face_smoothing.data[i];
+			for (size_t ci = 0; ci < face.num_indices; ci++) {
+				result->face_smoothing.data[index_offset + ci] = flag;
+			}
+		}
+		if (mesh->face_group.data) {
+			uint32_t group = mesh->face_group.data[i];
+			for (size_t ci = 0; ci < face.num_indices; ci++) {
+				result->face_group.data[index_offset + ci] = group;
+			}
+		}
+		if (mesh->face_hole.data) {
+			bool flag = mesh->face_hole.data[i];
+			for (size_t ci = 0; ci < face.num_indices; ci++) {
+				result->face_hole.data[index_offset + ci] = flag;
+			}
+		}
+		index_offset += face.num_indices;
+	}
+
+	// Will be filled in by `ufbxi_finalize_mesh()`.
+	result->vertex_first_index.count = 0;
+
+	// Faces have changed so the stored triangulation and topology are not valid
+	result->triangle_indices.data = NULL;
+	result->triangle_indices.count = 0;
+	result->topology.data = NULL;
+	result->topology.count = 0;
+
+	ufbxi_check_err(&sc->error, ufbxi_finalize_mesh_material(&sc->result, &sc->error, result));
+	ufbxi_check_err(&sc->error, ufbxi_finalize_mesh(&sc->result, &sc->error, result));
+	ufbxi_check_err(&sc->error, ufbxi_update_face_groups(&sc->result, &sc->error, result, true));
+
+	return 1;
+}
+
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_subdivide_mesh_imp(ufbxi_subdivide_context *sc, size_t level)
+{
+	// `ufbx_subdivide_opts` must be cleared to zero first!
+	ufbx_assert(sc->opts._begin_zero == 0 && sc->opts._end_zero == 0);
+	ufbxi_check_err_msg(&sc->error, sc->opts._begin_zero == 0 && sc->opts._end_zero == 0, "Uninitialized options");
+
+	if (sc->opts.boundary == UFBX_SUBDIVISION_BOUNDARY_DEFAULT) {
+		sc->opts.boundary = sc->src_mesh.subdivision_boundary;
+	}
+
+	if (sc->opts.uv_boundary == UFBX_SUBDIVISION_BOUNDARY_DEFAULT) {
+		sc->opts.uv_boundary = sc->src_mesh.subdivision_uv_boundary;
+	}
+
+	ufbxi_init_ator(&sc->error, &sc->ator_tmp, &sc->opts.temp_allocator, "temp");
+	ufbxi_init_ator(&sc->error, &sc->ator_result, &sc->opts.result_allocator, "result");
+
+	sc->result.unordered = true;
+	sc->source.unordered = true;
+	sc->tmp.unordered = true;
+
+	sc->source.ator = &sc->ator_tmp;
+	sc->tmp.ator = &sc->ator_tmp;
+
+	for (size_t i = 1; i < level; i++) {
+		sc->result.ator = &sc->ator_tmp;
+
+		ufbxi_trace_begin(&sc->tracer, "subdivide_level");
+		ufbxi_check_err(&sc->error, ufbxi_subdivide_mesh_level(sc));
+		ufbxi_trace_end(&sc->tracer);
+
+		sc->src_mesh = sc->dst_mesh;
+
+		ufbxi_buf_free(&sc->source);
+		ufbxi_buf_free(&sc->tmp);
+		sc->source = sc->result;
+		memset(&sc->result, 0, sizeof(sc->result));
+	}
+
+	sc->result.ator = &sc->ator_result;
+	ufbxi_trace_begin(&sc->tracer, "subdivide_level");
+	ufbxi_check_err(&sc->error, ufbxi_subdivide_mesh_level(sc));
+	ufbxi_trace_end(&sc->tracer);
+	ufbxi_buf_free(&sc->tmp);
+
+	ufbx_mesh *mesh = &sc->dst_mesh;
+	memset(&mesh->vertex_normal, 0, sizeof(mesh->vertex_normal));
+	memset(&mesh->skinned_normal, 0, sizeof(mesh->skinned_normal));
+
+	// Subdivision always results in a mesh that consists only of quads
+	mesh->max_face_triangles = 2;
+	mesh->num_empty_faces = 0;
+	mesh->num_point_faces = 0;
+	mesh->num_line_faces = 0;
+
+	if (!sc->opts.interpolate_normals && !sc->opts.ignore_normals) {
+		ufbxi_trace_begin(&sc->tracer, "subdivide_normals");
+
+		// Keep the topology in the result if the source mesh had it stored
+		bool keep_topology = sc->src_mesh_ptr->topology.count > 0;
+		ufbx_topo_edge *topo = ufbxi_push(keep_topology ? &sc->result : &sc->tmp, ufbx_topo_edge, mesh->num_indices);
+		ufbxi_check_err(&sc->error, topo);
+		ufbxi_check_err(&sc->error, ufbxi_compute_topology_imp(mesh, topo, &sc->tmp, NULL, &sc->error));
+		if (keep_topology) {
+			mesh->topology.data = topo;
+			mesh->topology.count = mesh->num_indices;
+		}
+
+		uint32_t *normal_indices = ufbxi_push(&sc->result, uint32_t, mesh->num_indices);
+		ufbxi_check_err(&sc->error, normal_indices);
+
+		size_t num_normals = ufbx_generate_normal_mapping(mesh, topo, mesh->num_indices, normal_indices, mesh->num_indices, true);
+		if (num_normals == mesh->num_vertices) {
+			mesh->skinned_normal.unique_per_vertex = true;
+		}
+
+		ufbx_vec3 *normal_data = ufbxi_push(&sc->result, ufbx_vec3, num_normals + 1);
+		ufbxi_check_err(&sc->error, normal_data);
+		normal_data[0] = ufbx_zero_vec3;
+		normal_data++;
+
+		ufbx_compute_normals(mesh, &mesh->skinned_position, normal_indices, mesh->num_indices, normal_data, num_normals);
+
+		mesh->generated_normals = true;
+		mesh->vertex_normal.exists = true;
+		mesh->vertex_normal.values.data = normal_data;
+		mesh->vertex_normal.values.count = num_normals;
+		mesh->vertex_normal.indices.data = normal_indices;
+		mesh->vertex_normal.indices.count = mesh->num_indices;
+
+		mesh->skinned_normal = mesh->vertex_normal;
+
+		ufbxi_trace_end(&sc->tracer);
+	}
+
+	ufbxi_refcount *parent = NULL;
+	if (sc->src_mesh_ptr->subdivision_evaluated && sc->src_mesh_ptr->from_tessellated_nurbs) {
+		parent = &(ufbxi_get_imp(ufbxi_mesh_imp, sc->src_mesh_ptr))->refcount;
+	} else {
+		parent = &(ufbxi_get_imp(ufbxi_scene_imp, sc->src_mesh_ptr->element.scene))->refcount;
+	}
+
+	ufbxi_patch_mesh_reals(mesh);
+
+	sc->imp = ufbxi_push(&sc->result, ufbxi_mesh_imp, 1);
+	ufbxi_check_err(&sc->error, sc->imp);
+
+	sc->dst_mesh.subdivision_result->result_memory_used = sc->ator_result.current_size;
+	sc->dst_mesh.subdivision_result->temp_memory_used = sc->ator_tmp.current_size;
+	sc->dst_mesh.subdivision_result->result_allocs = sc->ator_result.num_allocs;
+	sc->dst_mesh.subdivision_result->temp_allocs = sc->ator_tmp.num_allocs;
+
+	ufbxi_init_ref(&sc->imp->refcount, UFBXI_MESH_IMP_MAGIC, parent);
+
+	sc->imp->magic = UFBXI_MESH_IMP_MAGIC;
+	sc->imp->mesh = sc->dst_mesh;
+	sc->imp->refcount.ator = sc->ator_result;
+	sc->imp->refcount.buf = sc->result;
+	sc->imp->mesh.subdivision_evaluated = true;
+
+	return 1;
+}
+
+ufbxi_noinline static ufbx_mesh *ufbxi_subdivide_mesh(const ufbx_mesh *mesh, size_t level, const ufbx_subdivide_opts *user_opts, ufbx_error *p_error)
+{
+	ufbxi_subdivide_context sc = { 0 };
+	if (user_opts) {
+		sc.opts = *user_opts;
+	}
+
+	sc.src_mesh_ptr = (ufbx_mesh*)mesh;
+	sc.src_mesh = *mesh;
+
+	ufbxi_trace_init(&sc.tracer, &sc.opts.trace_cb);
+	ufbxi_trace_begin(&sc.tracer, "ufbx_subdivide_mesh");
+	int ok = ufbxi_subdivide_mesh_imp(&sc, level);
+	ufbxi_trace_unwind(&sc.tracer);
+
+	ufbxi_free(&sc.ator_tmp, ufbxi_subdivide_input, sc.inputs, sc.inputs_cap);
+	ufbxi_buf_free(&sc.tmp);
+	ufbxi_buf_free(&sc.source);
+
+	if (ok) {
+		ufbxi_free_ator(&sc.ator_tmp);
+		if (p_error) {
+			ufbxi_clear_error(p_error);
+		}
+
+		ufbxi_mesh_imp *imp = sc.imp;
+		return &imp->mesh;
+	} else {
+		ufbxi_fix_error_type(&sc.error, "Failed to subdivide");
+		if (p_error) *p_error = sc.error;
+		ufbxi_buf_free(&sc.result);
+		ufbxi_free_ator(&sc.ator_tmp);
+		ufbxi_free_ator(&sc.ator_result);
+		return NULL;
+	}
+}
+
+#else
+
+ufbxi_noinline static ufbx_mesh *ufbxi_subdivide_mesh(const ufbx_mesh *mesh, size_t level, const ufbx_subdivide_opts *user_opts, ufbx_error *p_error)
+{
+	if (p_error) {
+		memset(p_error, 0, sizeof(ufbx_error));
+		ufbxi_fmt_err_info(p_error, "UFBX_ENABLE_SUBDIVISION");
+		ufbxi_report_err_msg(p_error, "UFBXI_FEATURE_SUBDIVISION", "Feature disabled");
+	}
+	return NULL;
+}
+
+#endif
+
+// -- Utility
+
+#if UFBXI_FEATURE_INDEX_GENERATION
+
+static int ufbxi_map_cmp_vertex(void *user, const void *va, const void *vb)
+{
+	size_t size = *(size_t*)user;
+#if defined(UFBX_REGRESSION)
+	ufbx_assert(size % 8 == 0);
+#endif
+	for (size_t i = 0; i < size; i += 8) {
+		uint64_t a = *(const uint64_t*)((const char*)va + i);
+		uint64_t b = *(const uint64_t*)((const char*)vb + i);
+		if (a != b) return a < b ? -1 : +1;
+	}
+	return 0;
+}
+
+typedef struct {
+	char *begin, *ptr;
+	size_t vertex_size;
+	size_t packed_offset;
+} ufbxi_vertex_stream;
+
+static ufbxi_noinline size_t ufbxi_generate_indices(const ufbx_vertex_stream *user_streams, size_t num_streams, uint32_t *indices, size_t num_indices, const ufbx_allocator_opts *allocator, ufbx_error *error)
+{
+	bool fail = false;
+
+	ufbxi_allocator ator = { 0 };
+	ufbxi_init_ator(error, &ator, allocator, "allocator");
+
+	ufbxi_vertex_stream local_streams[16];
+	uint64_t local_packed_vertex[64];
+
+	ufbxi_vertex_stream *streams = NULL;
+	if (num_streams > ufbxi_arraycount(local_streams)) {
+		streams = ufbxi_alloc(&ator, ufbxi_vertex_stream, num_streams);
+		if (!streams) fail = true;
+	} else {
+		streams = local_streams;
+	}
+
+	size_t packed_size = 0;
+	if (!fail) {
+		for (size_t i = 0; i < num_streams; i++) {
+			if (user_streams[i].vertex_count < num_indices) {
+				ufbxi_fmt_err_info(error, "%zu", i);
+				ufbxi_report_err_msg(error, "user_streams[i].vertex_count < num_indices", "Truncated vertex stream");
+				fail = true;
+				break;
+			}
+
+			size_t vertex_size = user_streams[i].vertex_size;
+			size_t align = ufbxi_size_align_mask(vertex_size);
+			packed_size = ufbxi_align_to_mask(packed_size, align);
+			streams[i].ptr = streams[i].begin = (char*)user_streams[i].data;
+			streams[i].vertex_size = vertex_size;
+			streams[i].packed_offset = packed_size;
+			packed_size += vertex_size;
+		}
+		packed_size = ufbxi_align_to_mask(packed_size, 7);
+	}
+
+	if (!fail && packed_size == 0) {
+		ufbxi_report_err_msg(error, "packed_size != 0", "Zero vertex size");
+		fail = true;
+	}
+
+	char *packed_vertex = NULL;
+	if (!fail) {
+		if (packed_size > sizeof(local_packed_vertex)) {
+			ufbx_assert(packed_size % 8 == 0);
+			packed_vertex = (char*)ufbxi_alloc(&ator, uint64_t, packed_size / 8);
+			if (!packed_vertex) fail = true;
+		} else {
+			packed_vertex = (char*)local_packed_vertex;
+		}
+	}
+
+	ufbxi_map map = { 0 };
+	ufbxi_map_init(&map, &ator, &ufbxi_map_cmp_vertex, &packed_size);
+
+	if (num_indices > 0 && !ufbxi_map_grow_size(&map, packed_size, num_indices)) {
+		fail = true;
+	}
+
+	if (!fail) {
+		ufbx_assert(packed_vertex != NULL);
+		memset(packed_vertex, 0, packed_size);
+
+		for (size_t i = 0; i < num_indices; i++) {
+			for (size_t si = 0; si < num_streams; si++) {
+				size_t size = streams[si].vertex_size, offset = streams[si].packed_offset;
+				char *ptr = streams[si].ptr;
+				memcpy(packed_vertex + offset, ptr, size);
+				streams[si].ptr = ptr + size;
+			}
+
+			uint32_t hash = ufbxi_hash_string(packed_vertex, packed_size);
+			void *entry = ufbxi_map_find_size(&map, packed_size, hash, packed_vertex);
+			if (!entry) {
+				entry = ufbxi_map_insert_size(&map, packed_size, hash, packed_vertex);
+				if (!entry) {
+					fail = true;
+					break;
+				}
+				memcpy(entry, packed_vertex, packed_size);
+			}
+			uint32_t index = (uint32_t)(ufbxi_to_size((char*)entry - (char*)map.items) / packed_size);
+			indices[i] = index;
+		}
+	}
+
+	size_t result_vertices = 0;
+	if (!fail) {
+		result_vertices = map.size;
+
+		for (size_t si = 0; si < num_streams; si++) {
+			size_t vertex_size = streams[si].vertex_size;
+			char *dst = streams[si].begin;
+			char *src = ufbxi_add_ptr((char*)map.items, streams[si].packed_offset);
+			for (size_t i = 0; i < result_vertices; i++) {
+				memcpy(dst, src, vertex_size);
+				dst += vertex_size;
+				src += packed_size;
+			}
+		}
+
+		ufbxi_clear_error(error);
+	} else {
+		ufbxi_fix_error_type(error, "Failed to generate indices");
+	}
+
+	if (streams && streams != local_streams) {
+		ufbxi_free(&ator, ufbxi_vertex_stream, streams, num_streams);
+	}
+	if (packed_vertex && packed_vertex != (char*)local_packed_vertex) {
+		ufbxi_free(&ator, uint64_t, packed_vertex, packed_size / 8);
+	}
+
+	ufbxi_map_free(&map);
+	ufbxi_free_ator(&ator);
+
+	return result_vertices;
+}
+
+#else
+
+static ufbxi_noinline size_t ufbxi_generate_indices(const ufbx_vertex_stream *user_streams, size_t num_streams, uint32_t *indices, size_t num_indices, const ufbx_allocator_opts *allocator, ufbx_error *error)
+{
+	if (error) {
+		memset(error, 0, sizeof(ufbx_error));
+		ufbxi_fmt_err_info(error, "UFBX_ENABLE_INDEX_GENERATION");
+		ufbxi_report_err_msg(error, "UFBXI_FEATURE_INDEX_GENERATION", "Feature disabled");
+	}
+	return 0;
+}
+
+#endif
+
+#if UFBXI_FEATURE_INDEX_GENERATION
+
+typedef struct {
+	uint32_t begin, end; // < Range of `ufbxi_optimize_part.order[]`
+	ufbx_real sort_key;
+} ufbxi_optimize_cluster;
+
+typedef struct {
+	uint32_t *indices;
+	const uint32_t *local_indices;
+	const char *positions;
+	size_t position_stride;
+	uint32_t cache_size;
+	ufbx_real overdraw_threshold;
+} ufbxi_optimize_context;
+
+// Parts use disjoint slices of shared scratch buffers so they can be optimized in parallel.
+// Vertices are renumbered per part so the per-vertex buffers are bounded by the part size.
+typedef struct {
+	const ufbxi_optimize_context *oc;
+	uint32_t index_begin;
+	uint32_t num_triangles;
+	uint32_t num_vertices;
+
+	const uint32_t *vertices;         // < [num_vertices] local to global vertex index
+	uint32_t *adjacency_begin;        // < [num_vertices + 1]
+	uint32_t *adjacency;              // < [num_triangles * 3]
+	uint32_t *live_triangles;         // < [num_vertices]
+	uint32_t *cache_time;             // < [num_vertices]
+	uint32_t *vertex_stack;           // < [num_triangles * 3]
+	uint32_t *candidates;             // < [num_triangles * 3]
+	uint32_t *order;                  // < [num_triangles]
+	bool *emitted;                    // < [num_triangles]
+	ufbxi_optimize_cluster *clusters; // < [num_triangles * 2] if optimizing overdraw
+} ufbxi_optimize_part;
+
+typedef struct {
+	ufbx_error *error;
+	ufbxi_allocator ator;
+	ufbxi_buf tmp;
+	ufbxi_thread_pool pool;
+	ufbx_optimize_indices_opts opts;
+} ufbxi_optimize_state;
+
+// Simulate a FIFO cache of `cache_size` vertices, returns the number of misses.
+static ufbxi_forceinline uint32_t ufbxi_optimize_cache_triangle(uint32_t *cache_time, uint32_t *p_time, uint32_t cache_size, const uint32_t *tri)
+{
+	uint32_t misses = 0, time = *p_time;
+	for (size_t i = 0; i < 3; i++) {
+		uint32_t v = tri[i];
+		if (time - cache_time[v] > cache_size) {
+			cache_time[v] = time++;
+			misses++;
+		}
+	}
+	*p_time = time;
+	return misses;
+}
+
+static ufbxi_forceinline ufbx_vec3 ufbxi_optimize_position(const ufbxi_optimize_part *part, uint32_t local_vertex)
+{
+	const ufbxi_optimize_context *oc = part->oc;
+	ufbx_vec3 v;
+	memcpy(&v, oc->positions + part->vertices[local_vertex] * oc->position_stride, sizeof(ufbx_vec3));
+	return v;
+}
+
+// Twice the area weighted normal of a triangle.
+static ufbxi_forceinline ufbx_vec3 ufbxi_optimize_triangle_normal(ufbx_vec3 a, ufbx_vec3 b, ufbx_vec3 c)
+{
+	return ufbxi_cross3(ufbxi_sub3(b, a), ufbxi_sub3(c, a));
+}
+
+// Split the hard clusters found by Tipsify into smaller ones at points where the cache
+// efficiency is close to the whole cluster and sort them so that clusters facing away
+// from the center of the part are drawn first, "Fast Triangle Reordering for Vertex
+// Locality and Reduced Overdraw" (Sander et al. 2007). Returns the number of clusters.
+static ufbxi_noinline uint32_t ufbxi_optimize_overdraw(ufbxi_optimize_part *part, uint32_t num_hard_clusters, uint32_t time)
+{
+	const ufbxi_optimize_context *oc = part->oc;
+	const uint32_t *tri_indices = oc->local_indices + part->index_begin;
+	const uint32_t *order = part->order;
+	uint32_t num_triangles = part->num_triangles;
+	uint32_t cache_size = oc->cache_size;
+	uint32_t *cache_time = part->cache_time;
+
+	ufbxi_optimize_cluster *hard = part->clusters;
+	ufbxi_optimize_cluster *clusters = part->clusters + num_triangles;
+	uint32_t num_clusters = 0;
+
+	for (uint32_t hard_ix = 0; hard_ix < num_hard_clusters; hard_ix++) {
+		uint32_t begin = hard[hard_ix].begin;
+		uint32_t end = hard_ix + 1 < num_hard_clusters ? hard[hard_ix + 1].begin : num_triangles;
+
+		time += cache_size + 1;
+		uint32_t misses = 0;
+		for (uint32_t i = begin; i < end; i++) {
+			misses += ufbxi_optimize_cache_triangle(cache_time, &time, cache_size, tri_indices + order[i] * 3);
+		}
+		ufbx_real threshold = oc->overdraw_threshold * (ufbx_real)misses / (ufbx_real)(end - begin);
+
+		time += cache_size + 1;
+		uint32_t split_begin = begin, split_misses = 0;
+		for (uint32_t i = begin; i < end; i++) {
+			split_misses += ufbxi_optimize_cache_triangle(cache_time, &time, cache_size, tri_indices + order[i] * 3);
+			if (i + 1 < end && (ufbx_real)split_misses <= threshold * (ufbx_real)(i + 1 - split_begin)) {
+				clusters[num_clusters].begin = split_begin;
+				clusters[num_clusters].end = i + 1;
+				num_clusters++;
+				split_begin = i + 1;
+				split_misses = 0;
+				time += cache_size + 1;
+			}
+		}
+		clusters[num_clusters].begin = split_begin;
+		clusters[num_clusters].end = end;
+		num_clusters++;
+	}
+
+	// Area weighted centroid of the whole part
+	ufbx_vec3 part_center = ufbx_zero_vec3;
+	ufbx_real part_area = 0.0f;
+	for (uint32_t i = 0; i < num_triangles; i++) {
+		const uint32_t *tri = tri_indices + i * 3;
+		ufbx_vec3 a = ufbxi_optimize_position(part, tri[0]);
+		ufbx_vec3 b = ufbxi_optimize_position(part, tri[1]);
+		ufbx_vec3 c = ufbxi_optimize_position(part, tri[2]);
+		ufbx_real area = ufbxi_length3(ufbxi_optimize_triangle_normal(a, b, c));
+		part_center = ufbxi_add3(part_center, ufbxi_mul3(ufbxi_add3(ufbxi_add3(a, b), c), area));
+		part_area += area;
+	}
+	if (part_area > 0.0f) {
+		part_center = ufbxi_mul3(part_center, (ufbx_real)1.0 / part_area);
+	}
+
+	for (uint32_t cluster_ix = 0; cluster_ix < num_clusters; cluster_ix++) {
+		ufbxi_optimize_cluster *cluster = &clusters[cluster_ix];
+		ufbx_vec3 center = ufbx_zero_vec3, normal = ufbx_zero_vec3;
+		ufbx_real area = 0.0f;
+		for (uint32_t i = cluster->begin; i < cluster->end; i++) {
+			const uint32_t *tri = tri_indices + order[i] * 3;
+			ufbx_vec3 a = ufbxi_optimize_position(part, tri[0]);
+			ufbx_vec3 b = ufbxi_optimize_position(part, tri[1]);
+			ufbx_vec3 c = ufbxi_optimize_position(part, tri[2]);
+			ufbx_vec3 tri_normal = ufbxi_optimize_triangle_normal(a, b, c);
+			ufbx_real tri_area = ufbxi_length3(tri_normal);
+			center = ufbxi_add3(center, ufbxi_mul3(ufbxi_add3(ufbxi_add3(a, b), c), tri_area));
+			normal = ufbxi_add3(normal, tri_normal);
+			area += tri_area;
+		}
+
+		ufbx_real normal_len = ufbxi_length3(normal);
+		if (area > 0.0f && normal_len > 0.0f) {
+			ufbx_vec3 delta = ufbxi_sub3(ufbxi_mul3(center, (ufbx_real)1.0 / area), part_center);
+			cluster->sort_key = ufbxi_dot3(delta, normal) / normal_len;
+		} else {
+			cluster->sort_key = 0.0f;
+		}
+	}
+
+	// Centroids are scaled by 3 but only the order of the keys matters
+	ufbxi_macro_stable_sort(ufbxi_optimize_cluster, 32, clusters, part->clusters, num_clusters,
+		( a->sort_key > b->sort_key ));
+
+	return num_clusters;
+}
+
+// Order the triangles of a part for the post-transform vertex cache using Tipsify,
+// "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw" (Sander et al. 2007).
+static ufbxi_noinline void ufbxi_optimize_part_imp(ufbxi_optimize_part *part)
+{
+	const ufbxi_optimize_context *oc = part->oc;
+	const uint32_t *tri_indices = oc->local_indices + part->index_begin;
+	uint32_t num_triangles = part->num_triangles, num_vertices = part->num_vertices;
+	uint32_t cache_size = oc->cache_size;
+
+	uint32_t *adjacency_begin = part->adjacency_begin, *adjacency = part->adjacency;
+	uint32_t *live = part->live_triangles, *cache_time = part->cache_time;
+	uint32_t *stack = part->vertex_stack, *candidates = part->candidates;
+	uint32_t *order = part->order;
+	bool *emitted = part->emitted;
+	ufbxi_optimize_cluster *clusters = part->clusters;
+
+	// Vertex to triangle adjacency, `cache_time[]` is used as a write cursor
+	memset(live, 0, num_vertices * sizeof(uint32_t));
+	for (uint32_t i = 0; i < num_triangles * 3; i++) {
+		live[tri_indices[i]]++;
+	}
+	uint32_t offset = 0;
+	for (uint32_t i = 0; i < num_vertices; i++) {
+		adjacency_begin[i] = offset;
+		cache_time[i] = offset;
+		offset += live[i];
+	}
+	adjacency_begin[num_vertices] = offset;
+	for (uint32_t i = 0; i < num_triangles * 3; i++) {
+		adjacency[cache_time[tri_indices[i]]++] = i / 3;
+	}
+
+	memset(cache_time, 0, num_vertices * sizeof(uint32_t));
+	memset(emitted, 0, num_triangles * sizeof(bool));
+
+	uint32_t time = cache_size + 1;
+	uint32_t num_ordered = 0, num_stack = 0, next_vertex = 0;
+	uint32_t num_clusters = 0;
+	if (clusters) {
+		clusters[num_clusters++].begin = 0;
+	}
+
+	uint32_t fan = 0;
+	while (fan != UINT32_MAX) {
+		// Emit all remaining triangles around the fanning vertex
+		uint32_t num_candidates = 0;
+		for (uint32_t i = adjacency_begin[fan]; i < adjacency_begin[fan + 1]; i++) {
+			uint32_t tri = adjacency[i];
+			if (emitted[tri]) continue;
+			emitted[tri] = true;
+			order[num_ordered++] = tri;
+			for (uint32_t corner = 0; corner < 3; corner++) {
+				uint32_t v = tri_indices[tri * 3 + corner];
+				stack[num_stack++] = v;
+				candidates[num_candidates++] = v;
+				live[v]--;
+				if (time - cache_time[v] > cache_size) {
+					cache_time[v] = time++;
+				}
+			}
+		}
+
+		// Prefer the oldest candidate that stays in the cache while its triangles are emitted
+		fan = UINT32_MAX;
+		uint32_t best_priority = 0;
+		for (uint32_t i = 0; i < num_candidates; i++) {
+			uint32_t v = candidates[i];
+			if (live[v] == 0) continue;
+			uint32_t age = time - cache_time[v];
+			uint32_t priority = age + 2 * live[v] <= cache_size ? age : 0;
+			if (fan == UINT32_MAX || priority > best_priority) {
+				fan = v;
+				best_priority = priority;
+			}
+		}
+
+		if (fan == UINT32_MAX) {
+			// Dead end, continue from a recently used vertex or any vertex with triangles left
+			while (num_stack > 0 && fan == UINT32_MAX) {
+				uint32_t v = stack[--num_stack];
+				if (live[v] > 0) fan = v;
+			}
+			while (next_vertex < num_vertices && fan == UINT32_MAX) {
+				if (live[next_vertex] > 0) {
+					fan = next_vertex;
+				} else {
+					next_vertex++;
+				}
+			}
+			if (fan != UINT32_MAX && clusters) {
+				clusters[num_clusters++].begin = num_ordered;
+			}
+		}
+	}
+	ufbx_assert(num_ordered == num_triangles);
+
+	uint32_t *dst = oc->indices + part->index_begin;
+	const uint32_t *vertices = part->vertices;
+	if (clusters) {
+		num_clusters = ufbxi_optimize_overdraw(part, num_clusters, time);
+		clusters += num_triangles;
+		for (uint32_t cluster_ix = 0; cluster_ix < num_clusters; cluster_ix++) {
+			for (uint32_t i = clusters[cluster_ix].begin; i < clusters[cluster_ix].end; i++) {
+				const uint32_t *tri = tri_indices + order[i] * 3;
+				dst[0] = vertices[tri[0]];
+				dst[1] = vertices[tri[1]];
+				dst[2] = vertices[tri[2]];
+				dst += 3;
+			}
+		}
+	} else {
+		for (uint32_t i = 0; i < num_triangles; i++) {
+			const uint32_t *tri = tri_indices + order[i] * 3;
+			dst[0] = vertices[tri[0]];
+			dst[1] = vertices[tri[1]];
+			dst[2] = vertices[tri[2]];
+			dst += 3;
+		}
+	}
+}
+
+static bool ufbxi_optimize_part_task_fn(ufbxi_task *task)
+{
+	ufbxi_optimize_part_imp((ufbxi_optimize_part*)task->data);
+	return true;
+}
+
+// Renumber vertices in the order they are first used and permute `streams` to match.
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_optimize_vertex_fetch(ufbxi_optimize_state *os, const ufbx_vertex_stream *streams, size_t num_streams, uint32_t *indices, size_t num_indices, size_t num_vertices, uint32_t *remap)
+{
+	ufbx_error *error = os->error;
+
+	memset(remap, 0xff, num_vertices * sizeof(uint32_t));
+	uint32_t num_remapped = 0;
+	for (size_t i = 0; i < num_indices; i++) {
+		uint32_t *dst = &remap[indices[i]];
+		if (*dst == UINT32_MAX) *dst = num_remapped++;
+		indices[i] = *dst;
+	}
+
+	// Keep unused vertices at the end
+	for (size_t i = 0; i < num_vertices; i++) {
+		if (remap[i] == UINT32_MAX) remap[i] = num_remapped++;
+	}
+
+	size_t max_vertex_size = 0;
+	for (size_t i = 0; i < num_streams; i++) {
+		max_vertex_size = ufbxi_max_sz(max_vertex_size, streams[i].vertex_size);
+	}
+	if (max_vertex_size == 0) return 1;
+
+	ufbxi_check_err(error, num_vertices <= SIZE_MAX / max_vertex_size);
+	char *vertex_data = ufbxi_push(&os->tmp, char, num_vertices * max_vertex_size);
+	ufbxi_check_err(error, vertex_data);
+
+	for (size_t si = 0; si < num_streams; si++) {
+		size_t vertex_size = streams[si].vertex_size;
+		const char *src = (const char*)streams[si].data;
+		for (size_t i = 0; i < num_vertices; i++) {
+			memcpy(vertex_data + remap[i] * vertex_size, src + i * vertex_size, vertex_size);
+		}
+		if (vertex_size > 0) {
+			memcpy(streams[si].data, vertex_data, num_vertices * vertex_size);
+		}
+	}
+
+	return 1;
+}
+
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_optimize_indices_imp(ufbxi_optimize_state *os, const ufbx_vertex_stream *streams, size_t num_streams, uint32_t *indices, size_t num_indices, size_t num_vertices)
+{
+	ufbx_error *error = os->error;
+	const ufbx_optimize_indices_opts *opts = &os->opts;
+	ufbxi_thread_pool *pool = &os->pool;
+
+	ufbxi_check_err_msg(error, num_indices % 3 == 0, "Index count not divisible by 3");
+	ufbxi_check_err_msg(error, num_indices <= UINT32_MAX / 8 && num_vertices <= UINT32_MAX, "Too many indices");
+	for (size_t i = 0; i < num_streams; i++) {
+		if (streams[i].vertex_count < num_vertices) {
+			ufbxi_fmt_err_info(error, "%zu", i);
+			ufbxi_fail_err_msg(error, "streams[i].vertex_count < num_vertices", "Truncated vertex stream");
+		}
+	}
+
+	size_t cache_size = opts->cache_size ? opts->cache_size : 16;
+	ufbxi_check_err_msg(error, cache_size <= 1024, "Cache size too large");
+
+	ufbxi_optimize_context oc = { 0 };
+	oc.indices = indices;
+	oc.cache_size = (uint32_t)cache_size;
+	oc.overdraw_threshold = opts->overdraw_threshold > 0.0f ? opts->overdraw_threshold : (ufbx_real)1.05;
+	if (opts->optimize_overdraw) {
+		size_t position_stream = opts->position_stream;
+		ufbxi_check_err_msg(error, position_stream < num_streams, "Bad position stream");
+		ufbxi_check_err_msg(error, streams[position_stream].vertex_size >= sizeof(ufbx_vec3), "Bad position stream");
+		oc.positions = (const char*)streams[position_stream].data;
+		oc.position_stride = streams[position_stream].vertex_size;
+	}
+
+	size_t num_parts = opts->part_offsets.count + 1;
+	for (size_t i = 0; i < opts->part_offsets.count; i++) {
+		uint32_t offset = opts->part_offsets.data[i];
+		uint32_t prev = i > 0 ? opts->part_offsets.data[i - 1] : 0;
+		ufbxi_check_err_msg(error, offset >= prev && offset <= num_indices && offset % 3 == 0, "Bad part offset");
+	}
+
+	if (num_indices == 0) return 1;
+	ufbxi_check_err_msg(error, num_vertices > 0, "Index out of bounds");
+
+	uint32_t *local_indices = ufbxi_push(&os->tmp, uint32_t, num_indices);
+	uint32_t *local_vertices = ufbxi_push(&os->tmp, uint32_t, num_indices);
+	uint32_t *vertex_part = ufbxi_push(&os->tmp, uint32_t, num_vertices);
+	uint32_t *vertex_local = ufbxi_push(&os->tmp, uint32_t, num_vertices);
+	ufbxi_optimize_part *parts = ufbxi_push(&os->tmp, ufbxi_optimize_part, num_parts);
+	ufbxi_check_err(error, local_indices && local_vertices && vertex_part && vertex_local && parts);
+	oc.local_indices = local_indices;
+
+	// Renumber the vertices of each part
+	memset(vertex_part, 0xff, num_vertices * sizeof(uint32_t));
+	for (size_t part_ix = 0; part_ix < num_parts; part_ix++) {
+		uint32_t begin = part_ix > 0 ? opts->part_offsets.data[part_ix - 1] : 0;
+		uint32_t end = part_ix < opts->part_offsets.count ? opts->part_offsets.data[part_ix] : (uint32_t)num_indices;
+
+		uint32_t num_part_vertices = 0;
+		for (uint32_t i = begin; i < end; i++) {
+			uint32_t index = indices[i];
+			ufbxi_check_err_msg(error, index < num_vertices, "Index out of bounds");
+			if (vertex_part[index] != (uint32_t)part_ix) {
+				vertex_part[index] = (uint32_t)part_ix;
+				vertex_local[index] = num_part_vertices;
+				local_vertices[begin + num_part_vertices] = index;
+				num_part_vertices++;
+			}
+			local_indices[i] = vertex_local[index];
+		}
+
+		ufbxi_optimize_part *part = &parts[part_ix];
+		memset(part, 0, sizeof(ufbxi_optimize_part));
+		part->oc = &oc;
+		part->index_begin = begin;
+		part->num_triangles = (end - begin) / 3;
+		part->num_vertices = num_part_vertices;
+		part->vertices = local_vertices + begin;
+	}
+
+	size_t num_triangles = num_indices / 3;
+	uint32_t *scratch = ufbxi_push(&os->tmp, uint32_t, num_indices * 6 + num_triangles + num_parts);
+	bool *emitted = ufbxi_push(&os->tmp, bool, num_triangles);
+	ufbxi_check_err(error, scratch && emitted);
+
+	ufbxi_optimize_cluster *clusters = NULL;
+	if (opts->optimize_overdraw) {
+		clusters = ufbxi_push(&os->tmp, ufbxi_optimize_cluster, num_triangles * 2);
+		ufbxi_check_err(error, clusters);
+	}
+
+	uint32_t *adjacency_begin = scratch;
+	uint32_t *per_index = adjacency_begin + num_indices + num_parts;
+	uint32_t *order = per_index + num_indices * 5;
+
+	size_t num_nonempty_parts = 0;
+	for (size_t part_ix = 0; part_ix < num_parts; part_ix++) {
+		ufbxi_optimize_part *part = &parts[part_ix];
+		size_t begin = part->index_begin, tri_begin = begin / 3;
+		part->adjacency_begin = adjacency_begin + begin + part_ix;
+		part->adjacency = per_index + begin;
+		part->live_triangles = per_index + num_indices + begin;
+		part->cache_time = per_index + num_indices * 2 + begin;
+		part->vertex_stack = per_index + num_indices * 3 + begin;
+		part->candidates = per_index + num_indices * 4 + begin;
+		part->order = order + tri_begin;
+		part->emitted = emitted + tri_begin;
+		part->clusters = clusters ? clusters + tri_begin * 2 : NULL;
+		if (part->num_triangles > 0) num_nonempty_parts++;
+	}
+
+	ufbx_trace_cb trace_cb = { 0 };
+	if (num_nonempty_parts > 1) {
+		ufbxi_check_err(error, ufbxi_thread_pool_init(pool, error, &os->ator, &opts->thread_opts, &trace_cb));
+	}
+
+	for (size_t part_ix = 0; part_ix < num_parts; part_ix++) {
+		ufbxi_optimize_part *part = &parts[part_ix];
+		if (part->num_triangles == 0) continue;
+
+		ufbxi_task *task = pool->enabled ? ufbxi_thread_pool_create_task(pool, &ufbxi_optimize_part_task_fn, "optimize_indices") : NULL;
+		if (task) {
+			task->data = part;
+			ufbxi_thread_pool_run_task(pool, task, (double)part->num_triangles);
+		} else {
+			ufbxi_optimize_part_imp(part);
+		}
+	}
+
+	if (pool->enabled) {
+		ufbxi_thread_pool_flush_group(pool);
+		ufbxi_check_err(error, ufbxi_thread_pool_wait_all(pool));
+	}
+
+	if (opts->reorder_vertices) {
+		ufbxi_check_err(error, ufbxi_optimize_vertex_fetch(os, streams, num_streams, indices, num_indices, num_vertices, vertex_local));
+	}
+
+	return 1;
+}
+
+static ufbxi_noinline bool ufbxi_optimize_indices(const ufbx_vertex_stream *streams, size_t num_streams, uint32_t *indices, size_t num_indices, size_t num_vertices, const ufbx_optimize_indices_opts *user_opts, ufbx_error *error)
+{
+	ufbxi_optimize_state os;
+	memset(&os, 0, sizeof(os));
+	os.error = error;
+	if (user_opts) {
+		os.opts = *user_opts;
+	}
+
+	// `ufbx_optimize_indices_opts` must be cleared to zero first!
+	ufbx_assert(os.opts._begin_zero == 0 && os.opts._end_zero == 0);
+	if (os.opts._begin_zero != 0 || os.opts._end_zero != 0) {
+		ufbxi_report_err_msg(error, "opts._begin_zero == 0 && opts._end_zero == 0", "Uninitialized options");
+		ufbxi_fix_error_type(error, "Failed to optimize indices");
+		return false;
+	}
+
+	ufbxi_init_ator(error, &os.ator, &os.opts.temp_allocator, "temp");
+	os.tmp.ator = &os.ator;
+	os.tmp.unordered = true;
+
+	int ok = ufbxi_optimize_indices_imp(&os, streams, num_streams, indices, num_indices, num_vertices);
+
+	// Wait for all tasks before releasing them
+	ufbxi_thread_pool_free(&os.pool);
+	ufbxi_buf_free(&os.tmp);
+	ufbxi_free_ator(&os.ator);
+
+	if (ok) {
+		ufbxi_clear_error(error);
+	} else {
+		ufbxi_fix_error_type(error, "Failed to optimize indices");
+	}
+	return ok != 0;
+}
+
+#else
+
+static ufbxi_noinline bool ufbxi_optimize_indices(const ufbx_vertex_stream *streams, size_t num_streams, uint32_t *indices, size_t num_indices, size_t num_vertices, const ufbx_optimize_indices_opts *user_opts, ufbx_error *error)
+{
+	ufbxi_fmt_err_info(error, "UFBX_ENABLE_INDEX_GENERATION");
+	ufbxi_report_err_msg(error, "UFBXI_FEATURE_INDEX_GENERATION", "Feature disabled");
+	return false;
+}
+
+#endif
+
+typedef struct {
+	ufbxi_refcount refcount;
+	ufbx_mesh_buffers buffers;
+	uint32_t magic;
+} ufbxi_mesh_buffers_imp;
+
+#if UFBXI_FEATURE_TRIANGULATION
+
+typedef struct {
+	const ufbx_real *values;
+	const uint32_t *indices;
+	size_t num_values;
+	uint32_t num_reals;
+	uint32_t num_components;
+	uint32_t offset;
+	ufbx_vertex_format format;
+} ufbxi_mesh_buffer_attrib;
+
+typedef struct {
+	const ufbx_mesh *mesh;
+	const ufbxi_mesh_buffer_attrib *attribs;
+	size_t num_attribs;
+	size_t stride;
+} ufbxi_mesh_buffers_shared;
+
+typedef struct {
+	const ufbxi_mesh_buffers_shared *shared;
+
+	// Faces of the part, identity if NULL
+	const uint32_t *face_indices;
+	size_t num_faces;
+	size_t num_indices;
+
+	// Scratch memory, `vertices` has space for `num_indices` encoded vertices
+	char *vertices;
+	uint32_t *indices;
+	uint32_t *hash_table;
+	uint32_t *tri_indices;
+	uint32_t hash_mask;
+	ufbxi_monotone_scratch scratch;
+
+	size_t num_vertices;
+} ufbxi_mesh_buffers_part;
+
+typedef struct {
+	ufbx_error error;
+	ufbxi_allocator ator_tmp;
+	ufbxi_allocator ator_result;
+
+	ufbxi_buf tmp;
+	ufbxi_buf result;
+
+	ufbxi_thread_pool thread_pool;
+
+	ufbx_mesh_buffers_opts opts;
+	const ufbx_mesh *mesh;
+
+	ufbxi_mesh_buffers_imp *imp;
+} ufbxi_mesh_buffers_context;
+
+static const uint8_t ufbxi_vertex_format_size[] = {
+	4, 2, 2, 1, 2,
+};
+ufbx_static_assert(vertex_format_size, ufbxi_arraycount(ufbxi_vertex_format_size) == UFBX_VERTEX_FORMAT_COUNT);
+
+static const uint8_t ufbxi_vertex_attrib_default_components[] = {
+	3, 3, 3, 3, 2, 4,
+};
+ufbx_static_assert(vertex_attrib_default_components, ufbxi_arraycount(ufbxi_vertex_attrib_default_components) == UFBX_VERTEX_ATTRIB_TYPE_COUNT);
+
+// IEEE 754 binary16 with round to nearest even, overflows to infinity
+static ufbxi_forceinline uint16_t ufbxi_f32_to_f16(float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(uint32_t));
+	uint32_t sign = (bits >> 16) & 0x8000u;
+	uint32_t abs = bits & 0x7fffffffu;
+
+	if (abs >= 0x7f800000u) {
+		return (uint16_t)(sign | 0x7c00u | (abs > 0x7f800000u ? 0x200u : 0u));
+	} else if (abs >= 0x47800000u) {
+		return (uint16_t)(sign | 0x7c00u);
+	} else if (abs >= 0x38800000u) {
+		uint32_t half = (abs - 0x38000000u) >> 13;
+		uint32_t rem = abs & 0x1fffu;
+		if (rem > 0x1000u || (rem == 0x1000u && (half & 1) != 0)) half++;
+		return (uint16_t)(sign | half);
+	} else if (abs > 0x33000000u) {
+		// Subnormal, the carry from rounding up ends up in the exponent correctly
+		uint32_t shift = 126u - (abs >> 23);
+		uint32_t mantissa = (abs & 0x7fffffu) | 0x800000u;
+		uint32_t half = mantissa >> shift;
+		uint32_t rem = mantissa & ((1u << shift) - 1u);
+		uint32_t mid = 1u << (shift - 1u);
+		if (rem > mid || (rem == mid && (half & 1) != 0)) half++;
+		return (uint16_t)(sign | half);
+	} else {
+		return (uint16_t)sign;
+	}
+}
+
+static ufbxi_forceinline int16_t ufbxi_encode_snorm16(ufbx_real value)
+{
+	double v = ufbx_fmin(ufbx_fmax((double)value, -1.0), 1.0) * 32767.0;
+	return (int16_t)(v >= 0.0 ? v + 0.5 : v - 0.5);
+}
+
+static ufbxi_forceinline uint8_t ufbxi_encode_unorm8(ufbx_real value)
+{
+	return (uint8_t)(ufbx_fmin(ufbx_fmax((double)value, 0.0), 1.0) * 255.0 + 0.5);
+}
+
+static ufbxi_noinline void ufbxi_encode_vertex_attrib(char *dst, const ufbxi_mesh_buffer_attrib *attrib, uint32_t index)
+{
+	// Missing attributes are left as zero
+	uint32_t value_ix = attrib->indices[index];
+	if (value_ix >= attrib->num_values) return;
+	const ufbx_real *src = attrib->values + (size_t)value_ix * attrib->num_reals;
+
+	ufbx_real v[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+	for (uint32_t i = 0; i < attrib->num_reals; i++) {
+		v[i] = src[i];
+	}
+
+	uint32_t num_components = attrib->num_components;
+	switch (attrib->format) {
+	case UFBX_VERTEX_FORMAT_FLOAT32: {
+		float f[4];
+#if UFBXI_HAS_SSE && !defined(UFBX_REAL_IS_FLOAT)
+		_mm_storeu_ps(f, _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(v + 0)), _mm_cvtpd_ps(_mm_loadu_pd(v + 2))));
+#else
+		for (uint32_t i = 0; i < 4; i++) {
+			f[i] = (float)v[i];
+		}
+#endif
+		memcpy(dst, f, num_components * sizeof(float));
+	} break;
+	case UFBX_VERTEX_FORMAT_FLOAT16: {
+		uint16_t h[4];
+		for (uint32_t i = 0; i < num_components; i++) {
+			h[i] = ufbxi_f32_to_f16((float)v[i]);
+		}
+		memcpy(dst, h, num_components * sizeof(uint16_t));
+	} break;
+	case UFBX_VERTEX_FORMAT_SNORM16: {
+		int16_t s[4];
+		for (uint32_t i = 0; i < num_components; i++) {
+			s[i] = ufbxi_encode_snorm16(v[i]);
+		}
+		memcpy(dst, s, num_components * sizeof(int16_t));
+	} break;
+	case UFBX_VERTEX_FORMAT_UNORM8: {
+		uint8_t u[4];
+		for (uint32_t i = 0; i < num_components; i++) {
+			u[i] = ufbxi_encode_unorm8(v[i]);
+		}
+		memcpy(dst, u, num_components * sizeof(uint8_t));
+	} break;
+	case UFBX_VERTEX_FORMAT_OCT_SNORM16: {
+		// "A Survey of Efficient Representations for Independent Unit Vectors", Cigolle et al. 2014
+		ufbx_real sum = (ufbx_real)(ufbx_fabs(v[0]) + ufbx_fabs(v[1]) + ufbx_fabs(v[2]));
+		ufbx_real x = 0.0f, y = 0.0f;
+		if (sum > 0.0f) {
+			x = v[0] / sum;
+			y = v[1] / sum;
+			if (v[2] < 0.0f) {
+				ufbx_real ox = (ufbx_real)(1.0f - ufbx_fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+				ufbx_real oy = (ufbx_real)(1.0f - ufbx_fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+				x = ox;
+				y = oy;
+			}
+		}
+		int16_t s[2] = { ufbxi_encode_snorm16(x), ufbxi_encode_snorm16(y) };
+		memcpy(dst, s, sizeof(s));
+	} break;
+	default:
+		ufbx_assert(0 && "Unhandled vertex format");
+		break;
+	}
+}
+
+static ufbxi_noinline void ufbxi_build_mesh_buffers_part(ufbxi_mesh_buffers_part *part)
+{
+	const ufbxi_mesh_buffers_shared *shared = part->shared;
+	const ufbx_mesh *mesh = shared->mesh;
+	size_t stride = shared->stride;
+	uint32_t num_tri_indices = (uint32_t)(mesh->max_face_triangles * 3);
+
+	memset(part->hash_table, 0xff, ((size_t)part->hash_mask + 1) * sizeof(uint32_t));
+
+	uint32_t num_vertices = 0;
+	size_t num_indices = 0;
+	for (size_t face_ix = 0; face_ix < part->num_faces; face_ix++) {
+		ufbx_face face = mesh->faces.data[part->face_indices ? part->face_indices[face_ix] : face_ix];
+		if (face.num_indices < 3) continue;
+		uint32_t num_tris = ufbxi_triangulate_face_imp(part->tri_indices, num_tri_indices, mesh, face, &part->scratch);
+		ufbx_assert(num_indices + num_tris * 3 <= part->num_indices);
+
+		for (uint32_t corner = 0; corner < num_tris * 3; corner++) {
+			uint32_t index = part->tri_indices[corner];
+
+			// Encode directly into the next free slot and keep it only if it's unique
+			char *vertex = part->vertices + num_vertices * stride;
+			memset(vertex, 0, stride);
+			for (size_t i = 0; i < shared->num_attribs; i++) {
+				const ufbxi_mesh_buffer_attrib *attrib = &shared->attribs[i];
+				if (attrib->values) {
+					ufbxi_encode_vertex_attrib(vertex + attrib->offset, attrib, index);
+				}
+			}
+
+			uint32_t slot = ufbxi_hash_string(vertex, stride) & part->hash_mask;
+			uint32_t vertex_ix;
+			for (;;) {
+				vertex_ix = part->hash_table[slot];
+				if (vertex_ix == UINT32_MAX) {
+					vertex_ix = num_vertices++;
+					part->hash_table[slot] = vertex_ix;
+					break;
+				}
+				if (!memcmp(part->vertices + vertex_ix * stride, vertex, stride)) break;
+				slot = (slot + 1) & part->hash_mask;
+			}
+			part->indices[num_indices++] = vertex_ix;
+		}
+	}
+
+	part->num_indices = num_indices;
+	part->num_vertices = num_vertices;
+}
+
+static bool ufbxi_build_mesh_buffers_part_task_fn(ufbxi_task *task)
+{
+	ufbxi_build_mesh_buffers_part((ufbxi_mesh_buffers_part*)task->data);
+	return true;
+}
+
+static ufbxi_noinline void ufbxi_mesh_buffer_attrib_source(ufbxi_mesh_buffer_attrib *dst, const ufbx_mesh *mesh, const ufbx_vertex_attrib_desc *desc)
+{
+	const ufbx_vertex_attrib *src = NULL;
+	size_t set_ix = desc->set_index;
+	switch (desc->type) {
+	case UFBX_VERTEX_ATTRIB_POSITION:
+		src = (const ufbx_vertex_attrib*)&mesh->vertex_position;
+		break;
+	case UFBX_VERTEX_ATTRIB_NORMAL:
+		src = (const ufbx_vertex_attrib*)&mesh->vertex_normal;
+		break;
+	case UFBX_VERTEX_ATTRIB_TANGENT:
+		if (set_ix < mesh->uv_sets.count) src = (const ufbx_vertex_attrib*)&mesh->uv_sets.data[set_ix].vertex_tangent;
+		break;
+	case UFBX_VERTEX_ATTRIB_BITANGENT:
+		if (set_ix < mesh->uv_sets.count) src = (const ufbx_vertex_attrib*)&mesh->uv_sets.data[set_ix].vertex_bitangent;
+		break;
+	case UFBX_VERTEX_ATTRIB_UV:
+		if (set_ix < mesh->uv_sets.count) src = (const ufbx_vertex_attrib*)&mesh->uv_sets.data[set_ix].vertex_uv;
+		break;
+	case UFBX_VERTEX_ATTRIB_COLOR:
+		if (set_ix < mesh->color_sets.count) src = (const ufbx_vertex_attrib*)&mesh->color_sets.data[set_ix].vertex_color;
+		break;
+	default:
+		break;
+	}
+
+	if (src && src->exists && src->value_reals > 0 && src->indices.count >= mesh->num_indices) {
+		dst->values = (const ufbx_real*)src->values.data;
+		dst->indices = src->indices.data;
+		dst->num_values = src->values.count;
+		dst->num_reals = (uint32_t)ufbxi_min_sz(src->value_reals, 4);
+	}
+}
+
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_create_mesh_buffers_imp(ufbxi_mesh_buffers_context *bc)
+{
+	// `ufbx_mesh_buffers_opts` must be cleared to zero first!
+	ufbx_assert(bc->opts._begin_zero == 0 && bc->opts._end_zero == 0);
+	ufbxi_check_err_msg(&bc->error, bc->opts._begin_zero == 0 && bc->opts._end_zero == 0, "Uninitialized options");
+
+	ufbxi_init_ator(&bc->error, &bc->ator_tmp, &bc->opts.temp_allocator, "temp");
+	ufbxi_init_ator(&bc->error, &bc->ator_result, &bc->opts.result_allocator, "result");
+
+	bc->tmp.unordered = true;
+	bc->tmp.ator = &bc->ator_tmp;
+	bc->result.unordered = true;
+	bc->result.ator = &bc->ator_result;
+
+	const ufbx_mesh *mesh = bc->mesh;
+	const ufbx_mesh_buffers_opts *opts = &bc->opts;
+
+	// Resolve the vertex layout
+	size_t num_attribs = opts->attribs.count;
+	ufbxi_check_err_msg(&bc->error, num_attribs > 0, "Empty vertex layout");
+
+	ufbxi_mesh_buffer_attrib *attribs = ufbxi_push(&bc->tmp, ufbxi_mesh_buffer_attrib, num_attribs);
+	ufbxi_check_err(&bc->error, attribs);
+	memset(attribs, 0, num_attribs * sizeof(ufbxi_mesh_buffer_attrib));
+
+	size_t layout_end = 0;
+	for (size_t i = 0; i < num_attribs; i++) {
+		const ufbx_vertex_attrib_desc *desc = &opts->attribs.data[i];
+		ufbxi_mesh_buffer_attrib *attrib = &attribs[i];
+		if ((uint32_t)desc->type >= UFBX_VERTEX_ATTRIB_TYPE_COUNT || (uint32_t)desc->format >= UFBX_VERTEX_FORMAT_COUNT) {
+			ufbxi_fmt_err_info(&bc->error, "%zu", i);
+			ufbxi_fail_err_msg(&bc->error, "desc->type && desc->format", "Bad vertex attribute");
+		}
+
+		size_t num_components = desc->num_components ? desc->num_components : ufbxi_vertex_attrib_default_components[desc->type];
+		if (desc->format == UFBX_VERTEX_FORMAT_OCT_SNORM16) num_components = 2;
+		if (num_components > 4 || desc->offset > UINT32_MAX / 2) {
+			ufbxi_fmt_err_info(&bc->error, "%zu", i);
+			ufbxi_fail_err_msg(&bc->error, "num_components <= 4", "Bad vertex attribute");
+		}
+
+		attrib->num_components = (uint32_t)num_components;
+		attrib->offset = (uint32_t)desc->offset;
+		attrib->format = desc->format;
+		ufbxi_mesh_buffer_attrib_source(attrib, mesh, desc);
+
+		layout_end = ufbxi_max_sz(layout_end, desc->offset + num_components * ufbxi_vertex_format_size[desc->format]);
+	}
+
+	size_t stride = opts->vertex_stride ? opts->vertex_stride : ufbxi_align_to_mask(layout_end, 3);
+	ufbxi_check_err_msg(&bc->error, stride >= layout_end && stride <= UINT32_MAX / 2, "Vertex attribute out of bounds");
+
+	// Collect the parts, a mesh without material parts gets a single one with all faces
+	size_t num_parts = mesh->material_parts.count > 0 ? mesh->material_parts.count : 1;
+	ufbxi_mesh_buffers_part *parts = ufbxi_push(&bc->tmp, ufbxi_mesh_buffers_part, num_parts);
+	ufbxi_check_err(&bc->error, parts);
+	memset(parts, 0, num_parts * sizeof(ufbxi_mesh_buffers_part));
+
+	ufbxi_mesh_buffers_shared shared;
+	shared.mesh = mesh;
+	shared.attribs = attribs;
+	shared.num_attribs = num_attribs;
+	shared.stride = stride;
+
+	size_t num_nonempty_parts = 0;
+	for (size_t part_ix = 0; part_ix < num_parts; part_ix++) {
+		ufbxi_mesh_buffers_part *part = &parts[part_ix];
+		size_t num_triangles;
+		if (mesh->material_parts.count > 0) {
+			const ufbx_mesh_part *src = &mesh->material_parts.data[part_ix];
+			part->face_indices = src->face_indices.data;
+			part->num_faces = src->num_faces;
+			num_triangles = src->num_triangles;
+		} else {
+			part->num_faces = mesh->num_faces;
+			num_triangles = mesh->num_triangles;
+		}
+
+		ufbxi_check_err_msg(&bc->error, num_triangles <= UINT32_MAX / 6 && num_triangles * 3 <= SIZE_MAX / stride, "Too many triangles");
+		size_t num_indices = num_triangles * 3;
+		part->shared = &shared;
+		part->num_indices = num_indices;
+		if (num_indices == 0) continue;
+
+		size_t hash_size = 1;
+		while (hash_size < num_indices * 2) hash_size *= 2;
+		part->hash_mask = (uint32_t)(hash_size - 1);
+
+		part->vertices = ufbxi_push(&bc->tmp, char, num_indices * stride);
+		part->indices = ufbxi_push(&bc->tmp, uint32_t, num_indices);
+		part->hash_table = ufbxi_push(&bc->tmp, uint32_t, hash_size);
+		part->tri_indices = ufbxi_push(&bc->tmp, uint32_t, mesh->max_face_triangles * 3);
+		ufbxi_check_err(&bc->error, part->vertices && part->indices && part->hash_table && part->tri_indices);
+
+		uint32_t max_face_indices = 0;
+		for (size_t face_ix = 0; face_ix < part->num_faces; face_ix++) {
+			ufbx_face face = mesh->faces.data[part->face_indices ? part->face_indices[face_ix] : face_ix];
+			ufbxi_check_err_msg(&bc->error, face.index_begin <= mesh->num_indices && mesh->num_indices - face.index_begin >= face.num_indices, "Face out of bounds");
+			ufbxi_check_err_msg(&bc->error, face.num_indices < 3 || face.num_indices - 2 <= mesh->max_face_triangles, "Face out of bounds");
+			max_face_indices = ufbxi_max32(max_face_indices, face.num_indices);
+		}
+		ufbxi_check_err(&bc->error, ufbxi_init_monotone_scratch(&part->scratch, &bc->tmp, max_face_indices));
+		num_nonempty_parts++;
+	}
+
+	ufbx_trace_cb trace_cb = { 0 };
+	if (num_nonempty_parts > 1) {
+		ufbxi_check_err(&bc->error, ufbxi_thread_pool_init(&bc->thread_pool, &bc->error, &bc->ator_tmp, &opts->thread_opts, &trace_cb));
+	}
+
+	ufbxi_thread_pool *pool = &bc->thread_pool;
+	for (size_t part_ix = 0; part_ix < num_parts; part_ix++) {
+		ufbxi_mesh_buffers_part *part = &parts[part_ix];
+		if (part->num_indices == 0) continue;
+
+		ufbxi_task *task = pool->enabled ? ufbxi_thread_pool_create_task(pool, &ufbxi_build_mesh_buffers_part_task_fn, "mesh_buffers") : NULL;
+		if (task) {
+			task->data = part;
+			ufbxi_thread_pool_run_task(pool, task, (double)part->num_indices);
+		} else {
+			ufbxi_build_mesh_buffers_part(part);
+		}
+	}
+
+	if (pool->enabled) {
+		ufbxi_thread_pool_flush_group(pool);
+		ufbxi_check_err(&bc->error, ufbxi_thread_pool_wait_all(pool));
+	}
+
+	// Copy the compacted results
+	ufbx_mesh_buffer_part *dst_parts = ufbxi_push(&bc->result, ufbx_mesh_buffer_part, num_parts);
+	ufbxi_check_err(&bc->error, dst_parts);
+
+	for (size_t part_ix = 0; part_ix < num_parts; part_ix++) {
+		const ufbxi_mesh_buffers_part *part = &parts[part_ix];
+		ufbx_mesh_buffer_part *dst = &dst_parts[part_ix];
+		memset(dst, 0, sizeof(ufbx_mesh_buffer_part));
+
+		size_t vertex_bytes = part->num_vertices * stride;
+		bool index16 = part->num_vertices <= UINT16_MAX && !opts->force_32bit_indices;
+		size_t index_size = index16 ? sizeof(uint16_t) : sizeof(uint32_t);
+
+		// Push as `uint64_t` to keep the vertex data aligned for any format
+		uint64_t *vertex_data = ufbxi_push(&bc->result, uint64_t, (vertex_bytes + 7) / 8);
+		ufbxi_check_err(&bc->error, vertex_data);
+		if (vertex_bytes > 0) {
+			memcpy(vertex_data, part->vertices, vertex_bytes);
+		}
+
+		void *index_data = NULL;
+		if (index16) {
+			uint16_t *dst_indices = ufbxi_push(&bc->result, uint16_t, part->num_indices);
+			ufbxi_check_err(&bc->error, dst_indices);
+			for (size_t i = 0; i < part->num_indices; i++) {
+				dst_indices[i] = (uint16_t)part->indices[i];
+			}
+			index_data = dst_indices;
+		} else {
+			index_data = ufbxi_push_copy(&bc->result, uint32_t, part->num_indices, part->indices);
+			ufbxi_check_err(&bc->error, index_data);
+		}
+
+		dst->part_index = (uint32_t)part_ix;
+		dst->num_vertices = part->num_vertices;
+		dst->vertex_data.data = vertex_data;
+		dst->vertex_data.size = vertex_bytes;
+		dst->num_indices = part->num_indices;
+		dst->index_size = index_size;
+		dst->index_data.data = index_data;
+		dst->index_data.size = part->num_indices * index_size;
+	}
+
+	bc->imp = ufbxi_push(&bc->result, ufbxi_mesh_buffers_imp, 1);
+	ufbxi_check_err(&bc->error, bc->imp);
+
+	ufbxi_init_ref(&bc->imp->refcount, UFBXI_MESH_BUFFERS_IMP_MAGIC, NULL);
+
+	bc->imp->magic = UFBXI_MESH_BUFFERS_IMP_MAGIC;
+	bc->imp->buffers.vertex_stride = stride;
+	bc->imp->buffers.parts.data = dst_parts;
+	bc->imp->buffers.parts.count = num_parts;
+	bc->imp->refcount.ator = bc->ator_result;
+	bc->imp->refcount.buf = bc->result;
+	return 1;
+}
+
+static ufbxi_noinline ufbx_mesh_buffers *ufbxi_create_mesh_buffers(const ufbx_mesh *mesh, const ufbx_mesh_buffers_opts *opts, ufbx_error *error)
+{
+	ufbxi_mesh_buffers_context bc = { UFBX_ERROR_NONE };
+	if (opts) {
+		bc.opts = *opts;
+	}
+	bc.mesh = mesh;
+
+	int ok = ufbxi_create_mesh_buffers_imp(&bc);
+
+	// Wait for all tasks before releasing them
+	ufbxi_thread_pool_free(&bc.thread_pool);
+	ufbxi_buf_free(&bc.tmp);
+	ufbxi_free_ator(&bc.ator_tmp);
+
+	if (ok) {
+		ufbxi_clear_error(error);
+		return &bc.imp->buffers;
+	} else {
+		ufbxi_fix_error_type(&bc.error, "Failed to create mesh buffers");
+		if (error) *error = bc.error;
+		ufbxi_buf_free(&bc.result);
+		ufbxi_free_ator(&bc.ator_result);
+		return NULL;
+	}
+}
+
+#else
+
+static ufbxi_noinline ufbx_mesh_buffers *ufbxi_create_mesh_buffers(const ufbx_mesh *mesh, const ufbx_mesh_buffers_opts *opts, ufbx_error *error)
+{
+	ufbxi_fmt_err_info(error, "UFBX_ENABLE_TRIANGULATION");
+	ufbxi_report_err_msg(error, "UFBXI_FEATURE_TRIANGULATION", "Feature disabled");
+	return NULL;
+}
+
+#endif
+
+#define UFBXI_MAX_PACKED_SKIN_INFLUENCES 8
+#define UFBXI_PACK_SKIN_TASK_VERTICES 16384
+
+typedef struct {
+	const ufbx_skin_deformer *skin;
+	const uint32_t *vertices;
+	void *bone_indices;
+	void *bone_weights;
+	size_t num_influences;
+	bool wide_indices;
+	bool wide_weights;
+} ufbxi_pack_skin_context;
+
+typedef struct {
+	const ufbxi_pack_skin_context *pc;
+	size_t begin, end;
+} ufbxi_pack_skin_task;
+
+typedef struct {
+	ufbx_error *error;
+	ufbxi_allocator ator;
+	ufbxi_thread_pool pool;
+	ufbx_pack_skin_weights_opts opts;
+
+	ufbxi_pack_skin_task *tasks;
+	size_t num_tasks;
+} ufbxi_pack_skin_state;
+
+static ufbxi_noinline bool ufbxi_pack_skin_range(const ufbxi_pack_skin_context *pc, size_t begin, size_t end)
+{
+	const ufbx_skin_deformer *skin = pc->skin;
+	size_t num_influences = pc->num_influences;
+	uint32_t max_value = pc->wide_weights ? UINT16_MAX : UINT8_MAX;
+
+	for (size_t ix = begin; ix < end; ix++) {
+		size_t vertex = pc->vertices ? pc->vertices[ix] : ix;
+		if (vertex >= skin->vertices.count) return false;
+		ufbx_skin_vertex skin_vertex = skin->vertices.data[vertex];
+
+		// Weights are sorted by decreasing weight so the first ones are the most important,
+		// skip clusters without bones to match `ufbx_get_skin_vertex_matrix()`.
+		uint32_t indices[UFBXI_MAX_PACKED_SKIN_INFLUENCES];
+		ufbx_real weights[UFBXI_MAX_PACKED_SKIN_INFLUENCES];
+		uint32_t quantized[UFBXI_MAX_PACKED_SKIN_INFLUENCES];
+		size_t num_weights = 0;
+		ufbx_real total_weight = 0.0f;
+		for (uint32_t i = 0; i < skin_vertex.num_weights && num_weights < num_influences; i++) {
+			ufbx_skin_weight weight = skin->weights.data[skin_vertex.weight_begin + i];
+			if (!(weight.weight > 0.0f) || !skin->clusters.data[weight.cluster_index]->bone_node) continue;
+			indices[num_weights] = weight.cluster_index;
+			weights[num_weights] = weight.weight;
+			total_weight += weight.weight;
+			num_weights++;
+		}
+
+		uint32_t quantized_sum = 0;
+		for (size_t i = 0; i < num_weights; i++) {
+			uint32_t value = (uint32_t)(weights[i] / total_weight * (ufbx_real)max_value + 0.5f);
+			quantized[i] = ufbxi_min32(value, max_value);
+			quantized_sum += quantized[i];
+		}
+		for (size_t i = num_weights; i < num_influences; i++) {
+			indices[i] = 0;
+			quantized[i] = 0;
+		}
+
+		// Make the weights sum up exactly to one, the largest weight absorbs
+		// the rounding error as it has the smallest relative change.
+		if (num_weights > 0) {
+			quantized[0] = quantized[0] + max_value - quantized_sum;
+		}
+
+		size_t dst = ix * num_influences;
+		if (pc->wide_indices) {
+			uint16_t *dst_indices = (uint16_t*)pc->bone_indices + dst;
+			for (size_t i = 0; i < num_influences; i++) dst_indices[i] = (uint16_t)indices[i];
+		} else {
+			uint8_t *dst_indices = (uint8_t*)pc->bone_indices + dst;
+			for (size_t i = 0; i < num_influences; i++) dst_indices[i] = (uint8_t)indices[i];
+		}
+		if (pc->wide_weights) {
+			uint16_t *dst_weights = (uint16_t*)pc->bone_weights + dst;
+			for (size_t i = 0; i < num_influences; i++) dst_weights[i] = (uint16_t)quantized[i];
+		} else {
+			uint8_t *dst_weights = (uint8_t*)pc->bone_weights + dst;
+			for (size_t i = 0; i < num_influences; i++) dst_weights[i] = (uint8_t)quantized[i];
+		}
+	}
+
+	return true;
+}
+
+static bool ufbxi_pack_skin_task_fn(ufbxi_task *task)
+{
+	ufbxi_pack_skin_task *t = (ufbxi_pack_skin_task*)task->data;
+	if (!ufbxi_pack_skin_range(t->pc, t->begin, t->end)) {
+		task->error = "Vertex index out of bounds";
+		return false;
+	}
+	return true;
+}
+
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_pack_skin_weights_imp(ufbxi_pack_skin_state *ps, const ufbxi_pack_skin_context *pc, size_t num_vertices)
+{
+	ufbx_error *error = ps->error;
+	ufbxi_thread_pool *pool = &ps->pool;
+	const ufbx_skin_deformer *skin = pc->skin;
+	size_t max_index = pc->wide_indices ? UINT16_MAX : UINT8_MAX;
+	ufbxi_check_err_msg(error, pc->num_influences <= UFBXI_MAX_PACKED_SKIN_INFLUENCES, "Too many influences");
+	ufbxi_check_err_msg(error, skin->clusters.count == 0 || skin->clusters.count - 1 <= max_index, "Too many clusters for bone index type");
+	if (num_vertices == 0) return 1;
+	ufbxi_check_err_msg(error, pc->bone_indices && pc->bone_weights, "Missing output buffer");
+
+	size_t num_tasks = (num_vertices + UFBXI_PACK_SKIN_TASK_VERTICES - 1) / UFBXI_PACK_SKIN_TASK_VERTICES;
+	ufbx_trace_cb trace_cb = { 0 };
+	if (num_tasks > 1) {
+		ufbxi_check_err(error, ufbxi_thread_pool_init(pool, error, &ps->ator, &ps->opts.thread_opts, &trace_cb));
+	}
+
+	if (pool->enabled) {
+		ps->tasks = ufbxi_alloc(&ps->ator, ufbxi_pack_skin_task, num_tasks);
+		ufbxi_check_err(error, ps->tasks);
+		ps->num_tasks = num_tasks;
+	}
+
+	// Split the vertices into tasks, packing inline if threading is not available
+	for (size_t task_ix = 0; task_ix < num_tasks; task_ix++) {
+		size_t begin = task_ix * UFBXI_PACK_SKIN_TASK_VERTICES;
+		size_t end = ufbxi_min_sz(begin + UFBXI_PACK_SKIN_TASK_VERTICES, num_vertices);
+
+		ufbxi_task *task = pool->enabled ? ufbxi_thread_pool_create_task(pool, &ufbxi_pack_skin_task_fn, "pack_skin_weights") : NULL;
+		if (task) {
+			ufbxi_pack_skin_task *t = &ps->tasks[task_ix];
+			t->pc = pc;
+			t->begin = begin;
+			t->end = end;
+			task->data = t;
+			ufbxi_thread_pool_run_task(pool, task, (double)(end - begin));
+		} else {
+			ufbxi_check_err_msg(error, ufbxi_pack_skin_range(pc, begin, end), "Vertex index out of bounds");
+		}
+	}
+
+	if (pool->enabled) {
+		ufbxi_thread_pool_flush_group(pool);
+		ufbxi_check_err(error, ufbxi_thread_pool_wait_all(pool));
+	}
+
+	return 1;
+}
+
+static ufbxi_noinline bool ufbxi_pack_skin_weights(const ufbx_skin_deformer *skin, const uint32_t *vertices, size_t num_vertices,
+	void *bone_indices, void *bone_weights, const ufbx_pack_skin_weights_opts *user_opts, ufbx_error *error)
+{
+	ufbxi_pack_skin_state ps;
+	memset(&ps, 0, sizeof(ps));
+	ps.error = error;
+	if (user_opts) {
+		ps.opts = *user_opts;
+	}
+
+	// `ufbx_pack_skin_weights_opts` must be cleared to zero first!
+	ufbx_assert(ps.opts._begin_zero == 0 && ps.opts._end_zero == 0);
+	if (ps.opts._begin_zero != 0 || ps.opts._end_zero != 0) {
+		ufbxi_report_err_msg(error, "opts._begin_zero == 0 && opts._end_zero == 0", "Uninitialized options");
+		ufbxi_fix_error_type(error, "Failed to pack skin weights");
+		return false;
+	}
+
+	ufbxi_pack_skin_context pc;
+	pc.skin = skin;
+	pc.vertices = vertices;
+	pc.bone_indices = bone_indices;
+	pc.bone_weights = bone_weights;
+	pc.num_influences = ps.opts.max_influences ? ps.opts.max_influences : 4;
+	pc.wide_indices = ps.opts.wide_indices;
+	pc.wide_weights = ps.opts.wide_weights;
+
+	ufbxi_init_ator(error, &ps.ator, &ps.opts.temp_allocator, "temp");
+
+	int ok = ufbxi_pack_skin_weights_imp(&ps, &pc, num_vertices);
+
+	// Wait for all tasks before releasing them
+	ufbxi_thread_pool_free(&ps.pool);
+	ufbxi_free(&ps.ator, ufbxi_pack_skin_task, ps.tasks, ps.num_tasks);
+	ufbxi_free_ator(&ps.ator);
+
+	if (ok) {
+		ufbxi_clear_error(error);
+	} else {
+		ufbxi_fix_error_type(error, "Failed to pack skin weights");
+	}
+	return ok != 0;
+}
+
+// Add `weight * offsets[i]` to `vertices[indices[i]]` skipping out of bounds indices.
+// The SSE version computes the exact same results as the scalar one.
+static ufbxi_noinline void ufbxi_add_blend_offsets(ufbx_vec3 *vertices, size_t num_vertices, const uint32_t *indices, const ufbx_vec3 *offsets, size_t num_offsets, ufbx_real weight)
+{
+#if UFBXI_HAS_SSE && !defined(UFBX_REAL_IS_FLOAT)
+	const __m128d w = _mm_set1_pd(weight);
+	for (size_t i = 0; i < num_offsets; i++) {
+		uint32_t index = indices[i];
+		if (index >= num_vertices) continue;
+		ufbx_vec3 *v = &vertices[index];
+		const ufbx_vec3 *o = &offsets[i];
+		_mm_storeu_pd(&v->x, _mm_add_pd(_mm_loadu_pd(&v->x), _mm_mul_pd(_mm_loadu_pd(&o->x), w)));
+		v->z += o->z * weight;
+	}
+#else
+	for (size_t i = 0; i < num_offsets; i++) {
+		uint32_t index = indices[i];
+		if (index < num_vertices) {
+			ufbxi_add_weighted_vec3(&vertices[index], offsets[i], weight);
+		}
+	}
+#endif
+}
+
+typedef struct {
+	ufbxi_refcount refcount;
+	ufbx_blend_vertex_layout layout;
+	uint32_t magic;
+} ufbxi_blend_vertex_layout_imp;
 
-		ufbxi_buf_free(&sc->source);
-		ufbxi_buf_free(&sc->tmp);
-		sc->source = sc->result;
-		memset(&sc->result, 0, sizeof(sc->result));
+typedef struct {
+	ufbx_error error;
+	ufbxi_allocator ator_tmp;
+	ufbxi_allocator ator_result;
+
+	ufbxi_buf result;
+
+	ufbx_blend_vertex_layout_opts opts;
+	const ufbx_blend_deformer *blend;
+
+	ufbx_blend_vertex_layout layout;
+	ufbxi_blend_vertex_layout_imp *imp;
+} ufbxi_blend_layout_context;
+
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_create_blend_vertex_layout_imp(ufbxi_blend_layout_context *lc, uint32_t **p_counts, size_t *p_num_counts)
+{
+	// `ufbx_blend_vertex_layout_opts` must be cleared to zero first!
+	ufbx_assert(lc->opts._begin_zero == 0 && lc->opts._end_zero == 0);
+	ufbxi_check_err_msg(&lc->error, lc->opts._begin_zero == 0 && lc->opts._end_zero == 0, "Uninitialized options");
+
+	ufbxi_init_ator(&lc->error, &lc->ator_tmp, &lc->opts.temp_allocator, "temp");
+	ufbxi_init_ator(&lc->error, &lc->ator_result, &lc->opts.result_allocator, "result");
+
+	lc->result.unordered = true;
+	lc->result.ator = &lc->ator_result;
+
+	const ufbx_blend_deformer *blend = lc->blend;
+
+	// Count the shapes and the range of affected vertices
+	size_t num_shapes = 0, num_offsets = 0, max_vertex = 0;
+	ufbxi_for_ptr_list(ufbx_blend_channel, p_chan, blend->channels) {
+		ufbxi_for_list(ufbx_blend_keyframe, key, (*p_chan)->keyframes) {
+			const ufbx_blend_shape *shape = key->shape;
+			num_shapes++;
+			num_offsets += shape->num_offsets;
+			for (size_t i = 0; i < shape->num_offsets; i++) {
+				max_vertex = ufbxi_max_sz(max_vertex, shape->offset_vertices.data[i]);
+			}
+		}
 	}
+	ufbxi_check_err_msg(&lc->error, num_offsets < UINT32_MAX && num_shapes < UINT32_MAX, "Too many blend offsets");
 
-	sc->result.ator = &sc->ator_result;
-	ufbxi_check_err(&sc->error, ufbxi_subdivide_mesh_level(sc));
-	ufbxi_buf_free(&sc->tmp);
+	// Count the offsets per vertex and convert them to the starting position of each vertex
+	size_t num_counts = num_offsets > 0 ? max_vertex + 1 : 0;
+	uint32_t *counts = ufbxi_alloc(&lc->ator_tmp, uint32_t, num_counts);
+	ufbxi_check_err(&lc->error, counts);
+	memset(counts, 0, num_counts * sizeof(uint32_t));
+	*p_counts = counts;
+	*p_num_counts = num_counts;
 
-	ufbx_mesh *mesh = &sc->dst_mesh;
-	memset(&mesh->vertex_normal, 0, sizeof(mesh->vertex_normal));
-	memset(&mesh->skinned_normal, 0, sizeof(mesh->skinned_normal));
+	ufbxi_for_ptr_list(ufbx_blend_channel, p_chan, blend->channels) {
+		ufbxi_for_list(ufbx_blend_keyframe, key, (*p_chan)->keyframes) {
+			const ufbx_blend_shape *shape = key->shape;
+			for (size_t i = 0; i < shape->num_offsets; i++) {
+				counts[shape->offset_vertices.data[i]]++;
+			}
+		}
+	}
+
+	size_t num_vertices = 0;
+	for (size_t i = 0; i < num_counts; i++) {
+		if (counts[i] > 0) num_vertices++;
+	}
+
+	uint32_t *vertices = ufbxi_push(&lc->result, uint32_t, num_vertices);
+	uint32_t *offset_begin = ufbxi_push(&lc->result, uint32_t, num_vertices + 1);
+	uint32_t *offset_shapes = ufbxi_push(&lc->result, uint32_t, num_offsets);
+	ufbx_vec3 *position_offsets = ufbxi_push(&lc->result, ufbx_vec3, num_offsets);
+	ufbxi_check_err(&lc->error, vertices && offset_begin && offset_shapes && position_offsets);
+
+	uint32_t offset = 0, vertex_ix = 0;
+	for (size_t i = 0; i < num_counts; i++) {
+		uint32_t count = counts[i];
+		if (count == 0) continue;
+		vertices[vertex_ix] = (uint32_t)i;
+		offset_begin[vertex_ix] = offset;
+		counts[i] = offset;
+		offset += count;
+		vertex_ix++;
+	}
+	offset_begin[num_vertices] = offset;
+
+	// Scatter the offsets in shape order so each vertex has its offsets sorted by shape
+	uint32_t shape_ix = 0;
+	ufbxi_for_ptr_list(ufbx_blend_channel, p_chan, blend->channels) {
+		ufbxi_for_list(ufbx_blend_keyframe, key, (*p_chan)->keyframes) {
+			const ufbx_blend_shape *shape = key->shape;
+			for (size_t i = 0; i < shape->num_offsets; i++) {
+				uint32_t dst = counts[shape->offset_vertices.data[i]]++;
+				offset_shapes[dst] = shape_ix;
+				position_offsets[dst] = shape->position_offsets.data[i];
+			}
+			shape_ix++;
+		}
+	}
+
+	lc->layout.num_shapes = num_shapes;
+	lc->layout.num_offsets = num_offsets;
+	lc->layout.vertices.data = vertices;
+	lc->layout.vertices.count = num_vertices;
+	lc->layout.offset_begin.data = offset_begin;
+	lc->layout.offset_begin.count = num_vertices + 1;
+	lc->layout.offset_shapes.data = offset_shapes;
+	lc->layout.offset_shapes.count = num_offsets;
+	lc->layout.position_offsets.data = position_offsets;
+	lc->layout.position_offsets.count = num_offsets;
+
+	lc->imp = ufbxi_push(&lc->result, ufbxi_blend_vertex_layout_imp, 1);
+	ufbxi_check_err(&lc->error, lc->imp);
+
+	// The layout contains a copy of the offsets and does not refer to the scene
+	ufbxi_init_ref(&lc->imp->refcount, UFBXI_BLEND_VERTEX_LAYOUT_IMP_MAGIC, NULL);
+
+	lc->imp->magic = UFBXI_BLEND_VERTEX_LAYOUT_IMP_MAGIC;
+	lc->imp->layout = lc->layout;
+	lc->imp->refcount.ator = lc->ator_result;
+	lc->imp->refcount.buf = lc->result;
+	return 1;
+}
+
+static ufbxi_noinline void ufbxi_free_scene_imp(ufbxi_scene_imp *imp)
+{
+	ufbx_assert(imp->magic == UFBXI_SCENE_IMP_MAGIC);
+	ufbxi_buf_free(&imp->string_buf);
+}
+
+static ufbxi_noinline void ufbxi_free_load_context_imp(ufbxi_load_context_imp *imp)
+{
+	ufbx_assert(imp->magic == UFBXI_LOAD_CONTEXT_IMP_MAGIC);
+	ufbx_assert(!imp->in_use);
+	ufbxi_cache_trim(&imp->cache, 0);
+}
+
+static ufbxi_noinline void ufbxi_init_ref(ufbxi_refcount *refcount, uint32_t magic, ufbxi_refcount *parent)
+{
+	if (parent) {
+		ufbxi_retain_ref(parent);
+	}
+
+	ufbxi_atomic_counter_init(&refcount->refcount);
+	refcount->self_magic = UFBXI_REFCOUNT_IMP_MAGIC;
+	refcount->type_magic = magic;
+	refcount->parent = parent;
+}
+
+static ufbxi_noinline void ufbxi_retain_ref(ufbxi_refcount *refcount)
+{
+	ufbx_assert(refcount->self_magic == UFBXI_REFCOUNT_IMP_MAGIC);
+	size_t count = ufbxi_atomic_counter_inc(&refcount->refcount);
+	ufbxi_ignore(count);
+	ufbx_assert(count < SIZE_MAX / 2);
+}
+
+static ufbxi_noinline void ufbxi_release_ref(ufbxi_refcount *refcount)
+{
+	while (refcount) {
+		ufbx_assert(refcount->self_magic == UFBXI_REFCOUNT_IMP_MAGIC);
+		if (ufbxi_atomic_counter_dec(&refcount->refcount) > 0) return;
+		ufbxi_atomic_counter_free(&refcount->refcount);
+
+		ufbxi_refcount *parent = refcount->parent;
+		uint32_t type_magic = refcount->type_magic;
+
+		refcount->self_magic = 0;
+		refcount->type_magic = 0;
+
+		// Type-specific cleanup
+		switch (type_magic) {
+		case UFBXI_SCENE_IMP_MAGIC: ufbxi_free_scene_imp((ufbxi_scene_imp*)refcount); break;
+		case UFBXI_CACHE_IMP_MAGIC: ufbxi_free_geometry_cache_imp((ufbxi_geometry_cache_imp*)refcount); break;
+		case UFBXI_LOAD_CONTEXT_IMP_MAGIC: ufbxi_free_load_context_imp((ufbxi_load_context_imp*)refcount); break;
+		default: break;
+		}
+
+		// We need to free `data_buf` last and be careful to copy it to
+		// the stack since the `ufbxi_refcount` that contains it is allocated
+		// from the same result buffer!
+		ufbxi_allocator ator = refcount->ator;
+		ufbxi_buf buf = refcount->buf;
+		buf.ator = &ator;
+		ufbxi_buf_free(&buf);
+		ufbxi_free_ator(&ator);
+
+		refcount = parent;
+	}
+}
+
+// -- Scene snapshot
+//
+// Snapshots are created by walking the scene using generated type tables that
+// describe where the pointers are in each public struct. All the memory ranges
+// reachable from the scene are merged and copied into a single blob and all the
+// pointers are replaced with offsets into it. A relocation table lists every
+// pointer so loading is a single read followed by adding the base address.
+
+#if UFBXI_FEATURE_SCENE_SNAPSHOT
+
+typedef enum {
+	UFBXI_SNAPSHOT_FIELD_INLINE, // < Nested struct `type`
+	UFBXI_SNAPSHOT_FIELD_PTR,    // < Pointer to a single `type`, elements are resolved dynamically
+	UFBXI_SNAPSHOT_FIELD_LIST,   // < `UFBX_LIST_TYPE()` containing `type`
+	UFBXI_SNAPSHOT_FIELD_VALUES, // < `UFBXI_SNAPSHOT_FIELD_LIST` with a zero value before `data`, see `ufbx_vertex_attrib`
+	UFBXI_SNAPSHOT_FIELD_STRING, // < `ufbx_string`, including the NULL terminator
+	UFBXI_SNAPSHOT_FIELD_BLOB,   // < `ufbx_blob`
+} ufbxi_snapshot_field_kind;
+
+typedef struct {
+	uint32_t offset;
+	uint8_t kind;
+	uint16_t type;
+	uint32_t count;
+} ufbxi_snapshot_field;
+
+typedef struct {
+	size_t size;
+	const ufbxi_snapshot_field *fields;
+	size_t num_fields;
+	bool is_element;
+} ufbxi_snapshot_type;
+
+// Generated by `misc/gen_snapshot_types.py`
+
+typedef enum {
+	UFBXI_SNAPSHOT_TYPE_WARNING,
+	UFBXI_SNAPSHOT_TYPE_PROP,
+	UFBXI_SNAPSHOT_TYPE_PROPS,
+	UFBXI_SNAPSHOT_TYPE_APPLICATION,
+	UFBXI_SNAPSHOT_TYPE_THUMBNAIL,
+	UFBXI_SNAPSHOT_TYPE_METADATA,
+	UFBXI_SNAPSHOT_TYPE_SCENE_SETTINGS,
+	UFBXI_SNAPSHOT_TYPE_NODE_PTR,
+	UFBXI_SNAPSHOT_TYPE_CONNECTION,
+	UFBXI_SNAPSHOT_TYPE_DOM_NODE_PTR,
+	UFBXI_SNAPSHOT_TYPE_DOM_VALUE,
+	UFBXI_SNAPSHOT_TYPE_DOM_NODE,
+	UFBXI_SNAPSHOT_TYPE_ELEMENT,
+	UFBXI_SNAPSHOT_TYPE_FACE,
+	UFBXI_SNAPSHOT_TYPE_BOOL,
+	UFBXI_SNAPSHOT_TYPE_UINT32,
+	UFBXI_SNAPSHOT_TYPE_EDGE,
+	UFBXI_SNAPSHOT_TYPE_REAL,
+	UFBXI_SNAPSHOT_TYPE_VEC3,
+	UFBXI_SNAPSHOT_TYPE_TOPO_EDGE,
+	UFBXI_SNAPSHOT_TYPE_VERTEX_VEC3,
+	UFBXI_SNAPSHOT_TYPE_VEC2,
+	UFBXI_SNAPSHOT_TYPE_VERTEX_VEC2,
+	UFBXI_SNAPSHOT_TYPE_VEC4,
+	UFBXI_SNAPSHOT_TYPE_VERTEX_VEC4,
+	UFBXI_SNAPSHOT_TYPE_VERTEX_REAL,
+	UFBXI_SNAPSHOT_TYPE_UV_SET,
+	UFBXI_SNAPSHOT_TYPE_COLOR_SET,
+	UFBXI_SNAPSHOT_TYPE_VIDEO,
+	UFBXI_SNAPSHOT_TYPE_TEXTURE_LAYER,
+	UFBXI_SNAPSHOT_TYPE_SHADER_TEXTURE_INPUT,
+	UFBXI_SNAPSHOT_TYPE_SHADER_TEXTURE,
+	UFBXI_SNAPSHOT_TYPE_TEXTURE_PTR,
+	UFBXI_SNAPSHOT_TYPE_TEXTURE,
+	UFBXI_SNAPSHOT_TYPE_MATERIAL_MAP,
+	UFBXI_SNAPSHOT_TYPE_MATERIAL_FBX_MAPS,
+	UFBXI_SNAPSHOT_TYPE_MATERIAL_PBR_MAPS,
+	UFBXI_SNAPSHOT_TYPE_SHADER_PROP_BINDING,
+	UFBXI_SNAPSHOT_TYPE_SHADER_BINDING,
+	UFBXI_SNAPSHOT_TYPE_SHADER_BINDING_PTR,
+	UFBXI_SNAPSHOT_TYPE_SHADER,
+	UFBXI_SNAPSHOT_TYPE_MATERIAL_TEXTURE,
+	UFBXI_SNAPSHOT_TYPE_MATERIAL,
+	UFBXI_SNAPSHOT_TYPE_MATERIAL_PTR,
+	UFBXI_SNAPSHOT_TYPE_FACE_GROUP,
+	UFBXI_SNAPSHOT_TYPE_MESH_PART,
+	UFBXI_SNAPSHOT_TYPE_SKIN_CLUSTER,
+	UFBXI_SNAPSHOT_TYPE_SKIN_CLUSTER_PTR,
+	UFBXI_SNAPSHOT_TYPE_SKIN_VERTEX,
+	UFBXI_SNAPSHOT_TYPE_SKIN_WEIGHT,
+	UFBXI_SNAPSHOT_TYPE_SKIN_DEFORMER,
+	UFBXI_SNAPSHOT_TYPE_SKIN_DEFORMER_PTR,
+	UFBXI_SNAPSHOT_TYPE_BLEND_SHAPE,
+	UFBXI_SNAPSHOT_TYPE_BLEND_KEYFRAME,
+	UFBXI_SNAPSHOT_TYPE_BLEND_CHANNEL,
+	UFBXI_SNAPSHOT_TYPE_BLEND_CHANNEL_PTR,
+	UFBXI_SNAPSHOT_TYPE_BLEND_DEFORMER,
+	UFBXI_SNAPSHOT_TYPE_BLEND_DEFORMER_PTR,
+	UFBXI_SNAPSHOT_TYPE_CACHE_FRAME,
+	UFBXI_SNAPSHOT_TYPE_CACHE_CHANNEL,
+	UFBXI_SNAPSHOT_TYPE_STRING,
+	UFBXI_SNAPSHOT_TYPE_GEOMETRY_CACHE,
+	UFBXI_SNAPSHOT_TYPE_CACHE_FILE,
+	UFBXI_SNAPSHOT_TYPE_CACHE_DEFORMER,
+	UFBXI_SNAPSHOT_TYPE_CACHE_DEFORMER_PTR,
+	UFBXI_SNAPSHOT_TYPE_ELEMENT_PTR,
+	UFBXI_SNAPSHOT_TYPE_SUBDIVISION_WEIGHT_RANGE,
+	UFBXI_SNAPSHOT_TYPE_SUBDIVISION_WEIGHT,
+	UFBXI_SNAPSHOT_TYPE_SUBDIVISION_RESULT,
+	UFBXI_SNAPSHOT_TYPE_MESH,
+	UFBXI_SNAPSHOT_TYPE_LIGHT,
+	UFBXI_SNAPSHOT_TYPE_CAMERA,
+	UFBXI_SNAPSHOT_TYPE_NODE,
+	UFBXI_SNAPSHOT_TYPE_KEYFRAME,
+	UFBXI_SNAPSHOT_TYPE_ANIM_CURVE,
+	UFBXI_SNAPSHOT_TYPE_ANIM_VALUE,
+	UFBXI_SNAPSHOT_TYPE_ANIM_VALUE_PTR,
+	UFBXI_SNAPSHOT_TYPE_ANIM_PROP,
+	UFBXI_SNAPSHOT_TYPE_ANIM_LAYER,
+	UFBXI_SNAPSHOT_TYPE_ANIM_LAYER_PTR,
+	UFBXI_SNAPSHOT_TYPE_PROP_OVERRIDE,
+	UFBXI_SNAPSHOT_TYPE_TRANSFORM_OVERRIDE,
+	UFBXI_SNAPSHOT_TYPE_ANIM,
+	UFBXI_SNAPSHOT_TYPE_UNKNOWN,
+	UFBXI_SNAPSHOT_TYPE_UNKNOWN_PTR,
+	UFBXI_SNAPSHOT_TYPE_MESH_PTR,
+	UFBXI_SNAPSHOT_TYPE_LIGHT_PTR,
+	UFBXI_SNAPSHOT_TYPE_CAMERA_PTR,
+	UFBXI_SNAPSHOT_TYPE_BONE,
+	UFBXI_SNAPSHOT_TYPE_BONE_PTR,
+	UFBXI_SNAPSHOT_TYPE_EMPTY,
+	UFBXI_SNAPSHOT_TYPE_EMPTY_PTR,
+	UFBXI_SNAPSHOT_TYPE_LINE_SEGMENT,
+	UFBXI_SNAPSHOT_TYPE_LINE_CURVE,
+	UFBXI_SNAPSHOT_TYPE_LINE_CURVE_PTR,
+	UFBXI_SNAPSHOT_TYPE_NURBS_BASIS,
+	UFBXI_SNAPSHOT_TYPE_NURBS_CURVE,
+	UFBXI_SNAPSHOT_TYPE_NURBS_CURVE_PTR,
+	UFBXI_SNAPSHOT_TYPE_NURBS_SURFACE,
+	UFBXI_SNAPSHOT_TYPE_NURBS_SURFACE_PTR,
+	UFBXI_SNAPSHOT_TYPE_NURBS_TRIM_SURFACE,
+	UFBXI_SNAPSHOT_TYPE_NURBS_TRIM_SURFACE_PTR,
+	UFBXI_SNAPSHOT_TYPE_NURBS_TRIM_BOUNDARY,
+	UFBXI_SNAPSHOT_TYPE_NURBS_TRIM_BOUNDARY_PTR,
+	UFBXI_SNAPSHOT_TYPE_PROCEDURAL_GEOMETRY,
+	UFBXI_SNAPSHOT_TYPE_PROCEDURAL_GEOMETRY_PTR,
+	UFBXI_SNAPSHOT_TYPE_STEREO_CAMERA,
+	UFBXI_SNAPSHOT_TYPE_STEREO_CAMERA_PTR,
+	UFBXI_SNAPSHOT_TYPE_CAMERA_SWITCHER,
+	UFBXI_SNAPSHOT_TYPE_CAMERA_SWITCHER_PTR,
+	UFBXI_SNAPSHOT_TYPE_MARKER,
+	UFBXI_SNAPSHOT_TYPE_MARKER_PTR,
+	UFBXI_SNAPSHOT_TYPE_LOD_LEVEL,
+	UFBXI_SNAPSHOT_TYPE_LOD_GROUP,
+	UFBXI_SNAPSHOT_TYPE_LOD_GROUP_PTR,
+	UFBXI_SNAPSHOT_TYPE_BLEND_SHAPE_PTR,
+	UFBXI_SNAPSHOT_TYPE_CACHE_FILE_PTR,
+	UFBXI_SNAPSHOT_TYPE_VIDEO_PTR,
+	UFBXI_SNAPSHOT_TYPE_SHADER_PTR,
+	UFBXI_SNAPSHOT_TYPE_ANIM_STACK,
+	UFBXI_SNAPSHOT_TYPE_ANIM_STACK_PTR,
+	UFBXI_SNAPSHOT_TYPE_ANIM_CURVE_PTR,
+	UFBXI_SNAPSHOT_TYPE_DISPLAY_LAYER,
+	UFBXI_SNAPSHOT_TYPE_DISPLAY_LAYER_PTR,
+	UFBXI_SNAPSHOT_TYPE_SELECTION_NODE,
+	UFBXI_SNAPSHOT_TYPE_SELECTION_NODE_PTR,
+	UFBXI_SNAPSHOT_TYPE_SELECTION_SET,
+	UFBXI_SNAPSHOT_TYPE_SELECTION_SET_PTR,
+	UFBXI_SNAPSHOT_TYPE_CHARACTER,
+	UFBXI_SNAPSHOT_TYPE_CHARACTER_PTR,
+	UFBXI_SNAPSHOT_TYPE_CONSTRAINT_TARGET,
+	UFBXI_SNAPSHOT_TYPE_CONSTRAINT,
+	UFBXI_SNAPSHOT_TYPE_CONSTRAINT_PTR,
+	UFBXI_SNAPSHOT_TYPE_BONE_POSE,
+	UFBXI_SNAPSHOT_TYPE_POSE,
+	UFBXI_SNAPSHOT_TYPE_POSE_PTR,
+	UFBXI_SNAPSHOT_TYPE_METADATA_OBJECT,
+	UFBXI_SNAPSHOT_TYPE_METADATA_OBJECT_PTR,
+	UFBXI_SNAPSHOT_TYPE_TEXTURE_FILE,
+	UFBXI_SNAPSHOT_TYPE_NAME_ELEMENT,
+	UFBXI_SNAPSHOT_TYPE_SCENE,
+	UFBXI_SNAPSHOT_TYPE_COUNT,
+} ufbxi_snapshot_type_id;
+
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_warning[] = {
+	{ (uint32_t)offsetof(ufbx_warning, description), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_prop[] = {
+	{ (uint32_t)offsetof(ufbx_prop, name), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_prop, value_str), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_prop, value_blob), UFBXI_SNAPSHOT_FIELD_BLOB, 0, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_props[] = {
+	{ (uint32_t)offsetof(ufbx_props, props), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_PROP, 1 },
+	{ (uint32_t)offsetof(ufbx_props, defaults), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_PROPS, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_application[] = {
+	{ (uint32_t)offsetof(ufbx_application, vendor), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_application, name), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_application, version), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_thumbnail[] = {
+	{ (uint32_t)offsetof(ufbx_thumbnail, props), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_PROPS, 1 },
+	{ (uint32_t)offsetof(ufbx_thumbnail, data), UFBXI_SNAPSHOT_FIELD_BLOB, 0, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_metadata[] = {
+	{ (uint32_t)offsetof(ufbx_metadata, warnings), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_WARNING, 1 },
+	{ (uint32_t)offsetof(ufbx_metadata, creator), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_metadata, filename), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_metadata, relative_root), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_metadata, raw_filename), UFBXI_SNAPSHOT_FIELD_BLOB, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_metadata, raw_relative_root), UFBXI_SNAPSHOT_FIELD_BLOB, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_metadata, scene_props), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_PROPS, 1 },
+	{ (uint32_t)offsetof(ufbx_metadata, original_application), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_APPLICATION, 1 },
+	{ (uint32_t)offsetof(ufbx_metadata, latest_application), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_APPLICATION, 1 },
+	{ (uint32_t)offsetof(ufbx_metadata, thumbnail), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_THUMBNAIL, 1 },
+	{ (uint32_t)offsetof(ufbx_metadata, original_file_path), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_metadata, raw_original_file_path), UFBXI_SNAPSHOT_FIELD_BLOB, 0, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_scene_settings[] = {
+	{ (uint32_t)offsetof(ufbx_scene_settings, props), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_PROPS, 1 },
+	{ (uint32_t)offsetof(ufbx_scene_settings, default_camera), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_node_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_NODE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_connection[] = {
+	{ (uint32_t)offsetof(ufbx_connection, src), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_connection, dst), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_connection, src_prop), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_connection, dst_prop), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_dom_node_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_DOM_NODE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_dom_value[] = {
+	{ (uint32_t)offsetof(ufbx_dom_value, value_str), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_dom_value, value_blob), UFBXI_SNAPSHOT_FIELD_BLOB, 0, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_dom_node[] = {
+	{ (uint32_t)offsetof(ufbx_dom_node, name), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_dom_node, children), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_DOM_NODE_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_dom_node, values), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_DOM_VALUE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_element[] = {
+	{ (uint32_t)offsetof(ufbx_element, name), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_element, props), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_PROPS, 1 },
+	{ (uint32_t)offsetof(ufbx_element, instances), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_NODE_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_element, connections_src), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_CONNECTION, 1 },
+	{ (uint32_t)offsetof(ufbx_element, connections_dst), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_CONNECTION, 1 },
+	{ (uint32_t)offsetof(ufbx_element, dom_node), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_DOM_NODE, 1 },
+	{ (uint32_t)offsetof(ufbx_element, scene), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_SCENE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_vertex_vec3[] = {
+	{ (uint32_t)offsetof(ufbx_vertex_vec3, values), UFBXI_SNAPSHOT_FIELD_VALUES, UFBXI_SNAPSHOT_TYPE_VEC3, 1 },
+	{ (uint32_t)offsetof(ufbx_vertex_vec3, indices), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_UINT32, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_vertex_vec2[] = {
+	{ (uint32_t)offsetof(ufbx_vertex_vec2, values), UFBXI_SNAPSHOT_FIELD_VALUES, UFBXI_SNAPSHOT_TYPE_VEC2, 1 },
+	{ (uint32_t)offsetof(ufbx_vertex_vec2, indices), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_UINT32, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_vertex_vec4[] = {
+	{ (uint32_t)offsetof(ufbx_vertex_vec4, values), UFBXI_SNAPSHOT_FIELD_VALUES, UFBXI_SNAPSHOT_TYPE_VEC4, 1 },
+	{ (uint32_t)offsetof(ufbx_vertex_vec4, indices), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_UINT32, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_vertex_real[] = {
+	{ (uint32_t)offsetof(ufbx_vertex_real, values), UFBXI_SNAPSHOT_FIELD_VALUES, UFBXI_SNAPSHOT_TYPE_REAL, 1 },
+	{ (uint32_t)offsetof(ufbx_vertex_real, indices), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_UINT32, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_uv_set[] = {
+	{ (uint32_t)offsetof(ufbx_uv_set, name), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_uv_set, vertex_uv), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_VERTEX_VEC2, 1 },
+	{ (uint32_t)offsetof(ufbx_uv_set, vertex_tangent), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_VERTEX_VEC3, 1 },
+	{ (uint32_t)offsetof(ufbx_uv_set, vertex_bitangent), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_VERTEX_VEC3, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_color_set[] = {
+	{ (uint32_t)offsetof(ufbx_color_set, name), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_color_set, vertex_color), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_VERTEX_VEC4, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_video[] = {
+	{ (uint32_t)offsetof(ufbx_video, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_video, filename), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_video, absolute_filename), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_video, relative_filename), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_video, raw_filename), UFBXI_SNAPSHOT_FIELD_BLOB, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_video, raw_absolute_filename), UFBXI_SNAPSHOT_FIELD_BLOB, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_video, raw_relative_filename), UFBXI_SNAPSHOT_FIELD_BLOB, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_video, content), UFBXI_SNAPSHOT_FIELD_BLOB, 0, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_texture_layer[] = {
+	{ (uint32_t)offsetof(ufbx_texture_layer, texture), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_TEXTURE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_shader_texture_input[] = {
+	{ (uint32_t)offsetof(ufbx_shader_texture_input, name), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_shader_texture_input, value_str), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_shader_texture_input, value_blob), UFBXI_SNAPSHOT_FIELD_BLOB, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_shader_texture_input, texture), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_TEXTURE, 1 },
+	{ (uint32_t)offsetof(ufbx_shader_texture_input, prop), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_PROP, 1 },
+	{ (uint32_t)offsetof(ufbx_shader_texture_input, texture_prop), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_PROP, 1 },
+	{ (uint32_t)offsetof(ufbx_shader_texture_input, texture_enabled_prop), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_PROP, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_shader_texture[] = {
+	{ (uint32_t)offsetof(ufbx_shader_texture, shader_name), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_shader_texture, inputs), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_SHADER_TEXTURE_INPUT, 1 },
+	{ (uint32_t)offsetof(ufbx_shader_texture, shader_source), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_shader_texture, raw_shader_source), UFBXI_SNAPSHOT_FIELD_BLOB, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_shader_texture, main_texture), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_TEXTURE, 1 },
+	{ (uint32_t)offsetof(ufbx_shader_texture, prop_prefix), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_texture_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_TEXTURE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_texture[] = {
+	{ (uint32_t)offsetof(ufbx_texture, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_texture, filename), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_texture, absolute_filename), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_texture, relative_filename), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_texture, raw_filename), UFBXI_SNAPSHOT_FIELD_BLOB, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_texture, raw_absolute_filename), UFBXI_SNAPSHOT_FIELD_BLOB, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_texture, raw_relative_filename), UFBXI_SNAPSHOT_FIELD_BLOB, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_texture, content), UFBXI_SNAPSHOT_FIELD_BLOB, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_texture, video), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_VIDEO, 1 },
+	{ (uint32_t)offsetof(ufbx_texture, layers), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_TEXTURE_LAYER, 1 },
+	{ (uint32_t)offsetof(ufbx_texture, shader), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_SHADER_TEXTURE, 1 },
+	{ (uint32_t)offsetof(ufbx_texture, file_textures), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_TEXTURE_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_texture, uv_set), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_material_map[] = {
+	{ (uint32_t)offsetof(ufbx_material_map, texture), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_TEXTURE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_material_fbx_maps[] = {
+	{ (uint32_t)offsetof(ufbx_material_fbx_maps, maps), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_MATERIAL_MAP, UFBX_MATERIAL_FBX_MAP_COUNT },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_material_pbr_maps[] = {
+	{ (uint32_t)offsetof(ufbx_material_pbr_maps, maps), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_MATERIAL_MAP, UFBX_MATERIAL_PBR_MAP_COUNT },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_shader_prop_binding[] = {
+	{ (uint32_t)offsetof(ufbx_shader_prop_binding, shader_prop), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_shader_prop_binding, material_prop), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_shader_binding[] = {
+	{ (uint32_t)offsetof(ufbx_shader_binding, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_shader_binding, prop_bindings), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_SHADER_PROP_BINDING, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_shader_binding_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_SHADER_BINDING, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_shader[] = {
+	{ (uint32_t)offsetof(ufbx_shader, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_shader, bindings), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_SHADER_BINDING_PTR, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_material_texture[] = {
+	{ (uint32_t)offsetof(ufbx_material_texture, material_prop), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_material_texture, shader_prop), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_material_texture, texture), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_TEXTURE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_material[] = {
+	{ (uint32_t)offsetof(ufbx_material, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_material, fbx), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_MATERIAL_FBX_MAPS, 1 },
+	{ (uint32_t)offsetof(ufbx_material, pbr), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_MATERIAL_PBR_MAPS, 1 },
+	{ (uint32_t)offsetof(ufbx_material, shader), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_SHADER, 1 },
+	{ (uint32_t)offsetof(ufbx_material, shading_model_name), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_material, shader_prop_prefix), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_material, textures), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_MATERIAL_TEXTURE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_material_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_MATERIAL, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_face_group[] = {
+	{ (uint32_t)offsetof(ufbx_face_group, name), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_mesh_part[] = {
+	{ (uint32_t)offsetof(ufbx_mesh_part, face_indices), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_UINT32, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_skin_cluster[] = {
+	{ (uint32_t)offsetof(ufbx_skin_cluster, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_skin_cluster, bone_node), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_NODE, 1 },
+	{ (uint32_t)offsetof(ufbx_skin_cluster, vertices), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_UINT32, 1 },
+	{ (uint32_t)offsetof(ufbx_skin_cluster, weights), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_REAL, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_skin_cluster_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_SKIN_CLUSTER, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_skin_deformer[] = {
+	{ (uint32_t)offsetof(ufbx_skin_deformer, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_skin_deformer, clusters), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_SKIN_CLUSTER_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_skin_deformer, vertices), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_SKIN_VERTEX, 1 },
+	{ (uint32_t)offsetof(ufbx_skin_deformer, weights), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_SKIN_WEIGHT, 1 },
+	{ (uint32_t)offsetof(ufbx_skin_deformer, dq_vertices), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_UINT32, 1 },
+	{ (uint32_t)offsetof(ufbx_skin_deformer, dq_weights), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_REAL, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_skin_deformer_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_SKIN_DEFORMER, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_blend_shape[] = {
+	{ (uint32_t)offsetof(ufbx_blend_shape, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_blend_shape, offset_vertices), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_UINT32, 1 },
+	{ (uint32_t)offsetof(ufbx_blend_shape, position_offsets), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_VEC3, 1 },
+	{ (uint32_t)offsetof(ufbx_blend_shape, normal_offsets), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_VEC3, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_blend_keyframe[] = {
+	{ (uint32_t)offsetof(ufbx_blend_keyframe, shape), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_BLEND_SHAPE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_blend_channel[] = {
+	{ (uint32_t)offsetof(ufbx_blend_channel, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_blend_channel, keyframes), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_BLEND_KEYFRAME, 1 },
+	{ (uint32_t)offsetof(ufbx_blend_channel, target_shape), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_BLEND_SHAPE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_blend_channel_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_BLEND_CHANNEL, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_blend_deformer[] = {
+	{ (uint32_t)offsetof(ufbx_blend_deformer, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_blend_deformer, channels), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_BLEND_CHANNEL_PTR, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_blend_deformer_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_BLEND_DEFORMER, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_cache_frame[] = {
+	{ (uint32_t)offsetof(ufbx_cache_frame, channel), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_cache_frame, filename), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_cache_channel[] = {
+	{ (uint32_t)offsetof(ufbx_cache_channel, name), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_cache_channel, interpretation_name), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_cache_channel, frames), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_CACHE_FRAME, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_string[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_geometry_cache[] = {
+	{ (uint32_t)offsetof(ufbx_geometry_cache, root_filename), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_geometry_cache, channels), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_CACHE_CHANNEL, 1 },
+	{ (uint32_t)offsetof(ufbx_geometry_cache, frames), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_CACHE_FRAME, 1 },
+	{ (uint32_t)offsetof(ufbx_geometry_cache, extra_info), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_STRING, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_cache_file[] = {
+	{ (uint32_t)offsetof(ufbx_cache_file, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_cache_file, filename), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_cache_file, absolute_filename), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_cache_file, relative_filename), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_cache_file, raw_filename), UFBXI_SNAPSHOT_FIELD_BLOB, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_cache_file, raw_absolute_filename), UFBXI_SNAPSHOT_FIELD_BLOB, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_cache_file, raw_relative_filename), UFBXI_SNAPSHOT_FIELD_BLOB, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_cache_file, external_cache), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_GEOMETRY_CACHE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_cache_deformer[] = {
+	{ (uint32_t)offsetof(ufbx_cache_deformer, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_cache_deformer, channel), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_cache_deformer, file), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_CACHE_FILE, 1 },
+	{ (uint32_t)offsetof(ufbx_cache_deformer, external_cache), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_GEOMETRY_CACHE, 1 },
+	{ (uint32_t)offsetof(ufbx_cache_deformer, external_channel), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_CACHE_CHANNEL, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_cache_deformer_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_CACHE_DEFORMER, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_element_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_subdivision_result[] = {
+	{ (uint32_t)offsetof(ufbx_subdivision_result, source_vertex_ranges), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_SUBDIVISION_WEIGHT_RANGE, 1 },
+	{ (uint32_t)offsetof(ufbx_subdivision_result, source_vertex_weights), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_SUBDIVISION_WEIGHT, 1 },
+	{ (uint32_t)offsetof(ufbx_subdivision_result, skin_cluster_ranges), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_SUBDIVISION_WEIGHT_RANGE, 1 },
+	{ (uint32_t)offsetof(ufbx_subdivision_result, skin_cluster_weights), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_SUBDIVISION_WEIGHT, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_mesh[] = {
+	{ (uint32_t)offsetof(ufbx_mesh, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, faces), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_FACE, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, face_smoothing), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_BOOL, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, face_material), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_UINT32, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, face_group), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_UINT32, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, face_hole), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_BOOL, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, edges), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_EDGE, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, edge_smoothing), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_BOOL, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, edge_crease), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_REAL, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, edge_visibility), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_BOOL, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, vertex_indices), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_UINT32, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, vertices), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_VEC3, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, vertex_first_index), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_UINT32, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, triangle_indices), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_UINT32, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, topology), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_TOPO_EDGE, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, vertex_position), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_VERTEX_VEC3, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, vertex_normal), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_VERTEX_VEC3, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, vertex_uv), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_VERTEX_VEC2, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, vertex_tangent), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_VERTEX_VEC3, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, vertex_bitangent), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_VERTEX_VEC3, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, vertex_color), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_VERTEX_VEC4, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, vertex_crease), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_VERTEX_REAL, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, uv_sets), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_UV_SET, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, color_sets), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_COLOR_SET, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, materials), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_MATERIAL_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, face_groups), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_FACE_GROUP, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, material_parts), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_MESH_PART, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, face_group_parts), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_MESH_PART, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, skinned_position), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_VERTEX_VEC3, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, skinned_normal), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_VERTEX_VEC3, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, skin_deformers), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_SKIN_DEFORMER_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, blend_deformers), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_BLEND_DEFORMER_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, cache_deformers), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_CACHE_DEFORMER_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, all_deformers), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_ELEMENT_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_mesh, subdivision_result), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_SUBDIVISION_RESULT, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_light[] = {
+	{ (uint32_t)offsetof(ufbx_light, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_camera[] = {
+	{ (uint32_t)offsetof(ufbx_camera, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_node[] = {
+	{ (uint32_t)offsetof(ufbx_node, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_node, parent), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_NODE, 1 },
+	{ (uint32_t)offsetof(ufbx_node, children), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_NODE_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_node, mesh), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_MESH, 1 },
+	{ (uint32_t)offsetof(ufbx_node, light), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_LIGHT, 1 },
+	{ (uint32_t)offsetof(ufbx_node, camera), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_CAMERA, 1 },
+	{ (uint32_t)offsetof(ufbx_node, attrib), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_node, geometry_transform_helper), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_NODE, 1 },
+	{ (uint32_t)offsetof(ufbx_node, scale_helper), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_NODE, 1 },
+	{ (uint32_t)offsetof(ufbx_node, all_attribs), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_ELEMENT_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_node, inherit_scale_node), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_NODE, 1 },
+	{ (uint32_t)offsetof(ufbx_node, materials), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_MATERIAL_PTR, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_anim_curve[] = {
+	{ (uint32_t)offsetof(ufbx_anim_curve, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_anim_curve, keyframes), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_KEYFRAME, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_anim_value[] = {
+	{ (uint32_t)offsetof(ufbx_anim_value, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_anim_value, curves), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_ANIM_CURVE, 3 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_anim_value_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_ANIM_VALUE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_anim_prop[] = {
+	{ (uint32_t)offsetof(ufbx_anim_prop, element), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_anim_prop, prop_name), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_anim_prop, anim_value), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_ANIM_VALUE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_anim_layer[] = {
+	{ (uint32_t)offsetof(ufbx_anim_layer, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_anim_layer, anim_values), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_ANIM_VALUE_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_anim_layer, anim_props), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_ANIM_PROP, 1 },
+	{ (uint32_t)offsetof(ufbx_anim_layer, anim), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_ANIM, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_anim_layer_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_ANIM_LAYER, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_prop_override[] = {
+	{ (uint32_t)offsetof(ufbx_prop_override, prop_name), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_prop_override, value_str), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_anim[] = {
+	{ (uint32_t)offsetof(ufbx_anim, layers), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_ANIM_LAYER_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_anim, override_layer_weights), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_REAL, 1 },
+	{ (uint32_t)offsetof(ufbx_anim, prop_overrides), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_PROP_OVERRIDE, 1 },
+	{ (uint32_t)offsetof(ufbx_anim, transform_overrides), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_TRANSFORM_OVERRIDE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_unknown[] = {
+	{ (uint32_t)offsetof(ufbx_unknown, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_unknown, type), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_unknown, super_type), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_unknown, sub_type), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_unknown_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_UNKNOWN, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_mesh_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_MESH, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_light_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_LIGHT, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_camera_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_CAMERA, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_bone[] = {
+	{ (uint32_t)offsetof(ufbx_bone, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_bone_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_BONE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_empty[] = {
+	{ (uint32_t)offsetof(ufbx_empty, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_empty_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_EMPTY, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_line_curve[] = {
+	{ (uint32_t)offsetof(ufbx_line_curve, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_line_curve, control_points), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_VEC3, 1 },
+	{ (uint32_t)offsetof(ufbx_line_curve, point_indices), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_UINT32, 1 },
+	{ (uint32_t)offsetof(ufbx_line_curve, segments), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_LINE_SEGMENT, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_line_curve_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_LINE_CURVE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_nurbs_basis[] = {
+	{ (uint32_t)offsetof(ufbx_nurbs_basis, knot_vector), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_REAL, 1 },
+	{ (uint32_t)offsetof(ufbx_nurbs_basis, spans), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_REAL, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_nurbs_curve[] = {
+	{ (uint32_t)offsetof(ufbx_nurbs_curve, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_nurbs_curve, basis), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_NURBS_BASIS, 1 },
+	{ (uint32_t)offsetof(ufbx_nurbs_curve, control_points), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_VEC4, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_nurbs_curve_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_NURBS_CURVE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_nurbs_surface[] = {
+	{ (uint32_t)offsetof(ufbx_nurbs_surface, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_nurbs_surface, basis_u), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_NURBS_BASIS, 1 },
+	{ (uint32_t)offsetof(ufbx_nurbs_surface, basis_v), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_NURBS_BASIS, 1 },
+	{ (uint32_t)offsetof(ufbx_nurbs_surface, control_points), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_VEC4, 1 },
+	{ (uint32_t)offsetof(ufbx_nurbs_surface, material), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_MATERIAL, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_nurbs_surface_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_NURBS_SURFACE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_nurbs_trim_surface[] = {
+	{ (uint32_t)offsetof(ufbx_nurbs_trim_surface, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_nurbs_trim_surface_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_NURBS_TRIM_SURFACE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_nurbs_trim_boundary[] = {
+	{ (uint32_t)offsetof(ufbx_nurbs_trim_boundary, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_nurbs_trim_boundary_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_NURBS_TRIM_BOUNDARY, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_procedural_geometry[] = {
+	{ (uint32_t)offsetof(ufbx_procedural_geometry, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_procedural_geometry_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_PROCEDURAL_GEOMETRY, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_stereo_camera[] = {
+	{ (uint32_t)offsetof(ufbx_stereo_camera, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_stereo_camera, left), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_CAMERA, 1 },
+	{ (uint32_t)offsetof(ufbx_stereo_camera, right), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_CAMERA, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_stereo_camera_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_STEREO_CAMERA, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_camera_switcher[] = {
+	{ (uint32_t)offsetof(ufbx_camera_switcher, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_camera_switcher_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_CAMERA_SWITCHER, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_marker[] = {
+	{ (uint32_t)offsetof(ufbx_marker, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_marker_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_MARKER, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_lod_group[] = {
+	{ (uint32_t)offsetof(ufbx_lod_group, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_lod_group, lod_levels), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_LOD_LEVEL, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_lod_group_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_LOD_GROUP, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_blend_shape_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_BLEND_SHAPE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_cache_file_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_CACHE_FILE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_video_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_VIDEO, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_shader_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_SHADER, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_anim_stack[] = {
+	{ (uint32_t)offsetof(ufbx_anim_stack, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_anim_stack, layers), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_ANIM_LAYER_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_anim_stack, anim), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_ANIM, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_anim_stack_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_ANIM_STACK, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_anim_curve_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_ANIM_CURVE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_display_layer[] = {
+	{ (uint32_t)offsetof(ufbx_display_layer, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_display_layer, nodes), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_NODE_PTR, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_display_layer_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_DISPLAY_LAYER, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_selection_node[] = {
+	{ (uint32_t)offsetof(ufbx_selection_node, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_selection_node, target_node), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_NODE, 1 },
+	{ (uint32_t)offsetof(ufbx_selection_node, target_mesh), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_MESH, 1 },
+	{ (uint32_t)offsetof(ufbx_selection_node, vertices), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_UINT32, 1 },
+	{ (uint32_t)offsetof(ufbx_selection_node, edges), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_UINT32, 1 },
+	{ (uint32_t)offsetof(ufbx_selection_node, faces), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_UINT32, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_selection_node_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_SELECTION_NODE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_selection_set[] = {
+	{ (uint32_t)offsetof(ufbx_selection_set, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_selection_set, nodes), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_SELECTION_NODE_PTR, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_selection_set_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_SELECTION_SET, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_character[] = {
+	{ (uint32_t)offsetof(ufbx_character, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_character_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_CHARACTER, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_constraint_target[] = {
+	{ (uint32_t)offsetof(ufbx_constraint_target, node), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_NODE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_constraint[] = {
+	{ (uint32_t)offsetof(ufbx_constraint, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_constraint, type_name), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_constraint, node), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_NODE, 1 },
+	{ (uint32_t)offsetof(ufbx_constraint, targets), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_CONSTRAINT_TARGET, 1 },
+	{ (uint32_t)offsetof(ufbx_constraint, aim_up_node), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_NODE, 1 },
+	{ (uint32_t)offsetof(ufbx_constraint, ik_effector), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_NODE, 1 },
+	{ (uint32_t)offsetof(ufbx_constraint, ik_end_node), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_NODE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_constraint_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_CONSTRAINT, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_bone_pose[] = {
+	{ (uint32_t)offsetof(ufbx_bone_pose, bone_node), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_NODE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_pose[] = {
+	{ (uint32_t)offsetof(ufbx_pose, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_pose, bone_poses), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_BONE_POSE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_pose_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_POSE, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_metadata_object[] = {
+	{ (uint32_t)offsetof(ufbx_metadata_object, element), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_metadata_object_ptr[] = {
+	{ (uint32_t)0, UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_METADATA_OBJECT, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_texture_file[] = {
+	{ (uint32_t)offsetof(ufbx_texture_file, filename), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_texture_file, absolute_filename), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_texture_file, relative_filename), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_texture_file, raw_filename), UFBXI_SNAPSHOT_FIELD_BLOB, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_texture_file, raw_absolute_filename), UFBXI_SNAPSHOT_FIELD_BLOB, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_texture_file, raw_relative_filename), UFBXI_SNAPSHOT_FIELD_BLOB, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_texture_file, content), UFBXI_SNAPSHOT_FIELD_BLOB, 0, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_name_element[] = {
+	{ (uint32_t)offsetof(ufbx_name_element, name), UFBXI_SNAPSHOT_FIELD_STRING, 0, 1 },
+	{ (uint32_t)offsetof(ufbx_name_element, element), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_ELEMENT, 1 },
+};
+static const ufbxi_snapshot_field ufbxi_snapshot_fields_scene[] = {
+	{ (uint32_t)offsetof(ufbx_scene, metadata), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_METADATA, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, settings), UFBXI_SNAPSHOT_FIELD_INLINE, UFBXI_SNAPSHOT_TYPE_SCENE_SETTINGS, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, root_node), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_NODE, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, anim), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_ANIM, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, unknowns), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_UNKNOWN_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, nodes), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_NODE_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, meshes), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_MESH_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, lights), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_LIGHT_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, cameras), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_CAMERA_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, bones), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_BONE_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, empties), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_EMPTY_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, line_curves), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_LINE_CURVE_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, nurbs_curves), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_NURBS_CURVE_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, nurbs_surfaces), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_NURBS_SURFACE_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, nurbs_trim_surfaces), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_NURBS_TRIM_SURFACE_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, nurbs_trim_boundaries), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_NURBS_TRIM_BOUNDARY_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, procedural_geometries), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_PROCEDURAL_GEOMETRY_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, stereo_cameras), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_STEREO_CAMERA_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, camera_switchers), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_CAMERA_SWITCHER_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, markers), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_MARKER_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, lod_groups), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_LOD_GROUP_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, skin_deformers), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_SKIN_DEFORMER_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, skin_clusters), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_SKIN_CLUSTER_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, blend_deformers), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_BLEND_DEFORMER_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, blend_channels), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_BLEND_CHANNEL_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, blend_shapes), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_BLEND_SHAPE_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, cache_deformers), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_CACHE_DEFORMER_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, cache_files), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_CACHE_FILE_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, materials), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_MATERIAL_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, textures), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_TEXTURE_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, videos), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_VIDEO_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, shaders), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_SHADER_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, shader_bindings), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_SHADER_BINDING_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, anim_stacks), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_ANIM_STACK_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, anim_layers), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_ANIM_LAYER_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, anim_values), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_ANIM_VALUE_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, anim_curves), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_ANIM_CURVE_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, display_layers), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_DISPLAY_LAYER_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, selection_sets), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_SELECTION_SET_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, selection_nodes), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_SELECTION_NODE_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, characters), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_CHARACTER_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, constraints), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_CONSTRAINT_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, poses), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_POSE_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, metadata_objects), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_METADATA_OBJECT_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, texture_files), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_TEXTURE_FILE, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, elements), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_ELEMENT_PTR, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, connections_src), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_CONNECTION, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, connections_dst), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_CONNECTION, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, elements_by_name), UFBXI_SNAPSHOT_FIELD_LIST, UFBXI_SNAPSHOT_TYPE_NAME_ELEMENT, 1 },
+	{ (uint32_t)offsetof(ufbx_scene, dom_root), UFBXI_SNAPSHOT_FIELD_PTR, UFBXI_SNAPSHOT_TYPE_DOM_NODE, 1 },
+};
+
+static const ufbxi_snapshot_type ufbxi_snapshot_types[] = {
+	{ sizeof(ufbx_warning), ufbxi_snapshot_fields_warning, ufbxi_arraycount(ufbxi_snapshot_fields_warning), false },
+	{ sizeof(ufbx_prop), ufbxi_snapshot_fields_prop, ufbxi_arraycount(ufbxi_snapshot_fields_prop), false },
+	{ sizeof(ufbx_props), ufbxi_snapshot_fields_props, ufbxi_arraycount(ufbxi_snapshot_fields_props), false },
+	{ sizeof(ufbx_application), ufbxi_snapshot_fields_application, ufbxi_arraycount(ufbxi_snapshot_fields_application), false },
+	{ sizeof(ufbx_thumbnail), ufbxi_snapshot_fields_thumbnail, ufbxi_arraycount(ufbxi_snapshot_fields_thumbnail), false },
+	{ sizeof(ufbx_metadata), ufbxi_snapshot_fields_metadata, ufbxi_arraycount(ufbxi_snapshot_fields_metadata), false },
+	{ sizeof(ufbx_scene_settings), ufbxi_snapshot_fields_scene_settings, ufbxi_arraycount(ufbxi_snapshot_fields_scene_settings), false },
+	{ sizeof(ufbx_node*), ufbxi_snapshot_fields_node_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_node_ptr), false },
+	{ sizeof(ufbx_connection), ufbxi_snapshot_fields_connection, ufbxi_arraycount(ufbxi_snapshot_fields_connection), false },
+	{ sizeof(ufbx_dom_node*), ufbxi_snapshot_fields_dom_node_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_dom_node_ptr), false },
+	{ sizeof(ufbx_dom_value), ufbxi_snapshot_fields_dom_value, ufbxi_arraycount(ufbxi_snapshot_fields_dom_value), false },
+	{ sizeof(ufbx_dom_node), ufbxi_snapshot_fields_dom_node, ufbxi_arraycount(ufbxi_snapshot_fields_dom_node), false },
+	{ sizeof(ufbx_element), ufbxi_snapshot_fields_element, ufbxi_arraycount(ufbxi_snapshot_fields_element), true },
+	{ sizeof(ufbx_face), NULL, 0, false },
+	{ sizeof(bool), NULL, 0, false },
+	{ sizeof(uint32_t), NULL, 0, false },
+	{ sizeof(ufbx_edge), NULL, 0, false },
+	{ sizeof(ufbx_real), NULL, 0, false },
+	{ sizeof(ufbx_vec3), NULL, 0, false },
+	{ sizeof(ufbx_topo_edge), NULL, 0, false },
+	{ sizeof(ufbx_vertex_vec3), ufbxi_snapshot_fields_vertex_vec3, ufbxi_arraycount(ufbxi_snapshot_fields_vertex_vec3), false },
+	{ sizeof(ufbx_vec2), NULL, 0, false },
+	{ sizeof(ufbx_vertex_vec2), ufbxi_snapshot_fields_vertex_vec2, ufbxi_arraycount(ufbxi_snapshot_fields_vertex_vec2), false },
+	{ sizeof(ufbx_vec4), NULL, 0, false },
+	{ sizeof(ufbx_vertex_vec4), ufbxi_snapshot_fields_vertex_vec4, ufbxi_arraycount(ufbxi_snapshot_fields_vertex_vec4), false },
+	{ sizeof(ufbx_vertex_real), ufbxi_snapshot_fields_vertex_real, ufbxi_arraycount(ufbxi_snapshot_fields_vertex_real), false },
+	{ sizeof(ufbx_uv_set), ufbxi_snapshot_fields_uv_set, ufbxi_arraycount(ufbxi_snapshot_fields_uv_set), false },
+	{ sizeof(ufbx_color_set), ufbxi_snapshot_fields_color_set, ufbxi_arraycount(ufbxi_snapshot_fields_color_set), false },
+	{ sizeof(ufbx_video), ufbxi_snapshot_fields_video, ufbxi_arraycount(ufbxi_snapshot_fields_video), true },
+	{ sizeof(ufbx_texture_layer), ufbxi_snapshot_fields_texture_layer, ufbxi_arraycount(ufbxi_snapshot_fields_texture_layer), false },
+	{ sizeof(ufbx_shader_texture_input), ufbxi_snapshot_fields_shader_texture_input, ufbxi_arraycount(ufbxi_snapshot_fields_shader_texture_input), false },
+	{ sizeof(ufbx_shader_texture), ufbxi_snapshot_fields_shader_texture, ufbxi_arraycount(ufbxi_snapshot_fields_shader_texture), false },
+	{ sizeof(ufbx_texture*), ufbxi_snapshot_fields_texture_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_texture_ptr), false },
+	{ sizeof(ufbx_texture), ufbxi_snapshot_fields_texture, ufbxi_arraycount(ufbxi_snapshot_fields_texture), true },
+	{ sizeof(ufbx_material_map), ufbxi_snapshot_fields_material_map, ufbxi_arraycount(ufbxi_snapshot_fields_material_map), false },
+	{ sizeof(ufbx_material_fbx_maps), ufbxi_snapshot_fields_material_fbx_maps, ufbxi_arraycount(ufbxi_snapshot_fields_material_fbx_maps), false },
+	{ sizeof(ufbx_material_pbr_maps), ufbxi_snapshot_fields_material_pbr_maps, ufbxi_arraycount(ufbxi_snapshot_fields_material_pbr_maps), false },
+	{ sizeof(ufbx_shader_prop_binding), ufbxi_snapshot_fields_shader_prop_binding, ufbxi_arraycount(ufbxi_snapshot_fields_shader_prop_binding), false },
+	{ sizeof(ufbx_shader_binding), ufbxi_snapshot_fields_shader_binding, ufbxi_arraycount(ufbxi_snapshot_fields_shader_binding), true },
+	{ sizeof(ufbx_shader_binding*), ufbxi_snapshot_fields_shader_binding_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_shader_binding_ptr), false },
+	{ sizeof(ufbx_shader), ufbxi_snapshot_fields_shader, ufbxi_arraycount(ufbxi_snapshot_fields_shader), true },
+	{ sizeof(ufbx_material_texture), ufbxi_snapshot_fields_material_texture, ufbxi_arraycount(ufbxi_snapshot_fields_material_texture), false },
+	{ sizeof(ufbx_material), ufbxi_snapshot_fields_material, ufbxi_arraycount(ufbxi_snapshot_fields_material), true },
+	{ sizeof(ufbx_material*), ufbxi_snapshot_fields_material_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_material_ptr), false },
+	{ sizeof(ufbx_face_group), ufbxi_snapshot_fields_face_group, ufbxi_arraycount(ufbxi_snapshot_fields_face_group), false },
+	{ sizeof(ufbx_mesh_part), ufbxi_snapshot_fields_mesh_part, ufbxi_arraycount(ufbxi_snapshot_fields_mesh_part), false },
+	{ sizeof(ufbx_skin_cluster), ufbxi_snapshot_fields_skin_cluster, ufbxi_arraycount(ufbxi_snapshot_fields_skin_cluster), true },
+	{ sizeof(ufbx_skin_cluster*), ufbxi_snapshot_fields_skin_cluster_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_skin_cluster_ptr), false },
+	{ sizeof(ufbx_skin_vertex), NULL, 0, false },
+	{ sizeof(ufbx_skin_weight), NULL, 0, false },
+	{ sizeof(ufbx_skin_deformer), ufbxi_snapshot_fields_skin_deformer, ufbxi_arraycount(ufbxi_snapshot_fields_skin_deformer), true },
+	{ sizeof(ufbx_skin_deformer*), ufbxi_snapshot_fields_skin_deformer_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_skin_deformer_ptr), false },
+	{ sizeof(ufbx_blend_shape), ufbxi_snapshot_fields_blend_shape, ufbxi_arraycount(ufbxi_snapshot_fields_blend_shape), true },
+	{ sizeof(ufbx_blend_keyframe), ufbxi_snapshot_fields_blend_keyframe, ufbxi_arraycount(ufbxi_snapshot_fields_blend_keyframe), false },
+	{ sizeof(ufbx_blend_channel), ufbxi_snapshot_fields_blend_channel, ufbxi_arraycount(ufbxi_snapshot_fields_blend_channel), true },
+	{ sizeof(ufbx_blend_channel*), ufbxi_snapshot_fields_blend_channel_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_blend_channel_ptr), false },
+	{ sizeof(ufbx_blend_deformer), ufbxi_snapshot_fields_blend_deformer, ufbxi_arraycount(ufbxi_snapshot_fields_blend_deformer), true },
+	{ sizeof(ufbx_blend_deformer*), ufbxi_snapshot_fields_blend_deformer_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_blend_deformer_ptr), false },
+	{ sizeof(ufbx_cache_frame), ufbxi_snapshot_fields_cache_frame, ufbxi_arraycount(ufbxi_snapshot_fields_cache_frame), false },
+	{ sizeof(ufbx_cache_channel), ufbxi_snapshot_fields_cache_channel, ufbxi_arraycount(ufbxi_snapshot_fields_cache_channel), false },
+	{ sizeof(ufbx_string), ufbxi_snapshot_fields_string, ufbxi_arraycount(ufbxi_snapshot_fields_string), false },
+	{ sizeof(ufbx_geometry_cache), ufbxi_snapshot_fields_geometry_cache, ufbxi_arraycount(ufbxi_snapshot_fields_geometry_cache), false },
+	{ sizeof(ufbx_cache_file), ufbxi_snapshot_fields_cache_file, ufbxi_arraycount(ufbxi_snapshot_fields_cache_file), true },
+	{ sizeof(ufbx_cache_deformer), ufbxi_snapshot_fields_cache_deformer, ufbxi_arraycount(ufbxi_snapshot_fields_cache_deformer), true },
+	{ sizeof(ufbx_cache_deformer*), ufbxi_snapshot_fields_cache_deformer_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_cache_deformer_ptr), false },
+	{ sizeof(ufbx_element*), ufbxi_snapshot_fields_element_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_element_ptr), false },
+	{ sizeof(ufbx_subdivision_weight_range), NULL, 0, false },
+	{ sizeof(ufbx_subdivision_weight), NULL, 0, false },
+	{ sizeof(ufbx_subdivision_result), ufbxi_snapshot_fields_subdivision_result, ufbxi_arraycount(ufbxi_snapshot_fields_subdivision_result), false },
+	{ sizeof(ufbx_mesh), ufbxi_snapshot_fields_mesh, ufbxi_arraycount(ufbxi_snapshot_fields_mesh), true },
+	{ sizeof(ufbx_light), ufbxi_snapshot_fields_light, ufbxi_arraycount(ufbxi_snapshot_fields_light), true },
+	{ sizeof(ufbx_camera), ufbxi_snapshot_fields_camera, ufbxi_arraycount(ufbxi_snapshot_fields_camera), true },
+	{ sizeof(ufbx_node), ufbxi_snapshot_fields_node, ufbxi_arraycount(ufbxi_snapshot_fields_node), true },
+	{ sizeof(ufbx_keyframe), NULL, 0, false },
+	{ sizeof(ufbx_anim_curve), ufbxi_snapshot_fields_anim_curve, ufbxi_arraycount(ufbxi_snapshot_fields_anim_curve), true },
+	{ sizeof(ufbx_anim_value), ufbxi_snapshot_fields_anim_value, ufbxi_arraycount(ufbxi_snapshot_fields_anim_value), true },
+	{ sizeof(ufbx_anim_value*), ufbxi_snapshot_fields_anim_value_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_anim_value_ptr), false },
+	{ sizeof(ufbx_anim_prop), ufbxi_snapshot_fields_anim_prop, ufbxi_arraycount(ufbxi_snapshot_fields_anim_prop), false },
+	{ sizeof(ufbx_anim_layer), ufbxi_snapshot_fields_anim_layer, ufbxi_arraycount(ufbxi_snapshot_fields_anim_layer), true },
+	{ sizeof(ufbx_anim_layer*), ufbxi_snapshot_fields_anim_layer_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_anim_layer_ptr), false },
+	{ sizeof(ufbx_prop_override), ufbxi_snapshot_fields_prop_override, ufbxi_arraycount(ufbxi_snapshot_fields_prop_override), false },
+	{ sizeof(ufbx_transform_override), NULL, 0, false },
+	{ sizeof(ufbx_anim), ufbxi_snapshot_fields_anim, ufbxi_arraycount(ufbxi_snapshot_fields_anim), false },
+	{ sizeof(ufbx_unknown), ufbxi_snapshot_fields_unknown, ufbxi_arraycount(ufbxi_snapshot_fields_unknown), true },
+	{ sizeof(ufbx_unknown*), ufbxi_snapshot_fields_unknown_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_unknown_ptr), false },
+	{ sizeof(ufbx_mesh*), ufbxi_snapshot_fields_mesh_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_mesh_ptr), false },
+	{ sizeof(ufbx_light*), ufbxi_snapshot_fields_light_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_light_ptr), false },
+	{ sizeof(ufbx_camera*), ufbxi_snapshot_fields_camera_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_camera_ptr), false },
+	{ sizeof(ufbx_bone), ufbxi_snapshot_fields_bone, ufbxi_arraycount(ufbxi_snapshot_fields_bone), true },
+	{ sizeof(ufbx_bone*), ufbxi_snapshot_fields_bone_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_bone_ptr), false },
+	{ sizeof(ufbx_empty), ufbxi_snapshot_fields_empty, ufbxi_arraycount(ufbxi_snapshot_fields_empty), true },
+	{ sizeof(ufbx_empty*), ufbxi_snapshot_fields_empty_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_empty_ptr), false },
+	{ sizeof(ufbx_line_segment), NULL, 0, false },
+	{ sizeof(ufbx_line_curve), ufbxi_snapshot_fields_line_curve, ufbxi_arraycount(ufbxi_snapshot_fields_line_curve), true },
+	{ sizeof(ufbx_line_curve*), ufbxi_snapshot_fields_line_curve_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_line_curve_ptr), false },
+	{ sizeof(ufbx_nurbs_basis), ufbxi_snapshot_fields_nurbs_basis, ufbxi_arraycount(ufbxi_snapshot_fields_nurbs_basis), false },
+	{ sizeof(ufbx_nurbs_curve), ufbxi_snapshot_fields_nurbs_curve, ufbxi_arraycount(ufbxi_snapshot_fields_nurbs_curve), true },
+	{ sizeof(ufbx_nurbs_curve*), ufbxi_snapshot_fields_nurbs_curve_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_nurbs_curve_ptr), false },
+	{ sizeof(ufbx_nurbs_surface), ufbxi_snapshot_fields_nurbs_surface, ufbxi_arraycount(ufbxi_snapshot_fields_nurbs_surface), true },
+	{ sizeof(ufbx_nurbs_surface*), ufbxi_snapshot_fields_nurbs_surface_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_nurbs_surface_ptr), false },
+	{ sizeof(ufbx_nurbs_trim_surface), ufbxi_snapshot_fields_nurbs_trim_surface, ufbxi_arraycount(ufbxi_snapshot_fields_nurbs_trim_surface), true },
+	{ sizeof(ufbx_nurbs_trim_surface*), ufbxi_snapshot_fields_nurbs_trim_surface_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_nurbs_trim_surface_ptr), false },
+	{ sizeof(ufbx_nurbs_trim_boundary), ufbxi_snapshot_fields_nurbs_trim_boundary, ufbxi_arraycount(ufbxi_snapshot_fields_nurbs_trim_boundary), true },
+	{ sizeof(ufbx_nurbs_trim_boundary*), ufbxi_snapshot_fields_nurbs_trim_boundary_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_nurbs_trim_boundary_ptr), false },
+	{ sizeof(ufbx_procedural_geometry), ufbxi_snapshot_fields_procedural_geometry, ufbxi_arraycount(ufbxi_snapshot_fields_procedural_geometry), true },
+	{ sizeof(ufbx_procedural_geometry*), ufbxi_snapshot_fields_procedural_geometry_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_procedural_geometry_ptr), false },
+	{ sizeof(ufbx_stereo_camera), ufbxi_snapshot_fields_stereo_camera, ufbxi_arraycount(ufbxi_snapshot_fields_stereo_camera), true },
+	{ sizeof(ufbx_stereo_camera*), ufbxi_snapshot_fields_stereo_camera_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_stereo_camera_ptr), false },
+	{ sizeof(ufbx_camera_switcher), ufbxi_snapshot_fields_camera_switcher, ufbxi_arraycount(ufbxi_snapshot_fields_camera_switcher), true },
+	{ sizeof(ufbx_camera_switcher*), ufbxi_snapshot_fields_camera_switcher_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_camera_switcher_ptr), false },
+	{ sizeof(ufbx_marker), ufbxi_snapshot_fields_marker, ufbxi_arraycount(ufbxi_snapshot_fields_marker), true },
+	{ sizeof(ufbx_marker*), ufbxi_snapshot_fields_marker_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_marker_ptr), false },
+	{ sizeof(ufbx_lod_level), NULL, 0, false },
+	{ sizeof(ufbx_lod_group), ufbxi_snapshot_fields_lod_group, ufbxi_arraycount(ufbxi_snapshot_fields_lod_group), true },
+	{ sizeof(ufbx_lod_group*), ufbxi_snapshot_fields_lod_group_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_lod_group_ptr), false },
+	{ sizeof(ufbx_blend_shape*), ufbxi_snapshot_fields_blend_shape_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_blend_shape_ptr), false },
+	{ sizeof(ufbx_cache_file*), ufbxi_snapshot_fields_cache_file_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_cache_file_ptr), false },
+	{ sizeof(ufbx_video*), ufbxi_snapshot_fields_video_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_video_ptr), false },
+	{ sizeof(ufbx_shader*), ufbxi_snapshot_fields_shader_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_shader_ptr), false },
+	{ sizeof(ufbx_anim_stack), ufbxi_snapshot_fields_anim_stack, ufbxi_arraycount(ufbxi_snapshot_fields_anim_stack), true },
+	{ sizeof(ufbx_anim_stack*), ufbxi_snapshot_fields_anim_stack_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_anim_stack_ptr), false },
+	{ sizeof(ufbx_anim_curve*), ufbxi_snapshot_fields_anim_curve_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_anim_curve_ptr), false },
+	{ sizeof(ufbx_display_layer), ufbxi_snapshot_fields_display_layer, ufbxi_arraycount(ufbxi_snapshot_fields_display_layer), true },
+	{ sizeof(ufbx_display_layer*), ufbxi_snapshot_fields_display_layer_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_display_layer_ptr), false },
+	{ sizeof(ufbx_selection_node), ufbxi_snapshot_fields_selection_node, ufbxi_arraycount(ufbxi_snapshot_fields_selection_node), true },
+	{ sizeof(ufbx_selection_node*), ufbxi_snapshot_fields_selection_node_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_selection_node_ptr), false },
+	{ sizeof(ufbx_selection_set), ufbxi_snapshot_fields_selection_set, ufbxi_arraycount(ufbxi_snapshot_fields_selection_set), true },
+	{ sizeof(ufbx_selection_set*), ufbxi_snapshot_fields_selection_set_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_selection_set_ptr), false },
+	{ sizeof(ufbx_character), ufbxi_snapshot_fields_character, ufbxi_arraycount(ufbxi_snapshot_fields_character), true },
+	{ sizeof(ufbx_character*), ufbxi_snapshot_fields_character_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_character_ptr), false },
+	{ sizeof(ufbx_constraint_target), ufbxi_snapshot_fields_constraint_target, ufbxi_arraycount(ufbxi_snapshot_fields_constraint_target), false },
+	{ sizeof(ufbx_constraint), ufbxi_snapshot_fields_constraint, ufbxi_arraycount(ufbxi_snapshot_fields_constraint), true },
+	{ sizeof(ufbx_constraint*), ufbxi_snapshot_fields_constraint_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_constraint_ptr), false },
+	{ sizeof(ufbx_bone_pose), ufbxi_snapshot_fields_bone_pose, ufbxi_arraycount(ufbxi_snapshot_fields_bone_pose), false },
+	{ sizeof(ufbx_pose), ufbxi_snapshot_fields_pose, ufbxi_arraycount(ufbxi_snapshot_fields_pose), true },
+	{ sizeof(ufbx_pose*), ufbxi_snapshot_fields_pose_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_pose_ptr), false },
+	{ sizeof(ufbx_metadata_object), ufbxi_snapshot_fields_metadata_object, ufbxi_arraycount(ufbxi_snapshot_fields_metadata_object), true },
+	{ sizeof(ufbx_metadata_object*), ufbxi_snapshot_fields_metadata_object_ptr, ufbxi_arraycount(ufbxi_snapshot_fields_metadata_object_ptr), false },
+	{ sizeof(ufbx_texture_file), ufbxi_snapshot_fields_texture_file, ufbxi_arraycount(ufbxi_snapshot_fields_texture_file), false },
+	{ sizeof(ufbx_name_element), ufbxi_snapshot_fields_name_element, ufbxi_arraycount(ufbxi_snapshot_fields_name_element), false },
+	{ sizeof(ufbx_scene), ufbxi_snapshot_fields_scene, ufbxi_arraycount(ufbxi_snapshot_fields_scene), false },
+};
+
+static const uint16_t ufbxi_snapshot_element_types[] = {
+	UFBXI_SNAPSHOT_TYPE_UNKNOWN,
+	UFBXI_SNAPSHOT_TYPE_NODE,
+	UFBXI_SNAPSHOT_TYPE_MESH,
+	UFBXI_SNAPSHOT_TYPE_LIGHT,
+	UFBXI_SNAPSHOT_TYPE_CAMERA,
+	UFBXI_SNAPSHOT_TYPE_BONE,
+	UFBXI_SNAPSHOT_TYPE_EMPTY,
+	UFBXI_SNAPSHOT_TYPE_LINE_CURVE,
+	UFBXI_SNAPSHOT_TYPE_NURBS_CURVE,
+	UFBXI_SNAPSHOT_TYPE_NURBS_SURFACE,
+	UFBXI_SNAPSHOT_TYPE_NURBS_TRIM_SURFACE,
+	UFBXI_SNAPSHOT_TYPE_NURBS_TRIM_BOUNDARY,
+	UFBXI_SNAPSHOT_TYPE_PROCEDURAL_GEOMETRY,
+	UFBXI_SNAPSHOT_TYPE_STEREO_CAMERA,
+	UFBXI_SNAPSHOT_TYPE_CAMERA_SWITCHER,
+	UFBXI_SNAPSHOT_TYPE_MARKER,
+	UFBXI_SNAPSHOT_TYPE_LOD_GROUP,
+	UFBXI_SNAPSHOT_TYPE_SKIN_DEFORMER,
+	UFBXI_SNAPSHOT_TYPE_SKIN_CLUSTER,
+	UFBXI_SNAPSHOT_TYPE_BLEND_DEFORMER,
+	UFBXI_SNAPSHOT_TYPE_BLEND_CHANNEL,
+	UFBXI_SNAPSHOT_TYPE_BLEND_SHAPE,
+	UFBXI_SNAPSHOT_TYPE_CACHE_DEFORMER,
+	UFBXI_SNAPSHOT_TYPE_CACHE_FILE,
+	UFBXI_SNAPSHOT_TYPE_MATERIAL,
+	UFBXI_SNAPSHOT_TYPE_TEXTURE,
+	UFBXI_SNAPSHOT_TYPE_VIDEO,
+	UFBXI_SNAPSHOT_TYPE_SHADER,
+	UFBXI_SNAPSHOT_TYPE_SHADER_BINDING,
+	UFBXI_SNAPSHOT_TYPE_ANIM_STACK,
+	UFBXI_SNAPSHOT_TYPE_ANIM_LAYER,
+	UFBXI_SNAPSHOT_TYPE_ANIM_VALUE,
+	UFBXI_SNAPSHOT_TYPE_ANIM_CURVE,
+	UFBXI_SNAPSHOT_TYPE_DISPLAY_LAYER,
+	UFBXI_SNAPSHOT_TYPE_SELECTION_SET,
+	UFBXI_SNAPSHOT_TYPE_SELECTION_NODE,
+	UFBXI_SNAPSHOT_TYPE_CHARACTER,
+	UFBXI_SNAPSHOT_TYPE_CONSTRAINT,
+	UFBXI_SNAPSHOT_TYPE_POSE,
+	UFBXI_SNAPSHOT_TYPE_METADATA_OBJECT,
+};
+
+ufbx_static_assert(snapshot_element_types, ufbxi_arraycount(ufbxi_snapshot_element_types) == UFBX_ELEMENT_TYPE_COUNT);
+ufbx_static_assert(snapshot_type_count, ufbxi_arraycount(ufbxi_snapshot_types) == UFBXI_SNAPSHOT_TYPE_COUNT);
+ufbx_static_assert(snapshot_refcount_align, sizeof(ufbxi_refcount) % 8 == 0);
+
+#define UFBXI_SNAPSHOT_FORMAT_VERSION 1u
+#define UFBXI_SNAPSHOT_ENDIAN_TAG 0x01020304u
+#define UFBXI_SNAPSHOT_ZERO_SIZE 128u
+
+static const char ufbxi_snapshot_magic[8] = { 'u', 'f', 'b', 'x', 's', 'n', 'a', 'p' };
+
+typedef struct {
+	char magic[8];
+	uint32_t format_version;
+	uint32_t endian_tag;
+	uint32_t source_version;
+	uint32_t layout_hash;
+	uint64_t data_size;
+	uint64_t num_relocs;
+	uint32_t data_checksum;
+	uint32_t reloc_checksum;
+} ufbxi_snapshot_header;
+
+typedef struct {
+	ufbxi_refcount refcount;
+	ufbx_scene_snapshot snapshot;
+	uint32_t magic;
+} ufbxi_scene_snapshot_imp;
+
+ufbx_static_assert(snapshot_imp_offset, offsetof(ufbxi_scene_snapshot_imp, snapshot) == sizeof(ufbxi_refcount));
+ufbx_static_assert(snapshot_header_align, sizeof(ufbxi_snapshot_header) % 8 == 0);
+
+// Space reserved after `ufbx_scene` for the rest of `ufbxi_scene_imp` when loading.
+#define ufbxi_snapshot_scene_reserve() (sizeof(ufbxi_scene_imp) - sizeof(ufbxi_refcount))
+
+// Hash of everything that affects the binary layout of the snapshot data,
+// snapshots are only compatible if this matches exactly.
+static ufbxi_noinline uint32_t ufbxi_snapshot_layout_hash(void)
+{
+	uint32_t hash = ufbxi_hash32((uint32_t)sizeof(void*) ^ (uint32_t)sizeof(ufbx_real) << 8u);
+	hash = ufbxi_hash32(hash ^ (uint32_t)ufbxi_snapshot_scene_reserve());
+	for (size_t type_ix = 0; type_ix < UFBXI_SNAPSHOT_TYPE_COUNT; type_ix++) {
+		const ufbxi_snapshot_type *type = &ufbxi_snapshot_types[type_ix];
+		hash = ufbxi_hash32(hash ^ (uint32_t)type->size);
+		for (size_t i = 0; i < type->num_fields; i++) {
+			const ufbxi_snapshot_field *field = &type->fields[i];
+			hash = ufbxi_hash32(hash ^ field->offset);
+			hash = ufbxi_hash32(hash ^ ((uint32_t)field->kind << 16u | field->type));
+			hash = ufbxi_hash32(hash ^ field->count);
+		}
+	}
+	return hash;
+}
 
-	// Subdivision always results in a mesh that consists only of quads
-	mesh->max_face_triangles = 2;
-	mesh->num_empty_faces = 0;
-	mesh->num_point_faces = 0;
-	mesh->num_line_faces = 0;
+typedef struct {
+	const char *ptr;
+	size_t count;
+	uint32_t type;
+} ufbxi_snapshot_object;
 
-	if (!sc->opts.interpolate_normals && !sc->opts.ignore_normals) {
+typedef struct {
+	uintptr_t begin;
+	uintptr_t end;
+	size_t offset;
+	size_t order;
+	size_t align_mask;
+} ufbxi_snapshot_block;
 
-		ufbx_topo_edge *topo = ufbxi_push(&sc->tmp, ufbx_topo_edge, mesh->num_indices);
-		ufbxi_check_err(&sc->error, topo);
-		ufbx_compute_topology(mesh, topo, mesh->num_indices);
+typedef struct {
+	ufbx_error error;
+	ufbxi_allocator ator_tmp;
+	ufbxi_allocator ator_result;
 
-		uint32_t *normal_indices = ufbxi_push(&sc->result, uint32_t, mesh->num_indices);
-		ufbxi_check_err(&sc->error, normal_indices);
+	ufbxi_buf result;
+	ufbxi_buf tmp;
+	ufbxi_buf tmp_blocks;
+	ufbxi_buf tmp_slots;
 
-		size_t num_normals = ufbx_generate_normal_mapping(mesh, topo, mesh->num_indices, normal_indices, mesh->num_indices, true);
-		if (num_normals == mesh->num_vertices) {
-			mesh->skinned_normal.unique_per_vertex = true;
-		}
+	ufbxi_map visited_map;
 
-		ufbx_vec3 *normal_data = ufbxi_push(&sc->result, ufbx_vec3, num_normals + 1);
-		ufbxi_check_err(&sc->error, normal_data);
-		normal_data[0] = ufbx_zero_vec3;
-		normal_data++;
+	// Objects are walked in breadth-first order
+	ufbxi_snapshot_object *queue;
+	size_t queue_begin;
+	size_t queue_end;
+	size_t queue_cap;
 
-		ufbx_compute_normals(mesh, &mesh->skinned_position, normal_indices, mesh->num_indices, normal_data, num_normals);
+	ufbxi_snapshot_block *blocks;
+	size_t num_blocks;
+	size_t num_ranges;
 
-		mesh->generated_normals = true;
-		mesh->vertex_normal.exists = true;
-		mesh->vertex_normal.values.data = normal_data;
-		mesh->vertex_normal.values.count = num_normals;
-		mesh->vertex_normal.indices.data = normal_indices;
-		mesh->vertex_normal.indices.count = mesh->num_indices;
+	uintptr_t *slots;
+	size_t num_slots;
+	size_t data_size;
 
-		mesh->skinned_normal = mesh->vertex_normal;
-	}
+	// Lay out blocks in traversal order instead of address order
+	bool compact;
 
-	ufbxi_refcount *parent = NULL;
-	if (sc->src_mesh_ptr->subdivision_evaluated && sc->src_mesh_ptr->from_tessellated_nurbs) {
-		parent = &(ufbxi_get_imp(ufbxi_mesh_imp, sc->src_mesh_ptr))->refcount;
-	} else {
-		parent = &(ufbxi_get_imp(ufbxi_scene_imp, sc->src_mesh_ptr->element.scene))->refcount;
-	}
+	const ufbx_scene *scene;
+	ufbx_save_snapshot_opts opts;
 
-	ufbxi_patch_mesh_reals(mesh);
+	ufbxi_scene_snapshot_imp *imp;
+} ufbxi_snapshot_save_context;
 
-	sc->imp = ufbxi_push(&sc->result, ufbxi_mesh_imp, 1);
-	ufbxi_check_err(&sc->error, sc->imp);
+static int ufbxi_map_cmp_snapshot_object(void *user, const void *va, const void *vb)
+{
+	(void)user;
+	const ufbxi_snapshot_object *a = (const ufbxi_snapshot_object*)va, *b = (const ufbxi_snapshot_object*)vb;
+	if (a->ptr != b->ptr) return a->ptr < b->ptr ? -1 : +1;
+	if (a->type != b->type) return a->type < b->type ? -1 : +1;
+	if (a->count != b->count) return a->count < b->count ? -1 : +1;
+	return 0;
+}
 
-	sc->dst_mesh.subdivision_result->result_memory_used = sc->ator_result.current_size;
-	sc->dst_mesh.subdivision_result->temp_memory_used = sc->ator_tmp.current_size;
-	sc->dst_mesh.subdivision_result->result_allocs = sc->ator_result.num_allocs;
-	sc->dst_mesh.subdivision_result->temp_allocs = sc->ator_tmp.num_allocs;
+static int ufbxi_cmp_snapshot_block(const void *va, const void *vb)
+{
+	const ufbxi_snapshot_block *a = (const ufbxi_snapshot_block*)va, *b = (const ufbxi_snapshot_block*)vb;
+	if (a->begin != b->begin) return a->begin < b->begin ? -1 : +1;
+	if (a->end != b->end) return a->end < b->end ? -1 : +1;
+	return 0;
+}
 
-	ufbxi_init_ref(&sc->imp->refcount, UFBXI_MESH_IMP_MAGIC, parent);
+static int ufbxi_cmp_snapshot_block_order(const void *va, const void *vb)
+{
+	const ufbxi_snapshot_block *a = (const ufbxi_snapshot_block*)va, *b = (const ufbxi_snapshot_block*)vb;
+	if (a->order != b->order) return a->order < b->order ? -1 : +1;
+	return 0;
+}
 
-	sc->imp->magic = UFBXI_MESH_IMP_MAGIC;
-	sc->imp->mesh = sc->dst_mesh;
-	sc->imp->refcount.ator = sc->ator_result;
-	sc->imp->refcount.buf = sc->result;
-	sc->imp->mesh.subdivision_evaluated = true;
+ufbxi_nodiscard static ufbxi_forceinline int ufbxi_snapshot_add_range(ufbxi_snapshot_save_context *sc, const void *ptr, size_t size, size_t align_mask)
+{
+	ufbxi_snapshot_block *block = ufbxi_push(&sc->tmp_blocks, ufbxi_snapshot_block, 1);
+	ufbxi_check_err(&sc->error, block);
+	block->begin = (uintptr_t)ptr;
+	block->end = (uintptr_t)ptr + size;
+	block->offset = 0;
+	block->order = sc->num_ranges++;
+	block->align_mask = align_mask;
+	return 1;
+}
 
+ufbxi_nodiscard static ufbxi_forceinline int ufbxi_snapshot_add_slot(ufbxi_snapshot_save_context *sc, const void *slot)
+{
+	uintptr_t *dst = ufbxi_push(&sc->tmp_slots, uintptr_t, 1);
+	ufbxi_check_err(&sc->error, dst);
+	*dst = (uintptr_t)slot;
 	return 1;
 }
 
-ufbxi_noinline static ufbx_mesh *ufbxi_subdivide_mesh(const ufbx_mesh *mesh, size_t level, const ufbx_subdivide_opts *user_opts, ufbx_error *p_error)
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_snapshot_add_object(ufbxi_snapshot_save_context *sc, const void *ptr, uint32_t type_id, size_t count)
 {
-	ufbxi_subdivide_context sc = { 0 };
-	if (user_opts) {
-		sc.opts = *user_opts;
+	// Pointers to elements may point to any concrete element type
+	if (ufbxi_snapshot_types[type_id].is_element) {
+		ufbx_assert(count == 1);
+		ufbx_element_type elem_type = ((const ufbx_element*)ptr)->type;
+		ufbxi_check_err(&sc->error, (uint32_t)elem_type < UFBX_ELEMENT_TYPE_COUNT);
+		type_id = ufbxi_snapshot_element_types[elem_type];
 	}
 
-	sc.src_mesh_ptr = (ufbx_mesh*)mesh;
-	sc.src_mesh = *mesh;
+	const ufbxi_snapshot_type *type = &ufbxi_snapshot_types[type_id];
+	size_t size = type->size * count;
+	ufbxi_check_err(&sc->error, !ufbxi_does_overflow(size, type->size, count));
+	ufbxi_check_err(&sc->error, (uintptr_t)ptr <= UINTPTR_MAX - size);
 
-	int ok = ufbxi_subdivide_mesh_imp(&sc, level);
+	// Plain data only needs the memory range, otherwise walk it once.
+	if (type->num_fields > 0) {
+		ufbxi_snapshot_object object = { (const char*)ptr, count, type_id };
+		uint32_t hash = ufbxi_hash_ptr(ptr) ^ ufbxi_hash32(type_id) ^ ufbxi_hash_uptr(count);
+		if (ufbxi_map_find(&sc->visited_map, ufbxi_snapshot_object, hash, &object)) return 1;
 
-	ufbxi_free(&sc.ator_tmp, ufbxi_subdivide_input, sc.inputs, sc.inputs_cap);
-	ufbxi_buf_free(&sc.tmp);
-	ufbxi_buf_free(&sc.source);
+		ufbxi_snapshot_object *entry = ufbxi_map_insert(&sc->visited_map, ufbxi_snapshot_object, hash, &object);
+		ufbxi_check_err(&sc->error, entry);
+		*entry = object;
 
-	if (ok) {
-		ufbxi_free_ator(&sc.ator_tmp);
-		if (p_error) {
-			ufbxi_clear_error(p_error);
+		ufbxi_check_err(&sc->error, ufbxi_grow_array(&sc->ator_tmp, &sc->queue, &sc->queue_cap, sc->queue_end + 1));
+		sc->queue[sc->queue_end++] = object;
+	}
+
+	ufbxi_check_err(&sc->error, ufbxi_snapshot_add_range(sc, ptr, size, ufbxi_size_align_mask(type->size)));
+	return 1;
+}
+
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_snapshot_visit_fields(ufbxi_snapshot_save_context *sc, const char *ptr, uint32_t type_id)
+{
+	const ufbxi_snapshot_type *type = &ufbxi_snapshot_types[type_id];
+	for (size_t field_ix = 0; field_ix < type->num_fields; field_ix++) {
+		const ufbxi_snapshot_field *field = &type->fields[field_ix];
+		const char *field_ptr = ptr + field->offset;
+		for (uint32_t i = 0; i < field->count; i++) {
+			switch (field->kind) {
+			case UFBXI_SNAPSHOT_FIELD_INLINE: {
+				ufbxi_check_err(&sc->error, ufbxi_snapshot_visit_fields(sc, field_ptr, field->type));
+				field_ptr += ufbxi_snapshot_types[field->type].size;
+			} break;
+			case UFBXI_SNAPSHOT_FIELD_PTR: {
+				const void *value = *(const void *const*)field_ptr;
+				if (value) {
+					ufbxi_check_err(&sc->error, ufbxi_snapshot_add_slot(sc, field_ptr));
+					ufbxi_check_err(&sc->error, ufbxi_snapshot_add_object(sc, value, field->type, 1));
+				}
+				field_ptr += sizeof(void*);
+			} break;
+			case UFBXI_SNAPSHOT_FIELD_LIST:
+			case UFBXI_SNAPSHOT_FIELD_VALUES: {
+				const ufbx_void_list *list = (const ufbx_void_list*)field_ptr;
+				if (list->data && list->count > 0 && field->kind == UFBXI_SNAPSHOT_FIELD_VALUES) {
+					// Overlaps the list data so the zero value stays attached to it
+					size_t value_size = ufbxi_snapshot_types[field->type].size;
+					ufbxi_check_err(&sc->error, ufbxi_snapshot_add_range(sc, (const char*)list->data - value_size, value_size * 2, ufbxi_size_align_mask(value_size)));
+				}
+				if (list->data) {
+					ufbxi_check_err(&sc->error, ufbxi_snapshot_add_slot(sc, &list->data));
+					if (list->count > 0) {
+						ufbxi_check_err(&sc->error, ufbxi_snapshot_add_object(sc, list->data, field->type, list->count));
+					}
+				}
+				field_ptr += sizeof(ufbx_void_list);
+			} break;
+			case UFBXI_SNAPSHOT_FIELD_STRING: {
+				const ufbx_string *str = (const ufbx_string*)field_ptr;
+				if (str->data) {
+					ufbxi_check_err(&sc->error, str->length < SIZE_MAX);
+					ufbxi_check_err(&sc->error, ufbxi_snapshot_add_slot(sc, &str->data));
+					ufbxi_check_err(&sc->error, ufbxi_snapshot_add_range(sc, str->data, str->length + 1, 0));
+				}
+				field_ptr += sizeof(ufbx_string);
+			} break;
+			case UFBXI_SNAPSHOT_FIELD_BLOB: {
+				const ufbx_blob *blob = (const ufbx_blob*)field_ptr;
+				if (blob->data) {
+					ufbxi_check_err(&sc->error, ufbxi_snapshot_add_slot(sc, &blob->data));
+					if (blob->size > 0) {
+						// Blobs may contain typed arrays, eg. `UFBX_DOM_VALUE_ARRAY_F64`
+						ufbxi_check_err(&sc->error, ufbxi_snapshot_add_range(sc, blob->data, blob->size, 7));
+					}
+				}
+				field_ptr += sizeof(ufbx_blob);
+			} break;
+			default:
+				ufbx_assert(0 && "Bad snapshot field kind");
+				return 0;
+			}
 		}
+	}
 
-		ufbxi_mesh_imp *imp = sc.imp;
-		return &imp->mesh;
-	} else {
-		ufbxi_fix_error_type(&sc.error, "Failed to subdivide");
-		if (p_error) *p_error = sc.error;
-		ufbxi_buf_free(&sc.result);
-		ufbxi_free_ator(&sc.ator_tmp);
-		ufbxi_free_ator(&sc.ator_result);
-		return NULL;
+	// Raw string DOM arrays store `ufbx_string` values in `value_blob` that
+	// point to further data, which the field tables cannot describe.
+	if (type_id == UFBXI_SNAPSHOT_TYPE_DOM_VALUE) {
+		const ufbx_dom_value *value = (const ufbx_dom_value*)ptr;
+		if (value->type == UFBX_DOM_VALUE_ARRAY_RAW_STRING && value->value_blob.size > 0) {
+			const ufbx_string *strs = (const ufbx_string*)value->value_blob.data;
+			size_t num_strs = value->value_blob.size / sizeof(ufbx_string);
+			ufbxi_check_err(&sc->error, num_strs * sizeof(ufbx_string) == value->value_blob.size);
+			ufbxi_check_err(&sc->error, ufbxi_snapshot_add_range(sc, strs, value->value_blob.size, ufbxi_size_align_mask(sizeof(ufbx_string))));
+			for (size_t i = 0; i < num_strs; i++) {
+				if (!strs[i].data) continue;
+				ufbxi_check_err(&sc->error, ufbxi_snapshot_add_slot(sc, &strs[i].data));
+				if (strs[i].length > 0) {
+					ufbxi_check_err(&sc->error, ufbxi_snapshot_add_range(sc, strs[i].data, strs[i].length, 0));
+				}
+			}
+		}
 	}
+
+	return 1;
 }
 
-#else
+static int ufbxi_cmp_snapshot_slot(const void *va, const void *vb)
+{
+	uintptr_t a = *(const uintptr_t*)va, b = *(const uintptr_t*)vb;
+	if (a != b) return a < b ? -1 : +1;
+	return 0;
+}
 
-ufbxi_noinline static ufbx_mesh *ufbxi_subdivide_mesh(const ufbx_mesh *mesh, size_t level, const ufbx_subdivide_opts *user_opts, ufbx_error *p_error)
+static ufbxi_noinline const ufbxi_snapshot_block *ufbxi_snapshot_find_block(const ufbxi_snapshot_save_context *sc, uintptr_t ptr)
 {
-	if (p_error) {
-		memset(p_error, 0, sizeof(ufbx_error));
-		ufbxi_fmt_err_info(p_error, "UFBX_ENABLE_SUBDIVISION");
-		ufbxi_report_err_msg(p_error, "UFBXI_FEATURE_SUBDIVISION", "Feature disabled");
+	size_t begin = 0, end = sc->num_blocks;
+	while (begin < end) {
+		size_t mid = begin + (end - begin) / 2;
+		if (sc->blocks[mid].begin <= ptr) {
+			begin = mid + 1;
+		} else {
+			end = mid;
+		}
 	}
-	return NULL;
+	if (begin == 0) return NULL;
+	const ufbxi_snapshot_block *block = &sc->blocks[begin - 1];
+	return ptr < block->end ? block : NULL;
 }
 
-#endif
+// Merge overlapping memory ranges into disjoint blocks and assign them offsets
+// in the snapshot data. Adjacent ranges are merged as well unless compacting.
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_snapshot_layout(ufbxi_snapshot_save_context *sc, size_t *p_data_size)
+{
+	size_t num_ranges = sc->tmp_blocks.num_items;
+	ufbxi_snapshot_block *blocks = ufbxi_push_pop(&sc->tmp, &sc->tmp_blocks, ufbxi_snapshot_block, num_ranges);
+	ufbxi_check_err(&sc->error, blocks);
+	qsort(blocks, num_ranges, sizeof(ufbxi_snapshot_block), &ufbxi_cmp_snapshot_block);
 
-// -- Utility
+	uintptr_t merge_adjacent = sc->compact ? 0 : 1;
+	size_t num_blocks = 0;
+	for (size_t i = 0; i < num_ranges; i++) {
+		ufbxi_snapshot_block range = blocks[i];
+		if (num_blocks > 0 && range.begin < blocks[num_blocks - 1].end + merge_adjacent) {
+			ufbxi_snapshot_block *prev = &blocks[num_blocks - 1];
+			if (range.end > prev->end) prev->end = range.end;
+			if (range.order < prev->order) prev->order = range.order;
+			if (range.align_mask > prev->align_mask) prev->align_mask = range.align_mask;
+		} else {
+			blocks[num_blocks++] = range;
+		}
+	}
+	sc->blocks = blocks;
+	sc->num_blocks = num_blocks;
 
-#if UFBXI_FEATURE_INDEX_GENERATION
+	// The scene must be at offset zero followed by the rest of `ufbxi_scene_imp`,
+	// so nothing else may share memory with it.
+	uintptr_t scene_ptr = (uintptr_t)sc->scene;
+	ufbxi_snapshot_block *scene_block = (ufbxi_snapshot_block*)ufbxi_snapshot_find_block(sc, scene_ptr);
+	ufbxi_check_err(&sc->error, scene_block);
+	ufbxi_check_err(&sc->error, scene_block->begin == scene_ptr && scene_block->end == scene_ptr + sizeof(ufbx_scene));
+	scene_block->offset = 0;
 
-static int ufbxi_map_cmp_vertex(void *user, const void *va, const void *vb)
-{
-	size_t size = *(size_t*)user;
-#if defined(UFBX_REGRESSION)
-	ufbx_assert(size % 8 == 0);
-#endif
-	for (size_t i = 0; i < size; i += 8) {
-		uint64_t a = *(const uint64_t*)((const char*)va + i);
-		uint64_t b = *(const uint64_t*)((const char*)vb + i);
-		if (a != b) return a < b ? -1 : +1;
+	// Followed by a zero-filled area that empty lists can point to, empty lists
+	// point to the middle of it as vertex attributes may read one value before.
+	size_t offset = ufbxi_align_to_mask(ufbxi_snapshot_scene_reserve(), 7) + UFBXI_SNAPSHOT_ZERO_SIZE;
+
+	// Compact layouts place blocks in the order they were first reached from the
+	// scene, eg. all `ufbx_node` structs for `ufbx_scene.nodes[]` are contiguous.
+	// Lookups need the blocks sorted by address so sort them back afterwards.
+	scene_block->order = 0;
+	if (sc->compact) {
+		qsort(blocks, num_blocks, sizeof(ufbxi_snapshot_block), &ufbxi_cmp_snapshot_block_order);
 	}
-	return 0;
-}
 
-typedef struct {
-	char *begin, *ptr;
-	size_t vertex_size;
-	size_t packed_offset;
-} ufbxi_vertex_stream;
+	// Preserve the alignment of the original data relative to the largest
+	// alignment of the objects contained in the block.
+	for (size_t i = 0; i < num_blocks; i++) {
+		ufbxi_snapshot_block *block = &blocks[i];
+		if (block->begin == scene_ptr) continue;
+		size_t size = (size_t)(block->end - block->begin);
+		offset += ((size_t)block->begin - offset) & block->align_mask;
+		ufbxi_check_err(&sc->error, size <= SIZE_MAX / 2 - offset);
+		block->offset = offset;
+		offset += size;
+	}
 
-static ufbxi_noinline size_t ufbxi_generate_indices(const ufbx_vertex_stream *user_streams, size_t num_streams, uint32_t *indices, size_t num_indices, const ufbx_allocator_opts *allocator, ufbx_error *error)
-{
-	bool fail = false;
+	if (sc->compact) {
+		qsort(blocks, num_blocks, sizeof(ufbxi_snapshot_block), &ufbxi_cmp_snapshot_block);
+	}
 
-	ufbxi_allocator ator = { 0 };
-	ufbxi_init_ator(error, &ator, allocator, "allocator");
+	*p_data_size = ufbxi_align_to_mask(offset, 7);
+	return 1;
+}
 
-	ufbxi_vertex_stream local_streams[16];
-	uint64_t local_packed_vertex[64];
+static ufbxi_noinline void ufbxi_snapshot_init(ufbxi_snapshot_save_context *sc)
+{
+	ufbxi_init_ator(&sc->error, &sc->ator_tmp, &sc->opts.temp_allocator, "temp");
+	ufbxi_init_ator(&sc->error, &sc->ator_result, &sc->opts.result_allocator, "result");
 
-	ufbxi_vertex_stream *streams = NULL;
-	if (num_streams > ufbxi_arraycount(local_streams)) {
-		streams = ufbxi_alloc(&ator, ufbxi_vertex_stream, num_streams);
-		if (!streams) fail = true;
-	} else {
-		streams = local_streams;
-	}
+	sc->result.unordered = true;
+	sc->result.ator = &sc->ator_result;
 
-	size_t packed_size = 0;
-	if (!fail) {
-		for (size_t i = 0; i < num_streams; i++) {
-			if (user_streams[i].vertex_count < num_indices) {
-				ufbxi_fmt_err_info(error, "%zu", i);
-				ufbxi_report_err_msg(error, "user_streams[i].vertex_count < num_indices", "Truncated vertex stream");
-				fail = true;
-				break;
-			}
+	sc->tmp.unordered = true;
+	sc->tmp.ator = &sc->ator_tmp;
 
-			size_t vertex_size = user_streams[i].vertex_size;
-			size_t align = ufbxi_size_align_mask(vertex_size);
-			packed_size = ufbxi_align_to_mask(packed_size, align);
-			streams[i].ptr = streams[i].begin = (char*)user_streams[i].data;
-			streams[i].vertex_size = vertex_size;
-			streams[i].packed_offset = packed_size;
-			packed_size += vertex_size;
-		}
-		packed_size = ufbxi_align_to_mask(packed_size, 7);
-	}
+	sc->tmp_blocks.ator = &sc->ator_tmp;
+	sc->tmp_slots.ator = &sc->ator_tmp;
 
-	if (!fail && packed_size == 0) {
-		ufbxi_report_err_msg(error, "packed_size != 0", "Zero vertex size");
-		fail = true;
-	}
+	ufbxi_map_init(&sc->visited_map, &sc->ator_tmp, &ufbxi_map_cmp_snapshot_object, NULL);
+}
 
-	char *packed_vertex = NULL;
-	if (!fail) {
-		if (packed_size > sizeof(local_packed_vertex)) {
-			ufbx_assert(packed_size % 8 == 0);
-			packed_vertex = (char*)ufbxi_alloc(&ator, uint64_t, packed_size / 8);
-			if (!packed_vertex) fail = true;
-		} else {
-			packed_vertex = (char*)local_packed_vertex;
+static ufbxi_noinline void ufbxi_snapshot_free_temp(ufbxi_snapshot_save_context *sc)
+{
+	ufbxi_map_free(&sc->visited_map);
+	ufbxi_free(&sc->ator_tmp, ufbxi_snapshot_object, sc->queue, sc->queue_cap);
+	ufbxi_buf_free(&sc->tmp);
+	ufbxi_buf_free(&sc->tmp_blocks);
+	ufbxi_buf_free(&sc->tmp_slots);
+	ufbxi_free_ator(&sc->ator_tmp);
+}
+
+// Collect all memory reachable from `sc->scene` and lay it out into `sc->data_size` bytes.
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_snapshot_collect(ufbxi_snapshot_save_context *sc)
+{
+	ufbxi_check_err(&sc->error, ufbxi_snapshot_add_object(sc, sc->scene, UFBXI_SNAPSHOT_TYPE_SCENE, 1));
+	while (sc->queue_begin < sc->queue_end) {
+		ufbxi_snapshot_object object = sc->queue[sc->queue_begin++];
+		size_t stride = ufbxi_snapshot_types[object.type].size;
+		for (size_t i = 0; i < object.count; i++) {
+			ufbxi_check_err(&sc->error, ufbxi_snapshot_visit_fields(sc, object.ptr + i * stride, object.type));
 		}
 	}
 
-	ufbxi_map map = { 0 };
-	ufbxi_map_init(&map, &ator, &ufbxi_map_cmp_vertex, &packed_size);
+	ufbxi_check_err(&sc->error, ufbxi_snapshot_layout(sc, &sc->data_size));
 
-	if (num_indices > 0 && !ufbxi_map_grow_size(&map, packed_size, num_indices)) {
-		fail = true;
+	// Sort and deduplicate pointer locations, overlapping objects may be visited multiple times
+	size_t num_slots = sc->tmp_slots.num_items;
+	uintptr_t *slots = ufbxi_push_pop(&sc->tmp, &sc->tmp_slots, uintptr_t, num_slots);
+	ufbxi_check_err(&sc->error, slots);
+	qsort(slots, num_slots, sizeof(uintptr_t), &ufbxi_cmp_snapshot_slot);
+	size_t num_unique = 0;
+	for (size_t i = 0; i < num_slots; i++) {
+		if (num_unique == 0 || slots[num_unique - 1] != slots[i]) {
+			slots[num_unique++] = slots[i];
+		}
 	}
 
-	if (!fail) {
-		ufbx_assert(packed_vertex != NULL);
-		memset(packed_vertex, 0, packed_size);
-
-		for (size_t i = 0; i < num_indices; i++) {
-			for (size_t si = 0; si < num_streams; si++) {
-				size_t size = streams[si].vertex_size, offset = streams[si].packed_offset;
-				char *ptr = streams[si].ptr;
-				memcpy(packed_vertex + offset, ptr, size);
-				streams[si].ptr = ptr + size;
-			}
+	sc->slots = slots;
+	sc->num_slots = num_unique;
+	return 1;
+}
 
-			uint32_t hash = ufbxi_hash_string(packed_vertex, packed_size);
-			void *entry = ufbxi_map_find_size(&map, packed_size, hash, packed_vertex);
-			if (!entry) {
-				entry = ufbxi_map_insert_size(&map, packed_size, hash, packed_vertex);
-				if (!entry) {
-					fail = true;
-					break;
-				}
-				memcpy(entry, packed_vertex, packed_size);
-			}
-			uint32_t index = (uint32_t)(ufbxi_to_size((char*)entry - (char*)map.items) / packed_size);
-			indices[i] = index;
-		}
+// Copy the collected memory to `data[sc->data_size]`, pointers are written as
+// offsets relative to `base` and their locations are optionally stored in `relocs`.
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_snapshot_write(ufbxi_snapshot_save_context *sc, char *data, uintptr_t base, uint64_t *relocs)
+{
+	memset(data, 0, sc->data_size);
+	for (size_t i = 0; i < sc->num_blocks; i++) {
+		const ufbxi_snapshot_block *block = &sc->blocks[i];
+		memcpy(data + block->offset, (const void*)block->begin, (size_t)(block->end - block->begin));
 	}
 
-	size_t result_vertices = 0;
-	if (!fail) {
-		result_vertices = map.size;
+	size_t zero_offset = ufbxi_align_to_mask(ufbxi_snapshot_scene_reserve(), 7) + UFBXI_SNAPSHOT_ZERO_SIZE / 2;
+	for (size_t i = 0; i < sc->num_slots; i++) {
+		uintptr_t slot = sc->slots[i];
+		const ufbxi_snapshot_block *slot_block = ufbxi_snapshot_find_block(sc, slot);
+		ufbxi_check_err(&sc->error, slot_block);
+		size_t slot_offset = slot_block->offset + (size_t)(slot - slot_block->begin);
 
-		for (size_t si = 0; si < num_streams; si++) {
-			size_t vertex_size = streams[si].vertex_size;
-			char *dst = streams[si].begin;
-			char *src = ufbxi_add_ptr((char*)map.items, streams[si].packed_offset);
-			for (size_t i = 0; i < result_vertices; i++) {
-				memcpy(dst, src, vertex_size);
-				dst += vertex_size;
-				src += packed_size;
-			}
+		// Pointers that are not contained in any block can only be data
+		// pointers of empty lists, redirect those to the zero area.
+		uintptr_t value = *(const uintptr_t*)slot;
+		const ufbxi_snapshot_block *value_block = ufbxi_snapshot_find_block(sc, value);
+		uintptr_t value_offset = value_block ? (uintptr_t)(value_block->offset + (value - value_block->begin)) : (uintptr_t)zero_offset;
+		value_offset += base;
+
+		memcpy(data + slot_offset, &value_offset, sizeof(uintptr_t));
+		if (relocs) {
+			relocs[i] = (uint64_t)slot_offset;
 		}
+	}
 
-		ufbxi_clear_error(error);
-	} else {
-		ufbxi_fix_error_type(error, "Failed to generate indices");
+	return 1;
+}
+
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_save_scene_snapshot_imp(ufbxi_snapshot_save_context *sc)
+{
+	ufbxi_snapshot_init(sc);
+	ufbxi_check_err_msg(&sc->error, sc->opts._begin_zero == 0 && sc->opts._end_zero == 0, "Uninitialized options");
+
+	ufbxi_check_err(&sc->error, ufbxi_snapshot_collect(sc));
+
+	size_t data_size = sc->data_size;
+	size_t num_relocs = sc->num_slots;
+	size_t reloc_size = num_relocs * sizeof(uint64_t);
+	ufbxi_check_err(&sc->error, !ufbxi_does_overflow(reloc_size, num_relocs, sizeof(uint64_t)));
+	size_t total_size = sizeof(ufbxi_snapshot_header) + data_size + reloc_size;
+	ufbxi_check_err(&sc->error, reloc_size <= SIZE_MAX / 2 - data_size);
+
+	uint64_t *words = ufbxi_push(&sc->result, uint64_t, total_size / 8);
+	ufbxi_check_err(&sc->error, words);
+	char *dst = (char*)words;
+
+	ufbxi_snapshot_header *header = (ufbxi_snapshot_header*)dst;
+	char *data = dst + sizeof(ufbxi_snapshot_header);
+	uint64_t *relocs = (uint64_t*)(data + data_size);
+
+	ufbxi_check_err(&sc->error, ufbxi_snapshot_write(sc, data, 0, relocs));
+
+	memset(header, 0, sizeof(ufbxi_snapshot_header));
+	memcpy(header->magic, ufbxi_snapshot_magic, sizeof(ufbxi_snapshot_magic));
+	header->format_version = UFBXI_SNAPSHOT_FORMAT_VERSION;
+	header->endian_tag = UFBXI_SNAPSHOT_ENDIAN_TAG;
+	header->source_version = ufbx_source_version;
+	header->layout_hash = ufbxi_snapshot_layout_hash();
+	header->data_size = (uint64_t)data_size;
+	header->num_relocs = (uint64_t)num_relocs;
+	header->data_checksum = ufbxi_adler32(data, data_size);
+	header->reloc_checksum = ufbxi_adler32(relocs, reloc_size);
+
+	sc->imp = ufbxi_push(&sc->result, ufbxi_scene_snapshot_imp, 1);
+	ufbxi_check_err(&sc->error, sc->imp);
+
+	ufbxi_init_ref(&sc->imp->refcount, UFBXI_SCENE_SNAPSHOT_IMP_MAGIC, NULL);
+
+	sc->imp->magic = UFBXI_SCENE_SNAPSHOT_IMP_MAGIC;
+	sc->imp->snapshot.data.data = dst;
+	sc->imp->snapshot.data.size = total_size;
+	sc->imp->refcount.ator = sc->ator_result;
+	sc->imp->refcount.buf = sc->result;
+	return 1;
+}
+
+// Animated properties are sorted by element address which may change when compacting.
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_compact_sort_anim_props(ufbxi_snapshot_save_context *sc, ufbx_scene *scene)
+{
+	size_t max_props = 0;
+	ufbxi_for_ptr_list(ufbx_anim_layer, p_layer, scene->anim_layers) {
+		max_props = ufbxi_max_sz(max_props, (*p_layer)->anim_props.count);
 	}
 
-	if (streams && streams != local_streams) {
-		ufbxi_free(&ator, ufbxi_vertex_stream, streams, num_streams);
+	ufbx_anim_prop *tmp = ufbxi_push(&sc->tmp, ufbx_anim_prop, max_props);
+	ufbxi_check_err(&sc->error, tmp);
+	ufbxi_for_ptr_list(ufbx_anim_layer, p_layer, scene->anim_layers) {
+		ufbx_anim_prop_list props = (*p_layer)->anim_props;
+		ufbxi_macro_stable_sort(ufbx_anim_prop, 32, props.data, tmp, props.count, ( ufbxi_cmp_anim_prop_less(a, b) ));
 	}
-	if (packed_vertex && packed_vertex != (char*)local_packed_vertex) {
-		ufbxi_free(&ator, uint64_t, packed_vertex, packed_size / 8);
+	return 1;
+}
+
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_compact_scene_imp(ufbxi_snapshot_save_context *sc, ufbxi_context *uc, ufbxi_scene_imp **p_imp)
+{
+	ufbxi_snapshot_init(sc);
+	ufbxi_check_err(&sc->error, ufbxi_snapshot_collect(sc));
+
+	// Use the same layout as loaded snapshots, `ufbxi_refcount` followed by
+	// the scene and all the data, in a dedicated exact size allocation.
+	ufbxi_allocator *ator = &uc->ator_result;
+	ufbx_error *ator_error = ator->error;
+	size_t huge_size = ator->huge_size;
+	ator->error = &sc->error;
+	ator->huge_size = 1;
+
+	ufbxi_buf buf = { 0 };
+	buf.ator = ator;
+	buf.unordered = true;
+	uint64_t *words = ufbxi_push(&buf, uint64_t, (sizeof(ufbxi_refcount) + sc->data_size) / 8);
+
+	ator->error = ator_error;
+	ator->huge_size = huge_size;
+	ufbxi_check_err(&sc->error, words);
+
+	char *data = (char*)words + sizeof(ufbxi_refcount);
+	if (!ufbxi_snapshot_write(sc, data, (uintptr_t)data, NULL) || !ufbxi_compact_sort_anim_props(sc, (ufbx_scene*)data)) {
+		ufbxi_buf_free(&buf);
+		return 0;
 	}
 
-	ufbxi_map_free(&map);
-	ufbxi_free_ator(&ator);
+	// Everything is copied so we can release the original result memory
+	ufbxi_buf_free(&uc->result);
+	ufbxi_buf_free(&uc->string_pool.buf);
+	uc->result = buf;
 
-	return result_vertices;
+	*p_imp = (ufbxi_scene_imp*)words;
+	return 1;
 }
 
-#else
-
-static ufbxi_noinline size_t ufbxi_generate_indices(const ufbx_vertex_stream *user_streams, size_t num_streams, uint32_t *indices, size_t num_indices, const ufbx_allocator_opts *allocator, ufbx_error *error)
+// Move `uc->scene` and all data it references to a single allocation in `uc->result`.
+static ufbxi_noinline ufbxi_scene_imp *ufbxi_compact_scene(ufbxi_context *uc)
 {
-	if (error) {
-		memset(error, 0, sizeof(ufbx_error));
-		ufbxi_fmt_err_info(error, "UFBX_ENABLE_INDEX_GENERATION");
-		ufbxi_report_err_msg(error, "UFBXI_FEATURE_INDEX_GENERATION", "Feature disabled");
+	ufbxi_snapshot_save_context sc = { UFBX_ERROR_NONE };
+	sc.scene = &uc->scene;
+	sc.compact = true;
+	sc.opts.temp_allocator = uc->opts.temp_allocator;
+
+	ufbxi_scene_imp *imp = NULL;
+	int ok = ufbxi_compact_scene_imp(&sc, uc, &imp);
+	ufbxi_snapshot_free_temp(&sc);
+	ufbxi_free_ator(&sc.ator_result);
+
+	if (!ok) {
+		uc->error = sc.error;
+		return NULL;
 	}
-	return 0;
+	return imp;
 }
 
-#endif
+typedef struct {
+	ufbx_error error;
+	ufbxi_allocator ator_tmp;
+	ufbxi_allocator ator_result;
 
-static ufbxi_noinline void ufbxi_free_scene_imp(ufbxi_scene_imp *imp)
+	ufbxi_buf result;
+	ufbxi_buf tmp;
+
+	// Read either from `data` or `stream` if non-NULL
+	const char *data;
+	size_t data_size;
+	const ufbx_stream *stream;
+
+	ufbx_load_snapshot_opts opts;
+
+	ufbxi_scene_imp *imp;
+} ufbxi_snapshot_load_context;
+
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_snapshot_read(ufbxi_snapshot_load_context *lc, void *dst, size_t size)
 {
-	ufbx_assert(imp->magic == UFBXI_SCENE_IMP_MAGIC);
-	ufbxi_buf_free(&imp->string_buf);
+	if (lc->stream) {
+		char *ptr = (char*)dst;
+		while (size > 0) {
+			size_t num_read = lc->stream->read_fn(lc->stream->user, ptr, size);
+			ufbxi_check_err_msg(&lc->error, num_read != SIZE_MAX, "IO error");
+			ufbxi_check_err_msg(&lc->error, num_read > 0 && num_read <= size, "Truncated file");
+			ptr += num_read;
+			size -= num_read;
+		}
+	} else {
+		ufbxi_check_err_msg(&lc->error, size <= lc->data_size, "Truncated file");
+		if (size > 0) {
+			memcpy(dst, lc->data, size);
+		}
+		lc->data += size;
+		lc->data_size -= size;
+	}
+	return 1;
 }
 
-static ufbxi_noinline void ufbxi_init_ref(ufbxi_refcount *refcount, uint32_t magic, ufbxi_refcount *parent)
+ufbxi_nodiscard static ufbxi_noinline int ufbxi_load_scene_snapshot_imp(ufbxi_snapshot_load_context *lc)
 {
-	if (parent) {
-		ufbxi_retain_ref(parent);
+	ufbxi_init_ator(&lc->error, &lc->ator_tmp, &lc->opts.temp_allocator, "temp");
+	ufbxi_init_ator(&lc->error, &lc->ator_result, &lc->opts.result_allocator, "result");
+
+	lc->result.unordered = true;
+	lc->result.ator = &lc->ator_result;
+
+	lc->tmp.unordered = true;
+	lc->tmp.ator = &lc->ator_tmp;
+
+	ufbxi_check_err_msg(&lc->error, lc->opts._begin_zero == 0 && lc->opts._end_zero == 0, "Uninitialized options");
+
+	ufbxi_snapshot_header header;
+	ufbxi_check_err(&lc->error, ufbxi_snapshot_read(lc, &header, sizeof(header)));
+
+	ufbxi_check_err_msg(&lc->error, !memcmp(header.magic, ufbxi_snapshot_magic, sizeof(ufbxi_snapshot_magic)), "Bad snapshot");
+	ufbxi_check_err_msg(&lc->error, header.format_version == UFBXI_SNAPSHOT_FORMAT_VERSION, "Bad snapshot");
+	ufbxi_check_err_msg(&lc->error, header.endian_tag == UFBXI_SNAPSHOT_ENDIAN_TAG, "Bad snapshot");
+	ufbxi_check_err_msg(&lc->error, header.source_version == ufbx_source_version, "Bad snapshot");
+	ufbxi_check_err_msg(&lc->error, header.layout_hash == ufbxi_snapshot_layout_hash(), "Bad snapshot");
+	ufbxi_check_err_msg(&lc->error, header.data_size >= ufbxi_snapshot_scene_reserve(), "Bad snapshot");
+	ufbxi_check_err_msg(&lc->error, header.data_size % 8 == 0 && header.data_size <= SIZE_MAX / 2, "Bad snapshot");
+	ufbxi_check_err_msg(&lc->error, header.num_relocs <= header.data_size / sizeof(void*), "Bad snapshot");
+
+	size_t data_size = (size_t)header.data_size;
+	size_t num_relocs = (size_t)header.num_relocs;
+
+	// Read the data directly after the `ufbxi_refcount` header so that the scene
+	// at offset zero becomes `ufbxi_scene_imp.scene`.
+	uint64_t *words = ufbxi_push(&lc->result, uint64_t, (sizeof(ufbxi_refcount) + data_size) / 8);
+	ufbxi_check_err(&lc->error, words);
+	char *data = (char*)words + sizeof(ufbxi_refcount);
+	ufbxi_check_err(&lc->error, ufbxi_snapshot_read(lc, data, data_size));
+
+	uint64_t *relocs = ufbxi_push(&lc->tmp, uint64_t, num_relocs);
+	ufbxi_check_err(&lc->error, relocs);
+	ufbxi_check_err(&lc->error, ufbxi_snapshot_read(lc, relocs, num_relocs * sizeof(uint64_t)));
+
+	if (!lc->opts.skip_checksum) {
+		ufbxi_check_err_msg(&lc->error, ufbxi_adler32(data, data_size) == header.data_checksum, "Bad snapshot");
+		ufbxi_check_err_msg(&lc->error, ufbxi_adler32(relocs, num_relocs * sizeof(uint64_t)) == header.reloc_checksum, "Bad snapshot");
 	}
 
-	ufbxi_atomic_counter_init(&refcount->refcount);
-	refcount->self_magic = UFBXI_REFCOUNT_IMP_MAGIC;
-	refcount->type_magic = magic;
-	refcount->parent = parent;
-}
+	uintptr_t base = (uintptr_t)data;
+	for (size_t i = 0; i < num_relocs; i++) {
+		uint64_t offset = relocs[i];
+		ufbxi_check_err_msg(&lc->error, offset <= data_size - sizeof(uintptr_t) && offset % sizeof(uintptr_t) == 0, "Bad snapshot");
+		uintptr_t *slot = (uintptr_t*)(data + (size_t)offset);
+		ufbxi_check_err_msg(&lc->error, *slot < data_size, "Bad snapshot");
+		*slot += base;
+	}
 
-static ufbxi_noinline void ufbxi_retain_ref(ufbxi_refcount *refcount)
-{
-	ufbx_assert(refcount->self_magic == UFBXI_REFCOUNT_IMP_MAGIC);
-	size_t count = ufbxi_atomic_counter_inc(&refcount->refcount);
-	ufbxi_ignore(count);
-	ufbx_assert(count < SIZE_MAX / 2);
+	ufbxi_scene_imp *imp = (ufbxi_scene_imp*)words;
+	ufbxi_init_ref(&imp->refcount, UFBXI_SCENE_IMP_MAGIC, NULL);
+
+	imp->magic = UFBXI_SCENE_IMP_MAGIC;
+	imp->refcount.ator = lc->ator_result;
+	imp->refcount.ator.error = NULL;
+
+	imp->refcount.buf = lc->result;
+	imp->refcount.buf.ator = &imp->refcount.ator;
+	memset(&imp->string_buf, 0, sizeof(ufbxi_buf));
+	imp->eval_partition = NULL;
+	imp->string_buf.ator = &imp->refcount.ator;
+
+	imp->scene.metadata.result_memory_used = imp->refcount.ator.current_size;
+	imp->scene.metadata.temp_memory_used = lc->ator_tmp.current_size;
+	imp->scene.metadata.result_allocs = imp->refcount.ator.num_allocs;
+	imp->scene.metadata.temp_allocs = lc->ator_tmp.num_allocs;
+
+	lc->imp = imp;
+	return 1;
 }
 
-static ufbxi_noinline void ufbxi_release_ref(ufbxi_refcount *refcount)
+static ufbxi_noinline ufbx_scene *ufbxi_load_scene_snapshot(ufbxi_snapshot_load_context *lc, const ufbx_load_snapshot_opts *opts, ufbx_error *error)
 {
-	while (refcount) {
-		ufbx_assert(refcount->self_magic == UFBXI_REFCOUNT_IMP_MAGIC);
-		if (ufbxi_atomic_counter_dec(&refcount->refcount) > 0) return;
-		ufbxi_atomic_counter_free(&refcount->refcount);
-
-		ufbxi_refcount *parent = refcount->parent;
-		uint32_t type_magic = refcount->type_magic;
+	if (opts) {
+		lc->opts = *opts;
+	}
 
-		refcount->self_magic = 0;
-		refcount->type_magic = 0;
+	int ok = ufbxi_load_scene_snapshot_imp(lc);
 
-		// Type-specific cleanup
-		switch (type_magic) {
-		case UFBXI_SCENE_IMP_MAGIC: ufbxi_free_scene_imp((ufbxi_scene_imp*)refcount); break;
-		case UFBXI_CACHE_IMP_MAGIC: ufbxi_free_geometry_cache_imp((ufbxi_geometry_cache_imp*)refcount); break;
-		default: break;
-		}
+	if (lc->stream && lc->stream->close_fn) {
+		lc->stream->close_fn(lc->stream->user);
+	}
 
-		// We need to free `data_buf` last and be careful to copy it to
-		// the stack since the `ufbxi_refcount` that contains it is allocated
-		// from the same result buffer!
-		ufbxi_allocator ator = refcount->ator;
-		ufbxi_buf buf = refcount->buf;
-		buf.ator = &ator;
-		ufbxi_buf_free(&buf);
-		ufbxi_free_ator(&ator);
+	ufbxi_buf_free(&lc->tmp);
+	ufbxi_free_ator(&lc->ator_tmp);
 
-		refcount = parent;
+	if (ok) {
+		ufbxi_clear_error(error);
+		return &lc->imp->scene;
+	} else {
+		ufbxi_fix_error_type(&lc->error, "Failed to load snapshot");
+		if (error) *error = lc->error;
+		ufbxi_buf_free(&lc->result);
+		ufbxi_free_ator(&lc->ator_result);
+		return NULL;
 	}
 }
 
+#endif
+
 // -- API
 
 #ifdef __cplusplus
@@ -28691,6 +35060,203 @@ ufbx_abi void ufbx_retain_scene(ufbx_scene *scene)
 	ufbxi_retain_ref(&imp->refcount);
 }
 
+ufbx_abi ufbx_load_context *ufbx_create_load_context(const ufbx_load_context_opts *opts, ufbx_error *error)
+{
+	ufbx_load_context_opts zero_opts;
+	if (!opts) {
+		memset(&zero_opts, 0, sizeof(zero_opts));
+		opts = &zero_opts;
+	}
+
+	ufbx_error local_error = { UFBX_ERROR_NONE };
+	ufbxi_allocator ator = { 0 };
+	ufbxi_init_ator(&local_error, &ator, &opts->allocator, "context");
+
+	ufbxi_load_context_imp *imp = NULL;
+	ufbxi_buf buf = { 0 };
+	buf.ator = &ator;
+	buf.unordered = true;
+
+	if (opts->_begin_zero != 0 || opts->_end_zero != 0) {
+		ufbxi_report_err_msg(&local_error, "opts->_begin_zero == 0 && opts->_end_zero == 0", "Uninitialized options");
+	} else {
+		imp = ufbxi_push_zero(&buf, ufbxi_load_context_imp, 1);
+	}
+
+	if (!imp) {
+		ufbxi_fix_error_type(&local_error, "Failed to create load context");
+		if (error) *error = local_error;
+		ufbxi_buf_free(&buf);
+		ufbxi_free_ator(&ator);
+		return NULL;
+	}
+
+	ufbxi_init_ref(&imp->refcount, UFBXI_LOAD_CONTEXT_IMP_MAGIC, NULL);
+	imp->magic = UFBXI_LOAD_CONTEXT_IMP_MAGIC;
+	imp->refcount.ator = ator;
+	imp->refcount.ator.error = &imp->error;
+	imp->refcount.buf = buf;
+	imp->refcount.buf.ator = &imp->refcount.ator;
+
+	imp->cache.ator = &imp->refcount.ator;
+	imp->cache.max_cached_size = opts->max_cached_memory ? opts->max_cached_memory : 64*1024*1024;
+
+	if (error) {
+		ufbxi_clear_error(error);
+	}
+	return &imp->context;
+}
+
+ufbx_abi void ufbx_retain_load_context(ufbx_load_context *context)
+{
+	if (!context) return;
+
+	ufbxi_load_context_imp *imp = ufbxi_get_imp(ufbxi_load_context_imp, context);
+	ufbx_assert(imp->magic == UFBXI_LOAD_CONTEXT_IMP_MAGIC);
+	if (imp->magic != UFBXI_LOAD_CONTEXT_IMP_MAGIC) return;
+	ufbxi_retain_ref(&imp->refcount);
+}
+
+ufbx_abi void ufbx_free_load_context(ufbx_load_context *context)
+{
+	if (!context) return;
+
+	ufbxi_load_context_imp *imp = ufbxi_get_imp(ufbxi_load_context_imp, context);
+	ufbx_assert(imp->magic == UFBXI_LOAD_CONTEXT_IMP_MAGIC);
+	if (imp->magic != UFBXI_LOAD_CONTEXT_IMP_MAGIC) return;
+	ufbxi_release_ref(&imp->refcount);
+}
+
+ufbx_abi void ufbx_trim_load_context(ufbx_load_context *context, size_t max_memory)
+{
+	ufbx_assert(context);
+	if (!context) return;
+
+	ufbxi_load_context_imp *imp = ufbxi_get_imp(ufbxi_load_context_imp, context);
+	ufbx_assert(imp->magic == UFBXI_LOAD_CONTEXT_IMP_MAGIC);
+	if (imp->magic != UFBXI_LOAD_CONTEXT_IMP_MAGIC || imp->in_use) return;
+	ufbxi_cache_trim(&imp->cache, max_memory);
+	context->cached_memory = imp->cache.cached_size;
+}
+
+ufbx_abi ufbx_scene_snapshot *ufbx_save_scene_snapshot(const ufbx_scene *scene, const ufbx_save_snapshot_opts *opts, ufbx_error *error)
+{
+	ufbx_assert(scene);
+#if UFBXI_FEATURE_SCENE_SNAPSHOT
+	ufbxi_snapshot_save_context sc = { UFBX_ERROR_NONE };
+	if (opts) {
+		sc.opts = *opts;
+	}
+
+	sc.scene = scene;
+
+	int ok = ufbxi_save_scene_snapshot_imp(&sc);
+
+	ufbxi_snapshot_free_temp(&sc);
+
+	if (ok) {
+		ufbxi_clear_error(error);
+		ufbxi_scene_snapshot_imp *imp = sc.imp;
+		return &imp->snapshot;
+	} else {
+		ufbxi_fix_error_type(&sc.error, "Failed to save snapshot");
+		if (error) *error = sc.error;
+		ufbxi_buf_free(&sc.result);
+		ufbxi_free_ator(&sc.ator_result);
+		return NULL;
+	}
+#else
+	if (error) {
+		memset(error, 0, sizeof(ufbx_error));
+		ufbxi_fmt_err_info(error, "UFBX_ENABLE_SCENE_SNAPSHOT");
+		ufbxi_report_err_msg(error, "UFBXI_FEATURE_SCENE_SNAPSHOT", "Feature disabled");
+	}
+	return NULL;
+#endif
+}
+
+ufbx_abi void ufbx_retain_scene_snapshot(ufbx_scene_snapshot *snapshot)
+{
+	if (!snapshot) return;
+#if UFBXI_FEATURE_SCENE_SNAPSHOT
+	ufbxi_scene_snapshot_imp *imp = ufbxi_get_imp(ufbxi_scene_snapshot_imp, snapshot);
+	ufbx_assert(imp->magic == UFBXI_SCENE_SNAPSHOT_IMP_MAGIC);
+	if (imp->magic != UFBXI_SCENE_SNAPSHOT_IMP_MAGIC) return;
+	ufbxi_retain_ref(&imp->refcount);
+#endif
+}
+
+ufbx_abi void ufbx_free_scene_snapshot(ufbx_scene_snapshot *snapshot)
+{
+	if (!snapshot) return;
+#if UFBXI_FEATURE_SCENE_SNAPSHOT
+	ufbxi_scene_snapshot_imp *imp = ufbxi_get_imp(ufbxi_scene_snapshot_imp, snapshot);
+	ufbx_assert(imp->magic == UFBXI_SCENE_SNAPSHOT_IMP_MAGIC);
+	if (imp->magic != UFBXI_SCENE_SNAPSHOT_IMP_MAGIC) return;
+	ufbxi_release_ref(&imp->refcount);
+#endif
+}
+
+ufbx_abi ufbx_scene *ufbx_load_scene_snapshot(const void *data, size_t data_size, const ufbx_load_snapshot_opts *opts, ufbx_error *error)
+{
+#if UFBXI_FEATURE_SCENE_SNAPSHOT
+	ufbxi_snapshot_load_context lc = { UFBX_ERROR_NONE };
+	lc.data = (const char*)data;
+	lc.data_size = data_size;
+	return ufbxi_load_scene_snapshot(&lc, opts, error);
+#else
+	(void)data;
+	(void)data_size;
+	(void)opts;
+	if (error) {
+		memset(error, 0, sizeof(ufbx_error));
+		ufbxi_fmt_err_info(error, "UFBX_ENABLE_SCENE_SNAPSHOT");
+		ufbxi_report_err_msg(error, "UFBXI_FEATURE_SCENE_SNAPSHOT", "Feature disabled");
+	}
+	return NULL;
+#endif
+}
+
+ufbx_abi ufbx_scene *ufbx_load_scene_snapshot_file(const char *filename, const ufbx_load_snapshot_opts *opts, ufbx_error *error)
+{
+	return ufbx_load_scene_snapshot_file_len(filename, SIZE_MAX, opts, error);
+}
+
+ufbx_abi ufbx_scene *ufbx_load_scene_snapshot_file_len(const char *filename, size_t filename_len, const ufbx_load_snapshot_opts *opts, ufbx_error *error)
+{
+	ufbx_stream stream = { 0 };
+	if (!ufbx_open_file(&stream, filename, filename_len)) {
+		if (error) {
+			memset(error, 0, sizeof(ufbx_error));
+			ufbxi_set_err_info(error, filename, filename_len);
+			ufbxi_report_err_msg(error, "filename", "File not found");
+			error->type = UFBX_ERROR_FILE_NOT_FOUND;
+		}
+		return NULL;
+	}
+	return ufbx_load_scene_snapshot_stream(&stream, opts, error);
+}
+
+ufbx_abi ufbx_scene *ufbx_load_scene_snapshot_stream(const ufbx_stream *stream, const ufbx_load_snapshot_opts *opts, ufbx_error *error)
+{
+#if UFBXI_FEATURE_SCENE_SNAPSHOT
+	ufbxi_snapshot_load_context lc = { UFBX_ERROR_NONE };
+	lc.stream = stream;
+	return ufbxi_load_scene_snapshot(&lc, opts, error);
+#else
+	(void)opts;
+	if (stream->close_fn) {
+		stream->close_fn(stream->user);
+	}
+	if (error) {
+		memset(error, 0, sizeof(ufbx_error));
+		ufbxi_fmt_err_info(error, "UFBX_ENABLE_SCENE_SNAPSHOT");
+		ufbxi_report_err_msg(error, "UFBXI_FEATURE_SCENE_SNAPSHOT", "Feature disabled");
+	}
+	return NULL;
+#endif
+}
+
 ufbx_abi ufbxi_noinline size_t ufbx_format_error(char *dst, size_t dst_size, const ufbx_error *error)
 {
 	if (!dst || !dst_size) return 0;
@@ -28944,57 +35510,74 @@ ufbx_abi ufbx_real ufbx_evaluate_curve(const ufbx_anim_curve *curve, double time
 
 	end = curve->keyframes.count;
 	for (; begin < end; begin++) {
-		const ufbx_keyframe *next = &keys[begin];
-		if (next->time <= time) continue;
-
-		// First keyframe
-		if (begin == 0) return next->value;
-
-		const ufbx_keyframe *prev = next - 1;
+		if (!(keys[begin].time <= time)) break;
+	}
 
-		// Exact keyframe
-		if (prev->time == time) return prev->value;
+	return ufbxi_evaluate_keyframes(keys, curve->keyframes.count, begin, time);
+}
 
-		double rcp_delta = 1.0 / (next->time - prev->time);
-		double t = (time - prev->time) * rcp_delta;
+ufbx_abi ufbx_real ufbx_evaluate_curve_cursor(const ufbx_anim_curve *curve, ufbx_curve_cursor *cursor, double time, ufbx_real default_value)
+{
+	ufbx_assert(cursor);
+	if (!curve) return default_value;
+	if (curve->keyframes.count <= 1) {
+		if (curve->keyframes.count == 1) {
+			return curve->keyframes.data[0].value;
+		} else {
+			return default_value;
+		}
+	}
 
-		switch (prev->interpolation) {
+	const ufbx_keyframe *keys = curve->keyframes.data;
+	size_t count = curve->keyframes.count;
+	size_t index = ufbxi_find_key_index_hint(keys, sizeof(ufbx_keyframe), count, cursor->index, time);
+	cursor->index = index;
 
-		case UFBX_INTERPOLATION_CONSTANT_PREV:
-			return prev->value;
+	return ufbxi_evaluate_keyframes(keys, count, index, time);
+}
 
-		case UFBX_INTERPOLATION_CONSTANT_NEXT:
-			return next->value;
+ufbx_abi ufbxi_noinline void ufbx_evaluate_curves(const ufbx_anim_curve **curves, ufbx_curve_cursor *cursors, size_t num_curves, double time, ufbx_real *values)
+{
+	ufbx_assert(curves || num_curves == 0);
+	ufbx_assert(values || num_curves == 0);
 
-		case UFBX_INTERPOLATION_LINEAR:
-			return (ufbx_real)(prev->value*(1.0 - t) + next->value*t);
+	ufbxi_cubic_batch batch;
+	batch.num_lanes = 0;
 
-		case UFBX_INTERPOLATION_CUBIC:
-		{
-			double x1 = prev->right.dx * rcp_delta;
-			double x2 = 1.0 - next->left.dx * rcp_delta;
-			t = ufbxi_find_cubic_bezier_t(x1, x2, t);
+	for (size_t i = 0; i < num_curves; i++) {
+		const ufbx_anim_curve *curve = curves[i];
+		if (!curve) continue;
 
-			double t2 = t*t, t3 = t2*t;
-			double u = 1.0 - t, u2 = u*u, u3 = u2*u;
+		const ufbx_keyframe *keys = curve->keyframes.data;
+		size_t count = curve->keyframes.count;
+		if (count <= 1) {
+			if (count == 1) values[i] = keys[0].value;
+			continue;
+		}
 
-			double y0 = prev->value;
-			double y3 = next->value;
-			double y1 = y0 + prev->right.dy;
-			double y2 = y3 - next->left.dy;
+		size_t index = ufbxi_find_key_index_hint(keys, sizeof(ufbx_keyframe), count, cursors ? cursors[i].index : 0, time);
+		if (cursors) cursors[i].index = index;
+		ufbxi_cubic_batch_evaluate(&batch, keys, count, index, time, &values[i]);
+	}
 
-			return (ufbx_real)(u3*y0 + 3.0 * (u2*t*y1 + u*t2*y2) + t3*y3);
-		}
+	ufbxi_cubic_batch_flush(&batch);
+}
 
-		default:
-			ufbx_assert(0 && "Bad interpolation mode");
-			return 0.0f;
+ufbx_abi void ufbx_evaluate_curve_samples(const ufbx_anim_curve *curve, const double *times, ufbx_real *values, size_t num_samples, ufbx_real default_value)
+{
+	ufbx_assert(times || num_samples == 0);
+	ufbx_assert(values || num_samples == 0);
 
+	size_t count = curve ? curve->keyframes.count : 0;
+	if (count <= 1) {
+		ufbx_real value = count == 1 ? curve->keyframes.data[0].value : default_value;
+		for (size_t i = 0; i < num_samples; i++) {
+			values[i] = value;
 		}
+		return;
 	}
 
-	// Last keyframe
-	return curve->keyframes.data[curve->keyframes.count - 1].value;
+	ufbxi_evaluate_keyframes_batch(curve->keyframes.data, count, times, values, num_samples);
 }
 
 ufbx_abi ufbx_real ufbx_evaluate_anim_value_real(const ufbx_anim_value *anim_value, double time)
@@ -29104,19 +35687,6 @@ ufbx_abi ufbxi_noinline ufbx_transform ufbx_evaluate_transform(const ufbx_anim *
 	return ufbx_evaluate_transform_flags(anim, node, time, 0);
 }
 
-static const char *const ufbxi_transform_props_all[] = {
-	ufbxi_Lcl_Rotation,
-	ufbxi_Lcl_Scaling,
-	ufbxi_Lcl_Translation,
-	ufbxi_PostRotation,
-	ufbxi_PreRotation,
-	ufbxi_RotationOffset,
-	ufbxi_RotationOrder,
-	ufbxi_RotationPivot,
-	ufbxi_ScalingOffset,
-	ufbxi_ScalingPivot,
-};
-
 static const char *const ufbxi_transform_props_rotation[] = {
 	ufbxi_Lcl_Rotation,
 	ufbxi_PostRotation,
@@ -29257,6 +35827,37 @@ ufbx_abi ufbx_scene *ufbx_evaluate_scene(const ufbx_scene *scene, const ufbx_ani
 #endif
 }
 
+ufbx_abi bool ufbx_update_evaluated_scene(ufbx_scene *scene, double time, ufbx_error *error)
+{
+#if UFBXI_FEATURE_SCENE_EVALUATION
+	ufbxi_scene_imp *imp = ufbxi_get_imp(ufbxi_scene_imp, scene);
+	ufbx_assert(imp->magic == UFBXI_SCENE_IMP_MAGIC);
+	if (imp->magic != UFBXI_SCENE_IMP_MAGIC || !imp->eval_partition) {
+		if (error) {
+			memset(error, 0, sizeof(ufbx_error));
+			ufbxi_report_err_msg(error, "imp->eval_partition", "Scene not from ufbx_evaluate_scene()");
+			ufbxi_fix_error_type(error, "Failed to update evaluated scene");
+		}
+		return false;
+	}
+
+	ufbxi_update_evaluated_scene(scene, imp->eval_partition, time);
+	if (error) {
+		ufbxi_clear_error(error);
+	}
+	return true;
+#else
+	(void)scene;
+	(void)time;
+	if (error) {
+		memset(error, 0, sizeof(ufbx_error));
+		ufbxi_fmt_err_info(error, "UFBX_ENABLE_SCENE_EVALUATION");
+		ufbxi_report_err_msg(error, "UFBXI_FEATURE_SCENE_EVALUATION", "Feature disabled");
+	}
+	return false;
+#endif
+}
+
 ufbx_abi ufbx_anim *ufbx_create_anim(const ufbx_scene *scene, const ufbx_anim_opts *opts, ufbx_error *error)
 {
 	ufbx_assert(scene);
@@ -29320,6 +35921,8 @@ ufbx_abi ufbx_baked_anim *ufbx_bake_anim(const ufbx_scene *scene, const ufbx_ani
 
 	bc.scene = scene;
 
+	ufbxi_trace_init(&bc.tracer, &bc.opts.trace_cb);
+	ufbxi_trace_begin(&bc.tracer, "ufbx_bake_anim");
 	int ok = ufbxi_bake_anim_imp(&bc, anim);
 
 	ufbxi_buf_free(&bc.tmp);
@@ -29331,102 +35934,394 @@ ufbx_abi ufbx_baked_anim *ufbx_bake_anim(const ufbx_scene *scene, const ufbx_ani
 	ufbxi_buf_free(&bc.tmp_props);
 	ufbxi_buf_free(&bc.tmp_bake_stack);
 	ufbxi_free_ator(&bc.ator_tmp);
+	ufbxi_trace_unwind(&bc.tracer);
+
+	if (ok) {
+		ufbxi_clear_error(error);
+		ufbxi_baked_anim_imp *imp = bc.imp;
+		return &imp->bake;
+	} else {
+		ufbxi_fix_error_type(&bc.error, "Failed to bake anim");
+		if (error) *error = bc.error;
+		ufbxi_buf_free(&bc.result);
+		ufbxi_free_ator(&bc.ator_result);
+		return NULL;
+	}
+#else
+	if (error) {
+		memset(error, 0, sizeof(ufbx_error));
+		ufbxi_fmt_err_info(error, "UFBX_ENABLE_ANIMATION_BAKING");
+		ufbxi_report_err_msg(error, "UFBXI_FEATURE_ANIMATION_BAKING", "Feature disabled");
+	}
+	return NULL;
+#endif
+}
+
+ufbx_abi void ufbx_retain_baked_anim(ufbx_baked_anim *bake)
+{
+	if (!bake) return;
+
+	ufbxi_baked_anim_imp *imp = ufbxi_get_imp(ufbxi_baked_anim_imp, bake);
+	ufbx_assert(imp->magic == UFBXI_BAKED_ANIM_IMP_MAGIC);
+	if (imp->magic != UFBXI_BAKED_ANIM_IMP_MAGIC) return;
+	ufbxi_retain_ref(&imp->refcount);
+}
+
+ufbx_abi void ufbx_free_baked_anim(ufbx_baked_anim *bake)
+{
+	if (!bake) return;
+
+	ufbxi_baked_anim_imp *imp = ufbxi_get_imp(ufbxi_baked_anim_imp, bake);
+	ufbx_assert(imp->magic == UFBXI_BAKED_ANIM_IMP_MAGIC);
+	if (imp->magic != UFBXI_BAKED_ANIM_IMP_MAGIC) return;
+	ufbxi_release_ref(&imp->refcount);
+}
+
+// Same as `ufbxi_lerp3()`, the SSE version computes the exact same result.
+static ufbxi_forceinline ufbx_vec3 ufbxi_baked_lerp3(const ufbx_vec3 *a, const ufbx_vec3 *b, ufbx_real t)
+{
+#if UFBXI_HAS_SSE && !defined(UFBX_REAL_IS_FLOAT)
+	ufbx_real u = 1.0f - t;
+	ufbx_vec3 v;
+	__m128d xy = _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(&a->x), _mm_set1_pd(u)), _mm_mul_pd(_mm_loadu_pd(&b->x), _mm_set1_pd(t)));
+	_mm_storeu_pd(&v.x, xy);
+	v.z = a->z*u + b->z*t;
+	return v;
+#else
+	return ufbxi_lerp3(*a, *b, t);
+#endif
+}
+
+static ufbxi_noinline ufbx_vec3 ufbxi_evaluate_baked_vec3_index(ufbx_baked_vec3_list keyframes, size_t index, double time)
+{
+	const ufbx_baked_vec3 *keys = keyframes.data;
+	if (index >= keyframes.count) return keys[keyframes.count - 1].value;
+	if (index == 0) return keys[0].value;
+
+	const ufbx_baked_vec3 *next = &keys[index];
+	const ufbx_baked_vec3 *prev = next - 1;
+	double t = (time - prev->time) / (next->time - prev->time);
+	return ufbxi_baked_lerp3(&prev->value, &next->value, (ufbx_real)t);
+}
+
+static ufbxi_noinline ufbx_quat ufbxi_evaluate_baked_quat_index(ufbx_baked_quat_list keyframes, size_t index, double time)
+{
+	const ufbx_baked_quat *keys = keyframes.data;
+	if (index >= keyframes.count) return keys[keyframes.count - 1].value;
+	if (index == 0) return keys[0].value;
+
+	const ufbx_baked_quat *next = &keys[index];
+	const ufbx_baked_quat *prev = next - 1;
+	double t = (time - prev->time) / (next->time - prev->time);
+	return ufbx_quat_slerp(prev->value, next->value, (ufbx_real)t);
+}
+
+ufbx_abi ufbx_vec3 ufbx_evaluate_baked_vec3(ufbx_baked_vec3_list keyframes, double time)
+{
+	size_t begin = 0;
+	size_t end = keyframes.count;
+	const ufbx_baked_vec3 *keys = keyframes.data;
+	while (end - begin >= 8) {
+		size_t mid = (begin + end) >> 1;
+		if (keys[mid].time <= time) {
+			begin = mid + 1;
+		} else {
+			end = mid;
+		}
+	}
+
+	end = keyframes.count;
+	for (; begin < end; begin++) {
+		if (!(keys[begin].time <= time)) break;
+	}
+
+	return ufbxi_evaluate_baked_vec3_index(keyframes, begin, time);
+}
+
+ufbx_abi ufbx_quat ufbx_evaluate_baked_quat(ufbx_baked_quat_list keyframes, double time)
+{
+	size_t begin = 0;
+	size_t end = keyframes.count;
+	const ufbx_baked_quat *keys = keyframes.data;
+	while (end - begin >= 8) {
+		size_t mid = (begin + end) >> 1;
+		if (keys[mid].time <= time) {
+			begin = mid + 1;
+		} else {
+			end = mid;
+		}
+	}
+
+	end = keyframes.count;
+	for (; begin < end; begin++) {
+		if (!(keys[begin].time <= time)) break;
+	}
+
+	return ufbxi_evaluate_baked_quat_index(keyframes, begin, time);
+}
+
+ufbx_abi ufbx_vec3 ufbx_evaluate_baked_vec3_cursor(ufbx_baked_vec3_list keyframes, ufbx_curve_cursor *cursor, double time)
+{
+	ufbx_assert(cursor);
+	size_t index = ufbxi_find_key_index_hint(keyframes.data, sizeof(ufbx_baked_vec3), keyframes.count, cursor->index, time);
+	cursor->index = index;
+	return ufbxi_evaluate_baked_vec3_index(keyframes, index, time);
+}
+
+ufbx_abi ufbx_quat ufbx_evaluate_baked_quat_cursor(ufbx_baked_quat_list keyframes, ufbx_curve_cursor *cursor, double time)
+{
+	ufbx_assert(cursor);
+	size_t index = ufbxi_find_key_index_hint(keyframes.data, sizeof(ufbx_baked_quat), keyframes.count, cursor->index, time);
+	cursor->index = index;
+	return ufbxi_evaluate_baked_quat_index(keyframes, index, time);
+}
+
+// Returns `hint` if it is the index of the first keyframe after `time`, ie. another track
+// with the same keyframe times has already been searched, otherwise searches from `hint`.
+static ufbxi_forceinline size_t ufbxi_find_shared_key_index(const void *keys, size_t stride, size_t count, size_t hint, double time)
+{
+	if (hint <= count && (hint == 0 || ufbxi_key_time(keys, stride, hint - 1) <= time) && (hint == count || !(ufbxi_key_time(keys, stride, hint) <= time))) {
+		return hint;
+	}
+	return ufbxi_find_key_index_hint(keys, stride, count, hint, time);
+}
+
+ufbx_abi ufbxi_noinline size_t ufbx_sample_baked_pose(const ufbx_baked_anim *bake, double time, ufbx_transform *transforms, size_t num_transforms, ufbx_curve_cursor *cursors, size_t num_cursors)
+{
+	ufbx_assert(bake);
+	if (!bake || !transforms) return 0;
+	if (!cursors) num_cursors = 0;
+
+	size_t num_nodes = ufbxi_min_sz(bake->nodes.count, num_transforms);
+	for (size_t i = 0; i < num_nodes; i++) {
+		const ufbx_baked_node *node = &bake->nodes.data[i];
+		ufbx_transform *dst = &transforms[i];
+
+		// Tracks are usually resampled at the same times so the index found for
+		// one of them can be validated in constant time for the rest.
+		size_t index = i < num_cursors ? cursors[i].index : 0;
+
+		ufbx_baked_vec3_list translation = node->translation_keys;
+		if (translation.count > 0) {
+			index = ufbxi_find_shared_key_index(translation.data, sizeof(ufbx_baked_vec3), translation.count, index, time);
+			dst->translation = ufbxi_evaluate_baked_vec3_index(translation, index, time);
+		} else {
+			dst->translation = ufbx_zero_vec3;
+		}
+
+		ufbx_baked_quat_list rotation = node->rotation_keys;
+		if (rotation.count > 0) {
+			index = ufbxi_find_shared_key_index(rotation.data, sizeof(ufbx_baked_quat), rotation.count, index, time);
+			dst->rotation = ufbxi_evaluate_baked_quat_index(rotation, index, time);
+		} else {
+			dst->rotation = ufbx_identity_quat;
+		}
+
+		ufbx_baked_vec3_list scale = node->scale_keys;
+		if (scale.count > 0) {
+			index = ufbxi_find_shared_key_index(scale.data, sizeof(ufbx_baked_vec3), scale.count, index, time);
+			dst->scale = ufbxi_evaluate_baked_vec3_index(scale, index, time);
+		} else {
+			dst->scale = ufbxi_one_vec3;
+		}
+
+		if (i < num_cursors) cursors[i].index = index;
+	}
+
+	return num_nodes;
+}
+
+ufbx_abi ufbx_compressed_anim *ufbx_compress_baked_anim(const ufbx_baked_anim *bake, const ufbx_compress_anim_opts *opts, ufbx_error *error)
+{
+	ufbx_assert(bake);
+
+	ufbxi_compress_anim_context cc = { UFBX_ERROR_NONE };
+	if (opts) {
+		cc.opts = *opts;
+	}
+	cc.bake = bake;
+
+	int ok = ufbxi_compress_baked_anim_imp(&cc);
+
+	if (ok) {
+		ufbxi_clear_error(error);
+		ufbxi_compressed_anim_imp *imp = cc.imp;
+		return &imp->anim;
+	} else {
+		ufbxi_fix_error_type(&cc.error, "Failed to compress anim");
+		if (error) *error = cc.error;
+		ufbxi_buf_free(&cc.result);
+		ufbxi_free_ator(&cc.ator_result);
+		return NULL;
+	}
+}
+
+ufbx_abi void ufbx_retain_compressed_anim(ufbx_compressed_anim *anim)
+{
+	if (!anim) return;
+
+	ufbxi_compressed_anim_imp *imp = ufbxi_get_imp(ufbxi_compressed_anim_imp, anim);
+	ufbx_assert(imp->magic == UFBXI_COMPRESSED_ANIM_IMP_MAGIC);
+	if (imp->magic != UFBXI_COMPRESSED_ANIM_IMP_MAGIC) return;
+	ufbxi_retain_ref(&imp->refcount);
+}
+
+ufbx_abi void ufbx_free_compressed_anim(ufbx_compressed_anim *anim)
+{
+	if (!anim) return;
+
+	ufbxi_compressed_anim_imp *imp = ufbxi_get_imp(ufbxi_compressed_anim_imp, anim);
+	ufbx_assert(imp->magic == UFBXI_COMPRESSED_ANIM_IMP_MAGIC);
+	if (imp->magic != UFBXI_COMPRESSED_ANIM_IMP_MAGIC) return;
+	ufbxi_release_ref(&imp->refcount);
+}
+
+ufbx_abi ufbxi_noinline ufbx_vec3 ufbx_evaluate_compressed_vec3(const ufbx_compressed_track *track, double time)
+{
+	ufbx_assert(track);
+	if (!track) return ufbx_zero_vec3;
+	if (track->num_keys == 0) {
+		ufbx_vec3 v;
+		v.x = track->constant_value.x;
+		v.y = track->constant_value.y;
+		v.z = track->constant_value.z;
+		return v;
+	}
+
+	double t;
+	size_t index = ufbxi_find_compressed_key(track, time, &t);
+	ufbx_vec3 prev = ufbxi_decode_compressed_vec3(track, index);
+	if (t == 0.0) return prev;
+	ufbx_vec3 next = ufbxi_decode_compressed_vec3(track, index + 1);
+	return ufbxi_lerp3(prev, next, (ufbx_real)t);
+}
+
+ufbx_abi ufbxi_noinline ufbx_quat ufbx_evaluate_compressed_quat(const ufbx_compressed_track *track, double time)
+{
+	ufbx_assert(track);
+	if (!track) return ufbx_identity_quat;
+	if (track->num_keys == 0) {
+		ufbx_quat q;
+		q.x = track->constant_value.x;
+		q.y = track->constant_value.y;
+		q.z = track->constant_value.z;
+		q.w = track->constant_value.w;
+		return q;
+	}
+
+	double t;
+	size_t index = ufbxi_find_compressed_key(track, time, &t);
+	ufbx_quat prev = ufbxi_decode_compressed_quat(track, index);
+	if (t == 0.0) return prev;
+	ufbx_quat next = ufbxi_decode_compressed_quat(track, index + 1);
+	return ufbx_quat_slerp(prev, next, (ufbx_real)t);
+}
+
+ufbx_abi ufbx_transform ufbx_evaluate_compressed_node(const ufbx_compressed_node *node, double time)
+{
+	ufbx_assert(node);
+	if (!node) return ufbx_identity_transform;
+
+	ufbx_transform transform;
+	transform.translation = ufbx_evaluate_compressed_vec3(&node->translation, time);
+	transform.rotation = ufbx_evaluate_compressed_quat(&node->rotation, time);
+	transform.scale = ufbx_evaluate_compressed_vec3(&node->scale, time);
+	return transform;
+}
+
+ufbx_abi ufbx_compiled_anim *ufbx_compile_anim(const ufbx_scene *scene, const ufbx_anim *anim, const ufbx_compile_anim_opts *opts, ufbx_error *error)
+{
+	ufbx_assert(scene);
+#if UFBXI_FEATURE_SCENE_EVALUATION
+	if (!anim) {
+		anim = scene->anim;
+	}
+
+	ufbxi_compile_anim_context cc = { UFBX_ERROR_NONE };
+	if (opts) {
+		cc.opts = *opts;
+	}
+
+	cc.scene = scene;
+	cc.anim = anim;
+
+	int ok = ufbxi_compile_anim_imp(&cc);
+
+	ufbxi_buf_free(&cc.tmp_curves);
+	ufbxi_free_ator(&cc.ator_tmp);
 
 	if (ok) {
 		ufbxi_clear_error(error);
-		ufbxi_baked_anim_imp *imp = bc.imp;
-		return &imp->bake;
+		ufbxi_compiled_anim_imp *imp = cc.imp;
+		return &imp->compiled;
 	} else {
-		ufbxi_fix_error_type(&bc.error, "Failed to bake anim");
-		if (error) *error = bc.error;
-		ufbxi_buf_free(&bc.result);
-		ufbxi_free_ator(&bc.ator_result);
+		ufbxi_fix_error_type(&cc.error, "Failed to compile anim");
+		if (error) *error = cc.error;
+		ufbxi_buf_free(&cc.result);
+		ufbxi_free_ator(&cc.ator_result);
 		return NULL;
 	}
 #else
+	(void)anim;
+	(void)opts;
 	if (error) {
 		memset(error, 0, sizeof(ufbx_error));
-		ufbxi_fmt_err_info(error, "UFBX_ENABLE_ANIMATION_BAKING");
-		ufbxi_report_err_msg(error, "UFBXI_FEATURE_ANIMATION_BAKING", "Feature disabled");
+		ufbxi_fmt_err_info(error, "UFBX_ENABLE_SCENE_EVALUATION");
+		ufbxi_report_err_msg(error, "UFBXI_FEATURE_SCENE_EVALUATION", "Feature disabled");
 	}
 	return NULL;
 #endif
 }
 
-ufbx_abi void ufbx_retain_baked_anim(ufbx_baked_anim *bake)
+ufbx_abi void ufbx_retain_compiled_anim(ufbx_compiled_anim *compiled)
 {
-	if (!bake) return;
+	if (!compiled) return;
 
-	ufbxi_baked_anim_imp *imp = ufbxi_get_imp(ufbxi_baked_anim_imp, bake);
-	ufbx_assert(imp->magic == UFBXI_BAKED_ANIM_IMP_MAGIC);
-	if (imp->magic != UFBXI_BAKED_ANIM_IMP_MAGIC) return;
+	ufbxi_compiled_anim_imp *imp = ufbxi_get_imp(ufbxi_compiled_anim_imp, compiled);
+	ufbx_assert(imp->magic == UFBXI_COMPILED_ANIM_IMP_MAGIC);
+	if (imp->magic != UFBXI_COMPILED_ANIM_IMP_MAGIC) return;
 	ufbxi_retain_ref(&imp->refcount);
 }
 
-ufbx_abi void ufbx_free_baked_anim(ufbx_baked_anim *bake)
+ufbx_abi void ufbx_free_compiled_anim(ufbx_compiled_anim *compiled)
 {
-	if (!bake) return;
+	if (!compiled) return;
 
-	ufbxi_baked_anim_imp *imp = ufbxi_get_imp(ufbxi_baked_anim_imp, bake);
-	ufbx_assert(imp->magic == UFBXI_BAKED_ANIM_IMP_MAGIC);
-	if (imp->magic != UFBXI_BAKED_ANIM_IMP_MAGIC) return;
+	ufbxi_compiled_anim_imp *imp = ufbxi_get_imp(ufbxi_compiled_anim_imp, compiled);
+	ufbx_assert(imp->magic == UFBXI_COMPILED_ANIM_IMP_MAGIC);
+	if (imp->magic != UFBXI_COMPILED_ANIM_IMP_MAGIC) return;
 	ufbxi_release_ref(&imp->refcount);
 }
 
-ufbx_abi ufbx_vec3 ufbx_evaluate_baked_vec3(ufbx_baked_vec3_list keyframes, double time)
+ufbx_abi ufbxi_noinline size_t ufbx_evaluate_pose(const ufbx_compiled_anim *compiled, double time, ufbx_transform *transforms, size_t num_transforms)
 {
-	size_t begin = 0;
-	size_t end = keyframes.count;
-	const ufbx_baked_vec3 *keys = keyframes.data;
-	while (end - begin >= 8) {
-		size_t mid = (begin + end) >> 1;
-		if (keys[mid].time <= time) {
-			begin = mid + 1;
-		} else {
-			end = mid;
-		}
-	}
-
-	end = keyframes.count;
-	for (; begin < end; begin++) {
-		const ufbx_baked_vec3 *next = &keys[begin];
-		if (next->time <= time) continue;
-		if (begin == 0) return next->value;
-
-		const ufbx_baked_vec3 *prev = next - 1;
-		double t = (time - prev->time) / (next->time - prev->time);
-		return ufbxi_lerp3(prev->value, next->value, (ufbx_real)t);
-	}
+	ufbx_assert(compiled);
+	if (!compiled) return 0;
 
-	return keyframes.data[keyframes.count - 1].value;
-}
+	const ufbxi_compiled_anim_imp *imp = ufbxi_get_imp(ufbxi_compiled_anim_imp, compiled);
+	ufbx_assert(imp->magic == UFBXI_COMPILED_ANIM_IMP_MAGIC);
+	if (imp->magic != UFBXI_COMPILED_ANIM_IMP_MAGIC) return 0;
 
-ufbx_abi ufbx_quat ufbx_evaluate_baked_quat(ufbx_baked_quat_list keyframes, double time)
-{
-	size_t begin = 0;
-	size_t end = keyframes.count;
-	const ufbx_baked_quat *keys = keyframes.data;
-	while (end - begin >= 8) {
-		size_t mid = (begin + end) >> 1;
-		if (keys[mid].time <= time) {
-			begin = mid + 1;
+	size_t num_nodes = ufbxi_min_sz(compiled->num_nodes, num_transforms);
+	const ufbxi_compiled_curve *curves = imp->curves;
+	for (size_t i = 0; i < num_nodes; i++) {
+		const ufbxi_compiled_node *cn = &imp->nodes[i];
+		if (cn->kind == UFBXI_COMPILED_NODE_STATIC) {
+			transforms[i] = cn->transform;
+		} else if (cn->kind == UFBXI_COMPILED_NODE_CURVES) {
+			ufbx_vec3 values[3] = { cn->values[0], cn->values[1], cn->values[2] };
+			for (uint32_t ci = cn->curve_begin; ci != cn->curve_end; ci++) {
+				const ufbxi_compiled_curve *curve = &curves[ci];
+				ufbx_real *dst = &values[curve->channel].v[curve->axis];
+				*dst = ufbx_evaluate_curve(curve->curve, time, *dst);
+			}
+			transforms[i] = ufbxi_compose_transform(&cn->pivots, values[0], values[1], values[2], cn->rotation_order, cn->node, NULL);
 		} else {
-			end = mid;
+			transforms[i] = ufbx_evaluate_transform(imp->anim, cn->node, time);
 		}
 	}
 
-	end = keyframes.count;
-	for (; begin < end; begin++) {
-		const ufbx_baked_quat *next = &keys[begin];
-		if (next->time <= time) continue;
-		if (begin == 0) return next->value;
-
-		const ufbx_baked_quat *prev = next - 1;
-		double t = (time - prev->time) / (next->time - prev->time);
-		return ufbx_quat_slerp(prev->value, next->value, (ufbx_real)t);
-	}
-
-	return keyframes.data[keyframes.count - 1].value;
+	return num_nodes;
 }
 
 ufbx_abi ufbx_texture *ufbx_find_prop_texture_len(const ufbx_material *material, const char *name, size_t name_len)
@@ -29740,6 +36635,23 @@ ufbx_abi ufbxi_noinline ufbx_matrix ufbx_matrix_mul(const ufbx_matrix *a, const
 
 	ufbx_matrix dst;
 
+#if UFBXI_HAS_SSE && !defined(UFBX_REAL_IS_FLOAT)
+	// Columns are contiguous so the X/Y rows of each column can be computed as a pair,
+	// the operation order matches the scalar version below.
+	__m128d a0 = _mm_loadu_pd(&a->m00), a1 = _mm_loadu_pd(&a->m01);
+	__m128d a2 = _mm_loadu_pd(&a->m02), a3 = _mm_loadu_pd(&a->m03);
+	for (size_t i = 0; i < 4; i++) {
+		const ufbx_vec3 *c = &b->cols[i];
+		__m128d xy = _mm_add_pd(_mm_add_pd(_mm_mul_pd(a0, _mm_set1_pd(c->x)), _mm_mul_pd(a1, _mm_set1_pd(c->y))), _mm_mul_pd(a2, _mm_set1_pd(c->z)));
+		double z = a->m20*c->x + a->m21*c->y + a->m22*c->z;
+		if (i == 3) {
+			xy = _mm_add_pd(xy, a3);
+			z += a->m23;
+		}
+		_mm_storeu_pd(&dst.cols[i].x, xy);
+		dst.cols[i].z = z;
+	}
+#else
 	dst.m03 = a->m00*b->m03 + a->m01*b->m13 + a->m02*b->m23 + a->m03;
 	dst.m13 = a->m10*b->m03 + a->m11*b->m13 + a->m12*b->m23 + a->m13;
 	dst.m23 = a->m20*b->m03 + a->m21*b->m13 + a->m22*b->m23 + a->m23;
@@ -29755,6 +36667,7 @@ ufbx_abi ufbxi_noinline ufbx_matrix ufbx_matrix_mul(const ufbx_matrix *a, const
 	dst.m02 = a->m00*b->m02 + a->m01*b->m12 + a->m02*b->m22;
 	dst.m12 = a->m10*b->m02 + a->m11*b->m12 + a->m12*b->m22;
 	dst.m22 = a->m20*b->m02 + a->m21*b->m12 + a->m22*b->m22;
+#endif
 
 	return dst;
 }
@@ -30036,6 +36949,58 @@ ufbx_abi ufbxi_noinline ufbx_matrix ufbx_catch_get_skin_vertex_matrix(ufbx_panic
 	return mat;
 }
 
+ufbx_abi ufbxi_noinline size_t ufbx_update_skin_vertices(const ufbx_skin_deformer *skin, const uint32_t *changed_clusters, size_t num_changed_clusters,
+	const ufbx_vec3 *rest_positions, ufbx_vec3 *positions, size_t num_vertices, const ufbx_matrix *fallback)
+{
+	ufbx_assert(skin);
+	if (!skin) return 0;
+	ufbx_assert(num_changed_clusters == 0 || (changed_clusters && rest_positions && positions));
+
+	// Vertices influenced by multiple changed clusters are skinned only by the first
+	// one, this requires a sorted list for the binary search below.
+	bool sorted = true;
+	for (size_t i = 1; i < num_changed_clusters; i++) {
+		if (changed_clusters[i - 1] >= changed_clusters[i]) {
+			sorted = false;
+			break;
+		}
+	}
+
+	size_t num_skinned = 0;
+	for (size_t changed_ix = 0; changed_ix < num_changed_clusters; changed_ix++) {
+		uint32_t cluster_ix = changed_clusters[changed_ix];
+		if (cluster_ix >= skin->clusters.count) continue;
+		const ufbx_skin_cluster *cluster = skin->clusters.data[cluster_ix];
+
+		ufbxi_for_list(uint32_t, p_vertex, cluster->vertices) {
+			uint32_t vertex = *p_vertex;
+			if (vertex >= num_vertices || vertex >= skin->vertices.count) continue;
+
+			if (sorted && changed_ix > 0) {
+				ufbx_skin_vertex skin_vertex = skin->vertices.data[vertex];
+				bool skinned = false;
+				for (uint32_t i = 0; i < skin_vertex.num_weights && !skinned; i++) {
+					uint32_t weight_cluster = skin->weights.data[skin_vertex.weight_begin + i].cluster_index;
+					if (weight_cluster >= cluster_ix) continue;
+					size_t lo = 0, hi = changed_ix;
+					while (lo < hi) {
+						size_t mid = lo + (hi - lo) / 2;
+						if (changed_clusters[mid] < weight_cluster) lo = mid + 1; else hi = mid;
+					}
+					skinned = lo < changed_ix && changed_clusters[lo] == weight_cluster;
+				}
+				if (skinned) continue;
+			}
+
+			ufbx_matrix mat = ufbx_get_skin_vertex_matrix(skin, vertex, fallback);
+			positions[vertex] = ufbx_transform_position(&mat, rest_positions[vertex]);
+			num_skinned++;
+		}
+	}
+
+	return num_skinned;
+}
+
 ufbx_abi ufbxi_noinline uint32_t ufbx_get_blend_shape_offset_index(const ufbx_blend_shape *shape, size_t vertex)
 {
 	ufbx_assert(shape);
@@ -30083,15 +37048,7 @@ ufbx_abi void ufbx_add_blend_shape_vertex_offsets(const ufbx_blend_shape *shape,
 	if (weight == 0.0f) return;
 	if (!vertices) return;
 
-	size_t num_offsets = shape->num_offsets;
-	uint32_t *vertex_indices = shape->offset_vertices.data;
-	ufbx_vec3 *offsets = shape->position_offsets.data;
-	for (size_t i = 0; i < num_offsets; i++) {
-		uint32_t index = vertex_indices[i];
-		if (index < num_vertices) {
-			ufbxi_add_weighted_vec3(&vertices[index], offsets[i], weight);
-		}
-	}
+	ufbxi_add_blend_offsets(vertices, num_vertices, shape->offset_vertices.data, shape->position_offsets.data, shape->num_offsets, weight);
 }
 
 ufbx_abi void ufbx_add_blend_vertex_offsets(const ufbx_blend_deformer *blend, ufbx_vec3 *vertices, size_t num_vertices, ufbx_real weight)
@@ -30108,6 +37065,151 @@ ufbx_abi void ufbx_add_blend_vertex_offsets(const ufbx_blend_deformer *blend, uf
 	}
 }
 
+ufbx_abi size_t ufbx_get_blend_shape_weights(const ufbx_blend_deformer *blend, const ufbx_real *channel_weights, size_t num_channel_weights, ufbx_real *shape_weights, size_t num_shape_weights)
+{
+	ufbx_assert(blend);
+	if (!blend) return 0;
+	if (!shape_weights) num_shape_weights = 0;
+
+	size_t num_shapes = 0;
+	for (size_t chan_ix = 0; chan_ix < blend->channels.count; chan_ix++) {
+		const ufbx_blend_channel *chan = blend->channels.data[chan_ix];
+		size_t base = num_shapes;
+		size_t num_keys = chan->keyframes.count;
+		num_shapes += num_keys;
+		if (base >= num_shape_weights) continue;
+
+		ufbx_real *weights = shape_weights + base;
+		size_t num_weights = ufbxi_min_sz(num_keys, num_shape_weights - base);
+		for (size_t i = 0; i < num_weights; i++) {
+			weights[i] = 0.0f;
+		}
+
+		ufbx_real weight = channel_weights && chan_ix < num_channel_weights ? channel_weights[chan_ix] : chan->weight;
+		ptrdiff_t prev, next;
+		ufbx_real t;
+		if (ufbxi_find_blend_keyframes(chan->keyframes.data, (ptrdiff_t)num_keys, weight, &prev, &next, &t)) {
+			if (prev >= 0 && (size_t)prev < num_weights) weights[prev] = 1.0f - t;
+			if (next >= 0 && (size_t)next < num_weights) weights[next] = t;
+		}
+	}
+
+	return num_shapes;
+}
+
+ufbx_abi void ufbx_add_weighted_blend_vertex_offsets(const ufbx_blend_deformer *blend, const ufbx_real *shape_weights, size_t num_shape_weights, ufbx_vec3 *vertices, size_t num_vertices)
+{
+	ufbx_assert(blend);
+	if (!blend || !vertices) return;
+
+	size_t shape_ix = 0;
+	ufbxi_for_ptr_list(ufbx_blend_channel, p_chan, blend->channels) {
+		ufbxi_for_list(ufbx_blend_keyframe, key, (*p_chan)->keyframes) {
+			if (shape_ix >= num_shape_weights) return;
+			ufbx_real weight = shape_weights[shape_ix++];
+			if (weight == 0.0f) continue;
+
+			const ufbx_blend_shape *shape = key->shape;
+			ufbxi_add_blend_offsets(vertices, num_vertices, shape->offset_vertices.data, shape->position_offsets.data, shape->num_offsets, weight);
+		}
+	}
+}
+
+ufbx_abi ufbx_blend_vertex_layout *ufbx_create_blend_vertex_layout(const ufbx_blend_deformer *blend, const ufbx_blend_vertex_layout_opts *opts, ufbx_error *error)
+{
+	ufbx_assert(blend);
+
+	ufbxi_blend_layout_context lc = { UFBX_ERROR_NONE };
+	if (opts) {
+		lc.opts = *opts;
+	}
+	lc.blend = blend;
+
+	uint32_t *counts = NULL;
+	size_t num_counts = 0;
+	int ok = ufbxi_create_blend_vertex_layout_imp(&lc, &counts, &num_counts);
+
+	ufbxi_free(&lc.ator_tmp, uint32_t, counts, num_counts);
+	ufbxi_free_ator(&lc.ator_tmp);
+
+	if (ok) {
+		ufbxi_clear_error(error);
+		ufbxi_blend_vertex_layout_imp *imp = lc.imp;
+		return &imp->layout;
+	} else {
+		ufbxi_fix_error_type(&lc.error, "Failed to create blend vertex layout");
+		if (error) *error = lc.error;
+		ufbxi_buf_free(&lc.result);
+		ufbxi_free_ator(&lc.ator_result);
+		return NULL;
+	}
+}
+
+ufbx_abi void ufbx_retain_blend_vertex_layout(ufbx_blend_vertex_layout *layout)
+{
+	if (!layout) return;
+
+	ufbxi_blend_vertex_layout_imp *imp = ufbxi_get_imp(ufbxi_blend_vertex_layout_imp, layout);
+	ufbx_assert(imp->magic == UFBXI_BLEND_VERTEX_LAYOUT_IMP_MAGIC);
+	if (imp->magic != UFBXI_BLEND_VERTEX_LAYOUT_IMP_MAGIC) return;
+	ufbxi_retain_ref(&imp->refcount);
+}
+
+ufbx_abi void ufbx_free_blend_vertex_layout(ufbx_blend_vertex_layout *layout)
+{
+	if (!layout) return;
+
+	ufbxi_blend_vertex_layout_imp *imp = ufbxi_get_imp(ufbxi_blend_vertex_layout_imp, layout);
+	ufbx_assert(imp->magic == UFBXI_BLEND_VERTEX_LAYOUT_IMP_MAGIC);
+	if (imp->magic != UFBXI_BLEND_VERTEX_LAYOUT_IMP_MAGIC) return;
+	ufbxi_release_ref(&imp->refcount);
+}
+
+ufbx_abi ufbxi_noinline void ufbx_add_blend_vertex_layout_offsets(const ufbx_blend_vertex_layout *layout, const ufbx_real *shape_weights, size_t num_shape_weights, ufbx_vec3 *vertices, size_t num_vertices)
+{
+	ufbx_assert(layout);
+	if (!layout || !vertices) return;
+	if (!shape_weights) num_shape_weights = 0;
+
+	const uint32_t *offset_begin = layout->offset_begin.data;
+	const uint32_t *offset_shapes = layout->offset_shapes.data;
+	const ufbx_vec3 *offsets = layout->position_offsets.data;
+
+	// Accumulate each vertex in registers, adding the offsets in shape order
+	// so that the result matches `ufbx_add_weighted_blend_vertex_offsets()` exactly.
+	for (size_t vi = 0; vi < layout->vertices.count; vi++) {
+		uint32_t index = layout->vertices.data[vi];
+		if (index >= num_vertices) break;
+
+		uint32_t begin = offset_begin[vi], end = offset_begin[vi + 1];
+		ufbx_vec3 *v = &vertices[index];
+#if UFBXI_HAS_SSE && !defined(UFBX_REAL_IS_FLOAT)
+		__m128d xy = _mm_loadu_pd(&v->x);
+		double z = v->z;
+		for (uint32_t i = begin; i < end; i++) {
+			uint32_t shape = offset_shapes[i];
+			if (shape >= num_shape_weights) break;
+			double weight = shape_weights[shape];
+			if (weight == 0.0) continue;
+			xy = _mm_add_pd(xy, _mm_mul_pd(_mm_loadu_pd(&offsets[i].x), _mm_set1_pd(weight)));
+			z += offsets[i].z * weight;
+		}
+		_mm_storeu_pd(&v->x, xy);
+		v->z = z;
+#else
+		ufbx_vec3 pos = *v;
+		for (uint32_t i = begin; i < end; i++) {
+			uint32_t shape = offset_shapes[i];
+			if (shape >= num_shape_weights) break;
+			ufbx_real weight = shape_weights[shape];
+			if (weight == 0.0f) continue;
+			ufbxi_add_weighted_vec3(&pos, offsets[i], weight);
+		}
+		*v = pos;
+#endif
+	}
+}
+
 ufbx_abi size_t ufbx_evaluate_nurbs_basis(const ufbx_nurbs_basis *basis, ufbx_real u, ufbx_real *weights, size_t num_weights, ufbx_real *derivatives, size_t num_derivatives)
 {
 	ufbx_assert(basis);
@@ -30413,85 +37515,33 @@ ufbx_abi ufbxi_noinline uint32_t ufbx_catch_triangulate_face(ufbx_panic *panic,
 	if (ufbxi_panicf(panic, face.index_begin < mesh->num_indices, "Face index begin (%u) out of bounds (%zu)", face.index_begin, mesh->num_indices)) return 0;
 	if (ufbxi_panicf(panic, mesh->num_indices - face.index_begin >= face.num_indices, "Face index end (%u + %u) out of bounds (%zu)", face.index_begin, face.num_indices, mesh->num_indices)) return 0;
 
-	if (face.num_indices == 3) {
-		// Fast case: Already a triangle
-		indices[0] = face.index_begin + 0;
-		indices[1] = face.index_begin + 1;
-		indices[2] = face.index_begin + 2;
-		return 1;
-	} else if (face.num_indices == 4) {
-		// Quad: Split along the shortest axis unless a vertex crosses the axis
-		uint32_t i0 = face.index_begin + 0;
-		uint32_t i1 = face.index_begin + 1;
-		uint32_t i2 = face.index_begin + 2;
-		uint32_t i3 = face.index_begin + 3;
-		ufbx_vec3 v0 = mesh->vertex_position.values.data[mesh->vertex_position.indices.data[i0]];
-		ufbx_vec3 v1 = mesh->vertex_position.values.data[mesh->vertex_position.indices.data[i1]];
-		ufbx_vec3 v2 = mesh->vertex_position.values.data[mesh->vertex_position.indices.data[i2]];
-		ufbx_vec3 v3 = mesh->vertex_position.values.data[mesh->vertex_position.indices.data[i3]];
-
-		ufbx_vec3 a = ufbxi_sub3(v2, v0);
-		ufbx_vec3 b = ufbxi_sub3(v3, v1);
-
-		ufbx_vec3 na1 = ufbxi_normalize3(ufbxi_cross3(a, ufbxi_sub3(v1, v0)));
-		ufbx_vec3 na3 = ufbxi_normalize3(ufbxi_cross3(a, ufbxi_sub3(v0, v3)));
-		ufbx_vec3 nb0 = ufbxi_normalize3(ufbxi_cross3(b, ufbxi_sub3(v1, v0)));
-		ufbx_vec3 nb2 = ufbxi_normalize3(ufbxi_cross3(b, ufbxi_sub3(v2, v1)));
-
-		ufbx_real dot_aa = ufbxi_dot3(a, a);
-		ufbx_real dot_bb = ufbxi_dot3(b, b);
-		ufbx_real dot_na = ufbxi_dot3(na1, na3);
-		ufbx_real dot_nb = ufbxi_dot3(nb0, nb2);
-
-		bool split_a = dot_aa <= dot_bb;
-
-		if (dot_na < 0.0f || dot_nb < 0.0f) {
-			split_a = dot_na >= dot_nb;
-		}
-
-		if (split_a) {
-			indices[0] = i0;
-			indices[1] = i1;
-			indices[2] = i2;
-			indices[3] = i2;
-			indices[4] = i3;
-			indices[5] = i0;
-		} else {
-			indices[0] = i1;
-			indices[1] = i2;
-			indices[2] = i3;
-			indices[3] = i3;
-			indices[4] = i0;
-			indices[5] = i1;
-		}
-
-		return 2;
-	} else {
-		ufbxi_ngon_context nc = { 0 };
-		nc.positions = mesh->vertex_position;
-		nc.face = face;
-
-		uint32_t num_indices_u32 = num_indices < UINT32_MAX ? (uint32_t)num_indices : UINT32_MAX;
-
-		uint32_t local_indices[12];
-		if (num_indices_u32 < 12) {
-			uint32_t num_tris = ufbxi_triangulate_ngon(&nc, local_indices, 12);
-			memcpy(indices, local_indices, num_tris * 3 * sizeof(uint32_t));
-			return num_tris;
-		} else {
-			return ufbxi_triangulate_ngon(&nc, indices, num_indices_u32);
-		}
-	}
+	return ufbxi_triangulate_face_imp(indices, num_indices, mesh, face, NULL);
 #else
 	ufbxi_panicf_imp(panic, "Triangulation disabled");
 	return 0;
 #endif
 }
 
+ufbx_abi bool ufbx_triangulate_mesh(const ufbx_mesh *mesh, uint32_t *indices, size_t num_indices, const ufbx_triangulate_mesh_opts *opts, ufbx_error *error)
+{
+	ufbx_assert(mesh);
+	ufbx_error local_error;
+	if (!error) {
+		error = &local_error;
+	}
+	memset(error, 0, sizeof(ufbx_error));
+	return ufbxi_triangulate_mesh(mesh, indices, num_indices, opts, error);
+}
+
 ufbx_abi void ufbx_catch_compute_topology(ufbx_panic *panic, const ufbx_mesh *mesh, ufbx_topo_edge *indices, size_t num_indices)
 {
 	if (ufbxi_panicf(panic, num_indices >= mesh->num_indices, "Required mesh.num_indices (%zu) indices, got %zu", mesh->num_indices, num_indices)) return;
 
+	if (mesh->topology.count == mesh->num_indices && mesh->num_indices > 0) {
+		memcpy(indices, mesh->topology.data, mesh->num_indices * sizeof(ufbx_topo_edge));
+		return;
+	}
+
 	ufbxi_compute_topology(mesh, indices);
 }
 
@@ -31053,11 +38103,70 @@ ufbx_abi size_t ufbx_generate_indices(const ufbx_vertex_stream *streams, size_t
 	return ufbxi_generate_indices(streams, num_streams, indices, num_indices, allocator, error);
 }
 
+ufbx_abi bool ufbx_optimize_indices(const ufbx_vertex_stream *streams, size_t num_streams, uint32_t *indices, size_t num_indices, size_t num_vertices, const ufbx_optimize_indices_opts *opts, ufbx_error *error)
+{
+	ufbx_error local_error;
+	if (!error) {
+		error = &local_error;
+	}
+	memset(error, 0, sizeof(ufbx_error));
+	return ufbxi_optimize_indices(streams, num_streams, indices, num_indices, num_vertices, opts, error);
+}
+
+ufbx_abi ufbx_mesh_buffers *ufbx_create_mesh_buffers(const ufbx_mesh *mesh, const ufbx_mesh_buffers_opts *opts, ufbx_error *error)
+{
+	ufbx_assert(mesh);
+	ufbx_error local_error;
+	if (!error) {
+		error = &local_error;
+	}
+	memset(error, 0, sizeof(ufbx_error));
+	return ufbxi_create_mesh_buffers(mesh, opts, error);
+}
+
+ufbx_abi void ufbx_retain_mesh_buffers(ufbx_mesh_buffers *buffers)
+{
+	if (!buffers) return;
+
+	ufbxi_mesh_buffers_imp *imp = ufbxi_get_imp(ufbxi_mesh_buffers_imp, buffers);
+	ufbx_assert(imp->magic == UFBXI_MESH_BUFFERS_IMP_MAGIC);
+	if (imp->magic != UFBXI_MESH_BUFFERS_IMP_MAGIC) return;
+	ufbxi_retain_ref(&imp->refcount);
+}
+
+ufbx_abi void ufbx_free_mesh_buffers(ufbx_mesh_buffers *buffers)
+{
+	if (!buffers) return;
+
+	ufbxi_mesh_buffers_imp *imp = ufbxi_get_imp(ufbxi_mesh_buffers_imp, buffers);
+	ufbx_assert(imp->magic == UFBXI_MESH_BUFFERS_IMP_MAGIC);
+	if (imp->magic != UFBXI_MESH_BUFFERS_IMP_MAGIC) return;
+	ufbxi_release_ref(&imp->refcount);
+}
+
+ufbx_abi bool ufbx_pack_skin_weights(const ufbx_skin_deformer *skin, const uint32_t *vertices, size_t num_vertices,
+	void *bone_indices, void *bone_weights, const ufbx_pack_skin_weights_opts *opts, ufbx_error *error)
+{
+	ufbx_assert(skin);
+	ufbx_error local_error;
+	if (!error) {
+		error = &local_error;
+	}
+	memset(error, 0, sizeof(ufbx_error));
+	return ufbxi_pack_skin_weights(skin, vertices, num_vertices, bone_indices, bone_weights, opts, error);
+}
+
 ufbx_abi void ufbx_thread_pool_run_task(ufbx_thread_pool_context ctx, uint32_t index)
 {
 	ufbxi_thread_pool_execute((ufbxi_thread_pool*)ctx, index);
 }
 
+ufbx_abi double ufbx_thread_pool_get_task_cost(ufbx_thread_pool_context ctx, uint32_t index)
+{
+	ufbxi_thread_pool *pool = (ufbxi_thread_pool*)ctx;
+	return pool->tasks[index % pool->num_tasks].cost;
+}
+
 ufbx_abi void ufbx_thread_pool_set_user_ptr(ufbx_thread_pool_context ctx, void *user)
 {
 	ufbxi_thread_pool *pool = (ufbxi_thread_pool*)ctx;
@@ -335,7 +335,10 @@ typedef struct ufbx_void_list {
 } ufbx_void_list;
 
 UFBX_LIST_TYPE(ufbx_bool_list, bool);
+UFBX_LIST_TYPE(ufbx_uint16_list, uint16_t);
 UFBX_LIST_TYPE(ufbx_uint32_list, uint32_t);
+UFBX_LIST_TYPE(ufbx_float_list, float);
+UFBX_LIST_TYPE(ufbx_double_list, double);
 UFBX_LIST_TYPE(ufbx_real_list, ufbx_real);
 UFBX_LIST_TYPE(ufbx_vec2_list, ufbx_vec2);
 UFBX_LIST_TYPE(ufbx_vec3_list, ufbx_vec3);
@@ -1024,6 +1027,26 @@ typedef struct ufbx_face {
 
 UFBX_LIST_TYPE(ufbx_face_list, ufbx_face);
 
+typedef enum ufbx_topo_flags UFBX_FLAG_REPR {
+	UFBX_TOPO_NON_MANIFOLD = 0x1, // < Edge with three or more faces
+
+	UFBX_FLAG_FORCE_WIDTH(UFBX_TOPO_FLAGS)
+} ufbx_topo_flags;
+
+// Half-edge starting from a mesh index, see `ufbx_compute_topology()`
+typedef struct ufbx_topo_edge {
+	uint32_t index; // < Starting index of the edge, always defined
+	uint32_t next;  // < Ending index of the edge / next per-face `ufbx_topo_edge`, always defined
+	uint32_t prev;  // < Previous per-face `ufbx_topo_edge`, always defined
+	uint32_t twin;  // < `ufbx_topo_edge` on the opposite side, `UFBX_NO_INDEX` if not found
+	uint32_t face;  // < Index into `mesh->faces[]`, always defined
+	uint32_t edge;  // < Index into `mesh->edges[]`, `UFBX_NO_INDEX` if not found
+
+	ufbx_topo_flags flags;
+} ufbx_topo_edge;
+
+UFBX_LIST_TYPE(ufbx_topo_edge_list, ufbx_topo_edge);
+
 // Subset of mesh faces used by a single material or group.
 typedef struct ufbx_mesh_part {
 
@@ -1208,6 +1231,14 @@ struct ufbx_mesh {
 	// First index referring to a given vertex, `UFBX_NO_INDEX` if the vertex is unused.
 	ufbx_uint32_list vertex_first_index;
 
+	// Triangulated faces as indices to `vertex_*.indices[]`, contains `num_triangles * 3` indices.
+	// Only present if loaded with `ufbx_load_opts.store_triangle_indices`, see `ufbx_triangulate_mesh()`.
+	ufbx_uint32_list triangle_indices;
+
+	// Half-edge topology indexed by `vertex_*.indices[]`, contains `num_indices` edges.
+	// Only present if loaded with `ufbx_load_opts.compute_topology`, see `ufbx_compute_topology()`.
+	ufbx_topo_edge_list topology;
+
 	// Vertex attributes, see the comment over the struct.
 	//
 	// NOTE: Not all meshes have all attributes, in that case `indices/data == NULL`!
@@ -3018,6 +3049,14 @@ typedef struct ufbx_keyframe {
 
 UFBX_LIST_TYPE(ufbx_keyframe_list, ufbx_keyframe);
 
+// Remembers the keyframe segment found by the previous evaluation, so that sampling
+// at increasing (or nearby) times finds the next keyframe in constant time.
+// Use one cursor per curve, see `ufbx_evaluate_curve_cursor()`.
+// NOTE: Initialize to zero with `{ 0 }` (C) or `{ }` (C++)
+typedef struct ufbx_curve_cursor {
+	size_t index; // < Index of the first keyframe after the previously evaluated time
+} ufbx_curve_cursor;
+
 struct ufbx_anim_curve {
 	union { ufbx_element element; struct {
 		ufbx_string name;
@@ -3383,6 +3422,66 @@ typedef struct ufbx_thumbnail {
 	ufbx_blob data;
 } ufbx_thumbnail;
 
+// Stage of loading a scene, see `ufbx_load_stats`.
+// Time spent in nested phases is only counted in the innermost phase, eg.
+// reading and decompressing array data is excluded from `UFBX_LOAD_PHASE_READ_OBJECTS`.
+typedef enum ufbx_load_phase UFBX_ENUM_REPR {
+
+	// Reading data from the file or stream via `ufbx_stream.read_fn`.
+	UFBX_LOAD_PHASE_IO,
+
+	// Parsing the file, except for the separately counted phases below.
+	UFBX_LOAD_PHASE_PARSE,
+
+	// Decompressing DEFLATE compressed arrays.
+	UFBX_LOAD_PHASE_INFLATE,
+
+	// Reading the `Objects` section into elements.
+	UFBX_LOAD_PHASE_READ_OBJECTS,
+
+	// Reading and resolving connections between elements.
+	UFBX_LOAD_PHASE_CONNECTIONS,
+
+	// Building the final scene and post-processing it.
+	UFBX_LOAD_PHASE_FINALIZE,
+
+	// Evaluating skinning, see `ufbx_load_opts.evaluate_skinning`.
+	UFBX_LOAD_PHASE_SKINNING,
+
+	// Loading external files, see `ufbx_load_opts.load_external_files`.
+	UFBX_LOAD_PHASE_CACHES,
+
+	UFBX_ENUM_FORCE_WIDTH(UFBX_LOAD_PHASE)
+} ufbx_load_phase;
+
+UFBX_ENUM_TYPE(ufbx_load_phase, UFBX_LOAD_PHASE, UFBX_LOAD_PHASE_CACHES);
+
+typedef struct ufbx_load_phase_stats {
+	double wall_time; // < Elapsed real time in seconds
+	double cpu_time;  // < Processor time in seconds (of the whole process)
+
+	uint64_t bytes_read;     // < Bytes read from the input
+	uint64_t bytes_inflated; // < Bytes produced by decompression
+
+	size_t temp_allocs;   // < Number of temporary allocations
+	size_t result_allocs; // < Number of result allocations
+
+	size_t temp_memory_peak;   // < Highest amount of temporary memory allocated during the phase
+	size_t result_memory_peak; // < Highest amount of result memory allocated during the phase
+} ufbx_load_phase_stats;
+
+// Per-phase statistics of loading, see `ufbx_load_opts.collect_stats`.
+// NOTE: Only work done on the calling thread is measured.
+typedef struct ufbx_load_stats {
+	// Statistics have been collected.
+	bool enabled;
+
+	double wall_time; // < Total elapsed real time in seconds
+	double cpu_time;  // < Total processor time in seconds
+
+	ufbx_load_phase_stats phases[UFBX_LOAD_PHASE_COUNT];
+} ufbx_load_stats;
+
 // Miscellaneous data related to the loaded file
 typedef struct ufbx_metadata {
 
@@ -3450,6 +3549,16 @@ typedef struct ufbx_metadata {
 	size_t result_allocs;
 	size_t temp_allocs;
 
+	// Highest amount of temporary memory allocated at once during loading.
+	size_t temp_memory_peak;
+	// Highest amount of temporary and result memory allocated at once during loading.
+	// Temporary data is released progressively so this is usually noticeably less
+	// than the sum of `temp_memory_peak` and `result_memory_used`.
+	size_t memory_peak;
+
+	// Per-phase timing and memory statistics if `ufbx_load_opts.collect_stats` is set.
+	ufbx_load_stats load_stats;
+
 	size_t element_buffer_size;
 	size_t num_shader_textures;
 
@@ -3660,25 +3769,6 @@ typedef struct ufbx_surface_point {
 	ufbx_vec3 derivative_v;
 } ufbx_surface_point;
 
-// -- Mesh topology
-
-typedef enum ufbx_topo_flags UFBX_FLAG_REPR {
-	UFBX_TOPO_NON_MANIFOLD = 0x1, // < Edge with three or more faces
-
-	UFBX_FLAG_FORCE_WIDTH(UFBX_TOPO_FLAGS)
-} ufbx_topo_flags;
-
-typedef struct ufbx_topo_edge {
-	uint32_t index; // < Starting index of the edge, always defined
-	uint32_t next;  // < Ending index of the edge / next per-face `ufbx_topo_edge`, always defined
-	uint32_t prev;  // < Previous per-face `ufbx_topo_edge`, always defined
-	uint32_t twin;  // < `ufbx_topo_edge` on the opposite side, `UFBX_NO_INDEX` if not found
-	uint32_t face;  // < Index into `mesh->faces[]`, always defined
-	uint32_t edge;  // < Index into `mesh->edges[]`, `UFBX_NO_INDEX` if not found
-
-	ufbx_topo_flags flags;
-} ufbx_topo_edge;
-
 typedef struct ufbx_vertex_stream {
 	void *data;
 	size_t vertex_count;
@@ -3922,10 +4012,14 @@ typedef enum ufbx_error_type UFBX_ENUM_REPR {
 	// Duplicated override property in `ufbx_create_anim()`
 	UFBX_ERROR_DUPLICATE_OVERRIDE,
 
+	// Scene snapshot is corrupted or has been saved by an incompatible build of ufbx.
+	// See `ufbx_load_scene_snapshot()`.
+	UFBX_ERROR_BAD_SNAPSHOT,
+
 	UFBX_ENUM_FORCE_WIDTH(UFBX_ERROR_TYPE)
 } ufbx_error_type;
 
-UFBX_ENUM_TYPE(ufbx_error_type, UFBX_ERROR_TYPE, UFBX_ERROR_DUPLICATE_OVERRIDE);
+UFBX_ENUM_TYPE(ufbx_error_type, UFBX_ERROR_TYPE, UFBX_ERROR_BAD_SNAPSHOT);
 
 // Error description with detailed stack trace
 // HINT: You can use `ufbx_format_error()` for formatting the error
@@ -3965,6 +4059,23 @@ typedef struct ufbx_progress_cb {
 		(progress))
 } ufbx_progress_cb;
 
+// -- Tracing
+
+// Called when ufbx enters or leaves a named stage of work, eg. a phase of loading
+// or a thread pool task. `name` is a static string that stays valid forever.
+// Zones are always properly nested per thread, `end_fn()` is called with the same
+// `name` as the matching `begin_fn()` even if the operation fails.
+// NOTE: Called from thread pool tasks as well, so the callbacks must be thread-safe
+// if `ufbx_load_opts.thread_opts` is used.
+typedef void ufbx_trace_begin_fn(void *user, const char *name);
+typedef void ufbx_trace_end_fn(void *user, const char *name);
+
+typedef struct ufbx_trace_cb {
+	ufbx_trace_begin_fn *begin_fn;
+	ufbx_trace_end_fn *end_fn;
+	void *user;
+} ufbx_trace_cb;
+
 // -- Inflate
 
 typedef struct ufbx_inflate_input ufbx_inflate_input;
@@ -4165,6 +4276,199 @@ typedef struct ufbx_baked_anim {
 	ufbx_baked_element_list elements;
 } ufbx_baked_anim;
 
+// Quantized keyframes of a single baked track, see `ufbx_compress_baked_anim()`.
+// Evaluate using `ufbx_evaluate_compressed_vec3()` or `ufbx_evaluate_compressed_quat()`.
+typedef struct ufbx_compressed_track {
+
+	// Number of keyframes, zero for constant tracks that only have `constant_value`.
+	uint32_t num_keys;
+
+	// Time of the first keyframe in seconds.
+	double time_begin;
+
+	// Keyframe `i` is at `time_begin + i * time_step` if both `times` and `precise_times`
+	// are empty, otherwise at `time_begin + times[i]` (or `precise_times[i]`).
+	// `precise_times` is used if single precision can't separate the keyframes,
+	// eg. due to constant interpolation steps.
+	double time_step;
+	ufbx_float_list times;
+	ufbx_double_list precise_times;
+
+	// Quantized keyframe values, three per keyframe.
+	// Vectors are stored as `range_min + values[i] * range_scale` per component.
+	// Rotations use the "smallest three" encoding: the three smallest components
+	// of the quaternion are quantized to 15 bits and the index of the largest
+	// one is stored in the top bits of the first two values.
+	ufbx_uint16_list values;
+	ufbx_vec3 range_min;
+	ufbx_vec3 range_scale;
+
+	// Value of constant tracks, vectors use only `x`, `y`, and `z`.
+	ufbx_vec4 constant_value;
+
+} ufbx_compressed_track;
+
+typedef struct ufbx_compressed_node {
+	uint32_t typed_id;
+	uint32_t element_id;
+	ufbx_compressed_track translation;
+	ufbx_compressed_track rotation;
+	ufbx_compressed_track scale;
+} ufbx_compressed_node;
+
+UFBX_LIST_TYPE(ufbx_compressed_node_list, ufbx_compressed_node);
+
+typedef struct ufbx_compressed_prop {
+	ufbx_string name;
+	ufbx_compressed_track track;
+} ufbx_compressed_prop;
+
+UFBX_LIST_TYPE(ufbx_compressed_prop_list, ufbx_compressed_prop);
+
+typedef struct ufbx_compressed_element {
+	uint32_t element_id;
+	ufbx_compressed_prop_list props;
+} ufbx_compressed_element;
+
+UFBX_LIST_TYPE(ufbx_compressed_element_list, ufbx_compressed_element);
+
+// Compact version of `ufbx_baked_anim`, see `ufbx_compress_baked_anim()`.
+// Nodes and elements are in the same order as in the source `ufbx_baked_anim`.
+typedef struct ufbx_compressed_anim {
+	ufbx_compressed_node_list nodes;
+	ufbx_compressed_element_list elements;
+
+	// Total size of the keyframe times and values in bytes.
+	size_t key_data_size;
+} ufbx_compressed_anim;
+
+// Animation prepared for evaluating the transforms of all nodes at once,
+// see `ufbx_compile_anim()` and `ufbx_evaluate_pose()`.
+typedef struct ufbx_compiled_anim {
+
+	// Number of nodes in the pose, matches `ufbx_scene.nodes`.
+	size_t num_nodes;
+
+	// Nodes that have a constant transform in the animation.
+	size_t num_static_nodes;
+
+	// Nodes that are evaluated directly from pre-resolved animation curves.
+	size_t num_curve_nodes;
+
+	// Nodes that need to be evaluated using `ufbx_evaluate_transform()`,
+	// eg. due to multiple animation layers, property overrides, connected
+	// properties, or scale helper nodes.
+	size_t num_fallback_nodes;
+
+	// Total number of animation curves evaluated by curve nodes.
+	size_t num_curves;
+
+} ufbx_compiled_anim;
+
+// Vertex-major copy of the shape offsets of a `ufbx_blend_deformer`,
+// see `ufbx_create_blend_vertex_layout()` and `ufbx_add_blend_vertex_layout_offsets()`.
+// Shapes are indexed like in `ufbx_get_blend_shape_weights()`.
+typedef struct ufbx_blend_vertex_layout {
+
+	// Number of shapes (keyframes of all the blend channels) in the layout.
+	size_t num_shapes;
+
+	// Total number of offsets in all the shapes.
+	size_t num_offsets;
+
+	// Sorted indices of the vertices that have offsets in any shape.
+	ufbx_uint32_list vertices;
+
+	// Offsets of `vertices[i]` are stored in `[offset_begin[i], offset_begin[i + 1])`.
+	ufbx_uint32_list offset_begin;
+
+	// Shape index and position offset for each offset.
+	// Offsets of a single vertex are sorted by shape index.
+	ufbx_uint32_list offset_shapes;
+	ufbx_vec3_list position_offsets;
+
+} ufbx_blend_vertex_layout;
+
+// Mesh attribute written by `ufbx_create_mesh_buffers()`.
+typedef enum ufbx_vertex_attrib_type UFBX_ENUM_REPR {
+	UFBX_VERTEX_ATTRIB_POSITION,  // < `ufbx_mesh.vertex_position`
+	UFBX_VERTEX_ATTRIB_NORMAL,    // < `ufbx_mesh.vertex_normal`
+	UFBX_VERTEX_ATTRIB_TANGENT,   // < `ufbx_mesh.uv_sets[set_index].vertex_tangent`
+	UFBX_VERTEX_ATTRIB_BITANGENT, // < `ufbx_mesh.uv_sets[set_index].vertex_bitangent`
+	UFBX_VERTEX_ATTRIB_UV,        // < `ufbx_mesh.uv_sets[set_index].vertex_uv`
+	UFBX_VERTEX_ATTRIB_COLOR,     // < `ufbx_mesh.color_sets[set_index].vertex_color`
+
+	UFBX_ENUM_FORCE_WIDTH(UFBX_VERTEX_ATTRIB_TYPE)
+} ufbx_vertex_attrib_type;
+
+UFBX_ENUM_TYPE(ufbx_vertex_attrib_type, UFBX_VERTEX_ATTRIB_TYPE, UFBX_VERTEX_ATTRIB_COLOR);
+
+// Encoding of a vertex attribute in `ufbx_create_mesh_buffers()`.
+typedef enum ufbx_vertex_format UFBX_ENUM_REPR {
+	UFBX_VERTEX_FORMAT_FLOAT32,     // < `float` per component
+	UFBX_VERTEX_FORMAT_FLOAT16,     // < IEEE 754 half precision float per component
+	UFBX_VERTEX_FORMAT_SNORM16,     // < `int16_t` per component, `[-1, 1]` mapped to `[-32767, 32767]`
+	UFBX_VERTEX_FORMAT_UNORM8,      // < `uint8_t` per component, `[0, 1]` mapped to `[0, 255]`
+
+	// Unit vector as two `int16_t` SNORM components using octahedral mapping.
+	// Decode with: `v = (x, y, 1 - |x| - |y|); if (v.z < 0) v.xy = (1 - |v.yx|) * sign(v.xy); v = normalize(v)`
+	UFBX_VERTEX_FORMAT_OCT_SNORM16,
+
+	UFBX_ENUM_FORCE_WIDTH(UFBX_VERTEX_FORMAT)
+} ufbx_vertex_format;
+
+UFBX_ENUM_TYPE(ufbx_vertex_format, UFBX_VERTEX_FORMAT, UFBX_VERTEX_FORMAT_OCT_SNORM16);
+
+// Description of a single attribute in an interleaved vertex.
+typedef struct ufbx_vertex_attrib_desc {
+	ufbx_vertex_attrib_type type;
+	ufbx_vertex_format format;
+
+	// Number of components to write, from 1 to 4. Components the mesh doesn't have default
+	// to `(0, 0, 0, 1)`, attributes or sets the mesh doesn't have are written as zeros.
+	// Default: 3 for positions and vectors, 2 for UVs, 4 for colors, ignored for `UFBX_VERTEX_FORMAT_OCT_SNORM16`.
+	size_t num_components;
+
+	// Index of the UV or color set to use.
+	size_t set_index;
+
+	// Byte offset of the attribute in the vertex.
+	size_t offset;
+} ufbx_vertex_attrib_desc;
+
+UFBX_LIST_TYPE(ufbx_const_vertex_attrib_desc_list, const ufbx_vertex_attrib_desc);
+
+// Interleaved vertices and indices of a single mesh part.
+typedef struct ufbx_mesh_buffer_part {
+
+	// Index of the part in `ufbx_mesh.material_parts[]`.
+	uint32_t part_index;
+
+	// Number of unique vertices, `vertex_data` contains `num_vertices * vertex_stride` bytes.
+	size_t num_vertices;
+	ufbx_blob vertex_data;
+
+	// Triangle list indices to `vertex_data`, either `uint16_t` or `uint32_t` depending on `index_size`.
+	size_t num_indices;
+	size_t index_size;
+	ufbx_blob index_data;
+
+} ufbx_mesh_buffer_part;
+
+UFBX_LIST_TYPE(ufbx_mesh_buffer_part_list, ufbx_mesh_buffer_part);
+
+// GPU ready vertex and index buffers of a mesh, see `ufbx_create_mesh_buffers()`.
+typedef struct ufbx_mesh_buffers {
+
+	// Size of a single vertex in bytes.
+	size_t vertex_stride;
+
+	// Buffers for each `ufbx_mesh.material_parts[]` in order,
+	// or a single part containing all faces if the mesh has no material parts.
+	ufbx_mesh_buffer_part_list parts;
+
+} ufbx_mesh_buffers;
+
 // -- Thread API
 //
 // NOTE: This API is still experimental and may change.
@@ -4195,6 +4499,33 @@ typedef struct ufbx_thread_opts {
 	size_t memory_limit;
 } ufbx_thread_opts;
 
+// Reusable state for loading many files in sequence, see `ufbx_create_load_context()`.
+// Temporary memory freed by a load is retained in the context and reused by
+// the next one, avoiding allocator churn when loading lots of small files.
+// NOTE: A context may only be used by one load at a time.
+typedef struct ufbx_load_context {
+	// Amount of temporary memory currently retained for future loads.
+	size_t cached_memory;
+
+	// Number of loads that have used this context.
+	size_t num_loads;
+} ufbx_load_context;
+
+// Options for `ufbx_create_load_context()`
+// NOTE: Initialize to zero with `{ 0 }` (C) or `{ }` (C++)
+typedef struct ufbx_load_context_opts {
+	uint32_t _begin_zero;
+
+	// Allocator used for the context and all temporary memory of loads using it.
+	// `allocation_limit` is counted separately for each load.
+	ufbx_allocator_opts allocator;
+
+	// Maximum amount of temporary memory to retain between loads (default 64MB).
+	size_t max_cached_memory;
+
+	uint32_t _end_zero;
+} ufbx_load_context_opts;
+
 // -- Main API
 
 // Options for `ufbx_load_file/memory/stream/stdio()`
@@ -4206,6 +4537,11 @@ typedef struct ufbx_load_opts {
 	ufbx_allocator_opts result_allocator; // < Allocator used for the final scene
 	ufbx_thread_opts thread_opts;         // < Threading options
 
+	// Context to reuse temporary memory from, see `ufbx_create_load_context()`.
+	// Temporary memory is allocated from the context, limits in `temp_allocator`
+	// still apply but its allocator callbacks are not used.
+	ufbx_load_context *load_context;
+
 	// Preferences
 	bool ignore_geometry;    // < Do not load geometry datsa (vertices, indices, etc)
 	bool ignore_animation;   // < Do not load animation curves
@@ -4240,6 +4576,16 @@ typedef struct ufbx_load_opts {
 	// Clean-up skin weights by removing negative, zero and NAN weights.
 	bool clean_skin_weights;
 
+	// Pack the final scene into a single exact-size allocation with the data laid
+	// out in traversal order, eg. all `ufbx_node` structs of `ufbx_scene.nodes[]`
+	// are contiguous. Improves memory locality and removes allocator overhead at the
+	// cost of copying the scene once at the end of loading.
+	// NOTE: Ignored if ufbx is compiled with `UFBX_NO_SCENE_SNAPSHOT`.
+	bool compact_result;
+
+	// Collect per-phase timing and memory statistics to `ufbx_metadata.load_stats`.
+	bool collect_stats;
+
 	// Don't adjust reading the FBX file depending on the detected exporter
 	bool disable_quirks;
 
@@ -4278,6 +4624,16 @@ typedef struct ufbx_load_opts {
 	// You can see if the normals have been generated from `ufbx_mesh.generated_normals`.
 	bool generate_missing_normals;
 
+	// Triangulate all meshes into `ufbx_mesh.triangle_indices`.
+	// Large meshes are triangulated in parallel if `thread_opts` has a thread pool.
+	bool store_triangle_indices;
+
+	// Compute the half-edge topology of all meshes into `ufbx_mesh.topology`.
+	// The stored topology is reused by `generate_missing_normals`, skinning normals,
+	// `ufbx_subdivide_mesh()` and `ufbx_compute_topology()`.
+	// Large meshes are processed in parallel if `thread_opts` has a thread pool.
+	bool compute_topology;
+
 	// Ignore `open_file_cb` when loading the main file.
 	bool open_main_file_with_default;
 
@@ -4312,6 +4668,9 @@ typedef struct ufbx_load_opts {
 	// External file callbacks (defaults to stdio.h)
 	ufbx_open_file_cb open_file_cb;
 
+	// Profiling zone callbacks
+	ufbx_trace_cb trace_cb;
+
 	// How to handle geometry transforms in the nodes.
 	// See `ufbx_geometry_transform_handling` for an explanation.
 	ufbx_geometry_transform_handling geometry_transform_handling;
@@ -4439,6 +4798,13 @@ typedef struct ufbx_evaluate_opts {
 	// External file callbacks (defaults to stdio.h)
 	ufbx_open_file_cb open_file_cb;
 
+	// Profiling zone callbacks
+	ufbx_trace_cb trace_cb;
+
+	// Propagate node transforms of wide hierarchy levels in parallel.
+	// NOTE: Only used for scenes with thousands of nodes.
+	ufbx_thread_opts thread_opts;
+
 	uint32_t _end_zero;
 } ufbx_evaluate_opts;
 
@@ -4492,6 +4858,9 @@ typedef struct ufbx_bake_opts {
 	ufbx_allocator_opts temp_allocator;   // < Allocator used during loading
 	ufbx_allocator_opts result_allocator; // < Allocator used for the final baked animation
 
+	// Profiling zone callbacks
+	ufbx_trace_cb trace_cb;
+
 	// Offset to start the evaluation from.
 	double time_start_offset;
 
@@ -4550,6 +4919,37 @@ typedef struct ufbx_bake_opts {
 	uint32_t _end_zero;
 } ufbx_bake_opts;
 
+// Options for `ufbx_compress_baked_anim()`
+// NOTE: Initialize to zero with `{ 0 }` (C) or `{ }` (C++)
+typedef struct ufbx_compress_anim_opts {
+	uint32_t _begin_zero;
+
+	ufbx_allocator_opts result_allocator; // < Allocator used for the final compressed animation
+
+	// Tracks where all the keyframes are within this distance of the first one
+	// (per component) are collapsed into a constant value.
+	// Default `0.000001`, use negative to disable.
+	double constant_threshold;
+
+	// Maximum deviation in seconds from evenly spaced keyframe times to store
+	// times implicitly in `ufbx_compressed_track.time_step`.
+	// Default `0.000001`, use negative to disable.
+	double uniform_time_threshold;
+
+	uint32_t _end_zero;
+} ufbx_compress_anim_opts;
+
+// Options for `ufbx_compile_anim()`
+// NOTE: Initialize to zero with `{ 0 }` (C) or `{ }` (C++)
+typedef struct ufbx_compile_anim_opts {
+	uint32_t _begin_zero;
+
+	ufbx_allocator_opts temp_allocator;   // < Allocator used during compilation
+	ufbx_allocator_opts result_allocator; // < Allocator used for the final compiled animation
+
+	uint32_t _end_zero;
+} ufbx_compile_anim_opts;
+
 // Options for `ufbx_tessellate_nurbs_curve()`
 // NOTE: Initialize to zero with `{ 0 }` (C) or `{ }` (C++)
 typedef struct ufbx_tessellate_curve_opts {
@@ -4594,6 +4994,9 @@ typedef struct ufbx_subdivide_opts {
 	ufbx_allocator_opts temp_allocator;   // < Allocator used during subdivision
 	ufbx_allocator_opts result_allocator; // < Allocator used for the final mesh
 
+	// Profiling zone callbacks
+	ufbx_trace_cb trace_cb;
+
 	ufbx_subdivision_boundary boundary;
 	ufbx_subdivision_boundary uv_boundary;
 
@@ -4627,6 +5030,113 @@ typedef struct ufbx_subdivide_opts {
 	uint32_t _end_zero;
 } ufbx_subdivide_opts;
 
+// Options for `ufbx_triangulate_mesh()`
+// NOTE: Initialize to zero with `{ 0 }` (C) or `{ }` (C++)
+typedef struct ufbx_triangulate_mesh_opts {
+	uint32_t _begin_zero;
+
+	ufbx_allocator_opts temp_allocator; // < Allocator used during triangulation
+
+	// Triangulate ranges of faces in parallel using a thread pool
+	ufbx_thread_opts thread_opts;
+
+	uint32_t _end_zero;
+} ufbx_triangulate_mesh_opts;
+
+// Options for `ufbx_pack_skin_weights()`
+// NOTE: Initialize to zero with `{ 0 }` (C) or `{ }` (C++)
+typedef struct ufbx_pack_skin_weights_opts {
+	uint32_t _begin_zero;
+
+	ufbx_allocator_opts temp_allocator; // < Allocator used during packing
+
+	// Pack vertices in parallel using a thread pool
+	ufbx_thread_opts thread_opts;
+
+	// Number of influences per vertex, from 1 to 8.
+	// Default: 4
+	size_t max_influences;
+
+	// Write bone indices as `uint16_t` instead of `uint8_t`.
+	bool wide_indices;
+
+	// Write weights as `uint16_t` UNORM instead of `uint8_t` UNORM.
+	bool wide_weights;
+
+	uint32_t _end_zero;
+} ufbx_pack_skin_weights_opts;
+
+// Options for `ufbx_create_blend_vertex_layout()`
+// NOTE: Initialize to zero with `{ 0 }` (C) or `{ }` (C++)
+typedef struct ufbx_blend_vertex_layout_opts {
+	uint32_t _begin_zero;
+
+	ufbx_allocator_opts temp_allocator;   // < Allocator used while building the layout
+	ufbx_allocator_opts result_allocator; // < Allocator used for the final layout
+
+	uint32_t _end_zero;
+} ufbx_blend_vertex_layout_opts;
+
+// Options for `ufbx_optimize_indices()`
+// NOTE: Initialize to zero with `{ 0 }` (C) or `{ }` (C++)
+typedef struct ufbx_optimize_indices_opts {
+	uint32_t _begin_zero;
+
+	ufbx_allocator_opts temp_allocator; // < Allocator used during optimization
+
+	// Optimize parts in parallel using a thread pool
+	ufbx_thread_opts thread_opts;
+
+	// Index offsets where parts of the index buffer start, eg. the first index of each
+	// `ufbx_mesh_part` when triangulating the parts in order. Triangles are only reordered
+	// within their part. Offsets must be ascending and divisible by 3.
+	// Default: The whole index buffer is a single part
+	ufbx_const_uint32_list part_offsets;
+
+	// Number of vertices in the simulated post-transform cache.
+	// Default: 16
+	size_t cache_size;
+
+	// Reorder clusters of triangles to reduce overdraw, requires `position_stream`.
+	bool optimize_overdraw;
+
+	// Index of the vertex stream that starts with a `ufbx_vec3` position.
+	size_t position_stream;
+
+	// Maximum relative increase of vertex cache misses allowed by `optimize_overdraw`.
+	// Default: 1.05
+	ufbx_real overdraw_threshold;
+
+	// Renumber vertices in the order they are first used and reorder the data in all vertex streams to match.
+	bool reorder_vertices;
+
+	uint32_t _end_zero;
+} ufbx_optimize_indices_opts;
+
+// Options for `ufbx_create_mesh_buffers()`
+// NOTE: Initialize to zero with `{ 0 }` (C) or `{ }` (C++)
+typedef struct ufbx_mesh_buffers_opts {
+	uint32_t _begin_zero;
+
+	ufbx_allocator_opts temp_allocator;   // < Allocator used while building the buffers
+	ufbx_allocator_opts result_allocator; // < Allocator used for the final buffers
+
+	// Build parts in parallel using a thread pool
+	ufbx_thread_opts thread_opts;
+
+	// Attributes of the interleaved vertex, required.
+	ufbx_const_vertex_attrib_desc_list attribs;
+
+	// Size of a vertex in bytes, must fit all the attributes.
+	// Default: End of the last attribute rounded up to a multiple of 4
+	size_t vertex_stride;
+
+	// Always write `uint32_t` indices, by default parts with at most 65535 vertices use `uint16_t`.
+	bool force_32bit_indices;
+
+	uint32_t _end_zero;
+} ufbx_mesh_buffers_opts;
+
 // Options for `ufbx_load_geometry_cache()`
 // NOTE: Initialize to zero with `{ 0 }` (C) or `{ }` (C++)
 typedef struct ufbx_geometry_cache_opts {
@@ -4671,6 +5181,39 @@ typedef struct ufbx_geometry_cache_data_opts {
 	uint32_t _end_zero;
 } ufbx_geometry_cache_data_opts;
 
+// Options for `ufbx_save_scene_snapshot()`
+// NOTE: Initialize to zero with `{ 0 }` (C) or `{ }` (C++)
+typedef struct ufbx_save_snapshot_opts {
+	uint32_t _begin_zero;
+
+	ufbx_allocator_opts temp_allocator;   // < Allocator used during serialization
+	ufbx_allocator_opts result_allocator; // < Allocator used for the final snapshot
+
+	uint32_t _end_zero;
+} ufbx_save_snapshot_opts;
+
+// Options for `ufbx_load_scene_snapshot()`
+// NOTE: Initialize to zero with `{ 0 }` (C) or `{ }` (C++)
+typedef struct ufbx_load_snapshot_opts {
+	uint32_t _begin_zero;
+
+	ufbx_allocator_opts temp_allocator;   // < Allocator used during loading
+	ufbx_allocator_opts result_allocator; // < Allocator used for the final scene
+
+	// Skip verifying the checksum of the snapshot data.
+	// The header and relocations are always validated, but corrupted data may
+	// result in an invalid scene.
+	bool skip_checksum;
+
+	uint32_t _end_zero;
+} ufbx_load_snapshot_opts;
+
+// Serialized image of a `ufbx_scene`, see `ufbx_save_scene_snapshot()`.
+typedef struct ufbx_scene_snapshot {
+	// Snapshot data, store this as-is and pass it to `ufbx_load_scene_snapshot()`.
+	ufbx_blob data;
+} ufbx_scene_snapshot;
+
 typedef struct ufbx_panic {
 	bool did_panic;
 	size_t message_length;
@@ -4764,6 +5307,48 @@ ufbx_abi void ufbx_free_scene(ufbx_scene *scene);
 // Increment `scene` refcount
 ufbx_abi void ufbx_retain_scene(ufbx_scene *scene);
 
+// Create a context that can be passed in `ufbx_load_opts.load_context` to reuse
+// temporary memory between loads. Free the context with `ufbx_free_load_context()`.
+ufbx_abi ufbx_load_context *ufbx_create_load_context(const ufbx_load_context_opts *opts, ufbx_error *error);
+
+ufbx_abi void ufbx_retain_load_context(ufbx_load_context *context);
+ufbx_abi void ufbx_free_load_context(ufbx_load_context *context);
+
+// Release temporary memory retained by `context` until at most `max_memory` bytes remain.
+ufbx_abi void ufbx_trim_load_context(ufbx_load_context *context, size_t max_memory);
+
+// Scene snapshots
+//
+// Snapshots are position-independent binary images of a loaded scene that can be
+// loaded back without parsing, eg. for caching processed files between runs.
+// The loaded scene is a single allocation and behaves like any other `ufbx_scene`.
+// NOTE: Snapshots are only compatible with the exact same version and configuration
+// of ufbx (pointer size, endianness, `ufbx_real`), `UFBX_ERROR_BAD_SNAPSHOT` otherwise.
+
+// Serialize `scene` into a snapshot, free the result with `ufbx_free_scene_snapshot()`.
+ufbx_abi ufbx_scene_snapshot *ufbx_save_scene_snapshot(const ufbx_scene *scene, const ufbx_save_snapshot_opts *opts, ufbx_error *error);
+
+ufbx_abi void ufbx_retain_scene_snapshot(ufbx_scene_snapshot *snapshot);
+ufbx_abi void ufbx_free_scene_snapshot(ufbx_scene_snapshot *snapshot);
+
+// Load a scene from snapshot data returned by `ufbx_save_scene_snapshot()`.
+ufbx_abi ufbx_scene *ufbx_load_scene_snapshot(
+	const void *data, size_t data_size,
+	const ufbx_load_snapshot_opts *opts, ufbx_error *error);
+
+// Load a scene from a snapshot stored in a file named `filename`.
+ufbx_abi ufbx_scene *ufbx_load_scene_snapshot_file(
+	const char *filename,
+	const ufbx_load_snapshot_opts *opts, ufbx_error *error);
+ufbx_abi ufbx_scene *ufbx_load_scene_snapshot_file_len(
+	const char *filename, size_t filename_len,
+	const ufbx_load_snapshot_opts *opts, ufbx_error *error);
+
+// Load a scene from a snapshot read from a user-specified stream.
+ufbx_abi ufbx_scene *ufbx_load_scene_snapshot_stream(
+	const ufbx_stream *stream,
+	const ufbx_load_snapshot_opts *opts, ufbx_error *error);
+
 // Format a textual description of `error`.
 // Always produces a NULL-terminated string to `char dst[dst_size]`, truncating if
 // necessary. Returns the number of characters written not including the NULL terminator.
@@ -4859,6 +5444,20 @@ ufbx_abi bool ufbx_open_memory(ufbx_stream *stream, const void *data, size_t dat
 // Returns `default_value` only if `curve == NULL` or it has no keyframes.
 ufbx_abi ufbx_real ufbx_evaluate_curve(const ufbx_anim_curve *curve, double time, ufbx_real default_value);
 
+// Evaluate `curve` like `ufbx_evaluate_curve()` but start searching for the keyframe
+// from `cursor`, which is updated for the next call. Fast for sequential playback.
+ufbx_abi ufbx_real ufbx_evaluate_curve_cursor(const ufbx_anim_curve *curve, ufbx_curve_cursor *cursor, double time, ufbx_real default_value);
+
+// Evaluate `num_curves` curves at the same `time` into `values[]`.
+// `values[]` should contain the default values for the curves, which are kept for `NULL` curves.
+// `cursors[]` is optional, if specified it must contain one cursor for each curve.
+// Cubic segments of multiple curves are solved in parallel using SIMD where available.
+ufbx_abi void ufbx_evaluate_curves(const ufbx_anim_curve **curves, ufbx_curve_cursor *cursors, size_t num_curves, double time, ufbx_real *values);
+
+// Evaluate `curve` at `num_samples` different `times[]` into `values[]`, equivalent to
+// calling `ufbx_evaluate_curve()` for each time. Fastest if `times[]` is increasing.
+ufbx_abi void ufbx_evaluate_curve_samples(const ufbx_anim_curve *curve, const double *times, ufbx_real *values, size_t num_samples, ufbx_real default_value);
+
 // Evaluate a value from bundled animation curves.
 ufbx_abi ufbx_real ufbx_evaluate_anim_value_real(const ufbx_anim_value *anim_value, double time);
 ufbx_abi ufbx_vec2 ufbx_evaluate_anim_value_vec2(const ufbx_anim_value *anim_value, double time);
@@ -4908,8 +5507,17 @@ ufbx_abi ufbx_real ufbx_evaluate_blend_weight(const ufbx_anim *anim, const ufbx_
 //
 // NOTE: The returned scene refers to the original `scene` so the original
 // scene cannot be freed until all evaluated scenes are freed.
+// Overrides in `anim` are copied so it can be freed after evaluating.
 ufbx_abi ufbx_scene *ufbx_evaluate_scene(const ufbx_scene *scene, const ufbx_anim *anim, double time, const ufbx_evaluate_opts *opts, ufbx_error *error);
 
+// Re-evaluate a scene returned by `ufbx_evaluate_scene()` in place at a different `time`.
+// Only elements affected by the animation are recomputed: animated properties,
+// transforms of animated nodes and their descendants and skinned vertices of
+// meshes deformed by them. Reuses the existing buffers so nothing is allocated.
+// Returns `false` if `scene` was not created by `ufbx_evaluate_scene()`.
+// NOTE: Modifies `scene` so it must not be used concurrently from other threads.
+ufbx_abi bool ufbx_update_evaluated_scene(ufbx_scene *scene, double time, ufbx_error *error);
+
 ufbx_abi ufbx_anim *ufbx_create_anim(const ufbx_scene *scene, const ufbx_anim_opts *opts, ufbx_error *error);
 
 ufbx_abi void ufbx_retain_anim(ufbx_anim *anim);
@@ -4925,6 +5533,52 @@ ufbx_abi void ufbx_free_baked_anim(ufbx_baked_anim *bake);
 ufbx_abi ufbx_vec3 ufbx_evaluate_baked_vec3(ufbx_baked_vec3_list keyframes, double time);
 ufbx_abi ufbx_quat ufbx_evaluate_baked_quat(ufbx_baked_quat_list keyframes, double time);
 
+// Cursor based versions of `ufbx_evaluate_baked_vec3/quat()`, see `ufbx_curve_cursor`.
+ufbx_abi ufbx_vec3 ufbx_evaluate_baked_vec3_cursor(ufbx_baked_vec3_list keyframes, ufbx_curve_cursor *cursor, double time);
+ufbx_abi ufbx_quat ufbx_evaluate_baked_quat_cursor(ufbx_baked_quat_list keyframes, ufbx_curve_cursor *cursor, double time);
+
+// Sample the transforms of all baked nodes at `time` into `transforms[i]` for `bake->nodes[i]`,
+// the results match evaluating each track with `ufbx_evaluate_baked_vec3/quat()`.
+// The keyframe search is shared between the tracks of a node when they have the same keyframe times.
+// Optionally pass one cursor per node in `cursors[]` to speed up sampling increasing times.
+// Returns the number of transforms written, `min(bake->nodes.count, num_transforms)`.
+ufbx_abi size_t ufbx_sample_baked_pose(const ufbx_baked_anim *bake, double time, ufbx_transform *transforms, size_t num_transforms,
+	ufbx_curve_cursor *cursors, size_t num_cursors);
+
+// Compressed animation
+
+// Quantize the keyframes of `bake` into a compact representation: vectors are range
+// quantized to 16 bits per component, rotations use 48-bit "smallest three" quaternions,
+// evenly spaced keyframe times are stored implicitly, and constant tracks are collapsed.
+// Non-uniform keyframe times are stored as single precision offsets from the first key
+// unless the keys are too close to each other.
+// NOTE: The compressed animation does not refer to `bake` and can outlive it.
+ufbx_abi ufbx_compressed_anim *ufbx_compress_baked_anim(const ufbx_baked_anim *bake, const ufbx_compress_anim_opts *opts, ufbx_error *error);
+
+ufbx_abi void ufbx_retain_compressed_anim(ufbx_compressed_anim *anim);
+ufbx_abi void ufbx_free_compressed_anim(ufbx_compressed_anim *anim);
+
+// Evaluate compressed tracks, matching `ufbx_evaluate_baked_vec3/quat()` up to quantization error.
+ufbx_abi ufbx_vec3 ufbx_evaluate_compressed_vec3(const ufbx_compressed_track *track, double time);
+ufbx_abi ufbx_quat ufbx_evaluate_compressed_quat(const ufbx_compressed_track *track, double time);
+ufbx_abi ufbx_transform ufbx_evaluate_compressed_node(const ufbx_compressed_node *node, double time);
+
+// Compiled animation
+
+// Resolve the animation curves affecting each node in `scene` for fast evaluation
+// of full poses using `ufbx_evaluate_pose()`. Uses `scene->anim` if `anim` is `NULL`.
+// NOTE: The compiled animation refers to `scene` and `anim`, retaining them while alive.
+ufbx_abi ufbx_compiled_anim *ufbx_compile_anim(const ufbx_scene *scene, const ufbx_anim *anim, const ufbx_compile_anim_opts *opts, ufbx_error *error);
+
+ufbx_abi void ufbx_retain_compiled_anim(ufbx_compiled_anim *compiled);
+ufbx_abi void ufbx_free_compiled_anim(ufbx_compiled_anim *compiled);
+
+// Evaluate the local transforms of all nodes at `time` into `transforms[]` indexed by
+// `ufbx_node.typed_id`, the results match `ufbx_evaluate_transform()` for each node.
+// Returns the number of transforms written, `min(compiled->num_nodes, num_transforms)`.
+// Thread-safe, the compiled animation is not modified.
+ufbx_abi size_t ufbx_evaluate_pose(const ufbx_compiled_anim *compiled, double time, ufbx_transform *transforms, size_t num_transforms);
+
 // Materials
 
 ufbx_abi ufbx_texture *ufbx_find_prop_texture_len(const ufbx_material *material, const char *name, size_t name_len);
@@ -4976,6 +5630,25 @@ ufbx_inline ufbx_matrix ufbx_get_skin_vertex_matrix(const ufbx_skin_deformer *sk
 	return ufbx_catch_get_skin_vertex_matrix(NULL, skin, vertex, fallback);
 }
 
+// Incrementally re-skin `positions` after the bones of some clusters have moved.
+// Only vertices in `ufbx_skin_cluster.vertices` of the clusters `changed_clusters[]`
+// (indices to `skin->clusters[]`) are recomputed from `rest_positions`, the rest
+// must already contain the skinned result from the previous pose.
+// Vertices shared between clusters are skinned once if `changed_clusters[]` is sorted.
+// Returns the number of vertices that were recomputed.
+ufbx_abi size_t ufbx_update_skin_vertices(const ufbx_skin_deformer *skin, const uint32_t *changed_clusters, size_t num_changed_clusters,
+	const ufbx_vec3 *rest_positions, ufbx_vec3 *positions, size_t num_vertices, const ufbx_matrix *fallback);
+
+// Pack the skin weights of `vertices[]` into fixed size influences for GPU skinning.
+// Writes `num_vertices * max_influences` bone indices (cluster indices to `skin->clusters[]`)
+// and quantized weights, using the first `max_influences` weights of each vertex
+// renormalized so that the quantized weights sum exactly to 255 (or 65535).
+// Unused influences and vertices without weights are written as zeros.
+// If `vertices` is `NULL` the vertices are packed in order, pass eg. `ufbx_mesh.vertex_indices`
+// to get the weights per index to use with `ufbx_generate_indices()`.
+ufbx_abi bool ufbx_pack_skin_weights(const ufbx_skin_deformer *skin, const uint32_t *vertices, size_t num_vertices,
+	void *bone_indices, void *bone_weights, const ufbx_pack_skin_weights_opts *opts, ufbx_error *error);
+
 ufbx_abi uint32_t ufbx_get_blend_shape_offset_index(const ufbx_blend_shape *shape, size_t vertex);
 ufbx_abi ufbx_vec3 ufbx_get_blend_shape_vertex_offset(const ufbx_blend_shape *shape, size_t vertex);
 ufbx_abi ufbx_vec3 ufbx_get_blend_vertex_offset(const ufbx_blend_deformer *blend, size_t vertex);
@@ -4983,6 +5656,32 @@ ufbx_abi ufbx_vec3 ufbx_get_blend_vertex_offset(const ufbx_blend_deformer *blend
 ufbx_abi void ufbx_add_blend_shape_vertex_offsets(const ufbx_blend_shape *shape, ufbx_vec3 *vertices, size_t num_vertices, ufbx_real weight);
 ufbx_abi void ufbx_add_blend_vertex_offsets(const ufbx_blend_deformer *blend, ufbx_vec3 *vertices, size_t num_vertices, ufbx_real weight);
 
+// Compute the weight of every shape in `blend` into `shape_weights[]`, including in-between shapes.
+// Shapes are ordered by `blend->channels[]` and then by `ufbx_blend_channel.keyframes[]`.
+// `channel_weights[i]` is used instead of `ufbx_blend_channel.weight` of `blend->channels[i]`,
+// channels without a weight (or all if `channel_weights == NULL`) use the evaluated weight.
+// Returns the total number of shapes, writes at most `num_shape_weights` of them.
+ufbx_abi size_t ufbx_get_blend_shape_weights(const ufbx_blend_deformer *blend, const ufbx_real *channel_weights, size_t num_channel_weights,
+	ufbx_real *shape_weights, size_t num_shape_weights);
+
+// Add the offsets of all shapes in `blend` scaled by `shape_weights[]` (see `ufbx_get_blend_shape_weights()`).
+// Shapes with zero weight or past `num_shape_weights` are skipped.
+ufbx_abi void ufbx_add_weighted_blend_vertex_offsets(const ufbx_blend_deformer *blend, const ufbx_real *shape_weights, size_t num_shape_weights,
+	ufbx_vec3 *vertices, size_t num_vertices);
+
+// Create a vertex-major copy of the shape offsets in `blend` for `ufbx_add_blend_vertex_layout_offsets()`.
+// The layout does not refer to `blend` and needs to be recreated if the shapes change.
+ufbx_abi ufbx_blend_vertex_layout *ufbx_create_blend_vertex_layout(const ufbx_blend_deformer *blend, const ufbx_blend_vertex_layout_opts *opts, ufbx_error *error);
+
+ufbx_abi void ufbx_retain_blend_vertex_layout(ufbx_blend_vertex_layout *layout);
+ufbx_abi void ufbx_free_blend_vertex_layout(ufbx_blend_vertex_layout *layout);
+
+// Same as `ufbx_add_weighted_blend_vertex_offsets()` with identical results, but writes each vertex once.
+// Faster when many shapes are active at once, eg. in facial animation.
+// Thread-safe, the layout is not modified.
+ufbx_abi void ufbx_add_blend_vertex_layout_offsets(const ufbx_blend_vertex_layout *layout, const ufbx_real *shape_weights, size_t num_shape_weights,
+	ufbx_vec3 *vertices, size_t num_vertices);
+
 // Curves/surfaces
 
 ufbx_abi size_t ufbx_evaluate_nurbs_basis(const ufbx_nurbs_basis *basis, ufbx_real u, ufbx_real *weights, size_t num_weights, ufbx_real *derivatives, size_t num_derivatives);
@@ -5002,12 +5701,21 @@ ufbx_abi void ufbx_retain_line_curve(ufbx_line_curve *curve);
 // Returns `UFBX_NO_INDEX` if out of bounds.
 ufbx_abi uint32_t ufbx_find_face_index(ufbx_mesh *mesh, size_t index);
 
+// Triangulate `face` into `indices[(face.num_indices - 2) * 3]`, returns the number of triangles.
+// Uses ear clipping and never allocates memory, see `ufbx_triangulate_mesh()` for large polygons.
 ufbx_abi uint32_t ufbx_catch_triangulate_face(ufbx_panic *panic, uint32_t *indices, size_t num_indices, const ufbx_mesh *mesh, ufbx_face face);
 ufbx_inline uint32_t ufbx_triangulate_face(uint32_t *indices, size_t num_indices, const ufbx_mesh *mesh, ufbx_face face) {
 	return ufbx_catch_triangulate_face(NULL, indices, num_indices, mesh, face);
 }
 
+// Triangulate all faces of `mesh` into `indices[mesh->num_triangles * 3]` in face order,
+// the result is the same as calling `ufbx_triangulate_face()` for each face, except that
+// non-convex polygons with many corners are split into monotone pieces which is much faster.
+ufbx_abi bool ufbx_triangulate_mesh(const ufbx_mesh *mesh, uint32_t *indices, size_t num_indices, const ufbx_triangulate_mesh_opts *opts, ufbx_error *error);
+
 // Generate the half-edge representation of `mesh` to `topo[mesh->num_indices]`
+// Copies `mesh->topology` if it has been computed, see `ufbx_load_opts.compute_topology`,
+// otherwise sorts the edges in place without allocating memory.
 ufbx_abi void ufbx_catch_compute_topology(ufbx_panic *panic, const ufbx_mesh *mesh, ufbx_topo_edge *topo, size_t num_topo);
 ufbx_inline void ufbx_compute_topology(const ufbx_mesh *mesh, ufbx_topo_edge *topo, size_t num_topo) {
 	ufbx_catch_compute_topology(NULL, mesh, topo, num_topo);
@@ -5076,12 +5784,29 @@ ufbx_inline ufbx_dom_node *ufbx_dom_find(const ufbx_dom_node *parent, const char
 
 ufbx_abi size_t ufbx_generate_indices(const ufbx_vertex_stream *streams, size_t num_streams, uint32_t *indices, size_t num_indices, const ufbx_allocator_opts *allocator, ufbx_error *error);
 
+// Reorder the triangles of `indices` returned by `ufbx_generate_indices()` for the post-transform vertex cache.
+// `num_vertices` is the number of unique vertices, ie. the return value of `ufbx_generate_indices()`.
+// Optionally reduces overdraw and reorders `streams` for vertex fetch locality, see `ufbx_optimize_indices_opts`.
+// Triangles keep their winding and are only moved within their part.
+ufbx_abi bool ufbx_optimize_indices(const ufbx_vertex_stream *streams, size_t num_streams, uint32_t *indices, size_t num_indices, size_t num_vertices, const ufbx_optimize_indices_opts *opts, ufbx_error *error);
+
+// Triangulate each material part of `mesh` and write the attributes described by `opts->attribs`
+// into deduplicated interleaved vertex and index buffers. Vertices are compared after encoding.
+ufbx_abi ufbx_mesh_buffers *ufbx_create_mesh_buffers(const ufbx_mesh *mesh, const ufbx_mesh_buffers_opts *opts, ufbx_error *error);
+
+ufbx_abi void ufbx_retain_mesh_buffers(ufbx_mesh_buffers *buffers);
+ufbx_abi void ufbx_free_mesh_buffers(ufbx_mesh_buffers *buffers);
+
 // Thread pool
 
 // Run a single thread pool task.
 // See `ufbx_thread_pool_run_fn` for more information.
 ufbx_unsafe ufbx_abi void ufbx_thread_pool_run_task(ufbx_thread_pool_context ctx, uint32_t index);
 
+// Estimated relative cost of a thread pool task, eg. the amount of data it processes.
+// Can be used to start expensive tasks first to avoid idle threads at the end.
+ufbx_unsafe ufbx_abi double ufbx_thread_pool_get_task_cost(ufbx_thread_pool_context ctx, uint32_t index);
+
 ufbx_unsafe ufbx_abi void ufbx_thread_pool_set_user_ptr(ufbx_thread_pool_context ctx, void *user_ptr);
 ufbx_unsafe ufbx_abi void *ufbx_thread_pool_get_user_ptr(ufbx_thread_pool_context ctx);
 
@@ -5261,6 +5986,42 @@ template<> struct ufbx_type_traits<ufbx_baked_anim> {
 	static void free(ufbx_baked_anim *ptr) { ufbx_free_baked_anim(ptr); }
 };
 
+template<> struct ufbx_type_traits<ufbx_compressed_anim> {
+	enum { valid = 1 };
+	static void retain(ufbx_compressed_anim *ptr) { ufbx_retain_compressed_anim(ptr); }
+	static void free(ufbx_compressed_anim *ptr) { ufbx_free_compressed_anim(ptr); }
+};
+
+template<> struct ufbx_type_traits<ufbx_compiled_anim> {
+	enum { valid = 1 };
+	static void retain(ufbx_compiled_anim *ptr) { ufbx_retain_compiled_anim(ptr); }
+	static void free(ufbx_compiled_anim *ptr) { ufbx_free_compiled_anim(ptr); }
+};
+
+template<> struct ufbx_type_traits<ufbx_blend_vertex_layout> {
+	enum { valid = 1 };
+	static void retain(ufbx_blend_vertex_layout *ptr) { ufbx_retain_blend_vertex_layout(ptr); }
+	static void free(ufbx_blend_vertex_layout *ptr) { ufbx_free_blend_vertex_layout(ptr); }
+};
+
+template<> struct ufbx_type_traits<ufbx_mesh_buffers> {
+	enum { valid = 1 };
+	static void retain(ufbx_mesh_buffers *ptr) { ufbx_retain_mesh_buffers(ptr); }
+	static void free(ufbx_mesh_buffers *ptr) { ufbx_free_mesh_buffers(ptr); }
+};
+
+template<> struct ufbx_type_traits<ufbx_load_context> {
+	enum { valid = 1 };
+	static void retain(ufbx_load_context *ptr) { ufbx_retain_load_context(ptr); }
+	static void free(ufbx_load_context *ptr) { ufbx_free_load_context(ptr); }
+};
+
+template<> struct ufbx_type_traits<ufbx_scene_snapshot> {
+	enum { valid = 1 };
+	static void retain(ufbx_scene_snapshot *ptr) { ufbx_retain_scene_snapshot(ptr); }
+	static void free(ufbx_scene_snapshot *ptr) { ufbx_free_scene_snapshot(ptr); }
+};
+
 class ufbx_deleter {
 public:
 	template <typename T>